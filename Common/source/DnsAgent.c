@@ -0,0 +1,370 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the DNS agent.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_DNS_AGENT
+
+#include "DnsAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "DnsMessage.h"
+#include "simplelink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "timers.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+
+/* constant definitions ***************************************************** */
+
+/** File content: number of hosts, then DNS_CACHE_EXPORT_ENTRY_SIZE bytes per host */
+#define DNS_AGENT_FILE_SIZE             (1UL + ((uint32_t) DNS_CACHE_MAX_ENTRIES * DNS_CACHE_EXPORT_ENTRY_SIZE))
+
+#define DNS_AGENT_MAX_DATAGRAMS         UINT8_C(3) /**< Datagrams read while waiting for the answer to a query */
+
+/* local variables ********************************************************** */
+
+static const DnsAgent_Setup_T * AgentSetup = NULL;
+
+static DnsCache_T AgentCache;
+
+static SemaphoreHandle_t AgentLock = NULL; /**< Protects AgentCache */
+
+static StaticRtos_Semaphore_T AgentLockStorage;
+
+static xTimerHandle AgentTimer = NULL;
+
+static StaticRtos_Timer_T AgentTimerStorage;
+
+static uint16_t AgentQueryId = 0U;
+
+static uint8_t AgentMessage[DNS_MESSAGE_MAX_SIZE]; /**< Query and answer, used with AgentLock taken */
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Returns the DNS server the WLAN network assigned, 0 if there is none.
+ */
+static uint32_t AgentGetDnsServer(void)
+{
+    SlNetCfgIpV4Args_t ipV4;
+    _u8 length = (_u8) sizeof(ipV4);
+    _u8 isDhcp = 0U;
+
+    if (0 > sl_NetCfgGet(SL_IPV4_STA_P2P_CL_GET_INFO, &isDhcp, &length, (_u8 *) &ipV4))
+    {
+        return 0UL;
+    }
+    return ipV4.ipV4DnsServer;
+}
+
+/**
+ * @brief Sends an A query for host to the DNS server and waits for the answer.
+ */
+static DnsMessage_Result_T AgentQuery(uint32_t server, const char * host, uint32_t * address, uint32_t * ttlS)
+{
+    DnsMessage_Result_T result = DNS_MESSAGE_RESULT_INVALID;
+    SlSockAddrIn_t serverAddress;
+    SlSockAddrIn_t fromAddress;
+    SlSocklen_t fromLength;
+    struct SlTimeval_t receiveTimeout;
+    int16_t querySocket;
+    int16_t received;
+    uint16_t length;
+    uint16_t id = (uint16_t) (AgentNowMs() ^ (uint32_t) (++AgentQueryId << 8));
+    uint8_t datagram;
+
+    length = DnsMessage_WriteQuery(AgentMessage, sizeof(AgentMessage), id, host);
+    if (0U == length)
+    {
+        return DNS_MESSAGE_RESULT_NOT_FOUND;
+    }
+    querySocket = sl_Socket(SL_AF_INET, SL_SOCK_DGRAM, SL_IPPROTO_UDP);
+    if (0 > querySocket)
+    {
+        return DNS_MESSAGE_RESULT_FAILURE;
+    }
+    receiveTimeout.tv_sec = AgentSetup->TimeoutMs / 1000UL;
+    receiveTimeout.tv_usec = (AgentSetup->TimeoutMs % 1000UL) * 1000UL;
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = SL_AF_INET;
+    serverAddress.sin_port = sl_Htons(DNS_MESSAGE_PORT);
+    serverAddress.sin_addr.s_addr = sl_Htonl(server);
+    if ((0 <= sl_SetSockOpt(querySocket, SL_SOL_SOCKET, SL_SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout))) &&
+            (0 <= sl_SendTo(querySocket, AgentMessage, length, 0, (SlSockAddr_t *) &serverAddress, sizeof(serverAddress))))
+    {
+        /* Late answers to earlier queries carry another ID and are skipped */
+        for (datagram = 0U; (datagram < DNS_AGENT_MAX_DATAGRAMS) && (DNS_MESSAGE_RESULT_INVALID == result); datagram++)
+        {
+            fromLength = sizeof(fromAddress);
+            received = sl_RecvFrom(querySocket, AgentMessage, sizeof(AgentMessage), 0, (SlSockAddr_t *) &fromAddress, &fromLength);
+            if (0 >= received)
+            {
+                break;
+            }
+            if (fromAddress.sin_addr.s_addr == serverAddress.sin_addr.s_addr)
+            {
+                result = DnsMessage_ParseResponse(AgentMessage, (uint16_t) received, id, address, ttlS);
+            }
+        }
+    }
+    (void) sl_Close(querySocket);
+    return result;
+}
+
+/**
+ * @brief DnsCache resolver: own query for the TTL, the resolver of the WLAN chip if that fails.
+ */
+static bool AgentResolve(void * context, const char * host, uint32_t * address, uint32_t * ttlS)
+{
+    uint32_t server = AgentGetDnsServer();
+    DnsMessage_Result_T result = DNS_MESSAGE_RESULT_FAILURE;
+
+    BCDS_UNUSED(context);
+
+    if (0UL != server)
+    {
+        result = AgentQuery(server, host, address, ttlS);
+    }
+    if (DNS_MESSAGE_RESULT_ADDRESS == result)
+    {
+        return true;
+    }
+    if (DNS_MESSAGE_RESULT_NOT_FOUND == result)
+    {
+        printf("DnsAgent : %s does not exist \r\n", host);
+        return false;
+    }
+    *ttlS = 0UL;
+    if (0 > sl_NetAppDnsGetHostByName((_i8 *) host, (_u16) strlen(host), (_u32 *) address, SL_AF_INET))
+    {
+        printf("DnsAgent : Resolving %s failed \r\n", host);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the last good addresses of a previous run.
+ */
+static void AgentLoadFile(void)
+{
+    uint8_t content[DNS_AGENT_FILE_SIZE];
+    _i32 fileHandle = -1;
+    _i32 length;
+
+    if (0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_READ, NULL, &fileHandle))
+    {
+        return; /* First start */
+    }
+    length = sl_FsRead(fileHandle, 0UL, content, sizeof(content));
+    (void) sl_FsClose(fileHandle, NULL, NULL, 0UL);
+    if ((length > 0L) && (content[0] <= DNS_CACHE_MAX_ENTRIES) && (length >= (_i32) (1UL + (content[0] * DNS_CACHE_EXPORT_ENTRY_SIZE))))
+    {
+        printf("DnsAgent : %u fallback addresses from %s \r\n",
+                (unsigned int) DnsCache_Import(&AgentCache, &content[1], (uint16_t) (content[0] * DNS_CACHE_EXPORT_ENTRY_SIZE)),
+                AgentSetup->FileName);
+    }
+}
+
+/**
+ * @brief Writes the last good addresses if one changed; call with AgentLock taken.
+ */
+static void AgentSaveFile(void)
+{
+    uint8_t content[DNS_AGENT_FILE_SIZE];
+    _i32 fileHandle = -1;
+    uint16_t length;
+
+    if ((NULL == AgentSetup->FileName) || !AgentCache.IsExportDue)
+    {
+        return;
+    }
+    length = DnsCache_Export(&AgentCache, &content[1], sizeof(content) - 1U);
+    content[0] = (uint8_t) (length / DNS_CACHE_EXPORT_ENTRY_SIZE);
+    if ((0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_WRITE, NULL, &fileHandle)) &&
+            (0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_CREATE(DNS_AGENT_FILE_SIZE, _FS_FILE_OPEN_FLAG_COMMIT | _FS_FILE_PUBLIC_WRITE),
+                    NULL, &fileHandle)))
+    {
+        printf("DnsAgent : Cannot open %s \r\n", AgentSetup->FileName);
+        return;
+    }
+    if (0 > sl_FsWrite(fileHandle, 0UL, content, 1UL + length))
+    {
+        printf("DnsAgent : Writing %s failed \r\n", AgentSetup->FileName);
+    }
+    (void) sl_FsClose(fileHandle, NULL, NULL, 0UL);
+}
+
+/**
+ * @brief Refreshes the hosts due, on the background lane.
+ */
+static void AgentRefreshWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    (void) xSemaphoreTake(AgentLock, portMAX_DELAY);
+    (void) DnsCache_Refresh(&AgentCache);
+    AgentSaveFile();
+    (void) xSemaphoreGive(AgentLock);
+}
+
+static void AgentRefreshTimer(xTimerHandle timer)
+{
+    BCDS_UNUSED(timer);
+
+    /* A refresh still queued covers this one as well */
+    (void) WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_BACKGROUND, AgentRefreshWork, NULL, UINT32_C(0));
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T DnsAgent_Setup(const DnsAgent_Setup_T * setup)
+{
+    DnsCache_Setup_T cacheSetup;
+    uint32_t fallbackAddress;
+    uint8_t host;
+
+    if ((NULL == setup) || ((NULL == setup->Hosts) && (0U != setup->HostCount)))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((setup->HostCount > DNS_CACHE_MAX_ENTRIES) || (0UL == setup->RefreshPeriodMs))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    cacheSetup.Resolve = AgentResolve;
+    cacheSetup.Context = NULL;
+    cacheSetup.NowMs = AgentNowMs;
+    cacheSetup.DefaultTtlS = setup->DefaultTtlS;
+    cacheSetup.MinTtlS = setup->MinTtlS;
+    cacheSetup.MaxTtlS = setup->MaxTtlS;
+    cacheSetup.RefreshPercent = setup->RefreshPercent;
+    cacheSetup.RetryMs = setup->RetryMs;
+    if (!DnsCache_Init(&AgentCache, &cacheSetup))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    for (host = 0U; host < setup->HostCount; host++)
+    {
+        fallbackAddress = 0UL;
+        if ((NULL != setup->Hosts[host].FallbackAddress) && ('\0' != setup->Hosts[host].FallbackAddress[0]) &&
+                !DnsCache_ParseAddress(setup->Hosts[host].FallbackAddress, &fallbackAddress))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+        }
+        (void) DnsCache_AddHost(&AgentCache, setup->Hosts[host].Host, fallbackAddress);
+    }
+
+    AgentLock = StaticRtos_CreateMutex(&AgentLockStorage, "DnsLock");
+    AgentTimer = StaticRtos_CreateTimer(&AgentTimerStorage, "DnsRefresh", pdMS_TO_TICKS(setup->RefreshPeriodMs), pdTRUE, NULL, AgentRefreshTimer);
+    if ((NULL == AgentLock) || (NULL == AgentTimer))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T DnsAgent_Enable(void)
+{
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if (NULL != AgentSetup->FileName)
+    {
+        AgentLoadFile();
+    }
+    AgentRefreshWork(NULL, UINT32_C(0));
+    if (pdPASS != xTimerStart(AgentTimer, 0))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T DnsAgent_Resolve(const char * host, uint32_t * address)
+{
+    bool isResolved;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if ((NULL == host) || (NULL == address))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    (void) xSemaphoreTake(AgentLock, portMAX_DELAY);
+    isResolved = DnsCache_Lookup(&AgentCache, host, address);
+    (void) xSemaphoreGive(AgentLock);
+    return isResolved ? RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+}
+
+/** Refer interface header for description */
+const DnsCache_Statistics_T * DnsAgent_GetStatistics(void)
+{
+    return &AgentCache.Statistics;
+}
+
+/** Refer interface header for description */
+void DnsAgent_PrintReport(void)
+{
+    const DnsCache_Statistics_T * statistics = &AgentCache.Statistics;
+    const DnsCache_Entry_T * entry;
+    char address[DNS_CACHE_ADDRESS_STRING_SIZE];
+    uint32_t nowMs = AgentNowMs();
+    uint8_t index;
+
+    printf("DnsAgent : %lu hits, %lu misses, %lu stale, %lu fallbacks, %lu failed, %lu refreshes, %lu changes\r\n",
+            (unsigned long) statistics->Hits, (unsigned long) statistics->Misses, (unsigned long) statistics->Stale,
+            (unsigned long) statistics->Fallbacks, (unsigned long) statistics->Failures, (unsigned long) statistics->Refreshes,
+            (unsigned long) statistics->Changes);
+    if (0UL != statistics->Resolutions)
+    {
+        printf("DnsAgent :   resolver %lu x, %lu failed, last %lu ms, mean %lu ms, max %lu ms\r\n", (unsigned long) statistics->Resolutions,
+                (unsigned long) statistics->ResolverFailures, (unsigned long) statistics->ResolveLastMs,
+                (unsigned long) (statistics->ResolveTotalMs / statistics->Resolutions), (unsigned long) statistics->ResolveMaxMs);
+    }
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        entry = &AgentCache.Entries[index];
+        if (NULL != entry->Host)
+        {
+            DnsCache_FormatAddress((0UL != entry->Address) ? entry->Address : entry->FallbackAddress, address);
+            if (0UL != entry->Address)
+            {
+                printf("DnsAgent :   %-32s %-15s %s, TTL %lu s, age %lu s\r\n", entry->Host, address, entry->IsFailing ? "failing" : "resolved",
+                        (unsigned long) (entry->TtlMs / 1000UL), (unsigned long) ((nowMs - entry->ResolvedMs) / 1000UL));
+            }
+            else
+            {
+                printf("DnsAgent :   %-32s %-15s %s\r\n", entry->Host, (0UL != entry->FallbackAddress) ? address : "-", "unresolved");
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/**
+ *  @file
+ *
+ *  @brief Runs a DnsCache on the XDK for the servers of the application.
+ *
+ *  sl_NetAppDnsGetHostByName asks the DNS server for every connection and
+ *  does not return the time to live of the answer. The agent queries the DNS
+ *  server of the WLAN network itself over UDP (DnsMessage) to learn the TTL,
+ *  keeps the answers in a DnsCache and falls back to the resolver of the WLAN
+ *  chip, with DefaultTtlS, if that query fails.
+ *
+ *  The hosts of the setup are resolved by DnsAgent_Enable and refreshed by a
+ *  timer on the background lane of the WorkDispatcher before they expire, so
+ *  DnsAgent_Resolve answers them from the cache. Their last good addresses are
+ *  kept in a file of the WLAN chip and serve as fallback after a restart when
+ *  the DNS server does not answer; the file is written only when an address
+ *  changed.
+ *
+ *  DnsAgent_Resolve may be called from any task.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DNSAGENT_H_
+#define DNSAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "DnsCache.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief A host resolved ahead of its first use and kept fresh.
+ */
+struct DnsAgent_Host_S
+{
+    const char * Host;
+    const char * FallbackAddress; /**< Dotted IPv4 address used while Host cannot be resolved, NULL for none */
+};
+typedef struct DnsAgent_Host_S DnsAgent_Host_T;
+
+/**
+ * @brief Agent configuration.
+ */
+struct DnsAgent_Setup_S
+{
+    const DnsAgent_Host_T * Hosts;
+    uint8_t HostCount; /**< At most DNS_CACHE_MAX_ENTRIES */
+    const char * FileName; /**< File in the file system of the WLAN chip for the last good addresses, NULL for none */
+    uint32_t RefreshPeriodMs; /**< Period of the refresh timer */
+    uint32_t DefaultTtlS; /**< TTL of the addresses from the resolver of the WLAN chip */
+    uint32_t MinTtlS;
+    uint32_t MaxTtlS;
+    uint8_t RefreshPercent; /**< Share of the TTL after which a host is resolved again */
+    uint32_t RetryMs; /**< Shortest time between resolution attempts of a failing host */
+    uint32_t TimeoutMs; /**< Longest wait for the answer of the DNS server */
+};
+typedef struct DnsAgent_Setup_S DnsAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Sets up the cache with the hosts of the setup and their fallback addresses.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T DnsAgent_Setup(const DnsAgent_Setup_T * setup);
+
+/**
+ * @brief Loads the addresses of the last run, resolves the hosts of the setup and starts the refresh timer.
+ *
+ * Requires an established WLAN connection. A host which cannot be resolved
+ * yet is not an error, it is retried by the refresh.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T DnsAgent_Enable(void);
+
+/**
+ * @brief Returns the address of host, from the cache if possible, see DnsCache_Lookup.
+ *
+ * @param[out] address
+ * IPv4 address, host byte order
+ *
+ * @return  RETCODE_OK on success, RETCODE_FAILURE if host has no address.
+ */
+Retcode_T DnsAgent_Resolve(const char * host, uint32_t * address);
+
+/**
+ * @brief Returns the counters of the cache.
+ */
+const DnsCache_Statistics_T * DnsAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters of the cache and the hosts.
+ */
+void DnsAgent_PrintReport(void);
+
+#endif /* DNSAGENT_H_ */
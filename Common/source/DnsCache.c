@@ -0,0 +1,427 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the DNS cache.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "DnsCache.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* local type and macro definitions */
+
+#define DNS_CACHE_HASH_OFFSET           UINT32_C(2166136261) /**< FNV-1a */
+#define DNS_CACHE_HASH_PRIME            UINT32_C(16777619)
+
+/* local functions ********************************************************** */
+
+static uint32_t CacheHash(const char * host)
+{
+    uint32_t hash = DNS_CACHE_HASH_OFFSET;
+
+    while ('\0' != *host)
+    {
+        hash = (hash ^ (uint8_t) *host++) * DNS_CACHE_HASH_PRIME;
+    }
+    return hash;
+}
+
+static void CacheWrite32(uint8_t * data, uint32_t value)
+{
+    data[0] = (uint8_t) (value >> 24);
+    data[1] = (uint8_t) (value >> 16);
+    data[2] = (uint8_t) (value >> 8);
+    data[3] = (uint8_t) value;
+}
+
+static uint32_t CacheRead32(const uint8_t * data)
+{
+    return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+}
+
+static DnsCache_Entry_T * CacheFind(DnsCache_T * cache, const char * host)
+{
+    uint8_t index;
+
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        if ((NULL != cache->Entries[index].Host) && (0 == strcmp(cache->Entries[index].Host, host)))
+        {
+            return &cache->Entries[index];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Returns a free entry for host, else the least recently used one which is not pinned.
+ *
+ * @return NULL if every entry is pinned.
+ */
+static DnsCache_Entry_T * CacheAllocate(DnsCache_T * cache, const char * host)
+{
+    DnsCache_Entry_T * entry = NULL;
+    uint32_t nowMs = cache->Setup.NowMs();
+    uint8_t index;
+
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        if (NULL == cache->Entries[index].Host)
+        {
+            entry = &cache->Entries[index];
+            break;
+        }
+        if ((!cache->Entries[index].IsPinned) &&
+                ((NULL == entry) || ((nowMs - cache->Entries[index].LastUseMs) > (nowMs - entry->LastUseMs))))
+        {
+            entry = &cache->Entries[index];
+        }
+    }
+    if (NULL != entry)
+    {
+        memset(entry, 0, sizeof(*entry));
+        entry->Host = host;
+    }
+    return entry;
+}
+
+static bool CacheIsExpired(const DnsCache_Entry_T * entry, uint32_t nowMs)
+{
+    return (0UL == entry->Address) || ((nowMs - entry->ResolvedMs) >= entry->TtlMs);
+}
+
+/**
+ * @brief Whether a failing host may be resolved again.
+ */
+static bool CacheIsAttemptDue(const DnsCache_T * cache, const DnsCache_Entry_T * entry, uint32_t nowMs)
+{
+    return (!entry->IsFailing) || ((nowMs - entry->LastAttemptMs) >= cache->Setup.RetryMs);
+}
+
+/**
+ * @brief Asks the resolver for the address of an entry and times the call.
+ */
+static bool CacheResolve(DnsCache_T * cache, DnsCache_Entry_T * entry)
+{
+    DnsCache_Statistics_T * statistics = &cache->Statistics;
+    uint32_t address = 0UL;
+    uint32_t ttlS = 0UL;
+    uint32_t startMs = cache->Setup.NowMs();
+    uint32_t nowMs;
+    uint32_t durationMs;
+    uint32_t lastAddress;
+    bool isResolved;
+
+    isResolved = cache->Setup.Resolve(cache->Setup.Context, entry->Host, &address, &ttlS) && (0UL != address);
+    nowMs = cache->Setup.NowMs();
+    durationMs = nowMs - startMs;
+    statistics->Resolutions++;
+    statistics->ResolveLastMs = durationMs;
+    statistics->ResolveTotalMs += durationMs;
+    if (durationMs > statistics->ResolveMaxMs)
+    {
+        statistics->ResolveMaxMs = durationMs;
+    }
+    if (!isResolved)
+    {
+        statistics->ResolverFailures++;
+        entry->IsFailing = true;
+        entry->LastAttemptMs = nowMs;
+        return false;
+    }
+
+    if (0UL == ttlS)
+    {
+        ttlS = cache->Setup.DefaultTtlS;
+    }
+    if (ttlS < cache->Setup.MinTtlS)
+    {
+        ttlS = cache->Setup.MinTtlS;
+    }
+    if (ttlS > cache->Setup.MaxTtlS)
+    {
+        ttlS = cache->Setup.MaxTtlS;
+    }
+    if ((0UL != entry->Address) && (address != entry->Address))
+    {
+        statistics->Changes++;
+    }
+    lastAddress = (0UL != entry->Address) ? entry->Address : entry->FallbackAddress;
+    if (entry->IsPinned && (address != lastAddress))
+    {
+        cache->IsExportDue = true;
+    }
+    entry->Address = address;
+    entry->ResolvedMs = nowMs;
+    entry->TtlMs = ttlS * 1000UL;
+    entry->IsFailing = false;
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool DnsCache_Init(DnsCache_T * cache, const DnsCache_Setup_T * setup)
+{
+    if ((NULL == cache) || (NULL == setup) || (NULL == setup->Resolve) || (NULL == setup->NowMs) || (0U == setup->RefreshPercent) ||
+            (setup->RefreshPercent > 100U) || (setup->MinTtlS > setup->MaxTtlS) || (0UL == setup->MaxTtlS) ||
+            (setup->MaxTtlS > (UINT32_MAX / 1000UL)))
+    {
+        return false;
+    }
+    memset(cache, 0, sizeof(*cache));
+    cache->Setup = *setup;
+    return true;
+}
+
+/** Refer interface header for description */
+bool DnsCache_AddHost(DnsCache_T * cache, const char * host, uint32_t fallbackAddress)
+{
+    DnsCache_Entry_T * entry;
+
+    if ((NULL == cache) || (NULL == host))
+    {
+        return false;
+    }
+    entry = CacheFind(cache, host);
+    if (NULL == entry)
+    {
+        entry = CacheAllocate(cache, host);
+    }
+    if (NULL == entry)
+    {
+        return false;
+    }
+    entry->FallbackAddress = fallbackAddress;
+    entry->IsPinned = true;
+    return true;
+}
+
+/** Refer interface header for description */
+bool DnsCache_Lookup(DnsCache_T * cache, const char * host, uint32_t * address)
+{
+    DnsCache_Entry_T * entry;
+    DnsCache_Entry_T transient;
+    uint32_t nowMs;
+
+    if ((NULL == cache) || (NULL == host) || (NULL == address))
+    {
+        return false;
+    }
+    if (DnsCache_ParseAddress(host, address))
+    {
+        return true;
+    }
+    nowMs = cache->Setup.NowMs();
+    entry = CacheFind(cache, host);
+    if ((NULL != entry) && !CacheIsExpired(entry, nowMs))
+    {
+        cache->Statistics.Hits++;
+        entry->LastUseMs = nowMs;
+        *address = entry->Address;
+        return true;
+    }
+    if (NULL == entry)
+    {
+        entry = CacheAllocate(cache, host);
+    }
+    if (NULL == entry)
+    {
+        /* Every entry holds an added host, resolve without caching */
+        memset(&transient, 0, sizeof(transient));
+        transient.Host = host;
+        entry = &transient;
+    }
+    entry->LastUseMs = nowMs;
+
+    if (CacheIsAttemptDue(cache, entry, nowMs))
+    {
+        cache->Statistics.Misses++;
+        if (CacheResolve(cache, entry))
+        {
+            *address = entry->Address;
+            return true;
+        }
+    }
+    if (0UL != entry->Address)
+    {
+        cache->Statistics.Stale++;
+        *address = entry->Address;
+        return true;
+    }
+    if (0UL != entry->FallbackAddress)
+    {
+        cache->Statistics.Fallbacks++;
+        *address = entry->FallbackAddress;
+        return true;
+    }
+    cache->Statistics.Failures++;
+    return false;
+}
+
+/** Refer interface header for description */
+uint8_t DnsCache_Refresh(DnsCache_T * cache)
+{
+    DnsCache_Entry_T * entry;
+    uint32_t nowMs;
+    uint8_t refreshed = 0U;
+    uint8_t index;
+
+    if (NULL == cache)
+    {
+        return 0U;
+    }
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        entry = &cache->Entries[index];
+        nowMs = cache->Setup.NowMs();
+        if ((NULL == entry->Host) || !CacheIsAttemptDue(cache, entry, nowMs))
+        {
+            continue;
+        }
+        if ((!entry->IsPinned) && ((0UL == entry->Address) || ((nowMs - entry->LastUseMs) > (nowMs - entry->ResolvedMs))))
+        {
+            /* Not looked up since it was resolved, let it expire */
+            continue;
+        }
+        if ((0UL == entry->Address) || ((nowMs - entry->ResolvedMs) >= ((entry->TtlMs / 100UL) * cache->Setup.RefreshPercent)))
+        {
+            (void) CacheResolve(cache, entry);
+            cache->Statistics.Refreshes++;
+            refreshed++;
+        }
+    }
+    return refreshed;
+}
+
+/** Refer interface header for description */
+void DnsCache_Flush(DnsCache_T * cache)
+{
+    uint8_t index;
+
+    if (NULL == cache)
+    {
+        return;
+    }
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        cache->Entries[index].Address = 0UL;
+        cache->Entries[index].IsFailing = false;
+    }
+}
+
+/** Refer interface header for description */
+uint16_t DnsCache_Export(DnsCache_T * cache, uint8_t * buffer, uint16_t size)
+{
+    const DnsCache_Entry_T * entry;
+    uint32_t address;
+    uint16_t length = 0U;
+    uint8_t index;
+
+    if ((NULL == cache) || (NULL == buffer))
+    {
+        return 0U;
+    }
+    for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+    {
+        entry = &cache->Entries[index];
+        address = (0UL != entry->Address) ? entry->Address : entry->FallbackAddress;
+        if ((NULL != entry->Host) && entry->IsPinned && (0UL != address) && ((length + DNS_CACHE_EXPORT_ENTRY_SIZE) <= size))
+        {
+            CacheWrite32(&buffer[length], CacheHash(entry->Host));
+            CacheWrite32(&buffer[length + 4U], address);
+            length += DNS_CACHE_EXPORT_ENTRY_SIZE;
+        }
+    }
+    cache->IsExportDue = false;
+    return length;
+}
+
+/** Refer interface header for description */
+uint8_t DnsCache_Import(DnsCache_T * cache, const uint8_t * data, uint16_t length)
+{
+    DnsCache_Entry_T * entry;
+    uint32_t hash;
+    uint32_t address;
+    uint16_t offset;
+    uint8_t imported = 0U;
+    uint8_t index;
+
+    if ((NULL == cache) || (NULL == data))
+    {
+        return 0U;
+    }
+    for (offset = 0U; (offset + DNS_CACHE_EXPORT_ENTRY_SIZE) <= length; offset += DNS_CACHE_EXPORT_ENTRY_SIZE)
+    {
+        hash = CacheRead32(&data[offset]);
+        address = CacheRead32(&data[offset + 4U]);
+        for (index = 0U; index < DNS_CACHE_MAX_ENTRIES; index++)
+        {
+            entry = &cache->Entries[index];
+            if ((NULL != entry->Host) && entry->IsPinned && (0UL != address) && (CacheHash(entry->Host) == hash))
+            {
+                /* The last address which actually answered beats a configured one */
+                entry->FallbackAddress = address;
+                imported++;
+            }
+        }
+    }
+    return imported;
+}
+
+/** Refer interface header for description */
+bool DnsCache_ParseAddress(const char * text, uint32_t * address)
+{
+    uint32_t result = 0UL;
+    uint32_t part;
+    uint8_t digits;
+    uint8_t parts;
+
+    if ((NULL == text) || (NULL == address))
+    {
+        return false;
+    }
+    for (parts = 0U; parts < 4U; parts++)
+    {
+        if ((0U != parts) && ('.' != *text++))
+        {
+            return false;
+        }
+        part = 0UL;
+        for (digits = 0U; (*text >= '0') && (*text <= '9'); digits++)
+        {
+            part = (part * 10UL) + (uint32_t) (*text++ - '0');
+            if ((digits >= 3U) || (part > 255UL))
+            {
+                return false;
+            }
+        }
+        if (0U == digits)
+        {
+            return false;
+        }
+        result = (result << 8) | part;
+    }
+    if ('\0' != *text)
+    {
+        return false;
+    }
+    *address = result;
+    return true;
+}
+
+/** Refer interface header for description */
+void DnsCache_FormatAddress(uint32_t address, char * text)
+{
+    if (NULL != text)
+    {
+        (void) snprintf(text, DNS_CACHE_ADDRESS_STRING_SIZE, "%u.%u.%u.%u", (unsigned int) (address >> 24), (unsigned int) ((address >> 16) & 0xFFU),
+                (unsigned int) ((address >> 8) & 0xFFU), (unsigned int) (address & 0xFFU));
+    }
+}
@@ -0,0 +1,188 @@
+/**
+ *  @file
+ *
+ *  @brief Small DNS cache which keeps the addresses of the servers the
+ *  application talks to, respecting the time to live of their records.
+ *
+ *  A lookup of a cached, unexpired host returns right away; only a miss asks
+ *  the resolver. DnsCache_Refresh, called periodically from a background
+ *  task, resolves a host again once RefreshPercent of its TTL elapsed, so the
+ *  hosts registered with DnsCache_AddHost and the hosts in use never expire
+ *  in front of a request.
+ *
+ *  When the resolver fails (no answer, server failure) a lookup returns the
+ *  last address of the host even if it expired, then the fallback address of
+ *  the host: a configured one or the last good address of a previous run,
+ *  see DnsCache_Export / DnsCache_Import. Resolution failures are retried no
+ *  more often than every RetryMs, requests in the meantime get the stale or
+ *  fallback address at once.
+ *
+ *  Lookups of dotted IPv4 addresses are answered without the resolver. The
+ *  module is platform independent; DnsAgent runs it on the XDK.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DNSCACHE_H_
+#define DNSCACHE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Hosts a cache holds; a new host replaces the least recently used one which was not added with DnsCache_AddHost */
+#define DNS_CACHE_MAX_ENTRIES           UINT8_C(4)
+
+/** Bytes per host written by DnsCache_Export */
+#define DNS_CACHE_EXPORT_ENTRY_SIZE     UINT8_C(8)
+
+/** Longest dotted IPv4 address including the terminating 0 */
+#define DNS_CACHE_ADDRESS_STRING_SIZE   UINT8_C(16)
+
+/**
+ * @brief Resolves host to an IPv4 address in host byte order.
+ *
+ * Sets ttlS to the time to live of the record, or to 0 if the resolver does
+ * not know it (DefaultTtlS is used then).
+ */
+typedef bool (*DnsCache_ResolveFunc_T)(void * context, const char * host, uint32_t * address, uint32_t * ttlS);
+
+/**
+ * @brief Cache configuration, copied by DnsCache_Init.
+ */
+struct DnsCache_Setup_S
+{
+    DnsCache_ResolveFunc_T Resolve;
+    void * Context; /**< Passed to Resolve */
+    uint32_t (*NowMs)(void); /**< Monotonic time in milliseconds */
+    uint32_t DefaultTtlS; /**< TTL of addresses from a resolver which does not report one */
+    uint32_t MinTtlS; /**< Lower bound of the TTL, against resolvers answering 0 */
+    uint32_t MaxTtlS; /**< Upper bound of the TTL, a moved server is noticed after this time at the latest */
+    uint8_t RefreshPercent; /**< Share of the TTL after which DnsCache_Refresh resolves again, 1 to 100 */
+    uint32_t RetryMs; /**< Shortest time between resolution attempts of a failing host */
+};
+typedef struct DnsCache_Setup_S DnsCache_Setup_T;
+
+/**
+ * @brief One cached host.
+ */
+struct DnsCache_Entry_S
+{
+    const char * Host; /**< NULL for a free entry; must stay valid while cached */
+    uint32_t Address; /**< Last resolved address, 0 if none yet */
+    uint32_t FallbackAddress; /**< Used while the host cannot be resolved and has no address, 0 for none */
+    uint32_t ResolvedMs; /**< Time of the last resolution */
+    uint32_t TtlMs;
+    uint32_t LastUseMs; /**< Time of the last lookup */
+    uint32_t LastAttemptMs; /**< Time of the last failed resolution */
+    bool IsFailing; /**< The last resolution failed */
+    bool IsPinned; /**< Added with DnsCache_AddHost: never replaced, always refreshed */
+};
+typedef struct DnsCache_Entry_S DnsCache_Entry_T;
+
+/**
+ * @brief Counters of a cache.
+ */
+struct DnsCache_Statistics_S
+{
+    uint32_t Hits; /**< Lookups answered with an unexpired address */
+    uint32_t Misses; /**< Lookups which waited for the resolver */
+    uint32_t Stale; /**< Lookups answered with an expired address, the resolver failing */
+    uint32_t Fallbacks; /**< Lookups answered with the fallback address */
+    uint32_t Failures; /**< Lookups without any address */
+    uint32_t Refreshes; /**< Resolutions done by DnsCache_Refresh */
+    uint32_t Changes; /**< Resolutions which returned another address than before */
+    uint32_t Resolutions; /**< Resolver calls */
+    uint32_t ResolverFailures;
+    uint32_t ResolveLastMs; /**< Duration of the last resolver call */
+    uint32_t ResolveMaxMs;
+    uint32_t ResolveTotalMs;
+};
+typedef struct DnsCache_Statistics_S DnsCache_Statistics_T;
+
+/**
+ * @brief Cache state.
+ */
+struct DnsCache_S
+{
+    DnsCache_Setup_T Setup;
+    DnsCache_Entry_T Entries[DNS_CACHE_MAX_ENTRIES];
+    bool IsExportDue; /**< An address changed since the last DnsCache_Export */
+    DnsCache_Statistics_T Statistics;
+};
+typedef struct DnsCache_S DnsCache_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes an empty cache.
+ *
+ * @return false if a parameter is missing or out of range.
+ */
+bool DnsCache_Init(DnsCache_T * cache, const DnsCache_Setup_T * setup);
+
+/**
+ * @brief Adds a host which stays in the cache and is kept fresh by DnsCache_Refresh.
+ *
+ * @param[in] fallbackAddress
+ * Address used while the host cannot be resolved, 0 for none
+ *
+ * @return false if the cache is full of added hosts.
+ */
+bool DnsCache_AddHost(DnsCache_T * cache, const char * host, uint32_t fallbackAddress);
+
+/**
+ * @brief Returns the address of host, from the cache if possible.
+ *
+ * @return false if the host could neither be resolved nor has a stale or fallback address.
+ */
+bool DnsCache_Lookup(DnsCache_T * cache, const char * host, uint32_t * address);
+
+/**
+ * @brief Resolves the hosts whose refresh time passed: added hosts, and other hosts looked up since their last resolution.
+ *
+ * @return The number of hosts resolved.
+ */
+uint8_t DnsCache_Refresh(DnsCache_T * cache);
+
+/**
+ * @brief Forgets the addresses of all hosts, e.g. when the network changed; the hosts and fallbacks are kept.
+ */
+void DnsCache_Flush(DnsCache_T * cache);
+
+/**
+ * @brief Writes the last good address of every host with one, for DnsCache_Import after a restart.
+ *
+ * Clears IsExportDue.
+ *
+ * @return The number of bytes written, DNS_CACHE_EXPORT_ENTRY_SIZE per host.
+ */
+uint16_t DnsCache_Export(DnsCache_T * cache, uint8_t * buffer, uint16_t size);
+
+/**
+ * @brief Sets the fallback address of the added hosts found in data written by DnsCache_Export.
+ *
+ * A host is recognised by a hash of its name.
+ *
+ * @return The number of hosts updated.
+ */
+uint8_t DnsCache_Import(DnsCache_T * cache, const uint8_t * data, uint16_t length);
+
+/**
+ * @brief Parses a dotted IPv4 address like "192.168.0.1".
+ *
+ * @param[out] address
+ * Host byte order
+ *
+ * @return false if text is no dotted IPv4 address.
+ */
+bool DnsCache_ParseAddress(const char * text, uint32_t * address);
+
+/**
+ * @brief Writes address as dotted IPv4 text into a buffer of DNS_CACHE_ADDRESS_STRING_SIZE bytes.
+ */
+void DnsCache_FormatAddress(uint32_t address, char * text);
+
+#endif /* DNSCACHE_H_ */
@@ -0,0 +1,212 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the DNS query writer and response parser.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "DnsMessage.h"
+
+/* system header files */
+#include <stddef.h>
+
+/* local type and macro definitions */
+
+#define DNS_MESSAGE_HEADER_SIZE         UINT16_C(12)
+#define DNS_MESSAGE_MAX_LABEL           UINT8_C(63)
+#define DNS_MESSAGE_MAX_NAME            UINT16_C(255)
+
+#define DNS_MESSAGE_FLAG_RESPONSE       UINT8_C(0x80) /**< QR, first flag byte */
+#define DNS_MESSAGE_FLAG_TRUNCATED      UINT8_C(0x02) /**< TC, first flag byte */
+#define DNS_MESSAGE_FLAG_RECURSION      UINT8_C(0x01) /**< RD, first flag byte */
+#define DNS_MESSAGE_OPCODE_MASK         UINT8_C(0x78)
+#define DNS_MESSAGE_RCODE_MASK          UINT8_C(0x0F) /**< Second flag byte */
+#define DNS_MESSAGE_RCODE_NXDOMAIN      UINT8_C(3)
+
+#define DNS_MESSAGE_TYPE_A              UINT16_C(1)
+#define DNS_MESSAGE_TYPE_CNAME          UINT16_C(5)
+#define DNS_MESSAGE_CLASS_IN            UINT16_C(1)
+
+#define DNS_MESSAGE_POINTER             UINT8_C(0xC0) /**< Compressed name: the rest is elsewhere in the message */
+
+/* local functions ********************************************************** */
+
+static uint16_t MessageRead16(const uint8_t * data)
+{
+    return (uint16_t) (((uint16_t) data[0] << 8) | data[1]);
+}
+
+static uint32_t MessageRead32(const uint8_t * data)
+{
+    return ((uint32_t) data[0] << 24) | ((uint32_t) data[1] << 16) | ((uint32_t) data[2] << 8) | data[3];
+}
+
+static void MessageWrite16(uint8_t * data, uint16_t value)
+{
+    data[0] = (uint8_t) (value >> 8);
+    data[1] = (uint8_t) value;
+}
+
+/**
+ * @brief Skips a name at offset, which may end in a pointer to a name elsewhere.
+ *
+ * @return The offset after the name, 0 if it runs past length.
+ */
+static uint16_t MessageSkipName(const uint8_t * message, uint16_t length, uint16_t offset)
+{
+    while (offset < length)
+    {
+        uint8_t label = message[offset];
+
+        if (0U == label)
+        {
+            return offset + 1U;
+        }
+        if (DNS_MESSAGE_POINTER == (label & DNS_MESSAGE_POINTER))
+        {
+            return ((offset + 2U) <= length) ? (offset + 2U) : 0U;
+        }
+        if (label > DNS_MESSAGE_MAX_LABEL)
+        {
+            return 0U;
+        }
+        offset += label + 1U;
+    }
+    return 0U;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+uint16_t DnsMessage_WriteQuery(uint8_t * buffer, uint16_t size, uint16_t id, const char * host)
+{
+    uint16_t length = DNS_MESSAGE_HEADER_SIZE;
+    uint16_t labelOffset;
+    uint16_t labelLength;
+    uint16_t nameLength = 0U;
+
+    if ((NULL == buffer) || (NULL == host) || ('\0' == host[0]) || (size < DNS_MESSAGE_HEADER_SIZE))
+    {
+        return 0U;
+    }
+    MessageWrite16(&buffer[0], id);
+    buffer[2] = DNS_MESSAGE_FLAG_RECURSION;
+    buffer[3] = 0U;
+    MessageWrite16(&buffer[4], 1U);
+    MessageWrite16(&buffer[6], 0U);
+    MessageWrite16(&buffer[8], 0U);
+    MessageWrite16(&buffer[10], 0U);
+
+    /* "a.example" becomes 1 'a' 7 'example' 0 */
+    while ('\0' != *host)
+    {
+        labelOffset = length++;
+        while (('\0' != *host) && ('.' != *host))
+        {
+            if (length >= size)
+            {
+                return 0U;
+            }
+            buffer[length++] = (uint8_t) *host++;
+        }
+        labelLength = length - labelOffset - 1U;
+        if ((0U == labelLength) || (labelLength > DNS_MESSAGE_MAX_LABEL))
+        {
+            return 0U;
+        }
+        buffer[labelOffset] = (uint8_t) labelLength;
+        nameLength += labelLength + 1U;
+        if ('.' == *host)
+        {
+            host++; /* A trailing dot is the root, which the terminating 0 below already is */
+        }
+    }
+    if (((nameLength + 1U) > DNS_MESSAGE_MAX_NAME) || ((length + 5U) > size))
+    {
+        return 0U;
+    }
+    buffer[length++] = 0U;
+    MessageWrite16(&buffer[length], DNS_MESSAGE_TYPE_A);
+    MessageWrite16(&buffer[length + 2U], DNS_MESSAGE_CLASS_IN);
+    return length + 4U;
+}
+
+/** Refer interface header for description */
+DnsMessage_Result_T DnsMessage_ParseResponse(const uint8_t * message, uint16_t length, uint16_t id, uint32_t * address, uint32_t * ttlS)
+{
+    uint16_t offset;
+    uint16_t answers;
+    uint16_t type;
+    uint16_t recordClass;
+    uint16_t dataLength;
+    uint32_t recordTtlS;
+    uint32_t lowestTtlS = UINT32_MAX;
+
+    if ((NULL == message) || (NULL == address) || (NULL == ttlS) || (length < DNS_MESSAGE_HEADER_SIZE) ||
+            (MessageRead16(&message[0]) != id) || (0U == (message[2] & DNS_MESSAGE_FLAG_RESPONSE)) ||
+            (0U != (message[2] & (DNS_MESSAGE_OPCODE_MASK | DNS_MESSAGE_FLAG_TRUNCATED))) || (1U != MessageRead16(&message[4])))
+    {
+        return DNS_MESSAGE_RESULT_INVALID;
+    }
+    if (DNS_MESSAGE_RCODE_NXDOMAIN == (message[3] & DNS_MESSAGE_RCODE_MASK))
+    {
+        return DNS_MESSAGE_RESULT_NOT_FOUND;
+    }
+    if (0U != (message[3] & DNS_MESSAGE_RCODE_MASK))
+    {
+        return DNS_MESSAGE_RESULT_FAILURE;
+    }
+    answers = MessageRead16(&message[6]);
+
+    /* The question */
+    offset = MessageSkipName(message, length, DNS_MESSAGE_HEADER_SIZE);
+    if ((0U == offset) || ((offset + 4U) > length))
+    {
+        return DNS_MESSAGE_RESULT_INVALID;
+    }
+    offset += 4U;
+
+    /* The answers: CNAME records of the chain, then the addresses of its last name */
+    while (0U != answers--)
+    {
+        offset = MessageSkipName(message, length, offset);
+        if ((0U == offset) || ((offset + 10U) > length))
+        {
+            return DNS_MESSAGE_RESULT_INVALID;
+        }
+        type = MessageRead16(&message[offset]);
+        recordClass = MessageRead16(&message[offset + 2U]);
+        recordTtlS = MessageRead32(&message[offset + 4U]);
+        dataLength = MessageRead16(&message[offset + 8U]);
+        offset += 10U;
+        if ((offset + dataLength) > length)
+        {
+            return DNS_MESSAGE_RESULT_INVALID;
+        }
+        if (recordTtlS > INT32_MAX)
+        {
+            recordTtlS = 0UL; /* RFC 2181: a TTL with the top bit set counts as 0 */
+        }
+        if (DNS_MESSAGE_CLASS_IN == recordClass)
+        {
+            if ((DNS_MESSAGE_TYPE_CNAME == type) || ((DNS_MESSAGE_TYPE_A == type) && (4U == dataLength)))
+            {
+                if (recordTtlS < lowestTtlS)
+                {
+                    lowestTtlS = recordTtlS;
+                }
+            }
+            if ((DNS_MESSAGE_TYPE_A == type) && (4U == dataLength))
+            {
+                *address = MessageRead32(&message[offset]);
+                *ttlS = lowestTtlS;
+                return DNS_MESSAGE_RESULT_ADDRESS;
+            }
+        }
+        offset += dataLength;
+    }
+    return DNS_MESSAGE_RESULT_NOT_FOUND;
+}
@@ -0,0 +1,69 @@
+/**
+ *  @file
+ *
+ *  @brief DNS query writer and response parser for IPv4 address (A) lookups.
+ *
+ *  The resolver of the WLAN chip (sl_NetAppDnsGetHostByName) returns the
+ *  address only, without the time to live of the record. DnsCache needs the
+ *  TTL to keep an address exactly as long as its owner allows, so DnsAgent
+ *  sends its own query over UDP and parses the response with this module.
+ *
+ *  Only what an A lookup needs is supported: one question, recursion desired,
+ *  compressed names and CNAME chains in the answer section. The module is
+ *  platform independent.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DNSMESSAGE_H_
+#define DNSMESSAGE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+#define DNS_MESSAGE_PORT                UINT16_C(53)
+
+/** Largest DNS message over UDP without EDNS */
+#define DNS_MESSAGE_MAX_SIZE            UINT16_C(512)
+
+/**
+ * @brief Result of parsing a response.
+ */
+enum DnsMessage_Result_E
+{
+    DNS_MESSAGE_RESULT_ADDRESS = 0, /**< An A record was found */
+    DNS_MESSAGE_RESULT_NOT_FOUND, /**< NXDOMAIN or no A record */
+    DNS_MESSAGE_RESULT_FAILURE, /**< Server failure or refusal, try again later */
+    DNS_MESSAGE_RESULT_INVALID, /**< Malformed, truncated or not the answer to our query */
+};
+typedef enum DnsMessage_Result_E DnsMessage_Result_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Writes an A query for host.
+ *
+ * @param[in] id
+ * Query ID, the response carries it back
+ *
+ * @return The message length, 0 if it does not fit or host is no valid name.
+ */
+uint16_t DnsMessage_WriteQuery(uint8_t * buffer, uint16_t size, uint16_t id, const char * host);
+
+/**
+ * @brief Parses the response to a query written by DnsMessage_WriteQuery.
+ *
+ * @param[out] address
+ * First IPv4 address of the answer, host byte order
+ *
+ * @param[out] ttlS
+ * Time to live in seconds, the lowest one of the CNAME chain and the address
+ *
+ * @return DNS_MESSAGE_RESULT_ADDRESS if address and ttlS are set.
+ */
+DnsMessage_Result_T DnsMessage_ParseResponse(const uint8_t * message, uint16_t length, uint16_t id, uint32_t * address, uint32_t * ttlS);
+
+#endif /* DNSMESSAGE_H_ */
@@ -0,0 +1,458 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the HTTP/1.1 message framing.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "HttpMessage.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Compares the start of a line case insensitively, as header names are.
+ */
+static bool MessageStartsWith(const char * line, const char * prefix)
+{
+    char lineChar;
+    char prefixChar;
+
+    while ('\0' != *prefix)
+    {
+        lineChar = *line;
+        prefixChar = *prefix;
+        if ((lineChar >= 'A') && (lineChar <= 'Z'))
+        {
+            lineChar = (char) (lineChar - 'A' + 'a');
+        }
+        if ((prefixChar >= 'A') && (prefixChar <= 'Z'))
+        {
+            prefixChar = (char) (prefixChar - 'A' + 'a');
+        }
+        if (lineChar != prefixChar)
+        {
+            return false;
+        }
+        line++;
+        prefix++;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns true if a comma separated header value contains token.
+ */
+static bool MessageHasToken(const char * value, const char * token)
+{
+    while ('\0' != *value)
+    {
+        while ((' ' == *value) || (',' == *value))
+        {
+            value++;
+        }
+        if (MessageStartsWith(value, token))
+        {
+            return true;
+        }
+        while (('\0' != *value) && (',' != *value))
+        {
+            value++;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Copies a space delimited word of the start line.
+ *
+ * @return Start of the next word.
+ */
+static const char * MessageCopyWord(const char * line, char * word, uint32_t size)
+{
+    uint32_t length = 0UL;
+
+    while (('\0' != *line) && (' ' != *line))
+    {
+        if ((length + 1UL) < size)
+        {
+            word[length++] = *line;
+        }
+        line++;
+    }
+    word[length] = '\0';
+    while (' ' == *line)
+    {
+        line++;
+    }
+    return line;
+}
+
+/**
+ * @brief Returns true for responses which never have a body, whatever their headers say.
+ */
+static bool MessageIsBodyless(const HttpMessage_Head_T * head)
+{
+    return (head->IsResponse && ((head->Status < 200U) || (204U == head->Status) || (304U == head->Status)));
+}
+
+/**
+ * @brief Parses one character of a chunk size line.
+ */
+static void MessageParseChunkSize(HttpMessage_Head_T * head, char character)
+{
+    uint32_t digit;
+
+    if ('\n' == character)
+    {
+        head->ChunkState = (0UL == head->ChunkRemaining) ? HTTP_MESSAGE_CHUNK_TRAILER : HTTP_MESSAGE_CHUNK_DATA;
+        head->IsChunkExtension = false;
+        head->LineLength = 0U;
+        return;
+    }
+    if ((character >= '0') && (character <= '9'))
+    {
+        digit = (uint32_t) (character - '0');
+    }
+    else if ((character >= 'a') && (character <= 'f'))
+    {
+        digit = (uint32_t) (character - 'a' + 10);
+    }
+    else if ((character >= 'A') && (character <= 'F'))
+    {
+        digit = (uint32_t) (character - 'A' + 10);
+    }
+    else
+    {
+        /* ';' starts an extension, '\r' ends the line */
+        head->IsChunkExtension = true;
+        return;
+    }
+    if (!head->IsChunkExtension)
+    {
+        if (head->ChunkRemaining > (UINT32_MAX >> 4))
+        {
+            head->State = HTTP_MESSAGE_STATE_ERROR;
+            return;
+        }
+        head->ChunkRemaining = (head->ChunkRemaining << 4) | digit;
+    }
+}
+
+/**
+ * @brief Removes the chunk framing in place.
+ *
+ * @return Number of data bytes moved to the start of data.
+ */
+static uint32_t MessageDecodeChunked(HttpMessage_Head_T * head, uint8_t * data, uint32_t length)
+{
+    uint32_t in = 0UL;
+    uint32_t out = 0UL;
+    uint32_t count;
+
+    while ((in < length) && (HTTP_MESSAGE_CHUNK_DONE != head->ChunkState) && (HTTP_MESSAGE_STATE_ERROR != head->State))
+    {
+        switch (head->ChunkState)
+        {
+        case HTTP_MESSAGE_CHUNK_SIZE:
+            MessageParseChunkSize(head, (char) data[in++]);
+            break;
+        case HTTP_MESSAGE_CHUNK_DATA:
+            count = length - in;
+            if (count > head->ChunkRemaining)
+            {
+                count = head->ChunkRemaining;
+            }
+            memmove(&data[out], &data[in], count);
+            in += count;
+            out += count;
+            head->ChunkRemaining -= count;
+            if (0UL == head->ChunkRemaining)
+            {
+                head->ChunkState = HTTP_MESSAGE_CHUNK_DATA_END;
+            }
+            break;
+        case HTTP_MESSAGE_CHUNK_DATA_END:
+            if ('\n' == (char) data[in++])
+            {
+                head->ChunkState = HTTP_MESSAGE_CHUNK_SIZE;
+            }
+            break;
+        default:
+            /* Trailer lines up to an empty line */
+            if ('\n' == (char) data[in])
+            {
+                if (0U == head->LineLength)
+                {
+                    head->ChunkState = HTTP_MESSAGE_CHUNK_DONE;
+                }
+                head->LineLength = 0U;
+            }
+            else if ('\r' != (char) data[in])
+            {
+                head->LineLength++;
+            }
+            in++;
+            break;
+        }
+    }
+    return out;
+}
+
+static void MessageParseStartLine(HttpMessage_Head_T * head)
+{
+    char version[12];
+    const char * position = head->Line;
+    uint32_t status = 0UL;
+
+    if (head->IsResponse)
+    {
+        position = MessageCopyWord(position, version, sizeof(version));
+        while ((*position >= '0') && (*position <= '9'))
+        {
+            status = (status * 10UL) + (uint32_t) (*position - '0');
+            position++;
+        }
+        head->Status = (uint16_t) status;
+        if ((status < 100UL) || (status > 999UL))
+        {
+            head->State = HTTP_MESSAGE_STATE_ERROR;
+        }
+        if (MessageIsBodyless(head))
+        {
+            head->HasContentLength = true;
+        }
+    }
+    else
+    {
+        position = MessageCopyWord(position, head->Method, sizeof(head->Method));
+        position = MessageCopyWord(position, head->Path, sizeof(head->Path));
+        (void) MessageCopyWord(position, version, sizeof(version));
+        if (('\0' == head->Method[0]) || ('/' != head->Path[0]))
+        {
+            head->State = HTTP_MESSAGE_STATE_ERROR;
+        }
+    }
+    if (!MessageStartsWith(version, "HTTP/1."))
+    {
+        head->State = HTTP_MESSAGE_STATE_ERROR;
+    }
+    /* HTTP/1.0 closes unless it asks for keep-alive */
+    head->IsClose = (0 == strcmp(version, "HTTP/1.0"));
+}
+
+static void MessageParseHeader(HttpMessage_Head_T * head)
+{
+    const char * value = strchr(head->Line, ':');
+    uint32_t contentLength = 0UL;
+
+    if (NULL == value)
+    {
+        return;
+    }
+    value++;
+    while (' ' == *value)
+    {
+        value++;
+    }
+    if (MessageStartsWith(head->Line, "Content-Length:"))
+    {
+        if (MessageIsBodyless(head))
+        {
+            /* Describes the resource, not this response */
+            return;
+        }
+        while ((*value >= '0') && (*value <= '9'))
+        {
+            contentLength = (contentLength * 10UL) + (uint32_t) (*value - '0');
+            value++;
+        }
+        head->ContentLength = contentLength;
+        head->HasContentLength = true;
+    }
+    else if (MessageStartsWith(head->Line, "Connection:"))
+    {
+        if (MessageHasToken(value, "close"))
+        {
+            head->IsClose = true;
+        }
+        else if (MessageHasToken(value, "keep-alive"))
+        {
+            head->IsClose = false;
+        }
+    }
+    else if (MessageStartsWith(head->Line, "Transfer-Encoding:") && !MessageIsBodyless(head))
+    {
+        head->IsChunked = MessageHasToken(value, "chunked");
+    }
+    else if ((head->IsResponse ? MessageStartsWith(head->Line, "ETag:") : MessageStartsWith(head->Line, "If-None-Match:")) &&
+            (strlen(value) < sizeof(head->ETag)))
+    {
+        /* A truncated tag would never match, the client sends it back verbatim */
+        strcpy(head->ETag, value);
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+void HttpMessage_InitHead(HttpMessage_Head_T * head, bool isResponse)
+{
+    if (NULL != head)
+    {
+        memset(head, 0, sizeof(*head));
+        head->State = HTTP_MESSAGE_STATE_START_LINE;
+        head->IsResponse = isResponse;
+    }
+}
+
+/** Refer interface header for description */
+uint32_t HttpMessage_ParseHead(HttpMessage_Head_T * head, const uint8_t * data, uint32_t length)
+{
+    uint32_t consumed = 0UL;
+    char character;
+
+    if ((NULL == head) || (NULL == data))
+    {
+        return 0UL;
+    }
+    while ((consumed < length) && ((HTTP_MESSAGE_STATE_START_LINE == head->State) || (HTTP_MESSAGE_STATE_HEADERS == head->State)))
+    {
+        character = (char) data[consumed++];
+        if ('\r' == character)
+        {
+            continue;
+        }
+        if ('\n' != character)
+        {
+            if ((head->LineLength + 1U) < HTTP_MESSAGE_MAX_LINE)
+            {
+                head->Line[head->LineLength++] = character;
+            }
+            continue;
+        }
+        head->Line[head->LineLength] = '\0';
+        if (HTTP_MESSAGE_STATE_START_LINE == head->State)
+        {
+            head->State = HTTP_MESSAGE_STATE_HEADERS;
+            MessageParseStartLine(head);
+        }
+        else if (0U == head->LineLength)
+        {
+            head->State = HTTP_MESSAGE_STATE_BODY;
+        }
+        else
+        {
+            MessageParseHeader(head);
+        }
+        head->LineLength = 0U;
+    }
+    return consumed;
+}
+
+/** Refer interface header for description */
+bool HttpMessage_IsBodyDelimited(const HttpMessage_Head_T * head)
+{
+    if (NULL == head)
+    {
+        return false;
+    }
+    /* A request without Content-Length has no body, a response runs until the connection closes */
+    return (head->IsChunked || head->HasContentLength || (!head->IsResponse));
+}
+
+/** Refer interface header for description */
+uint32_t HttpMessage_ReceiveBody(HttpMessage_Head_T * head, uint8_t * data, uint32_t length)
+{
+    if ((NULL == head) || (NULL == data) || (HTTP_MESSAGE_STATE_BODY != head->State))
+    {
+        return 0UL;
+    }
+    if (head->IsChunked)
+    {
+        length = MessageDecodeChunked(head, data, length);
+    }
+    else if (HttpMessage_IsBodyDelimited(head) && (length > (head->ContentLength - head->BodyReceived)))
+    {
+        length = head->ContentLength - head->BodyReceived;
+    }
+    head->BodyReceived += length;
+    return length;
+}
+
+/** Refer interface header for description */
+bool HttpMessage_IsBodyComplete(const HttpMessage_Head_T * head)
+{
+    if ((NULL == head) || (HTTP_MESSAGE_STATE_BODY != head->State))
+    {
+        return false;
+    }
+    if (head->IsChunked)
+    {
+        return (HTTP_MESSAGE_CHUNK_DONE == head->ChunkState);
+    }
+    return (HttpMessage_IsBodyDelimited(head) && (head->BodyReceived >= head->ContentLength));
+}
+
+/** Refer interface header for description */
+uint32_t HttpMessage_WriteRequestHead(char * buffer, uint32_t size, const HttpMessage_Request_T * request)
+{
+    int written;
+    int bodyWritten = 0;
+
+    if ((NULL == buffer) || (NULL == request) || (NULL == request->Method) || (NULL == request->Host) || (NULL == request->Path))
+    {
+        return 0UL;
+    }
+    written = snprintf(buffer, size, "%s %s HTTP/1.1\r\nHost: %s\r\nConnection: %s\r\n%s", request->Method, request->Path,
+            request->Host, request->IsClose ? "close" : "keep-alive", (NULL != request->ExtraHeaders) ? request->ExtraHeaders : "");
+    if ((written > 0) && ((uint32_t) written < size) && (NULL != request->ContentType))
+    {
+        if (request->IsChunked)
+        {
+            bodyWritten = snprintf(&buffer[written], size - (uint32_t) written, "Content-Type: %s\r\nTransfer-Encoding: chunked\r\n",
+                    request->ContentType);
+        }
+        else
+        {
+            bodyWritten = snprintf(&buffer[written], size - (uint32_t) written, "Content-Type: %s\r\nContent-Length: %lu\r\n",
+                    request->ContentType, (unsigned long) request->ContentLength);
+        }
+        written = (bodyWritten < 0) ? bodyWritten : (written + bodyWritten);
+    }
+    if ((written > 0) && ((uint32_t) written < size))
+    {
+        bodyWritten = snprintf(&buffer[written], size - (uint32_t) written, "\r\n");
+        written = (bodyWritten < 0) ? bodyWritten : (written + bodyWritten);
+    }
+    if ((written <= 0) || ((uint32_t) written >= size))
+    {
+        return 0UL;
+    }
+    return (uint32_t) written;
+}
+
+/** Refer interface header for description */
+uint32_t HttpMessage_WriteResponseHead(char * buffer, uint32_t size, uint16_t status, const char * reason, const char * contentType,
+        uint32_t contentLength, bool isClose)
+{
+    int written;
+
+    if ((NULL == buffer) || (NULL == reason) || (NULL == contentType))
+    {
+        return 0UL;
+    }
+    written = snprintf(buffer, size, "HTTP/1.1 %u %s\r\nContent-Type: %s\r\nContent-Length: %lu\r\nConnection: %s\r\n\r\n",
+            (unsigned int) status, reason, contentType, (unsigned long) contentLength, isClose ? "close" : "keep-alive");
+    if ((written <= 0) || ((uint32_t) written >= size))
+    {
+        return 0UL;
+    }
+    return (uint32_t) written;
+}
@@ -0,0 +1,153 @@
+/**
+ *  @file
+ *
+ *  @brief HTTP/1.1 message framing: request and response heads, and an
+ *  incremental parser for received heads.
+ *
+ *  Platform independent, used by HttpsSession on the device and by the host
+ *  tools. The parser keeps only what a client or a small server acts on: the
+ *  status code or the method and path, Content-Length, Connection,
+ *  Transfer-Encoding and the entity tag (ETag, If-None-Match).
+ *  HttpMessage_ReceiveBody then finds the end of the body, which a connection
+ *  kept open for the next message depends on, and removes the chunked
+ *  framing in place.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef HTTPMESSAGE_H_
+#define HTTPMESSAGE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+#define HTTP_MESSAGE_MAX_LINE               UINT16_C(128) /**< Longer header lines are truncated */
+#define HTTP_MESSAGE_MAX_METHOD             UINT8_C(8)
+#define HTTP_MESSAGE_MAX_PATH               UINT8_C(64)
+#define HTTP_MESSAGE_MAX_ETAG               UINT8_C(48) /**< Longer entity tags are dropped, not truncated */
+
+/**
+ * @brief Parser state.
+ */
+enum HttpMessage_State_E
+{
+    HTTP_MESSAGE_STATE_START_LINE = 0,
+    HTTP_MESSAGE_STATE_HEADERS,
+    HTTP_MESSAGE_STATE_BODY, /**< Head complete, the body follows */
+    HTTP_MESSAGE_STATE_ERROR
+};
+typedef enum HttpMessage_State_E HttpMessage_State_T;
+
+/**
+ * @brief Decoder state of a chunked body.
+ */
+enum HttpMessage_ChunkState_E
+{
+    HTTP_MESSAGE_CHUNK_SIZE = 0,
+    HTTP_MESSAGE_CHUNK_DATA,
+    HTTP_MESSAGE_CHUNK_DATA_END, /**< CRLF after the data */
+    HTTP_MESSAGE_CHUNK_TRAILER,
+    HTTP_MESSAGE_CHUNK_DONE
+};
+typedef enum HttpMessage_ChunkState_E HttpMessage_ChunkState_T;
+
+/**
+ * @brief Received head of a request or response.
+ */
+struct HttpMessage_Head_S
+{
+    HttpMessage_State_T State;
+    bool IsResponse;
+    uint16_t Status; /**< Responses only */
+    char Method[HTTP_MESSAGE_MAX_METHOD]; /**< Requests only */
+    char Path[HTTP_MESSAGE_MAX_PATH]; /**< Requests only, truncated if longer */
+    char ETag[HTTP_MESSAGE_MAX_ETAG]; /**< ETag of a response, If-None-Match of a request, with the quotes; empty if none */
+    bool HasContentLength;
+    uint32_t ContentLength;
+    bool IsChunked;
+    bool IsClose; /**< Connection: close, or HTTP/1.0 without keep-alive */
+    uint32_t BodyReceived; /**< Body bytes passed to HttpMessage_ReceiveBody, without chunk framing */
+    HttpMessage_ChunkState_T ChunkState;
+    uint32_t ChunkRemaining; /**< Size being parsed, then data bytes left of the chunk */
+    bool IsChunkExtension; /**< Skipping a chunk extension up to the end of the size line */
+    uint16_t LineLength;
+    char Line[HTTP_MESSAGE_MAX_LINE];
+};
+typedef struct HttpMessage_Head_S HttpMessage_Head_T;
+
+/**
+ * @brief Request head to write.
+ */
+struct HttpMessage_Request_S
+{
+    const char * Method;
+    const char * Host;
+    const char * Path;
+    const char * ContentType; /**< NULL for a request without body */
+    uint32_t ContentLength;
+    bool IsChunked; /**< Transfer-Encoding: chunked instead of ContentLength */
+    const char * ExtraHeaders; /**< Complete header lines ending with CRLF, or NULL */
+    bool IsClose; /**< Asks the server to close the connection after the response */
+};
+typedef struct HttpMessage_Request_S HttpMessage_Request_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Prepares the parsing of a head.
+ *
+ * @param[in] isResponse
+ * true for a response head, false for a request head
+ */
+void HttpMessage_InitHead(HttpMessage_Head_T * head, bool isResponse);
+
+/**
+ * @brief Parses received bytes of a head, may be called with any fragmentation.
+ *
+ * @return Number of bytes consumed; less than length once the head is
+ * complete (State HTTP_MESSAGE_STATE_BODY), the rest belongs to the body.
+ */
+uint32_t HttpMessage_ParseHead(HttpMessage_Head_T * head, const uint8_t * data, uint32_t length);
+
+/**
+ * @brief Returns true if the end of the body can be detected, i.e. the
+ * connection can carry another message after it. Otherwise the body of a
+ * response runs until the server closes the connection.
+ */
+bool HttpMessage_IsBodyDelimited(const HttpMessage_Head_T * head);
+
+/**
+ * @brief Passes received body bytes, i.e. the bytes after the head.
+ *
+ * @param[in,out] data
+ * Received bytes, the chunk framing is removed in place
+ *
+ * @return Number of body bytes now at the start of data; bytes beyond the end
+ * of the body are dropped.
+ */
+uint32_t HttpMessage_ReceiveBody(HttpMessage_Head_T * head, uint8_t * data, uint32_t length);
+
+/**
+ * @brief Returns true once the whole body of a delimited message was received.
+ */
+bool HttpMessage_IsBodyComplete(const HttpMessage_Head_T * head);
+
+/**
+ * @brief Writes a request head.
+ *
+ * @return Length written without the terminating zero, 0 if the buffer is too small.
+ */
+uint32_t HttpMessage_WriteRequestHead(char * buffer, uint32_t size, const HttpMessage_Request_T * request);
+
+/**
+ * @brief Writes a response head with a Content-Length.
+ *
+ * @return Length written without the terminating zero, 0 if the buffer is too small.
+ */
+uint32_t HttpMessage_WriteResponseHead(char * buffer, uint32_t size, uint16_t status, const char * reason, const char * contentType,
+        uint32_t contentLength, bool isClose);
+
+#endif /* HTTPMESSAGE_H_ */
@@ -0,0 +1,329 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the HTTPS agent.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_HTTPS_AGENT
+
+#include "HttpsAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "simplelink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* constant definitions ***************************************************** */
+
+#define HTTPS_AGENT_SEGMENT_SIZE        UINT16_C(1400) /**< Largest sl_Send / sl_Recv */
+
+/* local variables ********************************************************** */
+
+/**
+ * Secure mask bit of every cipher suite, 0 where the SimpleLink version of the
+ * SDK does not know the suite.
+ */
+static const uint32_t AgentCipherMasks[HTTPS_SESSION_CIPHER_COUNT] =
+        {
+#ifdef SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256] = SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+#endif
+#ifdef SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256] = SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_128_CBC_SHA256,
+#endif
+#ifdef SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA] = SL_SEC_MASK_TLS_ECDHE_ECDSA_WITH_AES_256_CBC_SHA,
+#endif
+#ifdef SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256] = SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+#endif
+#ifdef SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256] = SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_128_CBC_SHA256,
+#endif
+#ifdef SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA] = SL_SEC_MASK_TLS_ECDHE_RSA_WITH_AES_256_CBC_SHA,
+#endif
+#ifdef SL_SEC_MASK_TLS_RSA_WITH_AES_128_CBC_SHA256
+                [HTTPS_SESSION_CIPHER_RSA_AES128_CBC_SHA256] = SL_SEC_MASK_TLS_RSA_WITH_AES_128_CBC_SHA256,
+#endif
+#ifdef SL_SEC_MASK_TLS_RSA_WITH_AES_256_CBC_SHA
+                [HTTPS_SESSION_CIPHER_RSA_AES256_CBC_SHA] = SL_SEC_MASK_TLS_RSA_WITH_AES_256_CBC_SHA,
+#endif
+        };
+
+static const HttpsAgent_Setup_T * AgentSetup = NULL;
+
+static HttpsSession_T AgentSession;
+
+static int16_t AgentSocket = -1;
+
+static uint32_t AgentStackLeftMin = UINT32_MAX; /**< Least stack ever left to a requesting task, in bytes */
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static bool AgentResolve(void * context, const char * host, uint32_t * address)
+{
+    BCDS_UNUSED(context);
+
+    if (NULL != AgentSetup->Resolve)
+    {
+        return (RETCODE_OK == AgentSetup->Resolve(host, address));
+    }
+    if (0 > sl_NetAppDnsGetHostByName((_i8 *) host, (_u16) strlen(host), (_u32 *) address, SL_AF_INET))
+    {
+        printf("HttpsAgent : Resolving %s failed \r\n", host);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Opens the socket; on a secure socket sl_Connect does the TLS handshake.
+ */
+static bool AgentConnect(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount)
+{
+    SlSockAddrIn_t serverAddress;
+    SlSockSecureMethod method;
+    SlSockSecureMask mask;
+    struct SlTimeval_t receiveTimeout;
+    int16_t result = SL_SOC_OK;
+    uint8_t cipher;
+
+    BCDS_UNUSED(context);
+
+    AgentSocket = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, AgentSetup->IsSecure ? SL_SEC_SOCKET : SL_IPPROTO_TCP);
+    if (0 > AgentSocket)
+    {
+        return false;
+    }
+    receiveTimeout.tv_sec = AgentSetup->TimeoutMs / 1000UL;
+    receiveTimeout.tv_usec = (AgentSetup->TimeoutMs % 1000UL) * 1000UL;
+    result = sl_SetSockOpt(AgentSocket, SL_SOL_SOCKET, SL_SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+    if (AgentSetup->IsSecure)
+    {
+        method.secureMethod = SL_SO_SEC_METHOD_TLSV1_2;
+        if (SL_SOC_OK == result)
+        {
+            result = sl_SetSockOpt(AgentSocket, SL_SOL_SOCKET, SL_SO_SECMETHOD, &method, sizeof(method));
+        }
+        mask.secureMask = 0UL;
+        for (cipher = 0U; cipher < cipherCount; cipher++)
+        {
+            if ((uint32_t) ciphers[cipher] < (uint32_t) HTTPS_SESSION_CIPHER_COUNT)
+            {
+                mask.secureMask |= AgentCipherMasks[ciphers[cipher]];
+            }
+        }
+        /* Without a known suite the chip offers its default set */
+        if ((SL_SOC_OK == result) && (0UL != mask.secureMask))
+        {
+            result = sl_SetSockOpt(AgentSocket, SL_SOL_SOCKET, SL_SO_SECURE_MASK, &mask, sizeof(mask));
+        }
+        if ((SL_SOC_OK == result) && (NULL != AgentSetup->CaFileName))
+        {
+            result = sl_SetSockOpt(AgentSocket, SL_SOL_SOCKET, SL_SO_SECURE_FILES_CA_FILE_NAME, AgentSetup->CaFileName,
+                    (SlSocklen_t) strlen(AgentSetup->CaFileName));
+        }
+    }
+    if (SL_SOC_OK == result)
+    {
+        memset(&serverAddress, 0, sizeof(serverAddress));
+        serverAddress.sin_family = SL_AF_INET;
+        serverAddress.sin_port = sl_Htons(port);
+        serverAddress.sin_addr.s_addr = sl_Htonl(address);
+        result = sl_Connect(AgentSocket, (SlSockAddr_t *) &serverAddress, sizeof(serverAddress));
+        if ((SL_ESECSNOVERIFY == result) && (NULL == AgentSetup->CaFileName))
+        {
+            /* Connected, the server was not verified as configured */
+            result = SL_SOC_OK;
+        }
+    }
+    if (0 > result)
+    {
+        printf("HttpsAgent : Connecting to %s failed with %d \r\n", AgentSetup->ServerHost, (int) result);
+        return false;
+    }
+    return true;
+}
+
+static bool AgentSend(void * context, const uint8_t * data, uint32_t length)
+{
+    uint32_t sent = 0UL;
+    uint32_t segment;
+    int16_t result;
+
+    BCDS_UNUSED(context);
+
+    while (sent < length)
+    {
+        segment = ((length - sent) > HTTPS_AGENT_SEGMENT_SIZE) ? HTTPS_AGENT_SEGMENT_SIZE : (length - sent);
+        result = sl_Send(AgentSocket, &data[sent], (_i16) segment, 0);
+        if (0 >= result)
+        {
+            return false;
+        }
+        sent += (uint32_t) result;
+    }
+    return true;
+}
+
+/**
+ * @brief Receives with the timeout set on the socket by AgentConnect.
+ */
+static int32_t AgentReceive(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(timeoutMs);
+
+    if (size > HTTPS_AGENT_SEGMENT_SIZE)
+    {
+        size = HTTPS_AGENT_SEGMENT_SIZE;
+    }
+    return (int32_t) sl_Recv(AgentSocket, buffer, (_i16) size, 0);
+}
+
+static void AgentClose(void * context)
+{
+    BCDS_UNUSED(context);
+
+    if (0 <= AgentSocket)
+    {
+        (void) sl_Close(AgentSocket);
+        AgentSocket = -1;
+    }
+}
+
+static const HttpsSession_Transport_T AgentTransport =
+        {
+                .Context = NULL,
+                .Resolve = AgentResolve,
+                .Connect = AgentConnect,
+                .Handshake = NULL, /* Part of sl_Connect */
+                .Send = AgentSend,
+                .Receive = AgentReceive,
+                .Close = AgentClose,
+                .NowMs = AgentNowMs,
+        };
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T HttpsAgent_Setup(const HttpsAgent_Setup_T * setup)
+{
+    HttpsSession_Setup_T sessionSetup;
+
+    if ((NULL == setup) || (NULL == setup->ServerHost))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    sessionSetup.Host = setup->ServerHost;
+    sessionSetup.Port = setup->ServerPort;
+    sessionSetup.Ciphers = setup->Ciphers;
+    sessionSetup.CipherCount = setup->CipherCount;
+    sessionSetup.MaxIdleMs = setup->MaxIdleMs;
+    sessionSetup.MaxRequestsPerConnection = 0UL;
+    sessionSetup.TimeoutMs = setup->TimeoutMs;
+    sessionSetup.Transport = &AgentTransport;
+    if (!HttpsSession_Init(&AgentSession, &sessionSetup))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T HttpsAgent_Request(const HttpsSession_Request_T * request, HttpsSession_Response_T * response)
+{
+    HttpsSession_Response_T status;
+    uint32_t stackLeft;
+    bool isDone;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if (NULL == request)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if (NULL == response)
+    {
+        status.Body = NULL;
+        status.BodySize = 0UL;
+        response = &status;
+    }
+    isDone = HttpsSession_Request(&AgentSession, request, response);
+    stackLeft = (uint32_t) uxTaskGetStackHighWaterMark(NULL) * (uint32_t) sizeof(StackType_t);
+    if (stackLeft < AgentStackLeftMin)
+    {
+        AgentStackLeftMin = stackLeft;
+    }
+    if (!isDone)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+    }
+    if ((response->Status < 200U) || (response->Status > 299U))
+    {
+        printf("HttpsAgent : %s %s answered %u \r\n", request->Method, request->Path, (unsigned int) response->Status);
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+void HttpsAgent_Close(void)
+{
+    HttpsSession_Close(&AgentSession);
+}
+
+/** Refer interface header for description */
+const HttpsSession_Statistics_T * HttpsAgent_GetStatistics(void)
+{
+    return &AgentSession.Statistics;
+}
+
+/** Refer interface header for description */
+void HttpsAgent_PrintReport(void)
+{
+    const HttpsSession_Statistics_T * statistics = &AgentSession.Statistics;
+    const HttpsSession_PhaseTiming_T * timing;
+    uint8_t phase;
+
+    printf("HttpsAgent : %lu requests, %lu failed, %lu connections, %lu on an open connection, %lu retried\r\n",
+            (unsigned long) statistics->Requests, (unsigned long) statistics->Failures, (unsigned long) statistics->Connections,
+            (unsigned long) statistics->Reused, (unsigned long) statistics->Retried);
+    if ((NULL != AgentSetup) && (statistics->Requests > 1UL) && (0UL == statistics->Reused))
+    {
+        printf("HttpsAgent : No connection reused, every request paid a handshake: the keep-alive timeout of the server and MaxIdleMs (%lu ms) have to exceed the request interval\r\n",
+                (unsigned long) AgentSetup->MaxIdleMs);
+    }
+    printf("HttpsAgent : %lu streamed body sends, %lu bytes of stack left to the requesting task at least, %lu bytes of heap minimum free\r\n",
+            (unsigned long) statistics->BodyParts, (unsigned long) AgentStackLeftMin, (unsigned long) xPortGetMinimumEverFreeHeapSize());
+    for (phase = 0U; phase < (uint8_t) HTTPS_SESSION_PHASE_COUNT; phase++)
+    {
+        timing = &statistics->Phases[phase];
+        if (0UL != timing->Count)
+        {
+            printf("HttpsAgent :   %-10s %5lu x, last %5lu ms, mean %5lu ms, max %5lu ms\r\n", HttpsSession_GetPhaseName((HttpsSession_Phase_T) phase),
+                    (unsigned long) timing->Count, (unsigned long) timing->LastMs, (unsigned long) (timing->TotalMs / timing->Count),
+                    (unsigned long) timing->MaxMs);
+        }
+    }
+}
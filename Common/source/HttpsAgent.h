@@ -0,0 +1,93 @@
+/**
+ *  @file
+ *
+ *  @brief Runs an HttpsSession on the XDK over a SimpleLink (secure) socket.
+ *
+ *  The TLS handshake of a SimpleLink secure socket runs in the network
+ *  processor of the WLAN chip. Its API has no access to the TLS session, so a
+ *  session cannot be resumed on a new socket; the agent saves the handshakes
+ *  by keeping the socket open between requests instead (see HttpsSession.h),
+ *  and restricts the offered cipher suites to the preference list of the
+ *  application. SimpleLink takes the suites as a set, the order of the list
+ *  only matters to transports honouring it (Tools/TlsHandshakeBench).
+ *
+ *  All functions are called from one task.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef HTTPSAGENT_H_
+#define HTTPSAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "HttpsSession.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Resolves host to an IPv4 address in host byte order, e.g. DnsAgent_Resolve.
+ */
+typedef Retcode_T (*HttpsAgent_ResolveFunc_T)(const char * host, uint32_t * address);
+
+/**
+ * @brief Agent configuration.
+ */
+struct HttpsAgent_Setup_S
+{
+    const char * ServerHost; /**< Host name or dotted IPv4 address */
+    uint16_t ServerPort;
+    bool IsSecure; /**< false for plain HTTP */
+    const char * CaFileName; /**< CA certificate in the file system of the WLAN chip, NULL to skip the server verification */
+    const HttpsSession_Cipher_T * Ciphers; /**< In order of preference */
+    uint8_t CipherCount;
+    uint32_t MaxIdleMs; /**< Reconnects instead of reusing a connection idle for longer, 0 for no limit */
+    uint32_t TimeoutMs; /**< Longest wait for response data */
+    HttpsAgent_ResolveFunc_T Resolve; /**< NULL to ask the resolver of the WLAN chip for every new connection */
+};
+typedef struct HttpsAgent_Setup_S HttpsAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Stores the agent configuration; no connection is opened yet.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T HttpsAgent_Setup(const HttpsAgent_Setup_T * setup);
+
+/**
+ * @brief Sends a request and receives the response, see HttpsSession_Request.
+ *
+ * Requires an established WLAN connection.
+ *
+ * @param[out] response
+ * Status and body, may be NULL
+ *
+ * @return  RETCODE_OK for a 2xx response, RETCODE_FAILURE for another status or a
+ * network error.
+ */
+Retcode_T HttpsAgent_Request(const HttpsSession_Request_T * request, HttpsSession_Response_T * response);
+
+/**
+ * @brief Closes the connection, e.g. before the WLAN reconnects.
+ */
+void HttpsAgent_Close(void);
+
+/**
+ * @brief Returns the counters and phase timings.
+ */
+const HttpsSession_Statistics_T * HttpsAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters, the phase timings and the least stack and heap left while requesting,
+ * and a hint if no connection was ever reused.
+ */
+void HttpsAgent_PrintReport(void);
+
+#endif /* HTTPSAGENT_H_ */
@@ -0,0 +1,410 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the HTTP(S) client session.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "HttpsSession.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* local variables ********************************************************** */
+
+static const char * const SessionCipherNames[HTTPS_SESSION_CIPHER_COUNT] =
+        {
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256] = "ECDHE-ECDSA-AES128-GCM-SHA256",
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256] = "ECDHE-ECDSA-AES128-SHA256",
+                [HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA] = "ECDHE-ECDSA-AES256-SHA",
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256] = "ECDHE-RSA-AES128-GCM-SHA256",
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256] = "ECDHE-RSA-AES128-SHA256",
+                [HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA] = "ECDHE-RSA-AES256-SHA",
+                [HTTPS_SESSION_CIPHER_RSA_AES128_CBC_SHA256] = "AES128-SHA256",
+                [HTTPS_SESSION_CIPHER_RSA_AES256_CBC_SHA] = "AES256-SHA",
+        };
+
+static const char * const SessionPhaseNames[HTTPS_SESSION_PHASE_COUNT] =
+        {
+                [HTTPS_SESSION_PHASE_RESOLVE] = "Resolve",
+                [HTTPS_SESSION_PHASE_CONNECT] = "Connect",
+                [HTTPS_SESSION_PHASE_HANDSHAKE] = "Handshake",
+                [HTTPS_SESSION_PHASE_REQUEST] = "Request",
+                [HTTPS_SESSION_PHASE_FIRST_BYTE] = "FirstByte",
+                [HTTPS_SESSION_PHASE_BODY] = "Body",
+        };
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Records the duration of a phase which started at startMs.
+ *
+ * @return The end of the phase, i.e. the start of the next one.
+ */
+static uint32_t SessionRecord(HttpsSession_T * session, HttpsSession_Phase_T phase, uint32_t startMs)
+{
+    HttpsSession_PhaseTiming_T * timing = &session->Statistics.Phases[phase];
+    uint32_t nowMs = session->Setup.Transport->NowMs();
+    uint32_t durationMs = nowMs - startMs;
+
+    timing->Count++;
+    timing->LastMs = durationMs;
+    timing->TotalMs += durationMs;
+    if (durationMs > timing->MaxMs)
+    {
+        timing->MaxMs = durationMs;
+    }
+    return nowMs;
+}
+
+/**
+ * @brief Opens a new connection: resolve, connect and handshake.
+ */
+static bool SessionConnect(HttpsSession_T * session)
+{
+    const HttpsSession_Transport_T * transport = session->Setup.Transport;
+    uint32_t address = 0UL;
+    bool isResumed = false;
+    bool isConnected;
+    uint32_t startMs = transport->NowMs();
+
+    isConnected = transport->Resolve(transport->Context, session->Setup.Host, &address);
+    startMs = SessionRecord(session, HTTPS_SESSION_PHASE_RESOLVE, startMs);
+    if (isConnected)
+    {
+        isConnected = transport->Connect(transport->Context, address, session->Setup.Port, session->Setup.Ciphers, session->Setup.CipherCount);
+        startMs = SessionRecord(session, HTTPS_SESSION_PHASE_CONNECT, startMs);
+    }
+    if (isConnected && (NULL != transport->Handshake))
+    {
+        isConnected = transport->Handshake(transport->Context, &isResumed);
+        (void) SessionRecord(session, HTTPS_SESSION_PHASE_HANDSHAKE, startMs);
+    }
+    if (!isConnected)
+    {
+        transport->Close(transport->Context);
+        return false;
+    }
+    session->Statistics.Connections++;
+    if (isResumed)
+    {
+        session->Statistics.Resumed++;
+    }
+    session->IsConnected = true;
+    session->ConnectionRequests = 0UL;
+    return true;
+}
+
+/**
+ * @brief Copies body bytes into the response.
+ */
+static void SessionStoreBody(HttpsSession_Response_T * response, const uint8_t * data, uint32_t length)
+{
+    uint32_t count;
+
+    if ((NULL == response) || (NULL == response->Body))
+    {
+        return;
+    }
+    count = response->BodySize - response->BodyLength;
+    if (count > length)
+    {
+        count = length;
+    }
+    memcpy(&response->Body[response->BodyLength], data, count);
+    response->BodyLength += count;
+}
+
+/**
+ * @brief Flush function of the body writer, sends a full session buffer.
+ */
+static bool SessionSend(void * context, const uint8_t * data, uint32_t length)
+{
+    const HttpsSession_Transport_T * transport = ((HttpsSession_T *) context)->Setup.Transport;
+
+    return transport->Send(transport->Context, data, length);
+}
+
+/**
+ * @brief Sends the length bytes at data as one chunk, and the terminating empty chunk behind it if isLast.
+ *
+ * data lies in the session buffer with HTTPS_SESSION_CHUNK_HEAD_SIZE bytes of room in front
+ * and HTTPS_SESSION_CHUNK_TAIL_SIZE behind, the framing goes there.
+ */
+static bool SessionSendChunk(HttpsSession_T * session, uint8_t * data, uint32_t length, bool isLast)
+{
+    const HttpsSession_Transport_T * transport = session->Setup.Transport;
+    char sizeLine[HTTPS_SESSION_CHUNK_HEAD_SIZE + 1U];
+    uint8_t * start = data;
+    int written;
+
+    if (0UL != length)
+    {
+        written = snprintf(sizeLine, sizeof(sizeLine), "%lX\r\n", (unsigned long) length);
+        if ((written <= 0) || ((uint32_t) written > HTTPS_SESSION_CHUNK_HEAD_SIZE))
+        {
+            return false;
+        }
+        start -= written;
+        memcpy(start, sizeLine, (size_t) written);
+        memcpy(&data[length], "\r\n", 2U);
+        length += 2UL;
+    }
+    if (isLast)
+    {
+        /* An empty chunk ends the body */
+        memcpy(&data[length], "0\r\n\r\n", 5U);
+        length += 5UL;
+    }
+    return transport->Send(transport->Context, start, (uint32_t) (&data[length] - start));
+}
+
+/**
+ * @brief Flush function of the body writer of a chunked request, sends a full buffer as one chunk.
+ */
+static bool SessionFlushChunk(void * context, const uint8_t * data, uint32_t length)
+{
+    HttpsSession_T * session = (HttpsSession_T *) context;
+
+    /* data is the start of the writer buffer, inside the session buffer */
+    return SessionSendChunk(session, &session->Buffer[data - session->Buffer], length, false);
+}
+
+/**
+ * @brief Sends a request on the open connection and receives the response.
+ *
+ * @param[out] isAnswered
+ * Set once a response byte arrived
+ *
+ * @return true if the response is complete; the connection stays open if the server allows.
+ */
+static bool SessionExchange(HttpsSession_T * session, const HttpsSession_Request_T * request, HttpsSession_Response_T * response,
+        bool * isAnswered)
+{
+    const HttpsSession_Transport_T * transport = session->Setup.Transport;
+    HttpMessage_Request_T head;
+    HttpMessage_Head_T responseHead;
+    PayloadWriter_T writer;
+    uint32_t bodyLength = request->BodyLength;
+    uint32_t length;
+    uint32_t consumed;
+    int32_t received = 1L;
+    bool isSent;
+    uint32_t startMs;
+
+    head.Method = request->Method;
+    head.Host = session->Setup.Host;
+    head.Path = request->Path;
+    head.ContentType = request->ContentType;
+    head.IsChunked = (NULL != request->WriteBody) && request->IsChunked;
+    if ((NULL != request->WriteBody) && !head.IsChunked)
+    {
+        PayloadWriter_Init(&writer, NULL, 0UL, 0UL, NULL, NULL);
+        if (!request->WriteBody(request->BodyContext, &writer))
+        {
+            return false;
+        }
+        bodyLength = writer.Length;
+    }
+    head.ContentLength = bodyLength;
+    head.ExtraHeaders = request->ExtraHeaders;
+    head.IsClose = (1UL == session->Setup.MaxRequestsPerConnection);
+    length = HttpMessage_WriteRequestHead((char *) session->Buffer, sizeof(session->Buffer), &head);
+    if (0UL == length)
+    {
+        return false;
+    }
+
+    startMs = transport->NowMs();
+    if (head.IsChunked)
+    {
+        /* The head goes alone, then each full buffer as a chunk and the rest together with the empty last chunk */
+        PayloadWriter_Init(&writer, &session->Buffer[HTTPS_SESSION_CHUNK_HEAD_SIZE],
+                sizeof(session->Buffer) - HTTPS_SESSION_CHUNK_HEAD_SIZE - HTTPS_SESSION_CHUNK_TAIL_SIZE, 0UL, SessionFlushChunk, session);
+        isSent = transport->Send(transport->Context, session->Buffer, length) && request->WriteBody(request->BodyContext, &writer) &&
+                (!writer.IsFailed) && SessionSendChunk(session, writer.Buffer, writer.Used, true);
+        session->Statistics.BodyParts += writer.Flushes + 1UL;
+    }
+    else if (NULL != request->WriteBody)
+    {
+        /* The body goes behind the head and the buffer is sent whenever it is full */
+        PayloadWriter_Init(&writer, session->Buffer, sizeof(session->Buffer), length, SessionSend, session);
+        isSent = request->WriteBody(request->BodyContext, &writer) && PayloadWriter_Finish(&writer) && (writer.Length == bodyLength);
+        session->Statistics.BodyParts += writer.Flushes;
+    }
+    else if ((0UL != request->BodyLength) && (request->BodyLength <= (sizeof(session->Buffer) - length)))
+    {
+        /* One TLS record and TCP segment instead of two, the second one would wait for the ACK of the first */
+        memcpy(&session->Buffer[length], request->Body, request->BodyLength);
+        isSent = transport->Send(transport->Context, session->Buffer, length + request->BodyLength);
+    }
+    else
+    {
+        isSent = transport->Send(transport->Context, session->Buffer, length);
+        if (isSent && (0UL != request->BodyLength))
+        {
+            isSent = transport->Send(transport->Context, request->Body, request->BodyLength);
+        }
+    }
+    startMs = SessionRecord(session, HTTPS_SESSION_PHASE_REQUEST, startMs);
+    if (!isSent)
+    {
+        return false;
+    }
+    session->ConnectionRequests++;
+
+    HttpMessage_InitHead(&responseHead, true);
+    while (HTTP_MESSAGE_STATE_BODY != responseHead.State)
+    {
+        received = transport->Receive(transport->Context, session->Buffer, sizeof(session->Buffer), session->Setup.TimeoutMs);
+        if (received <= 0L)
+        {
+            return false;
+        }
+        if (!*isAnswered)
+        {
+            *isAnswered = true;
+            startMs = SessionRecord(session, HTTPS_SESSION_PHASE_FIRST_BYTE, startMs);
+        }
+        consumed = HttpMessage_ParseHead(&responseHead, session->Buffer, (uint32_t) received);
+        if (HTTP_MESSAGE_STATE_ERROR == responseHead.State)
+        {
+            return false;
+        }
+        length = HttpMessage_ReceiveBody(&responseHead, &session->Buffer[consumed], (uint32_t) received - consumed);
+        SessionStoreBody(response, &session->Buffer[consumed], length);
+    }
+    while ((HTTP_MESSAGE_STATE_ERROR != responseHead.State) && !HttpMessage_IsBodyComplete(&responseHead))
+    {
+        received = transport->Receive(transport->Context, session->Buffer, sizeof(session->Buffer), session->Setup.TimeoutMs);
+        if ((0L == received) && !HttpMessage_IsBodyDelimited(&responseHead))
+        {
+            /* The close ends the body */
+            break;
+        }
+        if (received <= 0L)
+        {
+            return false;
+        }
+        length = HttpMessage_ReceiveBody(&responseHead, session->Buffer, (uint32_t) received);
+        SessionStoreBody(response, session->Buffer, length);
+    }
+    (void) SessionRecord(session, HTTPS_SESSION_PHASE_BODY, startMs);
+    if (HTTP_MESSAGE_STATE_ERROR == responseHead.State)
+    {
+        return false;
+    }
+    if (NULL != response)
+    {
+        response->Status = responseHead.Status;
+        memcpy(response->ETag, responseHead.ETag, sizeof(response->ETag));
+    }
+    if (responseHead.IsClose || (0L == received) || !HttpMessage_IsBodyDelimited(&responseHead))
+    {
+        HttpsSession_Close(session);
+    }
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool HttpsSession_Init(HttpsSession_T * session, const HttpsSession_Setup_T * setup)
+{
+    const HttpsSession_Transport_T * transport;
+
+    if ((NULL == session) || (NULL == setup) || (NULL == setup->Host) || (NULL == setup->Transport))
+    {
+        return false;
+    }
+    transport = setup->Transport;
+    if ((NULL == transport->Resolve) || (NULL == transport->Connect) || (NULL == transport->Send) || (NULL == transport->Receive) ||
+            (NULL == transport->Close) || (NULL == transport->NowMs))
+    {
+        return false;
+    }
+    memset(session, 0, sizeof(*session));
+    session->Setup = *setup;
+    return true;
+}
+
+/** Refer interface header for description */
+bool HttpsSession_Request(HttpsSession_T * session, const HttpsSession_Request_T * request, HttpsSession_Response_T * response)
+{
+    bool isReused;
+    bool isAnswered = false;
+    bool isDone;
+
+    if ((NULL == session) || (NULL == request) || (NULL == request->Method) || (NULL == request->Path) ||
+            ((NULL == request->Body) && (NULL == request->WriteBody) && (0UL != request->BodyLength)))
+    {
+        return false;
+    }
+    if (NULL != response)
+    {
+        response->Status = 0U;
+        response->BodyLength = 0UL;
+        response->ETag[0] = '\0';
+    }
+    session->Statistics.Requests++;
+
+    if (session->IsConnected &&
+            (((0UL != session->Setup.MaxIdleMs) && ((session->Setup.Transport->NowMs() - session->LastUseMs) > session->Setup.MaxIdleMs)) ||
+                    ((0UL != session->Setup.MaxRequestsPerConnection) && (session->ConnectionRequests >= session->Setup.MaxRequestsPerConnection))))
+    {
+        /* The server probably dropped it already */
+        HttpsSession_Close(session);
+    }
+    isReused = session->IsConnected;
+    isDone = (isReused || SessionConnect(session)) && SessionExchange(session, request, response, &isAnswered);
+    if ((!isDone) && isReused && (!isAnswered))
+    {
+        /* The reused connection was closed by the server, one more try on a new one */
+        HttpsSession_Close(session);
+        session->Statistics.Retried++;
+        isReused = false;
+        if (NULL != response)
+        {
+            response->BodyLength = 0UL;
+        }
+        isDone = SessionConnect(session) && SessionExchange(session, request, response, &isAnswered);
+    }
+    if (!isDone)
+    {
+        HttpsSession_Close(session);
+        session->Statistics.Failures++;
+        return false;
+    }
+    if (isReused)
+    {
+        session->Statistics.Reused++;
+    }
+    session->LastUseMs = session->Setup.Transport->NowMs();
+    return true;
+}
+
+/** Refer interface header for description */
+void HttpsSession_Close(HttpsSession_T * session)
+{
+    if ((NULL != session) && session->IsConnected)
+    {
+        session->Setup.Transport->Close(session->Setup.Transport->Context);
+        session->IsConnected = false;
+    }
+}
+
+/** Refer interface header for description */
+const char * HttpsSession_GetCipherName(HttpsSession_Cipher_T cipher)
+{
+    return ((uint32_t) cipher < (uint32_t) HTTPS_SESSION_CIPHER_COUNT) ? SessionCipherNames[cipher] : NULL;
+}
+
+/** Refer interface header for description */
+const char * HttpsSession_GetPhaseName(HttpsSession_Phase_T phase)
+{
+    return ((uint32_t) phase < (uint32_t) HTTPS_SESSION_PHASE_COUNT) ? SessionPhaseNames[phase] : "";
+}
@@ -0,0 +1,248 @@
+/**
+ *  @file
+ *
+ *  @brief HTTP(S) client session which keeps its connection open across requests.
+ *
+ *  HTTPRestClient_Post opens a new secure socket for every post, so every post
+ *  pays a full TLS handshake: certificate chain, ECDHE key exchange and
+ *  signature verification, several seconds of radio and CPU time. The session
+ *  sends each request over the connection of the previous one as long as the
+ *  server keeps it open (HTTP/1.1 keep-alive), and only connects and
+ *  handshakes again when
+ *  - the server closed the connection or answered without a body length,
+ *  - the connection was idle for longer than MaxIdleMs, which is set below the
+ *    keep-alive timeout of the server,
+ *  - MaxRequestsPerConnection requests were sent on it,
+ *  - a request failed.
+ *  A request which fails on a reused connection before any response byte
+ *  arrived is sent once more on a new connection, since the server may have
+ *  closed the idle connection in the meantime.
+ *
+ *  The module is platform independent. Sockets and TLS are behind
+ *  HttpsSession_Transport_T: HttpsAgent implements it with the secure sockets
+ *  of the WLAN chip, Tools/TlsHandshakeBench with OpenSSL and TLS session
+ *  resumption on Linux.
+ *
+ *  The cipher suites offered are a list in order of preference, by default
+ *  ECDHE-ECDSA first: an ECDSA P-256 server certificate makes the signature
+ *  verification and the key exchange use the same curve, much cheaper than an
+ *  RSA-2048 chain.
+ *
+ *  A body can also be written by the encoder straight into the session
+ *  buffer behind the request head (HttpsSession_Request_T::WriteBody): each
+ *  time the buffer fills up it is sent, so the body needs neither a staging
+ *  buffer of its own nor a copy, whatever its length. With IsChunked the
+ *  body is sent with chunked transfer encoding, one chunk per buffer, so its
+ *  length need not be known in advance: a backlog read from a file streams
+ *  through the session buffer without being counted first.
+ *
+ *  Every request is timed per phase (HttpsSession_Phase_T), see
+ *  HttpsSession_Statistics_T.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef HTTPSSESSION_H_
+#define HTTPSSESSION_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+#include "HttpMessage.h"
+#include "PayloadWriter.h"
+
+/* local type and macro definitions */
+
+/** Buffer for the request head and the received response, per session; a body fitting in after the head is sent with it */
+#define HTTPS_SESSION_BUFFER_SIZE           UINT16_C(512)
+
+/** Room kept in front of a chunk of a chunked body for its size line, four hex digits and CRLF */
+#define HTTPS_SESSION_CHUNK_HEAD_SIZE       UINT16_C(6)
+
+/** Room kept behind a chunk for its CRLF and, after the last one, the terminating empty chunk */
+#define HTTPS_SESSION_CHUNK_TAIL_SIZE       UINT16_C(7)
+
+/**
+ * @brief TLS 1.2 cipher suites a session may offer.
+ */
+enum HttpsSession_Cipher_E
+{
+    HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256 = 0,
+    HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256,
+    HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA,
+    HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256,
+    HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256,
+    HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA,
+    HTTPS_SESSION_CIPHER_RSA_AES128_CBC_SHA256,
+    HTTPS_SESSION_CIPHER_RSA_AES256_CBC_SHA,
+
+    HTTPS_SESSION_CIPHER_COUNT
+};
+typedef enum HttpsSession_Cipher_E HttpsSession_Cipher_T;
+
+/**
+ * @brief Timed phases of a request.
+ */
+enum HttpsSession_Phase_E
+{
+    HTTPS_SESSION_PHASE_RESOLVE = 0, /**< DNS lookup, new connections only */
+    HTTPS_SESSION_PHASE_CONNECT, /**< TCP connect, including the handshake if the transport has no Handshake */
+    HTTPS_SESSION_PHASE_HANDSHAKE, /**< TLS handshake */
+    HTTPS_SESSION_PHASE_REQUEST, /**< Sending head and body */
+    HTTPS_SESSION_PHASE_FIRST_BYTE, /**< Waiting for the response */
+    HTTPS_SESSION_PHASE_BODY, /**< Receiving the rest of the response */
+
+    HTTPS_SESSION_PHASE_COUNT
+};
+typedef enum HttpsSession_Phase_E HttpsSession_Phase_T;
+
+/**
+ * @brief Sockets and TLS of a session. Every function gets Context.
+ */
+struct HttpsSession_Transport_S
+{
+    void * Context;
+    /** Resolves host to an IPv4 address in host byte order */
+    bool (*Resolve)(void * context, const char * host, uint32_t * address);
+    /** Opens the connection, offering the cipher suites in the given order */
+    bool (*Connect)(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount);
+    /** TLS handshake after Connect, sets isResumed if a cached session was resumed; NULL if Connect does it */
+    bool (*Handshake)(void * context, bool * isResumed);
+    /** Sends all of data */
+    bool (*Send)(void * context, const uint8_t * data, uint32_t length);
+    /** Returns the number of bytes received, 0 if the peer closed, negative on error or timeout */
+    int32_t (*Receive)(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs);
+    void (*Close)(void * context);
+    /** Monotonic time in milliseconds */
+    uint32_t (*NowMs)(void);
+};
+typedef struct HttpsSession_Transport_S HttpsSession_Transport_T;
+
+/**
+ * @brief Session configuration, copied by HttpsSession_Init.
+ */
+struct HttpsSession_Setup_S
+{
+    const char * Host;
+    uint16_t Port;
+    const HttpsSession_Cipher_T * Ciphers; /**< In order of preference */
+    uint8_t CipherCount;
+    uint32_t MaxIdleMs; /**< 0 for no limit */
+    uint32_t MaxRequestsPerConnection; /**< 0 for no limit, 1 for a new connection per request */
+    uint32_t TimeoutMs; /**< Longest wait for response data */
+    const HttpsSession_Transport_T * Transport;
+};
+typedef struct HttpsSession_Setup_S HttpsSession_Setup_T;
+
+/**
+ * @brief One request.
+ */
+struct HttpsSession_Request_S
+{
+    const char * Method;
+    const char * Path;
+    const char * ContentType; /**< NULL for a request without body */
+    const char * ExtraHeaders; /**< Complete header lines ending with CRLF, or NULL */
+    const uint8_t * Body;
+    uint32_t BodyLength;
+    /**
+     * Writes the body instead of Body, or NULL. Called once to count the
+     * bytes for the Content-Length and once to send them, again when the
+     * request is retried, so it must write the same bytes each time.
+     */
+    bool (*WriteBody)(void * context, PayloadWriter_T * writer);
+    void * BodyContext;
+    bool IsChunked; /**< WriteBody is called once per attempt and sent in chunks, without Content-Length */
+};
+typedef struct HttpsSession_Request_S HttpsSession_Request_T;
+
+/**
+ * @brief Response of a request.
+ */
+struct HttpsSession_Response_S
+{
+    uint16_t Status;
+    uint8_t * Body; /**< NULL to discard the body */
+    uint32_t BodySize;
+    uint32_t BodyLength; /**< Bytes stored in Body, the rest of a longer body is discarded */
+    char ETag[HTTP_MESSAGE_MAX_ETAG]; /**< ETag header, empty if none; send it back in If-None-Match */
+};
+typedef struct HttpsSession_Response_S HttpsSession_Response_T;
+
+/**
+ * @brief Duration of one phase.
+ */
+struct HttpsSession_PhaseTiming_S
+{
+    uint32_t Count;
+    uint32_t LastMs;
+    uint32_t MaxMs;
+    uint32_t TotalMs;
+};
+typedef struct HttpsSession_PhaseTiming_S HttpsSession_PhaseTiming_T;
+
+/**
+ * @brief Counters of a session.
+ */
+struct HttpsSession_Statistics_S
+{
+    uint32_t Requests;
+    uint32_t Failures;
+    uint32_t Connections; /**< Connections opened, each with a handshake */
+    uint32_t Resumed; /**< Handshakes which resumed a cached TLS session */
+    uint32_t Reused; /**< Requests sent on an already open connection */
+    uint32_t Retried; /**< Requests sent again after a reused connection turned out closed */
+    uint32_t BodyParts; /**< Sends of bodies written through WriteBody, or of their chunks */
+    HttpsSession_PhaseTiming_T Phases[HTTPS_SESSION_PHASE_COUNT];
+};
+typedef struct HttpsSession_Statistics_S HttpsSession_Statistics_T;
+
+/**
+ * @brief Session state.
+ */
+struct HttpsSession_S
+{
+    HttpsSession_Setup_T Setup;
+    bool IsConnected;
+    uint32_t ConnectionRequests; /**< Requests sent on the open connection */
+    uint32_t LastUseMs;
+    HttpsSession_Statistics_T Statistics;
+    uint8_t Buffer[HTTPS_SESSION_BUFFER_SIZE];
+};
+typedef struct HttpsSession_S HttpsSession_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes a session, no connection is opened yet.
+ *
+ * @return false if a parameter is missing.
+ */
+bool HttpsSession_Init(HttpsSession_T * session, const HttpsSession_Setup_T * setup);
+
+/**
+ * @brief Sends a request and receives its response, connecting first if needed.
+ *
+ * @param[out] response
+ * Status and body, may be NULL
+ *
+ * @return true if a complete response was received, whatever its status.
+ */
+bool HttpsSession_Request(HttpsSession_T * session, const HttpsSession_Request_T * request, HttpsSession_Response_T * response);
+
+/**
+ * @brief Closes the connection, e.g. when the network went down.
+ */
+void HttpsSession_Close(HttpsSession_T * session);
+
+/**
+ * @brief Returns the OpenSSL name of a cipher suite, NULL if invalid.
+ */
+const char * HttpsSession_GetCipherName(HttpsSession_Cipher_T cipher);
+
+/**
+ * @brief Returns the name of a phase for reports.
+ */
+const char * HttpsSession_GetPhaseName(HttpsSession_Phase_T phase);
+
+#endif /* HTTPSSESSION_H_ */
@@ -0,0 +1,156 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the payload writer.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "PayloadWriter.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* local functions ********************************************************** */
+
+static bool WriterFlush(PayloadWriter_T * writer)
+{
+    if (0UL == writer->Used)
+    {
+        return true;
+    }
+    if (!writer->Flush(writer->Context, writer->Buffer, writer->Used))
+    {
+        writer->IsFailed = true;
+        return false;
+    }
+    writer->Used = 0UL;
+    writer->Flushes++;
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+void PayloadWriter_Init(PayloadWriter_T * writer, uint8_t * buffer, uint32_t size, uint32_t used, PayloadWriter_Flush_T flush, void * context)
+{
+    if (NULL == writer)
+    {
+        return;
+    }
+    writer->Buffer = buffer;
+    writer->Size = (NULL == buffer) ? 0UL : size;
+    writer->Used = (NULL == buffer) ? 0UL : used;
+    writer->Length = 0UL;
+    writer->Flushes = 0UL;
+    writer->Flush = flush;
+    writer->Context = context;
+    writer->IsFailed = (writer->Used > writer->Size);
+}
+
+/** Refer interface header for description */
+char * PayloadWriter_Reserve(PayloadWriter_T * writer, uint32_t length)
+{
+    if ((NULL == writer) || writer->IsFailed || (length > PAYLOAD_WRITER_MAX_RESERVE))
+    {
+        return NULL;
+    }
+    if (NULL == writer->Buffer)
+    {
+        return (char *) writer->Scratch;
+    }
+    if ((writer->Size - writer->Used) < length)
+    {
+        if ((NULL == writer->Flush) || (writer->Size < length) || !WriterFlush(writer))
+        {
+            writer->IsFailed = true;
+            return NULL;
+        }
+    }
+    return (char *) &writer->Buffer[writer->Used];
+}
+
+/** Refer interface header for description */
+char * PayloadWriter_ReserveBulk(PayloadWriter_T * writer, uint32_t * length)
+{
+    if ((NULL == writer) || (NULL == length) || writer->IsFailed)
+    {
+        return NULL;
+    }
+    if (NULL == writer->Buffer)
+    {
+        *length = PAYLOAD_WRITER_MAX_RESERVE;
+        return (char *) writer->Scratch;
+    }
+    if ((writer->Used == writer->Size) && ((NULL == writer->Flush) || !WriterFlush(writer) || (0UL == writer->Size)))
+    {
+        writer->IsFailed = true;
+        return NULL;
+    }
+    *length = writer->Size - writer->Used;
+    return (char *) &writer->Buffer[writer->Used];
+}
+
+/** Refer interface header for description */
+void PayloadWriter_Commit(PayloadWriter_T * writer, uint32_t length)
+{
+    if ((NULL == writer) || writer->IsFailed)
+    {
+        return;
+    }
+    if (NULL != writer->Buffer)
+    {
+        writer->Used += length;
+    }
+    writer->Length += length;
+}
+
+/** Refer interface header for description */
+bool PayloadWriter_Write(PayloadWriter_T * writer, const void * data, uint32_t length)
+{
+    const uint8_t * source = (const uint8_t *) data;
+    uint32_t part;
+
+    if ((NULL == writer) || writer->IsFailed || ((NULL == data) && (0UL != length)))
+    {
+        return false;
+    }
+    if (NULL == writer->Buffer)
+    {
+        writer->Length += length;
+        return true;
+    }
+    while (0UL != length)
+    {
+        if ((writer->Used == writer->Size) && ((NULL == writer->Flush) || !WriterFlush(writer)))
+        {
+            writer->IsFailed = true;
+            return false;
+        }
+        part = writer->Size - writer->Used;
+        part = (part < length) ? part : length;
+        memcpy(&writer->Buffer[writer->Used], source, part);
+        writer->Used += part;
+        writer->Length += part;
+        source += part;
+        length -= part;
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+bool PayloadWriter_Finish(PayloadWriter_T * writer)
+{
+    if ((NULL == writer) || writer->IsFailed)
+    {
+        return false;
+    }
+    if ((NULL != writer->Buffer) && (NULL != writer->Flush))
+    {
+        return WriterFlush(writer);
+    }
+    return true;
+}
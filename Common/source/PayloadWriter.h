@@ -0,0 +1,113 @@
+/**
+ *  @file
+ *
+ *  @brief Output of the payload encoders: straight into a transmit buffer.
+ *
+ *  An encoder asks the writer for room (PayloadWriter_Reserve), formats into
+ *  it and commits what it wrote. The writer hands out space of the buffer the
+ *  payload is sent from; when it is full, the flush function sends what it
+ *  holds and the encoder continues at its start. So a payload larger than the
+ *  buffer needs no contiguous staging copy, and nothing is copied between the
+ *  encoder and the network stack.
+ *
+ *  Three modes, chosen by PayloadWriter_Init:
+ *  - flushing: buffer and flush function, e.g. the request buffer of HttpsSession,
+ *  - fixed: a buffer without flush function, the payload must fit,
+ *  - counting: no buffer, only the length is kept; the encoders format into
+ *    a small scratch area, so a first pass yields the Content-Length.
+ *
+ *  The module is platform independent.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef PAYLOADWRITER_H_
+#define PAYLOADWRITER_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Largest room a single PayloadWriter_Reserve may ask for */
+#define PAYLOAD_WRITER_MAX_RESERVE          UINT32_C(64)
+
+/**
+ * @brief Sends the bytes the writer holds.
+ *
+ * @return false to abort the payload.
+ */
+typedef bool (*PayloadWriter_Flush_T)(void * context, const uint8_t * data, uint32_t length);
+
+/**
+ * @brief Writer state.
+ */
+struct PayloadWriter_S
+{
+    uint8_t * Buffer; /**< NULL while counting */
+    uint32_t Size;
+    uint32_t Used; /**< Bytes held in Buffer, a prefix such as a request head included */
+    uint32_t Length; /**< Payload bytes committed so far */
+    uint32_t Flushes;
+    PayloadWriter_Flush_T Flush; /**< NULL for a fixed buffer */
+    void * Context;
+    bool IsFailed; /**< The buffer overflowed or a flush failed, further output is dropped */
+    uint8_t Scratch[PAYLOAD_WRITER_MAX_RESERVE]; /**< Room handed out while counting */
+};
+typedef struct PayloadWriter_S PayloadWriter_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts a payload.
+ *
+ * @param[in] buffer
+ * Transmit buffer, NULL to count only
+ *
+ * @param[in] used
+ * Bytes already in the buffer before the payload, sent with its first part
+ *
+ * @param[in] flush
+ * Sends the buffer when it is full and at PayloadWriter_Finish, NULL for a fixed buffer
+ */
+void PayloadWriter_Init(PayloadWriter_T * writer, uint8_t * buffer, uint32_t size, uint32_t used, PayloadWriter_Flush_T flush, void * context);
+
+/**
+ * @brief Returns contiguous room for up to length bytes, flushing first if needed.
+ *
+ * @return NULL if the writer failed, length exceeds PAYLOAD_WRITER_MAX_RESERVE or the room does not exist.
+ */
+char * PayloadWriter_Reserve(PayloadWriter_T * writer, uint32_t length);
+
+/**
+ * @brief Returns all contiguous room left in the buffer, flushing first if it is full,
+ * for bulk copies such as file reads. While counting it is the scratch area.
+ *
+ * @param[out] length
+ * Size of the room
+ *
+ * @return NULL if the writer failed or a fixed buffer is full.
+ */
+char * PayloadWriter_ReserveBulk(PayloadWriter_T * writer, uint32_t * length);
+
+/**
+ * @brief Adds length bytes written into the room of the last PayloadWriter_Reserve or PayloadWriter_ReserveBulk.
+ */
+void PayloadWriter_Commit(PayloadWriter_T * writer, uint32_t length);
+
+/**
+ * @brief Copies bytes into the payload, in as many parts as the buffer needs.
+ *
+ * @return false if the writer failed.
+ */
+bool PayloadWriter_Write(PayloadWriter_T * writer, const void * data, uint32_t length);
+
+/**
+ * @brief Flushes what the writer still holds; a fixed buffer keeps it.
+ *
+ * @return false if the writer failed at any point.
+ */
+bool PayloadWriter_Finish(PayloadWriter_T * writer);
+
+#endif /* PAYLOADWRITER_H_ */
@@ -0,0 +1,531 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor component.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_SENSOR_COMPONENT
+
+#include "SensorComponent.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/* additional interface header files */
+#include "XdkSensorHandle.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Sensor driver glue generated from SENSOR_TABLE_SENSORS.
+ */
+struct SensorComponentSensor_S
+{
+    Retcode_T (*Init)(void); /**< NULL for a disabled sensor */
+    Retcode_T (*Configure)(uint32_t rate, uint32_t range); /**< NULL for a sensor without driver settings */
+    Retcode_T (*Read)(SensorTable_Value_T * values); /**< Returns the result of the driver, the channels are only written on success */
+    uint32_t Rate;
+    uint32_t Range;
+};
+typedef struct SensorComponentSensor_S SensorComponentSensor_T;
+
+/**
+ * @brief Driver settings of a sensor.
+ */
+struct SensorComponentSettings_S
+{
+    uint32_t Rate;
+    uint32_t Range;
+};
+typedef struct SensorComponentSettings_S SensorComponentSettings_T;
+
+/* local variables ********************************************************** */
+
+static SensorTable_Value_T * SensorValues = NULL;
+
+static xTimerHandle SensorTimers[SENSOR_TABLE_SENSOR_COUNT];
+
+static StaticRtos_Timer_T SensorTimerStorage[SENSOR_TABLE_SENSOR_COUNT];
+
+static SensorComponent_ReadHook_T SensorReadHooks[SENSOR_COMPONENT_MAX_READ_HOOKS];
+
+static SensorComponentSettings_T SensorSettings[SENSOR_TABLE_SENSOR_COUNT]; /**< Settings of SensorComponent_Configure, applied on the real-time lane */
+
+static uint32_t SensorInitialized = 0UL; /**< Sensors past SensorComponent_InitSensor, bit n for sensor n */
+
+/* local functions ********************************************************** */
+
+#if SENSOR_COMPONENT_ENABLE_ACCELEROMETER
+static Retcode_T SensorComponentInitAccelerometer(void)
+{
+    if (RETCODE_OK != CalibratedAccel_init(xdkCalibratedAccelerometer_Handle))
+    {
+        printf("Initializing Calibrated Accelerometer failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadAccelerometer(SensorTable_Value_T * values)
+{
+    CalibratedAccel_Status_T calibrationAccuracy = CALIBRATED_ACCEL_UNRELIABLE;
+    CalibratedAccel_XyzMps2Data_T getAccelMpsData = { INT32_C(0), INT32_C(0), INT32_C(0) };
+    Retcode_T retcode = CalibratedAccel_getStatus(&calibrationAccuracy);
+
+    /* Only a fully calibrated accelerometer delivers values */
+    if ((RETCODE_OK == retcode) && (CALIBRATED_ACCEL_HIGH != calibrationAccuracy))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_UNINITIALIZED);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = CalibratedAccel_readXyzMps2Value(&getAccelMpsData);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_ACCELEROMETER_X].Float = (float) getAccelMpsData.xAxisData;
+        values[SENSOR_TABLE_CHANNEL_ACCELEROMETER_Y].Float = (float) getAccelMpsData.yAxisData;
+        values[SENSOR_TABLE_CHANNEL_ACCELEROMETER_Z].Float = (float) getAccelMpsData.zAxisData;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitAccelerometer    NULL
+#define SensorComponentReadAccelerometer    NULL
+#endif /* SENSOR_COMPONENT_ENABLE_ACCELEROMETER */
+#define SensorComponentConfigureAccelerometer   NULL
+
+#if SENSOR_COMPONENT_ENABLE_GYROSCOPE
+static Retcode_T SensorComponentInitGyroscope(void)
+{
+    if (RETCODE_OK != Gyroscope_init(xdkGyroscope_BMG160_Handle))
+    {
+        printf("BMG160 Gyroscope initialization failed\n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentConfigureGyroscope(uint32_t rate, uint32_t range)
+{
+    if (RETCODE_OK != Gyroscope_setBandwidth(xdkGyroscope_BMG160_Handle, rate))
+    {
+        printf("Configuring bandwidth failed \n\r");
+    }
+    if (RETCODE_OK != Gyroscope_setRange(xdkGyroscope_BMG160_Handle, range))
+    {
+        printf("Configuring range failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadGyroscope(SensorTable_Value_T * values)
+{
+    Gyroscope_XyzData_T bmg160 = { INT32_C(0), INT32_C(0), INT32_C(0) };
+    Retcode_T retcode = Gyroscope_readXyzDegreeValue(xdkGyroscope_BMG160_Handle, &bmg160);
+
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_GYROSCOPE_X].Int = (int32_t) bmg160.xAxisData;
+        values[SENSOR_TABLE_CHANNEL_GYROSCOPE_Y].Int = (int32_t) bmg160.yAxisData;
+        values[SENSOR_TABLE_CHANNEL_GYROSCOPE_Z].Int = (int32_t) bmg160.zAxisData;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitGyroscope        NULL
+#define SensorComponentConfigureGyroscope   NULL
+#define SensorComponentReadGyroscope        NULL
+#endif /* SENSOR_COMPONENT_ENABLE_GYROSCOPE */
+
+#if SENSOR_COMPONENT_ENABLE_MAGNETOMETER
+static Retcode_T SensorComponentInitMagnetometer(void)
+{
+    if (RETCODE_OK != Magnetometer_init(xdkMagnetometer_BMM150_Handle))
+    {
+        printf("BMM150 Magnetometer initialization failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentConfigureMagnetometer(uint32_t rate, uint32_t range)
+{
+    if (RETCODE_OK != Magnetometer_setDataRate(xdkMagnetometer_BMM150_Handle, rate))
+    {
+        printf("Configuring data rate failed \n\r");
+    }
+    if (RETCODE_OK != Magnetometer_setPresetMode(xdkMagnetometer_BMM150_Handle, range))
+    {
+        printf("Configuring preset mode failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadMagnetometer(SensorTable_Value_T * values)
+{
+    Magnetometer_XyzData_T bmm150 = { INT32_C(0), INT32_C(0), INT32_C(0), INT32_C(0) };
+    Retcode_T retcode = Magnetometer_readXyzTeslaData(xdkMagnetometer_BMM150_Handle, &bmm150);
+
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_MAGNETOMETER_X].Int = (int32_t) bmm150.xAxisData;
+        values[SENSOR_TABLE_CHANNEL_MAGNETOMETER_Y].Int = (int32_t) bmm150.yAxisData;
+        values[SENSOR_TABLE_CHANNEL_MAGNETOMETER_Z].Int = (int32_t) bmm150.zAxisData;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitMagnetometer     NULL
+#define SensorComponentConfigureMagnetometer    NULL
+#define SensorComponentReadMagnetometer     NULL
+#endif /* SENSOR_COMPONENT_ENABLE_MAGNETOMETER */
+
+#if SENSOR_COMPONENT_ENABLE_ENVIRONMENTAL
+static Retcode_T SensorComponentInitEnvironmental(void)
+{
+    if (RETCODE_OK != Environmental_init(xdkEnvironmental_BME280_Handle))
+    {
+        printf("BME280 Environmental Sensor initialization failed\n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentConfigureEnvironmental(uint32_t rate, uint32_t range)
+{
+    if (RETCODE_OK != Environmental_setOverSamplingPressure(xdkEnvironmental_BME280_Handle, rate))
+    {
+        printf("Configuring pressure oversampling failed \n\r");
+    }
+    if (RETCODE_OK != Environmental_setFilterCoefficient(xdkEnvironmental_BME280_Handle, range))
+    {
+        printf("Configuring pressure filter coefficient failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadEnvironmental(SensorTable_Value_T * values)
+{
+    Environmental_Data_T bme280 = { INT32_C(0), UINT32_C(0), UINT32_C(0) };
+    Retcode_T retcode = Environmental_readData(xdkEnvironmental_BME280_Handle, &bme280);
+
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_PRESSURE].Int = (int32_t) bme280.pressure;
+        values[SENSOR_TABLE_CHANNEL_TEMPERATURE].Int = (int32_t) bme280.temperature;
+        values[SENSOR_TABLE_CHANNEL_HUMIDITY].Int = (int32_t) bme280.humidity;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitEnvironmental    NULL
+#define SensorComponentConfigureEnvironmental   NULL
+#define SensorComponentReadEnvironmental    NULL
+#endif /* SENSOR_COMPONENT_ENABLE_ENVIRONMENTAL */
+
+#if SENSOR_COMPONENT_ENABLE_LIGHT
+static Retcode_T SensorComponentInitLight(void)
+{
+    if (RETCODE_OK != LightSensor_init(xdkLightSensor_MAX44009_Handle))
+    {
+        printf("MAX44009 Light Sensor initialization failed\n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentConfigureLight(uint32_t rate, uint32_t range)
+{
+    if (RETCODE_OK != LightSensor_setBrightness(xdkLightSensor_MAX44009_Handle, range))
+    {
+        printf("Configuring brightness failed \n\r");
+    }
+    if (RETCODE_OK != LightSensor_setIntegrationTime(xdkLightSensor_MAX44009_Handle, rate))
+    {
+        printf("Configuring integration time failed \n\r");
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadLight(SensorTable_Value_T * values)
+{
+    uint32_t max44009 = UINT32_C(0);
+    Retcode_T retcode = LightSensor_readLuxData(xdkLightSensor_MAX44009_Handle, &max44009);
+
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_LIGHT].Int = (int32_t) max44009;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitLight            NULL
+#define SensorComponentConfigureLight       NULL
+#define SensorComponentReadLight            NULL
+#endif /* SENSOR_COMPONENT_ENABLE_LIGHT */
+
+#if SENSOR_COMPONENT_ENABLE_ACOUSTIC
+static float AcousticConversionRatio = 1.0f; /**< AKU340 sensitivity, RMS reading per Pa */
+
+static Retcode_T SensorComponentInitAcoustic(void)
+{
+    AcousticConversionRatio = (float) pow(10,(-38/20));
+    return RETCODE_OK;
+}
+
+static Retcode_T SensorComponentReadAcoustic(SensorTable_Value_T * values)
+{
+    float acousticData;
+    Retcode_T retcode = NoiseSensor_ReadRmsValue(&acousticData,10U);
+
+    if (RETCODE_OK == retcode)
+    {
+        values[SENSOR_TABLE_CHANNEL_ACOUSTIC].Float = acousticData / AcousticConversionRatio;
+    }
+    return retcode;
+}
+#else
+#define SensorComponentInitAcoustic         NULL
+#define SensorComponentReadAcoustic         NULL
+#endif /* SENSOR_COMPONENT_ENABLE_ACOUSTIC */
+#define SensorComponentConfigureAcoustic    NULL
+
+#define SENSOR_COMPONENT_SENSOR_ENTRY(id, name, periodMs, rate, range) \
+    [SENSOR_TABLE_SENSOR_##id] = { SensorComponentInit##name, SensorComponentConfigure##name, SensorComponentRead##name, \
+            (uint32_t) (rate), (uint32_t) (range) },
+
+static const SensorComponentSensor_T SensorComponentSensors[SENSOR_TABLE_SENSOR_COUNT] =
+        {
+                SENSOR_TABLE_SENSORS(SENSOR_COMPONENT_SENSOR_ENTRY)
+        };
+
+#if SENSOR_COMPONENT_PRINT_ENABLE
+static void SensorComponentPrint(uint8_t sensor)
+{
+    uint32_t channelMask = SensorTable_GetChannelMask(sensor);
+    uint8_t channel;
+
+    printf("%s :", SensorTable_GetSensorName(sensor));
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL != (channelMask & (1UL << channel)))
+        {
+            printf(" %s %f %s", SensorTable_GetChannelKey(channel), (double) SensorTable_GetValue(SensorValues, channel),
+                    SensorTable_GetChannelUnit(channel));
+        }
+    }
+    printf("\r\n");
+}
+#endif /* SENSOR_COMPONENT_PRINT_ENABLE */
+
+/**
+ * @brief Reads one sensor on the real-time lane.
+ *
+ * @param[in] param2
+ * Sensor
+ */
+static void SensorComponentReadWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+
+    uint8_t sensor = (uint8_t) param2;
+    Retcode_T retcode = SensorComponentSensors[sensor].Read(SensorValues);
+    uint8_t hook;
+
+    for (hook = 0U; (hook < SENSOR_COMPONENT_MAX_READ_HOOKS) && (NULL != SensorReadHooks[hook]); hook++)
+    {
+        SensorReadHooks[hook]((SensorTable_Sensor_T) sensor, retcode, SensorValues);
+    }
+#if SENSOR_COMPONENT_PRINT_ENABLE
+    SensorComponentPrint(sensor);
+#endif /* SENSOR_COMPONENT_PRINT_ENABLE */
+}
+
+/**
+ * @brief Applies the settings of SensorComponent_Configure on the real-time lane, between two reads.
+ *
+ * @param[in] param2
+ * Sensor
+ */
+static void SensorComponentConfigureWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+
+    uint8_t sensor = (uint8_t) param2;
+
+    (void) SensorComponentSensors[sensor].Configure(SensorSettings[sensor].Rate, SensorSettings[sensor].Range);
+}
+
+/**
+ * @brief Read timer callback shared by all sensors, the timer ID is the sensor.
+ *
+ * The bus transfer does not run in the timer service task, which would delay
+ * every other timer; a read refused by a full lane is counted there and skipped.
+ */
+static void SensorComponentRead(xTimerHandle xTimer)
+{
+    (void) WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_REALTIME, SensorComponentReadWork, NULL, (uint32_t) (uintptr_t) pvTimerGetTimerID(xTimer));
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_Setup(SensorTable_Value_T * values)
+{
+    uint8_t sensor;
+
+    if (NULL == values)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    SensorValues = values;
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if ((NULL != SensorComponentSensors[sensor].Init) && (NULL == SensorTimers[sensor]))
+        {
+            SensorTimers[sensor] = StaticRtos_CreateTimer(&SensorTimerStorage[sensor], SensorTable_GetSensorName(sensor),
+                    pdMS_TO_TICKS(SensorTable_GetSensorPeriodMs(sensor)), pdTRUE, (void *) (uintptr_t) sensor, SensorComponentRead);
+            if (NULL == SensorTimers[sensor])
+            {
+                return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+            }
+        }
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_InitSensor(SensorTable_Sensor_T sensor)
+{
+    Retcode_T retcode;
+
+    if ((uint8_t) sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (NULL == SensorComponentSensors[sensor].Init)
+    {
+        return RETCODE_OK;
+    }
+    retcode = SensorComponentSensors[sensor].Init();
+    if ((RETCODE_OK == retcode) && (NULL != SensorComponentSensors[sensor].Configure))
+    {
+        retcode = SensorComponentSensors[sensor].Configure(SensorComponentSensors[sensor].Rate, SensorComponentSensors[sensor].Range);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        SensorInitialized |= (1UL << sensor);
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_Init(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+    uint8_t sensor;
+
+    for (sensor = 0U; (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT) && (RETCODE_OK == retcode); sensor++)
+    {
+        retcode = SensorComponent_InitSensor((SensorTable_Sensor_T) sensor);
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_Enable(void)
+{
+    uint8_t sensor;
+
+    if (NULL == SensorValues)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if ((NULL != SensorTimers[sensor]) && (pdPASS != xTimerStart(SensorTimers[sensor], UINT32_MAX)))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_AddReadHook(SensorComponent_ReadHook_T hook)
+{
+    uint8_t index;
+
+    if (NULL == hook)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    for (index = 0U; index < SENSOR_COMPONENT_MAX_READ_HOOKS; index++)
+    {
+        if (NULL == SensorReadHooks[index])
+        {
+            SensorReadHooks[index] = hook;
+            return RETCODE_OK;
+        }
+    }
+    return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_ReadNow(SensorTable_Sensor_T sensor)
+{
+    if (((uint8_t) sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT) || (NULL == SensorComponentSensors[sensor].Read))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (NULL == SensorValues)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    return WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_REALTIME, SensorComponentReadWork, NULL, (uint32_t) sensor);
+}
+
+/** Refer interface header for description */
+Retcode_T SensorComponent_Configure(SensorTable_Sensor_T sensor, uint32_t rate, uint32_t range)
+{
+    if (((uint8_t) sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT) || (NULL == SensorComponentSensors[sensor].Configure))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (0UL == (SensorInitialized & (1UL << sensor)))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    SensorSettings[sensor].Rate = (SENSOR_COMPONENT_TABLE_SETTING == rate) ? SensorComponentSensors[sensor].Rate : rate;
+    SensorSettings[sensor].Range = (SENSOR_COMPONENT_TABLE_SETTING == range) ? SensorComponentSensors[sensor].Range : range;
+    return WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_REALTIME, SensorComponentConfigureWork, NULL, (uint32_t) sensor);
+}
+
+/** Refer interface header for description */
+xTimerHandle SensorComponent_GetTimer(SensorTable_Sensor_T sensor)
+{
+    return ((uint8_t) sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT) ? SensorTimers[sensor] : NULL;
+}
+
+/** Refer interface header for description */
+uint32_t SensorComponent_GetEnabledChannels(void)
+{
+    uint32_t channelMask = 0UL;
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if (0UL != (SENSOR_COMPONENT_ENABLED_SENSORS & (1UL << sensor)))
+        {
+            channelMask |= SensorTable_GetChannelMask(sensor);
+        }
+    }
+    return channelMask;
+}
@@ -0,0 +1,136 @@
+/**
+ *  @file
+ *
+ *  @brief Reads the XDK110 sensors an application enables, driven by SensorTable.h.
+ *
+ *  Every application provides a SensorComponentConfig.h next to its sources
+ *  which sets SENSOR_COMPONENT_ENABLE_<Id> to 1 or 0 for every sensor of
+ *  SENSOR_TABLE_SENSORS and SENSOR_COMPONENT_PRINT_ENABLE to print every read.
+ *  The driver calls, timer and strings of a disabled sensor are not compiled
+ *  in. The channel storage keeps all channels, so the layout is the same for
+ *  every configuration; channels of disabled sensors just stay 0.
+ *
+ *  Every enabled sensor has its own auto reload timer, which queues the read
+ *  on the real-time lane of the WorkDispatcher; the read writes into the
+ *  values array handed to SensorComponent_Setup. A failed read leaves the
+ *  channels of the sensor unchanged; the read hooks see every result.
+ *  SensorComponent_ReadNow queues a read outside of the timer period, and
+ *  SensorComponent_Configure changes the driver settings of a running sensor
+ *  on the same lane, so a read never sees a half configured sensor.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORCOMPONENT_H_
+#define SENSORCOMPONENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+
+#include "SensorTable.h"
+#include "SensorComponentConfig.h"
+
+/* local type and macro definitions */
+
+#define SENSOR_COMPONENT_ENABLED_BIT(id, name, periodMs, rate, range) \
+    | ((uint32_t) SENSOR_COMPONENT_ENABLE_##id << SENSOR_TABLE_SENSOR_##id)
+
+/** Most read hooks, one per agent observing the reads */
+#define SENSOR_COMPONENT_MAX_READ_HOOKS     UINT8_C(3)
+
+/** Rate or range argument of SensorComponent_Configure which selects the setting of SensorTable.h */
+#define SENSOR_COMPONENT_TABLE_SETTING      UINT32_MAX
+
+/** Sensors enabled by SensorComponentConfig.h, bit n for sensor n */
+#define SENSOR_COMPONENT_ENABLED_SENSORS    ((uint32_t) (0U SENSOR_TABLE_SENSORS(SENSOR_COMPONENT_ENABLED_BIT)))
+
+/**
+ * @brief Called on the real-time lane after every read of a sensor.
+ *
+ * @param[in] retcode
+ * Result of the driver; RETCODE_OK if the channels of the sensor in values were updated
+ *
+ * @param[in] values
+ * The channel storage of SensorComponent_Setup
+ */
+typedef void (*SensorComponent_ReadHook_T)(SensorTable_Sensor_T sensor, Retcode_T retcode, const SensorTable_Value_T * values);
+
+/* global function prototype declarations */
+
+/**
+ * @brief Creates the read timers of the enabled sensors.
+ *
+ * @param[in] values
+ * Storage of SENSOR_TABLE_CHANNEL_COUNT values the reads are written to, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorComponent_Setup(SensorTable_Value_T * values);
+
+/**
+ * @brief Initializes and configures one sensor; does nothing for a disabled sensor.
+ *
+ * Driver errors are printed but do not fail the call, the sensor then just
+ * does not deliver values.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorComponent_InitSensor(SensorTable_Sensor_T sensor);
+
+/**
+ * @brief Initializes every enabled sensor, in table order.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorComponent_Init(void);
+
+/**
+ * @brief Starts the read timers of every enabled sensor at its table period.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorComponent_Enable(void);
+
+/**
+ * @brief Adds a function called after every read, e.g. to record a trace.
+ *
+ * @return  RETCODE_OK on success, or an error code if SENSOR_COMPONENT_MAX_READ_HOOKS are set.
+ */
+Retcode_T SensorComponent_AddReadHook(SensorComponent_ReadHook_T hook);
+
+/**
+ * @brief Queues one read of a sensor on the real-time lane, independent of its timer.
+ *
+ * @return  RETCODE_OK on success, or an error code for a disabled sensor or a full lane.
+ */
+Retcode_T SensorComponent_ReadNow(SensorTable_Sensor_T sensor);
+
+/**
+ * @brief Queues new driver settings of an initialized sensor on the real-time lane.
+ *
+ * @param[in] rate
+ * Driver value of the data rate (bandwidth, integration time, oversampling),
+ * or SENSOR_COMPONENT_TABLE_SETTING
+ *
+ * @param[in] range
+ * Driver value of the range (preset, filter), or SENSOR_COMPONENT_TABLE_SETTING
+ *
+ * @return  RETCODE_OK on success, or an error code for a sensor without
+ * settings, one not initialized yet or a full lane.
+ */
+Retcode_T SensorComponent_Configure(SensorTable_Sensor_T sensor, uint32_t rate, uint32_t range);
+
+/**
+ * @brief Returns the read timer of a sensor, e.g. to change its period; NULL for a disabled sensor.
+ */
+xTimerHandle SensorComponent_GetTimer(SensorTable_Sensor_T sensor);
+
+/**
+ * @brief Returns the channels delivered by the enabled sensors, bit n for channel n.
+ */
+uint32_t SensorComponent_GetEnabledChannels(void);
+
+#endif /* SENSORCOMPONENT_H_ */
@@ -0,0 +1,360 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the values only upload.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "SensorSchema.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SCHEMA_MAGIC                UINT8_C(0x53) /**< 'S' */
+#define SCHEMA_FLAG_ATTACHED        UINT8_C(0x01)
+#define SCHEMA_ID_FLOAT             UINT8_C(0x80)
+#define SCHEMA_CHANNEL_FIXED_SIZE   UINT32_C(6) /**< id, scale and key length of a schema channel */
+#define SCHEMA_MAX_VALUE_SIZE       UINT32_C(5) /**< A 32 bit varint */
+#define SCHEMA_FNV_OFFSET           UINT32_C(2166136261)
+#define SCHEMA_FNV_PRIME            UINT32_C(16777619)
+
+/* local functions ********************************************************** */
+
+static uint32_t SchemaHash(uint32_t hash, const uint8_t * data, uint32_t length)
+{
+    uint32_t index;
+
+    for (index = 0UL; index < length; index++)
+    {
+        hash = (hash ^ data[index]) * SCHEMA_FNV_PRIME;
+    }
+    return hash;
+}
+
+static void SchemaPutWord(uint8_t * buffer, uint32_t word)
+{
+    buffer[0] = (uint8_t) word;
+    buffer[1] = (uint8_t) (word >> 8);
+    buffer[2] = (uint8_t) (word >> 16);
+    buffer[3] = (uint8_t) (word >> 24);
+}
+
+static uint32_t SchemaGetWord(const uint8_t * buffer)
+{
+    return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+/**
+ * @brief Formats the schema entry of a channel.
+ *
+ * @return Length of the entry, 0 for a key too long.
+ */
+static uint32_t SchemaFormatChannel(uint8_t channel, uint8_t * buffer)
+{
+    const char * key = SensorTable_GetChannelKey(channel);
+    float scale = SensorTable_GetChannelScale(channel);
+    uint32_t bits;
+    size_t keyLength = strlen(key);
+
+    if (keyLength > SENSOR_SCHEMA_MAX_KEY_LENGTH)
+    {
+        return 0UL;
+    }
+    memcpy(&bits, &scale, sizeof(bits));
+    buffer[0] = (uint8_t) (channel | ((0U != (SENSOR_TABLE_FLOAT_MASK & (1U << channel))) ? SCHEMA_ID_FLOAT : 0U));
+    SchemaPutWord(&buffer[1], bits);
+    buffer[5] = (uint8_t) keyLength;
+    memcpy(&buffer[SCHEMA_CHANNEL_FIXED_SIZE], key, keyLength);
+    return SCHEMA_CHANNEL_FIXED_SIZE + (uint32_t) keyLength;
+}
+
+/**
+ * @brief Formats one value.
+ *
+ * @return Length of the value.
+ */
+static uint32_t SchemaFormatValue(const SensorTable_Value_T * values, uint8_t channel, uint8_t * buffer)
+{
+    uint32_t zigzag;
+    uint32_t length = 0UL;
+
+    if (0U != (SENSOR_TABLE_FLOAT_MASK & (1U << channel)))
+    {
+        SchemaPutWord(buffer, values[channel].Bits);
+        return 4UL;
+    }
+    /* zigzag: small negative numbers get small codes too */
+    zigzag = (uint32_t) values[channel].Int << 1;
+    zigzag = (values[channel].Int < 0) ? ~zigzag : zigzag;
+    while (zigzag >= 0x80UL)
+    {
+        buffer[length++] = (uint8_t) (zigzag | 0x80UL);
+        zigzag >>= 7;
+    }
+    buffer[length++] = (uint8_t) zigzag;
+    return length;
+}
+
+static bool SchemaReadValue(const uint8_t * message, uint32_t length, uint32_t * offset, bool isFloat, SensorTable_Value_T * value)
+{
+    uint32_t zigzag = 0UL;
+    uint8_t shift = 0U;
+    uint8_t byte;
+
+    if (isFloat)
+    {
+        if ((length - *offset) < 4UL)
+        {
+            return false;
+        }
+        value->Bits = SchemaGetWord(&message[*offset]);
+        *offset += 4UL;
+        return true;
+    }
+    do
+    {
+        if ((*offset >= length) || (shift > 28U))
+        {
+            return false;
+        }
+        byte = message[(*offset)++];
+        zigzag |= (uint32_t) (byte & 0x7FU) << shift;
+        shift += 7U;
+    } while (0U != (byte & 0x80U));
+    value->Bits = (0UL != (zigzag & 1UL)) ? ~(zigzag >> 1) : (zigzag >> 1);
+    return true;
+}
+
+/**
+ * @brief Reads an attached schema into description and checks it against the hash.
+ */
+static bool SchemaReadDescription(const uint8_t * message, uint32_t length, uint32_t * offset, uint32_t hash, SensorSchema_Description_T * description)
+{
+    uint32_t start = *offset;
+    uint32_t bits;
+    uint8_t count;
+    uint8_t index;
+    uint8_t keyLength;
+    SensorSchema_Channel_T * channel;
+
+    description->ChannelCount = 0U;
+    if (*offset >= length)
+    {
+        return false;
+    }
+    count = message[(*offset)++];
+    if ((0U == count) || (count > SENSOR_SCHEMA_MAX_CHANNELS))
+    {
+        return false;
+    }
+    for (index = 0U; index < count; index++)
+    {
+        if ((length - *offset) < SCHEMA_CHANNEL_FIXED_SIZE)
+        {
+            return false;
+        }
+        channel = &description->Channels[index];
+        channel->Channel = message[*offset] & (uint8_t) ~SCHEMA_ID_FLOAT;
+        channel->IsFloat = (0U != (message[*offset] & SCHEMA_ID_FLOAT));
+        bits = SchemaGetWord(&message[*offset + 1UL]);
+        memcpy(&channel->Scale, &bits, sizeof(bits));
+        keyLength = message[*offset + 5UL];
+        *offset += SCHEMA_CHANNEL_FIXED_SIZE;
+        if ((keyLength > SENSOR_SCHEMA_MAX_KEY_LENGTH) || ((length - *offset) < keyLength))
+        {
+            return false;
+        }
+        memcpy(channel->Key, &message[*offset], keyLength);
+        channel->Key[keyLength] = '\0';
+        *offset += keyLength;
+    }
+    if (SchemaHash(SCHEMA_FNV_OFFSET, &message[start], *offset - start) != hash)
+    {
+        return false;
+    }
+    description->Hash = hash;
+    description->ChannelCount = count;
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool SensorSchema_Init(SensorSchema_T * schema, uint32_t channelMask)
+{
+    uint8_t entry[SCHEMA_CHANNEL_FIXED_SIZE + SENSOR_SCHEMA_MAX_KEY_LENGTH];
+    uint32_t entryLength;
+    uint8_t count = 0U;
+    uint8_t channel;
+
+    if ((NULL == schema) || (0UL == channelMask) || (0UL != (channelMask & ~SENSOR_TABLE_ALL_CHANNELS)))
+    {
+        return false;
+    }
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        count += (0UL != (channelMask & (1UL << channel))) ? 1U : 0U;
+    }
+    schema->Hash = SchemaHash(SCHEMA_FNV_OFFSET, &count, 1UL);
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (channelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        entryLength = SchemaFormatChannel(channel, entry);
+        if (0UL == entryLength)
+        {
+            return false;
+        }
+        schema->Hash = SchemaHash(schema->Hash, entry, entryLength);
+    }
+    schema->ChannelMask = channelMask;
+    schema->IsAnnounced = false;
+    return true;
+}
+
+/** Refer interface header for description */
+bool SensorSchema_WriteMessage(const SensorSchema_T * schema, const SensorTable_Value_T * values, PayloadWriter_T * writer)
+{
+    uint8_t * room;
+    uint8_t count = 0U;
+    uint8_t channel;
+
+    if ((NULL == schema) || (NULL == values) || (0UL == schema->ChannelMask))
+    {
+        return false;
+    }
+    room = (uint8_t *) PayloadWriter_Reserve(writer, SENSOR_SCHEMA_HEADER_SIZE);
+    if (NULL == room)
+    {
+        return false;
+    }
+    room[0] = SCHEMA_MAGIC;
+    room[1] = schema->IsAnnounced ? 0U : SCHEMA_FLAG_ATTACHED;
+    SchemaPutWord(&room[2], schema->Hash);
+    PayloadWriter_Commit(writer, SENSOR_SCHEMA_HEADER_SIZE);
+    if (!schema->IsAnnounced)
+    {
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            count += (0UL != (schema->ChannelMask & (1UL << channel))) ? 1U : 0U;
+        }
+        if (!PayloadWriter_Write(writer, &count, 1UL))
+        {
+            return false;
+        }
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            if (0UL == (schema->ChannelMask & (1UL << channel)))
+            {
+                continue;
+            }
+            room = (uint8_t *) PayloadWriter_Reserve(writer, SCHEMA_CHANNEL_FIXED_SIZE + SENSOR_SCHEMA_MAX_KEY_LENGTH);
+            if (NULL == room)
+            {
+                return false;
+            }
+            PayloadWriter_Commit(writer, SchemaFormatChannel(channel, room));
+        }
+    }
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (schema->ChannelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        room = (uint8_t *) PayloadWriter_Reserve(writer, SCHEMA_MAX_VALUE_SIZE);
+        if (NULL == room)
+        {
+            return false;
+        }
+        PayloadWriter_Commit(writer, SchemaFormatValue(values, channel, room));
+    }
+    return !writer->IsFailed;
+}
+
+/** Refer interface header for description */
+bool SensorSchema_HandleStatus(SensorSchema_T * schema, uint16_t status)
+{
+    if (NULL == schema)
+    {
+        return false;
+    }
+    if ((status >= 200U) && (status <= 299U))
+    {
+        schema->IsAnnounced = true;
+    }
+    else if (SENSOR_SCHEMA_STATUS_UNKNOWN == status)
+    {
+        /* Retried once only: a server which rejects the attached schema too answers the next post again */
+        bool isRetry = schema->IsAnnounced;
+        schema->IsAnnounced = false;
+        return isRetry;
+    }
+    return false;
+}
+
+/** Refer interface header for description */
+void SensorSchema_Reset(SensorSchema_T * schema)
+{
+    if (NULL != schema)
+    {
+        schema->IsAnnounced = false;
+    }
+}
+
+/** Refer interface header for description */
+bool SensorSchema_GetHash(const uint8_t * message, uint32_t length, uint32_t * hash, bool * isSchemaAttached)
+{
+    if ((NULL == message) || (NULL == hash) || (length < SENSOR_SCHEMA_HEADER_SIZE) || (SCHEMA_MAGIC != message[0]) ||
+            (0U != (message[1] & (uint8_t) ~SCHEMA_FLAG_ATTACHED)))
+    {
+        return false;
+    }
+    *hash = SchemaGetWord(&message[2]);
+    if (NULL != isSchemaAttached)
+    {
+        *isSchemaAttached = (0U != (message[1] & SCHEMA_FLAG_ATTACHED));
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+SensorSchema_Result_T SensorSchema_Decode(const uint8_t * message, uint32_t length, SensorSchema_Description_T * description, SensorTable_Value_T * values)
+{
+    uint32_t offset = SENSOR_SCHEMA_HEADER_SIZE;
+    uint32_t hash;
+    bool isSchemaAttached;
+    uint8_t index;
+
+    if ((NULL == description) || (NULL == values) || !SensorSchema_GetHash(message, length, &hash, &isSchemaAttached))
+    {
+        return SENSOR_SCHEMA_RESULT_INVALID;
+    }
+    if (isSchemaAttached)
+    {
+        if (!SchemaReadDescription(message, length, &offset, hash, description))
+        {
+            return SENSOR_SCHEMA_RESULT_INVALID;
+        }
+    }
+    else if ((0U == description->ChannelCount) || (description->Hash != hash))
+    {
+        return SENSOR_SCHEMA_RESULT_UNKNOWN;
+    }
+    for (index = 0U; index < description->ChannelCount; index++)
+    {
+        if (!SchemaReadValue(message, length, &offset, description->Channels[index].IsFloat, &values[index]))
+        {
+            return SENSOR_SCHEMA_RESULT_INVALID;
+        }
+    }
+    return (offset == length) ? SENSOR_SCHEMA_RESULT_OK : SENSOR_SCHEMA_RESULT_INVALID;
+}
@@ -0,0 +1,165 @@
+/**
+ *  @file
+ *
+ *  @brief Values only upload: the channel schema is announced once, a post
+ *  carries the schema hash and the packed values.
+ *
+ *  Most bytes of a JSON body are the keys, repeated with every post. Here the
+ *  schema, id, type, scale and key of every posted channel, is attached to the
+ *  messages until the server acknowledged one of them. From then on a message
+ *  is the hash of the schema followed by the values in schema order:
+ *  - integer channels as zigzag LEB128 varints, one to three bytes for the
+ *    usual readings,
+ *  - float channels as their four IEEE-754 bytes.
+ *  The server keeps every schema it was sent by its hash. To values of a hash
+ *  it does not know, e.g. after a restart of the server or from a firmware
+ *  with other channels, it answers SENSOR_SCHEMA_STATUS_UNKNOWN, and the
+ *  device posts the same values again with the schema attached.
+ *
+ *  Message layout (multi byte fields little endian):
+ *  | 0 | 1     | 2..5 | if flags bit 0: schema                       | values |
+ *  | S | flags | hash | count, count x (id, scale, key length, key) |        |
+ *  Bit 7 of the id byte is set for a float channel. The hash is the 32 bit
+ *  FNV-1a of the schema bytes, so it only changes with the channels.
+ *
+ *  The module is platform independent, the host tools decode with it.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORSCHEMA_H_
+#define SENSORSCHEMA_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "PayloadWriter.h"
+#include "SensorTable.h"
+
+/* local type and macro definitions */
+
+/** HTTP status with which the server asks for the schema */
+#define SENSOR_SCHEMA_STATUS_UNKNOWN        UINT16_C(409)
+
+/** Size of the header in front of the schema and the values */
+#define SENSOR_SCHEMA_HEADER_SIZE           UINT32_C(6)
+
+/** Largest number of channels of a schema */
+#define SENSOR_SCHEMA_MAX_CHANNELS          UINT8_C(32)
+
+/** Longest key of a channel */
+#define SENSOR_SCHEMA_MAX_KEY_LENGTH        UINT8_C(31)
+
+/**
+ * @brief Sender side state.
+ */
+struct SensorSchema_S
+{
+    uint32_t ChannelMask; /**< Posted channels, bit n for channel n */
+    uint32_t Hash;
+    bool IsAnnounced; /**< The server accepted a message carrying the schema */
+};
+typedef struct SensorSchema_S SensorSchema_T;
+
+/**
+ * @brief One channel of a received schema.
+ */
+struct SensorSchema_Channel_S
+{
+    uint8_t Channel; /**< Index in SENSOR_TABLE_CHANNELS of the sender */
+    bool IsFloat;
+    float Scale; /**< The value times Scale is the value in the unit of the channel */
+    char Key[SENSOR_SCHEMA_MAX_KEY_LENGTH + 1U];
+};
+typedef struct SensorSchema_Channel_S SensorSchema_Channel_T;
+
+/**
+ * @brief Receiver side copy of a schema.
+ */
+struct SensorSchema_Description_S
+{
+    uint32_t Hash;
+    uint8_t ChannelCount; /**< 0 until a schema was decoded into it */
+    SensorSchema_Channel_T Channels[SENSOR_SCHEMA_MAX_CHANNELS];
+};
+typedef struct SensorSchema_Description_S SensorSchema_Description_T;
+
+/**
+ * @brief Results of SensorSchema_Decode.
+ */
+enum SensorSchema_Result_E
+{
+    SENSOR_SCHEMA_RESULT_OK = 0,
+    SENSOR_SCHEMA_RESULT_UNKNOWN, /**< Values of another schema, answer SENSOR_SCHEMA_STATUS_UNKNOWN */
+    SENSOR_SCHEMA_RESULT_INVALID, /**< Not a message of this format */
+};
+typedef enum SensorSchema_Result_E SensorSchema_Result_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Builds the schema of a channel set and its hash; the schema is not announced yet.
+ *
+ * @param[in] channelMask
+ * Channels to post, bit n for channel n
+ *
+ * @return false for an empty or invalid channel set.
+ */
+bool SensorSchema_Init(SensorSchema_T * schema, uint32_t channelMask);
+
+/**
+ * @brief Writes a message with the values of the schema channels, the schema
+ * attached unless it is announced.
+ *
+ * @param[in] values
+ * Values of all channels, in channel order
+ *
+ * @param[in,out] writer
+ * Writer started with PayloadWriter_Init
+ *
+ * @return false if the writer failed.
+ */
+bool SensorSchema_WriteMessage(const SensorSchema_T * schema, const SensorTable_Value_T * values, PayloadWriter_T * writer);
+
+/**
+ * @brief Updates the announcement with the HTTP status of a post.
+ *
+ * @param[in] status
+ * Status of the response, 0 if none arrived
+ *
+ * @return true if the server did not know the announced schema: post the
+ * same values again, the schema is attached now.
+ */
+bool SensorSchema_HandleStatus(SensorSchema_T * schema, uint16_t status);
+
+/**
+ * @brief Attaches the schema to the messages again until a post is accepted,
+ * for transports which do not report the status.
+ */
+void SensorSchema_Reset(SensorSchema_T * schema);
+
+/**
+ * @brief Reads the hash of a message, so the receiver can look up its schema.
+ *
+ * @param[out] isSchemaAttached
+ * Whether the message carries the schema, may be NULL
+ *
+ * @return false if the message is not of this format.
+ */
+bool SensorSchema_GetHash(const uint8_t * message, uint32_t length, uint32_t * hash, bool * isSchemaAttached);
+
+/**
+ * @brief Decodes a message.
+ *
+ * @param[in,out] description
+ * Schema of the message hash, overwritten by an attached schema
+ *
+ * @param[out] values
+ * Values in the channel order of the description, SENSOR_SCHEMA_MAX_CHANNELS entries
+ *
+ * @return SENSOR_SCHEMA_RESULT_OK when the values were decoded.
+ */
+SensorSchema_Result_T SensorSchema_Decode(const uint8_t * message, uint32_t length, SensorSchema_Description_T * description, SensorTable_Value_T * values);
+
+#endif /* SENSORSCHEMA_H_ */
@@ -0,0 +1,205 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor descriptor lookups.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "SensorTable.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* local type and macro definitions */
+
+/**
+ * @brief Per sensor data of SENSOR_TABLE_SENSORS the lookups need.
+ */
+struct SensorTableSensor_S
+{
+    const char * Name;
+    uint32_t PeriodMs;
+};
+typedef struct SensorTableSensor_S SensorTableSensor_T;
+
+/**
+ * @brief Per channel data of SENSOR_TABLE_CHANNELS.
+ */
+struct SensorTableChannel_S
+{
+    const char * Key;
+    const char * Unit;
+    float Scale;
+    uint8_t Sensor;
+};
+typedef struct SensorTableChannel_S SensorTableChannel_T;
+
+#define SENSOR_TABLE_SENSOR_ENTRY(id, name, periodMs, rate, range) \
+    [SENSOR_TABLE_SENSOR_##id] = { #name, (periodMs) },
+
+#define SENSOR_TABLE_CHANNEL_ENTRY(id, sensor, key, type, scale, unit) \
+    [SENSOR_TABLE_CHANNEL_##id] = { (key), (unit), (scale), (uint8_t) SENSOR_TABLE_SENSOR_##sensor },
+
+/* local variables ********************************************************** */
+
+static const SensorTableSensor_T SensorTableSensors[SENSOR_TABLE_SENSOR_COUNT] =
+        {
+                SENSOR_TABLE_SENSORS(SENSOR_TABLE_SENSOR_ENTRY)
+        };
+
+static const SensorTableChannel_T SensorTableChannels[SENSOR_TABLE_CHANNEL_COUNT] =
+        {
+                SENSOR_TABLE_CHANNELS(SENSOR_TABLE_CHANNEL_ENTRY)
+        };
+
+/**
+ * @brief Formats one channel as a member of the JSON object, the opening brace before the first one.
+ *
+ * @return Result of snprintf.
+ */
+static int SensorTableFormatField(char * buffer, size_t size, const SensorTable_Value_T * values, uint8_t channel, bool isFirst)
+{
+    if (0U != (SENSOR_TABLE_FLOAT_MASK & (1U << channel)))
+    {
+        return snprintf(buffer, size, "%s \"%s\": \"%f\"", isFirst ? "{" : ",", SensorTableChannels[channel].Key,
+                (double) values[channel].Float);
+    }
+    return snprintf(buffer, size, "%s \"%s\": \"%ld\"", isFirst ? "{" : ",", SensorTableChannels[channel].Key,
+            (long int) values[channel].Int);
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+const char * SensorTable_GetSensorName(uint8_t sensor)
+{
+    return (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT) ? SensorTableSensors[sensor].Name : NULL;
+}
+
+/** Refer interface header for description */
+uint32_t SensorTable_GetSensorPeriodMs(uint8_t sensor)
+{
+    return (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT) ? SensorTableSensors[sensor].PeriodMs : 0UL;
+}
+
+/** Refer interface header for description */
+uint32_t SensorTable_GetChannelMask(uint8_t sensor)
+{
+    uint32_t mask = 0UL;
+    uint8_t channel;
+
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (SensorTableChannels[channel].Sensor == sensor)
+        {
+            mask |= (1UL << channel);
+        }
+    }
+    return mask;
+}
+
+/** Refer interface header for description */
+const char * SensorTable_GetChannelKey(uint8_t channel)
+{
+    return (channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT) ? SensorTableChannels[channel].Key : NULL;
+}
+
+/** Refer interface header for description */
+const char * SensorTable_GetChannelUnit(uint8_t channel)
+{
+    return (channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT) ? SensorTableChannels[channel].Unit : NULL;
+}
+
+/** Refer interface header for description */
+float SensorTable_GetChannelScale(uint8_t channel)
+{
+    return (channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT) ? SensorTableChannels[channel].Scale : 0.0f;
+}
+
+/** Refer interface header for description */
+float SensorTable_GetValue(const SensorTable_Value_T * values, uint8_t channel)
+{
+    if (channel >= (uint8_t) SENSOR_TABLE_CHANNEL_COUNT)
+    {
+        return 0.0f;
+    }
+    if (0U != (SENSOR_TABLE_FLOAT_MASK & (1U << channel)))
+    {
+        return values[channel].Float * SensorTableChannels[channel].Scale;
+    }
+    return (float) values[channel].Int * SensorTableChannels[channel].Scale;
+}
+
+/** Refer interface header for description */
+uint32_t SensorTable_ToJson(const SensorTable_Value_T * values, uint32_t channelMask, char * buffer, size_t size)
+{
+    size_t length = 0;
+    int written;
+    uint8_t channel;
+
+    if ((NULL == values) || (NULL == buffer) || (0U == size))
+    {
+        return 0UL;
+    }
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (channelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        written = SensorTableFormatField(&buffer[length], size - length, values, channel, (0U == length));
+        if ((written < 0) || ((size_t) written >= (size - length)))
+        {
+            return 0UL;
+        }
+        length += (size_t) written;
+    }
+    if ((length + 3U) > size)
+    {
+        return 0UL;
+    }
+    if (0U == length)
+    {
+        buffer[length++] = '{';
+    }
+    buffer[length++] = '}';
+    buffer[length] = '\0';
+    return (uint32_t) length;
+}
+
+/** Refer interface header for description */
+bool SensorTable_WriteJson(const SensorTable_Value_T * values, uint32_t channelMask, PayloadWriter_T * writer)
+{
+    bool isFirst = true;
+    char * room;
+    int written;
+    uint8_t channel;
+
+    if ((NULL == values) || (NULL == writer))
+    {
+        return false;
+    }
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (channelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        room = PayloadWriter_Reserve(writer, PAYLOAD_WRITER_MAX_RESERVE);
+        if (NULL == room)
+        {
+            return false;
+        }
+        written = SensorTableFormatField(room, PAYLOAD_WRITER_MAX_RESERVE, values, channel, isFirst);
+        if ((written < 0) || ((uint32_t) written >= PAYLOAD_WRITER_MAX_RESERVE))
+        {
+            return false;
+        }
+        PayloadWriter_Commit(writer, (uint32_t) written);
+        isFirst = false;
+    }
+    return PayloadWriter_Write(writer, isFirst ? "{}" : "}", isFirst ? 2UL : 1UL);
+}
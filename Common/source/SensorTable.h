@@ -0,0 +1,192 @@
+/**
+ *  @file
+ *
+ *  @brief Descriptor tables of the XDK110 sensors, shared by all applications.
+ *
+ *  Everything that is specific to a sensor or a channel is listed exactly once
+ *  here, as X-macro tables: the sensor component generates its timers, reads
+ *  and prints from them, the applications their channel enums, JSON keys and
+ *  unit conversions. Adding a channel means adding one line below.
+ *
+ *  SENSOR_TABLE_SENSORS(X) calls X(Id, Name, PeriodMs, Rate, Range) per sensor:
+ *  - Id: suffix of the SENSOR_TABLE_SENSOR_ enum
+ *  - Name: CamelCase name, also used for the generated functions
+ *  - PeriodMs: default read period
+ *  - Rate, Range: driver settings for the output data rate (or bandwidth,
+ *    integration time, oversampling) and the range (or preset, filter);
+ *    only expanded by the sensor component, 0 where the driver has none
+ *
+ *  SENSOR_TABLE_CHANNELS(X) calls X(Id, Sensor, Key, Type, Scale, Unit) per channel:
+ *  - Id: suffix of the SENSOR_TABLE_CHANNEL_ enum, in storage order
+ *  - Sensor: Id of the sensor that delivers the channel
+ *  - Key: JSON key of the HTTP POST body, as expected by the server side script
+ *  - Type: FLOAT or INT, the member of SensorTable_Value_T which holds the value
+ *  - Scale, Unit: the stored value times Scale is the value in Unit
+ *
+ *  This header is free of SDK includes, so host tools can use the tables too.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORTABLE_H_
+#define SENSORTABLE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "PayloadWriter.h"
+
+/* local type and macro definitions */
+
+#define SENSOR_TABLE_SENSORS(X) \
+    X(ACCELEROMETER, Accelerometer, 1000U, 0U, 0U) \
+    X(GYROSCOPE, Gyroscope, 1000U, GYROSCOPE_BMG160_BANDWIDTH_116HZ, GYROSCOPE_BMG160_RANGE_500s) \
+    X(MAGNETOMETER, Magnetometer, 1000U, MAGNETOMETER_BMM150_DATARATE_10HZ, MAGNETOMETER_BMM150_PRESETMODE_REGULAR) \
+    X(ENVIRONMENTAL, Environmental, 1000U, ENVIRONMENTAL_BME280_OVERSAMP_2X, ENVIRONMENTAL_BME280_FILTER_COEFF_2) \
+    X(LIGHT, Light, 1000U, LIGHTSENSOR_200MS, LIGHTSENSOR_NORMAL_BRIGHTNESS) \
+    X(ACOUSTIC, Acoustic, 1000U, 0U, 0U)
+
+#define SENSOR_TABLE_CHANNELS(X) \
+    X(ACCELEROMETER_X, ACCELEROMETER, "AccelerometerX", FLOAT, 1.0f, "m/s2") \
+    X(ACCELEROMETER_Y, ACCELEROMETER, "AccelerometerY", FLOAT, 1.0f, "m/s2") \
+    X(ACCELEROMETER_Z, ACCELEROMETER, "AccelerometerZ", FLOAT, 1.0f, "m/s2") \
+    X(ACOUSTIC, ACOUSTIC, "Acoustic", FLOAT, 1.0f, "Pa") \
+    X(LIGHT, LIGHT, "Digital_light", INT, 0.001f, "lx") \
+    X(GYROSCOPE_X, GYROSCOPE, "GyroscopeX", INT, 0.001f, "deg/s") \
+    X(GYROSCOPE_Y, GYROSCOPE, "GyroscopeY", INT, 0.001f, "deg/s") \
+    X(GYROSCOPE_Z, GYROSCOPE, "GyroscopeZ", INT, 0.001f, "deg/s") \
+    X(HUMIDITY, ENVIRONMENTAL, "Humidity", INT, 1.0f, "%RH") \
+    X(MAGNETOMETER_X, MAGNETOMETER, "MagnetometerX", INT, 1.0f, "uT") \
+    X(MAGNETOMETER_Y, MAGNETOMETER, "MagnetometerY", INT, 1.0f, "uT") \
+    X(MAGNETOMETER_Z, MAGNETOMETER, "MagnetometerZ", INT, 1.0f, "uT") \
+    X(PRESSURE, ENVIRONMENTAL, "Pressure", INT, 0.01f, "hPa") \
+    X(TEMPERATURE, ENVIRONMENTAL, "Temperature", INT, 0.001f, "Cel")
+
+#define SENSOR_TABLE_SENSOR_ENUM(id, name, periodMs, rate, range)   SENSOR_TABLE_SENSOR_##id,
+#define SENSOR_TABLE_CHANNEL_ENUM(id, sensor, key, type, scale, unit)   SENSOR_TABLE_CHANNEL_##id,
+#define SENSOR_TABLE_TYPE_FLOAT         1U
+#define SENSOR_TABLE_TYPE_INT           0U
+#define SENSOR_TABLE_FLOAT_BIT(id, sensor, key, type, scale, unit)  | ((uint32_t) SENSOR_TABLE_TYPE_##type << SENSOR_TABLE_CHANNEL_##id)
+
+/**
+ * @brief Sensors, in SENSOR_TABLE_SENSORS order.
+ */
+enum SensorTable_Sensor_E
+{
+    SENSOR_TABLE_SENSORS(SENSOR_TABLE_SENSOR_ENUM)
+
+    SENSOR_TABLE_SENSOR_COUNT
+};
+typedef enum SensorTable_Sensor_E SensorTable_Sensor_T;
+
+/**
+ * @brief Channels, in SENSOR_TABLE_CHANNELS (storage) order.
+ */
+enum SensorTable_Channel_E
+{
+    SENSOR_TABLE_CHANNELS(SENSOR_TABLE_CHANNEL_ENUM)
+
+    SENSOR_TABLE_CHANNEL_COUNT
+};
+typedef enum SensorTable_Channel_E SensorTable_Channel_T;
+
+/** Bit mask of the channels which hold a float value (bit n = channel n) */
+#define SENSOR_TABLE_FLOAT_MASK         ((uint16_t) (0U SENSOR_TABLE_CHANNELS(SENSOR_TABLE_FLOAT_BIT)))
+
+/** Channel mask covering every channel */
+#define SENSOR_TABLE_ALL_CHANNELS       ((uint32_t) ((1UL << SENSOR_TABLE_CHANNEL_COUNT) - 1UL))
+
+/**
+ * @brief One channel value, interpreted according to SENSOR_TABLE_FLOAT_MASK.
+ */
+union SensorTable_Value_U
+{
+    float Float;
+    int32_t Int;
+    uint32_t Bits;
+};
+typedef union SensorTable_Value_U SensorTable_Value_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Returns the name of a sensor, NULL for an invalid sensor.
+ */
+const char * SensorTable_GetSensorName(uint8_t sensor);
+
+/**
+ * @brief Returns the default read period of a sensor in milliseconds, 0 for an invalid sensor.
+ */
+uint32_t SensorTable_GetSensorPeriodMs(uint8_t sensor);
+
+/**
+ * @brief Returns the channels a sensor delivers, bit n for channel n.
+ */
+uint32_t SensorTable_GetChannelMask(uint8_t sensor);
+
+/**
+ * @brief Returns the JSON key of a channel, NULL for an invalid channel.
+ */
+const char * SensorTable_GetChannelKey(uint8_t channel);
+
+/**
+ * @brief Returns the unit of SensorTable_GetValue for a channel, NULL for an invalid channel.
+ */
+const char * SensorTable_GetChannelUnit(uint8_t channel);
+
+/**
+ * @brief Returns the factor from the stored value of a channel to its unit, 0 for an invalid channel.
+ */
+float SensorTable_GetChannelScale(uint8_t channel);
+
+/**
+ * @brief Returns a channel value converted to the unit of the channel.
+ *
+ * @param[in] values
+ * Values of all channels, in channel order
+ *
+ * @param[in] channel
+ * Channel index
+ *
+ * @return Value in SensorTable_GetChannelUnit units, 0 for an invalid channel.
+ */
+float SensorTable_GetValue(const SensorTable_Value_T * values, uint8_t channel);
+
+/**
+ * @brief Formats channel values as the JSON object expected by the server side script.
+ *
+ * @param[in] values
+ * Values of all channels, in channel order
+ *
+ * @param[in] channelMask
+ * Channels to format, bit n for channel n
+ *
+ * @param[out] buffer
+ * Output buffer, NUL terminated on success
+ *
+ * @param[in] size
+ * Size of the output buffer
+ *
+ * @return Length of the JSON text, 0 if the buffer is too small.
+ */
+uint32_t SensorTable_ToJson(const SensorTable_Value_T * values, uint32_t channelMask, char * buffer, size_t size);
+
+/**
+ * @brief Writes the JSON object of SensorTable_ToJson through a payload writer, field by field.
+ *
+ * @param[in] values
+ * Values of all channels, in channel order
+ *
+ * @param[in] channelMask
+ * Channels to write, bit n for channel n
+ *
+ * @param[in,out] writer
+ * Writer started with PayloadWriter_Init
+ *
+ * @return false if the writer failed.
+ */
+bool SensorTable_WriteJson(const SensorTable_Value_T * values, uint32_t channelMask, PayloadWriter_T * writer);
+
+#endif /* SENSORTABLE_H_ */
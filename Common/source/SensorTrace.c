@@ -0,0 +1,303 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor trace writer and reader.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "SensorTrace.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* local type and macro definitions */
+
+#define SENSOR_TRACE_FLAG_FAILED        UINT8_C(0x80)
+#define SENSOR_TRACE_SENSOR_MASK        UINT8_C(0x7F)
+#define SENSOR_TRACE_MAX_VARINT         UINT8_C(5)
+#define SENSOR_TRACE_MAX_CHUNK          UINT32_C(0xFFFF) /**< Limit of the 16 bit length prefix */
+
+/* local functions ********************************************************** */
+
+static uint8_t TraceWriteVarint(uint8_t * data, uint32_t value)
+{
+    uint8_t length = 0U;
+
+    while (value >= 0x80UL)
+    {
+        data[length++] = (uint8_t) (value | 0x80UL);
+        value >>= 7;
+    }
+    data[length++] = (uint8_t) value;
+    return length;
+}
+
+/**
+ * @return Bytes read, 0 if the varint runs past end or is longer than 32 bit.
+ */
+static uint8_t TraceReadVarint(const uint8_t * data, uint32_t available, uint32_t * value)
+{
+    uint8_t length = 0U;
+
+    *value = 0UL;
+    while ((length < available) && (length < SENSOR_TRACE_MAX_VARINT))
+    {
+        *value |= (uint32_t) (data[length] & 0x7FU) << (7U * length);
+        if (0U == (data[length++] & 0x80U))
+        {
+            return length;
+        }
+    }
+    return 0U;
+}
+
+/**
+ * @brief Maps a signed difference to an unsigned one, small magnitudes to small values.
+ */
+static uint32_t TraceZigZag(uint32_t difference)
+{
+    return (difference << 1) ^ (uint32_t) -(int32_t) (difference >> 31);
+}
+
+static uint32_t TraceUnZigZag(uint32_t value)
+{
+    return (value >> 1) ^ (uint32_t) -(int32_t) (value & 1UL);
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+uint32_t SensorTrace_WriteHeader(uint8_t * buffer, uint32_t size)
+{
+    if ((NULL == buffer) || (size < SENSOR_TRACE_HEADER_SIZE))
+    {
+        return 0UL;
+    }
+    buffer[0] = (uint8_t) 'S';
+    buffer[1] = (uint8_t) 'T';
+    buffer[2] = SENSOR_TRACE_VERSION;
+    buffer[3] = (uint8_t) SENSOR_TABLE_SENSOR_COUNT;
+    buffer[4] = (uint8_t) SENSOR_TABLE_CHANNEL_COUNT;
+    buffer[5] = 0U;
+    buffer[6] = 0U;
+    buffer[7] = 0U;
+    return SENSOR_TRACE_HEADER_SIZE;
+}
+
+/** Refer interface header for description */
+bool SensorTrace_InitWriter(SensorTrace_Writer_T * writer, uint8_t * buffer, uint32_t capacity)
+{
+    uint8_t channel;
+
+    if ((NULL == writer) || (NULL == buffer) || (capacity < (SENSOR_TRACE_CHUNK_PREFIX_SIZE + SENSOR_TRACE_MAX_RECORD_SIZE)))
+    {
+        return false;
+    }
+    writer->Buffer = buffer;
+    writer->Capacity = (capacity > SENSOR_TRACE_MAX_CHUNK) ? SENSOR_TRACE_MAX_CHUNK : capacity;
+    writer->Length = SENSOR_TRACE_CHUNK_PREFIX_SIZE;
+    writer->RecordCount = 0UL;
+    writer->PreviousMs = 0UL;
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        writer->Previous[channel] = 0UL;
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+bool SensorTrace_Append(SensorTrace_Writer_T * writer, const SensorTrace_Record_T * record)
+{
+    uint8_t encoded[1U + (SENSOR_TRACE_MAX_VARINT * (2U + (uint32_t) SENSOR_TABLE_CHANNEL_COUNT))];
+    uint32_t length = 1U;
+    uint32_t channelMask;
+    uint8_t channel;
+
+    if ((NULL == writer) || (NULL == record) || (record->Sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT))
+    {
+        return false;
+    }
+    encoded[0] = record->Sensor | ((0UL != record->Retcode) ? SENSOR_TRACE_FLAG_FAILED : 0U);
+    length += TraceWriteVarint(&encoded[length], record->TimestampMs - writer->PreviousMs);
+    channelMask = SensorTable_GetChannelMask(record->Sensor);
+    if (0UL != record->Retcode)
+    {
+        length += TraceWriteVarint(&encoded[length], record->Retcode);
+    }
+    else
+    {
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            if (0UL != (channelMask & (1UL << channel)))
+            {
+                length += TraceWriteVarint(&encoded[length], TraceZigZag(record->Values[channel].Bits - writer->Previous[channel]));
+            }
+        }
+    }
+    if ((writer->Length + length) > writer->Capacity)
+    {
+        return false;
+    }
+
+    /* The record fits, commit it */
+    (void) memcpy(&writer->Buffer[writer->Length], encoded, length);
+    writer->Length += length;
+    writer->RecordCount++;
+    writer->PreviousMs = record->TimestampMs;
+    if (0UL == record->Retcode)
+    {
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            if (0UL != (channelMask & (1UL << channel)))
+            {
+                writer->Previous[channel] = record->Values[channel].Bits;
+            }
+        }
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+uint32_t SensorTrace_FinishChunk(SensorTrace_Writer_T * writer)
+{
+    uint32_t recordLength;
+
+    if ((NULL == writer) || (0UL == writer->RecordCount))
+    {
+        return 0UL;
+    }
+    recordLength = writer->Length - SENSOR_TRACE_CHUNK_PREFIX_SIZE;
+    writer->Buffer[0] = (uint8_t) (recordLength & 0xFFU);
+    writer->Buffer[1] = (uint8_t) (recordLength >> 8);
+    return writer->Length;
+}
+
+/** Refer interface header for description */
+bool SensorTrace_InitReader(SensorTrace_Reader_T * reader, const uint8_t * data, uint32_t length)
+{
+    if ((NULL == reader) || (NULL == data) || (length < SENSOR_TRACE_HEADER_SIZE) || ('S' != data[0]) || ('T' != data[1]) ||
+            (SENSOR_TRACE_VERSION != data[2]) || ((uint8_t) SENSOR_TABLE_SENSOR_COUNT != data[3]) ||
+            ((uint8_t) SENSOR_TABLE_CHANNEL_COUNT != data[4]))
+    {
+        return false;
+    }
+    reader->Data = data;
+    reader->Length = length;
+    reader->Offset = SENSOR_TRACE_HEADER_SIZE;
+    reader->ChunkEnd = SENSOR_TRACE_HEADER_SIZE;
+    reader->PreviousMs = 0UL;
+    reader->IsTruncated = false;
+    return true;
+}
+
+/** Refer interface header for description */
+bool SensorTrace_Next(SensorTrace_Reader_T * reader, SensorTrace_Record_T * record)
+{
+    const uint8_t * data;
+    uint32_t channelMask;
+    uint32_t value;
+    uint32_t chunkLength;
+    uint8_t head;
+    uint8_t length;
+    uint8_t channel;
+
+    if ((NULL == reader) || (NULL == record))
+    {
+        return false;
+    }
+    data = reader->Data;
+    if (reader->Offset >= reader->ChunkEnd)
+    {
+        /* Next chunk; a zero length is the unwritten rest of a preallocated file */
+        if ((reader->Offset + SENSOR_TRACE_CHUNK_PREFIX_SIZE) > reader->Length)
+        {
+            reader->IsTruncated = (reader->Offset != reader->Length);
+            return false;
+        }
+        chunkLength = (uint32_t) data[reader->Offset] | ((uint32_t) data[reader->Offset + 1U] << 8);
+        if ((0UL == chunkLength) || ((reader->Offset + SENSOR_TRACE_CHUNK_PREFIX_SIZE + chunkLength) > reader->Length))
+        {
+            reader->IsTruncated = (0UL != chunkLength);
+            return false;
+        }
+        reader->Offset += SENSOR_TRACE_CHUNK_PREFIX_SIZE;
+        reader->ChunkEnd = reader->Offset + chunkLength;
+        reader->PreviousMs = 0UL;
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            reader->Previous[channel] = 0UL;
+        }
+    }
+
+    head = data[reader->Offset];
+    record->Sensor = head & SENSOR_TRACE_SENSOR_MASK;
+    if (record->Sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT)
+    {
+        reader->IsTruncated = true;
+        return false;
+    }
+    length = TraceReadVarint(&data[reader->Offset + 1U], reader->ChunkEnd - reader->Offset - 1U, &value);
+    if (0U == length)
+    {
+        reader->IsTruncated = true;
+        return false;
+    }
+    reader->Offset += 1U + length;
+    reader->PreviousMs += value;
+    record->TimestampMs = reader->PreviousMs;
+    record->Retcode = 0UL;
+    if (0U != (head & SENSOR_TRACE_FLAG_FAILED))
+    {
+        length = TraceReadVarint(&data[reader->Offset], reader->ChunkEnd - reader->Offset, &record->Retcode);
+        if (0U == length)
+        {
+            reader->IsTruncated = true;
+            return false;
+        }
+        reader->Offset += length;
+        return true;
+    }
+    channelMask = SensorTable_GetChannelMask(record->Sensor);
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (channelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        length = TraceReadVarint(&data[reader->Offset], reader->ChunkEnd - reader->Offset, &value);
+        if (0U == length)
+        {
+            reader->IsTruncated = true;
+            return false;
+        }
+        reader->Offset += length;
+        reader->Previous[channel] += TraceUnZigZag(value);
+        record->Values[channel].Bits = reader->Previous[channel];
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+bool SensorTrace_Apply(const SensorTrace_Record_T * record, SensorTable_Value_T * values)
+{
+    uint32_t channelMask;
+    uint8_t channel;
+
+    if ((NULL == record) || (NULL == values) || (0UL != record->Retcode))
+    {
+        return false;
+    }
+    channelMask = SensorTable_GetChannelMask(record->Sensor);
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL != (channelMask & (1UL << channel)))
+        {
+            values[channel] = record->Values[channel];
+        }
+    }
+    return true;
+}
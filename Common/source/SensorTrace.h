@@ -0,0 +1,147 @@
+/**
+ *  @file
+ *
+ *  @brief Compact binary trace of sensor reads, for recording on the device
+ *  and deterministic replay on the host.
+ *
+ *  Every read of a sensor becomes one record: the sensor, the time of the
+ *  read, the return code of the driver and, for a successful read, the values
+ *  of the channels the sensor delivers. Failed reads are kept, they are what
+ *  replays of problems in the field most often need.
+ *
+ *  Records are written into chunks of a caller owned buffer. Timestamps are
+ *  stored as the difference to the previous record and channel values as the
+ *  zig-zag encoded difference of their raw 32 bit words to the previous value
+ *  of the channel, both as base 128 varints, so a read of a slow changing
+ *  sensor takes a few bytes. Every chunk starts from zero, a trace cut short
+ *  by a reset loses at most its last chunk.
+ *
+ *  File layout: a SENSOR_TRACE_HEADER_SIZE byte header, then the chunks.
+ *  | 0 | 1 | 2       | 3           | 4            | 5..7     |
+ *  | S | T | version | sensorCount | channelCount | reserved |
+ *  Chunk: 16 bit little endian length of the records, then the records.
+ *  Record: sensor (bits 0..6, bit 7 set for a failed read), varint time
+ *  difference in ms, then the varint return code of a failed read or the
+ *  varint value differences of the channels of the sensor in channel order.
+ *
+ *  The module is platform independent; SensorTraceAgent records on the XDK,
+ *  Tools/SensorTraceReplay replays.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORTRACE_H_
+#define SENSORTRACE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorTable.h"
+
+/* local type and macro definitions */
+
+#define SENSOR_TRACE_HEADER_SIZE        UINT32_C(8)
+
+#define SENSOR_TRACE_VERSION            UINT8_C(1)
+
+/** Chunk length prefix */
+#define SENSOR_TRACE_CHUNK_PREFIX_SIZE  UINT32_C(2)
+
+/** Largest encoded record: sensor, time and three channels (the most a sensor has) of 5 byte varints */
+#define SENSOR_TRACE_MAX_RECORD_SIZE    UINT32_C(21)
+
+/**
+ * @brief One sensor read.
+ */
+struct SensorTrace_Record_S
+{
+    uint32_t TimestampMs; /**< Milliseconds since boot at the end of the read */
+    uint8_t Sensor; /**< SensorTable_Sensor_T */
+    uint32_t Retcode; /**< Return code of the driver, 0 (RETCODE_OK) for a successful read */
+    SensorTable_Value_T Values[SENSOR_TABLE_CHANNEL_COUNT]; /**< Channels of Sensor, successful reads only */
+};
+typedef struct SensorTrace_Record_S SensorTrace_Record_T;
+
+/**
+ * @brief Writer of one chunk.
+ */
+struct SensorTrace_Writer_S
+{
+    uint8_t * Buffer;
+    uint32_t Capacity;
+    uint32_t Length; /**< Including the length prefix */
+    uint32_t RecordCount;
+    uint32_t PreviousMs;
+    uint32_t Previous[SENSOR_TABLE_CHANNEL_COUNT]; /**< Raw bits of the last value of every channel */
+};
+typedef struct SensorTrace_Writer_S SensorTrace_Writer_T;
+
+/**
+ * @brief Reader of a complete trace.
+ */
+struct SensorTrace_Reader_S
+{
+    const uint8_t * Data;
+    uint32_t Length;
+    uint32_t Offset; /**< Next record */
+    uint32_t ChunkEnd; /**< End of the current chunk, Offset at the start of the next one */
+    uint32_t PreviousMs;
+    uint32_t Previous[SENSOR_TABLE_CHANNEL_COUNT];
+    bool IsTruncated; /**< The trace ends inside a chunk */
+};
+typedef struct SensorTrace_Reader_S SensorTrace_Reader_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Writes the file header.
+ *
+ * @return SENSOR_TRACE_HEADER_SIZE, 0 if the buffer is too small.
+ */
+uint32_t SensorTrace_WriteHeader(uint8_t * buffer, uint32_t size);
+
+/**
+ * @brief Starts a chunk in the given buffer.
+ *
+ * @return false if the buffer cannot hold the length prefix and one record.
+ */
+bool SensorTrace_InitWriter(SensorTrace_Writer_T * writer, uint8_t * buffer, uint32_t capacity);
+
+/**
+ * @brief Appends a record to the chunk; all or nothing.
+ *
+ * @return false if the record does not fit or its sensor is invalid.
+ */
+bool SensorTrace_Append(SensorTrace_Writer_T * writer, const SensorTrace_Record_T * record);
+
+/**
+ * @brief Completes the length prefix of the chunk.
+ *
+ * @return Number of bytes of the buffer used by the chunk, 0 for a chunk without records.
+ */
+uint32_t SensorTrace_FinishChunk(SensorTrace_Writer_T * writer);
+
+/**
+ * @brief Checks the header of a trace and prepares reading its records.
+ *
+ * @return false if the header is invalid or from another sensor table.
+ */
+bool SensorTrace_InitReader(SensorTrace_Reader_T * reader, const uint8_t * data, uint32_t length);
+
+/**
+ * @brief Decodes the next record.
+ *
+ * @return false at the end of the trace, or at the first damaged or truncated chunk.
+ */
+bool SensorTrace_Next(SensorTrace_Reader_T * reader, SensorTrace_Record_T * record);
+
+/**
+ * @brief Applies a read to the channel storage as the sensor component does:
+ * a successful read sets the channels of its sensor, a failed one leaves them.
+ *
+ * @return true if the read was successful.
+ */
+bool SensorTrace_Apply(const SensorTrace_Record_T * record, SensorTable_Value_T * values);
+
+#endif /* SENSORTRACE_H_ */
@@ -0,0 +1,306 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the static or heap allocation of RTOS objects.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_STATIC_RTOS
+
+#include "StaticRtos.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* local type and macro definitions */
+
+/**
+ * @brief One created object of the report.
+ */
+struct StaticRtosObject_S
+{
+    const char * Name;
+    uint32_t Bytes; /**< Storage size, or heap decrease */
+};
+typedef struct StaticRtosObject_S StaticRtosObject_T;
+
+/* local variables ********************************************************** */
+
+static StaticRtosObject_T RtosObjects[STATIC_RTOS_MAX_OBJECTS];
+
+static uint8_t RtosObjectCount = 0U;
+
+static uint32_t RtosObjectBytes = 0UL; /**< Of all objects, also those not listed */
+
+static uint32_t RtosObjectsNotListed = 0UL;
+
+#if configSUPPORT_STATIC_ALLOCATION
+static StaticTask_t IdleTaskTcb;
+
+static StackType_t IdleTaskStack[configMINIMAL_STACK_SIZE];
+
+#if configUSE_TIMERS
+static StaticTask_t TimerTaskTcb;
+
+static StackType_t TimerTaskStack[configTIMER_TASK_STACK_DEPTH];
+#endif /* configUSE_TIMERS */
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Starts the creation of an object; the scheduler stays suspended until RtosCreated.
+ *
+ * @return Free heap before the creation.
+ */
+static size_t RtosCreating(void)
+{
+    vTaskSuspendAll();
+    return xPortGetFreeHeapSize();
+}
+
+/**
+ * @brief Records a created object and resumes the scheduler.
+ *
+ * @param[in] freeHeap
+ * Return value of RtosCreating
+ *
+ * @param[in] staticBytes
+ * Storage size of the object with static allocation
+ */
+static void RtosCreated(const void * object, const char * name, size_t freeHeap, uint32_t staticBytes)
+{
+#if APP_STATIC_ALLOCATION_ENABLE
+    uint32_t bytes = staticBytes;
+
+    BCDS_UNUSED(freeHeap);
+#else
+    /* The scheduler is suspended, no other task allocated in between */
+    uint32_t bytes = (uint32_t) (freeHeap - xPortGetFreeHeapSize());
+
+    BCDS_UNUSED(staticBytes);
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+
+    if (NULL != object)
+    {
+        RtosObjectBytes += bytes;
+        if (RtosObjectCount < STATIC_RTOS_MAX_OBJECTS)
+        {
+            RtosObjects[RtosObjectCount].Name = name;
+            RtosObjects[RtosObjectCount].Bytes = bytes;
+            RtosObjectCount++;
+        }
+        else
+        {
+            RtosObjectsNotListed++;
+        }
+    }
+    (void) xTaskResumeAll();
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+StaticRtos_Task_T * StaticRtos_GetTask(StaticRtos_Task_T * task, StackType_t * stack, uint32_t stackWords)
+{
+    task->Stack = stack;
+    task->StackWords = stackWords;
+    return task;
+}
+
+/** Refer interface header for description */
+xTaskHandle StaticRtos_CreateTask(StaticRtos_Task_T * task, TaskFunction_t function, const char * name, void * parameter, UBaseType_t priority)
+{
+    xTaskHandle handle = NULL;
+    size_t freeHeap;
+
+    if ((NULL == task) || (NULL == function))
+    {
+        return NULL;
+    }
+    freeHeap = RtosCreating();
+#if APP_STATIC_ALLOCATION_ENABLE
+    if (NULL != task->Stack)
+    {
+        handle = xTaskCreateStatic(function, name, task->StackWords, parameter, priority, task->Stack, &task->Tcb);
+    }
+#else
+    if (pdPASS != xTaskCreate(function, name, (uint16_t) task->StackWords, parameter, priority, &handle))
+    {
+        handle = NULL;
+    }
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    RtosCreated(handle, name, freeHeap, (uint32_t) (sizeof(StaticTask_t) + (task->StackWords * sizeof(StackType_t))));
+    return handle;
+}
+
+/** Refer interface header for description */
+QueueHandle_t StaticRtos_CreateQueue(StaticRtos_Queue_T * queue, const char * name)
+{
+    QueueHandle_t handle = NULL;
+    size_t freeHeap;
+
+    if (NULL == queue)
+    {
+        return NULL;
+    }
+    freeHeap = RtosCreating();
+#if APP_STATIC_ALLOCATION_ENABLE
+    if (NULL != queue->Items)
+    {
+        handle = xQueueCreateStatic(queue->Length, queue->ItemSize, queue->Items, &queue->Queue);
+    }
+#else
+    handle = xQueueCreate(queue->Length, queue->ItemSize);
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    RtosCreated(handle, name, freeHeap, (uint32_t) (sizeof(StaticQueue_t) + (queue->Length * queue->ItemSize)));
+    return handle;
+}
+
+/** Refer interface header for description */
+xTimerHandle StaticRtos_CreateTimer(StaticRtos_Timer_T * timer, const char * name, TickType_t period, UBaseType_t autoReload, void * id,
+        TimerCallbackFunction_t callback)
+{
+    xTimerHandle handle;
+    size_t freeHeap;
+
+    if (NULL == timer)
+    {
+        return NULL;
+    }
+    freeHeap = RtosCreating();
+#if APP_STATIC_ALLOCATION_ENABLE
+    handle = xTimerCreateStatic(name, period, autoReload, id, callback, timer);
+#else
+    handle = xTimerCreate(name, period, autoReload, id, callback);
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    RtosCreated(handle, name, freeHeap, (uint32_t) sizeof(StaticTimer_t));
+    return handle;
+}
+
+/** Refer interface header for description */
+SemaphoreHandle_t StaticRtos_CreateMutex(StaticRtos_Semaphore_T * semaphore, const char * name)
+{
+    SemaphoreHandle_t handle;
+    size_t freeHeap;
+
+    if (NULL == semaphore)
+    {
+        return NULL;
+    }
+    freeHeap = RtosCreating();
+#if APP_STATIC_ALLOCATION_ENABLE
+    handle = xSemaphoreCreateMutexStatic(semaphore);
+#else
+    handle = xSemaphoreCreateMutex();
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    RtosCreated(handle, name, freeHeap, (uint32_t) sizeof(StaticSemaphore_t));
+    return handle;
+}
+
+/** Refer interface header for description */
+SemaphoreHandle_t StaticRtos_CreateCounting(StaticRtos_Semaphore_T * semaphore, const char * name, UBaseType_t maxCount, UBaseType_t initialCount)
+{
+    SemaphoreHandle_t handle;
+    size_t freeHeap;
+
+    if (NULL == semaphore)
+    {
+        return NULL;
+    }
+    freeHeap = RtosCreating();
+#if APP_STATIC_ALLOCATION_ENABLE
+    handle = xSemaphoreCreateCountingStatic(maxCount, initialCount, semaphore);
+#else
+    handle = xSemaphoreCreateCounting(maxCount, initialCount);
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    RtosCreated(handle, name, freeHeap, (uint32_t) sizeof(StaticSemaphore_t));
+    return handle;
+}
+
+/** Refer interface header for description */
+void StaticRtos_ExitTask(void)
+{
+#if APP_STATIC_ALLOCATION_ENABLE
+    for (;;)
+    {
+        vTaskSuspend(NULL);
+    }
+#else
+    vTaskDelete(NULL);
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+}
+
+/** Refer interface header for description */
+bool StaticRtos_ReclaimTask(xTaskHandle * handle)
+{
+    if (NULL == handle)
+    {
+        return false;
+    }
+#if APP_STATIC_ALLOCATION_ENABLE
+    if (NULL != *handle)
+    {
+        /* A task blocked without timeout reports eBlocked, eSuspended only comes from StaticRtos_ExitTask */
+        if (eSuspended != eTaskGetState(*handle))
+        {
+            return false;
+        }
+        /* Deleting another task frees the TCB at once, no idle task involved */
+        vTaskDelete(*handle);
+    }
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    /* A task on the heap deleted itself, the handle may be stale already */
+    *handle = NULL;
+    return true;
+}
+
+/** Refer interface header for description */
+void StaticRtos_PrintReport(void)
+{
+    uint8_t object;
+
+    printf("StaticRtos : %s allocation\r\n", APP_STATIC_ALLOCATION_ENABLE ? "static" : "heap");
+    for (object = 0U; object < RtosObjectCount; object++)
+    {
+        printf("StaticRtos :   %-16s %6lu\r\n", RtosObjects[object].Name, (unsigned long) RtosObjects[object].Bytes);
+    }
+    if (0UL != RtosObjectsNotListed)
+    {
+        printf("StaticRtos :   %lu more\r\n", (unsigned long) RtosObjectsNotListed);
+    }
+    printf("StaticRtos : %lu objects, %lu bytes %s\r\n", (unsigned long) (RtosObjectCount + RtosObjectsNotListed), (unsigned long) RtosObjectBytes,
+            APP_STATIC_ALLOCATION_ENABLE ? "in the bss" : "from the heap");
+    printf("StaticRtos : heap %lu bytes, %lu used, %lu minimum free\r\n", (unsigned long) configTOTAL_HEAP_SIZE,
+            (unsigned long) (configTOTAL_HEAP_SIZE - xPortGetFreeHeapSize()), (unsigned long) xPortGetMinimumEverFreeHeapSize());
+}
+
+#if configSUPPORT_STATIC_ALLOCATION
+/**
+ * @brief Storage of the idle task, needed by the kernel with static allocation support.
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t ** ppxIdleTaskTCBBuffer, StackType_t ** ppxIdleTaskStackBuffer, uint32_t * pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer = &IdleTaskTcb;
+    *ppxIdleTaskStackBuffer = IdleTaskStack;
+    *pulIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+#if configUSE_TIMERS
+/**
+ * @brief Storage of the timer service task, needed by the kernel with static allocation support.
+ */
+void vApplicationGetTimerTaskMemory(StaticTask_t ** ppxTimerTaskTCBBuffer, StackType_t ** ppxTimerTaskStackBuffer, uint32_t * pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer = &TimerTaskTcb;
+    *ppxTimerTaskStackBuffer = TimerTaskStack;
+    *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
+#endif /* configUSE_TIMERS */
+#endif /* configSUPPORT_STATIC_ALLOCATION */
@@ -0,0 +1,204 @@
+/**
+ *  @file
+ *
+ *  @brief Creates the tasks, queues, timers and semaphores of an application
+ *  either from static storage or from the FreeRTOS heap.
+ *
+ *  APP_STATIC_ALLOCATION_ENABLE in the XdkAppInfo.h of the application
+ *  selects the mode for every object created through this module:
+ *  - 1: TCB, stack, queue, timer and semaphore live in the storage the caller
+ *    declares, i.e. in the bss of the application. Their size shows up in
+ *    the footprint report at link time, and the heap only has to hold what
+ *    the SDK allocates itself (e.g. the command processor task and queue of
+ *    Main.c, WLAN and the Serval stack). This needs configSUPPORT_STATIC_ALLOCATION
+ *    in the FreeRTOSConfig.h of the SDK; rebuild the libraries after changing it.
+ *  - 0: the objects come from the heap as before; the storage only carries
+ *    the stack size, and no RAM is reserved.
+ *
+ *  Every object created is recorded with its size: the storage size with
+ *  static allocation, the measured heap decrease otherwise.
+ *  StaticRtos_PrintReport prints the objects together with the heap usage,
+ *  so the output of a build of either mode shows how far configTOTAL_HEAP_SIZE
+ *  can shrink with static allocation.
+ *
+ *  A task with static storage must not delete itself if the storage is
+ *  reused later: the idle task still uses the TCB after the deletion. Such a
+ *  task ends with StaticRtos_ExitTask, and the storage is made reusable with
+ *  StaticRtos_ReclaimTask.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef STATICRTOS_H_
+#define STATICRTOS_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "queue.h"
+#include "semphr.h"
+
+#include "XdkAppInfo.h"
+
+/* local type and macro definitions */
+
+#ifndef APP_STATIC_ALLOCATION_ENABLE
+#define APP_STATIC_ALLOCATION_ENABLE        UINT32_C(0)
+#endif
+
+#if APP_STATIC_ALLOCATION_ENABLE && !configSUPPORT_STATIC_ALLOCATION
+#error "APP_STATIC_ALLOCATION_ENABLE needs configSUPPORT_STATIC_ALLOCATION set to 1 in the FreeRTOSConfig.h of the SDK"
+#endif
+
+/** Maximum number of objects StaticRtos_PrintReport lists */
+#define STATIC_RTOS_MAX_OBJECTS             UINT8_C(24)
+
+/**
+ * @brief Storage of one task.
+ */
+struct StaticRtos_Task_S
+{
+#if APP_STATIC_ALLOCATION_ENABLE
+    StaticTask_t Tcb;
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    StackType_t * Stack; /**< NULL with heap allocation */
+    uint32_t StackWords;
+};
+typedef struct StaticRtos_Task_S StaticRtos_Task_T;
+
+/**
+ * @brief Storage of one queue.
+ */
+struct StaticRtos_Queue_S
+{
+#if APP_STATIC_ALLOCATION_ENABLE
+    StaticQueue_t Queue;
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+    uint8_t * Items; /**< NULL with heap allocation */
+    uint32_t Length;
+    uint32_t ItemSize;
+};
+typedef struct StaticRtos_Queue_S StaticRtos_Queue_T;
+
+#if APP_STATIC_ALLOCATION_ENABLE
+typedef StaticTimer_t StaticRtos_Timer_T;
+typedef StaticSemaphore_t StaticRtos_Semaphore_T;
+
+/** Declares the storage of a task with a stack of stackWords words */
+#define STATIC_RTOS_TASK(variable, stackWords) \
+    static StackType_t variable##Stack[stackWords]; \
+    static StaticRtos_Task_T variable = { .Stack = variable##Stack, .StackWords = (stackWords) }
+
+/** Declares the storage of count tasks, see STATIC_RTOS_TASK_AT */
+#define STATIC_RTOS_TASKS(variable, count, stackWords) \
+    static StackType_t variable##Stack[count][stackWords]; \
+    static StaticRtos_Task_T variable[count]
+
+/** Declares the storage of a queue of length items of itemSize bytes */
+#define STATIC_RTOS_QUEUE(variable, length, itemSize) \
+    static uint8_t variable##Items[(length) * (itemSize)]; \
+    static StaticRtos_Queue_T variable = { .Items = variable##Items, .Length = (length), .ItemSize = (itemSize) }
+
+/** Returns the storage of task index of STATIC_RTOS_TASKS */
+#define STATIC_RTOS_TASK_AT(variable, index) \
+    StaticRtos_GetTask(&variable[index], variable##Stack[index], sizeof(variable##Stack[index]) / sizeof(StackType_t))
+#else
+typedef uint8_t StaticRtos_Timer_T; /**< Unused, the timer comes from the heap */
+typedef uint8_t StaticRtos_Semaphore_T; /**< Unused, the semaphore comes from the heap */
+
+#define STATIC_RTOS_TASK(variable, stackWords) \
+    static StaticRtos_Task_T variable = { .Stack = NULL, .StackWords = (stackWords) }
+
+#define STATIC_RTOS_TASKS(variable, count, stackWords) \
+    static const uint32_t variable##StackWords = (stackWords); \
+    static StaticRtos_Task_T variable[count]
+
+#define STATIC_RTOS_TASK_AT(variable, index) \
+    StaticRtos_GetTask(&variable[index], NULL, variable##StackWords)
+
+#define STATIC_RTOS_QUEUE(variable, length, itemSize) \
+    static StaticRtos_Queue_T variable = { .Items = NULL, .Length = (length), .ItemSize = (itemSize) }
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+
+/* global function prototype declarations */
+
+/**
+ * @brief Sets up and returns the storage of one task of STATIC_RTOS_TASKS; use STATIC_RTOS_TASK_AT.
+ */
+StaticRtos_Task_T * StaticRtos_GetTask(StaticRtos_Task_T * task, StackType_t * stack, uint32_t stackWords);
+
+/**
+ * @brief Creates a task, see xTaskCreate.
+ *
+ * @param[in] task
+ * Storage declared with STATIC_RTOS_TASK; a task of it must not exist anymore
+ *
+ * @return The task, NULL if it could not be created.
+ */
+xTaskHandle StaticRtos_CreateTask(StaticRtos_Task_T * task, TaskFunction_t function, const char * name, void * parameter, UBaseType_t priority);
+
+/**
+ * @brief Creates a queue, see xQueueCreate.
+ *
+ * @param[in] queue
+ * Storage declared with STATIC_RTOS_QUEUE
+ *
+ * @param[in] name
+ * Name in the report
+ *
+ * @return The queue, NULL if it could not be created.
+ */
+QueueHandle_t StaticRtos_CreateQueue(StaticRtos_Queue_T * queue, const char * name);
+
+/**
+ * @brief Creates a timer, see xTimerCreate.
+ *
+ * @return The timer, NULL if it could not be created.
+ */
+xTimerHandle StaticRtos_CreateTimer(StaticRtos_Timer_T * timer, const char * name, TickType_t period, UBaseType_t autoReload, void * id,
+        TimerCallbackFunction_t callback);
+
+/**
+ * @brief Creates a mutex, see xSemaphoreCreateMutex.
+ *
+ * @param[in] name
+ * Name in the report
+ *
+ * @return The mutex, NULL if it could not be created.
+ */
+SemaphoreHandle_t StaticRtos_CreateMutex(StaticRtos_Semaphore_T * semaphore, const char * name);
+
+/**
+ * @brief Creates a counting semaphore, see xSemaphoreCreateCounting.
+ *
+ * @param[in] name
+ * Name in the report
+ *
+ * @return The semaphore, NULL if it could not be created.
+ */
+SemaphoreHandle_t StaticRtos_CreateCounting(StaticRtos_Semaphore_T * semaphore, const char * name, UBaseType_t maxCount, UBaseType_t initialCount);
+
+/**
+ * @brief Ends the calling task. With static allocation the task only
+ * suspends itself until StaticRtos_ReclaimTask deletes it; otherwise it deletes itself.
+ */
+void StaticRtos_ExitTask(void);
+
+/**
+ * @brief Makes the storage of a task which ended with StaticRtos_ExitTask reusable.
+ *
+ * @param[in,out] handle
+ * Task, NULL if none was created; set to NULL if the storage is reusable
+ *
+ * @return false if the task did not end yet.
+ */
+bool StaticRtos_ReclaimTask(xTaskHandle * handle);
+
+/**
+ * @brief Prints the objects created so far and the heap usage.
+ */
+void StaticRtos_PrintReport(void);
+
+#endif /* STATICRTOS_H_ */
@@ -0,0 +1,263 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the work dispatcher.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_WORK_DISPATCHER
+
+#include "WorkDispatcher.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "StaticRtos.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief One queued work item.
+ */
+struct WorkDispatcherItem_S
+{
+    WorkDispatcher_Func_T Func;
+    void * Param1;
+    uint32_t Param2;
+    TickType_t EnqueuedTicks;
+};
+typedef struct WorkDispatcherItem_S WorkDispatcherItem_T;
+
+/**
+ * @brief Configuration of one lane.
+ */
+struct WorkDispatcherLane_S
+{
+    const char * Name;
+    StaticRtos_Task_T * Task;
+    StaticRtos_Queue_T * Queue;
+    UBaseType_t Priority;
+};
+typedef struct WorkDispatcherLane_S WorkDispatcherLane_T;
+
+/* local variables ********************************************************** */
+
+STATIC_RTOS_TASK(RealtimeTask, TASK_STACK_SIZE_DISPATCHER_REALTIME);
+
+STATIC_RTOS_QUEUE(RealtimeQueue, TASK_Q_LEN_DISPATCHER_REALTIME, sizeof(WorkDispatcherItem_T));
+
+STATIC_RTOS_TASK(NormalTask, TASK_STACK_SIZE_DISPATCHER_NORMAL);
+
+STATIC_RTOS_QUEUE(NormalQueue, TASK_Q_LEN_DISPATCHER_NORMAL, sizeof(WorkDispatcherItem_T));
+
+STATIC_RTOS_TASK(BackgroundTask, TASK_STACK_SIZE_DISPATCHER_BACKGROUND);
+
+STATIC_RTOS_QUEUE(BackgroundQueue, TASK_Q_LEN_DISPATCHER_BACKGROUND, sizeof(WorkDispatcherItem_T));
+
+static const WorkDispatcherLane_T DispatcherLanes[WORK_DISPATCHER_LANE_COUNT] =
+        {
+                [WORK_DISPATCHER_LANE_REALTIME] = { "Realtime", &RealtimeTask, &RealtimeQueue, TASK_PRIO_DISPATCHER_REALTIME },
+                [WORK_DISPATCHER_LANE_NORMAL] = { "Normal", &NormalTask, &NormalQueue, TASK_PRIO_DISPATCHER_NORMAL },
+                [WORK_DISPATCHER_LANE_BACKGROUND] = { "Background", &BackgroundTask, &BackgroundQueue, TASK_PRIO_DISPATCHER_BACKGROUND },
+        };
+
+static QueueHandle_t DispatcherQueues[WORK_DISPATCHER_LANE_COUNT];
+
+static WorkDispatcher_Statistics_T DispatcherStatistics[WORK_DISPATCHER_LANE_COUNT];
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Returns the histogram bucket of a latency.
+ */
+static uint8_t DispatcherBucket(uint32_t latencyMs)
+{
+    uint8_t bucket = 0U;
+
+    while ((0UL != latencyMs) && (bucket < (WORK_DISPATCHER_HISTOGRAM_BUCKETS - 1U)))
+    {
+        latencyMs >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Counts an accepted or refused item; the caller protects the counters.
+ */
+static Retcode_T DispatcherCount(WorkDispatcher_Statistics_T * statistics, bool isQueued, uint32_t waiting)
+{
+    if (!isQueued)
+    {
+        statistics->Rejected++;
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    statistics->Enqueued++;
+    if (waiting > statistics->QueueHighWater)
+    {
+        statistics->QueueHighWater = waiting;
+    }
+    return RETCODE_OK;
+}
+
+/**
+ * @brief Lane task, runs the items of its lane in order.
+ *
+ * @param[in] pvParameters
+ * Lane
+ */
+static void DispatcherLaneTask(void * pvParameters)
+{
+    uint8_t lane = (uint8_t) (uintptr_t) pvParameters;
+    WorkDispatcher_Statistics_T * statistics = &DispatcherStatistics[lane];
+    WorkDispatcherItem_T item;
+    TickType_t startTicks;
+    uint32_t latencyMs;
+    uint32_t runMs;
+
+    for (;;)
+    {
+        if (pdTRUE == xQueueReceive(DispatcherQueues[lane], &item, portMAX_DELAY))
+        {
+            startTicks = xTaskGetTickCount();
+            item.Func(item.Param1, item.Param2);
+            latencyMs = (uint32_t) ((startTicks - item.EnqueuedTicks) * portTICK_PERIOD_MS);
+            runMs = (uint32_t) ((xTaskGetTickCount() - startTicks) * portTICK_PERIOD_MS);
+
+            /* Only this task writes these counters */
+            statistics->Executed++;
+            statistics->LatencyHistogram[DispatcherBucket(latencyMs)]++;
+            if (latencyMs > statistics->MaxLatencyMs)
+            {
+                statistics->MaxLatencyMs = latencyMs;
+            }
+            if (runMs > statistics->MaxRunMs)
+            {
+                statistics->MaxRunMs = runMs;
+            }
+        }
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T WorkDispatcher_Initialize(void)
+{
+    uint8_t lane;
+
+    for (lane = 0U; lane < (uint8_t) WORK_DISPATCHER_LANE_COUNT; lane++)
+    {
+        if (NULL != DispatcherQueues[lane])
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INCONSISTENT_STATE);
+        }
+        DispatcherQueues[lane] = StaticRtos_CreateQueue(DispatcherLanes[lane].Queue, DispatcherLanes[lane].Name);
+        if ((NULL == DispatcherQueues[lane]) ||
+                (NULL == StaticRtos_CreateTask(DispatcherLanes[lane].Task, DispatcherLaneTask, DispatcherLanes[lane].Name,
+                        (void *) (uintptr_t) lane, DispatcherLanes[lane].Priority)))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T WorkDispatcher_Enqueue(WorkDispatcher_Lane_T lane, WorkDispatcher_Func_T func, void * param1, uint32_t param2)
+{
+    WorkDispatcherItem_T item;
+    bool isQueued;
+    Retcode_T retcode;
+
+    if (((uint8_t) lane >= (uint8_t) WORK_DISPATCHER_LANE_COUNT) || (NULL == func))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (NULL == DispatcherQueues[lane])
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    item.Func = func;
+    item.Param1 = param1;
+    item.Param2 = param2;
+    item.EnqueuedTicks = xTaskGetTickCount();
+
+    isQueued = (pdTRUE == xQueueSend(DispatcherQueues[lane], &item, 0UL));
+    taskENTER_CRITICAL();
+    retcode = DispatcherCount(&DispatcherStatistics[lane], isQueued, (uint32_t) uxQueueMessagesWaiting(DispatcherQueues[lane]));
+    taskEXIT_CRITICAL();
+
+    return retcode;
+}
+
+/** Refer interface header for description */
+Retcode_T WorkDispatcher_EnqueueFromIsr(WorkDispatcher_Lane_T lane, WorkDispatcher_Func_T func, void * param1, uint32_t param2)
+{
+    WorkDispatcherItem_T item;
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    UBaseType_t interruptStatus;
+    bool isQueued;
+    Retcode_T retcode;
+
+    if (((uint8_t) lane >= (uint8_t) WORK_DISPATCHER_LANE_COUNT) || (NULL == func))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (NULL == DispatcherQueues[lane])
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    item.Func = func;
+    item.Param1 = param1;
+    item.Param2 = param2;
+    item.EnqueuedTicks = xTaskGetTickCountFromISR();
+
+    isQueued = (pdTRUE == xQueueSendFromISR(DispatcherQueues[lane], &item, &higherPriorityTaskWoken));
+    interruptStatus = taskENTER_CRITICAL_FROM_ISR();
+    retcode = DispatcherCount(&DispatcherStatistics[lane], isQueued, (uint32_t) uxQueueMessagesWaitingFromISR(DispatcherQueues[lane]));
+    taskEXIT_CRITICAL_FROM_ISR(interruptStatus);
+
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    return retcode;
+}
+
+/** Refer interface header for description */
+const WorkDispatcher_Statistics_T * WorkDispatcher_GetStatistics(WorkDispatcher_Lane_T lane)
+{
+    return ((uint8_t) lane < (uint8_t) WORK_DISPATCHER_LANE_COUNT) ? &DispatcherStatistics[lane] : NULL;
+}
+
+/** Refer interface header for description */
+void WorkDispatcher_PrintReport(void)
+{
+    const WorkDispatcher_Statistics_T * statistics;
+    uint8_t lane;
+    uint8_t bucket;
+
+    for (lane = 0U; lane < (uint8_t) WORK_DISPATCHER_LANE_COUNT; lane++)
+    {
+        statistics = &DispatcherStatistics[lane];
+        printf("WorkDispatcher : %-10s %lu run, %lu refused, queue max %lu of %lu, latency max %lu ms, run max %lu ms\r\n",
+                DispatcherLanes[lane].Name, (unsigned long) statistics->Executed, (unsigned long) statistics->Rejected,
+                (unsigned long) statistics->QueueHighWater, (unsigned long) DispatcherLanes[lane].Queue->Length,
+                (unsigned long) statistics->MaxLatencyMs, (unsigned long) statistics->MaxRunMs);
+        printf("WorkDispatcher :   latency ms");
+        for (bucket = 0U; bucket < WORK_DISPATCHER_HISTOGRAM_BUCKETS; bucket++)
+        {
+            /* Lower bound of the bucket */
+            printf(" %lu+:%lu", (0U == bucket) ? 0UL : (1UL << (bucket - 1U)), (unsigned long) statistics->LatencyHistogram[bucket]);
+        }
+        printf("\r\n");
+    }
+}
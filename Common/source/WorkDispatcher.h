@@ -0,0 +1,116 @@
+/**
+ *  @file
+ *
+ *  @brief Runs application work items on three lanes of different priority.
+ *
+ *  The single command processor of Main.c ran everything in order: setup,
+ *  enable, sensor reads and the ServalPAL network callbacks, so a slow
+ *  network callback delayed the acquisition and vice versa. The dispatcher
+ *  adds one task with its own bounded queue per lane:
+ *  - real-time: sensor acquisition, short and periodic,
+ *  - normal: setup, enable, encoding and upload work,
+ *  - background: logging and storage writes, runs when nothing else does.
+ *
+ *  The ServalPAL callbacks stay on the command processor, ServalPAL_Setup
+ *  takes a CmdProcessor_T.
+ *
+ *  WorkDispatcher_Enqueue takes the same function signature as
+ *  CmdProcessor_Enqueue and never blocks: a full lane refuses the item and
+ *  counts it (backpressure), the caller decides whether to drop or retry.
+ *  Every lane records the queueing latency of its items in a histogram.
+ *
+ *  Priority, stack size and queue length of every lane are set in the
+ *  XdkAppInfo.h of the application (TASK_*_DISPATCHER_*).
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef WORKDISPATCHER_H_
+#define WORKDISPATCHER_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+/* local type and macro definitions */
+
+/** Latency histogram buckets: 0 ms, then [2^(n-1), 2^n) ms, the last one 256 ms and more */
+#define WORK_DISPATCHER_HISTOGRAM_BUCKETS   UINT8_C(10)
+
+/**
+ * @brief Dispatcher lanes, highest priority first.
+ */
+enum WorkDispatcher_Lane_E
+{
+    WORK_DISPATCHER_LANE_REALTIME = 0,
+    WORK_DISPATCHER_LANE_NORMAL,
+    WORK_DISPATCHER_LANE_BACKGROUND,
+
+    WORK_DISPATCHER_LANE_COUNT
+};
+typedef enum WorkDispatcher_Lane_E WorkDispatcher_Lane_T;
+
+/**
+ * @brief Work item function, same signature as CmdProcessor_Func_T.
+ */
+typedef void (*WorkDispatcher_Func_T)(void * param1, uint32_t param2);
+
+/**
+ * @brief Counters of one lane.
+ */
+struct WorkDispatcher_Statistics_S
+{
+    uint32_t Enqueued;
+    uint32_t Rejected; /**< Items refused because the lane was full */
+    uint32_t Executed;
+    uint32_t QueueHighWater; /**< Most items waiting at once */
+    uint32_t MaxLatencyMs; /**< Longest time from enqueue to start */
+    uint32_t MaxRunMs; /**< Longest item run time */
+    uint32_t LatencyHistogram[WORK_DISPATCHER_HISTOGRAM_BUCKETS];
+};
+typedef struct WorkDispatcher_Statistics_S WorkDispatcher_Statistics_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Creates the lane queues and tasks; may be called before the scheduler runs.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T WorkDispatcher_Initialize(void);
+
+/**
+ * @brief Queues a work item on a lane, see CmdProcessor_Enqueue.
+ *
+ * @param[in] lane
+ * Lane to run the item on
+ *
+ * @param[in] func
+ * Function to run in the lane task
+ *
+ * @param[in] param1
+ * First parameter of func
+ *
+ * @param[in] param2
+ * Second parameter of func
+ *
+ * @return  RETCODE_OK on success, RETCODE_OUT_OF_RESOURCES if the lane is full.
+ */
+Retcode_T WorkDispatcher_Enqueue(WorkDispatcher_Lane_T lane, WorkDispatcher_Func_T func, void * param1, uint32_t param2);
+
+/**
+ * @brief WorkDispatcher_Enqueue for interrupt service routines.
+ */
+Retcode_T WorkDispatcher_EnqueueFromIsr(WorkDispatcher_Lane_T lane, WorkDispatcher_Func_T func, void * param1, uint32_t param2);
+
+/**
+ * @brief Returns the counters of a lane, NULL for an invalid lane.
+ */
+const WorkDispatcher_Statistics_T * WorkDispatcher_GetStatistics(WorkDispatcher_Lane_T lane);
+
+/**
+ * @brief Prints the counters and latency histogram of every lane.
+ */
+void WorkDispatcher_PrintReport(void);
+
+#endif /* WORKDISPATCHER_H_ */
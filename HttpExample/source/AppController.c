@@ -11,6 +11,7 @@
 
 /* system header files */
 #include <stdio.h>
+#include <string.h>
 
 /* additional interface header files */
 #include "XDK_WLAN.h"
@@ -27,6 +28,19 @@
 #include "FreeRTOS.h"
 #include "task.h"
 
+#include "SensorComponent.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+#if HTTPS_SESSION_ENABLE
+#include "HttpsAgent.h"
+#endif /* HTTPS_SESSION_ENABLE */
+#if DNS_CACHE_ENABLE
+#include "DnsAgent.h"
+#endif /* DNS_CACHE_ENABLE */
+#if POST_SCHEMA_ENABLE
+#include "SensorSchema.h"
+#endif /* POST_SCHEMA_ENABLE */
+
 /* constant definitions ***************************************************** */
 
 #if HTTP_SECURE_ENABLE
@@ -37,6 +51,26 @@
 
 #define APP_RESPONSE_FROM_HTTP_SERVER_GET_TIMEOUT       UINT32_C(25000)/**< Timeout for completion of HTTP rest client GET */
 
+#if DNS_CACHE_ENABLE
+#define APP_DNS_REFRESH_PERIOD_MS                       UINT32_C(10000) /**< Period of the check for servers due for a refresh */
+#define APP_DNS_DEFAULT_TTL_S                           UINT32_C(300) /**< TTL of addresses from the resolver of the WLAN chip */
+#define APP_DNS_MIN_TTL_S                               UINT32_C(30)
+#define APP_DNS_MAX_TTL_S                               UINT32_C(86400)
+#define APP_DNS_REFRESH_PERCENT                         UINT8_C(75) /**< Share of the TTL after which a server is resolved again */
+#define APP_DNS_RETRY_MS                                UINT32_C(30000) /**< Shortest time between attempts to resolve a failing server */
+#define APP_DNS_TIMEOUT_MS                              UINT32_C(2000) /**< Longest wait for the DNS server */
+#endif /* DNS_CACHE_ENABLE */
+
+#if HTTPS_SESSION_ENABLE
+#define APP_HTTPS_REPORT_INTERVAL                       UINT32_C(60) /**< Posts between two HttpsAgent reports */
+#endif /* HTTPS_SESSION_ENABLE */
+
+#if POST_SCHEMA_ENABLE
+#define APP_POST_CONTENT_TYPE                           "application/octet-stream"
+#else
+#define APP_POST_CONTENT_TYPE                           "application/json"
+#endif /* POST_SCHEMA_ENABLE */
+
 /* local variables ********************************************************** */
 
 static WLAN_Setup_T WLANSetupInfo =
@@ -49,13 +83,45 @@ static WLAN_Setup_T WLANSetupInfo =
         };/**< WLAN setup parameters */
 
 #if HTTP_SECURE_ENABLE
+#if DNS_CACHE_ENABLE
+static char SntpServerUrl[sizeof(SNTP_SERVER_URL) + DNS_CACHE_ADDRESS_STRING_SIZE] = SNTP_SERVER_URL; /**< SNTP_SERVER_URL, its address once resolved */
+#endif /* DNS_CACHE_ENABLE */
+
 static SNTP_Setup_T SNTPSetupInfo =
         {
+#if DNS_CACHE_ENABLE
+                .ServerUrl = SntpServerUrl,
+#else
                 .ServerUrl = SNTP_SERVER_URL,
+#endif /* DNS_CACHE_ENABLE */
                 .ServerPort = SNTP_SERVER_PORT,
         };/**< SNTP setup parameters */
 #endif /* HTTP_SECURE_ENABLE */
 
+#if DNS_CACHE_ENABLE
+static const DnsAgent_Host_T DnsHosts[] =
+        {
+                { DEST_SERVER_HOST, DEST_SERVER_FALLBACK_ADDRESS },
+#if HTTP_SECURE_ENABLE
+                { SNTP_SERVER_URL, SNTP_SERVER_FALLBACK_ADDRESS },
+#endif /* HTTP_SECURE_ENABLE */
+        };/**< Servers resolved ahead of their first use */
+
+static const DnsAgent_Setup_T DnsAgentSetupInfo =
+        {
+                .Hosts = DnsHosts,
+                .HostCount = (uint8_t) (sizeof(DnsHosts) / sizeof(DnsHosts[0])),
+                .FileName = DNS_CACHE_FILE_NAME,
+                .RefreshPeriodMs = APP_DNS_REFRESH_PERIOD_MS,
+                .DefaultTtlS = APP_DNS_DEFAULT_TTL_S,
+                .MinTtlS = APP_DNS_MIN_TTL_S,
+                .MaxTtlS = APP_DNS_MAX_TTL_S,
+                .RefreshPercent = APP_DNS_REFRESH_PERCENT,
+                .RetryMs = APP_DNS_RETRY_MS,
+                .TimeoutMs = APP_DNS_TIMEOUT_MS,
+        };/**< DNS agent setup parameters */
+#endif /* DNS_CACHE_ENABLE */
+
 static HTTPRestClient_Setup_T HTTPRestClientSetupInfo =
         {
                 .IsSecure = HTTP_SECURE_ENABLE,
@@ -69,33 +135,83 @@ static HTTPRestClient_Config_T HTTPRestClientConfigInfo =
                 .RequestMaxDownloadSize = REQUEST_MAX_DOWNLOAD_SIZE,
         }; /**< HTTP rest client configuration parameters */
 
+static SensorTable_Value_T SensorValues[SENSOR_TABLE_CHANNEL_COUNT]; /**< Latest value of every channel, written by the sensor timers */
+
+#if !HTTPS_SESSION_ENABLE
+static char PostRequestBody[POST_REQUEST_BODY_SIZE]; /**< JSON or SensorSchema POST body */
+
 static HTTPRestClient_Post_T HTTPRestClientPostInfo =
         {
-                .Payload = "{ \"AccelerometerX\": \"3\","
-                		" \"AccelerometerY\": \"3\","
-                		" \"AccelerometerZ\": \"3\","
-                		" \"Acoustic\": \"3\","
-                		" \"Digital_light\": \"3\","
-                		" \"GyroscopeX\": \"3\","
-                		" \"GyroscopeY\": \"3\","
-                		" \"GyroscopeZ\": \"3\","
-                		" \"Humidity\": \"3\","
-                		" \"MagnetometerX\": \"3\","
-                		" \"MagnetometerY\": \"3\","
-                		" \"MagnetometerZ\": \"3\","
-                		" \"Pressure\": \"3\","
-                		" \"Temperature\": \"3\"}",
-                .PayloadLength = (sizeof(POST_REQUEST_BODY) - 1U),
+                .Payload = PostRequestBody,
+                .PayloadLength = 0UL,
                 .Url = DEST_POST_PATH,
         }; /**< HTTP rest client POST parameters */
+#endif /* !HTTPS_SESSION_ENABLE */
+
+#if HTTPS_SESSION_ENABLE
+static const HttpsSession_Cipher_T HttpsCiphers[] = { HTTPS_CIPHER_PREFERENCE };
+
+static const HttpsAgent_Setup_T HttpsAgentSetupInfo =
+        {
+                .ServerHost = DEST_SERVER_HOST,
+                .ServerPort = HTTP_SECURE_ENABLE ? DEST_SERVER_PORT_SECURE : DEST_SERVER_PORT,
+                .IsSecure = HTTP_SECURE_ENABLE,
+                .CaFileName = HTTPS_CA_FILE_NAME,
+                .Ciphers = HttpsCiphers,
+                .CipherCount = (uint8_t) (sizeof(HttpsCiphers) / sizeof(HttpsCiphers[0])),
+                .MaxIdleMs = HTTPS_SESSION_MAX_IDLE_MS,
+                .TimeoutMs = APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT,
+#if DNS_CACHE_ENABLE
+                .Resolve = DnsAgent_Resolve,
+#endif /* DNS_CACHE_ENABLE */
+        };/**< HTTPS agent setup parameters */
+
+static HttpsSession_Request_T HttpsPostRequest =
+        {
+                .Method = "POST",
+                .Path = DEST_POST_PATH,
+                .ContentType = APP_POST_CONTENT_TYPE,
+                .ExtraHeaders = NULL,
+                .Body = NULL, /* Written by AppControllerWriteBody */
+                .BodyLength = 0UL,
+        };/**< POST through the HTTPS agent */
+
+static HttpsSession_Response_T HttpsPostResponse =
+        {
+                .Body = NULL,
+                .BodySize = 0UL,
+        };/**< Status of the last POST, the body is discarded */
+
+static SensorTable_Value_T PostValues[SENSOR_TABLE_CHANNEL_COUNT]; /**< Values of the next POST, encoded straight into the buffer of the HTTPS session */
+#endif /* HTTPS_SESSION_ENABLE */
+
+#if POST_SCHEMA_ENABLE
+static SensorSchema_T PostSchema; /**< Channels of the POST body and whether the server knows them */
+#endif /* POST_SCHEMA_ENABLE */
 
 
 static xTaskHandle AppControllerHandle = NULL; /**< OS thread handle for Application controller */
 
+STATIC_RTOS_TASK(AppControllerStorage, TASK_STACK_SIZE_APP_CONTROLLER);
+
 static CmdProcessor_T * AppCmdProcessor; /**< Handle to store the main Command processor handle to be reused by ServalPAL thread */
 
 /* local functions ********************************************************** */
 
+#if HTTPS_SESSION_ENABLE
+/**
+ * @brief Writes the POST body of PostValues, see HttpsSession_Request_T.
+ */
+static bool AppControllerWriteBody(void * context, PayloadWriter_T * writer)
+{
+#if POST_SCHEMA_ENABLE
+    return SensorSchema_WriteMessage(&PostSchema, (const SensorTable_Value_T *) context, writer);
+#else
+    return SensorTable_WriteJson((const SensorTable_Value_T *) context, SensorComponent_GetEnabledChannels(), writer);
+#endif /* POST_SCHEMA_ENABLE */
+}
+#endif /* HTTPS_SESSION_ENABLE */
+
 /**
  * @brief This will validate the WLAN network connectivity
  *
@@ -111,6 +227,10 @@ static Retcode_T AppControllerValidateWLANConnectivity(void)
 
     if (WLANNWCT_IPSTATUS_CT_AQRD != nwStatus)
     {
+#if HTTPS_SESSION_ENABLE
+        /* The socket did not survive the disconnection */
+        HttpsAgent_Close();
+#endif /* HTTPS_SESSION_ENABLE */
 #if HTTP_SECURE_ENABLE
         static bool isSntpDisabled = false;
         if (false == isSntpDisabled)
@@ -152,6 +272,12 @@ static void AppControllerFire(void* pvParameters)
     BCDS_UNUSED(pvParameters);
 
     Retcode_T retcode = RETCODE_OK;
+#if HTTPS_SESSION_ENABLE
+    uint32_t posts = 0UL;
+#endif /* HTTPS_SESSION_ENABLE */
+#if (POST_SCHEMA_ENABLE && !HTTPS_SESSION_ENABLE)
+    PayloadWriter_T writer;
+#endif /* POST_SCHEMA_ENABLE && !HTTPS_SESSION_ENABLE */
 
 #if HTTP_SECURE_ENABLE
 
@@ -161,6 +287,14 @@ static void AppControllerFire(void* pvParameters)
      * Since there is no point in doing a HTTPS communication without a valid time */
     do
     {
+#if DNS_CACHE_ENABLE
+        /* The SNTP module resolves the server itself, its cached address needs no DNS request */
+        uint32_t sntpServerAddress;
+        if (RETCODE_OK == DnsAgent_Resolve(SNTP_SERVER_URL, &sntpServerAddress))
+        {
+            DnsCache_FormatAddress(sntpServerAddress, SntpServerUrl);
+        }
+#endif /* DNS_CACHE_ENABLE */
         retcode = SNTP_GetTimeFromServer(&sntpTimeStampFromServer, APP_RESPONSE_FROM_SNTP_SERVER_TIMEOUT);
         if ((RETCODE_OK != retcode) || (0UL == sntpTimeStampFromServer))
         {
@@ -179,10 +313,69 @@ static void AppControllerFire(void* pvParameters)
         /* Check whether the WLAN network connection is available */
         retcode = AppControllerValidateWLANConnectivity();
 
+        /* Post the latest values of the enabled sensors */
+#if HTTPS_SESSION_ENABLE
+        if (RETCODE_OK == retcode)
+        {
+            /* Both passes of the body writer have to see the same values */
+            taskENTER_CRITICAL();
+            memcpy(PostValues, SensorValues, sizeof(PostValues));
+            taskEXIT_CRITICAL();
+            HttpsPostRequest.WriteBody = AppControllerWriteBody;
+            HttpsPostRequest.BodyContext = PostValues;
+        }
+#else
+        if (RETCODE_OK == retcode)
+        {
+#if POST_SCHEMA_ENABLE
+            PayloadWriter_Init(&writer, (uint8_t *) PostRequestBody, sizeof(PostRequestBody), 0UL, NULL, NULL);
+            (void) SensorSchema_WriteMessage(&PostSchema, SensorValues, &writer);
+            HTTPRestClientPostInfo.PayloadLength = PayloadWriter_Finish(&writer) ? writer.Length : 0UL;
+#else
+            HTTPRestClientPostInfo.PayloadLength = SensorTable_ToJson(SensorValues, SensorComponent_GetEnabledChannels(),
+                    PostRequestBody, sizeof(PostRequestBody));
+#endif /* POST_SCHEMA_ENABLE */
+            if (0UL == HTTPRestClientPostInfo.PayloadLength)
+            {
+                retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+            }
+        }
+#endif /* HTTPS_SESSION_ENABLE */
+
         /* Do a HTTP rest client POST */
         if (RETCODE_OK == retcode)
         {
+#if HTTPS_SESSION_ENABLE
+            retcode = HttpsAgent_Request(&HttpsPostRequest, &HttpsPostResponse);
+#if POST_SCHEMA_ENABLE
+            if (SensorSchema_HandleStatus(&PostSchema, HttpsPostResponse.Status))
+            {
+                /* The server lost the schema, e.g. in a restart: the same values once more, the schema attached */
+                retcode = HttpsAgent_Request(&HttpsPostRequest, &HttpsPostResponse);
+                (void) SensorSchema_HandleStatus(&PostSchema, HttpsPostResponse.Status);
+            }
+#endif /* POST_SCHEMA_ENABLE */
+            if (0UL == (++posts % APP_HTTPS_REPORT_INTERVAL))
+            {
+                HttpsAgent_PrintReport();
+#if DNS_CACHE_ENABLE
+                DnsAgent_PrintReport();
+#endif /* DNS_CACHE_ENABLE */
+            }
+#else
             retcode = HTTPRestClient_Post(&HTTPRestClientConfigInfo, &HTTPRestClientPostInfo, APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT);
+#if POST_SCHEMA_ENABLE
+            /* The rest client hides the status: after a failed post the schema goes with the next one */
+            if (RETCODE_OK == retcode)
+            {
+                (void) SensorSchema_HandleStatus(&PostSchema, UINT16_C(200));
+            }
+            else
+            {
+                SensorSchema_Reset(&PostSchema);
+            }
+#endif /* POST_SCHEMA_ENABLE */
+#endif /* HTTPS_SESSION_ENABLE */
         }
         if (RETCODE_OK == retcode)
         {
@@ -201,6 +394,7 @@ static void AppControllerFire(void* pvParameters)
 
 /**
  * @brief To enable the necessary modules for the application
+ * - Sensors
  * - WLAN
  * - ServalPAL
  * - SNTP (if HTTPS)
@@ -211,24 +405,43 @@ static void AppControllerEnable(void * param1, uint32_t param2)
     BCDS_UNUSED(param1);
     BCDS_UNUSED(param2);
 
-    Retcode_T retcode = WLAN_Enable();
+    Retcode_T retcode = SensorComponent_Enable();
+#if POST_SCHEMA_ENABLE
+    if ((RETCODE_OK == retcode) && !SensorSchema_Init(&PostSchema, SensorComponent_GetEnabledChannels()))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+#endif /* POST_SCHEMA_ENABLE */
+    if (RETCODE_OK == retcode)
+    {
+        retcode = WLAN_Enable();
+    }
     if (RETCODE_OK == retcode)
     {
         retcode = ServalPAL_Enable();
     }
+#if DNS_CACHE_ENABLE
+    if (RETCODE_OK == retcode)
+    {
+        retcode = DnsAgent_Enable();
+    }
+#endif /* DNS_CACHE_ENABLE */
 #if HTTP_SECURE_ENABLE
     if (RETCODE_OK == retcode)
     {
         retcode = SNTP_Enable();
     }
 #endif /* HTTP_SECURE_ENABLE */
+#if !HTTPS_SESSION_ENABLE
     if (RETCODE_OK == retcode)
     {
         retcode = HTTPRestClient_Enable();
     }
+#endif /* !HTTPS_SESSION_ENABLE */
     if (RETCODE_OK == retcode)
     {
-        if (pdPASS != xTaskCreate(AppControllerFire, (const char * const ) "AppController", TASK_STACK_SIZE_APP_CONTROLLER, NULL, TASK_PRIO_APP_CONTROLLER, &AppControllerHandle))
+        AppControllerHandle = StaticRtos_CreateTask(&AppControllerStorage, AppControllerFire, "AppController", NULL, TASK_PRIO_APP_CONTROLLER);
+        if (NULL == AppControllerHandle)
         {
             retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
         }
@@ -240,11 +453,17 @@ static void AppControllerEnable(void * param1, uint32_t param2)
         assert(0); /* To provide LED indication for the user */
     }
 
+    StaticRtos_PrintReport();
+    WorkDispatcher_PrintReport();
+#if DNS_CACHE_ENABLE
+    DnsAgent_PrintReport();
+#endif /* DNS_CACHE_ENABLE */
     Utils_PrintResetCause();
 }
 
 /**
  * @brief To setup the necessary modules for the application
+ * - Sensors
  * - WLAN
  * - ServalPAL
  * - SNTP (if HTTPS)
@@ -261,24 +480,47 @@ static void AppControllerSetup(void * param1, uint32_t param2)
     BCDS_UNUSED(param1);
     BCDS_UNUSED(param2);
 
-    Retcode_T retcode = WLAN_Setup(&WLANSetupInfo);
+    Retcode_T retcode = SensorComponent_Init();
+    if (RETCODE_OK == retcode)
+    {
+        retcode = SensorComponent_Setup(SensorValues);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = WLAN_Setup(&WLANSetupInfo);
+    }
     if (RETCODE_OK == retcode)
     {
         retcode = ServalPAL_Setup(AppCmdProcessor);
     }
+#if DNS_CACHE_ENABLE
+    if (RETCODE_OK == retcode)
+    {
+        retcode = DnsAgent_Setup(&DnsAgentSetupInfo);
+    }
+#endif /* DNS_CACHE_ENABLE */
 #if HTTP_SECURE_ENABLE
     if (RETCODE_OK == retcode)
     {
         retcode = SNTP_Setup(&SNTPSetupInfo);
     }
 #endif /* HTTP_SECURE_ENABLE */
+#if HTTPS_SESSION_ENABLE
+    BCDS_UNUSED(HTTPRestClientSetupInfo);
+    BCDS_UNUSED(HTTPRestClientConfigInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = HttpsAgent_Setup(&HttpsAgentSetupInfo);
+    }
+#else
     if (RETCODE_OK == retcode)
     {
         retcode = HTTPRestClient_Setup(&HTTPRestClientSetupInfo);
     }
+#endif /* HTTPS_SESSION_ENABLE */
     if (RETCODE_OK == retcode)
     {
-        retcode = CmdProcessor_Enqueue(AppCmdProcessor, AppControllerEnable, NULL, UINT32_C(0));
+        retcode = WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AppControllerEnable, NULL, UINT32_C(0));
     }
     if (RETCODE_OK != retcode)
     {
@@ -304,7 +546,7 @@ void AppController_Init(void * cmdProcessorHandle, uint32_t param2)
     else
     {
         AppCmdProcessor = (CmdProcessor_T *) cmdProcessorHandle;
-        retcode = CmdProcessor_Enqueue(AppCmdProcessor, AppControllerSetup, NULL, UINT32_C(0));
+        retcode = WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AppControllerSetup, NULL, UINT32_C(0));
     }
 
     if (RETCODE_OK != retcode)
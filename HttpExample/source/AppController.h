@@ -96,9 +96,23 @@
 #define DEST_POST_PATH                  "/~ex0eby/sendValuesToDatabase.php"
 
 /**
- * POST_REQUEST_BODY is sent as body with the HTTP POST request
+ * POST_REQUEST_BODY_SIZE is the size in bytes of the JSON body sent with the
+ * HTTP POST request. The body holds the latest values of the sensors enabled
+ * in SensorComponentConfig.h. Unused with HTTPS_SESSION_ENABLE, which writes
+ * the body straight into the buffer of the session. With POST_SCHEMA_ENABLE
+ * the largest body is the one announcing the schema, 7 bytes plus about 20
+ * per channel.
  */
-#define POST_REQUEST_BODY               "{\"acoustic\":\"3\"}"
+#define POST_REQUEST_BODY_SIZE          UINT32_C(256)
+
+/**
+ * POST_SCHEMA_ENABLE is set to post the values without their JSON keys, as a
+ * SensorSchema message: the channels are announced once with a hash, and the
+ * posts after that only carry the hash and the packed values, about a tenth
+ * of the JSON body. The server answers 409 to a hash it does not know (see
+ * Tools/SchemaBench for the decoder).
+ */
+#define POST_SCHEMA_ENABLE              UINT32_C(0)
 
 /**
  * The time we wait (in milliseconds) between sending HTTP requests.
@@ -126,6 +140,70 @@
 
 #endif /* #if HTTP_SECURE_ENABLE */
 
+/**
+ * HTTPS_SESSION_ENABLE is set to post through HttpsAgent instead of the HTTP rest
+ * client. HttpsAgent keeps the connection open between posts, so only the first
+ * post and posts after the server closed the connection pay a TLS handshake.
+ */
+#define HTTPS_SESSION_ENABLE            UINT32_C(0)
+
+/**
+ * HTTPS_SESSION_MAX_IDLE_MS is the idle time after which a new connection is
+ * opened instead of reusing the last one. It has to stay below the keep-alive
+ * timeout of the server (KeepAliveTimeout of Apache, 5 s by default), or a post
+ * goes out on a connection the server already closed and is sent twice.
+ * With a stock server and INTER_REQUEST_INTERVAL every post connects anew:
+ * keep-alive only saves handshakes once KeepAliveTimeout of the server is
+ * raised above INTER_REQUEST_INTERVAL and this limit between the two, e.g.
+ * 15000 for a KeepAliveTimeout of 20 s.
+ */
+#define HTTPS_SESSION_MAX_IDLE_MS       UINT32_C(4000)
+
+/**
+ * HTTPS_CA_FILE_NAME is the CA certificate of the server in the file system of
+ * the WLAN chip (DER), uploaded once e.g. with WLANHostPgm. NULL skips the
+ * verification of the server, for tests only.
+ */
+#define HTTPS_CA_FILE_NAME              "/cert/server_ca.der"
+
+/**
+ * HTTPS_CIPHER_PREFERENCE lists the offered TLS cipher suites, most preferred
+ * first. ECDHE-ECDSA with an ECDSA P-256 server certificate is the cheapest
+ * handshake; the ECDHE-RSA suites remain for servers with an RSA certificate.
+ * Tools/TlsHandshakeBench measures a server with a given list.
+ */
+#define HTTPS_CIPHER_PREFERENCE         HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA
+
+/**
+ * DNS_CACHE_ENABLE is set to resolve the servers through DnsAgent. The servers
+ * are resolved once the WLAN is connected and again in the background before
+ * their DNS records expire, so a new connection or SNTP request does not wait
+ * for the DNS server, and still gets the last address when the DNS server is
+ * down. The HTTP rest client resolves DEST_SERVER_HOST itself, the cache
+ * serves the uploads with HTTPS_SESSION_ENABLE only.
+ */
+#define DNS_CACHE_ENABLE                UINT32_C(0)
+
+/**
+ * DEST_SERVER_FALLBACK_ADDRESS and SNTP_SERVER_FALLBACK_ADDRESS are dotted IPv4
+ * addresses used while the server cannot be resolved and no address of an
+ * earlier run is stored in DNS_CACHE_FILE_NAME, "" for none.
+ */
+#define DEST_SERVER_FALLBACK_ADDRESS    ""
+#define SNTP_SERVER_FALLBACK_ADDRESS    ""
+
+/**
+ * DNS_CACHE_FILE_NAME is the file of the WLAN chip keeping the last good
+ * address of every server across restarts. It is only written when an address
+ * changed.
+ */
+#define DNS_CACHE_FILE_NAME             "/usr/dnscache.bin"
+
 /**
  * The maximum amount of data we download in a single request (in bytes). This number is
  * limited by the platform abstraction layer implementation that ships with the
@@ -50,6 +50,7 @@
 #include "BCDS_Assert.h"
 #include "AppController.h"
 #include "BCDS_CmdProcessor.h"
+#include "WorkDispatcher.h"
 #include "FreeRTOS.h"
 #include "task.h"
 /* own header files */
@@ -72,6 +73,11 @@ int main(void)
         retcode = CmdProcessor_Initialize(&MainCmdProcessor, (char *) "MainCmdProcessor", TASK_PRIO_MAIN_CMD_PROCESSOR, TASK_STACK_SIZE_MAIN_CMD_PROCESSOR, TASK_Q_LEN_MAIN_CMD_PROCESSOR);
     }
     if (RETCODE_OK == retcode)
+    {
+        /* The application work runs on the dispatcher lanes, the command processor keeps the ServalPAL callbacks */
+        retcode = WorkDispatcher_Initialize();
+    }
+    if (RETCODE_OK == retcode)
     {
         /* Here we enqueue the application initialization into the command
          * processor, such that the initialization function will be invoked
@@ -0,0 +1,25 @@
+/**
+ *  @file
+ *
+ *  @brief Sensors of HttpExample, see SensorComponent.h. Only the sensors
+ *  whose values are posted are compiled in.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORCOMPONENTCONFIG_H_
+#define SENSORCOMPONENTCONFIG_H_
+
+/* local type and macro definitions */
+
+#define SENSOR_COMPONENT_ENABLE_ACCELEROMETER       0
+#define SENSOR_COMPONENT_ENABLE_GYROSCOPE           0
+#define SENSOR_COMPONENT_ENABLE_MAGNETOMETER        0
+#define SENSOR_COMPONENT_ENABLE_ENVIRONMENTAL       1
+#define SENSOR_COMPONENT_ENABLE_LIGHT               1
+#define SENSOR_COMPONENT_ENABLE_ACOUSTIC            0
+
+/** Print the channels of a sensor after every read */
+#define SENSOR_COMPONENT_PRINT_ENABLE               0
+
+#endif /* SENSORCOMPONENTCONFIG_H_ */
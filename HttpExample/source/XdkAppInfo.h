@@ -56,11 +56,35 @@
 /**< Main command processor task queue length */
 #define TASK_Q_LEN_MAIN_CMD_PROCESSOR               (UINT32_C(10))
 
+/**< Work dispatcher real-time lane (sensor acquisition) task priority */
+#define TASK_PRIO_DISPATCHER_REALTIME               (UINT32_C(4))
+/**< Work dispatcher real-time lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_REALTIME         (UINT32_C(400))
+/**< Work dispatcher real-time lane queue length */
+#define TASK_Q_LEN_DISPATCHER_REALTIME              (UINT32_C(16))
+
+/**< Work dispatcher normal lane (setup, enable, encoding) task priority */
+#define TASK_PRIO_DISPATCHER_NORMAL                 (UINT32_C(2))
+/**< Work dispatcher normal lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_NORMAL           (UINT32_C(1600))
+/**< Work dispatcher normal lane queue length */
+#define TASK_Q_LEN_DISPATCHER_NORMAL                (UINT32_C(8))
+
+/**< Work dispatcher background lane (logging, storage) task priority */
+#define TASK_PRIO_DISPATCHER_BACKGROUND             (UINT32_C(1))
+/**< Work dispatcher background lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_BACKGROUND       (UINT32_C(300))
+/**< Work dispatcher background lane queue length */
+#define TASK_Q_LEN_DISPATCHER_BACKGROUND            (UINT32_C(4))
+
 /**< Application controller task priority */
 #define TASK_PRIO_APP_CONTROLLER                    (UINT32_C(3))
 /**< Application controller task stack size */
 #define TASK_STACK_SIZE_APP_CONTROLLER              (UINT32_C(1000))
 
+/**< 1: tasks, timers and semaphores of the application use static storage instead of the heap, see StaticRtos.h */
+#define APP_STATIC_ALLOCATION_ENABLE                (UINT32_C(0))
+
 /**
  * @brief BCDS_APP_MODULE_ID for Application C module of XDK
  * @info  usage:
@@ -71,6 +95,11 @@ enum XDK_App_ModuleID_E
 {
     XDK_APP_MODULE_ID_MAIN = XDK_COMMON_ID_OVERFLOW,
     XDK_APP_MODULE_ID_APP_CONTROLLER,
+    XDK_APP_MODULE_ID_SENSOR_COMPONENT,
+    XDK_APP_MODULE_ID_STATIC_RTOS,
+    XDK_APP_MODULE_ID_WORK_DISPATCHER,
+    XDK_APP_MODULE_ID_HTTPS_AGENT,
+    XDK_APP_MODULE_ID_DNS_AGENT,
 
 /* Define next module ID here */
 };
@@ -0,0 +1,386 @@
+/* --------------------------------------------------------------------------- |
+ * INCLUDES & DEFINES ******************************************************** |
+ * -------------------------------------------------------------------------- */
+#include "XdkAppInfo.h"
+#undef BCDS_MODULE_ID  // [i] Module ID define before including Basics package
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_APP_CONTROLLER
+
+#include <stdio.h>
+#include "BCDS_CmdProcessor.h"
+#include "FreeRTOS.h"
+#include "timers.h"
+#include "XdkSensorHandle.h"
+
+#include "CycleBench.h"
+#include "DecimationFilter.h"
+#include "LoRaPayload.h"
+#include "SensorComponent.h"
+#include "SensorSnapshot.h"
+#include "SensorTrace.h"
+#include "ThermalFrame.h"
+#include "TimeSeriesCompressor.h"
+#include "WorkDispatcher.h"
+#include "StaticRtos.h"
+
+#define BENCH_SENSOR_ITERATIONS         UINT32_C(2000) /**< Calls per driver case */
+#define BENCH_ENCODER_ITERATIONS        UINT32_C(2000) /**< Calls per encoder case */
+#define BENCH_JSON_SIZE                 UINT32_C(512) /**< APP_PAYLOAD_BUFFER_SIZE of XDK110_Dashboard */
+#define BENCH_BATCH_SIZE                UINT32_C(512) /**< APP_SAMPLE_BATCH_SIZE of XDK110_Dashboard */
+#define BENCH_TRACE_CHUNK_SIZE          UINT32_C(512) /**< SENSOR_TRACE_AGENT_CHUNK_SIZE of XDK110_Dashboard */
+#define BENCH_ACOUSTIC_SAMPLES          UINT32_C(10) /**< Samples per RMS value, as SensorComponent reads */
+#define BENCH_DECIMATION_BLOCK          UINT32_C(20) /**< DECIMATION_BLOCK_LENGTH of XDK110_Dashboard */
+#define BENCH_THERMAL_DEADBAND          UINT8_C(2) /**< THERMAL_DEADBAND of XDK110_Dashboard */
+#define BENCH_THERMAL_SPOT              INT16_C(32) /**< A person 8 degC above the room */
+
+/* --------------------------------------------------------------------------- |
+ * VARIABLES ***************************************************************** |
+ * -------------------------------------------------------------------------- */
+
+static CalibratedAccel_XyzMps2Data_T BenchAccelerometer;
+static Gyroscope_XyzData_T BenchGyroscope;
+static Magnetometer_XyzData_T BenchMagnetometer;
+static Environmental_Data_T BenchEnvironmental;
+static uint32_t BenchLight;
+static float BenchAcoustic;
+
+static SensorSnapshot_T BenchSnapshot; /**< Encoder input, filled from the last driver reads */
+
+static char BenchJson[BENCH_JSON_SIZE];
+static uint8_t BenchBatchBuffer[BENCH_BATCH_SIZE];
+static TimeSeriesCompressor_T BenchBatch;
+static uint8_t BenchTraceChunk[BENCH_TRACE_CHUNK_SIZE];
+static SensorTrace_Writer_T BenchTraceWriter;
+static uint8_t BenchLoRaPayload[LORA_PAYLOAD_MAX_SIZE];
+
+/** Filter of APP_DECIMATION_ENABLE in XDK110_Dashboard: 100 Hz reads in mm/s2 to 10 Hz and 1 Hz */
+static const DecimationFilter_Setup_T BenchDecimationSetup =
+        {
+                .InputBits = UINT8_C(19),
+                .Stages = UINT8_C(2),
+                .Stage = { { 5U, 2U, 15U, 40U }, { 5U, 2U, 15U, 40U } },
+        };
+static DecimationFilter_Bank_T BenchDecimationBank;
+static DecimationFilter_Channel_T BenchDecimationChannel;
+static int32_t BenchDecimationInput[BENCH_DECIMATION_BLOCK];
+static int32_t BenchDecimationOutputs[2][DECIMATION_FILTER_OUTPUT_LENGTH(BENCH_DECIMATION_BLOCK, 10UL)];
+
+static ThermalFrame_Encoder_T BenchThermalEncoder;
+static ThermalFrame_T BenchThermalFrame;
+static uint8_t BenchThermalMessage[THERMAL_FRAME_MAX_MESSAGE];
+
+/* --------------------------------------------------------------------------- |
+ * BENCHMARK CASES *********************************************************** |
+ * -------------------------------------------------------------------------- */
+
+static Retcode_T BenchAccelerometerRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return CalibratedAccel_readXyzMps2Value(&BenchAccelerometer);
+}
+
+static Retcode_T BenchGyroscopeRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return Gyroscope_readXyzDegreeValue(xdkGyroscope_BMG160_Handle, &BenchGyroscope);
+}
+
+static Retcode_T BenchMagnetometerRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return Magnetometer_readXyzTeslaData(xdkMagnetometer_BMM150_Handle, &BenchMagnetometer);
+}
+
+static Retcode_T BenchEnvironmentalRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return Environmental_readData(xdkEnvironmental_BME280_Handle, &BenchEnvironmental);
+}
+
+static Retcode_T BenchLightRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return LightSensor_readLuxData(xdkLightSensor_MAX44009_Handle, &BenchLight);
+}
+
+static Retcode_T BenchAcousticRead(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return NoiseSensor_ReadRmsValue(&BenchAcoustic, BENCH_ACOUSTIC_SAMPLES);
+}
+
+static Retcode_T BenchTableJson(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return (0UL != SensorTable_ToJson(BenchSnapshot.Values, SENSOR_TABLE_ALL_CHANNELS, BenchJson, sizeof(BenchJson))) ?
+            RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+}
+
+static Retcode_T BenchSnapshotJson(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return (0UL != SensorSnapshot_ToJson(&BenchSnapshot, BenchJson, sizeof(BenchJson))) ?
+            RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+}
+
+/**
+ * @brief Appends a 1 Hz sample with a changing temperature; a full batch starts over,
+ * the restart is part of the timed call as on the device.
+ */
+static Retcode_T BenchCompressorAppend(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_TEMPERATURE].Int += (int32_t) (iteration & 3UL) - 1;
+    if (!TimeSeriesCompressor_Append(&BenchBatch, iteration * 1000UL, &BenchSnapshot.Values[0].Bits))
+    {
+        (void) TimeSeriesCompressor_Init(&BenchBatch, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK,
+                BenchBatchBuffer, sizeof(BenchBatchBuffer));
+        if (!TimeSeriesCompressor_Append(&BenchBatch, iteration * 1000UL, &BenchSnapshot.Values[0].Bits))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return RETCODE_OK;
+}
+
+static Retcode_T BenchLoRaEncode(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(iteration);
+
+    return (0U != LoRaPayload_Encode((LoRaPayload_Format_T) (uintptr_t) context, &BenchSnapshot, LORA_PAYLOAD_ALL_ITEMS,
+            BenchLoRaPayload, sizeof(BenchLoRaPayload))) ? RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+}
+
+/**
+ * @brief Records an environmental read with a changing temperature; a full chunk starts over.
+ */
+static Retcode_T BenchTraceAppend(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+
+    SensorTrace_Record_T record;
+
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_TEMPERATURE].Int += (int32_t) (iteration & 3UL) - 1;
+    record.TimestampMs = iteration * 1000UL;
+    record.Sensor = (uint8_t) SENSOR_TABLE_SENSOR_ENVIRONMENTAL;
+    record.Retcode = 0UL;
+    record.Values[SENSOR_TABLE_CHANNEL_HUMIDITY] = BenchSnapshot.Values[SENSOR_SNAPSHOT_HUMIDITY];
+    record.Values[SENSOR_TABLE_CHANNEL_PRESSURE] = BenchSnapshot.Values[SENSOR_SNAPSHOT_PRESSURE];
+    record.Values[SENSOR_TABLE_CHANNEL_TEMPERATURE] = BenchSnapshot.Values[SENSOR_SNAPSHOT_TEMPERATURE];
+    if (!SensorTrace_Append(&BenchTraceWriter, &record))
+    {
+        (void) SensorTrace_InitWriter(&BenchTraceWriter, BenchTraceChunk, sizeof(BenchTraceChunk));
+        if (!SensorTrace_Append(&BenchTraceWriter, &record))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return RETCODE_OK;
+}
+
+/**
+ * @brief Filters one block of accelerometer reads; cycles per input sample are the cycles of the case over BENCH_DECIMATION_BLOCK.
+ */
+static Retcode_T BenchDecimationProcess(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+
+    int32_t * outputs[DECIMATION_FILTER_MAX_STAGES] = { BenchDecimationOutputs[0], BenchDecimationOutputs[1], NULL };
+    uint32_t counts[DECIMATION_FILTER_MAX_STAGES];
+
+    BenchDecimationInput[iteration % BENCH_DECIMATION_BLOCK] += (int32_t) (iteration & 7UL) - 3;
+    return DecimationFilter_Process(&BenchDecimationChannel, BenchDecimationInput, BENCH_DECIMATION_BLOCK, outputs, counts) ?
+            RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+}
+
+/**
+ * @brief Encodes a frame of a warm spot which moves one pixel per call, a delta frame of 2 pixels.
+ */
+static Retcode_T BenchThermalEncode(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+
+    uint8_t spot = (uint8_t) (iteration % THERMAL_FRAME_PIXELS);
+
+    BenchThermalFrame.Pixels[(spot + THERMAL_FRAME_PIXELS - 1U) % THERMAL_FRAME_PIXELS] -= BENCH_THERMAL_SPOT;
+    BenchThermalFrame.Pixels[spot] += BENCH_THERMAL_SPOT;
+    return (0UL != ThermalFrame_Encode(&BenchThermalEncoder, &BenchThermalFrame, UINT16_C(1), BenchThermalMessage, sizeof(BenchThermalMessage))) ?
+            RETCODE_OK : RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+}
+
+/**
+ * Driver reads block on the I2C bus and run with the scheduler running; the
+ * encoders never block and run with the scheduler suspended, so their
+ * percentiles only show interrupts.
+ */
+static const CycleBench_Case_T BenchSensorCases[] =
+        {
+                { "CalibratedAccel_readXyzMps2Value", BenchAccelerometerRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+                { "Gyroscope_readXyzDegreeValue", BenchGyroscopeRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+                { "Magnetometer_readXyzTeslaData", BenchMagnetometerRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+                { "Environmental_readData", BenchEnvironmentalRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+                { "LightSensor_readLuxData", BenchLightRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+                { "NoiseSensor_ReadRmsValue", BenchAcousticRead, NULL, BENCH_SENSOR_ITERATIONS, false },
+        };
+
+static const CycleBench_Case_T BenchEncoderCases[] =
+        {
+                { "SensorTable_ToJson", BenchTableJson, NULL, BENCH_ENCODER_ITERATIONS, true },
+                { "SensorSnapshot_ToJson", BenchSnapshotJson, NULL, BENCH_ENCODER_ITERATIONS, true },
+                { "TimeSeriesCompressor_Append", BenchCompressorAppend, NULL, BENCH_ENCODER_ITERATIONS, true },
+                { "LoRaPayload_Encode_Lpp", BenchLoRaEncode, (void *) (uintptr_t) LORA_PAYLOAD_FORMAT_CAYENNE_LPP, BENCH_ENCODER_ITERATIONS, true },
+                { "LoRaPayload_Encode_BitPacked", BenchLoRaEncode, (void *) (uintptr_t) LORA_PAYLOAD_FORMAT_BIT_PACKED, BENCH_ENCODER_ITERATIONS, true },
+                { "SensorTrace_Append", BenchTraceAppend, NULL, BENCH_ENCODER_ITERATIONS, true },
+                { "DecimationFilter_Process_20", BenchDecimationProcess, NULL, BENCH_ENCODER_ITERATIONS, true },
+                { "ThermalFrame_Encode", BenchThermalEncode, NULL, BENCH_ENCODER_ITERATIONS, true },
+        };
+
+/* --------------------------------------------------------------------------- |
+ * BOOTING- AND SETUP FUNCTIONS ********************************************** |
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @brief Gives the encoders the values of the last driver reads, converted as SensorComponent does.
+ */
+static void AppControllerFillSnapshot(void)
+{
+    BenchSnapshot.TimestampMs = 0UL;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = BenchAccelerometer.xAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = BenchAccelerometer.yAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = BenchAccelerometer.zAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = BenchAcoustic;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) BenchLight;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = BenchGyroscope.xAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = BenchGyroscope.yAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = BenchGyroscope.zAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) BenchEnvironmental.humidity;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = BenchMagnetometer.xAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = BenchMagnetometer.yAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = BenchMagnetometer.zAxisData;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) BenchEnvironmental.pressure;
+    BenchSnapshot.Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) BenchEnvironmental.temperature;
+}
+
+/**
+ * @brief Designs the filter of the decimation case and fills its block with the last accelerometer read.
+ */
+static void AppControllerFillDecimation(void)
+{
+    uint32_t index;
+
+    (void) DecimationFilter_Design(&BenchDecimationBank, &BenchDecimationSetup);
+    (void) DecimationFilter_Reset(&BenchDecimationChannel, &BenchDecimationBank, (int32_t) (BenchAccelerometer.zAxisData * 1000.0f));
+    for (index = 0UL; index < BENCH_DECIMATION_BLOCK; index++)
+    {
+        BenchDecimationInput[index] = (int32_t) (BenchAccelerometer.zAxisData * 1000.0f);
+    }
+}
+
+/**
+ * @brief Fills the frame of the thermal case with the room temperature of the last environmental read, the spot on the last pixel.
+ */
+static void AppControllerFillThermal(void)
+{
+    uint8_t index;
+
+    (void) ThermalFrame_InitEncoder(&BenchThermalEncoder, BENCH_THERMAL_DEADBAND, UINT16_C(0));
+    for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+    {
+        BenchThermalFrame.Pixels[index] = (int16_t) (((int32_t) BenchEnvironmental.temperature * 4L) / 1000L);
+    }
+    BenchThermalFrame.Pixels[THERMAL_FRAME_PIXELS - 1U] += BENCH_THERMAL_SPOT;
+}
+
+static void AppControllerRunBench(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    Retcode_T retcode = CycleBench_Initialize();
+    uint32_t index;
+
+    if (RETCODE_OK != retcode)
+    {
+        printf("AppControllerRunBench : No cycle counter \r\n");
+        Retcode_RaiseError(retcode);
+        return;
+    }
+    (void) TimeSeriesCompressor_Init(&BenchBatch, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK,
+            BenchBatchBuffer, sizeof(BenchBatchBuffer));
+    (void) SensorTrace_InitWriter(&BenchTraceWriter, BenchTraceChunk, sizeof(BenchTraceChunk));
+
+    CycleBench_PrintHeader();
+    for (index = 0UL; index < (sizeof(BenchSensorCases) / sizeof(BenchSensorCases[0])); index++)
+    {
+        (void) CycleBench_Run(&BenchSensorCases[index], NULL);
+    }
+    AppControllerFillSnapshot();
+    AppControllerFillDecimation();
+    AppControllerFillThermal();
+    for (index = 0UL; index < (sizeof(BenchEncoderCases) / sizeof(BenchEncoderCases[0])); index++)
+    {
+        (void) CycleBench_Run(&BenchEncoderCases[index], NULL);
+    }
+    CycleBench_PrintFooter();
+    StaticRtos_PrintReport();
+    WorkDispatcher_PrintReport();
+}
+
+static void AppControllerSetup(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    // Initialization and configuration of the sensors, they are read by the benchmark only
+    Retcode_T retcode = SensorComponent_Init();
+
+    if (RETCODE_OK == retcode)
+    {
+        retcode = WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AppControllerRunBench, NULL, UINT32_C(0));
+    }
+
+    if (RETCODE_OK != retcode)
+    {
+        printf("AppControllerSetup : Failed \r\n");
+        Retcode_RaiseError(retcode);
+        assert(0);
+    }
+}
+
+void AppController_Init(void * cmdProcessorHandle, uint32_t param2)
+{
+    BCDS_UNUSED(param2);
+
+    Retcode_T retcode = RETCODE_OK;
+
+    if (cmdProcessorHandle == NULL)
+    {
+        printf("AppController_Init : Command processor handle is NULL \r\n");
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    else
+    {
+        retcode = WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AppControllerSetup, NULL, UINT32_C(0));
+    }
+    if (RETCODE_OK != retcode)
+    {
+        Retcode_RaiseError(retcode);
+        assert(0);
+    }
+}
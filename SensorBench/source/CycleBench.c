@@ -0,0 +1,189 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the cycle counter benchmark.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_CYCLE_BENCH
+
+#include "CycleBench.h"
+
+/* system header files */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* additional interface header files */
+#include "em_device.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* constant definitions ***************************************************** */
+
+#define CYCLE_BENCH_OVERHEAD_ITERATIONS     UINT32_C(64)
+
+/* local variables ********************************************************** */
+
+static uint32_t CycleBenchSamples[CYCLE_BENCH_MAX_ITERATIONS];
+
+static uint32_t CycleBenchOverhead = 0UL; /**< Cycles of timing an empty call */
+
+static bool CycleBenchIsInitialized = false;
+
+/* local functions ********************************************************** */
+
+static Retcode_T CycleBenchEmpty(void * context, uint32_t iteration)
+{
+    BCDS_UNUSED(context);
+    BCDS_UNUSED(iteration);
+
+    return RETCODE_OK;
+}
+
+static int CycleBenchCompare(const void * left, const void * right)
+{
+    uint32_t a = *(const uint32_t *) left;
+    uint32_t b = *(const uint32_t *) right;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Calls the function of a case Iterations times and keeps the cycles of every call.
+ *
+ * @return Failed calls.
+ */
+static uint32_t CycleBenchMeasure(const CycleBench_Case_T * benchCase)
+{
+    uint32_t failed = 0UL;
+    uint32_t iteration;
+    uint32_t start;
+    uint32_t cycles;
+    Retcode_T retcode;
+
+    if (benchCase->Isolated)
+    {
+        vTaskSuspendAll();
+    }
+    /* warm up, so caches of the drivers and lazy initializations are not timed */
+    (void) benchCase->Function(benchCase->Context, 0UL);
+    for (iteration = 0UL; iteration < benchCase->Iterations; iteration++)
+    {
+        start = DWT->CYCCNT;
+        retcode = benchCase->Function(benchCase->Context, iteration + 1UL);
+        cycles = DWT->CYCCNT - start;
+
+        CycleBenchSamples[iteration] = (cycles > CycleBenchOverhead) ? (cycles - CycleBenchOverhead) : 0UL;
+        if (RETCODE_OK != retcode)
+        {
+            failed++;
+        }
+    }
+    if (benchCase->Isolated)
+    {
+        (void) xTaskResumeAll();
+    }
+    return failed;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T CycleBench_Initialize(void)
+{
+    CycleBench_Case_T overheadCase = { "Overhead", CycleBenchEmpty, NULL, CYCLE_BENCH_OVERHEAD_ITERATIONS, true };
+    uint32_t start;
+    uint32_t iteration;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0UL;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* a core without cycle counter leaves it at 0 */
+    start = DWT->CYCCNT;
+    for (iteration = 0UL; (iteration < CYCLE_BENCH_OVERHEAD_ITERATIONS) && (DWT->CYCCNT == start); iteration++)
+    {
+        __NOP();
+    }
+    if (DWT->CYCCNT == start)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+    }
+
+    /* the fastest empty call is what timing itself costs */
+    CycleBenchOverhead = 0UL;
+    (void) CycleBenchMeasure(&overheadCase);
+    CycleBenchOverhead = UINT32_MAX;
+    for (iteration = 0UL; iteration < CYCLE_BENCH_OVERHEAD_ITERATIONS; iteration++)
+    {
+        if (CycleBenchSamples[iteration] < CycleBenchOverhead)
+        {
+            CycleBenchOverhead = CycleBenchSamples[iteration];
+        }
+    }
+    CycleBenchIsInitialized = true;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+void CycleBench_PrintHeader(void)
+{
+    printf("#CYCLEBENCH,%lu,%lu,%lu\r\n", (unsigned long) CYCLE_BENCH_VERSION, (unsigned long) SystemCoreClockGet(),
+            (unsigned long) CycleBenchOverhead);
+    printf("#name,iterations,failed,min,median,p99,max,mean\r\n");
+}
+
+/** Refer interface header for description */
+Retcode_T CycleBench_Run(const CycleBench_Case_T * benchCase, CycleBench_Result_T * result)
+{
+    CycleBench_Result_T caseResult;
+    uint64_t sum = 0ULL;
+    uint32_t iteration;
+
+    if ((NULL == benchCase) || (NULL == benchCase->Name) || (NULL == benchCase->Function))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0UL == benchCase->Iterations) || (benchCase->Iterations > CYCLE_BENCH_MAX_ITERATIONS))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    if (!CycleBenchIsInitialized)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+
+    caseResult.Iterations = benchCase->Iterations;
+    caseResult.Failed = CycleBenchMeasure(benchCase);
+    for (iteration = 0UL; iteration < benchCase->Iterations; iteration++)
+    {
+        sum += CycleBenchSamples[iteration];
+    }
+    qsort(CycleBenchSamples, benchCase->Iterations, sizeof(CycleBenchSamples[0]), CycleBenchCompare);
+    caseResult.Min = CycleBenchSamples[0];
+    caseResult.Median = CycleBenchSamples[benchCase->Iterations / 2UL];
+    caseResult.P99 = CycleBenchSamples[((benchCase->Iterations * 99UL) - 1UL) / 100UL];
+    caseResult.Max = CycleBenchSamples[benchCase->Iterations - 1UL];
+    caseResult.Mean = (uint32_t) (sum / benchCase->Iterations);
+
+    printf("BENCH,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu\r\n", benchCase->Name, (unsigned long) caseResult.Iterations,
+            (unsigned long) caseResult.Failed, (unsigned long) caseResult.Min, (unsigned long) caseResult.Median,
+            (unsigned long) caseResult.P99, (unsigned long) caseResult.Max, (unsigned long) caseResult.Mean);
+    if (NULL != result)
+    {
+        *result = caseResult;
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+void CycleBench_PrintFooter(void)
+{
+    printf("#END\r\n");
+}
@@ -0,0 +1,103 @@
+/**
+ *  @file
+ *
+ *  @brief Times function calls with the DWT cycle counter of the Cortex-M3.
+ *
+ *  A case is a function called a given number of times; every call is timed
+ *  on its own and the call overhead, measured once with an empty case, is
+ *  taken off. The report of a case is one line on the console:
+ *
+ *  BENCH,<name>,<iterations>,<failed>,<min>,<median>,<p99>,<max>,<mean>
+ *
+ *  all in core clock cycles. A run starts with "#CYCLEBENCH,<version>,<core
+ *  clock Hz>,<overhead>" and ends with "#END"; Tools/CycleBenchDiff compares
+ *  two console captures.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef CYCLEBENCH_H_
+#define CYCLEBENCH_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+/* local type and macro definitions */
+
+/** Most iterations of a case, the cycles of every call are kept for the percentiles */
+#define CYCLE_BENCH_MAX_ITERATIONS      UINT32_C(2000)
+
+#define CYCLE_BENCH_VERSION             UINT32_C(1)
+
+/**
+ * @brief Function under test.
+ *
+ * @param[in] context
+ * CycleBench_Case_T::Context
+ *
+ * @param[in] iteration
+ * Number of the call, 0 for the warm up call
+ *
+ * @return RETCODE_OK, or the error of the call, which is counted as failed.
+ */
+typedef Retcode_T (*CycleBench_Function_T)(void * context, uint32_t iteration);
+
+/**
+ * @brief One benchmark case.
+ */
+struct CycleBench_Case_S
+{
+    const char * Name; /**< No commas */
+    CycleBench_Function_T Function;
+    void * Context;
+    uint32_t Iterations; /**< 1 .. CYCLE_BENCH_MAX_ITERATIONS */
+    bool Isolated; /**< The scheduler is suspended during the case; only for functions which never block */
+};
+typedef struct CycleBench_Case_S CycleBench_Case_T;
+
+/**
+ * @brief Result of a case in cycles.
+ */
+struct CycleBench_Result_S
+{
+    uint32_t Iterations;
+    uint32_t Failed;
+    uint32_t Min;
+    uint32_t Median;
+    uint32_t P99;
+    uint32_t Max;
+    uint32_t Mean;
+};
+typedef struct CycleBench_Result_S CycleBench_Result_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the cycle counter and measures the call overhead.
+ *
+ * @return  RETCODE_OK on success, or an error code if the core has no cycle counter.
+ */
+Retcode_T CycleBench_Initialize(void);
+
+/**
+ * @brief Prints the first line of a run.
+ */
+void CycleBench_PrintHeader(void);
+
+/**
+ * @brief Runs a case and prints its line.
+ *
+ * @param[out] result
+ * Result of the case, may be NULL
+ *
+ * @return  RETCODE_OK on success, or an error code for an invalid case.
+ */
+Retcode_T CycleBench_Run(const CycleBench_Case_T * benchCase, CycleBench_Result_T * result);
+
+/**
+ * @brief Prints the last line of a run.
+ */
+void CycleBench_PrintFooter(void);
+
+#endif /* CYCLEBENCH_H_ */
@@ -0,0 +1,584 @@
+/**
+ *  @file
+ *
+ *  @brief Host run of the backlog upload of XDK110_Dashboard
+ *  (APP_SD_BACKLOG_UPLOAD_ENABLE).
+ *
+ *  The client posts an APP_SD_LOG_FILE_NAME log through the firmware
+ *  HttpsSession over plain TCP, the way the device posts the part of the log
+ *  not uploaded yet: chunked transfer encoding, the file read piece by piece
+ *  straight into the session buffer (PayloadWriter_ReserveBulk), so the RAM
+ *  used is the same for a log of one batch and for a log of a week. It prints
+ *  the body bytes, the chunks, the time and the throughput; --contiguous posts
+ *  the same file from one buffer with a Content-Length for comparison, as a
+ *  firmware staging the whole backlog would have to.
+ *
+ *  --server runs a local endpoint which decodes the body while it arrives,
+ *  batch by batch, and answers 400 unless every batch decodes and the body
+ *  ends on a batch boundary. It prints the samples and the bytes of each post.
+ *
+ *  --make-log writes a synthetic log: 1 Hz samples compressed in batches of
+ *  APP_SAMPLE_BATCH_SIZE bytes, each prefixed with its 16 bit length.
+ *
+ *  Usage: BacklogUpload [--contiguous] [--repeat n] [--path p] SAMPLES.TSC host port
+ *         BacklogUpload --server [--idle ms] port
+ *         BacklogUpload --make-log samples SAMPLES.TSC
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "HttpsSession.h"
+#include "SensorSnapshot.h"
+#include "TimeSeriesCompressor.h"
+
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* constant definitions ***************************************************** */
+
+#define BACKLOG_BATCH_SIZE          512U    /**< APP_SAMPLE_BATCH_SIZE of the firmware */
+#define BACKLOG_MAX_BATCH           65535U  /**< Largest length the 16 bit prefix allows */
+#define BACKLOG_TIMEOUT_MS          25000U  /**< APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT */
+#define BACKLOG_RECEIVE_SIZE        2048U
+
+/* local type definitions *************************************************** */
+
+/**
+ * @brief Incremental decoder of a log arriving in pieces.
+ */
+struct BacklogDecoder_S
+{
+    uint8_t Prefix[2];
+    uint32_t PrefixFill;
+    uint32_t BatchLength;
+    uint32_t BatchFill;
+    uint8_t Batch[BACKLOG_MAX_BATCH];
+    uint64_t Samples;
+    uint32_t Batches;
+    bool IsFailed;
+};
+typedef struct BacklogDecoder_S BacklogDecoder_T;
+
+/* local variables ********************************************************** */
+
+static int BacklogSocket = -1;
+
+static FILE * BacklogFile = NULL;
+
+static uint64_t BacklogBytesSent = 0U;
+
+/* local functions ********************************************************** */
+
+static uint32_t BacklogNowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((now.tv_sec * 1000L) + (now.tv_nsec / 1000000L));
+}
+
+static double BacklogNowS(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + ((double) now.tv_nsec / 1000000000.0);
+}
+
+static bool BacklogWrite(int socketHandle, const uint8_t * data, uint32_t length)
+{
+    ssize_t written;
+
+    while (0U != length)
+    {
+        written = send(socketHandle, data, length, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= (uint32_t) written;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the number of bytes received, 0 if the peer closed, negative on error or timeout.
+ */
+static int32_t BacklogRead(int socketHandle, uint8_t * buffer, uint32_t size, int timeoutMs)
+{
+    struct pollfd descriptor = { .fd = socketHandle, .events = POLLIN };
+
+    if (poll(&descriptor, 1, timeoutMs) <= 0)
+    {
+        return -1;
+    }
+    return (int32_t) recv(socketHandle, buffer, size, 0);
+}
+
+static bool BacklogResolve(void * context, const char * host, uint32_t * address)
+{
+    struct addrinfo hints;
+    struct addrinfo * result;
+
+    (void) context;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (0 != getaddrinfo(host, NULL, &hints, &result))
+    {
+        return false;
+    }
+    *address = ntohl(((struct sockaddr_in *) result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+static bool BacklogConnect(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount)
+{
+    struct sockaddr_in serverAddress;
+    int isNoDelay = 1;
+
+    (void) context;
+    (void) ciphers;
+    (void) cipherCount;
+    BacklogSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (BacklogSocket < 0)
+    {
+        return false;
+    }
+    (void) setsockopt(BacklogSocket, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(port);
+    serverAddress.sin_addr.s_addr = htonl(address);
+    return (0 == connect(BacklogSocket, (struct sockaddr *) &serverAddress, sizeof(serverAddress)));
+}
+
+static bool BacklogSend(void * context, const uint8_t * data, uint32_t length)
+{
+    (void) context;
+    BacklogBytesSent += length;
+    return BacklogWrite(BacklogSocket, data, length);
+}
+
+static int32_t BacklogReceive(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs)
+{
+    (void) context;
+    return BacklogRead(BacklogSocket, buffer, size, (int) timeoutMs);
+}
+
+static void BacklogClose(void * context)
+{
+    (void) context;
+    if (BacklogSocket >= 0)
+    {
+        close(BacklogSocket);
+        BacklogSocket = -1;
+    }
+}
+
+static const HttpsSession_Transport_T BacklogTransport =
+        {
+                .Context = NULL,
+                .Resolve = BacklogResolve,
+                .Connect = BacklogConnect,
+                .Handshake = NULL,
+                .Send = BacklogSend,
+                .Receive = BacklogReceive,
+                .Close = BacklogClose,
+                .NowMs = BacklogNowMs,
+        };
+
+/**
+ * @brief WriteBody of the post, reads the log into the session buffer like AppControllerWriteBacklog.
+ */
+static bool BacklogWriteBody(void * context, PayloadWriter_T * writer)
+{
+    char * room;
+    uint32_t length;
+    size_t bytesRead;
+
+    (void) context;
+    rewind(BacklogFile);
+    for (;;)
+    {
+        room = PayloadWriter_ReserveBulk(writer, &length);
+        if (NULL == room)
+        {
+            return false;
+        }
+        bytesRead = fread(room, 1U, length, BacklogFile);
+        if (0U == bytesRead)
+        {
+            return (0 == ferror(BacklogFile));
+        }
+        PayloadWriter_Commit(writer, (uint32_t) bytesRead);
+    }
+}
+
+static int BacklogPost(const char * path, const char * host, uint16_t port, const char * urlPath, bool isContiguous, uint32_t repeat)
+{
+    HttpsSession_Setup_T setup;
+    HttpsSession_Request_T request;
+    HttpsSession_Response_T response;
+    static HttpsSession_T session;
+    uint8_t responseBody[64];
+    uint8_t * contiguous = NULL;
+    long fileSize;
+    double startS;
+    double elapsedS;
+    uint32_t post;
+    int result = 0;
+
+    BacklogFile = fopen(path, "rb");
+    if (NULL == BacklogFile)
+    {
+        perror(path);
+        return 1;
+    }
+    fseek(BacklogFile, 0, SEEK_END);
+    fileSize = ftell(BacklogFile);
+    rewind(BacklogFile);
+
+    setup.Host = host;
+    setup.Port = port;
+    setup.Ciphers = NULL;
+    setup.CipherCount = 0U;
+    setup.MaxIdleMs = 0U;
+    setup.MaxRequestsPerConnection = 0U;
+    setup.TimeoutMs = BACKLOG_TIMEOUT_MS;
+    setup.Transport = &BacklogTransport;
+    if (!HttpsSession_Init(&session, &setup))
+    {
+        fclose(BacklogFile);
+        return 1;
+    }
+
+    request.Method = "POST";
+    request.Path = urlPath;
+    request.ContentType = "application/octet-stream";
+    request.ExtraHeaders = NULL;
+    request.Body = NULL;
+    request.BodyLength = 0U;
+    request.WriteBody = BacklogWriteBody;
+    request.BodyContext = NULL;
+    request.IsChunked = true;
+    if (isContiguous)
+    {
+        contiguous = malloc((size_t) fileSize + 1U);
+        if ((NULL == contiguous) || (fread(contiguous, 1U, (size_t) fileSize, BacklogFile) != (size_t) fileSize))
+        {
+            fclose(BacklogFile);
+            free(contiguous);
+            return 1;
+        }
+        request.Body = contiguous;
+        request.BodyLength = (uint32_t) fileSize;
+        request.WriteBody = NULL;
+        request.IsChunked = false;
+    }
+    response.Body = responseBody;
+    response.BodySize = sizeof(responseBody);
+
+    startS = BacklogNowS();
+    for (post = 0U; post < repeat; post++)
+    {
+        if (!HttpsSession_Request(&session, &request, &response) || (200U != response.Status))
+        {
+            fprintf(stderr, "post %u failed, status %u\n", post, (unsigned int) response.Status);
+            result = 1;
+            break;
+        }
+    }
+    elapsedS = BacklogNowS() - startS;
+    HttpsSession_Close(&session);
+
+    printf("%s: %ld bytes, %u posts %s, %.3f s, %.2f MB/s\n", path, fileSize, post,
+            isContiguous ? "with Content-Length from one buffer" : "chunked from the file", elapsedS,
+            ((double) fileSize * post) / (elapsedS * 1000000.0));
+    printf("Sent %llu bytes with framing, %u sends of the body, %u connections\n", (unsigned long long) BacklogBytesSent,
+            session.Statistics.BodyParts, session.Statistics.Connections);
+    printf("Body RAM: %ld bytes of staging buffer, %u bytes of session buffer, %u bytes of writer\n",
+            isContiguous ? fileSize : 0L, (unsigned int) HTTPS_SESSION_BUFFER_SIZE, isContiguous ? 0U : (unsigned int) sizeof(PayloadWriter_T));
+    fclose(BacklogFile);
+    free(contiguous);
+    return result;
+}
+
+static void BacklogResetDecoder(BacklogDecoder_T * decoder)
+{
+    decoder->PrefixFill = 0U;
+    decoder->Samples = 0U;
+    decoder->Batches = 0U;
+    decoder->IsFailed = false;
+}
+
+/**
+ * @brief Feeds received body bytes to the decoder, a batch is decoded once complete.
+ */
+static void BacklogDecode(BacklogDecoder_T * decoder, const uint8_t * data, uint32_t length)
+{
+    TimeSeriesDecompressor_T decompressor;
+    uint32_t values[TIMESERIES_COMPRESSOR_MAX_CHANNELS];
+    uint32_t timestampMs;
+    uint32_t count;
+
+    while ((0U != length) && !decoder->IsFailed)
+    {
+        if (decoder->PrefixFill < sizeof(decoder->Prefix))
+        {
+            decoder->Prefix[decoder->PrefixFill++] = *data++;
+            length--;
+            if (decoder->PrefixFill == sizeof(decoder->Prefix))
+            {
+                decoder->BatchLength = (uint32_t) decoder->Prefix[0] | ((uint32_t) decoder->Prefix[1] << 8);
+                decoder->BatchFill = 0U;
+            }
+            continue;
+        }
+        count = decoder->BatchLength - decoder->BatchFill;
+        count = (count < length) ? count : length;
+        memcpy(&decoder->Batch[decoder->BatchFill], data, count);
+        decoder->BatchFill += count;
+        data += count;
+        length -= count;
+        if (decoder->BatchFill == decoder->BatchLength)
+        {
+            if (!TimeSeriesDecompressor_Init(&decompressor, decoder->Batch, decoder->BatchLength))
+            {
+                decoder->IsFailed = true;
+                break;
+            }
+            while (TimeSeriesDecompressor_Next(&decompressor, &timestampMs, values))
+            {
+                decoder->Samples++;
+            }
+            decoder->IsFailed = (decompressor.SampleIndex != decompressor.SampleCount);
+            decoder->Batches++;
+            decoder->PrefixFill = 0U;
+        }
+    }
+}
+
+static void BacklogServeConnection(int socketHandle, int idleMs, BacklogDecoder_T * decoder)
+{
+    static const char body[] = "OK\n";
+    HttpMessage_Head_T head;
+    uint8_t buffer[BACKLOG_RECEIVE_SIZE];
+    char response[256];
+    uint64_t bodyBytes = 0U;
+    uint32_t consumed;
+    uint32_t length;
+    bool isDecoded;
+    int32_t count;
+
+    HttpMessage_InitHead(&head, false);
+    BacklogResetDecoder(decoder);
+    for (;;)
+    {
+        count = BacklogRead(socketHandle, buffer, sizeof(buffer), idleMs);
+        if (count <= 0)
+        {
+            break;
+        }
+        consumed = (HTTP_MESSAGE_STATE_BODY == head.State) ? 0U : HttpMessage_ParseHead(&head, buffer, (uint32_t) count);
+        if (HTTP_MESSAGE_STATE_ERROR == head.State)
+        {
+            break;
+        }
+        if (HTTP_MESSAGE_STATE_BODY != head.State)
+        {
+            continue;
+        }
+        length = HttpMessage_ReceiveBody(&head, &buffer[consumed], (uint32_t) count - consumed);
+        BacklogDecode(decoder, &buffer[consumed], length);
+        bodyBytes += length;
+        if (!HttpMessage_IsBodyComplete(&head))
+        {
+            continue;
+        }
+        isDecoded = (!decoder->IsFailed) && (0U == decoder->PrefixFill);
+        printf("%s post: %llu body bytes, %u batches, %llu samples%s\n", head.IsChunked ? "chunked" : "Content-Length",
+                (unsigned long long) bodyBytes, decoder->Batches, (unsigned long long) decoder->Samples,
+                isDecoded ? "" : ", not decodable");
+        fflush(stdout);
+
+        length = HttpMessage_WriteResponseHead(response, sizeof(response), isDecoded ? 200U : 400U, isDecoded ? "OK" : "Bad Request",
+                "text/plain", sizeof(body) - 1U, head.IsClose);
+        memcpy(&response[length], body, sizeof(body) - 1U);
+        if (!BacklogWrite(socketHandle, (const uint8_t *) response, length + sizeof(body) - 1U) || head.IsClose)
+        {
+            break;
+        }
+        HttpMessage_InitHead(&head, false);
+        BacklogResetDecoder(decoder);
+        bodyBytes = 0U;
+    }
+    close(socketHandle);
+}
+
+static int BacklogServer(uint16_t port, int idleMs)
+{
+    static BacklogDecoder_T decoder;
+    struct sockaddr_in address;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int option = 1;
+    int socketHandle;
+
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((0 != bind(listener, (struct sockaddr *) &address, sizeof(address))) || (0 != listen(listener, SOMAXCONN)))
+    {
+        perror("bind");
+        return 1;
+    }
+    printf("Backlog endpoint on 127.0.0.1:%u, one connection at a time\n", (unsigned int) port);
+    fflush(stdout);
+    for (;;)
+    {
+        socketHandle = accept(listener, NULL, NULL);
+        if (socketHandle >= 0)
+        {
+            BacklogServeConnection(socketHandle, idleMs, &decoder);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a synthetic log of 1 Hz samples in the format of APP_SD_LOG_FILE_NAME.
+ */
+static int BacklogMakeLog(uint32_t samples, const char * path)
+{
+    static uint8_t block[BACKLOG_BATCH_SIZE];
+    TimeSeriesCompressor_T compressor;
+    SensorSnapshot_T snapshot;
+    FILE * file = fopen(path, "wb");
+    uint32_t sample;
+    uint32_t length;
+    uint32_t batches = 0U;
+    uint32_t seed = 12345U;
+    uint8_t prefix[2];
+    bool isAppended;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return 1;
+    }
+    memset(&snapshot, 0, sizeof(snapshot));
+    (void) TimeSeriesCompressor_Init(&compressor, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, block, sizeof(block));
+    for (sample = 0U; sample <= samples; sample++)
+    {
+        isAppended = false;
+        if (sample < samples)
+        {
+            seed = (seed * 1103515245U) + 12345U;
+            snapshot.TimestampMs = sample * 1000U;
+            snapshot.Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = (float) (9.0 + (0.01 * (double) ((seed >> 16) % 5U)));
+            snapshot.Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (120000.0 + (20000.0 * sin((double) sample / 3600.0)));
+            snapshot.Values[SENSOR_SNAPSHOT_PRESSURE].Int = 101325 + (int32_t) ((seed >> 8) % 7U);
+            snapshot.Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) (22000.0 + (500.0 * sin((double) sample / 2400.0)));
+            isAppended = TimeSeriesCompressor_Append(&compressor, snapshot.TimestampMs, &snapshot.Values[0].Bits);
+        }
+        if (!isAppended && (0U != compressor.SampleCount))
+        {
+            /* The batch is full, or the last one: logged like AppControllerLogSampleBatch */
+            length = TimeSeriesCompressor_Finish(&compressor);
+            prefix[0] = (uint8_t) (length & 0xFFU);
+            prefix[1] = (uint8_t) (length >> 8);
+            (void) fwrite(prefix, 1U, sizeof(prefix), file);
+            (void) fwrite(block, 1U, length, file);
+            batches++;
+            (void) TimeSeriesCompressor_Init(&compressor, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, block, sizeof(block));
+            if (sample < samples)
+            {
+                (void) TimeSeriesCompressor_Append(&compressor, snapshot.TimestampMs, &snapshot.Values[0].Bits);
+            }
+        }
+    }
+    printf("%s: %u samples in %u batches, %ld bytes\n", path, samples, batches, ftell(file));
+    fclose(file);
+    return 0;
+}
+
+static void BacklogUsage(void)
+{
+    fprintf(stderr, "Usage: BacklogUpload [--contiguous] [--repeat n] [--path p] SAMPLES.TSC host port\n"
+            "       BacklogUpload --server [--idle ms] port\n"
+            "       BacklogUpload --make-log samples SAMPLES.TSC\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const char * urlPath = "/~ex0eby/sendValuesToDatabase.php"; /* DEST_POST_PATH */
+    bool isServer = false;
+    bool isContiguous = false;
+    uint32_t repeat = 1U;
+    int idleMs = 10000;
+    int argument;
+
+    if ((4 == argc) && (0 == strcmp(argv[1], "--make-log")))
+    {
+        return BacklogMakeLog((uint32_t) strtoul(argv[2], NULL, 0), argv[3]);
+    }
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--server"))
+        {
+            isServer = true;
+        }
+        else if (0 == strcmp(argv[argument], "--contiguous"))
+        {
+            isContiguous = true;
+        }
+        else if (argument + 1 >= argc)
+        {
+            BacklogUsage();
+            return 1;
+        }
+        else if (0 == strcmp(argv[argument], "--repeat"))
+        {
+            repeat = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--path"))
+        {
+            urlPath = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--idle"))
+        {
+            idleMs = atoi(argv[++argument]);
+        }
+        else
+        {
+            BacklogUsage();
+            return 1;
+        }
+    }
+    if (isServer && ((argument + 1) == argc))
+    {
+        return BacklogServer((uint16_t) strtoul(argv[argument], NULL, 0), idleMs);
+    }
+    if (isServer || ((argument + 3) != argc))
+    {
+        BacklogUsage();
+        return 1;
+    }
+    return BacklogPost(argv[argument], argv[argument + 1], (uint16_t) strtoul(argv[argument + 2], NULL, 0), urlPath, isContiguous, repeat);
+}
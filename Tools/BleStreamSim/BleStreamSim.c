@@ -0,0 +1,266 @@
+/**
+ *  @file
+ *
+ *  @brief Simulated BLE link for the XDK110_Dashboard notification streamer.
+ *
+ *  Drives the firmware SampleRing and BleStream modules in simulated time:
+ *  the acquisition pushes samples at the requested rate, the stream is
+ *  processed once per connection interval and the link refuses a configurable
+ *  share of the frames (controller buffers full, retransmissions). Every
+ *  delivered frame is decoded and checked: sequence numbers must be
+ *  continuous and samples may only go missing where the ring reported a drop.
+ *
+ *  Usage: BleStreamSim [rate Hz] [payload bytes] [interval ms] [packets per event]
+ *                      [busy %] [duration s] [ring capacity] [channel mask]
+ *
+ *  Defaults: 50 Hz, 244 bytes, 30 ms, 4 packets, 10 %, 60 s, 64 samples,
+ *  accelerometer and gyroscope.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "BleStream.h"
+#include "SampleRing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_LATENCY_BUCKETS     10000U /**< 1 ms latency histogram buckets */
+
+#define SIM_ACCEL_GYRO_MASK     ((1U << SENSOR_SNAPSHOT_ACCELEROMETER_X) | (1U << SENSOR_SNAPSHOT_ACCELEROMETER_Y) | \
+                                 (1U << SENSOR_SNAPSHOT_ACCELEROMETER_Z) | (1U << SENSOR_SNAPSHOT_GYROSCOPE_X) | \
+                                 (1U << SENSOR_SNAPSHOT_GYROSCOPE_Y) | (1U << SENSOR_SNAPSHOT_GYROSCOPE_Z))
+
+/* local variables ********************************************************** */
+
+static uint32_t SimNowMs = 0UL;
+
+static uint32_t SimBusyPercent = 10UL;
+
+static uint16_t SimChannelMask = SIM_ACCEL_GYRO_MASK;
+
+static uint32_t SimLatency[SIM_LATENCY_BUCKETS + 1U];
+
+static uint32_t SimDelivered = 0UL; /**< Samples decoded from delivered frames */
+
+static uint32_t SimGaps = 0UL; /**< Samples missing between delivered samples */
+
+static uint32_t SimErrors = 0UL;
+
+static int64_t SimLastIndex = -1;
+
+static int SimLastSequence = -1;
+
+/* local functions ********************************************************** */
+
+static uint16_t ReadLe16(const uint8_t * buffer)
+{
+    return (uint16_t) (buffer[0] | (buffer[1] << 8));
+}
+
+static uint32_t ReadLe32(const uint8_t * buffer)
+{
+    return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+/**
+ * @brief Every value encodes the sample index and its channel, so the decoder can spot reordering and loss.
+ */
+static uint32_t SimValue(uint32_t sampleIndex, uint8_t channel)
+{
+    return (sampleIndex << 4) | channel;
+}
+
+/**
+ * @brief Decodes and checks one delivered frame, the way the phone application would.
+ */
+static void SimDecodeFrame(const uint8_t * frame, uint16_t length)
+{
+    uint8_t count = frame[1];
+    uint32_t timestampMs = ReadLe32(&frame[2]);
+    uint16_t position = BLE_STREAM_FRAME_HEADER_SIZE;
+    uint32_t latencyMs;
+    uint32_t index = 0UL;
+    uint8_t sample;
+    uint8_t channel;
+    bool first;
+
+    if ((SimLastSequence >= 0) && (frame[0] != (uint8_t) (SimLastSequence + 1)))
+    {
+        printf("sequence error: %u after %d\n", frame[0], SimLastSequence);
+        SimErrors++;
+    }
+    SimLastSequence = frame[0];
+
+    for (sample = 0U; sample < count; sample++)
+    {
+        timestampMs += ReadLe16(&frame[position]);
+        position += BLE_STREAM_SAMPLE_DELTA_SIZE;
+        first = true;
+        for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+        {
+            if (0U != (SimChannelMask & (1U << channel)))
+            {
+                uint32_t value = ReadLe32(&frame[position]);
+                position += 4U;
+                if (first)
+                {
+                    index = value >> 4;
+                    first = false;
+                }
+                if (value != SimValue(index, channel))
+                {
+                    SimErrors++;
+                }
+            }
+        }
+        if ((int64_t) index <= SimLastIndex)
+        {
+            printf("sample %u repeated or reordered\n", (unsigned int) index);
+            SimErrors++;
+        }
+        else
+        {
+            SimGaps += (uint32_t) ((int64_t) index - SimLastIndex - 1);
+        }
+        SimLastIndex = index;
+        latencyMs = SimNowMs - timestampMs;
+        SimLatency[(latencyMs < SIM_LATENCY_BUCKETS) ? latencyMs : SIM_LATENCY_BUCKETS]++;
+        SimDelivered++;
+    }
+    if (position != length)
+    {
+        printf("frame length %u, decoded %u\n", length, position);
+        SimErrors++;
+    }
+}
+
+static bool SimSend(void * context, const uint8_t * frame, uint16_t length)
+{
+    (void) context;
+
+    if ((uint32_t) (rand() % 100) < SimBusyPercent)
+    {
+        return false;
+    }
+    SimDecodeFrame(frame, length);
+    return true;
+}
+
+static uint32_t SimPercentile(uint32_t percent)
+{
+    uint64_t target = ((uint64_t) SimDelivered * percent + 99U) / 100U;
+    uint64_t seen = 0U;
+    uint32_t bucket;
+
+    for (bucket = 0U; bucket <= SIM_LATENCY_BUCKETS; bucket++)
+    {
+        seen += SimLatency[bucket];
+        if ((seen >= target) && (0U != seen))
+        {
+            return bucket;
+        }
+    }
+    return SIM_LATENCY_BUCKETS;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    uint32_t rateHz = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : 50UL;
+    uint32_t payload = (argc > 2) ? (uint32_t) strtoul(argv[2], NULL, 0) : BLE_STREAM_MAX_PAYLOAD_SIZE;
+    uint32_t intervalMs = (argc > 3) ? (uint32_t) strtoul(argv[3], NULL, 0) : 30UL;
+    uint32_t packets = (argc > 4) ? (uint32_t) strtoul(argv[4], NULL, 0) : 4UL;
+    uint32_t durationS = (argc > 6) ? (uint32_t) strtoul(argv[6], NULL, 0) : 60UL;
+    uint32_t capacity = (argc > 7) ? (uint32_t) strtoul(argv[7], NULL, 0) : 64UL;
+    SensorSnapshot_T * storage;
+    SensorSnapshot_T snapshot;
+    SampleRing_T ring;
+    BleStream_T stream;
+    BleStream_Setup_T setup;
+    const BleStream_Statistics_T * statistics;
+    uint32_t produced = 0UL;
+    uint32_t lost;
+    uint64_t nextSampleUs = 0U;
+    uint8_t channel;
+
+    if (argc > 5)
+    {
+        SimBusyPercent = (uint32_t) strtoul(argv[5], NULL, 0);
+    }
+    if (argc > 8)
+    {
+        SimChannelMask = (uint16_t) strtoul(argv[8], NULL, 0);
+    }
+    storage = calloc(capacity, sizeof(SensorSnapshot_T));
+    if ((0UL == rateHz) || (NULL == storage) || !SampleRing_Init(&ring, storage, capacity))
+    {
+        fprintf(stderr, "invalid rate or ring capacity\n");
+        return 1;
+    }
+    setup.PayloadSize = (uint16_t) payload;
+    setup.ChannelMask = SimChannelMask;
+    setup.ConnectionIntervalMs = intervalMs;
+    setup.PacketsPerEvent = (uint8_t) packets;
+    setup.MaxLatencyMs = intervalMs * 2UL;
+    setup.Send = SimSend;
+    setup.SendContext = NULL;
+    if (!BleStream_Init(&stream, &setup, &ring))
+    {
+        fprintf(stderr, "invalid stream configuration (one sample must fit into the payload)\n");
+        return 1;
+    }
+    srand(1);
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    for (SimNowMs = 0UL; SimNowMs < (durationS * 1000UL); SimNowMs++)
+    {
+        while (nextSampleUs <= ((uint64_t) SimNowMs * 1000U))
+        {
+            snapshot.TimestampMs = SimNowMs;
+            for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+            {
+                snapshot.Values[channel].Bits = SimValue(produced, channel);
+            }
+            (void) SampleRing_Push(&ring, &snapshot);
+            produced++;
+            nextSampleUs += 1000000U / rateHz;
+        }
+        if (0UL == (SimNowMs % intervalMs))
+        {
+            (void) BleStream_Process(&stream, SimNowMs);
+        }
+    }
+
+    statistics = BleStream_GetStatistics(&stream);
+    printf("rate_hz=%u payload=%u interval_ms=%u packets_per_event=%u busy_percent=%u duration_s=%u\n",
+            (unsigned int) rateHz, (unsigned int) payload, (unsigned int) intervalMs, (unsigned int) packets,
+            (unsigned int) SimBusyPercent, (unsigned int) durationS);
+    printf("samples_per_frame=%u recommended_interval_us=%u\n", BleStream_GetSamplesPerFrame(&stream),
+            (unsigned int) BleStream_RecommendConnectionIntervalUs(&stream, rateHz));
+    printf("produced=%u delivered=%u queued=%u dropped=%u peak_ring_fill=%u/%u\n", (unsigned int) produced,
+            (unsigned int) SimDelivered, (unsigned int) SampleRing_Count(&ring), (unsigned int) statistics->SamplesDropped,
+            (unsigned int) statistics->PeakRingFill, (unsigned int) capacity);
+    printf("frames=%u link_busy=%u bytes=%u throughput_Bps=%u bytes_per_sample=%.2f\n",
+            (unsigned int) statistics->FramesSent, (unsigned int) statistics->LinkBusy, (unsigned int) statistics->BytesSent,
+            (unsigned int) BleStream_GetThroughput(&stream),
+            (0UL != SimDelivered) ? ((double) statistics->BytesSent / SimDelivered) : 0.0);
+    printf("latency_ms p50=%u p99=%u max=%u\n", (unsigned int) SimPercentile(50U), (unsigned int) SimPercentile(99U),
+            (unsigned int) SimPercentile(100U));
+
+    /* Only ring drops may go missing, the stream itself must never lose a sample */
+    lost = produced - SimDelivered - SampleRing_Count(&ring);
+    if ((lost != statistics->SamplesDropped) || (SimGaps > lost))
+    {
+        printf("FAILED: %u samples lost, %u dropped by the ring\n", (unsigned int) lost, (unsigned int) statistics->SamplesDropped);
+        SimErrors++;
+    }
+    printf("%s\n", (0UL == SimErrors) ? "check OK" : "check FAILED");
+    free(storage);
+    return (0UL == SimErrors) ? 0 : 1;
+}
@@ -0,0 +1,497 @@
+/**
+ *  @file
+ *
+ *  @brief Serves and fetches the RemoteConfig document of XDK110_Dashboard
+ *  (APP_REMOTE_CONFIG_ENABLE) on the host.
+ *
+ *  The server answers a GET of any path with the document file, read again
+ *  for every request, so an edit of the file is what a fleet sees on its next
+ *  poll. Its ETag is the FNV-1a hash of the content; a request whose
+ *  If-None-Match carries it gets a 304 without body. A document which the
+ *  firmware would reject is served anyway, to test the device side, and
+ *  reported with the rejected line.
+ *
+ *  --fetch polls a server like ConfigAgent does, through the firmware
+ *  HttpsSession over plain TCP: the ETag of the last answer goes out in
+ *  If-None-Match, a new document is parsed with RemoteConfig_Parse and the
+ *  changed settings are printed. It reports the bytes received per poll, a
+ *  200 and a 304 side by side.
+ *
+ *  --check validates a document and prints its settings, before it goes to
+ *  the server.
+ *
+ *  Usage: ConfigServer [--idle ms] document port
+ *         ConfigServer --fetch [--polls n] [--interval ms] host port path
+ *         ConfigServer --check document
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "HttpsSession.h"
+#include "RemoteConfig.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* constant definitions ***************************************************** */
+
+#define CONFIG_TIMEOUT_MS           25000U  /**< APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT */
+#define CONFIG_RECEIVE_SIZE         2048U
+
+/* local variables ********************************************************** */
+
+static int ConfigSocket = -1;
+
+static uint64_t ConfigBytesReceived = 0U;
+
+/* local functions ********************************************************** */
+
+static uint32_t ConfigNowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((now.tv_sec * 1000L) + (now.tv_nsec / 1000000L));
+}
+
+static bool ConfigWrite(int socketHandle, const uint8_t * data, uint32_t length)
+{
+    ssize_t written;
+
+    while (0U != length)
+    {
+        written = send(socketHandle, data, length, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= (uint32_t) written;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the number of bytes received, 0 if the peer closed, negative on error or timeout.
+ */
+static int32_t ConfigRead(int socketHandle, uint8_t * buffer, uint32_t size, int timeoutMs)
+{
+    struct pollfd descriptor = { .fd = socketHandle, .events = POLLIN };
+
+    if (poll(&descriptor, 1, timeoutMs) <= 0)
+    {
+        return -1;
+    }
+    return (int32_t) recv(socketHandle, buffer, size, 0);
+}
+
+static bool ConfigResolve(void * context, const char * host, uint32_t * address)
+{
+    struct addrinfo hints;
+    struct addrinfo * result;
+
+    (void) context;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (0 != getaddrinfo(host, NULL, &hints, &result))
+    {
+        return false;
+    }
+    *address = ntohl(((struct sockaddr_in *) result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+static bool ConfigConnect(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount)
+{
+    struct sockaddr_in serverAddress;
+    int isNoDelay = 1;
+
+    (void) context;
+    (void) ciphers;
+    (void) cipherCount;
+    ConfigSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (ConfigSocket < 0)
+    {
+        return false;
+    }
+    (void) setsockopt(ConfigSocket, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(port);
+    serverAddress.sin_addr.s_addr = htonl(address);
+    return (0 == connect(ConfigSocket, (struct sockaddr *) &serverAddress, sizeof(serverAddress)));
+}
+
+static bool ConfigSend(void * context, const uint8_t * data, uint32_t length)
+{
+    (void) context;
+    return ConfigWrite(ConfigSocket, data, length);
+}
+
+static int32_t ConfigReceive(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs)
+{
+    int32_t count;
+
+    (void) context;
+    count = ConfigRead(ConfigSocket, buffer, size, (int) timeoutMs);
+    if (count > 0)
+    {
+        ConfigBytesReceived += (uint64_t) count;
+    }
+    return count;
+}
+
+static void ConfigClose(void * context)
+{
+    (void) context;
+    if (ConfigSocket >= 0)
+    {
+        close(ConfigSocket);
+        ConfigSocket = -1;
+    }
+}
+
+static const HttpsSession_Transport_T ConfigTransport =
+        {
+                .Context = NULL,
+                .Resolve = ConfigResolve,
+                .Connect = ConfigConnect,
+                .Handshake = NULL,
+                .Send = ConfigSend,
+                .Receive = ConfigReceive,
+                .Close = ConfigClose,
+                .NowMs = ConfigNowMs,
+        };
+
+/**
+ * @brief Reads a document file, at most REMOTE_CONFIG_MAX_DOCUMENT + 1 bytes.
+ *
+ * @return Length read, negative if the file cannot be read.
+ */
+static long ConfigReadDocument(const char * path, char * document)
+{
+    FILE * file = fopen(path, "rb");
+    size_t length;
+
+    if (NULL == file)
+    {
+        return -1L;
+    }
+    length = fread(document, 1U, REMOTE_CONFIG_MAX_DOCUMENT + 1U, file);
+    fclose(file);
+    return (long) length;
+}
+
+static void ConfigPrint(const RemoteConfig_T * config)
+{
+    uint8_t sensor;
+
+    printf("  version %u\n", (unsigned int) config->Version);
+    printf("  snapshot period %u ms, upload interval %u ms%s\n", (unsigned int) config->SnapshotPeriodMs,
+            (unsigned int) config->UploadIntervalMs, " (0: built in)");
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if (0U != config->SensorPeriodsMs[sensor])
+        {
+            printf("  %s period %u ms\n", SensorTable_GetSensorName(sensor), (unsigned int) config->SensorPeriodsMs[sensor]);
+        }
+    }
+    printf("  gyroscope range %u dps, magnetometer rate %u Hz, post path %s\n", (unsigned int) config->GyroscopeRangeDps,
+            (unsigned int) config->MagnetometerRateHz, ('\0' != config->PostPath[0]) ? config->PostPath : "(built in)");
+}
+
+static int ConfigCheck(const char * path)
+{
+    static char document[REMOTE_CONFIG_MAX_DOCUMENT + 1U];
+    RemoteConfig_T config;
+    uint16_t errorLine = 0U;
+    long length = ConfigReadDocument(path, document);
+
+    if (length < 0L)
+    {
+        perror(path);
+        return 1;
+    }
+    if (!RemoteConfig_Parse(document, (uint32_t) length, &config, &errorLine))
+    {
+        if (0U == errorLine)
+        {
+            printf("%s: rejected, longer than %u bytes\n", path, (unsigned int) REMOTE_CONFIG_MAX_DOCUMENT);
+        }
+        else
+        {
+            printf("%s: rejected at line %u\n", path, (unsigned int) errorLine);
+        }
+        return 1;
+    }
+    printf("%s: valid, %ld bytes\n", path, length);
+    ConfigPrint(&config);
+    return 0;
+}
+
+/**
+ * @brief Polls a document like ConfigAgent_Poll, at a fixed interval.
+ */
+static int ConfigFetch(const char * host, uint16_t port, const char * path, uint32_t polls, uint32_t intervalMs)
+{
+    static HttpsSession_T session;
+    static char document[REMOTE_CONFIG_MAX_DOCUMENT + 1U];
+    HttpsSession_Setup_T setup;
+    HttpsSession_Request_T request;
+    HttpsSession_Response_T response;
+    RemoteConfig_T current;
+    RemoteConfig_T config;
+    char etag[HTTP_MESSAGE_MAX_ETAG] = "";
+    char headers[sizeof("If-None-Match: \r\n") + HTTP_MESSAGE_MAX_ETAG];
+    uint64_t bytesBefore;
+    uint16_t errorLine;
+    uint32_t poll;
+    int result = 0;
+
+    setup.Host = host;
+    setup.Port = port;
+    setup.Ciphers = NULL;
+    setup.CipherCount = 0U;
+    setup.MaxIdleMs = 0U;
+    setup.MaxRequestsPerConnection = 0U;
+    setup.TimeoutMs = CONFIG_TIMEOUT_MS;
+    setup.Transport = &ConfigTransport;
+    if (!HttpsSession_Init(&session, &setup))
+    {
+        return 1;
+    }
+    memset(&request, 0, sizeof(request));
+    request.Method = "GET";
+    request.Path = path;
+    response.Body = (uint8_t *) document;
+    response.BodySize = sizeof(document);
+    memset(&current, 0, sizeof(current));
+
+    for (poll = 0U; poll < polls; poll++)
+    {
+        if (0U != poll)
+        {
+            usleep(intervalMs * 1000U);
+        }
+        (void) snprintf(headers, sizeof(headers), "If-None-Match: %s\r\n", etag);
+        request.ExtraHeaders = ('\0' != etag[0]) ? headers : NULL;
+        bytesBefore = ConfigBytesReceived;
+        if (!HttpsSession_Request(&session, &request, &response))
+        {
+            printf("poll %u: no response\n", poll);
+            result = 1;
+            continue;
+        }
+        printf("poll %u: %u, %llu bytes received", poll, (unsigned int) response.Status, (unsigned long long) (ConfigBytesReceived - bytesBefore));
+        if (304U == response.Status)
+        {
+            printf(", unchanged\n");
+            continue;
+        }
+        if (200U != response.Status)
+        {
+            printf("\n");
+            result = 1;
+            continue;
+        }
+        memcpy(etag, response.ETag, sizeof(etag));
+        if (!RemoteConfig_Parse(document, response.BodyLength, &config, &errorLine))
+        {
+            printf(", ETag %s, rejected at line %u, settings kept\n", etag, (unsigned int) errorLine);
+            continue;
+        }
+        printf(", ETag %s, changes 0x%02x\n", etag, (unsigned int) RemoteConfig_Compare(&current, &config));
+        current = config;
+        ConfigPrint(&current);
+        fflush(stdout);
+    }
+    HttpsSession_Close(&session);
+    printf("%u requests on %u connections\n", session.Statistics.Requests, session.Statistics.Connections);
+    return result;
+}
+
+/**
+ * @brief 32 bit FNV-1a, the ETag of a document.
+ */
+static uint32_t ConfigHash(const char * data, uint32_t length)
+{
+    uint32_t hash = 2166136261U;
+    uint32_t index;
+
+    for (index = 0U; index < length; index++)
+    {
+        hash = (hash ^ (uint8_t) data[index]) * 16777619U;
+    }
+    return hash;
+}
+
+static void ConfigServeConnection(int socketHandle, int idleMs, const char * path)
+{
+    static char document[REMOTE_CONFIG_MAX_DOCUMENT + 1U];
+    HttpMessage_Head_T head;
+    RemoteConfig_T config;
+    uint8_t buffer[CONFIG_RECEIVE_SIZE];
+    char response[256 + sizeof(document)];
+    char etag[HTTP_MESSAGE_MAX_ETAG];
+    uint32_t length;
+    uint16_t errorLine;
+    long documentLength;
+    bool isUnchanged;
+    int32_t count;
+    int written;
+
+    HttpMessage_InitHead(&head, false);
+    for (;;)
+    {
+        count = ConfigRead(socketHandle, buffer, sizeof(buffer), idleMs);
+        if (count <= 0)
+        {
+            break;
+        }
+        (void) HttpMessage_ParseHead(&head, buffer, (uint32_t) count);
+        if (HTTP_MESSAGE_STATE_ERROR == head.State)
+        {
+            break;
+        }
+        if (HTTP_MESSAGE_STATE_BODY != head.State)
+        {
+            continue;
+        }
+        documentLength = ConfigReadDocument(path, document);
+        if (documentLength < 0L)
+        {
+            length = HttpMessage_WriteResponseHead(response, sizeof(response), 404U, "Not Found", "text/plain", 0U, head.IsClose);
+            printf("GET %s: 404, %s not readable\n", head.Path, path);
+        }
+        else
+        {
+            (void) snprintf(etag, sizeof(etag), "\"%08x\"", (unsigned int) ConfigHash(document, (uint32_t) documentLength));
+            isUnchanged = (0 == strcmp(head.ETag, etag));
+            written = snprintf(response, sizeof(response), "HTTP/1.1 %s\r\nContent-Type: text/plain\r\nETag: %s\r\n"
+                    "Content-Length: %ld\r\nConnection: %s\r\n\r\n", isUnchanged ? "304 Not Modified" : "200 OK", etag,
+                    isUnchanged ? 0L : documentLength, head.IsClose ? "close" : "keep-alive");
+            length = (uint32_t) written;
+            if (!isUnchanged)
+            {
+                memcpy(&response[length], document, (size_t) documentLength);
+                length += (uint32_t) documentLength;
+            }
+            printf("GET %s: %s, ETag %s", head.Path, isUnchanged ? "304" : "200", etag);
+            if (!isUnchanged && !RemoteConfig_Parse(document, (uint32_t) documentLength, &config, &errorLine))
+            {
+                printf(", the firmware rejects it at line %u", (unsigned int) errorLine);
+            }
+            printf("\n");
+        }
+        fflush(stdout);
+        if (!ConfigWrite(socketHandle, (const uint8_t *) response, length) || head.IsClose)
+        {
+            break;
+        }
+        HttpMessage_InitHead(&head, false);
+    }
+    close(socketHandle);
+}
+
+static int ConfigServer(const char * path, uint16_t port, int idleMs)
+{
+    struct sockaddr_in address;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int option = 1;
+    int socketHandle;
+
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if ((0 != bind(listener, (struct sockaddr *) &address, sizeof(address))) || (0 != listen(listener, SOMAXCONN)))
+    {
+        perror("bind");
+        return 1;
+    }
+    printf("Serving %s on port %u, one connection at a time\n", path, (unsigned int) port);
+    fflush(stdout);
+    for (;;)
+    {
+        socketHandle = accept(listener, NULL, NULL);
+        if (socketHandle >= 0)
+        {
+            ConfigServeConnection(socketHandle, idleMs, path);
+        }
+    }
+    return 0;
+}
+
+static void ConfigUsage(void)
+{
+    fprintf(stderr, "Usage: ConfigServer [--idle ms] document port\n"
+            "       ConfigServer --fetch [--polls n] [--interval ms] host port path\n"
+            "       ConfigServer --check document\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    bool isFetch = false;
+    uint32_t polls = 3U;
+    uint32_t intervalMs = 1000U;
+    int idleMs = 10000;
+    int argument;
+
+    if ((3 == argc) && (0 == strcmp(argv[1], "--check")))
+    {
+        return ConfigCheck(argv[2]);
+    }
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--fetch"))
+        {
+            isFetch = true;
+        }
+        else if (argument + 1 >= argc)
+        {
+            ConfigUsage();
+            return 1;
+        }
+        else if (0 == strcmp(argv[argument], "--polls"))
+        {
+            polls = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--interval"))
+        {
+            intervalMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--idle"))
+        {
+            idleMs = atoi(argv[++argument]);
+        }
+        else
+        {
+            ConfigUsage();
+            return 1;
+        }
+    }
+    if (isFetch && ((argument + 3) == argc))
+    {
+        return ConfigFetch(argv[argument], (uint16_t) strtoul(argv[argument + 1], NULL, 0), argv[argument + 2], polls, intervalMs);
+    }
+    if (isFetch || ((argument + 2) != argc))
+    {
+        ConfigUsage();
+        return 1;
+    }
+    return ConfigServer(argv[argument], (uint16_t) strtoul(argv[argument + 1], NULL, 0), idleMs);
+}
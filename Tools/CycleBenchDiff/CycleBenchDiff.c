@@ -0,0 +1,264 @@
+/**
+ *  @file
+ *
+ *  @brief Report and comparison of SensorBench runs.
+ *
+ *  Reads the USB console output of SensorBench (captured with any terminal
+ *  program; other lines and prefixes before "BENCH," are ignored) and prints
+ *  every case in cycles and microseconds. With two captures every case of
+ *  either run is listed with the change of its median and p99; a case whose
+ *  median or p99 grew by more than the threshold, or which fails more often,
+ *  is a regression and makes the exit code 2.
+ *
+ *  Usage: CycleBenchDiff [--threshold <percent>] <run.log> [<new run.log>]
+ *    --threshold <percent>     allowed growth of median and p99, default 5
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define DIFF_LINE_SIZE          512U
+#define DIFF_NAME_SIZE          64U
+#define DIFF_MAX_CASES          128U
+
+/* local types ************************************************************** */
+
+struct DiffCase_S
+{
+    char Name[DIFF_NAME_SIZE];
+    unsigned long Iterations;
+    unsigned long Failed;
+    unsigned long Min;
+    unsigned long Median;
+    unsigned long P99;
+    unsigned long Max;
+    unsigned long Mean;
+};
+typedef struct DiffCase_S DiffCase_T;
+
+struct DiffRun_S
+{
+    const char * Path;
+    unsigned long CoreHz;
+    unsigned long Overhead;
+    uint32_t Count;
+    DiffCase_T Cases[DIFF_MAX_CASES];
+};
+typedef struct DiffRun_S DiffRun_T;
+
+/* local variables ********************************************************** */
+
+static DiffRun_T DiffRuns[2];
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Reads the cases of a capture; a case listed twice keeps its last result.
+ */
+static bool LoadRun(const char * path, DiffRun_T * run)
+{
+    FILE * file = fopen(path, "r");
+    char line[DIFF_LINE_SIZE];
+    DiffCase_T entry;
+    const char * marker;
+    unsigned long version;
+    uint32_t index;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    memset(run, 0, sizeof(*run));
+    run->Path = path;
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        marker = strstr(line, "#CYCLEBENCH,");
+        if ((NULL != marker) && (3 == sscanf(marker, "#CYCLEBENCH,%lu,%lu,%lu", &version, &run->CoreHz, &run->Overhead)))
+        {
+            continue;
+        }
+        marker = strstr(line, "BENCH,");
+        if ((NULL == marker) || ((marker != line) && ('#' == marker[-1])))
+        {
+            continue;
+        }
+        memset(&entry, 0, sizeof(entry));
+        if (8 != sscanf(marker, "BENCH,%63[^,],%lu,%lu,%lu,%lu,%lu,%lu,%lu", entry.Name, &entry.Iterations, &entry.Failed,
+                &entry.Min, &entry.Median, &entry.P99, &entry.Max, &entry.Mean))
+        {
+            fprintf(stderr, "%s: skipping malformed line: %s", path, marker);
+            continue;
+        }
+        for (index = 0U; (index < run->Count) && (0 != strcmp(run->Cases[index].Name, entry.Name)); index++)
+        {
+        }
+        if (index == DIFF_MAX_CASES)
+        {
+            fprintf(stderr, "%s: more than %u cases\n", path, DIFF_MAX_CASES);
+            break;
+        }
+        run->Cases[index] = entry;
+        if (index == run->Count)
+        {
+            run->Count++;
+        }
+    }
+    fclose(file);
+    if (0U == run->Count)
+    {
+        fprintf(stderr, "%s: no BENCH lines\n", path);
+        return false;
+    }
+    return true;
+}
+
+static const DiffCase_T * FindCase(const DiffRun_T * run, const char * name)
+{
+    uint32_t index;
+
+    for (index = 0U; index < run->Count; index++)
+    {
+        if (0 == strcmp(run->Cases[index].Name, name))
+        {
+            return &run->Cases[index];
+        }
+    }
+    return NULL;
+}
+
+static double Microseconds(const DiffRun_T * run, unsigned long cycles)
+{
+    return (0UL == run->CoreHz) ? 0.0 : (((double) cycles * 1e6) / (double) run->CoreHz);
+}
+
+static void PrintRun(const DiffRun_T * run)
+{
+    uint32_t index;
+
+    printf("%s: core clock %lu Hz, timing overhead %lu cycles\n\n", run->Path, run->CoreHz, run->Overhead);
+    printf("%-34s %6s %6s %10s %10s %10s %10s %10s %10s\n", "case", "calls", "failed", "min", "median", "p99", "max",
+            "median us", "p99 us");
+    for (index = 0U; index < run->Count; index++)
+    {
+        const DiffCase_T * entry = &run->Cases[index];
+        printf("%-34s %6lu %6lu %10lu %10lu %10lu %10lu %10.1f %10.1f\n", entry->Name, entry->Iterations, entry->Failed,
+                entry->Min, entry->Median, entry->P99, entry->Max, Microseconds(run, entry->Median), Microseconds(run, entry->P99));
+    }
+}
+
+static double Change(unsigned long before, unsigned long after)
+{
+    if (0UL == before)
+    {
+        return (0UL == after) ? 0.0 : 100.0;
+    }
+    return (((double) after - (double) before) * 100.0) / (double) before;
+}
+
+/**
+ * @brief Prints the cases of both runs.
+ *
+ * @return Number of regressions.
+ */
+static uint32_t PrintDiff(const DiffRun_T * before, const DiffRun_T * after, double threshold)
+{
+    uint32_t regressions = 0U;
+    uint32_t index;
+
+    printf("%s -> %s\n", before->Path, after->Path);
+    if (before->CoreHz != after->CoreHz)
+    {
+        printf("core clock changed: %lu -> %lu Hz, cycles are not comparable\n", before->CoreHz, after->CoreHz);
+    }
+    printf("\n%-34s %10s %10s %8s %10s %10s %8s %13s\n", "case", "median", "new", "change", "p99", "new", "change", "failed");
+    for (index = 0U; index < after->Count; index++)
+    {
+        const DiffCase_T * entry = &after->Cases[index];
+        const DiffCase_T * old = FindCase(before, entry->Name);
+        double medianChange;
+        double p99Change;
+        bool isRegression;
+
+        if (NULL == old)
+        {
+            printf("%-34s %10s %10lu %8s %10s %10lu %8s %6s %6lu  new\n", entry->Name, "-", entry->Median, "", "-", entry->P99,
+                    "", "-", entry->Failed);
+            continue;
+        }
+        medianChange = Change(old->Median, entry->Median);
+        p99Change = Change(old->P99, entry->P99);
+        isRegression = (medianChange > threshold) || (p99Change > threshold) ||
+                ((entry->Failed * old->Iterations) > (old->Failed * entry->Iterations));
+        printf("%-34s %10lu %10lu %+7.1f%% %10lu %10lu %+7.1f%% %6lu %6lu%s\n", entry->Name, old->Median, entry->Median,
+                medianChange, old->P99, entry->P99, p99Change, old->Failed, entry->Failed, isRegression ? "  REGRESSION" : "");
+        if (isRegression)
+        {
+            regressions++;
+        }
+    }
+    for (index = 0U; index < before->Count; index++)
+    {
+        if (NULL == FindCase(after, before->Cases[index].Name))
+        {
+            printf("%-34s %10lu %10s %8s %10lu %10s %8s %6lu %6s  removed\n", before->Cases[index].Name, before->Cases[index].Median,
+                    "-", "", before->Cases[index].P99, "-", "", before->Cases[index].Failed, "-");
+        }
+    }
+    printf("\n%u regression%s above %.1f %%\n", regressions, (1U == regressions) ? "" : "s", threshold);
+    return regressions;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const char * paths[2] = { NULL, NULL };
+    uint32_t pathCount = 0U;
+    double threshold = 5.0;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--threshold")) && ((arg + 1) < argc))
+        {
+            threshold = strtod(argv[++arg], NULL);
+        }
+        else if (('-' != argv[arg][0]) && (pathCount < 2U))
+        {
+            paths[pathCount++] = argv[arg];
+        }
+        else
+        {
+            pathCount = 0U;
+            break;
+        }
+    }
+    if (0U == pathCount)
+    {
+        fprintf(stderr, "usage: %s [--threshold <percent>] <run.log> [<new run.log>]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!LoadRun(paths[0], &DiffRuns[0]))
+    {
+        return EXIT_FAILURE;
+    }
+    if (1U == pathCount)
+    {
+        PrintRun(&DiffRuns[0]);
+        return EXIT_SUCCESS;
+    }
+    if (!LoadRun(paths[1], &DiffRuns[1]))
+    {
+        return EXIT_FAILURE;
+    }
+    return (0U == PrintDiff(&DiffRuns[0], &DiffRuns[1], threshold)) ? EXIT_SUCCESS : 2;
+}
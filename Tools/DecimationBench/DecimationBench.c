@@ -0,0 +1,407 @@
+/**
+ *  @file
+ *
+ *  @brief Host verification and benchmark of the XDK110_Dashboard decimation
+ *  filters.
+ *
+ *  Designs a filter with the firmware DecimationFilter and measures every
+ *  output: a complex tone, a sine and a cosine channel, is run through the
+ *  filter and the magnitude of the output pair, which a decimator keeps
+ *  constant, is its gain at the frequency of the tone. The sweep covers the
+ *  passband of the output and every band of the input which aliases into it,
+ *  and compares each point with the model of the design: the CIC responses
+ *  and the quantized FIR coefficients of the stages in float. Taking the last
+ *  value at the output rate, as the timers did so far, passes all of these
+ *  bands at 0 dB.
+ *
+ *  A constant input must come out unchanged within one LSB. Then the
+ *  processing time per input sample of one channel is measured in blocks.
+ *  The exit code is 1 if a passband ripple exceeds --max-ripple, an alias
+ *  rejection falls short of --min-rejection, a measured point deviates from
+ *  the model by more than 0.1 dB or the constant changed.
+ *
+ *  Usage: DecimationBench [options]
+ *    --stage <R,D,taps,passband%>  stage of the filter, repeated per stage,
+ *                                  default 5,2,15,40 twice (APP_DECIMATION_ENABLE)
+ *    --bits <n>              input bits, default 19
+ *    --rate <Hz>             input rate for the report, default 100
+ *    --max-ripple <dB>       default 0.5
+ *    --min-rejection <dB>    default 60
+ *    --block <n>             samples per DecimationFilter_Process, default 20
+ *    --samples <n>           samples of the timing run, default 10000000
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "DecimationFilter.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* constant definitions ***************************************************** */
+
+#define BENCH_PI                3.14159265358979
+#define BENCH_PASSBAND_POINTS   32U
+#define BENCH_ALIAS_POINTS      16U     /**< Per alias band */
+#define BENCH_MEASURED_OUTPUTS  64U     /**< Outputs averaged per point, after the settling */
+#define BENCH_MAX_DEVIATION_DB  0.1
+#define BENCH_FLOOR_MARGIN_DB   40.0    /**< Points compared with the model are this far above the rounding of one LSB */
+#define BENCH_MAX_BLOCK         4096U
+
+/* local variables ********************************************************** */
+
+static DecimationFilter_Bank_T BenchBank;
+static DecimationFilter_Channel_T BenchSine;
+static DecimationFilter_Channel_T BenchCosine;
+
+static int32_t BenchInput[2][BENCH_MAX_BLOCK];
+static int32_t BenchOutputs[2][DECIMATION_FILTER_MAX_STAGES][BENCH_MAX_BLOCK + 1U];
+
+/* local functions ********************************************************** */
+
+static double BenchNowS(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + ((double) now.tv_nsec / 1e9);
+}
+
+static double BenchDb(double gain)
+{
+    return 20.0 * log10(fmax(gain, 1e-12));
+}
+
+/**
+ * @brief Returns the modelled gain of the filter up to a stage at frequency f of the input rate.
+ */
+static double BenchModel(uint8_t stage, double f)
+{
+    double gain = 1.0;
+    double u = f;
+    uint8_t index;
+
+    for (index = 0U; index <= stage; index++)
+    {
+        const DecimationFilter_Stage_T * design = &BenchBank.Stage[index];
+        uint8_t factor = design->Setup.CicFactor;
+        double real = 0.0;
+        double imaginary = 0.0;
+        double v = u * factor;
+        uint8_t tap;
+
+        if ((factor > 1U) && (fabs(sin(BENCH_PI * u)) > 1e-12))
+        {
+            gain *= pow(fabs(sin(BENCH_PI * factor * u) / (factor * sin(BENCH_PI * u))), DECIMATION_FILTER_CIC_ORDER);
+        }
+        gain *= pow((double) factor, DECIMATION_FILTER_CIC_ORDER) / ldexp(1.0, design->CicShift);
+        for (tap = 0U; tap < design->Setup.FirTaps; tap++)
+        {
+            real += design->Coefficients[tap] * cos(2.0 * BENCH_PI * v * tap);
+            imaginary -= design->Coefficients[tap] * sin(2.0 * BENCH_PI * v * tap);
+        }
+        gain *= hypot(real, imaginary) / ldexp(1.0, DECIMATION_FILTER_COEFFICIENT_BITS);
+        u = v * design->Setup.FirFactor;
+    }
+    return gain;
+}
+
+/**
+ * @brief Runs a complex tone of frequency f through the filter.
+ *
+ * @return Mean magnitude of the output pair of a stage over BENCH_MEASURED_OUTPUTS, relative to the input.
+ */
+static double BenchMeasure(uint8_t bits, uint8_t stage, double f)
+{
+    double amplitude = ldexp(1.0, bits - 2U);
+    uint32_t factor = BenchBank.Factors[stage];
+    uint32_t settle = (uint32_t) (2.0 * DecimationFilter_GetDelay(&BenchBank, stage) / factor) + 4U;
+    uint32_t outputs = 0UL;
+    uint64_t sample = 0ULL;
+    double magnitude = 0.0;
+
+    (void) DecimationFilter_Reset(&BenchSine, &BenchBank, 0L);
+    (void) DecimationFilter_Reset(&BenchCosine, &BenchBank, 0L);
+    while (outputs < (settle + BENCH_MEASURED_OUTPUTS))
+    {
+        int32_t * sineOutputs[DECIMATION_FILTER_MAX_STAGES];
+        int32_t * cosineOutputs[DECIMATION_FILTER_MAX_STAGES];
+        uint32_t sineCounts[DECIMATION_FILTER_MAX_STAGES];
+        uint32_t cosineCounts[DECIMATION_FILTER_MAX_STAGES];
+        uint32_t index;
+
+        for (index = 0UL; index < DECIMATION_FILTER_MAX_STAGES; index++)
+        {
+            sineOutputs[index] = BenchOutputs[0][index];
+            cosineOutputs[index] = BenchOutputs[1][index];
+        }
+        for (index = 0UL; index < factor; index++, sample++)
+        {
+            double phase = 2.0 * BENCH_PI * fmod(f * (double) sample, 1.0);
+
+            BenchInput[0][index] = (int32_t) lround(amplitude * sin(phase));
+            BenchInput[1][index] = (int32_t) lround(amplitude * cos(phase));
+        }
+        (void) DecimationFilter_Process(&BenchSine, BenchInput[0], factor, sineOutputs, sineCounts);
+        (void) DecimationFilter_Process(&BenchCosine, BenchInput[1], factor, cosineOutputs, cosineCounts);
+        for (index = 0UL; index < sineCounts[stage]; index++, outputs++)
+        {
+            if (outputs >= settle)
+            {
+                magnitude += hypot(sineOutputs[stage][index], cosineOutputs[stage][index]);
+            }
+        }
+    }
+    return magnitude / BENCH_MEASURED_OUTPUTS / amplitude;
+}
+
+/**
+ * @brief Measures one point and keeps the largest deviation from the model, for points well above the rounding.
+ *
+ * @return The measured gain in dB.
+ */
+static double BenchPoint(uint8_t bits, uint8_t stage, double f, double * deviation)
+{
+    double measured = BenchDb(BenchMeasure(bits, stage, f));
+    double model = BenchDb(BenchModel(stage, f));
+
+    if ((model > (BenchDb(ldexp(1.0, 2 - (int) bits)) + BENCH_FLOOR_MARGIN_DB)) && (fabs(measured - model) > *deviation))
+    {
+        *deviation = fabs(measured - model);
+    }
+    return measured;
+}
+
+/**
+ * @brief Checks that a constant input comes out within one LSB at every output.
+ */
+static bool BenchConstant(int32_t value)
+{
+    uint32_t settle = (uint32_t) (2.0 * DecimationFilter_GetDelay(&BenchBank, BenchBank.Stages - 1U)) + BenchBank.Factors[BenchBank.Stages - 1U];
+    uint32_t sample;
+    bool isOk = true;
+
+    (void) DecimationFilter_Reset(&BenchSine, &BenchBank, 0L);
+    for (sample = 0UL; sample < (2UL * settle); sample++)
+    {
+        int32_t * outputs[DECIMATION_FILTER_MAX_STAGES];
+        uint32_t counts[DECIMATION_FILTER_MAX_STAGES];
+        uint8_t stage;
+
+        for (stage = 0U; stage < DECIMATION_FILTER_MAX_STAGES; stage++)
+        {
+            outputs[stage] = BenchOutputs[0][stage];
+        }
+        (void) DecimationFilter_Process(&BenchSine, &value, 1UL, outputs, counts);
+        for (stage = 0U; (sample >= settle) && (stage < BenchBank.Stages); stage++)
+        {
+            if ((0UL != counts[stage]) && (labs((long) outputs[stage][0] - value) > 1L))
+            {
+                printf("Constant %ld: output %u is %ld\n", (long) value, stage + 1U, (long) outputs[stage][0]);
+                isOk = false;
+            }
+        }
+    }
+    return isOk;
+}
+
+/**
+ * @brief Times one channel, the input is a noisy sine.
+ */
+static void BenchTime(uint8_t bits, uint32_t block, uint32_t samples)
+{
+    double amplitude = ldexp(1.0, bits - 2U);
+    uint32_t produced[DECIMATION_FILTER_MAX_STAGES] = { 0U };
+    uint32_t index;
+    uint32_t done;
+    double startS;
+    double elapsedS;
+    uint8_t stage;
+
+    for (index = 0UL; index < block; index++)
+    {
+        BenchInput[0][index] = (int32_t) lround(amplitude * sin(0.01 * index)) + (int32_t) (rand() % 64) - 32;
+    }
+    (void) DecimationFilter_Reset(&BenchSine, &BenchBank, 0L);
+    startS = BenchNowS();
+    for (done = 0UL; done < samples; done += block)
+    {
+        int32_t * outputs[DECIMATION_FILTER_MAX_STAGES];
+        uint32_t counts[DECIMATION_FILTER_MAX_STAGES];
+
+        for (stage = 0U; stage < DECIMATION_FILTER_MAX_STAGES; stage++)
+        {
+            outputs[stage] = BenchOutputs[0][stage];
+        }
+        (void) DecimationFilter_Process(&BenchSine, BenchInput[0], block, outputs, counts);
+        for (stage = 0U; stage < BenchBank.Stages; stage++)
+        {
+            produced[stage] += counts[stage];
+        }
+    }
+    elapsedS = BenchNowS() - startS;
+    printf("Process: %.1f ns per input sample in blocks of %lu, %lu samples, %lu outputs of the last stage\n",
+            elapsedS * 1e9 / done, (unsigned long) block, (unsigned long) done, (unsigned long) produced[BenchBank.Stages - 1U]);
+}
+
+static bool BenchParseStage(const char * text, DecimationFilter_StageSetup_T * setup)
+{
+    unsigned int cic;
+    unsigned int fir;
+    unsigned int taps;
+    unsigned int passband;
+
+    if (4 != sscanf(text, "%u,%u,%u,%u", &cic, &fir, &taps, &passband))
+    {
+        return false;
+    }
+    setup->CicFactor = (uint8_t) cic;
+    setup->FirFactor = (uint8_t) fir;
+    setup->FirTaps = (uint8_t) taps;
+    setup->PassbandPercent = (uint8_t) passband;
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    DecimationFilter_Setup_T setup = { 19U, 0U, { { 0U } } };
+    static const DecimationFilter_StageSetup_T defaultStage = { 5U, 2U, 15U, 40U };
+    double rateHz = 100.0;
+    double maxRippleDb = 0.5;
+    double minRejectionDb = 60.0;
+    uint32_t block = 20UL;
+    uint32_t samples = 10000000UL;
+    bool isOk = true;
+    uint32_t factor = 1UL;
+    uint8_t stage;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--stage")) && ((arg + 1) < argc) && (setup.Stages < DECIMATION_FILTER_MAX_STAGES) &&
+                BenchParseStage(argv[arg + 1], &setup.Stage[setup.Stages]))
+        {
+            setup.Stages++;
+            arg++;
+        }
+        else if ((0 == strcmp(argv[arg], "--bits")) && ((arg + 1) < argc))
+        {
+            setup.InputBits = (uint8_t) atoi(argv[++arg]);
+        }
+        else if ((0 == strcmp(argv[arg], "--rate")) && ((arg + 1) < argc))
+        {
+            rateHz = atof(argv[++arg]);
+        }
+        else if ((0 == strcmp(argv[arg], "--max-ripple")) && ((arg + 1) < argc))
+        {
+            maxRippleDb = atof(argv[++arg]);
+        }
+        else if ((0 == strcmp(argv[arg], "--min-rejection")) && ((arg + 1) < argc))
+        {
+            minRejectionDb = atof(argv[++arg]);
+        }
+        else if ((0 == strcmp(argv[arg], "--block")) && ((arg + 1) < argc))
+        {
+            block = (uint32_t) strtoul(argv[++arg], NULL, 10);
+        }
+        else if ((0 == strcmp(argv[arg], "--samples")) && ((arg + 1) < argc))
+        {
+            samples = (uint32_t) strtoul(argv[++arg], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "Usage: %s [--stage R,D,taps,passband%%]... [--bits n] [--rate Hz] [--max-ripple dB] "
+                    "[--min-rejection dB] [--block n] [--samples n]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (0U == setup.Stages)
+    {
+        setup.Stages = 2U;
+        setup.Stage[0] = defaultStage;
+        setup.Stage[1] = defaultStage;
+    }
+    if ((0UL == block) || (block > BENCH_MAX_BLOCK) || !DecimationFilter_Design(&BenchBank, &setup) ||
+            (BenchBank.Factors[BenchBank.Stages - 1U] > BENCH_MAX_BLOCK))
+    {
+        fprintf(stderr, "Invalid design or block\n");
+        return 2;
+    }
+
+    for (stage = 0U; stage < BenchBank.Stages; stage++)
+    {
+        const DecimationFilter_StageSetup_T * stageSetup = &BenchBank.Stage[stage].Setup;
+        double outputNyquist = 0.5 / BenchBank.Factors[stage];
+        double passband = outputNyquist * stageSetup->PassbandPercent / 100.0;
+        double rippleDb = 0.0;
+        double worstDb = -200.0;
+        double worstF = 0.0;
+        double deviationDb = 0.0;
+        uint32_t band;
+        uint32_t point;
+
+        printf("Output %u: %.2f Hz -> %.2f Hz (CIC %u, FIR %u x %u taps, CIC shift %u), delay %.1f samples = %.1f ms\n",
+                stage + 1U, rateHz / factor, rateHz / BenchBank.Factors[stage], stageSetup->CicFactor, stageSetup->FirFactor,
+                stageSetup->FirTaps, BenchBank.Stage[stage].CicShift, DecimationFilter_GetDelay(&BenchBank, stage),
+                1000.0 * DecimationFilter_GetDelay(&BenchBank, stage) / rateHz);
+        factor = BenchBank.Factors[stage];
+
+        for (point = 0UL; point <= BENCH_PASSBAND_POINTS; point++)
+        {
+            double gainDb = BenchPoint(setup.InputBits, stage, passband * point / BENCH_PASSBAND_POINTS, &deviationDb);
+
+            rippleDb = fmax(rippleDb, fabs(gainDb));
+        }
+        /* Band n folds [2n fo - fp, 2n fo + fp] onto the passband */
+        for (band = 1UL; ((2.0 * band * outputNyquist) - passband) < 0.5; band++)
+        {
+            for (point = 0UL; point <= BENCH_ALIAS_POINTS; point++)
+            {
+                double f = (2.0 * band * outputNyquist) - passband + (2.0 * passband * point / BENCH_ALIAS_POINTS);
+                double gainDb;
+
+                if (f > 0.5)
+                {
+                    break;
+                }
+                gainDb = BenchPoint(setup.InputBits, stage, f, &deviationDb);
+                if (gainDb > worstDb)
+                {
+                    worstDb = gainDb;
+                    worstF = f;
+                }
+            }
+        }
+        printf("  passband 0 .. %.3f Hz: ripple %.3f dB\n", passband * rateHz, rippleDb);
+        printf("  aliasing into it: rejection %.1f dB, worst at %.3f Hz\n", -worstDb, worstF * rateHz);
+        printf("  largest deviation from the model: %.3f dB\n", deviationDb);
+        if (rippleDb > maxRippleDb)
+        {
+            printf("  FAIL: ripple above %.3f dB\n", maxRippleDb);
+            isOk = false;
+        }
+        if (-worstDb < minRejectionDb)
+        {
+            printf("  FAIL: rejection below %.1f dB\n", minRejectionDb);
+            isOk = false;
+        }
+        if (deviationDb > BENCH_MAX_DEVIATION_DB)
+        {
+            printf("  FAIL: deviation above %.1f dB\n", BENCH_MAX_DEVIATION_DB);
+            isOk = false;
+        }
+    }
+
+    isOk = BenchConstant((int32_t) ldexp(1.0, setup.InputBits - 1U) - 1L) && isOk;
+    isOk = BenchConstant(1L - (int32_t) ldexp(1.0, setup.InputBits - 1U)) && isOk;
+    isOk = BenchConstant(12345L % (int32_t) ldexp(1.0, setup.InputBits - 1U)) && isOk;
+    BenchTime(setup.InputBits, block, samples);
+    printf("%s\n", isOk ? "PASS" : "FAIL");
+    return isOk ? 0 : 1;
+}
@@ -0,0 +1,1089 @@
+/**
+ *  @file
+ *
+ *  @brief Load generator simulating a fleet of XDK110_Dashboard devices
+ *  posting to the ingestion endpoint (DEST_POST_PATH).
+ *
+ *  Every simulated device is a thread running the firmware HttpsSession over
+ *  plain TCP or OpenSSL, and encodes its bodies with the firmware encoders:
+ *  - json: SensorSnapshot_ToJson, one object per sample like
+ *    APP_UPLOAD_ENCODING_JSON; a batch of several samples is posted as a JSON
+ *    array of these objects,
+ *  - compressed: TimeSeriesCompressor blocks of APP_SAMPLE_BATCH_SIZE bytes
+ *    like APP_UPLOAD_ENCODING_COMPRESSED.
+ *  A device takes one synthetic sample per --sample period and posts every
+ *  --batch samples; a batch larger than one body is posted as several bodies
+ *  right away, as the firmware does with a full block. The devices start
+ *  spread over the first period, or all at the same instant with --sync (a
+ *  fleet coming back after a server outage). The schedule is open loop: a
+ *  device which falls behind posts at once and the post counts as late.
+ *
+ *  At the end the tool prints requests/s, the latency percentiles of the
+ *  posts, the body and HTTP bytes per sample and the connections opened.
+ *
+ *  --server runs a local stand-in for the endpoint: a thread per connection,
+ *  HTTP/1.1 keep-alive, optional TLS with a generated certificate, and an
+ *  optional --work delay per request in place of the PHP script and the
+ *  database insert. It decodes every body to count the samples it ingested.
+ *
+ *  Usage: FleetLoadGen [options] host port
+ *         FleetLoadGen --server [--tls [--rsa]] [--work ms] [--idle ms] port
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "HttpsSession.h"
+#include "SensorSnapshot.h"
+#include "TimeSeriesCompressor.h"
+
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+/* constant definitions ***************************************************** */
+
+#define FLEET_MAX_BODY              8192U
+#define FLEET_BLOCK_SIZE            512U  /**< APP_SAMPLE_BATCH_SIZE of the firmware */
+#define FLEET_JSON_SIZE             512U  /**< APP_PAYLOAD_BUFFER_SIZE of the firmware */
+#define FLEET_CIPHER_LIST_SIZE      512
+#define FLEET_THREAD_STACK          (256U * 1024U)
+#define FLEET_MAX_ERRORS_SHOWN      10U
+#define FLEET_REPORT_PERIOD_S       5U
+
+/* local type definitions *************************************************** */
+
+enum FleetEncoding_E
+{
+    FLEET_ENCODING_JSON = 0,
+    FLEET_ENCODING_COMPRESSED
+};
+typedef enum FleetEncoding_E FleetEncoding_T;
+
+enum FleetConnection_E
+{
+    FLEET_CONNECTION_KEEPALIVE = 0, /**< One connection per device, like HttpsAgent */
+    FLEET_CONNECTION_NEW, /**< A new connection and full handshake per post, like HTTPRestClient */
+    FLEET_CONNECTION_RESUME /**< A new connection per post resuming the TLS session */
+};
+typedef enum FleetConnection_E FleetConnection_T;
+
+/**
+ * @brief Fleet configuration, shared read only by all devices.
+ */
+struct FleetConfig_S
+{
+    const char * Host;
+    uint16_t Port;
+    const char * Path;
+    bool IsTls;
+    SSL_CTX * Context;
+    FleetConnection_T Connection;
+    FleetEncoding_T Encoding;
+    uint32_t Devices;
+    uint32_t SampleMs; /**< Sampling period of a device */
+    uint32_t Batch; /**< Samples per post */
+    uint32_t DurationS;
+    bool IsSync;
+    uint64_t StartUs;
+    uint64_t EndUs;
+};
+typedef struct FleetConfig_S FleetConfig_T;
+
+/**
+ * @brief Socket of a client or server connection, with TLS if Ssl is set.
+ */
+struct FleetSocket_S
+{
+    int Socket;
+    SSL * Ssl;
+};
+typedef struct FleetSocket_S FleetSocket_T;
+
+/**
+ * @brief State of the transport of one device.
+ */
+struct FleetTransport_S
+{
+    FleetSocket_T Link;
+    SSL_SESSION * Session; /**< Session to resume, FLEET_CONNECTION_RESUME only */
+    char CipherList[FLEET_CIPHER_LIST_SIZE];
+    uint64_t BytesSent; /**< HTTP bytes, heads and bodies */
+};
+typedef struct FleetTransport_S FleetTransport_T;
+
+/**
+ * @brief One simulated device.
+ */
+struct FleetDevice_S
+{
+    uint32_t Index;
+    pthread_t Thread;
+    FleetTransport_T State;
+    HttpsSession_Transport_T Transport;
+    HttpsSession_T Session;
+    SensorSnapshot_T Snapshot; /**< Latest synthetic sample */
+    bool IsPending; /**< Snapshot did not fit into the previous body and opens the next one */
+    uint32_t Seed;
+    uint8_t Body[FLEET_MAX_BODY];
+    uint32_t * LatenciesUs;
+    uint32_t LatencyCount;
+    uint32_t LatencyCapacity;
+    uint32_t Posts;
+    uint32_t Failures; /**< No complete response */
+    uint32_t Rejected; /**< Response status other than 2xx */
+    uint32_t Late; /**< Posts started more than a period after they were due */
+    uint64_t Samples;
+    uint64_t BodyBytes;
+};
+typedef struct FleetDevice_S FleetDevice_T;
+
+/**
+ * @brief Counters of the stand-in server.
+ */
+struct FleetServerStatistics_S
+{
+    pthread_mutex_t Lock;
+    uint32_t Connections;
+    uint32_t OpenConnections;
+    uint64_t Requests;
+    uint64_t Samples;
+    uint64_t BodyBytes;
+    uint64_t Undecodable; /**< Bodies neither JSON nor a compressed block */
+};
+typedef struct FleetServerStatistics_S FleetServerStatistics_T;
+
+/**
+ * @brief Arguments of a server connection thread.
+ */
+struct FleetServerConnection_S
+{
+    FleetSocket_T Link;
+    uint32_t WorkMs;
+    int IdleMs;
+};
+typedef struct FleetServerConnection_S FleetServerConnection_T;
+
+/* local variables ********************************************************** */
+
+static const HttpsSession_Cipher_T FleetCiphers[] =
+        {
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA,
+        }; /* HTTPS_CIPHER_PREFERENCE of the applications */
+
+static FleetConfig_T FleetConfig;
+
+static FleetServerStatistics_T FleetServerStatistics = { .Lock = PTHREAD_MUTEX_INITIALIZER };
+
+static pthread_mutex_t FleetErrorLock = PTHREAD_MUTEX_INITIALIZER;
+
+static uint32_t FleetErrorsShown = 0U;
+
+/* local functions ********************************************************** */
+
+static uint64_t FleetNowUs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000ULL) + ((uint64_t) now.tv_nsec / 1000ULL);
+}
+
+static uint32_t FleetNowMs(void)
+{
+    return (uint32_t) (FleetNowUs() / 1000ULL);
+}
+
+static void FleetSleepUntil(uint64_t timeUs)
+{
+    uint64_t nowUs = FleetNowUs();
+
+    if (timeUs > nowUs)
+    {
+        struct timespec delay = { .tv_sec = (time_t) ((timeUs - nowUs) / 1000000ULL), .tv_nsec = (long) (((timeUs - nowUs) % 1000000ULL) * 1000ULL) };
+
+        (void) nanosleep(&delay, NULL);
+    }
+}
+
+/**
+ * @brief Prints the first errors of the fleet; hundreds of devices failing the same way would flood the terminal.
+ */
+static void FleetError(const char * format, uint32_t device, uint32_t value)
+{
+    pthread_mutex_lock(&FleetErrorLock);
+    if (FleetErrorsShown < FLEET_MAX_ERRORS_SHOWN)
+    {
+        fprintf(stderr, format, device, value);
+        if (++FleetErrorsShown == FLEET_MAX_ERRORS_SHOWN)
+        {
+            fprintf(stderr, "Further errors are only counted\n");
+        }
+    }
+    pthread_mutex_unlock(&FleetErrorLock);
+}
+
+/**
+ * @brief Disables the Nagle algorithm, see TlsHandshakeBench.
+ */
+static void FleetSetNoDelay(int socketHandle)
+{
+    int isNoDelay = 1;
+
+    (void) setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+}
+
+static bool FleetWrite(FleetSocket_T * link, const uint8_t * data, uint32_t length)
+{
+    ssize_t written;
+
+    if (NULL != link->Ssl)
+    {
+        return ((0U == length) || (SSL_write(link->Ssl, data, (int) length) == (int) length));
+    }
+    while (0U != length)
+    {
+        written = send(link->Socket, data, length, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        length -= (uint32_t) written;
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the number of bytes received, 0 if the peer closed, negative on error or timeout.
+ */
+static int32_t FleetRead(FleetSocket_T * link, uint8_t * buffer, uint32_t size, int timeoutMs)
+{
+    struct pollfd descriptor = { .fd = link->Socket, .events = POLLIN };
+    int received;
+
+    if (((NULL == link->Ssl) || (0 == SSL_pending(link->Ssl))) && (poll(&descriptor, 1, timeoutMs) <= 0))
+    {
+        return -1;
+    }
+    if (NULL == link->Ssl)
+    {
+        return (int32_t) recv(link->Socket, buffer, size, 0);
+    }
+    received = SSL_read(link->Ssl, buffer, (int) size);
+    if (received > 0)
+    {
+        return received;
+    }
+    return (SSL_ERROR_ZERO_RETURN == SSL_get_error(link->Ssl, received)) ? 0 : -1;
+}
+
+static void FleetCloseLink(FleetSocket_T * link)
+{
+    if (NULL != link->Ssl)
+    {
+        (void) SSL_shutdown(link->Ssl);
+        SSL_free(link->Ssl);
+        link->Ssl = NULL;
+    }
+    if (link->Socket >= 0)
+    {
+        close(link->Socket);
+        link->Socket = -1;
+    }
+}
+
+static bool FleetResolve(void * context, const char * host, uint32_t * address)
+{
+    struct addrinfo hints;
+    struct addrinfo * result;
+
+    (void) context;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (0 != getaddrinfo(host, NULL, &hints, &result))
+    {
+        return false;
+    }
+    *address = ntohl(((struct sockaddr_in *) result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+static bool FleetConnect(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount)
+{
+    FleetTransport_T * state = context;
+    struct sockaddr_in serverAddress;
+    size_t length = 0U;
+    uint8_t cipher;
+
+    state->CipherList[0] = '\0';
+    for (cipher = 0U; cipher < cipherCount; cipher++)
+    {
+        length += (size_t) snprintf(&state->CipherList[length], sizeof(state->CipherList) - length, "%s%s", (0U == cipher) ? "" : ":",
+                HttpsSession_GetCipherName(ciphers[cipher]));
+    }
+    state->Link.Socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (state->Link.Socket < 0)
+    {
+        return false;
+    }
+    FleetSetNoDelay(state->Link.Socket);
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(port);
+    serverAddress.sin_addr.s_addr = htonl(address);
+    return (0 == connect(state->Link.Socket, (struct sockaddr *) &serverAddress, sizeof(serverAddress)));
+}
+
+static bool FleetHandshake(void * context, bool * isResumed)
+{
+    FleetTransport_T * state = context;
+
+    state->Link.Ssl = SSL_new(FleetConfig.Context);
+    if ((NULL == state->Link.Ssl) || (1 != SSL_set_cipher_list(state->Link.Ssl, state->CipherList)))
+    {
+        return false;
+    }
+    SSL_set_fd(state->Link.Ssl, state->Link.Socket);
+    if (NULL != state->Session)
+    {
+        SSL_set_session(state->Link.Ssl, state->Session);
+    }
+    if (1 != SSL_connect(state->Link.Ssl))
+    {
+        return false;
+    }
+    *isResumed = (1 == SSL_session_reused(state->Link.Ssl));
+    if (FLEET_CONNECTION_RESUME == FleetConfig.Connection)
+    {
+        SSL_SESSION_free(state->Session);
+        state->Session = SSL_get1_session(state->Link.Ssl);
+    }
+    return true;
+}
+
+static bool FleetSend(void * context, const uint8_t * data, uint32_t length)
+{
+    FleetTransport_T * state = context;
+
+    state->BytesSent += length;
+    return FleetWrite(&state->Link, data, length);
+}
+
+static int32_t FleetReceive(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs)
+{
+    FleetTransport_T * state = context;
+
+    return FleetRead(&state->Link, buffer, size, (int) timeoutMs);
+}
+
+static void FleetClose(void * context)
+{
+    FleetTransport_T * state = context;
+
+    FleetCloseLink(&state->Link);
+}
+
+/**
+ * @brief Advances the synthetic sensor values of a device by one sample period.
+ *
+ * Slow daily curves with a little noise, offset per device, so the compressed
+ * blocks have the size they have on a device in an office.
+ */
+static void FleetNextSample(FleetDevice_T * device)
+{
+    SensorSnapshot_T * sample = &device->Snapshot;
+    double t = (double) sample->TimestampMs / 1000.0;
+    int32_t noise;
+
+    device->Seed = (device->Seed * 1103515245U) + 12345U;
+    noise = (int32_t) ((device->Seed >> 16) % 5U) - 2;
+
+    sample->TimestampMs += FleetConfig.SampleMs + ((((device->Seed >> 8) % 7U) == 0U) ? 1U : 0U);
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = (float) (noise * 0.01);
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = 0.0f;
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = (float) (9.0 + ((noise > 1) ? 1.0 : 0.0));
+    sample->Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = (float) (0.02 + (0.001 * noise));
+    sample->Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (120000.0 + (20000.0 * sin((t / 3600.0) + device->Index)));
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = noise * 61;
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = -noise * 61;
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = 0;
+    sample->Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) (45.0 + (2.0 * sin((t / 1800.0) + device->Index)));
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = 21 + ((noise > 0) ? 1 : 0);
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = -4;
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = -40;
+    sample->Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) (101325.0 + (150.0 * sin((t / 7200.0) + device->Index)));
+    sample->Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) (22000.0 + (1500.0 * sin((t / 5400.0) + device->Index)));
+}
+
+/**
+ * @brief Encodes up to *remaining samples into the body of the device.
+ *
+ * @return Body length, 0 if not even one sample fits.
+ */
+static uint32_t FleetBuildBody(FleetDevice_T * device, uint32_t * remaining, uint32_t * samples)
+{
+    TimeSeriesCompressor_T compressor;
+    char json[FLEET_JSON_SIZE];
+    uint32_t length = 0U;
+    uint32_t jsonLength;
+
+    *samples = 0U;
+    if (FLEET_ENCODING_COMPRESSED == FleetConfig.Encoding)
+    {
+        (void) TimeSeriesCompressor_Init(&compressor, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, device->Body, FLEET_BLOCK_SIZE);
+    }
+    while (0U != *remaining)
+    {
+        if (!device->IsPending)
+        {
+            FleetNextSample(device);
+            device->IsPending = true;
+        }
+        if (FLEET_ENCODING_COMPRESSED == FleetConfig.Encoding)
+        {
+            if (!TimeSeriesCompressor_Append(&compressor, device->Snapshot.TimestampMs, &device->Snapshot.Values[0].Bits))
+            {
+                break;
+            }
+        }
+        else
+        {
+            jsonLength = SensorSnapshot_ToJson(&device->Snapshot, json, sizeof(json));
+            if ((0U == jsonLength) || ((length + jsonLength + 2U) > FLEET_MAX_BODY))
+            {
+                break;
+            }
+            if (1U != FleetConfig.Batch)
+            {
+                device->Body[length] = (0U == length) ? '[' : ',';
+                length++;
+            }
+            memcpy(&device->Body[length], json, jsonLength);
+            length += jsonLength;
+        }
+        device->IsPending = false;
+        (*remaining)--;
+        (*samples)++;
+    }
+    if (FLEET_ENCODING_COMPRESSED == FleetConfig.Encoding)
+    {
+        return (0U != *samples) ? TimeSeriesCompressor_Finish(&compressor) : 0U;
+    }
+    if ((1U != FleetConfig.Batch) && (0U != length))
+    {
+        device->Body[length++] = ']';
+    }
+    return length;
+}
+
+static void FleetRecordLatency(FleetDevice_T * device, uint32_t latencyUs)
+{
+    uint32_t * latencies;
+
+    if (device->LatencyCount == device->LatencyCapacity)
+    {
+        device->LatencyCapacity = (0U != device->LatencyCapacity) ? (2U * device->LatencyCapacity) : 64U;
+        latencies = realloc(device->LatenciesUs, device->LatencyCapacity * sizeof(*latencies));
+        if (NULL == latencies)
+        {
+            return;
+        }
+        device->LatenciesUs = latencies;
+    }
+    device->LatenciesUs[device->LatencyCount++] = latencyUs;
+}
+
+/**
+ * @brief Posts one batch of a device, in as many bodies as it takes.
+ */
+static void FleetPostBatch(FleetDevice_T * device)
+{
+    HttpsSession_Request_T request;
+    HttpsSession_Response_T response;
+    uint8_t responseBody[64];
+    uint32_t remaining = FleetConfig.Batch;
+    uint32_t samples;
+    uint64_t startUs;
+
+    request.Method = "POST";
+    request.Path = FleetConfig.Path;
+    request.ContentType = (FLEET_ENCODING_COMPRESSED == FleetConfig.Encoding) ? "application/octet-stream" : "application/json";
+    request.ExtraHeaders = NULL;
+    request.Body = device->Body;
+    request.WriteBody = NULL;
+    request.BodyContext = NULL;
+    request.IsChunked = false;
+    response.Body = responseBody;
+    response.BodySize = sizeof(responseBody);
+
+    while (0U != remaining)
+    {
+        request.BodyLength = FleetBuildBody(device, &remaining, &samples);
+        if (0U == request.BodyLength)
+        {
+            FleetError("Device %u: a sample does not fit into a body (%u)\n", device->Index, remaining);
+            return;
+        }
+        startUs = FleetNowUs();
+        device->Posts++;
+        if (!HttpsSession_Request(&device->Session, &request, &response))
+        {
+            device->Failures++;
+            FleetError("Device %u: post %u failed\n", device->Index, device->Posts);
+            continue;
+        }
+        FleetRecordLatency(device, (uint32_t) (FleetNowUs() - startUs));
+        if ((response.Status < 200U) || (response.Status > 299U))
+        {
+            device->Rejected++;
+            FleetError("Device %u: post answered %u\n", device->Index, response.Status);
+            continue;
+        }
+        device->Samples += samples;
+        device->BodyBytes += request.BodyLength;
+    }
+}
+
+static void * FleetDeviceRun(void * argument)
+{
+    FleetDevice_T * device = argument;
+    uint64_t periodUs = (uint64_t) FleetConfig.SampleMs * FleetConfig.Batch * 1000ULL;
+    uint64_t dueUs = FleetConfig.StartUs;
+
+    if (!FleetConfig.IsSync)
+    {
+        dueUs += (periodUs * device->Index) / FleetConfig.Devices;
+    }
+    while (dueUs < FleetConfig.EndUs)
+    {
+        FleetSleepUntil(dueUs);
+        if ((FleetNowUs() - dueUs) > periodUs)
+        {
+            device->Late++;
+        }
+        FleetPostBatch(device);
+        dueUs += periodUs;
+    }
+    HttpsSession_Close(&device->Session);
+    return NULL;
+}
+
+static int FleetCompareLatency(const void * left, const void * right)
+{
+    uint32_t leftUs = *(const uint32_t *) left;
+    uint32_t rightUs = *(const uint32_t *) right;
+
+    return (leftUs > rightUs) - (leftUs < rightUs);
+}
+
+static double FleetPercentileMs(const uint32_t * sortedUs, uint32_t count, uint32_t percent)
+{
+    return (0U != count) ? ((double) sortedUs[((uint64_t) (count - 1U) * percent) / 100U] / 1000.0) : 0.0;
+}
+
+static int FleetRun(void)
+{
+    FleetDevice_T * devices = calloc(FleetConfig.Devices, sizeof(*devices));
+    HttpsSession_Setup_T setup;
+    pthread_attr_t attributes;
+    uint32_t * latencies;
+    uint32_t latencyCount = 0U;
+    uint32_t posts = 0U;
+    uint32_t failures = 0U;
+    uint32_t rejected = 0U;
+    uint32_t late = 0U;
+    uint32_t connections = 0U;
+    uint32_t resumed = 0U;
+    uint64_t samples = 0U;
+    uint64_t bodyBytes = 0U;
+    uint64_t httpBytes = 0U;
+    double elapsedS;
+    uint32_t index;
+
+    if (NULL == devices)
+    {
+        return 1;
+    }
+    setup.Host = FleetConfig.Host;
+    setup.Port = FleetConfig.Port;
+    setup.Ciphers = FleetCiphers;
+    setup.CipherCount = (uint8_t) (sizeof(FleetCiphers) / sizeof(FleetCiphers[0]));
+    setup.MaxIdleMs = 0U;
+    setup.MaxRequestsPerConnection = (FLEET_CONNECTION_KEEPALIVE == FleetConfig.Connection) ? 0U : 1U;
+    setup.TimeoutMs = 10000U;
+
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, FLEET_THREAD_STACK);
+    FleetConfig.StartUs = FleetNowUs() + 100000ULL;
+    FleetConfig.EndUs = FleetConfig.StartUs + ((uint64_t) FleetConfig.DurationS * 1000000ULL);
+    for (index = 0U; index < FleetConfig.Devices; index++)
+    {
+        FleetDevice_T * device = &devices[index];
+
+        device->Index = index;
+        device->Seed = 12345U + index;
+        device->Snapshot.TimestampMs = index * 7U;
+        device->State.Link.Socket = -1;
+        device->Transport.Context = &device->State;
+        device->Transport.Resolve = FleetResolve;
+        device->Transport.Connect = FleetConnect;
+        device->Transport.Handshake = FleetConfig.IsTls ? FleetHandshake : NULL;
+        device->Transport.Send = FleetSend;
+        device->Transport.Receive = FleetReceive;
+        device->Transport.Close = FleetClose;
+        device->Transport.NowMs = FleetNowMs;
+        setup.Transport = &device->Transport;
+        if (!HttpsSession_Init(&device->Session, &setup) || (0 != pthread_create(&device->Thread, &attributes, FleetDeviceRun, device)))
+        {
+            fprintf(stderr, "Cannot start device %u\n", index);
+            return 1;
+        }
+    }
+    pthread_attr_destroy(&attributes);
+
+    for (index = 0U; index < FleetConfig.Devices; index++)
+    {
+        const FleetDevice_T * device = &devices[index];
+
+        pthread_join(device->Thread, NULL);
+        posts += device->Posts;
+        failures += device->Failures;
+        rejected += device->Rejected;
+        late += device->Late;
+        connections += device->Session.Statistics.Connections;
+        resumed += device->Session.Statistics.Resumed;
+        samples += device->Samples;
+        bodyBytes += device->BodyBytes;
+        httpBytes += device->State.BytesSent;
+        latencyCount += device->LatencyCount;
+    }
+    elapsedS = (double) (FleetConfig.EndUs - FleetConfig.StartUs) / 1000000.0;
+
+    latencies = malloc(((size_t) latencyCount + 1U) * sizeof(*latencies));
+    latencyCount = 0U;
+    for (index = 0U; index < FleetConfig.Devices; index++)
+    {
+        if (NULL != latencies)
+        {
+            memcpy(&latencies[latencyCount], devices[index].LatenciesUs, devices[index].LatencyCount * sizeof(*latencies));
+            latencyCount += devices[index].LatencyCount;
+        }
+        free(devices[index].LatenciesUs);
+        SSL_SESSION_free(devices[index].State.Session);
+    }
+    qsort(latencies, latencyCount, sizeof(*latencies), FleetCompareLatency);
+
+    printf("%u devices, %s bodies, %u samples per post every %u ms, %s%s, %.1f s\n", FleetConfig.Devices,
+            (FLEET_ENCODING_COMPRESSED == FleetConfig.Encoding) ? "compressed" : "json", FleetConfig.Batch,
+            FleetConfig.SampleMs * FleetConfig.Batch, FleetConfig.IsTls ? "https " : "http ",
+            (FLEET_CONNECTION_KEEPALIVE == FleetConfig.Connection) ? "keep-alive" :
+                    ((FLEET_CONNECTION_NEW == FleetConfig.Connection) ? "new connection per post" : "resumed session per post"),
+            elapsedS);
+    printf("Target %.1f posts/s; posted %u, failed %u, rejected %u, late %u\n",
+            (1000.0 * FleetConfig.Devices) / ((double) FleetConfig.SampleMs * FleetConfig.Batch), posts, failures, rejected, late);
+    printf("Throughput %.1f requests/s, %.1f samples/s\n", (double) latencyCount / elapsedS, (double) samples / elapsedS);
+    printf("Latency ms: p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n", FleetPercentileMs(latencies, latencyCount, 50U),
+            FleetPercentileMs(latencies, latencyCount, 90U), FleetPercentileMs(latencies, latencyCount, 99U),
+            FleetPercentileMs(latencies, latencyCount, 100U));
+    printf("Bytes per sample: body %.1f, HTTP %.1f; connections %u, resumed %u\n",
+            (0U != samples) ? ((double) bodyBytes / samples) : 0.0, (0U != samples) ? ((double) httpBytes / samples) : 0.0, connections, resumed);
+
+    free(latencies);
+    free(devices);
+    return ((0U == failures) && (0U == rejected)) ? 0 : 1;
+}
+
+/**
+ * @brief Counts the samples of a received body: a compressed block, a JSON object or a JSON array of objects.
+ *
+ * @return false if the body is neither.
+ */
+static bool FleetCountSamples(const uint8_t * body, uint32_t length, uint64_t * samples)
+{
+    TimeSeriesDecompressor_T decompressor;
+    uint32_t values[TIMESERIES_COMPRESSOR_MAX_CHANNELS];
+    uint32_t timestampMs;
+    uint32_t offset;
+
+    if (TimeSeriesDecompressor_Init(&decompressor, body, length))
+    {
+        while (TimeSeriesDecompressor_Next(&decompressor, &timestampMs, values))
+        {
+            (*samples)++;
+        }
+        return (decompressor.SampleIndex == decompressor.SampleCount);
+    }
+    if ((0U == length) || (('{' != body[0]) && ('[' != body[0])))
+    {
+        return false;
+    }
+    /* The snapshot objects are flat */
+    for (offset = 0U; offset < length; offset++)
+    {
+        *samples += ('{' == body[offset]) ? 1U : 0U;
+    }
+    return true;
+}
+
+static void * FleetServeConnection(void * argument)
+{
+    static const char body[] = "OK\n";
+    FleetServerConnection_T * connection = argument;
+    HttpMessage_Head_T head;
+    uint8_t buffer[2048];
+    uint8_t received[FLEET_MAX_BODY];
+    char response[256];
+    uint32_t receivedLength = 0U;
+    uint32_t consumed;
+    uint32_t length;
+    uint64_t samples;
+    bool isDecoded;
+    int32_t count;
+
+    HttpMessage_InitHead(&head, false);
+    for (;;)
+    {
+        count = FleetRead(&connection->Link, buffer, sizeof(buffer), connection->IdleMs);
+        if (count <= 0)
+        {
+            break;
+        }
+        consumed = (HTTP_MESSAGE_STATE_BODY == head.State) ? 0U : HttpMessage_ParseHead(&head, buffer, (uint32_t) count);
+        if (HTTP_MESSAGE_STATE_ERROR == head.State)
+        {
+            break;
+        }
+        if (HTTP_MESSAGE_STATE_BODY != head.State)
+        {
+            continue;
+        }
+        length = HttpMessage_ReceiveBody(&head, &buffer[consumed], (uint32_t) count - consumed);
+        if ((receivedLength + length) <= sizeof(received))
+        {
+            memcpy(&received[receivedLength], &buffer[consumed], length);
+        }
+        receivedLength += length;
+        if (!HttpMessage_IsBodyComplete(&head))
+        {
+            continue;
+        }
+        samples = 0U;
+        isDecoded = (receivedLength <= sizeof(received)) && FleetCountSamples(received, receivedLength, &samples);
+        if (0U != connection->WorkMs)
+        {
+            usleep(connection->WorkMs * 1000U);
+        }
+        pthread_mutex_lock(&FleetServerStatistics.Lock);
+        FleetServerStatistics.Requests++;
+        FleetServerStatistics.Samples += samples;
+        FleetServerStatistics.BodyBytes += receivedLength;
+        FleetServerStatistics.Undecodable += isDecoded ? 0U : 1U;
+        pthread_mutex_unlock(&FleetServerStatistics.Lock);
+
+        length = HttpMessage_WriteResponseHead(response, sizeof(response), isDecoded ? 200U : 400U, isDecoded ? "OK" : "Bad Request",
+                "text/plain", sizeof(body) - 1U, head.IsClose);
+        memcpy(&response[length], body, sizeof(body) - 1U);
+        if (!FleetWrite(&connection->Link, (const uint8_t *) response, length + sizeof(body) - 1U) || head.IsClose)
+        {
+            break;
+        }
+        /* Pipelined bytes of the next request are not expected from HttpsSession */
+        HttpMessage_InitHead(&head, false);
+        receivedLength = 0U;
+    }
+    FleetCloseLink(&connection->Link);
+    pthread_mutex_lock(&FleetServerStatistics.Lock);
+    FleetServerStatistics.OpenConnections--;
+    pthread_mutex_unlock(&FleetServerStatistics.Lock);
+    free(connection);
+    return NULL;
+}
+
+/**
+ * @brief Prints the server counters every FLEET_REPORT_PERIOD_S while requests arrive.
+ */
+static void * FleetServerReport(void * argument)
+{
+    FleetServerStatistics_T last = { .Requests = 0U };
+    FleetServerStatistics_T now;
+
+    (void) argument;
+    for (;;)
+    {
+        sleep(FLEET_REPORT_PERIOD_S);
+        pthread_mutex_lock(&FleetServerStatistics.Lock);
+        now.Connections = FleetServerStatistics.Connections;
+        now.OpenConnections = FleetServerStatistics.OpenConnections;
+        now.Requests = FleetServerStatistics.Requests;
+        now.Samples = FleetServerStatistics.Samples;
+        now.BodyBytes = FleetServerStatistics.BodyBytes;
+        now.Undecodable = FleetServerStatistics.Undecodable;
+        pthread_mutex_unlock(&FleetServerStatistics.Lock);
+        if (now.Requests != last.Requests)
+        {
+            printf("Server: %.1f requests/s, %.1f samples/s, %.0f body bytes/s; %u open connections, %u total, %llu requests, %llu undecodable\n",
+                    (double) (now.Requests - last.Requests) / FLEET_REPORT_PERIOD_S, (double) (now.Samples - last.Samples) / FLEET_REPORT_PERIOD_S,
+                    (double) (now.BodyBytes - last.BodyBytes) / FLEET_REPORT_PERIOD_S, now.OpenConnections, now.Connections,
+                    (unsigned long long) now.Requests, (unsigned long long) now.Undecodable);
+            fflush(stdout);
+        }
+        last = now;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Self-signed certificate for the stand-in server, see TlsHandshakeBench.
+ */
+static bool FleetGenerateCertificate(SSL_CTX * context, bool isRsa)
+{
+    EVP_PKEY * key = isRsa ? EVP_RSA_gen(2048) : EVP_EC_gen("P-256");
+    X509 * certificate = X509_new();
+    X509_NAME * name;
+    bool isDone;
+
+    if ((NULL == key) || (NULL == certificate))
+    {
+        return false;
+    }
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 86400L);
+    X509_set_pubkey(certificate, key);
+    name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *) "localhost", -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+    isDone = (0 != X509_sign(certificate, key, EVP_sha256())) && (1 == SSL_CTX_use_certificate(context, certificate)) &&
+            (1 == SSL_CTX_use_PrivateKey(context, key));
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+    return isDone;
+}
+
+static int FleetServer(uint16_t port, bool isTls, bool isRsa, uint32_t workMs, int idleMs)
+{
+    SSL_CTX * context = NULL;
+    FleetServerConnection_T * connection;
+    struct sockaddr_in address;
+    pthread_attr_t attributes;
+    pthread_t thread;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int option = 1;
+    int socketHandle;
+
+    if (isTls)
+    {
+        context = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+        SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_set_session_id_context(context, (const unsigned char *) "FleetLoadGen", 12U);
+        if (!FleetGenerateCertificate(context, isRsa))
+        {
+            ERR_print_errors_fp(stderr);
+            return 1;
+        }
+    }
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((0 != bind(listener, (struct sockaddr *) &address, sizeof(address))) || (0 != listen(listener, SOMAXCONN)))
+    {
+        perror("bind");
+        return 1;
+    }
+    printf("Stand-in endpoint on 127.0.0.1:%u, %s, %u ms work per request\n", (unsigned int) port,
+            isTls ? (isRsa ? "https RSA-2048" : "https ECDSA P-256") : "http", workMs);
+    fflush(stdout);
+    pthread_attr_init(&attributes);
+    pthread_attr_setstacksize(&attributes, FLEET_THREAD_STACK);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    (void) pthread_create(&thread, &attributes, FleetServerReport, NULL);
+    for (;;)
+    {
+        socketHandle = accept(listener, NULL, NULL);
+        if (socketHandle < 0)
+        {
+            continue;
+        }
+        FleetSetNoDelay(socketHandle);
+        connection = calloc(1U, sizeof(*connection));
+        if (NULL == connection)
+        {
+            close(socketHandle);
+            continue;
+        }
+        connection->Link.Socket = socketHandle;
+        connection->WorkMs = workMs;
+        connection->IdleMs = idleMs;
+        if (isTls)
+        {
+            /* The handshake runs in the accepting thread; a slow client delays the next accept, as with a single TLS terminator */
+            connection->Link.Ssl = SSL_new(context);
+            SSL_set_fd(connection->Link.Ssl, socketHandle);
+            if (1 != SSL_accept(connection->Link.Ssl))
+            {
+                FleetCloseLink(&connection->Link);
+                free(connection);
+                continue;
+            }
+        }
+        pthread_mutex_lock(&FleetServerStatistics.Lock);
+        FleetServerStatistics.Connections++;
+        FleetServerStatistics.OpenConnections++;
+        pthread_mutex_unlock(&FleetServerStatistics.Lock);
+        if (0 != pthread_create(&thread, &attributes, FleetServeConnection, connection))
+        {
+            FleetCloseLink(&connection->Link);
+            free(connection);
+            pthread_mutex_lock(&FleetServerStatistics.Lock);
+            FleetServerStatistics.OpenConnections--;
+            pthread_mutex_unlock(&FleetServerStatistics.Lock);
+        }
+    }
+    return 0;
+}
+
+static void FleetUsage(void)
+{
+    fprintf(stderr, "Usage: FleetLoadGen [--devices n] [--sample ms] [--batch samples] [--encoding json|compressed]\n"
+            "                    [--connection keepalive|new|resume] [--duration s] [--sync] [--tls] [--path p] host port\n"
+            "       FleetLoadGen --server [--tls [--rsa]] [--work ms] [--idle ms] port\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    bool isServer = false;
+    bool isRsa = false;
+    uint32_t workMs = 0U;
+    int idleMs = 10000;
+    int argument;
+    int result;
+
+    FleetConfig.Path = "/~ex0eby/sendValuesToDatabase.php"; /* DEST_POST_PATH */
+    FleetConfig.Connection = FLEET_CONNECTION_KEEPALIVE;
+    FleetConfig.Encoding = FLEET_ENCODING_JSON;
+    FleetConfig.Devices = 10U;
+    FleetConfig.SampleMs = 1000U;
+    FleetConfig.Batch = 1U;
+    FleetConfig.DurationS = 10U;
+
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--server"))
+        {
+            isServer = true;
+        }
+        else if (0 == strcmp(argv[argument], "--tls"))
+        {
+            FleetConfig.IsTls = true;
+        }
+        else if (0 == strcmp(argv[argument], "--rsa"))
+        {
+            isRsa = true;
+        }
+        else if (0 == strcmp(argv[argument], "--sync"))
+        {
+            FleetConfig.IsSync = true;
+        }
+        else if (argument + 1 >= argc)
+        {
+            FleetUsage();
+            return 1;
+        }
+        else if (0 == strcmp(argv[argument], "--devices"))
+        {
+            FleetConfig.Devices = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--sample"))
+        {
+            FleetConfig.SampleMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--batch"))
+        {
+            FleetConfig.Batch = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--duration"))
+        {
+            FleetConfig.DurationS = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--encoding"))
+        {
+            FleetConfig.Encoding = (0 == strcmp(argv[++argument], "compressed")) ? FLEET_ENCODING_COMPRESSED : FLEET_ENCODING_JSON;
+        }
+        else if (0 == strcmp(argv[argument], "--connection"))
+        {
+            argument++;
+            FleetConfig.Connection = (0 == strcmp(argv[argument], "new")) ? FLEET_CONNECTION_NEW :
+                    ((0 == strcmp(argv[argument], "resume")) ? FLEET_CONNECTION_RESUME : FLEET_CONNECTION_KEEPALIVE);
+        }
+        else if (0 == strcmp(argv[argument], "--path"))
+        {
+            FleetConfig.Path = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--work"))
+        {
+            workMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--idle"))
+        {
+            idleMs = atoi(argv[++argument]);
+        }
+        else
+        {
+            FleetUsage();
+            return 1;
+        }
+    }
+    if (isServer)
+    {
+        if (argument + 1 != argc)
+        {
+            FleetUsage();
+            return 1;
+        }
+        return FleetServer((uint16_t) atoi(argv[argument]), FleetConfig.IsTls, isRsa, workMs, idleMs);
+    }
+    if ((argument + 2 != argc) || (0U == FleetConfig.Devices) || (0U == FleetConfig.SampleMs) || (0U == FleetConfig.Batch))
+    {
+        FleetUsage();
+        return 1;
+    }
+    FleetConfig.Host = argv[argument];
+    FleetConfig.Port = (uint16_t) atoi(argv[argument + 1]);
+    if (FleetConfig.IsTls)
+    {
+        /* The stand-in certificate is self-signed, it is not verified */
+        FleetConfig.Context = SSL_CTX_new(TLS_client_method());
+        SSL_CTX_set_max_proto_version(FleetConfig.Context, TLS1_2_VERSION);
+        SSL_CTX_set_session_cache_mode(FleetConfig.Context, SSL_SESS_CACHE_CLIENT);
+    }
+    result = FleetRun();
+    SSL_CTX_free(FleetConfig.Context);
+    return result;
+}
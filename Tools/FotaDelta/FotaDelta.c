@@ -0,0 +1,512 @@
+/**
+ *  @file
+ *
+ *  @brief Creates and checks the firmware delta patches of XDK110_Dashboard
+ *  (APP_DELTA_FOTA_ENABLE).
+ *
+ *  Compares two builds (debug/XDK110_Dashboard.bin) and writes the DeltaPatch
+ *  which turns the old one into the new one. Matches are found through a
+ *  hash of every 8 bytes of the old image and extended over differing bytes
+ *  as long as most bytes still match, as bsdiff does: code which moved
+ *  differs from its old copy in a few addresses only, which the patch then
+ *  carries as differences in an ADD instead of the whole code in an INSERT.
+ *  The device has no decompressor, so the unchanged runs inside an ADD are
+ *  coded as counts instead of the zero differences bsdiff leaves to bzip2.
+ *
+ *  The patch is then applied with the firmware decoder in blocks of the
+ *  download size, the decoder state copied and restored after each block as
+ *  DeltaFotaAgent does through its state file, and the result compared with
+ *  the new image. The report gives the patch size against the full image,
+ *  in bytes and in download blocks.
+ *
+ *  Usage: FotaDelta [--block bytes] old.bin new.bin [patch.xdp]
+ *         FotaDelta --apply [--block bytes] old.bin patch.xdp new.bin
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "DeltaPatch.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define FOTA_BLOCK_SIZE         1024U   /**< DELTA_FOTA_AGENT_BLOCK_SIZE */
+#define FOTA_HASH_BITS          20U
+#define FOTA_SEED_SIZE          8U      /**< Bytes hashed to find match candidates */
+#define FOTA_MAX_CANDIDATES     64U     /**< Old positions tried per hash */
+#define FOTA_MIN_SCORE          16      /**< Matching minus differing bytes a match must reach */
+#define FOTA_SLACK              24      /**< Score drop which ends a match */
+
+/* local types ************************************************************** */
+
+struct FotaBuffer_S
+{
+    uint8_t * Data;
+    uint32_t Length;
+    uint32_t Size;
+};
+typedef struct FotaBuffer_S FotaBuffer_T;
+
+/**
+ * @brief Commands of a patch, for the report.
+ */
+struct FotaStatistics_S
+{
+    uint32_t Adds;
+    uint32_t AddBytes;
+    uint32_t ChangedBytes;
+    uint32_t Inserts;
+    uint32_t InsertBytes;
+    uint32_t Seeks;
+};
+typedef struct FotaStatistics_S FotaStatistics_T;
+
+/**
+ * @brief Images of DeltaPatch_Io_T.
+ */
+struct FotaImages_S
+{
+    const FotaBuffer_T * Old;
+    FotaBuffer_T * New;
+};
+typedef struct FotaImages_S FotaImages_T;
+
+/* local functions ********************************************************** */
+
+static bool FotaLoad(const char * path, FotaBuffer_T * buffer)
+{
+    FILE * file = fopen(path, "rb");
+    long size;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return false;
+    }
+    fseek(file, 0L, SEEK_END);
+    size = ftell(file);
+    fseek(file, 0L, SEEK_SET);
+    buffer->Size = (uint32_t) size + 1U;
+    buffer->Data = malloc(buffer->Size);
+    buffer->Length = (uint32_t) fread(buffer->Data, 1U, (size_t) size, file);
+    fclose(file);
+    return ((long) buffer->Length == size);
+}
+
+static bool FotaSave(const char * path, const FotaBuffer_T * buffer)
+{
+    FILE * file = fopen(path, "wb");
+    bool isOk;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return false;
+    }
+    isOk = (buffer->Length == fwrite(buffer->Data, 1U, buffer->Length, file));
+    fclose(file);
+    return isOk;
+}
+
+static void FotaAppend(FotaBuffer_T * buffer, const uint8_t * data, uint32_t length)
+{
+    if ((buffer->Length + length) > buffer->Size)
+    {
+        buffer->Size = 2U * (buffer->Length + length);
+        buffer->Data = realloc(buffer->Data, buffer->Size);
+    }
+    memcpy(&buffer->Data[buffer->Length], data, length);
+    buffer->Length += length;
+}
+
+static void FotaAppendNumber(FotaBuffer_T * buffer, uint32_t number)
+{
+    uint8_t group;
+
+    do
+    {
+        group = (uint8_t) (number & 0x7FU);
+        number >>= 7;
+        if (0U != number)
+        {
+            group |= 0x80U;
+        }
+        FotaAppend(buffer, &group, 1U);
+    } while (0U != number);
+}
+
+static void FotaAppendCommand(FotaBuffer_T * buffer, uint8_t opcode, uint32_t number)
+{
+    FotaAppend(buffer, &opcode, 1U);
+    FotaAppendNumber(buffer, number);
+}
+
+static uint32_t FotaHash(const uint8_t * data)
+{
+    uint64_t value;
+
+    memcpy(&value, data, sizeof(value));
+    return (uint32_t) ((value * UINT64_C(0x9E3779B97F4A7C15)) >> (64U - FOTA_HASH_BITS));
+}
+
+static uint32_t FotaMatchLength(const FotaBuffer_T * old, uint32_t oldPosition, const FotaBuffer_T * new, uint32_t newPosition)
+{
+    uint32_t length = 0U;
+
+    while (((oldPosition + length) < old->Length) && ((newPosition + length) < new->Length) &&
+            (old->Data[oldPosition + length] == new->Data[newPosition + length]))
+    {
+        length++;
+    }
+    return length;
+}
+
+/**
+ * @brief Extends a match over differing bytes while the matching ones outweigh them.
+ *
+ * @return Length of the match with the best score.
+ */
+static uint32_t FotaExtend(const FotaBuffer_T * old, uint32_t oldPosition, const FotaBuffer_T * new, uint32_t newPosition, int * bestScore)
+{
+    uint32_t length = 0U;
+    uint32_t bestLength = 0U;
+    int score = 0;
+
+    *bestScore = 0;
+    while (((oldPosition + length) < old->Length) && ((newPosition + length) < new->Length))
+    {
+        score += (old->Data[oldPosition + length] == new->Data[newPosition + length]) ? 1 : -1;
+        length++;
+        if (score > *bestScore)
+        {
+            *bestScore = score;
+            bestLength = length;
+        }
+        else if (score < (*bestScore - FOTA_SLACK))
+        {
+            break;
+        }
+    }
+    return bestLength;
+}
+
+/**
+ * @brief Writes an ADD: unchanged runs as counts, changed runs with their differences.
+ */
+static void FotaAppendAdd(FotaBuffer_T * patch, const FotaBuffer_T * old, uint32_t oldPosition, const FotaBuffer_T * new,
+        uint32_t newPosition, uint32_t length, FotaStatistics_T * statistics)
+{
+    const uint8_t * oldData = &old->Data[oldPosition];
+    const uint8_t * newData = &new->Data[newPosition];
+    uint32_t index = 0U;
+    uint32_t start;
+    uint32_t zeros;
+    uint8_t difference;
+
+    FotaAppendCommand(patch, DELTA_PATCH_OP_ADD, length);
+    statistics->Adds++;
+    statistics->AddBytes += length;
+    while (index < length)
+    {
+        start = index;
+        while ((index < length) && (oldData[index] == newData[index]))
+        {
+            index++;
+        }
+        FotaAppendNumber(patch, index - start);
+        if (index == length)
+        {
+            break;
+        }
+        /* A changed run takes short unchanged gaps along, two counts would cost more */
+        start = index;
+        while (index < length)
+        {
+            for (zeros = 0U; ((index + zeros) < length) && (oldData[index + zeros] == newData[index + zeros]); zeros++)
+            {
+            }
+            if ((zeros >= 3U) || ((index + zeros) == length))
+            {
+                break;
+            }
+            index += (0U != zeros) ? zeros : 1U;
+        }
+        FotaAppendNumber(patch, index - start);
+        statistics->ChangedBytes += index - start;
+        for (; start < index; start++)
+        {
+            difference = (uint8_t) (newData[start] - oldData[start]);
+            FotaAppend(patch, &difference, 1U);
+        }
+    }
+}
+
+static void FotaAppendInsert(FotaBuffer_T * patch, const FotaBuffer_T * new, uint32_t start, uint32_t end, FotaStatistics_T * statistics)
+{
+    if (end > start)
+    {
+        FotaAppendCommand(patch, DELTA_PATCH_OP_INSERT, end - start);
+        FotaAppend(patch, &new->Data[start], end - start);
+        statistics->Inserts++;
+        statistics->InsertBytes += end - start;
+    }
+}
+
+/**
+ * @brief Creates the patch from old to new.
+ */
+static void FotaDiff(const FotaBuffer_T * old, const FotaBuffer_T * new, FotaBuffer_T * patch, FotaStatistics_T * statistics)
+{
+    int32_t * heads = malloc(sizeof(int32_t) << FOTA_HASH_BITS);
+    int32_t * chain = malloc(sizeof(int32_t) * (old->Length + 1U));
+    DeltaPatch_Header_T header;
+    uint32_t hash;
+    uint32_t position;
+    uint32_t newPosition = 0U;
+    uint32_t insertStart = 0U;
+    uint32_t oldCursor = 0U;
+    uint32_t candidate;
+    uint32_t candidates;
+    uint32_t length;
+    uint32_t bestPosition;
+    uint32_t bestLength;
+    uint32_t exactLength;
+    int32_t distance;
+    int bestScore;
+    int score;
+    uint8_t opcode;
+
+    memset(heads, 0xFF, sizeof(int32_t) << FOTA_HASH_BITS);
+    for (position = 0U; (position + FOTA_SEED_SIZE) <= old->Length; position++)
+    {
+        hash = FotaHash(&old->Data[position]);
+        chain[position] = heads[hash];
+        heads[hash] = (int32_t) position;
+    }
+
+    patch->Size = new->Length + 1024U;
+    patch->Data = malloc(patch->Size);
+    patch->Length = DELTA_PATCH_HEADER_SIZE;
+    memset(statistics, 0, sizeof(*statistics));
+
+    while ((newPosition + FOTA_SEED_SIZE) <= new->Length)
+    {
+        /* The old bytes right after the last match, as if the new bytes since replaced as many old ones */
+        bestPosition = oldCursor + (newPosition - insertStart);
+        bestLength = 0U;
+        bestScore = 0;
+        if (bestPosition < old->Length)
+        {
+            bestLength = FotaExtend(old, bestPosition, new, newPosition, &bestScore);
+        }
+        /* Of the hashed candidates only the longest exact match is extended */
+        exactLength = 0U;
+        candidate = UINT32_MAX;
+        candidates = 0U;
+        for (distance = heads[FotaHash(&new->Data[newPosition])]; (distance >= 0) && (candidates < FOTA_MAX_CANDIDATES);
+                distance = chain[distance], candidates++)
+        {
+            length = FotaMatchLength(old, (uint32_t) distance, new, newPosition);
+            if (length > exactLength)
+            {
+                exactLength = length;
+                candidate = (uint32_t) distance;
+            }
+        }
+        if ((exactLength >= FOTA_SEED_SIZE) && (candidate != bestPosition))
+        {
+            length = FotaExtend(old, candidate, new, newPosition, &score);
+            if (score > bestScore)
+            {
+                bestScore = score;
+                bestLength = length;
+                bestPosition = candidate;
+            }
+        }
+        if (bestScore < FOTA_MIN_SCORE)
+        {
+            newPosition++;
+            continue;
+        }
+        while ((newPosition > insertStart) && (bestPosition > 0U) && (old->Data[bestPosition - 1U] == new->Data[newPosition - 1U]))
+        {
+            newPosition--;
+            bestPosition--;
+            bestLength++;
+        }
+        FotaAppendInsert(patch, new, insertStart, newPosition, statistics);
+        if (bestPosition != oldCursor)
+        {
+            distance = (int32_t) (bestPosition - oldCursor);
+            FotaAppendCommand(patch, DELTA_PATCH_OP_SEEK, ((uint32_t) distance << 1) ^ (uint32_t) (distance >> 31));
+            statistics->Seeks++;
+        }
+        FotaAppendAdd(patch, old, bestPosition, new, newPosition, bestLength, statistics);
+        newPosition += bestLength;
+        oldCursor = bestPosition + bestLength;
+        insertStart = newPosition;
+    }
+    FotaAppendInsert(patch, new, insertStart, new->Length, statistics);
+    opcode = DELTA_PATCH_OP_END;
+    FotaAppend(patch, &opcode, 1U);
+
+    header.PatchSize = patch->Length;
+    header.OldSize = old->Length;
+    header.OldCrc = DeltaPatch_Crc32(0U, old->Data, old->Length);
+    header.NewSize = new->Length;
+    header.NewCrc = DeltaPatch_Crc32(0U, new->Data, new->Length);
+    DeltaPatch_WriteHeader(&header, patch->Data);
+    free(heads);
+    free(chain);
+}
+
+static bool FotaReadOld(void * context, uint32_t offset, uint8_t * buffer, uint32_t length)
+{
+    const FotaImages_T * images = context;
+
+    if ((offset > images->Old->Length) || (length > (images->Old->Length - offset)))
+    {
+        return false;
+    }
+    memcpy(buffer, &images->Old->Data[offset], length);
+    return true;
+}
+
+static bool FotaWriteNew(void * context, const uint8_t * data, uint32_t length)
+{
+    FotaImages_T * images = context;
+
+    FotaAppend(images->New, data, length);
+    return true;
+}
+
+/**
+ * @brief Applies a patch block by block, restoring a saved decoder before each block.
+ *
+ * @return false if the patch does not apply to old.
+ */
+static bool FotaApply(const FotaBuffer_T * old, const FotaBuffer_T * patch, uint32_t blockSize, FotaBuffer_T * new)
+{
+    DeltaPatch_Header_T header;
+    DeltaPatch_Decoder_T decoder;
+    uint8_t savedState[sizeof(DeltaPatch_Decoder_T)];
+    FotaImages_T images = { .Old = old, .New = new };
+    DeltaPatch_Io_T io = { .Context = &images, .ReadOld = FotaReadOld, .WriteNew = FotaWriteNew };
+    uint32_t offset;
+    uint32_t length;
+
+    new->Length = 0U;
+    if ((patch->Length < DELTA_PATCH_HEADER_SIZE) || !DeltaPatch_ParseHeader(patch->Data, &header) || (header.PatchSize != patch->Length))
+    {
+        fprintf(stderr, "Not a patch, or truncated\n");
+        return false;
+    }
+    if ((header.OldSize != old->Length) || (header.OldCrc != DeltaPatch_Crc32(0U, old->Data, old->Length)))
+    {
+        fprintf(stderr, "The patch is for another old image (%u bytes, CRC 0x%08x)\n", header.OldSize, header.OldCrc);
+        return false;
+    }
+    DeltaPatch_InitDecoder(&decoder, &header);
+    for (offset = DELTA_PATCH_HEADER_SIZE; offset < patch->Length; offset += length)
+    {
+        memcpy(savedState, &decoder, sizeof(savedState));
+        memset(&decoder, 0xA5, sizeof(decoder));
+        memcpy(&decoder, savedState, sizeof(decoder));
+        length = ((patch->Length - offset) < blockSize) ? (patch->Length - offset) : blockSize;
+        if (!DeltaPatch_Decode(&decoder, &patch->Data[offset], length, &io))
+        {
+            fprintf(stderr, "Patch rejected in the block at %u, new image at %u\n", offset, decoder.NewPosition);
+            return false;
+        }
+    }
+    if (DELTA_PATCH_STATE_DONE != decoder.State)
+    {
+        fprintf(stderr, "Patch ends without END\n");
+        return false;
+    }
+    return true;
+}
+
+static uint32_t FotaBlocks(uint32_t bytes, uint32_t blockSize)
+{
+    return (bytes + blockSize - 1U) / blockSize;
+}
+
+static void FotaUsage(void)
+{
+    fprintf(stderr, "Usage: FotaDelta [--block bytes] old.bin new.bin [patch.xdp]\n"
+            "       FotaDelta --apply [--block bytes] old.bin patch.xdp new.bin\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    FotaBuffer_T old;
+    FotaBuffer_T new;
+    FotaBuffer_T patch;
+    FotaBuffer_T result = { .Data = NULL, .Length = 0U, .Size = 0U };
+    FotaStatistics_T statistics;
+    uint32_t blockSize = FOTA_BLOCK_SIZE;
+    bool isApply = false;
+    int argument;
+
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--apply"))
+        {
+            isApply = true;
+        }
+        else if ((0 == strcmp(argv[argument], "--block")) && ((argument + 1) < argc))
+        {
+            blockSize = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else
+        {
+            argument = argc;
+        }
+    }
+    if ((0U == blockSize) || (isApply && ((argument + 3) != argc)) || (!isApply && ((argument + 2) != argc) && ((argument + 3) != argc)))
+    {
+        FotaUsage();
+        return 1;
+    }
+
+    if (isApply)
+    {
+        if (!FotaLoad(argv[argument], &old) || !FotaLoad(argv[argument + 1], &patch) || !FotaApply(&old, &patch, blockSize, &result) ||
+                !FotaSave(argv[argument + 2], &result))
+        {
+            return 1;
+        }
+        printf("%s: %u bytes, CRC 0x%08x\n", argv[argument + 2], result.Length, DeltaPatch_Crc32(0U, result.Data, result.Length));
+        return 0;
+    }
+
+    if (!FotaLoad(argv[argument], &old) || !FotaLoad(argv[argument + 1], &new))
+    {
+        return 1;
+    }
+    FotaDiff(&old, &new, &patch, &statistics);
+    if (((argument + 3) == argc) && !FotaSave(argv[argument + 2], &patch))
+    {
+        return 1;
+    }
+    printf("Image %8u bytes, %5u blocks of %u bytes\n", new.Length, FotaBlocks(new.Length, blockSize), blockSize);
+    printf("Patch %8u bytes, %5u blocks, %.1f %% of the image\n", patch.Length, FotaBlocks(patch.Length, blockSize),
+            (100.0 * patch.Length) / new.Length);
+    printf("  %u ADD of %u bytes, %u of them changed; %u INSERT of %u bytes; %u SEEK\n", statistics.Adds, statistics.AddBytes,
+            statistics.ChangedBytes, statistics.Inserts, statistics.InsertBytes, statistics.Seeks);
+    if (!FotaApply(&old, &patch, blockSize, &result) || (result.Length != new.Length) || (0 != memcmp(result.Data, new.Data, new.Length)))
+    {
+        printf("Applied in %u byte blocks: MISMATCH\n", blockSize);
+        return 1;
+    }
+    printf("Applied in %u byte blocks, resumed after each, decoder state %u bytes: new image rebuilt\n", blockSize,
+            (unsigned int) sizeof(DeltaPatch_Decoder_T));
+    return 0;
+}
@@ -0,0 +1,675 @@
+/**
+ *  @file
+ *
+ *  @brief Serves the live view of XDK110_Dashboard (APP_LIVE_VIEW_ENABLE) on
+ *  the host, and load-tests an HTTP server with concurrent clients.
+ *
+ *  The server runs the firmware LiveView the way LiveViewAgent does: one
+ *  thread waits in poll() on the listen socket and the connections, keeps
+ *  them open for further requests, closes them after --idle ms without one
+ *  and answers a client beyond --connections with 503. A synthetic snapshot
+ *  is added every --period ms; --period 0 adds one before every request, so
+ *  every response is rendered again, to compare with the cached responses.
+ *  On exit (--seconds, or Ctrl-C) it prints the counters of the agent report.
+ *
+ *  --bench keeps --clients keep-alive connections busy with GET requests for
+ *  --seconds and prints the requests per second, the status codes and the
+ *  latency percentiles; --close opens a connection per request. It works
+ *  against the device as well, or use wrk or ab.
+ *
+ *  Usage: LiveViewServer [--connections n] [--idle ms] [--history n] [--period ms] [--seconds s] port
+ *         LiveViewServer --bench [--clients n] [--seconds s] [--close] host port path
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "LiveView.h"
+
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* constant definitions ***************************************************** */
+
+#define LIVE_MAX_CONNECTIONS        4U      /**< LIVE_VIEW_AGENT_MAX_CONNECTIONS */
+#define LIVE_HISTORY_LENGTH         20U     /**< LIVE_VIEW_AGENT_HISTORY_LENGTH */
+#define LIVE_MAX_HISTORY            200U
+#define LIVE_POLL_MS                100     /**< LIVE_VIEW_AGENT_POLL_MS */
+#define LIVE_RECEIVE_SIZE           128U    /**< Receive buffer of the agent */
+#define LIVE_MAX_CLIENTS            256U
+#define LIVE_BENCH_RECEIVE_SIZE     16384U
+
+/**
+ * @brief Server connection, as AgentConnection_T.
+ */
+struct LiveConnection_S
+{
+    int Socket; /**< -1 for a free slot */
+    uint32_t ActiveMs;
+    HttpMessage_Head_T Head;
+};
+typedef struct LiveConnection_S LiveConnection_T;
+
+/**
+ * @brief Benchmark client.
+ */
+struct LiveClient_S
+{
+    int Socket;
+    uint64_t SentUs; /**< Time the request went out */
+    HttpMessage_Head_T Head; /**< Response being received */
+};
+typedef struct LiveClient_S LiveClient_T;
+
+/* local variables ********************************************************** */
+
+static volatile sig_atomic_t LiveIsStopped = 0;
+
+static LiveView_T LiveView;
+
+static SensorSnapshot_T LiveHistory[LIVE_MAX_HISTORY];
+
+static char LiveLatestBuffer[LIVE_VIEW_LATEST_SIZE];
+
+static char LiveHistoryBuffer[LIVE_VIEW_HISTORY_SIZE(LIVE_MAX_HISTORY)];
+
+static LiveConnection_T LiveConnections[LIVE_MAX_CONNECTIONS];
+
+static uint32_t LiveOpenConnections = 0U;
+
+static uint32_t LiveSnapshots = 0U;
+
+static uint32_t LiveAccepted = 0U;
+
+static uint32_t LiveRefused = 0U;
+
+static uint32_t LiveTimeouts = 0U;
+
+static uint32_t LiveFailures = 0U;
+
+static uint32_t LivePeakConnections = 0U;
+
+static uint64_t LiveBytesSent = 0U;
+
+static uint32_t * LiveLatencies = NULL;
+
+static uint32_t LiveLatencyCount = 0U;
+
+static uint32_t LiveLatencySize = 0U;
+
+/* local functions ********************************************************** */
+
+static uint64_t LiveNowUs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000U) + ((uint64_t) now.tv_nsec / 1000U);
+}
+
+static uint32_t LiveNowMs(void)
+{
+    return (uint32_t) (LiveNowUs() / 1000U);
+}
+
+static void LiveStop(int signalNumber)
+{
+    (void) signalNumber;
+    LiveIsStopped = 1;
+}
+
+static bool LiveWrite(int socketHandle, const char * data, uint32_t length)
+{
+    ssize_t written;
+
+    while (0U != length)
+    {
+        written = send(socketHandle, data, length, MSG_NOSIGNAL);
+        if (written <= 0)
+        {
+            return false;
+        }
+        LiveBytesSent += (uint64_t) written;
+        data += written;
+        length -= (uint32_t) written;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds the next synthetic snapshot: slow waves around plausible readings, in the raw units of the sensors.
+ */
+static void LiveAddSnapshot(void)
+{
+    SensorSnapshot_T snapshot;
+    uint8_t channel;
+    double phase;
+
+    LiveSnapshots++;
+    snapshot.TimestampMs = LiveSnapshots * 1000U;
+    for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        phase = sin(((double) LiveSnapshots / 30.0) + channel);
+        if (0U != (SENSOR_SNAPSHOT_FLOAT_MASK & (1U << channel)))
+        {
+            snapshot.Values[channel].Float = (float) ((SENSOR_SNAPSHOT_ACCELEROMETER_Z == channel) ? (9.81 + (0.2 * phase)) : (0.5 * phase));
+        }
+        else
+        {
+            snapshot.Values[channel].Int = (int32_t) ((SENSOR_SNAPSHOT_PRESSURE == channel) ? (101325.0 + (300.0 * phase)) :
+                    (SENSOR_SNAPSHOT_TEMPERATURE == channel) ? (22500.0 + (2000.0 * phase)) : (1000.0 * phase));
+        }
+    }
+    (void) LiveView_Update(&LiveView, &snapshot);
+}
+
+static void LiveClose(LiveConnection_T * connection)
+{
+    close(connection->Socket);
+    connection->Socket = -1;
+    LiveOpenConnections--;
+}
+
+static void LiveAccept(int listener, uint32_t maxConnections)
+{
+    const char * response;
+    uint32_t length;
+    uint32_t index;
+    int socketHandle = accept(listener, NULL, NULL);
+    int isNoDelay = 1;
+
+    if (socketHandle < 0)
+    {
+        return;
+    }
+    (void) setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+    if (LiveOpenConnections >= maxConnections)
+    {
+        LiveView_RespondStatus(&LiveView, 503U, true, &response, &length);
+        (void) LiveWrite(socketHandle, response, length);
+        close(socketHandle);
+        LiveRefused++;
+        return;
+    }
+    for (index = 0U; LiveConnections[index].Socket >= 0; index++)
+    {
+    }
+    LiveConnections[index].Socket = socketHandle;
+    LiveConnections[index].ActiveMs = LiveNowMs();
+    HttpMessage_InitHead(&LiveConnections[index].Head, false);
+    LiveOpenConnections++;
+    LiveAccepted++;
+    if (LiveOpenConnections > LivePeakConnections)
+    {
+        LivePeakConnections = LiveOpenConnections;
+    }
+}
+
+/**
+ * @brief Reads what a client sent and answers its complete request heads, as AgentReceive.
+ */
+static void LiveReceive(LiveConnection_T * connection, bool isRenderEach)
+{
+    uint8_t buffer[LIVE_RECEIVE_SIZE];
+    const char * response;
+    uint32_t length;
+    uint32_t offset = 0U;
+    ssize_t received = recv(connection->Socket, buffer, sizeof(buffer), 0);
+    bool isClose;
+
+    if (received <= 0)
+    {
+        if (received < 0)
+        {
+            LiveFailures++;
+        }
+        LiveClose(connection);
+        return;
+    }
+    connection->ActiveMs = LiveNowMs();
+    while (offset < (uint32_t) received)
+    {
+        offset += HttpMessage_ParseHead(&connection->Head, &buffer[offset], (uint32_t) received - offset);
+        if ((HTTP_MESSAGE_STATE_BODY != connection->Head.State) && (HTTP_MESSAGE_STATE_ERROR != connection->Head.State))
+        {
+            continue;
+        }
+        if (isRenderEach)
+        {
+            LiveAddSnapshot();
+        }
+        LiveView_Respond(&LiveView, &connection->Head, &response, &length);
+        isClose = (HTTP_MESSAGE_STATE_ERROR == connection->Head.State) || connection->Head.IsClose || connection->Head.IsChunked ||
+                (connection->Head.HasContentLength && (0U != connection->Head.ContentLength));
+        if (!LiveWrite(connection->Socket, response, length))
+        {
+            LiveFailures++;
+            isClose = true;
+        }
+        if (isClose)
+        {
+            LiveClose(connection);
+            return;
+        }
+        HttpMessage_InitHead(&connection->Head, false);
+    }
+}
+
+static void LiveReport(void)
+{
+    const LiveView_Statistics_T * view = LiveView_GetStatistics(&LiveView);
+
+    printf("%u connections, %u refused, %u timed out, %u failed, peak %u open, %llu bytes sent\n", LiveAccepted, LiveRefused,
+            LiveTimeouts, LiveFailures, LivePeakConnections, (unsigned long long) LiveBytesSent);
+    printf("%u snapshots, %u requests, %u from cache, %u renders, %u errors, %u overflows\n", LiveSnapshots, view->Requests,
+            view->CacheHits, view->Renders, view->Errors, view->Overflows);
+    printf("response buffers: latest %u of %u bytes, history %u of %u bytes\n",
+            LiveView.Caches[LIVE_VIEW_RESOURCE_LATEST].Offset + LiveView.Caches[LIVE_VIEW_RESOURCE_LATEST].Length,
+            LiveView.Caches[LIVE_VIEW_RESOURCE_LATEST].Size,
+            LiveView.Caches[LIVE_VIEW_RESOURCE_HISTORY].Offset + LiveView.Caches[LIVE_VIEW_RESOURCE_HISTORY].Length,
+            LiveView.Caches[LIVE_VIEW_RESOURCE_HISTORY].Size);
+}
+
+static int LiveServe(uint16_t port, uint32_t maxConnections, uint32_t idleMs, uint32_t historyLength, uint32_t periodMs, uint32_t seconds)
+{
+    struct pollfd descriptors[LIVE_MAX_CONNECTIONS + 1U];
+    LiveConnection_T * polled[LIVE_MAX_CONNECTIONS + 1U];
+    struct sockaddr_in address;
+    LiveView_Setup_T setup;
+    uint32_t startMs = LiveNowMs();
+    uint32_t snapshotMs = startMs;
+    uint32_t count;
+    uint32_t index;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int option = 1;
+
+    setup.History = LiveHistory;
+    setup.HistoryLength = historyLength;
+    setup.LatestBuffer = LiveLatestBuffer;
+    setup.LatestSize = sizeof(LiveLatestBuffer);
+    setup.HistoryBuffer = LiveHistoryBuffer;
+    setup.HistorySize = LIVE_VIEW_HISTORY_SIZE(historyLength);
+    if (!LiveView_Init(&LiveView, &setup))
+    {
+        return 1;
+    }
+    for (index = 0U; index < LIVE_MAX_CONNECTIONS; index++)
+    {
+        LiveConnections[index].Socket = -1;
+    }
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    if ((0 != bind(listener, (struct sockaddr *) &address, sizeof(address))) || (0 != listen(listener, SOMAXCONN)))
+    {
+        perror("bind");
+        return 1;
+    }
+    signal(SIGINT, LiveStop);
+    signal(SIGTERM, LiveStop);
+    printf("Serving http://127.0.0.1:%u/latest and /history, %u connections, %u snapshots of history\n", (unsigned int) port,
+            maxConnections, historyLength);
+    fflush(stdout);
+    LiveAddSnapshot();
+
+    while (!LiveIsStopped && ((0U == seconds) || ((LiveNowMs() - startMs) < (seconds * 1000U))))
+    {
+        if ((0U != periodMs) && ((LiveNowMs() - snapshotMs) >= periodMs))
+        {
+            snapshotMs += periodMs;
+            LiveAddSnapshot();
+        }
+        descriptors[0].fd = listener;
+        descriptors[0].events = POLLIN;
+        count = 1U;
+        for (index = 0U; index < LIVE_MAX_CONNECTIONS; index++)
+        {
+            if (LiveConnections[index].Socket >= 0)
+            {
+                descriptors[count].fd = LiveConnections[index].Socket;
+                descriptors[count].events = POLLIN;
+                polled[count] = &LiveConnections[index];
+                count++;
+            }
+        }
+        if (poll(descriptors, count, LIVE_POLL_MS) > 0)
+        {
+            for (index = 1U; index < count; index++)
+            {
+                if (0 != (descriptors[index].revents & (POLLIN | POLLHUP | POLLERR)))
+                {
+                    LiveReceive(polled[index], 0U == periodMs);
+                }
+            }
+            if (0 != (descriptors[0].revents & POLLIN))
+            {
+                LiveAccept(listener, maxConnections);
+            }
+        }
+        for (index = 0U; index < LIVE_MAX_CONNECTIONS; index++)
+        {
+            if ((LiveConnections[index].Socket >= 0) && ((LiveNowMs() - LiveConnections[index].ActiveMs) >= idleMs))
+            {
+                LiveTimeouts++;
+                LiveClose(&LiveConnections[index]);
+            }
+        }
+    }
+    close(listener);
+    LiveReport();
+    return 0;
+}
+
+static int LiveConnect(const struct sockaddr_in * address)
+{
+    int socketHandle = socket(AF_INET, SOCK_STREAM, 0);
+    int isNoDelay = 1;
+
+    if (socketHandle < 0)
+    {
+        return -1;
+    }
+    (void) setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+    if (0 != connect(socketHandle, (const struct sockaddr *) address, sizeof(*address)))
+    {
+        close(socketHandle);
+        return -1;
+    }
+    return socketHandle;
+}
+
+static void LiveRecordLatency(uint32_t latencyUs)
+{
+    if (LiveLatencyCount == LiveLatencySize)
+    {
+        LiveLatencySize = (0U == LiveLatencySize) ? 65536U : (2U * LiveLatencySize);
+        LiveLatencies = realloc(LiveLatencies, LiveLatencySize * sizeof(uint32_t));
+        if (NULL == LiveLatencies)
+        {
+            perror("realloc");
+            exit(1);
+        }
+    }
+    LiveLatencies[LiveLatencyCount++] = latencyUs;
+}
+
+static int LiveCompare(const void * first, const void * second)
+{
+    uint32_t a = *(const uint32_t *) first;
+    uint32_t b = *(const uint32_t *) second;
+
+    return (a > b) - (a < b);
+}
+
+static uint32_t LivePercentile(double percent)
+{
+    return LiveLatencies[(uint32_t) ((percent / 100.0) * (double) (LiveLatencyCount - 1U))];
+}
+
+static int LiveBench(const char * host, uint16_t port, const char * path, uint32_t clientCount, uint32_t seconds, bool isClose)
+{
+    static LiveClient_T clients[LIVE_MAX_CLIENTS];
+    static uint8_t buffer[LIVE_BENCH_RECEIVE_SIZE];
+    struct pollfd descriptors[LIVE_MAX_CLIENTS];
+    struct addrinfo hints;
+    struct addrinfo * result;
+    struct sockaddr_in address;
+    HttpMessage_Request_T request;
+    char requestHead[256];
+    uint32_t requestLength;
+    uint64_t startUs;
+    uint64_t endUs;
+    uint64_t bodyBytes = 0U;
+    uint32_t statusOk = 0U;
+    uint32_t statusBusy = 0U;
+    uint32_t statusOther = 0U;
+    uint32_t errors = 0U;
+    uint32_t connections = 0U;
+    uint32_t index;
+    uint32_t offset;
+    ssize_t received;
+    bool isDone;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (0 != getaddrinfo(host, NULL, &hints, &result))
+    {
+        fprintf(stderr, "%s: not resolved\n", host);
+        return 1;
+    }
+    address = *(struct sockaddr_in *) result->ai_addr;
+    address.sin_port = htons(port);
+    freeaddrinfo(result);
+
+    memset(&request, 0, sizeof(request));
+    request.Method = "GET";
+    request.Host = host;
+    request.Path = path;
+    request.IsClose = isClose;
+    requestLength = HttpMessage_WriteRequestHead(requestHead, sizeof(requestHead), &request);
+    if (0U == requestLength)
+    {
+        return 1;
+    }
+
+    startUs = LiveNowUs();
+    endUs = startUs + ((uint64_t) seconds * 1000000U);
+    for (index = 0U; index < clientCount; index++)
+    {
+        clients[index].Socket = -1;
+    }
+    for (;;)
+    {
+        isDone = (LiveNowUs() >= endUs);
+        for (index = 0U; index < clientCount; index++)
+        {
+            if (!isDone && (clients[index].Socket < 0))
+            {
+                clients[index].Socket = LiveConnect(&address);
+                if (clients[index].Socket < 0)
+                {
+                    errors++;
+                    continue;
+                }
+                connections++;
+                HttpMessage_InitHead(&clients[index].Head, true);
+                clients[index].SentUs = LiveNowUs();
+                if (requestLength != (uint32_t) send(clients[index].Socket, requestHead, requestLength, MSG_NOSIGNAL))
+                {
+                    errors++;
+                    close(clients[index].Socket);
+                    clients[index].Socket = -1;
+                    continue;
+                }
+            }
+            descriptors[index].fd = clients[index].Socket;
+            descriptors[index].events = POLLIN;
+            descriptors[index].revents = 0;
+        }
+        if (isDone)
+        {
+            break;
+        }
+        if (poll(descriptors, clientCount, 100) <= 0)
+        {
+            continue;
+        }
+        for (index = 0U; index < clientCount; index++)
+        {
+            if ((clients[index].Socket < 0) || (0 == (descriptors[index].revents & (POLLIN | POLLHUP | POLLERR))))
+            {
+                continue;
+            }
+            received = recv(clients[index].Socket, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                /* Closed mid response, or before the next one */
+                errors += (HTTP_MESSAGE_STATE_START_LINE != clients[index].Head.State) || (0U != clients[index].Head.LineLength) ? 1U : 0U;
+                close(clients[index].Socket);
+                clients[index].Socket = -1;
+                continue;
+            }
+            offset = 0U;
+            if (HTTP_MESSAGE_STATE_BODY != clients[index].Head.State)
+            {
+                offset = HttpMessage_ParseHead(&clients[index].Head, buffer, (uint32_t) received);
+            }
+            if (HTTP_MESSAGE_STATE_ERROR == clients[index].Head.State)
+            {
+                errors++;
+                close(clients[index].Socket);
+                clients[index].Socket = -1;
+                continue;
+            }
+            if (HTTP_MESSAGE_STATE_BODY != clients[index].Head.State)
+            {
+                continue;
+            }
+            bodyBytes += HttpMessage_ReceiveBody(&clients[index].Head, &buffer[offset], (uint32_t) received - offset);
+            if (!HttpMessage_IsBodyComplete(&clients[index].Head))
+            {
+                continue;
+            }
+            LiveRecordLatency((uint32_t) (LiveNowUs() - clients[index].SentUs));
+            if (200U == clients[index].Head.Status)
+            {
+                statusOk++;
+            }
+            else if (503U == clients[index].Head.Status)
+            {
+                statusBusy++;
+            }
+            else
+            {
+                statusOther++;
+            }
+            if (clients[index].Head.IsClose || isClose)
+            {
+                close(clients[index].Socket);
+                clients[index].Socket = -1;
+                continue;
+            }
+            HttpMessage_InitHead(&clients[index].Head, true);
+            clients[index].SentUs = LiveNowUs();
+            if (requestLength != (uint32_t) send(clients[index].Socket, requestHead, requestLength, MSG_NOSIGNAL))
+            {
+                errors++;
+                close(clients[index].Socket);
+                clients[index].Socket = -1;
+            }
+        }
+    }
+    for (index = 0U; index < clientCount; index++)
+    {
+        if (clients[index].Socket >= 0)
+        {
+            close(clients[index].Socket);
+        }
+    }
+
+    printf("%u clients, %u s, %s connections: %u responses, %.0f per second\n", clientCount, seconds, isClose ? "one request" : "keep-alive",
+            LiveLatencyCount, (double) LiveLatencyCount / (double) seconds);
+    printf("status 200: %u, 503: %u, other: %u; %u connections, %u errors, %.0f body bytes per 200\n", statusOk, statusBusy, statusOther,
+            connections, errors, (0U != statusOk) ? ((double) bodyBytes / (double) statusOk) : 0.0);
+    if (0U != LiveLatencyCount)
+    {
+        qsort(LiveLatencies, LiveLatencyCount, sizeof(uint32_t), LiveCompare);
+        printf("latency us: p50 %u, p90 %u, p99 %u, max %u\n", LivePercentile(50.0), LivePercentile(90.0), LivePercentile(99.0),
+                LiveLatencies[LiveLatencyCount - 1U]);
+    }
+    free(LiveLatencies);
+    return ((0U == statusOk) || (0U != statusOther)) ? 1 : 0;
+}
+
+static void LiveUsage(void)
+{
+    fprintf(stderr, "Usage: LiveViewServer [--connections n] [--idle ms] [--history n] [--period ms] [--seconds s] port\n"
+            "       LiveViewServer --bench [--clients n] [--seconds s] [--close] host port path\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    bool isBench = false;
+    bool isClose = false;
+    uint32_t connections = 2U;
+    uint32_t idleMs = 5000U;
+    uint32_t historyLength = LIVE_HISTORY_LENGTH;
+    uint32_t periodMs = 1000U;
+    uint32_t seconds = 0U;
+    uint32_t clients = 2U;
+    int argument;
+
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--bench"))
+        {
+            isBench = true;
+        }
+        else if (0 == strcmp(argv[argument], "--close"))
+        {
+            isClose = true;
+        }
+        else if (argument + 1 >= argc)
+        {
+            LiveUsage();
+            return 1;
+        }
+        else if (0 == strcmp(argv[argument], "--connections"))
+        {
+            connections = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--idle"))
+        {
+            idleMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--history"))
+        {
+            historyLength = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--period"))
+        {
+            periodMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--seconds"))
+        {
+            seconds = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--clients"))
+        {
+            clients = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else
+        {
+            LiveUsage();
+            return 1;
+        }
+    }
+    if (isBench && ((argument + 3) == argc) && (0U != clients) && (clients <= LIVE_MAX_CLIENTS))
+    {
+        return LiveBench(argv[argument], (uint16_t) strtoul(argv[argument + 1], NULL, 0), argv[argument + 2], clients,
+                (0U != seconds) ? seconds : 10U, isClose);
+    }
+    if (isBench || ((argument + 1) != argc) || (0U == connections) || (connections > LIVE_MAX_CONNECTIONS) ||
+            (0U == historyLength) || (historyLength > LIVE_MAX_HISTORY))
+    {
+        LiveUsage();
+        return 1;
+    }
+    return LiveServe((uint16_t) strtoul(argv[argument], NULL, 0), connections, idleMs, historyLength, periodMs, seconds);
+}
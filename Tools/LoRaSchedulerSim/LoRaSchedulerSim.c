@@ -0,0 +1,431 @@
+/**
+ *  @file
+ *
+ *  @brief Host simulation of the XDK110_Dashboard LoRaWAN uplink scheduler.
+ *
+ *  Feeds a week (or a recorded trace) of 1 Hz sensor snapshots through the
+ *  firmware DutyCycleScheduler and LoRaPayload modules, polling once per
+ *  sample like the LoRa task does, and reports per day the uplinks, the
+ *  airtime and the items sent, plus how long a change waited for its uplink.
+ *  Every uplink is decoded again and checked against the snapshot, and the
+ *  uplink spacing is checked against the duty cycle independently of the
+ *  scheduler.
+ *
+ *  Usage: LoRaSchedulerSim [options]
+ *    --trace <file.csv>    recorded trace (TimeSeriesBench CSV), default: synthetic
+ *    --days <n>            length of the synthetic trace, default 7
+ *    --region eu868|us915  default eu868
+ *    --dr <n>              data rate, default 5 (EU868 SF7)
+ *    --format lpp|bits     payload format, default bits
+ *    --budget <ms>         daily airtime budget, default 30000 (TTN fair use)
+ *    --duty <permille>     duty cycle of the sub-band, default 10 (1 %)
+ *    --min <s>             minimum uplink interval, default 60
+ *    --max <s>             heartbeat interval per item, default 3600
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "DutyCycleScheduler.h"
+#include "LoRaPayload.h"
+#include "SensorSnapshot.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_LINE_SIZE           1024
+#define SIM_MAX_DAYS            64U
+#define SIM_WAIT_BUCKETS        3601U /**< Change to uplink waiting time histogram, 1 s buckets */
+
+/* local types ************************************************************** */
+
+struct SimDay_S
+{
+    uint32_t Uplinks;
+    uint32_t AirtimeMs;
+    uint32_t Bytes;
+    uint32_t Items[LORA_PAYLOAD_ITEM_COUNT];
+};
+typedef struct SimDay_S SimDay_T;
+
+/* local variables ********************************************************** */
+
+static const char * const SimItemNames[LORA_PAYLOAD_ITEM_COUNT] =
+        {
+                "accel", "gyro", "mag", "temp", "humid", "press", "light", "sound"
+        };
+
+/** Deadbands in item units: m/s2, deg/s, uT, degC, %RH, hPa, lux, dB */
+static const float SimDeadbands[LORA_PAYLOAD_ITEM_COUNT] =
+        {
+                1.0f, 10.0f, 5.0f, 0.5f, 3.0f, 1.0f, 200.0f, 6.0f
+        };
+
+static SimDay_T SimDays[SIM_MAX_DAYS];
+
+static uint32_t SimWaits[SIM_WAIT_BUCKETS];
+
+static uint32_t SimWaitCount = 0UL;
+
+static uint32_t SimChangedSinceMs[LORA_PAYLOAD_ITEM_COUNT]; /**< 0 when the item is not waiting */
+
+static uint32_t SimErrors = 0UL;
+
+static uint32_t SimSeed = 4711U;
+
+/* local functions ********************************************************** */
+
+static double SimRandom(void)
+{
+    SimSeed = (SimSeed * 1103515245U) + 12345U;
+    return (double) ((SimSeed >> 8) & 0xFFFFU) / 65536.0;
+}
+
+static bool ParseLine(char * line, SensorSnapshot_T * snapshot)
+{
+    char * cursor = line;
+    char * end;
+    uint8_t channel;
+
+    snapshot->TimestampMs = (uint32_t) strtoul(cursor, &end, 10);
+    if (end == cursor)
+    {
+        return false;
+    }
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        cursor = end;
+        while ((',' == *cursor) || (' ' == *cursor) || (';' == *cursor))
+        {
+            cursor++;
+        }
+        if (0U != (SENSOR_SNAPSHOT_FLOAT_MASK & (1U << channel)))
+        {
+            snapshot->Values[channel].Float = strtof(cursor, &end);
+        }
+        else
+        {
+            snapshot->Values[channel].Int = (int32_t) strtol(cursor, &end, 10);
+        }
+        if (end == cursor)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Office like week at 1 Hz: diurnal climate and light, a few motion and noise events a day.
+ */
+static void SyntheticSample(uint32_t second, SensorSnapshot_T * snapshot)
+{
+    static uint32_t motionUntil = 0UL;
+    static uint32_t noiseUntil = 0UL;
+    static double cloud = 1.0;
+    double hour = fmod((double) second / 3600.0, 24.0);
+    double day = sin(((hour - 9.0) / 24.0) * 2.0 * M_PI);
+    double daylight = ((hour > 6.0) && (hour < 20.0)) ? sin(((hour - 6.0) / 14.0) * M_PI) : 0.0;
+    bool moving;
+
+    if ((second > motionUntil) && (SimRandom() < (4.0 / 86400.0)))
+    {
+        motionUntil = second + 60UL + (uint32_t) (SimRandom() * 300.0);
+    }
+    if ((second > noiseUntil) && (SimRandom() < (10.0 / 86400.0)))
+    {
+        noiseUntil = second + 10UL + (uint32_t) (SimRandom() * 120.0);
+    }
+    if (0UL == (second % 600UL))
+    {
+        cloud = 0.4 + (0.6 * SimRandom());
+    }
+    moving = (second <= motionUntil);
+
+    snapshot->TimestampMs = second * 1000UL;
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = (float) (moving ? ((SimRandom() - 0.5) * 8.0) : ((SimRandom() - 0.5) * 0.05));
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = (float) (moving ? ((SimRandom() - 0.5) * 8.0) : ((SimRandom() - 0.5) * 0.05));
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = (float) (9.81 + (moving ? ((SimRandom() - 0.5) * 8.0) : ((SimRandom() - 0.5) * 0.05)));
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = (int32_t) (moving ? ((SimRandom() - 0.5) * 200000.0) : ((SimRandom() - 0.5) * 500.0));
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = (int32_t) (moving ? ((SimRandom() - 0.5) * 200000.0) : ((SimRandom() - 0.5) * 500.0));
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = (int32_t) (moving ? ((SimRandom() - 0.5) * 200000.0) : ((SimRandom() - 0.5) * 500.0));
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = (int32_t) (moving ? (20.0 + ((SimRandom() - 0.5) * 40.0)) : (20.0 + SimRandom()));
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = (int32_t) (moving ? (-5.0 + ((SimRandom() - 0.5) * 40.0)) : (-5.0 + SimRandom()));
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = (int32_t) (moving ? (-40.0 + ((SimRandom() - 0.5) * 40.0)) : (-40.0 + SimRandom()));
+    snapshot->Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) ((21.0 + (3.0 * day) + ((SimRandom() - 0.5) * 0.1)) * 1000.0);
+    snapshot->Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) (50.0 - (8.0 * day) + (SimRandom() - 0.5));
+    snapshot->Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) (101300.0 + (300.0 * sin((double) second / 200000.0)) + ((SimRandom() - 0.5) * 10.0));
+    snapshot->Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (((daylight * 2000.0 * cloud) + 5.0) * 1000.0);
+    snapshot->Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = (float) ((second <= noiseUntil) ? (0.2 + (SimRandom() * 0.5)) : (0.002 + (SimRandom() * 0.001)));
+}
+
+/**
+ * @brief Checks a payload against the values it was built from, within the quantization of the format.
+ */
+static void CheckPayload(const DutyCycleScheduler_T * scheduler, const uint8_t * payload, uint8_t size)
+{
+    static const float tolerance[LORA_PAYLOAD_ITEM_COUNT] = { 0.05f, 0.5f, 1.0f, 0.1f, 1.0f, 0.1f, 1.0f, 0.5f };
+    LoRaPayload_Values_T decoded;
+    uint8_t item;
+    uint8_t axis;
+    float expected;
+
+    if (!LoRaPayload_Decode(scheduler->Setup.Format, payload, size, &decoded) || (decoded.ItemMask != scheduler->PendingItems))
+    {
+        printf("payload does not decode\n");
+        SimErrors++;
+        return;
+    }
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U == (decoded.ItemMask & (1U << item)))
+        {
+            continue;
+        }
+        for (axis = 0U; axis < LoRaPayload_GetAxisCount((LoRaPayload_Item_T) item); axis++)
+        {
+            expected = scheduler->PendingValues[item][axis];
+            if ((LORA_PAYLOAD_ITEM_LIGHT == item) && (LORA_PAYLOAD_FORMAT_CAYENNE_LPP == scheduler->Setup.Format) && (expected > 65535.0f))
+            {
+                expected = 65535.0f; /* LPP illuminance saturates */
+            }
+            if (fabsf(decoded.Values[item][axis] - expected) > tolerance[item])
+            {
+                printf("%s axis %u: sent %f, decoded %f\n", SimItemNames[item], axis, (double) expected,
+                        (double) decoded.Values[item][axis]);
+                SimErrors++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Starts the change clock of items which just crossed their deadband.
+ */
+static void TrackChanges(const DutyCycleScheduler_T * scheduler, const SensorSnapshot_T * snapshot, uint32_t nowMs)
+{
+    uint8_t item;
+    uint8_t axis;
+    bool changed;
+
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U == (scheduler->SentMask & (1U << item)))
+        {
+            continue;
+        }
+        changed = false;
+        for (axis = 0U; axis < LoRaPayload_GetAxisCount((LoRaPayload_Item_T) item); axis++)
+        {
+            if (fabsf(LoRaPayload_GetValue(snapshot, (LoRaPayload_Item_T) item, axis) - scheduler->SentValues[item][axis]) >=
+                    scheduler->Setup.Deadband[item])
+            {
+                changed = true;
+            }
+        }
+        if (!changed)
+        {
+            SimChangedSinceMs[item] = 0UL; /* back within the deadband, nothing to deliver any more */
+        }
+        else if (0UL == SimChangedSinceMs[item])
+        {
+            SimChangedSinceMs[item] = nowMs + 1UL; /* + 1 keeps 0 free as "not waiting" */
+        }
+    }
+}
+
+static uint32_t WaitPercentile(uint32_t percent)
+{
+    uint64_t target = ((uint64_t) SimWaitCount * percent + 99U) / 100U;
+    uint64_t seen = 0U;
+    uint32_t bucket;
+
+    for (bucket = 0U; bucket < SIM_WAIT_BUCKETS; bucket++)
+    {
+        seen += SimWaits[bucket];
+        if ((seen >= target) && (0U != seen))
+        {
+            return bucket;
+        }
+    }
+    return SIM_WAIT_BUCKETS - 1U;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    DutyCycleScheduler_Setup_T setup;
+    DutyCycleScheduler_T scheduler;
+    SensorSnapshot_T snapshot;
+    uint8_t payload[LORA_PAYLOAD_MAX_SIZE];
+    char line[SIM_LINE_SIZE];
+    const char * tracePath = NULL;
+    FILE * trace = NULL;
+    uint32_t days = 7UL;
+    uint32_t second = 0UL;
+    uint32_t lastUplinkMs = 0UL;
+    uint32_t lastAirtimeUs = 0UL;
+    uint32_t airtimeUs;
+    uint32_t wait;
+    uint32_t day;
+    uint32_t dayCount = 0UL;
+    uint8_t size;
+    uint8_t item;
+    int argument;
+
+    memset(&setup, 0, sizeof(setup));
+    setup.Region = LORA_PAYLOAD_REGION_EU868;
+    setup.DataRate = 5U;
+    setup.Format = LORA_PAYLOAD_FORMAT_BIT_PACKED;
+    setup.DutyCyclePermille = 10U;
+    setup.DailyAirtimeBudgetMs = 30000UL;
+    setup.MinIntervalMs = 60000UL;
+    setup.MaxIntervalMs = 3600000UL;
+    memcpy(setup.Deadband, SimDeadbands, sizeof(setup.Deadband));
+
+    for (argument = 1; argument < argc; argument++)
+    {
+        const char * value = (argument + 1 < argc) ? argv[argument + 1] : "";
+
+        if (0 == strcmp(argv[argument], "--trace")) { tracePath = value; }
+        else if (0 == strcmp(argv[argument], "--days")) { days = (uint32_t) strtoul(value, NULL, 0); }
+        else if (0 == strcmp(argv[argument], "--region")) { setup.Region = (0 == strcmp(value, "us915")) ? LORA_PAYLOAD_REGION_US915 : LORA_PAYLOAD_REGION_EU868; }
+        else if (0 == strcmp(argv[argument], "--dr")) { setup.DataRate = (uint8_t) strtoul(value, NULL, 0); }
+        else if (0 == strcmp(argv[argument], "--format")) { setup.Format = (0 == strcmp(value, "lpp")) ? LORA_PAYLOAD_FORMAT_CAYENNE_LPP : LORA_PAYLOAD_FORMAT_BIT_PACKED; }
+        else if (0 == strcmp(argv[argument], "--budget")) { setup.DailyAirtimeBudgetMs = (uint32_t) strtoul(value, NULL, 0); }
+        else if (0 == strcmp(argv[argument], "--duty")) { setup.DutyCyclePermille = (uint16_t) strtoul(value, NULL, 0); }
+        else if (0 == strcmp(argv[argument], "--min")) { setup.MinIntervalMs = (uint32_t) strtoul(value, NULL, 0) * 1000UL; }
+        else if (0 == strcmp(argv[argument], "--max")) { setup.MaxIntervalMs = (uint32_t) strtoul(value, NULL, 0) * 1000UL; }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[argument]);
+            return 1;
+        }
+        argument++;
+    }
+    if (!DutyCycleScheduler_Init(&scheduler, &setup))
+    {
+        fprintf(stderr, "invalid region / data rate / duty cycle\n");
+        return 1;
+    }
+    if ((NULL != tracePath) && (NULL == (trace = fopen(tracePath, "r"))))
+    {
+        perror(tracePath);
+        return 1;
+    }
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    for (;;)
+    {
+        if (NULL != trace)
+        {
+            if (NULL == fgets(line, sizeof(line), trace))
+            {
+                break;
+            }
+            if (isalpha((unsigned char) line[0]) || ('#' == line[0]) || !ParseLine(line, &snapshot))
+            {
+                continue;
+            }
+        }
+        else
+        {
+            if (second >= (days * 86400UL))
+            {
+                break;
+            }
+            SyntheticSample(second++, &snapshot);
+        }
+
+        TrackChanges(&scheduler, &snapshot, snapshot.TimestampMs);
+        size = DutyCycleScheduler_Poll(&scheduler, &snapshot, snapshot.TimestampMs, payload);
+        if (0U == size)
+        {
+            continue;
+        }
+        CheckPayload(&scheduler, payload, size);
+        airtimeUs = LoRaPayload_GetAirtimeUs(setup.Region, setup.DataRate, size);
+        if ((0UL != scheduler.Statistics.Uplinks) &&
+                ((uint64_t) (snapshot.TimestampMs - lastUplinkMs) * setup.DutyCyclePermille * 1000ULL <
+                 (uint64_t) lastAirtimeUs * 1000U))
+        {
+            printf("duty cycle violated at %u ms\n", (unsigned int) snapshot.TimestampMs);
+            SimErrors++;
+        }
+        day = snapshot.TimestampMs / DUTY_CYCLE_SCHEDULER_DAY_MS;
+        if (day < SIM_MAX_DAYS)
+        {
+            SimDays[day].Uplinks++;
+            SimDays[day].AirtimeMs += (airtimeUs + 500UL) / 1000UL;
+            SimDays[day].Bytes += size;
+            dayCount = (day + 1UL > dayCount) ? (day + 1UL) : dayCount;
+        }
+        for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+        {
+            if (0U == (scheduler.PendingItems & (1U << item)))
+            {
+                continue;
+            }
+            if (day < SIM_MAX_DAYS)
+            {
+                SimDays[day].Items[item]++;
+            }
+            if (0UL != SimChangedSinceMs[item])
+            {
+                wait = (snapshot.TimestampMs - (SimChangedSinceMs[item] - 1UL)) / 1000UL;
+                SimWaits[(wait < SIM_WAIT_BUCKETS) ? wait : (SIM_WAIT_BUCKETS - 1U)]++;
+                SimWaitCount++;
+                SimChangedSinceMs[item] = 0UL;
+            }
+        }
+        DutyCycleScheduler_Confirm(&scheduler, snapshot.TimestampMs, true);
+        lastUplinkMs = snapshot.TimestampMs;
+        lastAirtimeUs = airtimeUs;
+    }
+    if (NULL != trace)
+    {
+        fclose(trace);
+    }
+
+    printf("region=%s dr=%u max_payload=%u format=%s budget_ms=%u duty_permille=%u min_s=%u max_s=%u\n",
+            (LORA_PAYLOAD_REGION_EU868 == setup.Region) ? "eu868" : "us915", setup.DataRate, scheduler.MaxPayloadSize,
+            (LORA_PAYLOAD_FORMAT_CAYENNE_LPP == setup.Format) ? "lpp" : "bits", (unsigned int) setup.DailyAirtimeBudgetMs,
+            setup.DutyCyclePermille, (unsigned int) (setup.MinIntervalMs / 1000UL), (unsigned int) (setup.MaxIntervalMs / 1000UL));
+    printf("full_payload_bytes=%u full_payload_airtime_ms=%.1f\n", LoRaPayload_GetSize(setup.Format, LORA_PAYLOAD_ALL_ITEMS),
+            LoRaPayload_GetAirtimeUs(setup.Region, setup.DataRate, (uint8_t) LoRaPayload_GetSize(setup.Format, LORA_PAYLOAD_ALL_ITEMS)) / 1000.0);
+    printf("day uplinks airtime_s bytes");
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        printf(" %s", SimItemNames[item]);
+    }
+    printf("\n");
+    for (day = 0UL; day < dayCount; day++)
+    {
+        printf("%3u %7u %9.2f %5u", (unsigned int) day, (unsigned int) SimDays[day].Uplinks, SimDays[day].AirtimeMs / 1000.0,
+                (unsigned int) SimDays[day].Bytes);
+        for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+        {
+            printf(" %*u", (int) strlen(SimItemNames[item]), (unsigned int) SimDays[day].Items[item]);
+        }
+        printf("\n");
+        if ((0UL != setup.DailyAirtimeBudgetMs) && (SimDays[day].AirtimeMs > setup.DailyAirtimeBudgetMs + (setup.DailyAirtimeBudgetMs / 8UL)))
+        {
+            printf("daily budget exceeded on day %u\n", (unsigned int) day);
+            SimErrors++;
+        }
+    }
+    printf("uplinks=%u airtime_s=%.2f held_duty_cycle=%u held_budget=%u items_deferred=%u\n",
+            (unsigned int) scheduler.Statistics.Uplinks, (double) scheduler.Statistics.AirtimeUs / 1e6,
+            (unsigned int) scheduler.Statistics.HeldByDutyCycle, (unsigned int) scheduler.Statistics.HeldByBudget,
+            (unsigned int) scheduler.Statistics.ItemsDeferred);
+    printf("change_to_uplink_s p50=%u p99=%u max=%u (%u changes)\n", (unsigned int) WaitPercentile(50U),
+            (unsigned int) WaitPercentile(99U), (unsigned int) WaitPercentile(100U), (unsigned int) SimWaitCount);
+    printf("%s\n", (0UL == SimErrors) ? "check OK" : "check FAILED");
+    return (0UL == SimErrors) ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/**
+ *  @file
+ *
+ *  @brief Host build of the XDK110_Dashboard LWM2M observe client.
+ *
+ *  Runs the firmware Lwm2mObserve module over a POSIX UDP socket against a
+ *  local LWM2M server (e.g. Leshan: java -jar leshan-server-demo.jar) and
+ *  feeds it a generated sensor snapshot, so registration, Observe,
+ *  Write-Attributes and the pmin/pmax driven sampling can be checked without
+ *  hardware. The sampling periods requested by the server are printed
+ *  whenever they change.
+ *
+ *  Usage: Lwm2mObserveSim [server host] [port] [endpoint] [duration s]
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "Lwm2mObserve.h"
+
+#include <math.h>
+#include <netdb.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_POLL_INTERVAL_MS    100
+
+/* local variables ********************************************************** */
+
+static int SimSocket = -1;
+
+/* local functions ********************************************************** */
+
+static uint32_t SimNowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((now.tv_sec * 1000L) + (now.tv_nsec / 1000000L));
+}
+
+static void SimSend(void * context, const uint8_t * datagram, uint16_t length)
+{
+    (void) context;
+
+    if (send(SimSocket, datagram, length, 0) < 0)
+    {
+        perror("send");
+    }
+}
+
+/**
+ * @brief Slowly varying values, so st / gt / lt conditions trigger now and then.
+ */
+static void SimUpdateSnapshot(SensorSnapshot_T * snapshot, uint32_t nowMs)
+{
+    double t = (double) nowMs / 1000.0;
+
+    snapshot->TimestampMs = nowMs;
+    snapshot->Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) (22000.0 + (1500.0 * sin(t / 60.0)));
+    snapshot->Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) (45.0 + (5.0 * sin(t / 90.0)));
+    snapshot->Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) (101325.0 + (80.0 * sin(t / 120.0)));
+    snapshot->Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (150000.0 + (100000.0 * sin(t / 30.0)));
+    snapshot->Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = (float) (0.02 + (0.01 * sin(t / 5.0)));
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = (float) (0.5 * sin(t / 7.0));
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = (float) (0.5 * cos(t / 7.0));
+    snapshot->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = 9.81f;
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = (int32_t) (20.0 * cos(t / 40.0));
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = (int32_t) (20.0 * sin(t / 40.0));
+    snapshot->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = -40;
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = (int32_t) (3000.0 * sin(t / 3.0));
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = 0;
+    snapshot->Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = 0;
+}
+
+static void SimPrintSampling(const Lwm2mObserve_T * client)
+{
+    uint8_t channel;
+    uint32_t period;
+
+    printf("[%lu] sampling:", (unsigned long) SimNowMs());
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        period = Lwm2mObserve_GetSamplingPeriodMs(client, channel);
+        if (0UL != period)
+        {
+            printf(" %s=%lums", SensorSnapshot_GetChannelName(channel), (unsigned long) period);
+        }
+    }
+    printf("%s\n", (0U == client->Statistics.Notifications + client->Statistics.Requests) ? " (idle)" : "");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const char * host = (argc > 1) ? argv[1] : "127.0.0.1";
+    const char * port = (argc > 2) ? argv[2] : "5683";
+    const char * endpoint = (argc > 3) ? argv[3] : "XDK110_Sim";
+    uint32_t durationMs = (argc > 4) ? (uint32_t) strtoul(argv[4], NULL, 10) * 1000U : 0U;
+    struct addrinfo hints;
+    struct addrinfo * server = NULL;
+    struct pollfd descriptor;
+    static Lwm2mObserve_T client;
+    Lwm2mObserve_Setup_T setup;
+    SensorSnapshot_T snapshot;
+    uint8_t datagram[1152];
+    uint32_t generation = 0U;
+    uint32_t startMs = SimNowMs();
+    ssize_t received;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    if ((0 != getaddrinfo(host, port, &hints, &server)) || (NULL == server))
+    {
+        fprintf(stderr, "cannot resolve %s:%s\n", host, port);
+        return EXIT_FAILURE;
+    }
+    SimSocket = socket(server->ai_family, server->ai_socktype, server->ai_protocol);
+    if ((SimSocket < 0) || (0 != connect(SimSocket, server->ai_addr, server->ai_addrlen)))
+    {
+        perror("socket");
+        freeaddrinfo(server);
+        return EXIT_FAILURE;
+    }
+    freeaddrinfo(server);
+
+    memset(&setup, 0, sizeof(setup));
+    setup.EndpointName = endpoint;
+    setup.LifetimeS = 300U;
+    setup.DefaultSamplingMs = 1000U;
+    setup.Send = SimSend;
+    if (!Lwm2mObserve_Init(&client, &setup))
+    {
+        return EXIT_FAILURE;
+    }
+    memset(&snapshot, 0, sizeof(snapshot));
+
+    descriptor.fd = SimSocket;
+    descriptor.events = POLLIN;
+    while ((0U == durationMs) || ((SimNowMs() - startMs) < durationMs))
+    {
+        SimUpdateSnapshot(&snapshot, SimNowMs());
+        if (poll(&descriptor, 1, SIM_POLL_INTERVAL_MS) > 0)
+        {
+            received = recv(SimSocket, datagram, sizeof(datagram), 0);
+            if (received > 0)
+            {
+                Lwm2mObserve_HandleDatagram(&client, datagram, (uint16_t) received, &snapshot, SimNowMs());
+            }
+        }
+        Lwm2mObserve_Process(&client, &snapshot, SimNowMs());
+        if (generation != client.SamplingGeneration)
+        {
+            generation = client.SamplingGeneration;
+            SimPrintSampling(&client);
+        }
+    }
+
+    printf("registrations=%lu updates=%lu requests=%lu notifications=%lu cancellations=%lu\n",
+            (unsigned long) client.Statistics.Registrations, (unsigned long) client.Statistics.Updates,
+            (unsigned long) client.Statistics.Requests, (unsigned long) client.Statistics.Notifications,
+            (unsigned long) client.Statistics.Cancellations);
+    close(SimSocket);
+    return EXIT_SUCCESS;
+}
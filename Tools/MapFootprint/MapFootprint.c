@@ -0,0 +1,761 @@
+/**
+ *  @file
+ *
+ *  @brief Flash / RAM footprint report and budget gate for the XDK applications.
+ *
+ *  Reads the GNU ld map file of a build (debug/<App>.map, written by the XDK
+ *  makefiles) and attributes every input section of the allocated output
+ *  sections to its object file (module) and to a group:
+ *  - archive members to their library, named after the archive without the
+ *    lib prefix and the _efm32 suffix (FreeRTOS, ServalStack, BSP, ...),
+ *  - objects of XDK sources compiled into the application (debug/objects/source,
+ *    debug/objects/legacy) to XdkCommon, objects of library sources to the
+ *    library folder,
+ *  - toolchain objects and archives to libc, libm, libgcc and crt,
+ *  - all other objects, the application and Common/source, to App.
+ *
+ *  Output sections are classified by the memory regions of the map: sections
+ *  in a read only region count as text, .bss, .heap, .stack and .noinit and
+ *  sections without load address in a writable region as bss, the other
+ *  writable sections as data (flash and RAM). Padding and
+ *  linker generated bytes are attributed to the group (linker), so the totals
+ *  match the output section sizes. Sections placed on top of an earlier one
+ *  (like .stack_dummy, which only reserves the stack for a size check) are
+ *  skipped.
+ *
+ *  Usage: MapFootprint [options] <file.map> [<new.map>]
+ *    --objects <n>     also list the n largest modules, 0 for all
+ *    --diff            compare two maps; lists every group and module that changed
+ *    --budget <file>   check the (new) map against a budget file; exit code 2 if exceeded
+ *
+ *  Budget file: one limit per line, "<group|total> <text|data|bss|flash|ram> <bytes>",
+ *  # starts a comment. Example:
+ *
+ *      total flash 420000
+ *      total ram   110000
+ *      App   flash  40000
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define MAP_LINE_SIZE           4096
+#define MAP_NAME_SIZE           96U
+#define MAP_MAX_REGIONS         8U
+#define MAP_MAX_SECTIONS        64U /**< Allocated output sections per map */
+
+/* local types ************************************************************** */
+
+enum MapKind_E
+{
+    MAP_KIND_TEXT = 0,
+    MAP_KIND_DATA,
+    MAP_KIND_BSS,
+
+    MAP_KIND_COUNT
+};
+typedef enum MapKind_E MapKind_T;
+
+struct MapRegion_S
+{
+    char Name[MAP_NAME_SIZE];
+    uint32_t Origin;
+    uint32_t Length;
+    int Writable;
+    uint32_t Used;
+};
+typedef struct MapRegion_S MapRegion_T;
+
+/**
+ * @brief Footprint of one module or group.
+ */
+struct MapEntry_S
+{
+    char Name[MAP_NAME_SIZE];
+    char Group[MAP_NAME_SIZE];
+    uint32_t Size[MAP_KIND_COUNT];
+};
+typedef struct MapEntry_S MapEntry_T;
+
+struct MapTable_S
+{
+    MapEntry_T * Entries;
+    uint32_t Count;
+    uint32_t Capacity;
+};
+typedef struct MapTable_S MapTable_T;
+
+struct Map_S
+{
+    const char * Path;
+    MapRegion_T Regions[MAP_MAX_REGIONS];
+    uint32_t RegionCount;
+    MapTable_T Modules;
+    MapTable_T Groups;
+    uint32_t Total[MAP_KIND_COUNT];
+    uint32_t Sections[MAP_MAX_SECTIONS][2]; /**< Start and end of the allocated output sections */
+    uint32_t SectionCount;
+};
+typedef struct Map_S Map_T;
+
+/** State of the output section being parsed */
+struct MapSection_S
+{
+    int Active; /**< Allocated and not skipped */
+    MapKind_T Kind;
+    uint32_t Address;
+    uint32_t Size;
+    uint32_t Attributed; /**< Bytes of input sections seen so far */
+};
+typedef struct MapSection_S MapSection_T;
+
+/* local variables ********************************************************** */
+
+static const char * const MapKindNames[MAP_KIND_COUNT] = { "text", "data", "bss" };
+
+/* local functions ********************************************************** */
+
+static uint32_t MapFlash(const uint32_t * size)
+{
+    return size[MAP_KIND_TEXT] + size[MAP_KIND_DATA];
+}
+
+static uint32_t MapRam(const uint32_t * size)
+{
+    return size[MAP_KIND_DATA] + size[MAP_KIND_BSS];
+}
+
+static MapEntry_T * MapTableGet(MapTable_T * table, const char * name, const char * group)
+{
+    uint32_t index;
+
+    for (index = 0U; index < table->Count; index++)
+    {
+        if ((0 == strcmp(table->Entries[index].Name, name)) && (0 == strcmp(table->Entries[index].Group, group)))
+        {
+            return &table->Entries[index];
+        }
+    }
+    if (table->Count == table->Capacity)
+    {
+        table->Capacity = (0U == table->Capacity) ? 256U : (table->Capacity * 2U);
+        table->Entries = realloc(table->Entries, table->Capacity * sizeof(MapEntry_T));
+        if (NULL == table->Entries)
+        {
+            fprintf(stderr, "out of memory\n");
+            exit(1);
+        }
+    }
+    memset(&table->Entries[table->Count], 0, sizeof(MapEntry_T));
+    snprintf(table->Entries[table->Count].Name, MAP_NAME_SIZE, "%s", name);
+    snprintf(table->Entries[table->Count].Group, MAP_NAME_SIZE, "%s", group);
+    return &table->Entries[table->Count++];
+}
+
+static MapEntry_T * MapTableFind(const MapTable_T * table, const char * name, const char * group)
+{
+    uint32_t index;
+
+    for (index = 0U; index < table->Count; index++)
+    {
+        if ((0 == strcmp(table->Entries[index].Name, name)) && (0 == strcmp(table->Entries[index].Group, group)))
+        {
+            return &table->Entries[index];
+        }
+    }
+    return NULL;
+}
+
+static const char * MapBaseName(const char * path, size_t length, size_t * baseLength)
+{
+    size_t start = length;
+
+    while ((start > 0U) && (path[start - 1U] != '/'))
+    {
+        start--;
+    }
+    *baseLength = length - start;
+    return &path[start];
+}
+
+/**
+ * @brief Derives module and group of an input file as printed in the map.
+ */
+static void MapClassify(const char * file, char * module, char * group)
+{
+    const char * member = strchr(file, '(');
+    const char * base;
+    const char * marker;
+    size_t baseLength;
+    size_t length;
+
+    if (NULL != member)
+    {
+        /* Archive member: <path>/lib<Name>[_efm32...].a(<member>.o) */
+        snprintf(module, MAP_NAME_SIZE, "%.*s", (int) (strlen(member) - 2U), member + 1);
+        base = MapBaseName(file, (size_t) (member - file), &baseLength);
+        if ((baseLength > 2U) && (0 == strncmp(&base[baseLength - 2U], ".a", 2U)))
+        {
+            baseLength -= 2U;
+        }
+        if (NULL != strstr(file, "arm-none-eabi"))
+        {
+            snprintf(group, MAP_NAME_SIZE, "%.*s", (int) baseLength, base);
+            return;
+        }
+        if ((baseLength > 3U) && (0 == strncmp(base, "lib", 3U)))
+        {
+            base += 3;
+            baseLength -= 3U;
+        }
+        marker = strstr(base, "_efm32");
+        if ((NULL != marker) && ((size_t) (marker - base) < baseLength))
+        {
+            baseLength = (size_t) (marker - base);
+        }
+        snprintf(group, MAP_NAME_SIZE, "%.*s", (int) baseLength, base);
+        return;
+    }
+
+    base = MapBaseName(file, strlen(file), &baseLength);
+    snprintf(module, MAP_NAME_SIZE, "%s", base);
+    if (NULL != strstr(file, "arm-none-eabi"))
+    {
+        snprintf(group, MAP_NAME_SIZE, "crt");
+    }
+    else if ((NULL != strstr(file, "/objects/source/")) || (NULL != strstr(file, "/objects/legacy/")))
+    {
+        snprintf(group, MAP_NAME_SIZE, "XdkCommon");
+    }
+    else if (NULL != (marker = strstr(file, "/Libraries/")))
+    {
+        marker += strlen("/Libraries/");
+        length = strcspn(marker, "/");
+        snprintf(group, MAP_NAME_SIZE, "%.*s", (int) length, marker);
+    }
+    else
+    {
+        snprintf(group, MAP_NAME_SIZE, "App");
+    }
+}
+
+static void MapAttribute(Map_T * map, MapSection_T * section, const char * module, const char * group, uint32_t address,
+        uint32_t size)
+{
+    MapEntry_T * entry;
+
+    /* Merged sections (.rodata.str1.4) list their size before merging at address 0 */
+    if ((!section->Active) || (0U == size) || (address < section->Address) || ((address - section->Address) >= section->Size))
+    {
+        return;
+    }
+    entry = MapTableGet(&map->Modules, module, group);
+    entry->Size[section->Kind] += size;
+    entry = MapTableGet(&map->Groups, group, "");
+    entry->Size[section->Kind] += size;
+    map->Total[section->Kind] += size;
+    section->Attributed += size;
+}
+
+/**
+ * @brief Attributes what the input sections did not cover (ALIGN, linker assignments) to (linker).
+ */
+static void MapCloseSection(Map_T * map, MapSection_T * section)
+{
+    if (section->Active && (section->Size > section->Attributed))
+    {
+        MapAttribute(map, section, "(unattributed)", "(linker)", section->Address, section->Size - section->Attributed);
+    }
+    section->Active = 0;
+}
+
+static MapRegion_T * MapFindRegion(Map_T * map, uint32_t address)
+{
+    uint32_t index;
+
+    for (index = 0U; index < map->RegionCount; index++)
+    {
+        if ((address >= map->Regions[index].Origin) && ((address - map->Regions[index].Origin) < map->Regions[index].Length))
+        {
+            return &map->Regions[index];
+        }
+    }
+    return NULL;
+}
+
+static void MapOpenSection(Map_T * map, MapSection_T * section, const char * name, uint32_t address, uint32_t size,
+        int hasLoadAddress, uint32_t loadAddress)
+{
+    MapRegion_T * region = MapFindRegion(map, address);
+    MapRegion_T * loadRegion;
+    uint32_t index;
+
+    section->Active = 0;
+    section->Attributed = 0U;
+    section->Address = address;
+    section->Size = size;
+    if ((NULL == region) || (0U == size))
+    {
+        return;
+    }
+    for (index = 0U; index < map->SectionCount; index++)
+    {
+        if ((address >= map->Sections[index][0]) && (address < map->Sections[index][1]))
+        {
+            /* Starts inside an earlier section: a placeholder like .stack_dummy */
+            return;
+        }
+    }
+    if (map->SectionCount < MAP_MAX_SECTIONS)
+    {
+        map->Sections[map->SectionCount][0] = address;
+        map->Sections[map->SectionCount][1] = address + size;
+        map->SectionCount++;
+    }
+    section->Active = 1;
+    if (!region->Writable)
+    {
+        section->Kind = MAP_KIND_TEXT;
+    }
+    else if (!hasLoadAddress || (0 == strncmp(name, ".bss", 4U)) || (0 == strncmp(name, ".heap", 5U)) ||
+            (0 == strncmp(name, ".stack", 6U)) || (0 == strncmp(name, ".noinit", 7U)))
+    {
+        /* The XDK linker script gives .bss a load address too */
+        section->Kind = MAP_KIND_BSS;
+    }
+    else
+    {
+        section->Kind = MAP_KIND_DATA;
+        /* The initial values occupy the load region as well */
+        loadRegion = MapFindRegion(map, loadAddress);
+        if ((NULL != loadRegion) && (loadRegion != region))
+        {
+            loadRegion->Used += size;
+        }
+    }
+    region->Used += size;
+}
+
+static int MapParseHex(const char * token, uint32_t * value)
+{
+    char * end;
+
+    if ((NULL == token) || (0 != strncmp(token, "0x", 2U)))
+    {
+        return 0;
+    }
+    *value = (uint32_t) strtoul(token, &end, 16);
+    return ('\0' == *end);
+}
+
+static int MapLoad(Map_T * map, const char * path)
+{
+    FILE * file = fopen(path, "r");
+    char line[MAP_LINE_SIZE];
+    char pending[MAP_LINE_SIZE * 2] = "";
+    char joined[MAP_LINE_SIZE * 2];
+    char * text;
+    char module[MAP_NAME_SIZE];
+    char group[MAP_NAME_SIZE];
+    char * tokens[6];
+    char * cursor;
+    uint32_t tokenCount;
+    uint32_t address;
+    uint32_t size;
+    int state = 0; /* 0: before, 1: memory configuration, 2: memory map */
+    int isOutput;
+    int hasLoadAddress;
+    uint32_t loadAddress = 0U;
+    MapSection_T section;
+
+    memset(map, 0, sizeof(*map));
+    memset(&section, 0, sizeof(section));
+    map->Path = path;
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 0;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (0 == strncmp(line, "Memory Configuration", 20U))
+        {
+            state = 1;
+            continue;
+        }
+        if (0 == strncmp(line, "Linker script and memory map", 28U))
+        {
+            state = 2;
+            continue;
+        }
+        if (1 == state)
+        {
+            tokenCount = 0U;
+            for (cursor = strtok(line, " \t"); (NULL != cursor) && (tokenCount < 4U); cursor = strtok(NULL, " \t"))
+            {
+                tokens[tokenCount++] = cursor;
+            }
+            if ((tokenCount >= 3U) && (map->RegionCount < MAP_MAX_REGIONS) && ('*' != tokens[0][0]) &&
+                    MapParseHex(tokens[1], &address) && MapParseHex(tokens[2], &size))
+            {
+                MapRegion_T * region = &map->Regions[map->RegionCount++];
+                snprintf(region->Name, MAP_NAME_SIZE, "%s", tokens[0]);
+                region->Origin = address;
+                region->Length = size;
+                region->Writable = (tokenCount >= 4U) && (NULL != strchr(tokens[3], 'w'));
+            }
+            continue;
+        }
+        if ((2 != state) || ('\0' == line[0]))
+        {
+            continue;
+        }
+
+        /* Long section names are printed alone, their addresses follow on the next line */
+        text = line;
+        if ('\0' != pending[0])
+        {
+            snprintf(joined, sizeof(joined), "%s %s", pending, line);
+            text = joined;
+            pending[0] = '\0';
+        }
+        isOutput = ('.' == text[0]);
+        if (!isOutput && (0 != strncmp(text, " .", 2U)) && (0 != strncmp(text, " COMMON", 7U)) &&
+                (0 != strncmp(text, " *fill*", 7U)))
+        {
+            if (0 == strncmp(text, "OUTPUT(", 7U))
+            {
+                break;
+            }
+            continue;
+        }
+        if (NULL == strpbrk(text + 1, " \t"))
+        {
+            snprintf(pending, sizeof(pending), "%s", text);
+            continue;
+        }
+        tokenCount = 0U;
+        for (cursor = strtok(text, " \t"); (NULL != cursor) && (tokenCount < 6U); cursor = strtok(NULL, " \t"))
+        {
+            tokens[tokenCount++] = cursor;
+        }
+        if ((tokenCount < 3U) || !MapParseHex(tokens[1], &address) || !MapParseHex(tokens[2], &size))
+        {
+            continue;
+        }
+        if (isOutput)
+        {
+            MapCloseSection(map, &section);
+            hasLoadAddress = (tokenCount >= 6U) && (0 == strcmp(tokens[3], "load")) && MapParseHex(tokens[5], &loadAddress);
+            MapOpenSection(map, &section, tokens[0], address, size, hasLoadAddress, loadAddress);
+        }
+        else if (0 == strcmp(tokens[0], "*fill*"))
+        {
+            MapAttribute(map, &section, "(fill)", "(linker)", address, size);
+        }
+        else if (tokenCount >= 4U)
+        {
+            MapClassify(tokens[3], module, group);
+            MapAttribute(map, &section, module, group, address, size);
+        }
+        else
+        {
+            MapAttribute(map, &section, "(unattributed)", "(linker)", address, size);
+        }
+    }
+    MapCloseSection(map, &section);
+    fclose(file);
+    if (0U == map->RegionCount)
+    {
+        fprintf(stderr, "%s: no memory configuration, not a GNU ld map file?\n", path);
+        return 0;
+    }
+    return 1;
+}
+
+static const MapTable_T * MapSortTable;
+
+static int MapCompareFootprint(const void * left, const void * right)
+{
+    const MapEntry_T * a = &MapSortTable->Entries[*(const uint32_t *) left];
+    const MapEntry_T * b = &MapSortTable->Entries[*(const uint32_t *) right];
+    uint32_t sizeA = MapFlash(a->Size) + MapRam(a->Size);
+    uint32_t sizeB = MapFlash(b->Size) + MapRam(b->Size);
+
+    return (sizeA < sizeB) ? 1 : ((sizeA > sizeB) ? -1 : strcmp(a->Name, b->Name));
+}
+
+static uint32_t * MapSortedIndex(const MapTable_T * table)
+{
+    uint32_t * order = malloc((table->Count + 1U) * sizeof(uint32_t));
+    uint32_t index;
+
+    if (NULL == order)
+    {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    for (index = 0U; index < table->Count; index++)
+    {
+        order[index] = index;
+    }
+    MapSortTable = table;
+    qsort(order, table->Count, sizeof(uint32_t), MapCompareFootprint);
+    return order;
+}
+
+static void MapPrintRow(const char * name, const uint32_t * size)
+{
+    printf("%-28s %9u %9u %9u %9u %9u\n", name, (unsigned int) size[MAP_KIND_TEXT], (unsigned int) size[MAP_KIND_DATA],
+            (unsigned int) size[MAP_KIND_BSS], (unsigned int) MapFlash(size), (unsigned int) MapRam(size));
+}
+
+static void MapReport(const Map_T * map, int objects)
+{
+    uint32_t * order;
+    uint32_t index;
+    char name[2U * MAP_NAME_SIZE + 4U];
+
+    printf("%s\n", map->Path);
+    for (index = 0U; index < map->RegionCount; index++)
+    {
+        if (0U != map->Regions[index].Used)
+        {
+            printf("  %-10s %9u of %9u bytes used (%.1f %%)\n", map->Regions[index].Name, (unsigned int) map->Regions[index].Used,
+                    (unsigned int) map->Regions[index].Length, 100.0 * map->Regions[index].Used / map->Regions[index].Length);
+        }
+    }
+    printf("\n%-28s %9s %9s %9s %9s %9s\n", "group", "text", "data", "bss", "flash", "ram");
+    order = MapSortedIndex(&map->Groups);
+    for (index = 0U; index < map->Groups.Count; index++)
+    {
+        MapPrintRow(map->Groups.Entries[order[index]].Name, map->Groups.Entries[order[index]].Size);
+    }
+    free(order);
+    MapPrintRow("total", map->Total);
+
+    if (objects >= 0)
+    {
+        printf("\n%-28s %9s %9s %9s %9s %9s\n", "module", "text", "data", "bss", "flash", "ram");
+        order = MapSortedIndex(&map->Modules);
+        for (index = 0U; (index < map->Modules.Count) && ((0 == objects) || (index < (uint32_t) objects)); index++)
+        {
+            snprintf(name, sizeof(name), "%s:%s", map->Modules.Entries[order[index]].Group, map->Modules.Entries[order[index]].Name);
+            MapPrintRow(name, map->Modules.Entries[order[index]].Size);
+        }
+        free(order);
+    }
+}
+
+static void MapPrintDeltaRow(const char * name, const uint32_t * oldSize, const uint32_t * newSize)
+{
+    static const uint32_t zero[MAP_KIND_COUNT] = { 0U };
+    const uint32_t * before = (NULL != oldSize) ? oldSize : zero;
+    const uint32_t * after = (NULL != newSize) ? newSize : zero;
+
+    printf("%-40s %+9ld %+9ld %+9ld %+9ld %+9ld%s\n", name,
+            (long) after[MAP_KIND_TEXT] - (long) before[MAP_KIND_TEXT],
+            (long) after[MAP_KIND_DATA] - (long) before[MAP_KIND_DATA],
+            (long) after[MAP_KIND_BSS] - (long) before[MAP_KIND_BSS],
+            (long) MapFlash(after) - (long) MapFlash(before), (long) MapRam(after) - (long) MapRam(before),
+            (NULL == oldSize) ? "  (new)" : ((NULL == newSize) ? "  (removed)" : ""));
+}
+
+static int MapChanged(const MapEntry_T * before, const MapEntry_T * after)
+{
+    return (NULL == before) || (NULL == after) || (0 != memcmp(before->Size, after->Size, sizeof(before->Size)));
+}
+
+/**
+ * @brief Prints the changes of every group and module from one map to the other.
+ */
+static void MapDiffTables(const MapTable_T * before, const MapTable_T * after, int modules)
+{
+    char name[2U * MAP_NAME_SIZE + 4U];
+    const MapEntry_T * other;
+    uint32_t index;
+
+    for (index = 0U; index < after->Count; index++)
+    {
+        other = MapTableFind(before, after->Entries[index].Name, after->Entries[index].Group);
+        if (MapChanged(other, &after->Entries[index]))
+        {
+            snprintf(name, sizeof(name), "%s%s%s", after->Entries[index].Group, modules ? ":" : "", after->Entries[index].Name);
+            MapPrintDeltaRow(name, (NULL != other) ? other->Size : NULL, after->Entries[index].Size);
+        }
+    }
+    for (index = 0U; index < before->Count; index++)
+    {
+        if (NULL == MapTableFind(after, before->Entries[index].Name, before->Entries[index].Group))
+        {
+            snprintf(name, sizeof(name), "%s%s%s", before->Entries[index].Group, modules ? ":" : "", before->Entries[index].Name);
+            MapPrintDeltaRow(name, before->Entries[index].Size, NULL);
+        }
+    }
+}
+
+static void MapDiff(const Map_T * before, const Map_T * after)
+{
+    printf("%s -> %s\n\n%-40s %9s %9s %9s %9s %9s\n", before->Path, after->Path, "group", "text", "data", "bss", "flash", "ram");
+    MapDiffTables(&before->Groups, &after->Groups, 0);
+    MapPrintDeltaRow("total", before->Total, after->Total);
+    printf("\n%-40s %9s %9s %9s %9s %9s\n", "module", "text", "data", "bss", "flash", "ram");
+    MapDiffTables(&before->Modules, &after->Modules, 1);
+}
+
+/**
+ * @brief Checks a map against a budget file.
+ *
+ * @return Number of exceeded limits, -1 if the budget file is unreadable or malformed.
+ */
+static int MapCheckBudget(const Map_T * map, const char * path)
+{
+    FILE * file = fopen(path, "r");
+    char line[MAP_LINE_SIZE];
+    char group[MAP_NAME_SIZE];
+    char metric[16];
+    unsigned long limit;
+    const uint32_t * size;
+    const MapEntry_T * entry;
+    uint32_t value;
+    uint32_t lineNumber = 0U;
+    int exceeded = 0;
+    int kind;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return -1;
+    }
+    printf("\nbudget %s\n", path);
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        lineNumber++;
+        line[strcspn(line, "#\r\n")] = '\0';
+        if (sscanf(line, " %95s %15s %lu", group, metric, &limit) != 3)
+        {
+            if (NULL != strpbrk(line, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789"))
+            {
+                fprintf(stderr, "%s:%u: expected \"<group|total> <text|data|bss|flash|ram> <bytes>\"\n", path, (unsigned int) lineNumber);
+                fclose(file);
+                return -1;
+            }
+            continue;
+        }
+        if (0 == strcmp(group, "total"))
+        {
+            size = map->Total;
+        }
+        else
+        {
+            entry = MapTableFind(&map->Groups, group, "");
+            size = (NULL != entry) ? entry->Size : NULL;
+        }
+        if (0 == strcmp(metric, "flash"))
+        {
+            value = (NULL != size) ? MapFlash(size) : 0U;
+        }
+        else if (0 == strcmp(metric, "ram"))
+        {
+            value = (NULL != size) ? MapRam(size) : 0U;
+        }
+        else
+        {
+            for (kind = 0; (kind < (int) MAP_KIND_COUNT) && (0 != strcmp(metric, MapKindNames[kind])); kind++)
+            {
+            }
+            if (kind == (int) MAP_KIND_COUNT)
+            {
+                fprintf(stderr, "%s:%u: unknown metric %s\n", path, (unsigned int) lineNumber, metric);
+                fclose(file);
+                return -1;
+            }
+            value = (NULL != size) ? size[kind] : 0U;
+        }
+        printf("  %-28s %-6s %9u of %9lu  %s\n", group, metric, (unsigned int) value, limit, (value > limit) ? "EXCEEDED" : "ok");
+        if (value > limit)
+        {
+            exceeded++;
+        }
+    }
+    fclose(file);
+    return exceeded;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const char * paths[2] = { NULL, NULL };
+    const char * budget = NULL;
+    uint32_t pathCount = 0U;
+    int objects = -1;
+    int diff = 0;
+    int exceeded = 0;
+    int index;
+    Map_T maps[2];
+
+    for (index = 1; index < argc; index++)
+    {
+        if ((0 == strcmp(argv[index], "--objects")) && ((index + 1) < argc))
+        {
+            objects = atoi(argv[++index]);
+        }
+        else if (0 == strcmp(argv[index], "--diff"))
+        {
+            diff = 1;
+        }
+        else if ((0 == strcmp(argv[index], "--budget")) && ((index + 1) < argc))
+        {
+            budget = argv[++index];
+        }
+        else if (('-' != argv[index][0]) && (pathCount < 2U))
+        {
+            paths[pathCount++] = argv[index];
+        }
+        else
+        {
+            pathCount = 0U;
+            break;
+        }
+    }
+    if ((0U == pathCount) || (diff && (2U != pathCount)) || (!diff && (1U != pathCount)))
+    {
+        fprintf(stderr, "usage: MapFootprint [--objects <n>] [--budget <file>] <file.map>\n"
+                "       MapFootprint --diff [--budget <file>] <old.map> <new.map>\n");
+        return 1;
+    }
+    for (index = 0; index < (int) pathCount; index++)
+    {
+        if (!MapLoad(&maps[index], paths[index]))
+        {
+            return 1;
+        }
+    }
+    if (diff)
+    {
+        MapDiff(&maps[0], &maps[1]);
+    }
+    else
+    {
+        MapReport(&maps[0], objects);
+    }
+    if (NULL != budget)
+    {
+        exceeded = MapCheckBudget(&maps[pathCount - 1U], budget);
+        if (exceeded < 0)
+        {
+            return 1;
+        }
+        printf("%s\n", (0 == exceeded) ? "budget OK" : "budget EXCEEDED");
+    }
+    return (0 == exceeded) ? 0 : 2;
+}
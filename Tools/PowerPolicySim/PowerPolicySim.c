@@ -0,0 +1,387 @@
+/**
+ *  @file
+ *
+ *  @brief Host simulation of the XDK110_Dashboard battery aware sampling.
+ *
+ *  Discharges a model of the XDK battery through the firmware PowerPolicy,
+ *  the way PowerAgent and AppController drive it: one measurement per
+ *  POWER_MEASURE_PERIOD_MS, a transition retimes the sensors and snapshots,
+ *  stops the sensors without a channel of the level, sets the upload interval
+ *  and the magnetometer data rate. The same charge is also run with the policy
+ *  held at every single level.
+ *
+ *  The battery is a LiPo open circuit voltage curve over the charge, minus
+ *  the drop of the mean current over the internal resistance, plus a few mV
+ *  of noise. The device is empty once the loaded voltage reaches the cutoff.
+ *  The current of a level is an order of magnitude estimate: a base current
+ *  (MCU, regulators, WLAN associated and idle), the sensors, which keep
+ *  running when their reads stop (the magnetometer with its data rate), a
+ *  charge per read, per snapshot and per post.
+ *
+ *  The report lists the runtime to empty, mean current, snapshots and posts
+ *  of every policy, the time per level and the transitions of the adaptive
+ *  run. It checks that the adaptive run only moves towards saving while
+ *  discharging, reaches every level and outlasts the normal level; a
+ *  violation makes the exit code 1.
+ *
+ *  Usage: PowerPolicySim [options]
+ *    --capacity <mAh>      battery capacity, default 560 (XDK battery)
+ *    --base <mA>           base current, default 6.0
+ *    --post <mAs>          charge of a post, default 60 (WLAN transmit and TLS record)
+ *    --resistance <mOhm>   internal resistance, default 200
+ *    --cutoff <mV>         loaded voltage at which the device stops, default 3400
+ *    --seed <n>            seed of the measurement noise, default 4711
+ *    --csv <file>          write the adaptive run: hour, charge, mV, average, level
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "PowerPolicy.h"
+#include "SensorTable.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_MEASURE_PERIOD_MS   60000U  /**< POWER_MEASURE_PERIOD_MS */
+#define SIM_SNAPSHOT_PERIOD_MS  1000U   /**< APP_SNAPSHOT_PERIOD_MS */
+#define SIM_NORMAL_UPLOAD_MS    10000U  /**< INTER_REQUEST_INTERVAL */
+#define SIM_TABLE_MAG_HZ        10U     /**< MAGNETOMETER_BMM150_DATARATE_10HZ of SensorTable.h */
+#define SIM_NOISE_MV            8.0     /**< Peak measurement noise */
+#define SIM_MAX_HOURS           2000.0
+#define SIM_READ_MAS            0.012   /**< Charge of a read: MCU awake, I2C transfer */
+#define SIM_SNAPSHOT_MAS        0.003   /**< Charge of a snapshot appended to the batch */
+#define SIM_MAG_MA_PER_HZ       0.05    /**< BMM150 regular preset */
+#define SIM_CURVE_POINTS        15U
+#define SIM_POLICIES            (1U + POWER_POLICY_MAX_LEVELS) /**< Adaptive, then every level fixed */
+
+/* local types ************************************************************** */
+
+struct SimCurvePoint_S
+{
+    double Percent;
+    double Millivolts;
+};
+typedef struct SimCurvePoint_S SimCurvePoint_T;
+
+struct SimRun_S
+{
+    const char * Name;
+    int FixedLevel; /**< -1 for the adaptive run */
+    double Hours;
+    double ChargeMah; /**< Drawn until empty */
+    double Snapshots;
+    double Posts;
+    double LevelHours[POWER_POLICY_MAX_LEVELS];
+    PowerPolicy_T Policy;
+    bool HasRaised; /**< A transition towards less saving */
+};
+typedef struct SimRun_S SimRun_T;
+
+/* local variables ********************************************************** */
+
+/** Open circuit voltage of a LiPo cell over its charge, discharged at C/20 */
+static const SimCurvePoint_T SimCurve[SIM_CURVE_POINTS] =
+        {
+                { 0.0, 3300.0 }, { 2.0, 3480.0 }, { 5.0, 3580.0 }, { 10.0, 3650.0 }, { 15.0, 3690.0 },
+                { 20.0, 3720.0 }, { 30.0, 3760.0 }, { 40.0, 3790.0 }, { 50.0, 3830.0 }, { 60.0, 3880.0 },
+                { 70.0, 3950.0 }, { 80.0, 4020.0 }, { 90.0, 4110.0 }, { 95.0, 4150.0 }, { 100.0, 4200.0 },
+        };
+
+/** Current of a running sensor in mA, the magnetometer apart (SIM_MAG_MA_PER_HZ) */
+static const double SimSensorMa[SENSOR_TABLE_SENSOR_COUNT] =
+        {
+                0.13,  /* accelerometer, BMA280 normal mode */
+                5.0,   /* gyroscope, BMG160 normal mode */
+                0.0,   /* magnetometer */
+                0.004, /* environmental, BME280 at 1 Hz */
+                0.001, /* light */
+                0.25,  /* acoustic, microphone and amplifier */
+        };
+
+/** Defaults of AppController.h (POWER_*) */
+static const PowerPolicy_Level_T SimLevels[] =
+        {
+                { "Normal", 0U, 1U, SIM_NORMAL_UPLOAD_MS, SENSOR_TABLE_ALL_CHANNELS, 0U },
+                { "Saving", 3790U, 5U, 60000U, 0x3F1FU, 6U },
+                { "Low", 3720U, 30U, 300000U, 0x3117U, 2U },
+                { "Critical", 3650U, 300U, 1800000U, 0x3100U, 2U },
+        };
+
+static const PowerPolicy_Setup_T SimSetup =
+        {
+                .Levels = SimLevels,
+                .LevelCount = (uint8_t) (sizeof(SimLevels) / sizeof(SimLevels[0])),
+                .HysteresisMv = 100U,
+                .MinDwellMs = 600000U,
+                .FilterShift = 2U,
+        };
+
+static double SimCapacityMah = 560.0;
+
+static double SimBaseMa = 6.0;
+
+static double SimPostMas = 60.0;
+
+static double SimResistanceOhm = 0.2;
+
+static double SimCutoffMv = 3400.0;
+
+static uint32_t SimSeed = 4711U;
+
+static SimRun_T SimRuns[SIM_POLICIES];
+
+static FILE * SimCsv = NULL;
+
+static uint32_t SimErrors = 0U;
+
+/* local functions ********************************************************** */
+
+static double SimRandom(void)
+{
+    SimSeed = (SimSeed * 1103515245U) + 12345U;
+    return (double) ((SimSeed >> 8) & 0xFFFFU) / 65536.0;
+}
+
+static void Check(bool condition, const char * message)
+{
+    if (!condition)
+    {
+        printf("CHECK FAILED: %s\n", message);
+        SimErrors++;
+    }
+}
+
+static double OpenCircuitMv(double percent)
+{
+    uint32_t index;
+
+    if (percent <= SimCurve[0].Percent)
+    {
+        return SimCurve[0].Millivolts;
+    }
+    for (index = 1U; index < SIM_CURVE_POINTS; index++)
+    {
+        if (percent <= SimCurve[index].Percent)
+        {
+            return SimCurve[index - 1U].Millivolts + (((percent - SimCurve[index - 1U].Percent) /
+                    (SimCurve[index].Percent - SimCurve[index - 1U].Percent)) * (SimCurve[index].Millivolts - SimCurve[index - 1U].Millivolts));
+        }
+    }
+    return SimCurve[SIM_CURVE_POINTS - 1U].Millivolts;
+}
+
+/**
+ * @brief Returns the mean current of a level in mA, like AppControllerApplyPowerLevel sets it up.
+ */
+static double LevelMa(const PowerPolicy_Level_T * level)
+{
+    uint32_t magnetometerHz = (0U != level->MagnetometerRateHz) ? level->MagnetometerRateHz : SIM_TABLE_MAG_HZ;
+    double current = SimBaseMa + (SIM_MAG_MA_PER_HZ * magnetometerHz);
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        current += SimSensorMa[sensor];
+        if (0U != (level->ChannelMask & SensorTable_GetChannelMask(sensor)))
+        {
+            current += SIM_READ_MAS * 1000.0 / ((double) SensorTable_GetSensorPeriodMs(sensor) * level->PeriodFactor);
+        }
+    }
+    current += SIM_SNAPSHOT_MAS * 1000.0 / ((double) SIM_SNAPSHOT_PERIOD_MS * level->PeriodFactor);
+    current += SimPostMas * 1000.0 / (double) level->UploadIntervalMs;
+    return current;
+}
+
+static void Run(SimRun_T * run)
+{
+    const PowerPolicy_Level_T * level;
+    double chargeMah = SimCapacityMah;
+    double stepHours = SIM_MEASURE_PERIOD_MS / 3600000.0;
+    double current;
+    double loadedMv;
+    uint32_t nowMs = 0U;
+    uint8_t from;
+
+    (void) PowerPolicy_Init(&run->Policy, &SimSetup);
+    level = (run->FixedLevel < 0) ? PowerPolicy_GetLevel(&run->Policy) : &SimLevels[run->FixedLevel];
+    while (run->Hours < SIM_MAX_HOURS)
+    {
+        current = LevelMa(level);
+        loadedMv = OpenCircuitMv((100.0 * chargeMah) / SimCapacityMah) - (current * SimResistanceOhm);
+        if (loadedMv <= SimCutoffMv)
+        {
+            break;
+        }
+        if (run->FixedLevel < 0)
+        {
+            /* PowerAgent measures first, the level applies to the next period */
+            from = run->Policy.Level;
+            if (PowerPolicy_Update(&run->Policy, (uint16_t) (loadedMv + (SIM_NOISE_MV * ((2.0 * SimRandom()) - 1.0))), nowMs))
+            {
+                run->HasRaised |= (run->Policy.Level < from);
+                level = PowerPolicy_GetLevel(&run->Policy);
+                current = LevelMa(level);
+            }
+            if (NULL != SimCsv)
+            {
+                fprintf(SimCsv, "%.3f,%.1f,%.0f,%u,%s\n", run->Hours, chargeMah, loadedMv, PowerPolicy_GetMillivolts(&run->Policy), level->Name);
+            }
+        }
+        chargeMah -= current * stepHours;
+        run->ChargeMah += current * stepHours;
+        run->Snapshots += (SIM_MEASURE_PERIOD_MS / (double) SIM_SNAPSHOT_PERIOD_MS) / level->PeriodFactor;
+        run->Posts += SIM_MEASURE_PERIOD_MS / (double) level->UploadIntervalMs;
+        run->LevelHours[level - SimLevels] += stepHours;
+        run->Hours += stepHours;
+        nowMs += SIM_MEASURE_PERIOD_MS;
+    }
+}
+
+static void PrintReport(void)
+{
+    const SimRun_T * adaptive = &SimRuns[0];
+    const PowerPolicy_Transition_T * transition;
+    uint8_t level;
+    uint8_t index;
+
+    printf("battery %.0f mAh, %.0f mOhm, cutoff %.0f mV; base %.1f mA, %.1f mAs per post\n\n", SimCapacityMah, SimResistanceOhm * 1000.0,
+            SimCutoffMv, SimBaseMa, SimPostMas);
+    printf("%-16s %10s %10s %12s %10s\n", "policy", "runtime h", "mean mA", "snapshots", "posts");
+    for (index = 0U; index < SIM_POLICIES; index++)
+    {
+        const SimRun_T * run = &SimRuns[index];
+
+        printf("%-16s %10.1f %10.2f %12.0f %10.0f", run->Name, run->Hours, (run->Hours > 0.0) ? (run->ChargeMah / run->Hours) : 0.0,
+                run->Snapshots, run->Posts);
+        if (1U != index)
+        {
+            printf("  (%.0f %% of normal)", (100.0 * run->Hours) / SimRuns[1].Hours);
+        }
+        printf("\n");
+    }
+
+    printf("\nadaptive:");
+    for (level = 0U; level < SimSetup.LevelCount; level++)
+    {
+        printf(" %s %.1f h%s", SimLevels[level].Name, adaptive->LevelHours[level], ((level + 1U) < SimSetup.LevelCount) ? "," : "\n");
+    }
+    printf("policy: %u readings, %u transitions, %u deferred, %u..%u mV\n", adaptive->Policy.Statistics.Readings,
+            adaptive->Policy.Statistics.Transitions, adaptive->Policy.Statistics.Deferred, adaptive->Policy.Statistics.MinMv,
+            adaptive->Policy.Statistics.MaxMv);
+    for (index = 0U; NULL != (transition = PowerPolicy_GetTransition(&adaptive->Policy, index)); index++)
+    {
+        printf("  %8.1f h  %-8s -> %-8s at %u mV\n", transition->TimestampMs / 3600000.0, SimLevels[transition->From].Name,
+                SimLevels[transition->To].Name, transition->Millivolts);
+    }
+
+    Check(!adaptive->HasRaised, "the adaptive run moved towards less saving while discharging");
+    for (level = 1U; level < SimSetup.LevelCount; level++)
+    {
+        Check(adaptive->LevelHours[level] > 0.0, "the adaptive run did not reach every level");
+    }
+    Check(adaptive->Hours > SimRuns[1].Hours, "the adaptive run did not outlast the normal level");
+    printf("%s\n", (0U == SimErrors) ? "checks: ok" : "checks: FAILED");
+}
+
+static void Usage(const char * name)
+{
+    fprintf(stderr, "usage: %s [--capacity <mAh>] [--base <mA>] [--post <mAs>] [--resistance <mOhm>] [--cutoff <mV>] [--seed <n>] [--csv <file>]\n",
+            name);
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    static char fixedNames[POWER_POLICY_MAX_LEVELS][24];
+    const char * csvPath = NULL;
+    uint8_t index;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        const char * option = argv[arg];
+        const char * value = ((arg + 1) < argc) ? argv[arg + 1] : NULL;
+
+        if (NULL == value)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        arg++;
+        if (0 == strcmp(option, "--capacity"))
+        {
+            SimCapacityMah = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--base"))
+        {
+            SimBaseMa = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--post"))
+        {
+            SimPostMas = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--resistance"))
+        {
+            SimResistanceOhm = strtod(value, NULL) / 1000.0;
+        }
+        else if (0 == strcmp(option, "--cutoff"))
+        {
+            SimCutoffMv = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--seed"))
+        {
+            SimSeed = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--csv"))
+        {
+            csvPath = value;
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((SimCapacityMah <= 0.0) || (SimBaseMa < 0.0) || (SimPostMas < 0.0) || (SimResistanceOhm < 0.0) ||
+            (SimCutoffMv < SimCurve[0].Millivolts) || (SimCutoffMv >= SimLevels[SimSetup.LevelCount - 1U].EnterMv))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (NULL != csvPath)
+    {
+        SimCsv = fopen(csvPath, "w");
+        if (NULL == SimCsv)
+        {
+            perror(csvPath);
+            return EXIT_FAILURE;
+        }
+        fprintf(SimCsv, "hour,charge_mah,mv,average_mv,level\n");
+    }
+
+    SimRuns[0].Name = "adaptive";
+    SimRuns[0].FixedLevel = -1;
+    for (index = 0U; index < SimSetup.LevelCount; index++)
+    {
+        (void) snprintf(fixedNames[index], sizeof(fixedNames[index]), "fixed %s", SimLevels[index].Name);
+        SimRuns[1U + index].Name = fixedNames[index];
+        SimRuns[1U + index].FixedLevel = (int) index;
+    }
+    for (index = 0U; index < (1U + SimSetup.LevelCount); index++)
+    {
+        Run(&SimRuns[index]);
+        /* Only the adaptive run goes into the CSV */
+        if ((0U == index) && (NULL != SimCsv))
+        {
+            fclose(SimCsv);
+            SimCsv = NULL;
+        }
+    }
+    PrintReport();
+    return (0U == SimErrors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
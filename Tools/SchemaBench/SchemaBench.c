@@ -0,0 +1,334 @@
+/**
+ *  @file
+ *
+ *  @brief Host encoder / decoder pair and size benchmark of the values only
+ *  upload (SensorSchema, APP_UPLOAD_ENCODING_SCHEMA of XDK110_Dashboard and
+ *  POST_SCHEMA_ENABLE of HttpExample).
+ *
+ *  A synthetic 1 Hz trace is posted twice, every sample as the JSON body of
+ *  the firmware and as a SensorSchema message. The messages go through a
+ *  stand-in of the server, which keeps the schemas it was sent by hash,
+ *  answers SENSOR_SCHEMA_STATUS_UNKNOWN to values of an unknown one and
+ *  forgets all of them every --restart posts, as a restarted server does. The
+ *  device side reacts as the firmware does: the same values once more, with
+ *  the schema attached. Every decoded value is compared bit by bit with the
+ *  posted one (exit code 1 on a mismatch).
+ *
+ *  Prints per post the body, the HTTP request, the same over TLS, the BLE
+ *  notifications and whether it fits a LoRaWAN uplink at the lowest data
+ *  rate, for JSON and for the values only messages, the schema announcements
+ *  included, and the encode and decode cost.
+ *
+ *  Usage: SchemaBench [--samples n] [--channels mask] [--restart posts]
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "HttpMessage.h"
+#include "SensorSchema.h"
+#include "SensorSnapshot.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* constant definitions ***************************************************** */
+
+#define BENCH_BODY_SIZE             512U    /**< APP_PAYLOAD_BUFFER_SIZE of the firmware */
+#define BENCH_HEAD_SIZE             512U
+#define BENCH_HOST                  "fas-webteach.sunderland.ac.uk" /**< DEST_SERVER_HOST */
+#define BENCH_PATH                  "/~ex0eby/sendValuesToDatabase.php" /**< DEST_POST_PATH */
+#define BENCH_TLS_RECORD_OVERHEAD   29U     /**< Record header, explicit nonce and tag of AES-GCM */
+#define BENCH_BLE_PAYLOAD           20U     /**< BLE_STREAM_PAYLOAD_SIZE */
+#define BENCH_LORA_DR0_PAYLOAD      51U     /**< EU868 DR0 */
+#define BENCH_MAX_SCHEMAS           4U
+
+/* local type definitions *************************************************** */
+
+/**
+ * @brief Bytes of one encoding over the run.
+ */
+struct BenchTotals_S
+{
+    uint64_t Posts;
+    uint64_t Body;
+    uint64_t Http;
+    uint64_t Tls;
+    uint64_t BleNotifications;
+    uint64_t LoRaFits; /**< Posts within BENCH_LORA_DR0_PAYLOAD */
+    uint32_t MinBody;
+    uint32_t MaxBody;
+    uint64_t EncodeNs;
+};
+typedef struct BenchTotals_S BenchTotals_T;
+
+/* local variables ********************************************************** */
+
+static SensorSchema_Description_T ServerSchemas[BENCH_MAX_SCHEMAS]; /**< Schemas the server stand-in knows */
+
+/* local functions ********************************************************** */
+
+static uint64_t BenchNowNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+}
+
+/**
+ * @brief The trace of Tools/TimeSeriesBench, 1 Hz samples of an office desk.
+ */
+static void SyntheticSample(size_t index, SensorSnapshot_T * sample, uint32_t * seed)
+{
+    double t = (double) index;
+    int32_t noise;
+
+    *seed = (*seed * 1103515245U) + 12345U;
+    noise = (int32_t) ((*seed >> 16) % 5U) - 2;
+
+    sample->TimestampMs = (uint32_t) (index * 1000U);
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = (float) (0.0 + (noise * 0.01));
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = 0.0f;
+    sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = (float) (9.0 + ((noise > 1) ? 1.0 : 0.0));
+    sample->Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = (float) (0.02 + (0.001 * noise));
+    sample->Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (120000.0 + (20000.0 * sin(t / 3600.0)));
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = noise * 61;
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = -noise * 61;
+    sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = 0;
+    sample->Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) (45.0 + (2.0 * sin(t / 1800.0)));
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = 21 + ((noise > 0) ? 1 : 0);
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = -3;
+    sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = -40 + ((noise < 0) ? -1 : 0);
+    sample->Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) (101325.0 + (50.0 * sin(t / 900.0))) + noise;
+    sample->Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) (22000.0 + (500.0 * sin(t / 2400.0))) + (noise * 10);
+}
+
+static void BenchCount(BenchTotals_T * totals, const char * contentType, uint32_t bodyLength, uint64_t encodeNs)
+{
+    char head[BENCH_HEAD_SIZE];
+    HttpMessage_Request_T request =
+            {
+                    .Method = "POST",
+                    .Host = BENCH_HOST,
+                    .Path = BENCH_PATH,
+                    .ContentType = contentType,
+                    .ContentLength = bodyLength,
+            };
+    uint32_t http = HttpMessage_WriteRequestHead(head, sizeof(head), &request) + bodyLength;
+
+    if ((0UL == totals->Posts) || (bodyLength < totals->MinBody))
+    {
+        totals->MinBody = bodyLength;
+    }
+    if (bodyLength > totals->MaxBody)
+    {
+        totals->MaxBody = bodyLength;
+    }
+    totals->Posts++;
+    totals->Body += bodyLength;
+    totals->Http += http;
+    /* Head and body go out as one record, see HttpsSession */
+    totals->Tls += http + BENCH_TLS_RECORD_OVERHEAD;
+    totals->BleNotifications += (bodyLength + BENCH_BLE_PAYLOAD - 1U) / BENCH_BLE_PAYLOAD;
+    totals->LoRaFits += (bodyLength <= BENCH_LORA_DR0_PAYLOAD) ? 1U : 0U;
+    totals->EncodeNs += encodeNs;
+}
+
+/**
+ * @brief The server side: looks up the schema of the message hash and decodes.
+ *
+ * @param[out] used
+ * Schema the values were decoded with
+ *
+ * @return HTTP status of the response.
+ */
+static uint16_t ServerReceive(const uint8_t * message, uint32_t length, SensorTable_Value_T * values, const SensorSchema_Description_T ** used,
+        uint64_t * decodeNs)
+{
+    SensorSchema_Description_T * description = NULL;
+    SensorSchema_Result_T result;
+    uint64_t start = BenchNowNs();
+    uint32_t hash;
+    uint32_t index;
+
+    if (!SensorSchema_GetHash(message, length, &hash, NULL))
+    {
+        return 400U;
+    }
+    for (index = 0U; index < BENCH_MAX_SCHEMAS; index++)
+    {
+        if ((0U != ServerSchemas[index].ChannelCount) && (ServerSchemas[index].Hash == hash))
+        {
+            description = &ServerSchemas[index];
+            break;
+        }
+        if ((NULL == description) && (0U == ServerSchemas[index].ChannelCount))
+        {
+            description = &ServerSchemas[index];
+        }
+    }
+    if (NULL == description)
+    {
+        return 503U;
+    }
+    result = SensorSchema_Decode(message, length, description, values);
+    *decodeNs += BenchNowNs() - start;
+    *used = description;
+    if (SENSOR_SCHEMA_RESULT_UNKNOWN == result)
+    {
+        return SENSOR_SCHEMA_STATUS_UNKNOWN;
+    }
+    return (SENSOR_SCHEMA_RESULT_OK == result) ? 200U : 400U;
+}
+
+/**
+ * @brief Compares the decoded values with the posted ones.
+ */
+static bool BenchCheck(const SensorSchema_Description_T * description, const SensorTable_Value_T * posted, const SensorTable_Value_T * decoded,
+        uint32_t channelMask)
+{
+    uint8_t index;
+    uint8_t channel;
+
+    for (index = 0U, channel = 0U; channel < SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        if (0UL == (channelMask & (1UL << channel)))
+        {
+            continue;
+        }
+        if ((index >= description->ChannelCount) || (description->Channels[index].Channel != channel) ||
+                (0 != strcmp(description->Channels[index].Key, SensorTable_GetChannelKey(channel))) ||
+                (posted[channel].Bits != decoded[index].Bits))
+        {
+            return false;
+        }
+        index++;
+    }
+    return (index == description->ChannelCount);
+}
+
+static void BenchPrint(const char * name, const BenchTotals_T * totals, uint64_t samples)
+{
+    printf("%-12s %8.1f %5lu..%-5lu %8.1f %8.1f %8.2f %9.1f %%   %8.0f\n", name,
+            (double) totals->Body / (double) samples, (unsigned long) totals->MinBody, (unsigned long) totals->MaxBody,
+            (double) totals->Http / (double) samples, (double) totals->Tls / (double) samples,
+            (double) totals->BleNotifications / (double) samples, (100.0 * (double) totals->LoRaFits) / (double) totals->Posts,
+            (double) totals->EncodeNs / (double) totals->Posts);
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    SensorSnapshot_T sample;
+    SensorSchema_T schema;
+    const SensorSchema_Description_T * description = NULL;
+    SensorTable_Value_T decoded[SENSOR_SCHEMA_MAX_CHANNELS];
+    uint8_t body[BENCH_BODY_SIZE];
+    PayloadWriter_T writer;
+    BenchTotals_T json = { 0 };
+    BenchTotals_T values = { 0 };
+    uint64_t samples = 3600U;
+    uint64_t restart = 0U;
+    uint64_t index;
+    uint64_t start;
+    uint64_t decodeNs = 0U;
+    uint64_t announcements = 0U;
+    uint64_t unknown = 0U;
+    uint64_t mismatches = 0U;
+    uint64_t lost = 0U;
+    uint32_t channelMask = SENSOR_TABLE_ALL_CHANNELS;
+    uint32_t seed = 12345U;
+    uint16_t status;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        if ((0 == strcmp(argv[arg], "--samples")) && ((arg + 1) < argc))
+        {
+            samples = strtoull(argv[++arg], NULL, 10);
+        }
+        else if ((0 == strcmp(argv[arg], "--channels")) && ((arg + 1) < argc))
+        {
+            channelMask = (uint32_t) strtoul(argv[++arg], NULL, 0);
+        }
+        else if ((0 == strcmp(argv[arg], "--restart")) && ((arg + 1) < argc))
+        {
+            restart = strtoull(argv[++arg], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--samples n] [--channels mask] [--restart posts]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((0U == samples) || !SensorSchema_Init(&schema, channelMask))
+    {
+        fprintf(stderr, "no samples or invalid channel mask 0x%lx\n", (unsigned long) channelMask);
+        return EXIT_FAILURE;
+    }
+
+    for (index = 0U; index < samples; index++)
+    {
+        SyntheticSample((size_t) index, &sample, &seed);
+        if ((0U != restart) && (0U != index) && (0U == (index % restart)))
+        {
+            memset(ServerSchemas, 0, sizeof(ServerSchemas));
+        }
+
+        start = BenchNowNs();
+        PayloadWriter_Init(&writer, body, sizeof(body), 0UL, NULL, NULL);
+        (void) SensorTable_WriteJson(sample.Values, channelMask, &writer);
+        if (!PayloadWriter_Finish(&writer))
+        {
+            fprintf(stderr, "JSON body larger than %u bytes\n", BENCH_BODY_SIZE);
+            return EXIT_FAILURE;
+        }
+        BenchCount(&json, "application/json", writer.Length, BenchNowNs() - start);
+
+        do
+        {
+            start = BenchNowNs();
+            announcements += schema.IsAnnounced ? 0U : 1U;
+            PayloadWriter_Init(&writer, body, sizeof(body), 0UL, NULL, NULL);
+            (void) SensorSchema_WriteMessage(&schema, sample.Values, &writer);
+            if (!PayloadWriter_Finish(&writer))
+            {
+                fprintf(stderr, "message larger than %u bytes\n", BENCH_BODY_SIZE);
+                return EXIT_FAILURE;
+            }
+            BenchCount(&values, "application/octet-stream", writer.Length, BenchNowNs() - start);
+            status = ServerReceive(body, writer.Length, decoded, &description, &decodeNs);
+            unknown += (SENSOR_SCHEMA_STATUS_UNKNOWN == status) ? 1U : 0U;
+        } while (SensorSchema_HandleStatus(&schema, status));
+
+        if (200U != status)
+        {
+            lost++;
+        }
+        else if (!BenchCheck(description, sample.Values, decoded, channelMask))
+        {
+            mismatches++;
+        }
+    }
+
+    printf("%lu samples, channels 0x%04lx, schema hash 0x%08lx, server restart every %lu posts\n", (unsigned long) samples,
+            (unsigned long) channelMask, (unsigned long) schema.Hash, (unsigned long) restart);
+    printf("%-12s %8s %12s %8s %8s %8s %11s %10s\n", "per sample", "body B", "min..max", "HTTP B", "TLS B", "BLE ntf", "LoRa DR0",
+            "encode ns");
+    BenchPrint("JSON", &json, samples);
+    BenchPrint("values only", &values, samples);
+    printf("body %.1fx smaller, HTTP request %.1fx, TLS %.1fx\n", (double) json.Body / (double) values.Body,
+            (double) json.Http / (double) values.Http, (double) json.Tls / (double) values.Tls);
+    printf("posts %lu for %lu samples: %lu schema announcements, %lu answered %u; decode %.0f ns per message\n",
+            (unsigned long) values.Posts, (unsigned long) samples, (unsigned long) announcements, (unsigned long) unknown,
+            (unsigned int) SENSOR_SCHEMA_STATUS_UNKNOWN, (double) decodeNs / (double) values.Posts);
+    printf("decoded values: %lu mismatches, %lu samples not accepted\n", (unsigned long) mismatches, (unsigned long) lost);
+    return ((0U == mismatches) && (0U == lost)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,680 @@
+/**
+ *  @file
+ *
+ *  @brief Deterministic host replay of XDK110_Dashboard sensor traces.
+ *
+ *  Decodes a trace recorded with APP_SENSOR_TRACE_ENABLE (or generates one)
+ *  and replays it in virtual time, as fast as the host allows, through the
+ *  same path the firmware takes: every read is applied to the latest snapshot
+ *  the way SensorComponent does, the snapshot timer appends to the compressed
+ *  sample batch, the batch is swapped every post interval and the JSON body is
+ *  formatted. Every batch is decoded again and checked against the snapshots
+ *  that went in.
+ *
+ *  The report lists per sensor the reads, the failed reads by return code and
+ *  the jitter of the read interval against the period of SensorTable, then
+ *  the samples, drops, bytes and the cost of every stage. Everything but the
+ *  cost is a pure function of the trace, so two builds can be compared by
+ *  diffing the report or the --csv output.
+ *
+ *  Usage: SensorTraceReplay [options] <SENSORS.TRC>
+ *         SensorTraceReplay [options] --synthetic <seconds>
+ *    --fail <permille>     failed reads injected into the synthetic trace, default 5
+ *    --record <file>       also write the synthetic trace to a file
+ *    --csv <file>          write every snapshot as TimeSeriesBench CSV
+ *    --snapshot <ms>       snapshot timer period, default 1000
+ *    --post <ms>           batch swap interval, default 10000 (INTER_REQUEST_INTERVAL)
+ *    --batch <bytes>       batch size, default 512 (APP_SAMPLE_BATCH_SIZE)
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "SensorSnapshot.h"
+#include "SensorTable.h"
+#include "SensorTrace.h"
+#include "TimeSeriesCompressor.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* constant definitions ***************************************************** */
+
+#define REPLAY_CHUNK_SIZE           512U  /**< SENSOR_TRACE_AGENT_CHUNK_SIZE of the firmware */
+#define REPLAY_JSON_SIZE            512U  /**< APP_PAYLOAD_BUFFER_SIZE of the firmware */
+#define REPLAY_JITTER_BUCKETS       1001U /**< Read interval deviation histogram, 1 ms buckets, the last one open */
+#define REPLAY_MAX_RETCODES         8U    /**< Distinct return codes listed per sensor */
+#define REPLAY_SYNTHETIC_FAILURE    UINT32_C(0x0B002005) /**< Stand-in driver error, laid out like a BCDS return code */
+
+/* local types ************************************************************** */
+
+struct ReplaySensor_S
+{
+    uint32_t Reads;
+    uint32_t Failed;
+    uint32_t Retcodes[REPLAY_MAX_RETCODES];
+    uint32_t RetcodeCounts[REPLAY_MAX_RETCODES];
+    uint32_t LastMs;
+    bool HasLast;
+    uint32_t Jitter[REPLAY_JITTER_BUCKETS];
+    uint32_t Intervals;
+};
+typedef struct ReplaySensor_S ReplaySensor_T;
+
+struct ReplayConfig_S
+{
+    const char * TracePath;
+    uint32_t SyntheticSeconds;
+    uint32_t FailPermille;
+    const char * RecordPath;
+    const char * CsvPath;
+    uint32_t SnapshotMs;
+    uint32_t PostMs;
+    uint32_t BatchSize;
+};
+typedef struct ReplayConfig_S ReplayConfig_T;
+
+/* local variables ********************************************************** */
+
+static ReplayConfig_T ReplayConfig =
+        {
+                .FailPermille = 5U,
+                .SnapshotMs = 1000U,
+                .PostMs = 10000U,
+                .BatchSize = 512U,
+        };
+
+static ReplaySensor_T ReplaySensors[SENSOR_TABLE_SENSOR_COUNT];
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Cycle counter of the host, nanoseconds where no cycle counter is available.
+ */
+static uint64_t ReplayNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+#endif
+}
+
+static const char * ReplayUnit(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+static double ReplayWallSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + ((double) now.tv_nsec / 1e9);
+}
+
+static uint8_t * LoadFile(const char * path, uint32_t * length)
+{
+    FILE * file = fopen(path, "rb");
+    uint8_t * data;
+    long fileSize;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc((size_t) fileSize + 1U);
+    if ((NULL == data) || (fread(data, 1, (size_t) fileSize, file) != (size_t) fileSize))
+    {
+        fclose(file);
+        free(data);
+        return NULL;
+    }
+    fclose(file);
+    *length = (uint32_t) fileSize;
+    return data;
+}
+
+/**
+ * @brief Value of a channel of the synthetic desk top recording, see TimeSeriesBench.
+ */
+static SensorTable_Value_T SyntheticValue(uint8_t channel, double t, int32_t noise)
+{
+    SensorTable_Value_T value;
+
+    value.Bits = 0UL;
+    switch (channel)
+    {
+    case SENSOR_TABLE_CHANNEL_ACCELEROMETER_X:
+        value.Float = (float) (noise * 0.01);
+        break;
+    case SENSOR_TABLE_CHANNEL_ACCELEROMETER_Z:
+        value.Float = (float) (9.0 + ((noise > 1) ? 1.0 : 0.0));
+        break;
+    case SENSOR_TABLE_CHANNEL_ACOUSTIC:
+        value.Float = (float) (0.02 + (0.001 * noise));
+        break;
+    case SENSOR_TABLE_CHANNEL_LIGHT:
+        value.Int = (int32_t) (120000.0 + (20000.0 * sin(t / 3600.0)));
+        break;
+    case SENSOR_TABLE_CHANNEL_GYROSCOPE_X:
+        value.Int = noise * 61;
+        break;
+    case SENSOR_TABLE_CHANNEL_GYROSCOPE_Y:
+        value.Int = -noise * 61;
+        break;
+    case SENSOR_TABLE_CHANNEL_HUMIDITY:
+        value.Int = (int32_t) (45.0 + (2.0 * sin(t / 1800.0)));
+        break;
+    case SENSOR_TABLE_CHANNEL_MAGNETOMETER_X:
+        value.Int = 21 + ((noise > 0) ? 1 : 0);
+        break;
+    case SENSOR_TABLE_CHANNEL_MAGNETOMETER_Y:
+        value.Int = -3;
+        break;
+    case SENSOR_TABLE_CHANNEL_MAGNETOMETER_Z:
+        value.Int = -40 + ((noise < 0) ? -1 : 0);
+        break;
+    case SENSOR_TABLE_CHANNEL_PRESSURE:
+        value.Int = (int32_t) (101325.0 + (50.0 * sin(t / 900.0))) + noise;
+        break;
+    case SENSOR_TABLE_CHANNEL_TEMPERATURE:
+        value.Int = (int32_t) (22000.0 + (500.0 * sin(t / 2400.0))) + (noise * 10);
+        break;
+    default:
+        break;
+    }
+    return value;
+}
+
+/**
+ * @brief Generates a trace the way SensorTraceAgent writes it: every sensor read
+ * at its SensorTable period with a few ms of jitter, some reads failing.
+ */
+static uint8_t * SyntheticTrace(uint32_t seconds, uint32_t failPermille, uint32_t * length)
+{
+    uint32_t nextMs[SENSOR_TABLE_SENSOR_COUNT];
+    uint32_t capacity = SENSOR_TRACE_HEADER_SIZE + REPLAY_CHUNK_SIZE;
+    uint32_t endMs = seconds * 1000U;
+    uint32_t seed = 12345U;
+    uint8_t chunk[REPLAY_CHUNK_SIZE];
+    uint8_t * data = malloc(capacity);
+    SensorTrace_Writer_T writer;
+    SensorTrace_Record_T record;
+    uint8_t sensor;
+    uint8_t channel;
+    uint32_t chunkLength;
+
+    if (NULL == data)
+    {
+        return NULL;
+    }
+    *length = SensorTrace_WriteHeader(data, capacity);
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        /* the sensor timers start one after the other during boot */
+        nextMs[sensor] = 150U + (sensor * 37U);
+    }
+    (void) SensorTrace_InitWriter(&writer, chunk, sizeof(chunk));
+    for (;;)
+    {
+        /* next read due, the real-time lane runs them one at a time */
+        uint8_t due = 0U;
+        for (sensor = 1U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+        {
+            if (nextMs[sensor] < nextMs[due])
+            {
+                due = sensor;
+            }
+        }
+        if (nextMs[due] >= endMs)
+        {
+            break;
+        }
+        seed = (seed * 1103515245U) + 12345U;
+        record.TimestampMs = nextMs[due] + ((seed >> 8) % 4U);
+        record.Sensor = due;
+        record.Retcode = (((seed >> 12) % 1000U) < failPermille) ? REPLAY_SYNTHETIC_FAILURE : 0UL;
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            record.Values[channel] = SyntheticValue(channel, (double) record.TimestampMs / 1000.0, (int32_t) ((seed >> 16) % 5U) - 2);
+        }
+        nextMs[due] += SensorTable_GetSensorPeriodMs(due);
+
+        if (!SensorTrace_Append(&writer, &record))
+        {
+            chunkLength = SensorTrace_FinishChunk(&writer);
+            if ((*length + chunkLength) > capacity)
+            {
+                capacity *= 2U;
+                data = realloc(data, capacity);
+                if (NULL == data)
+                {
+                    return NULL;
+                }
+            }
+            memcpy(&data[*length], chunk, chunkLength);
+            *length += chunkLength;
+            (void) SensorTrace_InitWriter(&writer, chunk, sizeof(chunk));
+            (void) SensorTrace_Append(&writer, &record);
+        }
+    }
+    chunkLength = SensorTrace_FinishChunk(&writer);
+    if ((*length + chunkLength) > capacity)
+    {
+        data = realloc(data, *length + chunkLength);
+        if (NULL == data)
+        {
+            return NULL;
+        }
+    }
+    memcpy(&data[*length], chunk, chunkLength);
+    *length += chunkLength;
+    return data;
+}
+
+static void CountRead(const SensorTrace_Record_T * record)
+{
+    ReplaySensor_T * sensor = &ReplaySensors[record->Sensor];
+    uint32_t periodMs = SensorTable_GetSensorPeriodMs(record->Sensor);
+    uint32_t deviation;
+    uint8_t index;
+
+    sensor->Reads++;
+    if (sensor->HasLast)
+    {
+        uint32_t interval = record->TimestampMs - sensor->LastMs;
+        deviation = (interval > periodMs) ? (interval - periodMs) : (periodMs - interval);
+        sensor->Jitter[(deviation < REPLAY_JITTER_BUCKETS) ? deviation : (REPLAY_JITTER_BUCKETS - 1U)]++;
+        sensor->Intervals++;
+    }
+    sensor->LastMs = record->TimestampMs;
+    sensor->HasLast = true;
+    if (0UL == record->Retcode)
+    {
+        return;
+    }
+    sensor->Failed++;
+    for (index = 0U; index < REPLAY_MAX_RETCODES; index++)
+    {
+        if ((0UL == sensor->RetcodeCounts[index]) || (sensor->Retcodes[index] == record->Retcode))
+        {
+            sensor->Retcodes[index] = record->Retcode;
+            sensor->RetcodeCounts[index]++;
+            break;
+        }
+    }
+}
+
+static uint32_t JitterPercentile(const ReplaySensor_T * sensor, uint32_t permille)
+{
+    uint64_t target = (((uint64_t) sensor->Intervals * permille) + 999U) / 1000U;
+    uint64_t seen = 0U;
+    uint32_t bucket;
+
+    for (bucket = 0U; bucket < REPLAY_JITTER_BUCKETS; bucket++)
+    {
+        seen += sensor->Jitter[bucket];
+        if ((seen >= target) && (0U != seen))
+        {
+            return bucket;
+        }
+    }
+    return REPLAY_JITTER_BUCKETS - 1U;
+}
+
+static void WriteCsvHeader(FILE * csv)
+{
+    uint8_t channel;
+
+    fprintf(csv, "timestamp_ms");
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        fprintf(csv, ",%s", SensorSnapshot_GetChannelName(channel));
+    }
+    fprintf(csv, "\n");
+}
+
+static void WriteCsvSample(FILE * csv, const SensorSnapshot_T * snapshot)
+{
+    uint8_t channel;
+
+    fprintf(csv, "%lu", (unsigned long) snapshot->TimestampMs);
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        if (0U != (SENSOR_SNAPSHOT_FLOAT_MASK & (1U << channel)))
+        {
+            fprintf(csv, ",%f", (double) snapshot->Values[channel].Float);
+        }
+        else
+        {
+            fprintf(csv, ",%ld", (long) snapshot->Values[channel].Int);
+        }
+    }
+    fprintf(csv, "\n");
+}
+
+/**
+ * @brief Decodes a finished batch and compares it with the snapshots appended to it.
+ *
+ * @return Number of samples which differ or are missing.
+ */
+static uint32_t CheckBatch(const uint8_t * buffer, uint32_t length, const SensorSnapshot_T * expected, uint32_t count)
+{
+    TimeSeriesDecompressor_T decompressor;
+    uint32_t values[SENSOR_SNAPSHOT_CHANNEL_COUNT];
+    uint32_t timestamp;
+    uint32_t mismatches = 0U;
+
+    if (!TimeSeriesDecompressor_Init(&decompressor, buffer, length))
+    {
+        return count;
+    }
+    while (TimeSeriesDecompressor_Next(&decompressor, &timestamp, values))
+    {
+        if ((decompressor.SampleIndex > count) || (timestamp != expected[decompressor.SampleIndex - 1U].TimestampMs) ||
+                (0 != memcmp(values, expected[decompressor.SampleIndex - 1U].Values, sizeof(values))))
+        {
+            mismatches++;
+        }
+    }
+    if (decompressor.SampleIndex < count)
+    {
+        mismatches += count - decompressor.SampleIndex;
+    }
+    return mismatches;
+}
+
+static int Replay(const uint8_t * trace, uint32_t length, FILE * csv)
+{
+    SensorTrace_Reader_T reader;
+    SensorTrace_Record_T record;
+    SensorSnapshot_T latest;
+    TimeSeriesCompressor_T batch;
+    uint8_t * batchBuffer = malloc(ReplayConfig.BatchSize);
+    SensorSnapshot_T * batchSamples = NULL;
+    uint32_t batchCapacity = 0U;
+    uint32_t batchCount = 0U;
+    char json[REPLAY_JSON_SIZE];
+    uint64_t applyTicks = 0U;
+    uint64_t compressTicks = 0U;
+    uint64_t jsonTicks = 0U;
+    uint64_t start;
+    uint32_t records = 0U;
+    uint32_t snapshots = 0U;
+    uint32_t dropped = 0U;
+    uint32_t batches = 0U;
+    uint32_t mismatches = 0U;
+    uint64_t compressedBytes = 0U;
+    uint64_t jsonBytes = 0U;
+    uint32_t firstMs = 0U;
+    uint32_t nowMs = 0U;
+    uint32_t snapshotDueMs = 0U;
+    uint32_t postDueMs = 0U;
+    double wallStart;
+    double wallSeconds;
+    bool hasRecord;
+    uint8_t sensor;
+    uint8_t index;
+
+    if ((NULL == batchBuffer) || !SensorTrace_InitReader(&reader, trace, length))
+    {
+        fprintf(stderr, "not a sensor trace of this sensor table\n");
+        free(batchBuffer);
+        return EXIT_FAILURE;
+    }
+    memset(&latest, 0, sizeof(latest));
+    (void) TimeSeriesCompressor_Init(&batch, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, batchBuffer, ReplayConfig.BatchSize);
+    if (NULL != csv)
+    {
+        WriteCsvHeader(csv);
+    }
+
+    wallStart = ReplayWallSeconds();
+    hasRecord = SensorTrace_Next(&reader, &record);
+    if (hasRecord)
+    {
+        firstMs = record.TimestampMs;
+        snapshotDueMs = firstMs + ReplayConfig.SnapshotMs;
+        postDueMs = firstMs + ReplayConfig.PostMs;
+    }
+    while (hasRecord)
+    {
+        /* virtual time: the earliest of the next read, snapshot and post */
+        if (hasRecord && (record.TimestampMs < snapshotDueMs) && (record.TimestampMs < postDueMs))
+        {
+            nowMs = record.TimestampMs;
+            start = ReplayNow();
+            (void) SensorTrace_Apply(&record, latest.Values);
+            applyTicks += ReplayNow() - start;
+            CountRead(&record);
+            records++;
+            hasRecord = SensorTrace_Next(&reader, &record);
+            continue;
+        }
+        if (snapshotDueMs <= postDueMs)
+        {
+            nowMs = snapshotDueMs;
+            snapshotDueMs += ReplayConfig.SnapshotMs;
+            latest.TimestampMs = nowMs;
+            snapshots++;
+            start = ReplayNow();
+            if (!TimeSeriesCompressor_Append(&batch, latest.TimestampMs, &latest.Values[0].Bits))
+            {
+                compressTicks += ReplayNow() - start;
+                dropped++;
+            }
+            else
+            {
+                compressTicks += ReplayNow() - start;
+                if (batchCount == batchCapacity)
+                {
+                    batchCapacity = (0U == batchCapacity) ? 64U : (batchCapacity * 2U);
+                    batchSamples = realloc(batchSamples, batchCapacity * sizeof(*batchSamples));
+                    if (NULL == batchSamples)
+                    {
+                        free(batchBuffer);
+                        return EXIT_FAILURE;
+                    }
+                }
+                batchSamples[batchCount++] = latest;
+            }
+            start = ReplayNow();
+            jsonBytes += SensorSnapshot_ToJson(&latest, json, sizeof(json));
+            jsonTicks += ReplayNow() - start;
+            if (NULL != csv)
+            {
+                WriteCsvSample(csv, &latest);
+            }
+        }
+        else
+        {
+            nowMs = postDueMs;
+            postDueMs += ReplayConfig.PostMs;
+            start = ReplayNow();
+            compressedBytes += TimeSeriesCompressor_Finish(&batch);
+            compressTicks += ReplayNow() - start;
+            mismatches += CheckBatch(batchBuffer, ReplayConfig.BatchSize, batchSamples, batchCount);
+            batches++;
+            batchCount = 0U;
+            (void) TimeSeriesCompressor_Init(&batch, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, batchBuffer, ReplayConfig.BatchSize);
+        }
+    }
+    if (0U != batchCount)
+    {
+        compressedBytes += TimeSeriesCompressor_Finish(&batch);
+        mismatches += CheckBatch(batchBuffer, ReplayConfig.BatchSize, batchSamples, batchCount);
+        batches++;
+    }
+    wallSeconds = ReplayWallSeconds() - wallStart;
+
+    printf("trace              : %lu bytes, %lu reads over %.1f s%s\n", (unsigned long) length, (unsigned long) records,
+            (double) (nowMs - firstMs) / 1000.0, reader.IsTruncated ? ", truncated" : "");
+    printf("sensor             reads    failed   jitter p50 / p99 ms (period ms)\n");
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        const ReplaySensor_T * stats = &ReplaySensors[sensor];
+        if (0U == stats->Reads)
+        {
+            continue;
+        }
+        printf("  %-16s %7lu  %7lu   %4lu / %4lu (%lu)\n", SensorTable_GetSensorName(sensor), (unsigned long) stats->Reads,
+                (unsigned long) stats->Failed, (unsigned long) JitterPercentile(stats, 500U), (unsigned long) JitterPercentile(stats, 990U),
+                (unsigned long) SensorTable_GetSensorPeriodMs(sensor));
+        for (index = 0U; (index < REPLAY_MAX_RETCODES) && (0U != stats->RetcodeCounts[index]); index++)
+        {
+            printf("    retcode 0x%08lX (module %lu, severity %lu, code %lu) : %lu\n", (unsigned long) stats->Retcodes[index],
+                    (unsigned long) ((stats->Retcodes[index] >> 16) & 0xFFUL), (unsigned long) ((stats->Retcodes[index] >> 12) & 0xFUL),
+                    (unsigned long) (stats->Retcodes[index] & 0xFFFUL), (unsigned long) stats->RetcodeCounts[index]);
+        }
+    }
+    printf("snapshots          : %lu, %lu dropped\n", (unsigned long) snapshots, (unsigned long) dropped);
+    printf("batches            : %lu (%lu bytes each), %.1f compressed bytes per sample\n", (unsigned long) batches,
+            (unsigned long) ReplayConfig.BatchSize, (0U == snapshots) ? 0.0 : ((double) compressedBytes / (double) snapshots));
+    printf("JSON bytes         : %.1f per sample\n", (0U == snapshots) ? 0.0 : ((double) jsonBytes / (double) snapshots));
+    printf("round trip         : %s\n", (0U == mismatches) ? "OK" : "MISMATCH");
+    printf("apply              : %.0f %s/read\n", (0U == records) ? 0.0 : ((double) applyTicks / (double) records), ReplayUnit());
+    printf("compress           : %.0f %s/sample\n", (0U == snapshots) ? 0.0 : ((double) compressTicks / (double) snapshots), ReplayUnit());
+    printf("JSON               : %.0f %s/sample\n", (0U == snapshots) ? 0.0 : ((double) jsonTicks / (double) snapshots), ReplayUnit());
+    printf("replay             : %.3f s, %.0fx real time\n", wallSeconds,
+            (wallSeconds > 0.0) ? (((double) (nowMs - firstMs) / 1000.0) / wallSeconds) : 0.0);
+
+    free(batchSamples);
+    free(batchBuffer);
+    return (0U == mismatches) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void Usage(const char * name)
+{
+    fprintf(stderr, "usage: %s [options] <SENSORS.TRC>\n"
+            "       %s [options] --synthetic <seconds>\n"
+            "  --fail <permille> --record <file> --csv <file> --snapshot <ms> --post <ms> --batch <bytes>\n", name, name);
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    uint8_t * trace;
+    uint32_t length = 0U;
+    FILE * csv = NULL;
+    FILE * record;
+    int result;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        const char * option = argv[arg];
+        const char * value = ((arg + 1) < argc) ? argv[arg + 1] : NULL;
+
+        if ('-' != option[0])
+        {
+            ReplayConfig.TracePath = option;
+            continue;
+        }
+        if (NULL == value)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        arg++;
+        if (0 == strcmp(option, "--synthetic"))
+        {
+            ReplayConfig.SyntheticSeconds = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--fail"))
+        {
+            ReplayConfig.FailPermille = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--record"))
+        {
+            ReplayConfig.RecordPath = value;
+        }
+        else if (0 == strcmp(option, "--csv"))
+        {
+            ReplayConfig.CsvPath = value;
+        }
+        else if (0 == strcmp(option, "--snapshot"))
+        {
+            ReplayConfig.SnapshotMs = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--post"))
+        {
+            ReplayConfig.PostMs = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--batch"))
+        {
+            ReplayConfig.BatchSize = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (((NULL == ReplayConfig.TracePath) == (0U == ReplayConfig.SyntheticSeconds)) || (0U == ReplayConfig.SnapshotMs) ||
+            (0U == ReplayConfig.PostMs))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (0U != ReplayConfig.SyntheticSeconds)
+    {
+        trace = SyntheticTrace(ReplayConfig.SyntheticSeconds, ReplayConfig.FailPermille, &length);
+    }
+    else
+    {
+        trace = LoadFile(ReplayConfig.TracePath, &length);
+    }
+    if (NULL == trace)
+    {
+        return EXIT_FAILURE;
+    }
+    if (NULL != ReplayConfig.RecordPath)
+    {
+        record = fopen(ReplayConfig.RecordPath, "wb");
+        if ((NULL == record) || (fwrite(trace, 1, length, record) != length))
+        {
+            perror(ReplayConfig.RecordPath);
+        }
+        if (NULL != record)
+        {
+            fclose(record);
+        }
+    }
+    if (NULL != ReplayConfig.CsvPath)
+    {
+        csv = fopen(ReplayConfig.CsvPath, "w");
+        if (NULL == csv)
+        {
+            perror(ReplayConfig.CsvPath);
+            free(trace);
+            return EXIT_FAILURE;
+        }
+    }
+    result = Replay(trace, length, csv);
+    if (NULL != csv)
+    {
+        fclose(csv);
+    }
+    free(trace);
+    return result;
+}
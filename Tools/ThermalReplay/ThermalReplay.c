@@ -0,0 +1,600 @@
+/**
+ *  @file
+ *
+ *  @brief Host frame replay of the XDK110_Dashboard thermal array streaming.
+ *
+ *  Replays Grid-EYE frames through the firmware ThermalFrame the way
+ *  ThermalAgent does: the frames of a post go into a batch of
+ *  THERMAL_AGENT_BATCH_SIZE bytes which starts with a header and a key frame,
+ *  a frame which finds the batch full is dropped. Every batch is decoded on
+ *  its own again and compared with the frames.
+ *
+ *  The frames come from a CSV, 64 temperatures in degC per line as the
+ *  AMG88xx examples log them, or from a synthetic room: a background of
+ *  about 22 degC with a gradient towards a window and a slow drift, sensor
+ *  noise, and people crossing the field of view, some of them stopping for
+ *  a while.
+ *
+ *  Every deadband of the sweep, and the one given, reports the bytes per
+ *  frame, the compression against the 128 bytes of the pixel registers,
+ *  the message types, the largest decoding error, the largest batch and the
+ *  encoding and decoding time per frame. The summary mode reports the
+ *  records and the detection time per frame; a synthetic replay also checks
+ *  the presence against the people in the room. A decoding error above the
+ *  deadband, a dropped frame at the given deadband or a presence agreement
+ *  below 90 % makes the exit code 1.
+ *
+ *  Usage: ThermalReplay [options]
+ *    --frames <n>          synthetic frames, default 3000 (5 minutes at 10 fps)
+ *    --csv <file>          replay the frames of a CSV instead
+ *    --period <ms>         frame period, default 100 (THERMAL_FRAME_PERIOD_MS)
+ *    --batch <ms>          time between two posts, default 10000 (INTER_REQUEST_INTERVAL)
+ *    --deadband <LSB>      deadband in 0.25 degC, default 2 (THERMAL_DEADBAND)
+ *    --key <n>             key frame interval, default 100 (THERMAL_KEY_INTERVAL)
+ *    --noise <LSB>         peak noise of the synthetic frames, default 1
+ *    --seed <n>            seed of the synthetic room, default 4711
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "ThermalFrame.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* constant definitions ***************************************************** */
+
+#define REPLAY_BATCH_SIZE           3072U   /**< THERMAL_AGENT_BATCH_SIZE */
+#define REPLAY_THRESHOLD            6U      /**< THERMAL_PRESENCE_THRESHOLD */
+#define REPLAY_MIN_PIXELS           2U      /**< THERMAL_PRESENCE_MIN_PIXELS */
+#define REPLAY_BACKGROUND_SHIFT     7U      /**< THERMAL_BACKGROUND_SHIFT */
+#define REPLAY_MAX_FRAMES           1000000U
+#define REPLAY_LINE_SIZE            4096U
+#define REPLAY_SWEEP                { 0U, 1U, 2U, 4U }
+#define REPLAY_SWEEP_LENGTH         4U
+#define REPLAY_MIN_AGREEMENT        90.0    /**< Percent of the frames the presence has to agree on */
+#define REPLAY_ROOM_C               22.0
+#define REPLAY_PERSON_C             8.0     /**< Rise of the pixel a person fills */
+#define REPLAY_PERSON_SIGMA_PX      0.9
+
+/* local types ************************************************************** */
+
+struct ReplayResult_S
+{
+    uint8_t Deadband;
+    ThermalFrame_Statistics_T Statistics;
+    uint32_t Dropped;
+    uint32_t LargestBatch;
+    int32_t MaxError;
+    double EncodeNs;
+    double DecodeNs;
+};
+typedef struct ReplayResult_S ReplayResult_T;
+
+/* local variables ********************************************************** */
+
+static uint32_t ReplayFrameCount = 3000U;
+
+static uint32_t ReplayPeriodMs = 100U;
+
+static uint32_t ReplayBatchMs = 10000U;
+
+static uint8_t ReplayDeadband = 2U;
+
+static uint16_t ReplayKeyInterval = 100U;
+
+static double ReplayNoise = 1.0;
+
+static uint32_t ReplaySeed = 4711U;
+
+static ThermalFrame_T * ReplayFrames = NULL;
+
+static bool * ReplayPresence = NULL; /**< People in the synthetic room, NULL for a CSV */
+
+static uint8_t * ReplayBatches = NULL; /**< Batches of a run, REPLAY_BATCH_SIZE apart */
+
+static uint32_t * ReplayBatchLengths = NULL;
+
+static uint32_t ReplayErrors = 0U;
+
+/* local functions ********************************************************** */
+
+static double ReplayRandom(void)
+{
+    ReplaySeed = (ReplaySeed * 1103515245U) + 12345U;
+    return (double) ((ReplaySeed >> 8) & 0xFFFFU) / 65536.0;
+}
+
+static void Check(bool condition, const char * message)
+{
+    if (!condition)
+    {
+        printf("CHECK FAILED: %s\n", message);
+        ReplayErrors++;
+    }
+}
+
+static double ReplayNowS(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + ((double) now.tv_nsec / 1e9);
+}
+
+static int16_t ReplayToPixel(double celsius)
+{
+    double value = floor((celsius * 4.0) + 0.5);
+
+    return (int16_t) fmax(fmin(value, (double) THERMAL_FRAME_PIXEL_MAX), (double) THERMAL_FRAME_PIXEL_MIN);
+}
+
+/**
+ * @brief Fills ReplayFrames with the synthetic room.
+ *
+ * A person enters on one side, crosses at 1 to 3 pixels per second and
+ * leaves on the other, a third of them stop in the middle for up to 30 s.
+ * Between two people the room is empty for up to 20 s.
+ */
+static void ReplaySynthesize(void)
+{
+    double seconds = (double) ReplayPeriodMs / 1000.0;
+    double x = 0.0;
+    double y = 0.0;
+    double speed = 0.0;
+    double stopAt = -100.0;
+    double stopS = 0.0;
+    double emptyS = 5.0;
+    bool isPresent = false;
+    uint32_t frame;
+    uint8_t index;
+
+    for (frame = 0U; frame < ReplayFrameCount; frame++)
+    {
+        double t = (double) frame * seconds;
+        double room = REPLAY_ROOM_C + (0.5 * sin(t / 120.0)) + (t / 3600.0);
+
+        if (!isPresent)
+        {
+            emptyS -= seconds;
+            if (emptyS <= 0.0)
+            {
+                isPresent = true;
+                speed = (1.0 + (2.0 * ReplayRandom())) * ((ReplayRandom() < 0.5) ? 1.0 : -1.0);
+                x = (speed > 0.0) ? -1.5 : 8.5;
+                y = 1.0 + (5.0 * ReplayRandom());
+                stopAt = (ReplayRandom() < (1.0 / 3.0)) ? (2.5 + (2.0 * ReplayRandom())) : -100.0;
+                stopS = 30.0 * ReplayRandom();
+            }
+        }
+        else
+        {
+            if ((stopS > 0.0) && (fabs(x - stopAt) < 0.2))
+            {
+                stopS -= seconds;
+            }
+            else
+            {
+                x += speed * seconds;
+            }
+            if ((x < -2.0) || (x > 9.0))
+            {
+                isPresent = false;
+                emptyS = 20.0 * ReplayRandom();
+            }
+        }
+        ReplayPresence[frame] = isPresent && (x > -0.5) && (x < 7.5);
+
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            double column = (double) (index % THERMAL_FRAME_WIDTH);
+            double row = (double) (index / THERMAL_FRAME_WIDTH);
+            double celsius = room + (0.25 * column) - (0.1 * row);
+            double distance;
+
+            if (isPresent)
+            {
+                distance = ((column - x) * (column - x)) + ((row - y) * (row - y) * 0.5);
+                celsius += REPLAY_PERSON_C * exp(-distance / (2.0 * REPLAY_PERSON_SIGMA_PX * REPLAY_PERSON_SIGMA_PX));
+            }
+            celsius += (ReplayNoise * 0.25) * ((2.0 * ReplayRandom()) - 1.0);
+            ReplayFrames[frame].Pixels[index] = ReplayToPixel(celsius);
+        }
+    }
+}
+
+/**
+ * @return false for an unreadable file or a line without 64 values.
+ */
+static bool ReplayLoadCsv(const char * path)
+{
+    static char line[REPLAY_LINE_SIZE];
+    FILE * file = fopen(path, "r");
+    uint32_t number = 0U;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return false;
+    }
+    ReplayFrameCount = 0U;
+    while ((NULL != fgets(line, sizeof(line), file)) && (ReplayFrameCount < REPLAY_MAX_FRAMES))
+    {
+        char * cursor = line;
+        char * end;
+        uint8_t index;
+
+        number++;
+        if ((line[0] < '0' || line[0] > '9') && ('-' != line[0]))
+        {
+            continue; /* Header or empty line */
+        }
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            double celsius = strtod(cursor, &end);
+
+            if (end == cursor)
+            {
+                fprintf(stderr, "%s:%u: %u values instead of 64\n", path, (unsigned int) number, (unsigned int) index);
+                fclose(file);
+                return false;
+            }
+            ReplayFrames[ReplayFrameCount].Pixels[index] = ReplayToPixel(celsius);
+            cursor = end + strspn(end, " ,;\t");
+        }
+        ReplayFrameCount++;
+    }
+    fclose(file);
+    return (0U != ReplayFrameCount);
+}
+
+static uint32_t ReplayFramesPerBatch(void)
+{
+    uint32_t frames = ReplayBatchMs / ReplayPeriodMs;
+
+    return (0U == frames) ? 1U : frames;
+}
+
+/**
+ * @brief Decodes a batch of messages and compares it with the frames from first on.
+ *
+ * @return The largest error, -1 for a malformed batch.
+ */
+static int32_t ReplayVerifyBatch(const uint8_t * batch, uint32_t length, uint32_t first, uint32_t frames)
+{
+    ThermalFrame_Decoder_T decoder;
+    ThermalFrame_T frame;
+    ThermalFrame_Mode_T mode;
+    uint16_t periodMs;
+    uint32_t offset = THERMAL_FRAME_BATCH_HEADER_SIZE;
+    uint32_t position = first - 1U;
+    uint32_t read;
+    uint32_t gap;
+    int32_t maxError = 0;
+    int32_t error;
+    uint8_t index;
+
+    if (!ThermalFrame_ReadBatchHeader(batch, length, &mode, &periodMs) || (THERMAL_FRAME_MODE_FRAMES != mode) || (periodMs != ReplayPeriodMs))
+    {
+        return -1;
+    }
+    ThermalFrame_InitDecoder(&decoder);
+    while (offset < length)
+    {
+        read = ThermalFrame_Decode(&decoder, &batch[offset], length - offset, &frame, &gap);
+        position += gap;
+        if ((0U == read) || (position >= (first + frames)))
+        {
+            return -1;
+        }
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            error = abs((int32_t) frame.Pixels[index] - (int32_t) ReplayFrames[position].Pixels[index]);
+            maxError = (error > maxError) ? error : maxError;
+        }
+        offset += read;
+    }
+    return maxError;
+}
+
+/**
+ * @brief Runs the frames through the encoder into batches, decodes them again and times both.
+ */
+static void ReplayEncode(ReplayResult_T * result)
+{
+    ThermalFrame_Encoder_T encoder;
+    ThermalFrame_Decoder_T decoder;
+    ThermalFrame_T frame;
+    uint8_t scratch[THERMAL_FRAME_MAX_MESSAGE];
+    uint32_t perBatch = ReplayFramesPerBatch();
+    uint32_t batchCount = (ReplayFrameCount + perBatch - 1U) / perBatch;
+    uint32_t batch;
+    uint32_t frameIndex;
+    uint32_t offset;
+    uint32_t read;
+    uint16_t gap = 0U;
+    int32_t error;
+    double start;
+
+    (void) ThermalFrame_InitEncoder(&encoder, result->Deadband, ReplayKeyInterval);
+    for (frameIndex = 0U; frameIndex < ReplayFrameCount; frameIndex++)
+    {
+        uint8_t * current;
+
+        batch = frameIndex / perBatch;
+        current = &ReplayBatches[(size_t) batch * REPLAY_BATCH_SIZE];
+        if (0U == (frameIndex % perBatch))
+        {
+            ThermalFrame_WriteBatchHeader(THERMAL_FRAME_MODE_FRAMES, (uint16_t) ReplayPeriodMs, current);
+            ReplayBatchLengths[batch] = THERMAL_FRAME_BATCH_HEADER_SIZE;
+            ThermalFrame_ResetEncoder(&encoder);
+            gap = 0U;
+        }
+        gap++;
+        read = ThermalFrame_Encode(&encoder, &ReplayFrames[frameIndex], gap, &current[ReplayBatchLengths[batch]],
+                REPLAY_BATCH_SIZE - ReplayBatchLengths[batch]);
+        if (0U == read)
+        {
+            result->Dropped++;
+            continue;
+        }
+        ReplayBatchLengths[batch] += read;
+        gap = 0U;
+    }
+    result->Statistics = encoder.Statistics;
+
+    for (batch = 0U; batch < batchCount; batch++)
+    {
+        frameIndex = batch * perBatch;
+        error = ReplayVerifyBatch(&ReplayBatches[(size_t) batch * REPLAY_BATCH_SIZE], ReplayBatchLengths[batch], frameIndex,
+                (ReplayFrameCount - frameIndex < perBatch) ? (ReplayFrameCount - frameIndex) : perBatch);
+        Check(error >= 0, "a batch did not decode");
+        result->MaxError = (error > result->MaxError) ? error : result->MaxError;
+        result->LargestBatch = (ReplayBatchLengths[batch] > result->LargestBatch) ? ReplayBatchLengths[batch] : result->LargestBatch;
+    }
+    Check(result->MaxError <= (int32_t) result->Deadband, "a decoded pixel is further off than the deadband");
+
+    /* Timing: the same work without the batch bookkeeping */
+    (void) ThermalFrame_InitEncoder(&encoder, result->Deadband, ReplayKeyInterval);
+    start = ReplayNowS();
+    for (frameIndex = 0U; frameIndex < ReplayFrameCount; frameIndex++)
+    {
+        if (0U == (frameIndex % perBatch))
+        {
+            ThermalFrame_ResetEncoder(&encoder);
+        }
+        (void) ThermalFrame_Encode(&encoder, &ReplayFrames[frameIndex], 1U, scratch, sizeof(scratch));
+    }
+    result->EncodeNs = ((ReplayNowS() - start) * 1e9) / (double) ReplayFrameCount;
+
+    start = ReplayNowS();
+    for (batch = 0U; batch < batchCount; batch++)
+    {
+        const uint8_t * data = &ReplayBatches[(size_t) batch * REPLAY_BATCH_SIZE];
+
+        ThermalFrame_InitDecoder(&decoder);
+        for (offset = THERMAL_FRAME_BATCH_HEADER_SIZE; offset < ReplayBatchLengths[batch]; offset += read)
+        {
+            read = ThermalFrame_Decode(&decoder, &data[offset], ReplayBatchLengths[batch] - offset, &frame, NULL);
+            if (0U == read)
+            {
+                break;
+            }
+        }
+    }
+    result->DecodeNs = ((ReplayNowS() - start) * 1e9) / (double) ReplayFrameCount;
+}
+
+/**
+ * @brief Runs the presence detector over the frames and reports the summary mode.
+ */
+static void ReplaySummaries(void)
+{
+    const ThermalFrame_PresenceSetup_T setup = { REPLAY_THRESHOLD, REPLAY_MIN_PIXELS, REPLAY_BACKGROUND_SHIFT };
+    ThermalFrame_Presence_T presence;
+    ThermalFrame_Summary_T summary;
+    ThermalFrame_Summary_T last;
+    ThermalFrame_Summary_T read;
+    uint8_t record[THERMAL_FRAME_SUMMARY_SIZE];
+    uint32_t perBatch = ReplayFramesPerBatch();
+    uint32_t records = 0U;
+    uint32_t agreed = 0U;
+    uint32_t present = 0U;
+    uint32_t bytes = 0U;
+    uint32_t frame;
+    bool hasRecord = false;
+    double start;
+    double agreement;
+
+    Check(ThermalFrame_InitPresence(&presence, &setup), "the presence setup was refused");
+    for (frame = 0U; frame < ReplayFrameCount; frame++)
+    {
+        if (0U == (frame % perBatch))
+        {
+            bytes += THERMAL_FRAME_BATCH_HEADER_SIZE;
+            hasRecord = false;
+        }
+        ThermalFrame_Detect(&presence, &ReplayFrames[frame], &summary);
+        if (!hasRecord || ThermalFrame_SummaryChanged(&last, &summary, ReplayDeadband))
+        {
+            ThermalFrame_WriteSummary(&summary, (uint16_t) (frame % perBatch), record);
+            Check((frame % perBatch) == ThermalFrame_ReadSummary(record, &read), "the frame number of a record did not read back");
+            Check((read.Presence == summary.Presence) && (read.ActivePixels == summary.ActivePixels) && (read.HotspotIndex == summary.HotspotIndex) &&
+                    (read.Hotspot == summary.Hotspot) && (read.Background == summary.Background), "a summary record did not read back");
+            last = summary;
+            hasRecord = true;
+            records++;
+            bytes += THERMAL_FRAME_SUMMARY_SIZE;
+        }
+        if (NULL != ReplayPresence)
+        {
+            agreed += (summary.Presence == ReplayPresence[frame]) ? 1U : 0U;
+            present += ReplayPresence[frame] ? 1U : 0U;
+        }
+    }
+
+    (void) ThermalFrame_InitPresence(&presence, &setup);
+    start = ReplayNowS();
+    for (frame = 0U; frame < ReplayFrameCount; frame++)
+    {
+        ThermalFrame_Detect(&presence, &ReplayFrames[frame], &summary);
+    }
+
+    printf("\nsummaries: %u records, %.2f bytes per frame, %.1f times smaller than raw, detection %.0f ns per frame\n", (unsigned int) records,
+            (double) bytes / (double) ReplayFrameCount, ((double) ReplayFrameCount * THERMAL_FRAME_RAW_SIZE) / (double) bytes,
+            ((ReplayNowS() - start) * 1e9) / (double) ReplayFrameCount);
+    if (NULL != ReplayPresence)
+    {
+        agreement = (100.0 * (double) agreed) / (double) ReplayFrameCount;
+        printf("presence: people in %.1f %% of the frames, detector agrees on %.1f %%\n", (100.0 * (double) present) / (double) ReplayFrameCount,
+                agreement);
+        Check(agreement >= REPLAY_MIN_AGREEMENT, "the presence agrees on less than 90 % of the frames");
+    }
+}
+
+static void ReplayPrint(const ReplayResult_T * result)
+{
+    const ThermalFrame_Statistics_T * statistics = &result->Statistics;
+    double bytes = (double) statistics->Bytes + ((double) THERMAL_FRAME_BATCH_HEADER_SIZE * (double) ((ReplayFrameCount + ReplayFramesPerBatch() - 1U) /
+            ReplayFramesPerBatch()));
+
+    printf("%8u %11.2f %6.1f %6u %6u %9u %8u %8d %9u %9.0f %9.0f\n", (unsigned int) result->Deadband, bytes / (double) ReplayFrameCount,
+            ((double) ReplayFrameCount * THERMAL_FRAME_RAW_SIZE) / bytes, (unsigned int) statistics->KeyFrames, (unsigned int) statistics->DeltaFrames,
+            (unsigned int) statistics->UnchangedFrames, (unsigned int) result->Dropped, (int) result->MaxError, (unsigned int) result->LargestBatch,
+            result->EncodeNs, result->DecodeNs);
+}
+
+static void Usage(const char * name)
+{
+    fprintf(stderr, "usage: %s [--frames <n>] [--csv <file>] [--period <ms>] [--batch <ms>] [--deadband <LSB>] [--key <n>] [--noise <LSB>] [--seed <n>]\n",
+            name);
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const uint8_t sweep[REPLAY_SWEEP_LENGTH] = REPLAY_SWEEP;
+    ReplayResult_T result;
+    const char * csvPath = NULL;
+    uint32_t batchCount;
+    uint8_t index;
+    bool isSwept = false;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        const char * option = argv[arg];
+        const char * value = ((arg + 1) < argc) ? argv[arg + 1] : NULL;
+
+        if (NULL == value)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        arg++;
+        if (0 == strcmp(option, "--frames"))
+        {
+            ReplayFrameCount = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--csv"))
+        {
+            csvPath = value;
+        }
+        else if (0 == strcmp(option, "--period"))
+        {
+            ReplayPeriodMs = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--batch"))
+        {
+            ReplayBatchMs = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--deadband"))
+        {
+            ReplayDeadband = (uint8_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--key"))
+        {
+            ReplayKeyInterval = (uint16_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--noise"))
+        {
+            ReplayNoise = strtod(value, NULL);
+        }
+        else if (0 == strcmp(option, "--seed"))
+        {
+            ReplaySeed = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((0U == ReplayFrameCount) || (ReplayFrameCount > REPLAY_MAX_FRAMES) || (ReplayPeriodMs < 100U) || (ReplayPeriodMs > UINT16_MAX) ||
+            (ReplayDeadband > 127U) || (ReplayNoise < 0.0))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ReplayFrames = calloc((NULL != csvPath) ? REPLAY_MAX_FRAMES : ReplayFrameCount, sizeof(ThermalFrame_T));
+    if (NULL == ReplayFrames)
+    {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    if (NULL != csvPath)
+    {
+        if (!ReplayLoadCsv(csvPath))
+        {
+            return EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        ReplayPresence = calloc(ReplayFrameCount, sizeof(bool));
+        if (NULL == ReplayPresence)
+        {
+            perror("calloc");
+            return EXIT_FAILURE;
+        }
+        ReplaySynthesize();
+    }
+    batchCount = (ReplayFrameCount + ReplayFramesPerBatch() - 1U) / ReplayFramesPerBatch();
+    ReplayBatches = malloc((size_t) batchCount * REPLAY_BATCH_SIZE);
+    ReplayBatchLengths = calloc(batchCount, sizeof(uint32_t));
+    if ((NULL == ReplayBatches) || (NULL == ReplayBatchLengths))
+    {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    printf("%u %s frames at %u ms, %u frames per post, batches of %u bytes, key frame every %u frames\n\n", (unsigned int) ReplayFrameCount,
+            (NULL != csvPath) ? "replayed" : "synthetic", (unsigned int) ReplayPeriodMs, (unsigned int) ReplayFramesPerBatch(),
+            (unsigned int) REPLAY_BATCH_SIZE, (unsigned int) ReplayKeyInterval);
+    printf("deadband bytes/frame  ratio    key  delta unchanged  dropped maxerror  maxbatch encode ns decode ns\n");
+    for (index = 0U; index <= REPLAY_SWEEP_LENGTH; index++)
+    {
+        if ((REPLAY_SWEEP_LENGTH == index) && isSwept)
+        {
+            break;
+        }
+        memset(&result, 0, sizeof(result));
+        result.Deadband = (REPLAY_SWEEP_LENGTH == index) ? ReplayDeadband : sweep[index];
+        isSwept = isSwept || (result.Deadband == ReplayDeadband);
+        ReplayEncode(&result);
+        ReplayPrint(&result);
+        if (result.Deadband == ReplayDeadband)
+        {
+            Check(0U == result.Dropped, "frames were dropped at the given deadband, the batch is too small for the post interval");
+        }
+    }
+    ReplaySummaries();
+
+    return (0U == ReplayErrors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
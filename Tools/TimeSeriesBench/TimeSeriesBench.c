@@ -0,0 +1,411 @@
+/**
+ *  @file
+ *
+ *  @brief Host benchmark and decoder for the TimeSeriesCompressor batches.
+ *
+ *  Builds against the firmware sources of XDK110_Dashboard, see Tools/README.md.
+ *
+ *  Usage:
+ *  - TimeSeriesBench <trace.csv> [batch bytes]
+ *      Compresses a recorded trace and reports the compression ratio against
+ *      the JSON body and the raw binary layout, plus encode cost per sample.
+ *      The CSV holds one sample per line: timestamp_ms followed by the
+ *      SENSOR_SNAPSHOT_CHANNEL_COUNT channels in SensorSnapshot order.
+ *      A first line starting with a letter is treated as a header.
+ *  - TimeSeriesBench --synthetic <samples> [batch bytes]
+ *      Same as above on a generated 1 Hz trace.
+ *  - TimeSeriesBench --decode <SAMPLES.TSC>
+ *      Decodes an APP_SD_LOG_FILE_NAME log (or one POST body) to CSV on stdout.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "SensorSnapshot.h"
+#include "TimeSeriesCompressor.h"
+
+#include <ctype.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* constant definitions ***************************************************** */
+
+#define BENCH_DEFAULT_BATCH_SIZE    512U  /**< APP_SAMPLE_BATCH_SIZE of the firmware */
+#define BENCH_LINE_SIZE             1024U
+#define BENCH_JSON_SIZE             512U  /**< APP_PAYLOAD_BUFFER_SIZE of the firmware */
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Cycle counter of the host, nanoseconds where no cycle counter is available.
+ */
+static uint64_t BenchNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t) now.tv_sec * 1000000000ULL) + (uint64_t) now.tv_nsec;
+#endif
+}
+
+static const char * BenchUnit(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+static bool ParseLine(char * line, SensorSnapshot_T * snapshot)
+{
+    char * cursor = line;
+    char * end;
+    uint8_t channel;
+
+    snapshot->TimestampMs = (uint32_t) strtoul(cursor, &end, 10);
+    if (end == cursor)
+    {
+        return false;
+    }
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        cursor = end;
+        while ((',' == *cursor) || (' ' == *cursor) || (';' == *cursor))
+        {
+            cursor++;
+        }
+        if (0U != (SENSOR_SNAPSHOT_FLOAT_MASK & (1U << channel)))
+        {
+            snapshot->Values[channel].Float = strtof(cursor, &end);
+        }
+        else
+        {
+            snapshot->Values[channel].Int = (int32_t) strtol(cursor, &end, 10);
+        }
+        if (end == cursor)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static SensorSnapshot_T * LoadTrace(const char * path, size_t * count)
+{
+    FILE * file = fopen(path, "r");
+    char line[BENCH_LINE_SIZE];
+    SensorSnapshot_T * samples = NULL;
+    size_t capacity = 0;
+
+    *count = 0;
+    if (NULL == file)
+    {
+        perror(path);
+        return NULL;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        if (isalpha((unsigned char) line[0]) || ('#' == line[0]) || ('\n' == line[0]))
+        {
+            continue;
+        }
+        if (*count == capacity)
+        {
+            capacity = (0 == capacity) ? 1024 : (capacity * 2);
+            samples = realloc(samples, capacity * sizeof(*samples));
+            if (NULL == samples)
+            {
+                fclose(file);
+                return NULL;
+            }
+        }
+        if (ParseLine(line, &samples[*count]))
+        {
+            (*count)++;
+        }
+        else
+        {
+            fprintf(stderr, "skipping malformed line: %s", line);
+        }
+    }
+    fclose(file);
+    return samples;
+}
+
+/**
+ * @brief 1 Hz trace with slow drifts and sensor noise, shaped like a desk top recording.
+ */
+static SensorSnapshot_T * SyntheticTrace(size_t count)
+{
+    SensorSnapshot_T * samples = calloc(count, sizeof(*samples));
+    size_t index;
+    uint32_t seed = 12345U;
+
+    if (NULL == samples)
+    {
+        return NULL;
+    }
+    for (index = 0; index < count; index++)
+    {
+        SensorSnapshot_T * sample = &samples[index];
+        double t = (double) index;
+        int32_t noise;
+
+        seed = (seed * 1103515245U) + 12345U;
+        noise = (int32_t) ((seed >> 16) % 5U) - 2;
+
+        /* the timer jitters by a tick now and then */
+        sample->TimestampMs = (uint32_t) (index * 1000U) + (((seed >> 8) % 7U == 0U) ? 1U : 0U);
+        sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_X].Float = (float) (0.0 + (noise * 0.01));
+        sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Y].Float = 0.0f;
+        sample->Values[SENSOR_SNAPSHOT_ACCELEROMETER_Z].Float = (float) (9.0 + ((noise > 1) ? 1.0 : 0.0));
+        sample->Values[SENSOR_SNAPSHOT_ACOUSTIC].Float = (float) (0.02 + (0.001 * noise));
+        sample->Values[SENSOR_SNAPSHOT_LIGHT].Int = (int32_t) (120000.0 + (20000.0 * sin(t / 3600.0)));
+        sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_X].Int = noise * 61;
+        sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Y].Int = -noise * 61;
+        sample->Values[SENSOR_SNAPSHOT_GYROSCOPE_Z].Int = 0;
+        sample->Values[SENSOR_SNAPSHOT_HUMIDITY].Int = (int32_t) (45.0 + (2.0 * sin(t / 1800.0)));
+        sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_X].Int = 21 + ((noise > 0) ? 1 : 0);
+        sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Y].Int = -3;
+        sample->Values[SENSOR_SNAPSHOT_MAGNETOMETER_Z].Int = -40 + ((noise < 0) ? -1 : 0);
+        sample->Values[SENSOR_SNAPSHOT_PRESSURE].Int = (int32_t) (101325.0 + (50.0 * sin(t / 900.0))) + noise;
+        sample->Values[SENSOR_SNAPSHOT_TEMPERATURE].Int = (int32_t) (22000.0 + (500.0 * sin(t / 2400.0))) + (noise * 10);
+    }
+    return samples;
+}
+
+static int Benchmark(const SensorSnapshot_T * samples, size_t count, uint32_t batchSize)
+{
+    uint8_t * buffer = malloc(batchSize);
+    TimeSeriesCompressor_T compressor;
+    TimeSeriesDecompressor_T decompressor;
+    char json[BENCH_JSON_SIZE];
+    uint64_t encodeTicks = 0;
+    uint64_t start;
+    size_t compressedBytes = 0;
+    size_t jsonBytes = 0;
+    size_t rawBytes = count * (sizeof(uint32_t) * (1U + SENSOR_SNAPSHOT_CHANNEL_COUNT));
+    size_t blocks = 0;
+    size_t index = 0;
+    size_t blockStart;
+    size_t mismatches = 0;
+    uint32_t timestamp;
+    uint32_t values[SENSOR_SNAPSHOT_CHANNEL_COUNT];
+
+    if (NULL == buffer)
+    {
+        return EXIT_FAILURE;
+    }
+    for (index = 0; index < count; index++)
+    {
+        jsonBytes += SensorSnapshot_ToJson(&samples[index], json, sizeof(json));
+    }
+
+    index = 0;
+    while (index < count)
+    {
+        blockStart = index;
+        (void) TimeSeriesCompressor_Init(&compressor, SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK, buffer, batchSize);
+        start = BenchNow();
+        while ((index < count) && TimeSeriesCompressor_Append(&compressor, samples[index].TimestampMs, &samples[index].Values[0].Bits))
+        {
+            index++;
+        }
+        compressedBytes += TimeSeriesCompressor_Finish(&compressor);
+        encodeTicks += BenchNow() - start;
+        blocks++;
+        if (index == blockStart)
+        {
+            fprintf(stderr, "batch size %u cannot hold a single sample\n", batchSize);
+            free(buffer);
+            return EXIT_FAILURE;
+        }
+
+        /* round trip check of the block just written */
+        (void) TimeSeriesDecompressor_Init(&decompressor, buffer, batchSize);
+        while (TimeSeriesDecompressor_Next(&decompressor, &timestamp, values))
+        {
+            const SensorSnapshot_T * expected = &samples[blockStart + decompressor.SampleIndex - 1U];
+            if ((timestamp != expected->TimestampMs) ||
+                    (0 != memcmp(values, expected->Values, sizeof(values))))
+            {
+                mismatches++;
+            }
+        }
+        if (decompressor.SampleIndex != (index - blockStart))
+        {
+            mismatches += (index - blockStart) - decompressor.SampleIndex;
+        }
+    }
+
+    printf("samples            : %zu\n", count);
+    printf("batches            : %zu (%u bytes each)\n", blocks, batchSize);
+    printf("JSON bytes         : %zu (%.1f per sample)\n", jsonBytes, (double) jsonBytes / (double) count);
+    printf("raw binary bytes   : %zu (%.1f per sample)\n", rawBytes, (double) rawBytes / (double) count);
+    printf("compressed bytes   : %zu (%.1f per sample)\n", compressedBytes, (double) compressedBytes / (double) count);
+    printf("ratio vs JSON      : %.1f : 1\n", (double) jsonBytes / (double) compressedBytes);
+    printf("ratio vs raw       : %.1f : 1\n", (double) rawBytes / (double) compressedBytes);
+    printf("encode             : %.0f %s/sample\n", (double) encodeTicks / (double) count, BenchUnit());
+    printf("round trip         : %s\n", (0U == mismatches) ? "OK" : "MISMATCH");
+
+    free(buffer);
+    return (0U == mismatches) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static void PrintSample(uint32_t timestamp, const uint32_t * values)
+{
+    SensorSnapshot_Value_T value;
+    uint8_t channel;
+
+    printf("%lu", (unsigned long) timestamp);
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        value.Bits = values[channel];
+        if (0U != (SENSOR_SNAPSHOT_FLOAT_MASK & (1U << channel)))
+        {
+            printf(",%f", (double) value.Float);
+        }
+        else
+        {
+            printf(",%ld", (long) value.Int);
+        }
+    }
+    printf("\n");
+}
+
+static int Decode(const char * path)
+{
+    FILE * file = fopen(path, "rb");
+    uint8_t * block = NULL;
+    long fileSize;
+    long offset = 0;
+    uint32_t blockLength;
+    uint32_t timestamp;
+    uint32_t values[TIMESERIES_COMPRESSOR_MAX_CHANNELS];
+    TimeSeriesDecompressor_T decompressor;
+    uint8_t channel;
+    int result = EXIT_SUCCESS;
+
+    if (NULL == file)
+    {
+        perror(path);
+        return EXIT_FAILURE;
+    }
+    fseek(file, 0, SEEK_END);
+    fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    block = malloc((size_t) fileSize + 1U);
+    if ((NULL == block) || (fread(block, 1, (size_t) fileSize, file) != (size_t) fileSize))
+    {
+        fclose(file);
+        free(block);
+        return EXIT_FAILURE;
+    }
+    fclose(file);
+
+    printf("timestamp_ms");
+    for (channel = 0U; channel < SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        printf(",%s", SensorSnapshot_GetChannelName(channel));
+    }
+    printf("\n");
+
+    /* a single POST body starts directly with the block header */
+    if ((fileSize > 0) && ('T' == block[0]))
+    {
+        blockLength = (uint32_t) fileSize;
+        if (TimeSeriesDecompressor_Init(&decompressor, block, blockLength))
+        {
+            while (TimeSeriesDecompressor_Next(&decompressor, &timestamp, values))
+            {
+                PrintSample(timestamp, values);
+            }
+        }
+        free(block);
+        return EXIT_SUCCESS;
+    }
+
+    while ((offset + 2) <= fileSize)
+    {
+        blockLength = (uint32_t) block[offset] | ((uint32_t) block[offset + 1] << 8);
+        offset += 2;
+        if ((offset + (long) blockLength) > fileSize)
+        {
+            fprintf(stderr, "truncated batch at offset %ld\n", offset - 2);
+            result = EXIT_FAILURE;
+            break;
+        }
+        if (!TimeSeriesDecompressor_Init(&decompressor, &block[offset], blockLength))
+        {
+            fprintf(stderr, "invalid batch header at offset %ld\n", offset);
+            result = EXIT_FAILURE;
+            break;
+        }
+        while (TimeSeriesDecompressor_Next(&decompressor, &timestamp, values))
+        {
+            PrintSample(timestamp, values);
+        }
+        offset += (long) blockLength;
+    }
+    free(block);
+    return result;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    SensorSnapshot_T * samples = NULL;
+    size_t count = 0;
+    uint32_t batchSize = BENCH_DEFAULT_BATCH_SIZE;
+    int result;
+
+    if ((3 == argc) && (0 == strcmp(argv[1], "--decode")))
+    {
+        return Decode(argv[2]);
+    }
+    if ((argc >= 3) && (0 == strcmp(argv[1], "--synthetic")))
+    {
+        count = (size_t) strtoul(argv[2], NULL, 10);
+        samples = SyntheticTrace(count);
+        if (argc >= 4)
+        {
+            batchSize = (uint32_t) strtoul(argv[3], NULL, 10);
+        }
+    }
+    else if (argc >= 2)
+    {
+        samples = LoadTrace(argv[1], &count);
+        if (argc >= 3)
+        {
+            batchSize = (uint32_t) strtoul(argv[2], NULL, 10);
+        }
+    }
+    else
+    {
+        fprintf(stderr, "usage: %s <trace.csv> [batch bytes]\n"
+                "       %s --synthetic <samples> [batch bytes]\n"
+                "       %s --decode <SAMPLES.TSC>\n", argv[0], argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((NULL == samples) || (0U == count))
+    {
+        fprintf(stderr, "no samples\n");
+        free(samples);
+        return EXIT_FAILURE;
+    }
+    result = Benchmark(samples, count, batchSize);
+    free(samples);
+    return result;
+}
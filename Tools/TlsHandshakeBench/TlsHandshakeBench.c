@@ -0,0 +1,630 @@
+/**
+ *  @file
+ *
+ *  @brief Host build of the HTTPS session of HttpExample and XDK110_Dashboard.
+ *
+ *  Runs the firmware HttpsSession module over OpenSSL and posts a series of
+ *  bodies to a server, then prints the per phase timings, the handshakes
+ *  done and the CPU time they took. Three modes compare the ways to pay for
+ *  TLS:
+ *  - full: a new connection and a full handshake per post, like HTTPRestClient,
+ *  - resume: a new connection per post, resuming the TLS session of the
+ *    previous one (session ID or ticket),
+ *  - keepalive: one connection for all posts, like HttpsAgent on the device.
+ *  With --session the TLS session is stored in a file at exit and resumed at
+ *  the next start, as a session kept across a reboot would be.
+ *
+ *  The cipher suites offered are the HTTPS_CIPHER_PREFERENCE list of the
+ *  applications (or an RSA only list), TLS 1.2 like the WLAN chip.
+ *
+ *  --server runs a local stand-in server with HTTP/1.1 keep-alive, session
+ *  cache and tickets; without --cert it generates a self-signed ECDSA P-256
+ *  (or with --rsa an RSA-2048) certificate.
+ *
+ *  Usage: TlsHandshakeBench [options] host port
+ *         TlsHandshakeBench --server [--rsa] [--cert f --key f] [--idle ms] [--close] port
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "HttpsSession.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+/* constant definitions ***************************************************** */
+
+#define BENCH_CIPHER_LIST_SIZE      512
+#define BENCH_MAX_BODY              4096
+
+/* local type definitions *************************************************** */
+
+enum BenchMode_E
+{
+    BENCH_MODE_FULL = 0,
+    BENCH_MODE_RESUME,
+    BENCH_MODE_KEEPALIVE
+};
+typedef enum BenchMode_E BenchMode_T;
+
+/**
+ * @brief State of the OpenSSL transport.
+ */
+struct BenchTransport_S
+{
+    SSL_CTX * Context;
+    SSL * Ssl;
+    int Socket;
+    bool IsResuming; /**< Offer the cached session on the next handshake */
+    SSL_SESSION * Session; /**< Session of the last handshake */
+    char CipherList[BENCH_CIPHER_LIST_SIZE];
+    const char * Negotiated;
+    double FullCpuMs; /**< CPU time of the full handshakes */
+    double ResumedCpuMs;
+    uint32_t FullHandshakes;
+    uint32_t ResumedHandshakes;
+};
+typedef struct BenchTransport_S BenchTransport_T;
+
+/* local variables ********************************************************** */
+
+static const HttpsSession_Cipher_T BenchEcdsaPreference[] =
+        {
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256,
+                HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA,
+        }; /* HTTPS_CIPHER_PREFERENCE of the applications */
+
+static const HttpsSession_Cipher_T BenchRsaPreference[] =
+        {
+                HTTPS_SESSION_CIPHER_RSA_AES128_CBC_SHA256,
+                HTTPS_SESSION_CIPHER_RSA_AES256_CBC_SHA,
+        }; /* Plain RSA key exchange, for comparison */
+
+static BenchTransport_T BenchState = { .Socket = -1 };
+
+/* local functions ********************************************************** */
+
+static uint32_t BenchNowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((now.tv_sec * 1000L) + (now.tv_nsec / 1000000L));
+}
+
+static double BenchCpuMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return ((double) now.tv_sec * 1000.0) + ((double) now.tv_nsec / 1000000.0);
+}
+
+/**
+ * @brief Disables the Nagle algorithm: the request right after the last
+ * handshake message of a resumed session would wait for its ACK otherwise.
+ */
+static void BenchSetNoDelay(int socketHandle)
+{
+    int isNoDelay = 1;
+
+    (void) setsockopt(socketHandle, IPPROTO_TCP, TCP_NODELAY, &isNoDelay, sizeof(isNoDelay));
+}
+
+static bool BenchResolve(void * context, const char * host, uint32_t * address)
+{
+    struct addrinfo hints;
+    struct addrinfo * result;
+
+    (void) context;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (0 != getaddrinfo(host, NULL, &hints, &result))
+    {
+        fprintf(stderr, "Cannot resolve %s\n", host);
+        return false;
+    }
+    *address = ntohl(((struct sockaddr_in *) result->ai_addr)->sin_addr.s_addr);
+    freeaddrinfo(result);
+    return true;
+}
+
+static bool BenchConnect(void * context, uint32_t address, uint16_t port, const HttpsSession_Cipher_T * ciphers, uint8_t cipherCount)
+{
+    BenchTransport_T * state = context;
+    struct sockaddr_in serverAddress;
+    size_t length = 0U;
+    uint8_t cipher;
+
+    state->CipherList[0] = '\0';
+    for (cipher = 0U; cipher < cipherCount; cipher++)
+    {
+        length += (size_t) snprintf(&state->CipherList[length], sizeof(state->CipherList) - length, "%s%s", (0U == cipher) ? "" : ":",
+                HttpsSession_GetCipherName(ciphers[cipher]));
+    }
+    state->Socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (state->Socket < 0)
+    {
+        return false;
+    }
+    BenchSetNoDelay(state->Socket);
+    memset(&serverAddress, 0, sizeof(serverAddress));
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(port);
+    serverAddress.sin_addr.s_addr = htonl(address);
+    return (0 == connect(state->Socket, (struct sockaddr *) &serverAddress, sizeof(serverAddress)));
+}
+
+static bool BenchHandshake(void * context, bool * isResumed)
+{
+    BenchTransport_T * state = context;
+    double startCpuMs;
+    double cpuMs;
+
+    state->Ssl = SSL_new(state->Context);
+    if ((NULL == state->Ssl) || (1 != SSL_set_cipher_list(state->Ssl, state->CipherList)))
+    {
+        ERR_print_errors_fp(stderr);
+        return false;
+    }
+    SSL_set_fd(state->Ssl, state->Socket);
+    if (state->IsResuming && (NULL != state->Session))
+    {
+        SSL_set_session(state->Ssl, state->Session);
+    }
+    startCpuMs = BenchCpuMs();
+    if (1 != SSL_connect(state->Ssl))
+    {
+        ERR_print_errors_fp(stderr);
+        return false;
+    }
+    cpuMs = BenchCpuMs() - startCpuMs;
+    *isResumed = (1 == SSL_session_reused(state->Ssl));
+    if (*isResumed)
+    {
+        state->ResumedHandshakes++;
+        state->ResumedCpuMs += cpuMs;
+    }
+    else
+    {
+        state->FullHandshakes++;
+        state->FullCpuMs += cpuMs;
+    }
+    state->Negotiated = SSL_get_cipher_name(state->Ssl);
+    if (state->IsResuming)
+    {
+        /* With TLS 1.2 the session is complete after the handshake */
+        SSL_SESSION_free(state->Session);
+        state->Session = SSL_get1_session(state->Ssl);
+    }
+    return true;
+}
+
+static bool BenchSend(void * context, const uint8_t * data, uint32_t length)
+{
+    BenchTransport_T * state = context;
+
+    return ((0U == length) || (SSL_write(state->Ssl, data, (int) length) == (int) length));
+}
+
+static int32_t BenchReceive(void * context, uint8_t * buffer, uint32_t size, uint32_t timeoutMs)
+{
+    BenchTransport_T * state = context;
+    struct pollfd descriptor = { .fd = state->Socket, .events = POLLIN };
+    int received;
+
+    if ((0 == SSL_pending(state->Ssl)) && (poll(&descriptor, 1, (int) timeoutMs) <= 0))
+    {
+        return -1;
+    }
+    received = SSL_read(state->Ssl, buffer, (int) size);
+    if (received > 0)
+    {
+        return received;
+    }
+    return (SSL_ERROR_ZERO_RETURN == SSL_get_error(state->Ssl, received)) ? 0 : -1;
+}
+
+static void BenchClose(void * context)
+{
+    BenchTransport_T * state = context;
+
+    if (NULL != state->Ssl)
+    {
+        (void) SSL_shutdown(state->Ssl);
+        SSL_free(state->Ssl);
+        state->Ssl = NULL;
+    }
+    if (state->Socket >= 0)
+    {
+        close(state->Socket);
+        state->Socket = -1;
+    }
+}
+
+static const HttpsSession_Transport_T BenchTransport =
+        {
+                .Context = &BenchState,
+                .Resolve = BenchResolve,
+                .Connect = BenchConnect,
+                .Handshake = BenchHandshake,
+                .Send = BenchSend,
+                .Receive = BenchReceive,
+                .Close = BenchClose,
+                .NowMs = BenchNowMs,
+        };
+
+/**
+ * @brief Self-signed certificate for the stand-in server.
+ */
+static bool BenchGenerateCertificate(SSL_CTX * context, bool isRsa)
+{
+    EVP_PKEY * key = isRsa ? EVP_RSA_gen(2048) : EVP_EC_gen("P-256");
+    X509 * certificate = X509_new();
+    X509_NAME * name;
+    bool isDone;
+
+    if ((NULL == key) || (NULL == certificate))
+    {
+        return false;
+    }
+    ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+    X509_gmtime_adj(X509_getm_notAfter(certificate), 86400L);
+    X509_set_pubkey(certificate, key);
+    name = X509_get_subject_name(certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, (const unsigned char *) "localhost", -1, -1, 0);
+    X509_set_issuer_name(certificate, name);
+    isDone = (0 != X509_sign(certificate, key, EVP_sha256())) && (1 == SSL_CTX_use_certificate(context, certificate)) &&
+            (1 == SSL_CTX_use_PrivateKey(context, key));
+    X509_free(certificate);
+    EVP_PKEY_free(key);
+    return isDone;
+}
+
+/**
+ * @brief Answers the requests of one connection until the client closes or idles.
+ */
+static void BenchServeConnection(SSL * ssl, int idleMs, bool isClose, uint32_t * requests)
+{
+    static const char body[] = "OK\n";
+    HttpMessage_Head_T head;
+    uint8_t buffer[1024];
+    char response[256];
+    struct pollfd descriptor = { .fd = SSL_get_fd(ssl), .events = POLLIN };
+    uint32_t consumed;
+    uint32_t length;
+    int received;
+
+    HttpMessage_InitHead(&head, false);
+    for (;;)
+    {
+        if ((0 == SSL_pending(ssl)) && (poll(&descriptor, 1, idleMs) <= 0))
+        {
+            /* Keep-alive timeout of the server */
+            return;
+        }
+        received = SSL_read(ssl, buffer, sizeof(buffer));
+        if (received <= 0)
+        {
+            return;
+        }
+        consumed = HttpMessage_ParseHead(&head, buffer, (uint32_t) received);
+        if (HTTP_MESSAGE_STATE_ERROR == head.State)
+        {
+            return;
+        }
+        (void) HttpMessage_ReceiveBody(&head, &buffer[consumed], (uint32_t) received - consumed);
+        if (HttpMessage_IsBodyComplete(&head))
+        {
+            (*requests)++;
+            isClose = isClose || head.IsClose;
+            length = HttpMessage_WriteResponseHead(response, sizeof(response), 200U, "OK", "text/plain", sizeof(body) - 1U, isClose);
+            memcpy(&response[length], body, sizeof(body) - 1U);
+            if ((SSL_write(ssl, response, (int) (length + sizeof(body) - 1U)) <= 0) || isClose)
+            {
+                return;
+            }
+            /* Pipelined bytes of the next request are not expected from HttpsSession */
+            HttpMessage_InitHead(&head, false);
+        }
+    }
+}
+
+static int BenchServer(uint16_t port, const char * certFile, const char * keyFile, bool isRsa, int idleMs, bool isClose)
+{
+    SSL_CTX * context = SSL_CTX_new(TLS_server_method());
+    struct sockaddr_in address;
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int option = 1;
+    int connection;
+    SSL * ssl;
+    uint32_t connections = 0U;
+    uint32_t resumed = 0U;
+    uint32_t requests = 0U;
+
+    SSL_CTX_set_max_proto_version(context, TLS1_2_VERSION);
+    SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+    SSL_CTX_set_session_id_context(context, (const unsigned char *) "TlsHandshakeBench", 17U);
+    if ((NULL != certFile) ? ((1 != SSL_CTX_use_certificate_chain_file(context, certFile)) ||
+            (1 != SSL_CTX_use_PrivateKey_file(context, keyFile, SSL_FILETYPE_PEM))) : !BenchGenerateCertificate(context, isRsa))
+    {
+        ERR_print_errors_fp(stderr);
+        return 1;
+    }
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((0 != bind(listener, (struct sockaddr *) &address, sizeof(address))) || (0 != listen(listener, 4)))
+    {
+        perror("bind");
+        return 1;
+    }
+    printf("Stand-in server on 127.0.0.1:%u, %s certificate, keep-alive %s\n", (unsigned int) port,
+            (NULL != certFile) ? certFile : (isRsa ? "RSA-2048" : "ECDSA P-256"), isClose ? "off" : "on");
+    fflush(stdout);
+    for (;;)
+    {
+        connection = accept(listener, NULL, NULL);
+        if (connection < 0)
+        {
+            continue;
+        }
+        BenchSetNoDelay(connection);
+        ssl = SSL_new(context);
+        SSL_set_fd(ssl, connection);
+        if (1 == SSL_accept(ssl))
+        {
+            connections++;
+            resumed += (1 == SSL_session_reused(ssl)) ? 1U : 0U;
+            BenchServeConnection(ssl, idleMs, isClose, &requests);
+            (void) SSL_shutdown(ssl);
+            printf("Server: %u connections, %u resumed, %u requests\n", connections, resumed, requests);
+            fflush(stdout);
+        }
+        SSL_free(ssl);
+        close(connection);
+    }
+    return 0;
+}
+
+static void BenchUsage(void)
+{
+    fprintf(stderr, "Usage: TlsHandshakeBench [--mode full|resume|keepalive] [--posts n] [--interval ms] [--max-idle ms]\n"
+            "                         [--ciphers ecdsa|rsa] [--session file] [--ca file] [--body bytes] host port\n"
+            "       TlsHandshakeBench --server [--rsa] [--cert file --key file] [--idle ms] [--close] port\n");
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    BenchMode_T mode = BENCH_MODE_KEEPALIVE;
+    uint32_t posts = 10U;
+    uint32_t intervalMs = 0U;
+    uint32_t maxIdleMs = 0U;
+    uint32_t bodyLength = 200U;
+    bool isServer = false;
+    bool isRsa = false;
+    bool isClose = false;
+    int idleMs = 5000;
+    const char * certFile = NULL;
+    const char * keyFile = NULL;
+    const char * caFile = NULL;
+    const char * sessionFile = NULL;
+    const HttpsSession_Cipher_T * ciphers = BenchEcdsaPreference;
+    uint8_t cipherCount = (uint8_t) (sizeof(BenchEcdsaPreference) / sizeof(BenchEcdsaPreference[0]));
+    static HttpsSession_T session;
+    HttpsSession_Setup_T setup;
+    HttpsSession_Request_T request;
+    HttpsSession_Response_T response;
+    static uint8_t body[BENCH_MAX_BODY];
+    uint8_t responseBody[64];
+    const HttpsSession_PhaseTiming_T * timing;
+    uint32_t post;
+    uint32_t startMs;
+    uint8_t phase;
+    FILE * file;
+    int argument;
+
+    for (argument = 1; (argument < argc) && (0 == strncmp(argv[argument], "--", 2U)); argument++)
+    {
+        if (0 == strcmp(argv[argument], "--server"))
+        {
+            isServer = true;
+        }
+        else if (0 == strcmp(argv[argument], "--rsa"))
+        {
+            isRsa = true;
+        }
+        else if (0 == strcmp(argv[argument], "--close"))
+        {
+            isClose = true;
+        }
+        else if (argument + 1 >= argc)
+        {
+            BenchUsage();
+            return 1;
+        }
+        else if (0 == strcmp(argv[argument], "--mode"))
+        {
+            argument++;
+            mode = (0 == strcmp(argv[argument], "full")) ? BENCH_MODE_FULL :
+                    ((0 == strcmp(argv[argument], "resume")) ? BENCH_MODE_RESUME : BENCH_MODE_KEEPALIVE);
+        }
+        else if (0 == strcmp(argv[argument], "--posts"))
+        {
+            posts = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--interval"))
+        {
+            intervalMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--max-idle"))
+        {
+            maxIdleMs = (uint32_t) strtoul(argv[++argument], NULL, 0);
+        }
+        else if (0 == strcmp(argv[argument], "--body"))
+        {
+            bodyLength = (uint32_t) strtoul(argv[++argument], NULL, 0);
+            bodyLength = (bodyLength > BENCH_MAX_BODY) ? BENCH_MAX_BODY : bodyLength;
+        }
+        else if (0 == strcmp(argv[argument], "--ciphers"))
+        {
+            if (0 == strcmp(argv[++argument], "rsa"))
+            {
+                ciphers = BenchRsaPreference;
+                cipherCount = (uint8_t) (sizeof(BenchRsaPreference) / sizeof(BenchRsaPreference[0]));
+            }
+        }
+        else if (0 == strcmp(argv[argument], "--session"))
+        {
+            sessionFile = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--ca"))
+        {
+            caFile = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--cert"))
+        {
+            certFile = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--key"))
+        {
+            keyFile = argv[++argument];
+        }
+        else if (0 == strcmp(argv[argument], "--idle"))
+        {
+            idleMs = atoi(argv[++argument]);
+        }
+        else
+        {
+            BenchUsage();
+            return 1;
+        }
+    }
+    if (isServer)
+    {
+        if ((argument + 1 != argc) || ((NULL == certFile) != (NULL == keyFile)))
+        {
+            BenchUsage();
+            return 1;
+        }
+        return BenchServer((uint16_t) atoi(argv[argument]), certFile, keyFile, isRsa, idleMs, isClose);
+    }
+    if (argument + 2 != argc)
+    {
+        BenchUsage();
+        return 1;
+    }
+
+    BenchState.Context = SSL_CTX_new(TLS_client_method());
+    SSL_CTX_set_max_proto_version(BenchState.Context, TLS1_2_VERSION);
+    SSL_CTX_set_session_cache_mode(BenchState.Context, SSL_SESS_CACHE_CLIENT);
+    if (NULL != caFile)
+    {
+        SSL_CTX_load_verify_locations(BenchState.Context, caFile, NULL);
+        SSL_CTX_set_verify(BenchState.Context, SSL_VERIFY_PEER, NULL);
+    }
+    BenchState.IsResuming = (BENCH_MODE_FULL != mode);
+    if (BenchState.IsResuming && (NULL != sessionFile) && (NULL != (file = fopen(sessionFile, "r"))))
+    {
+        BenchState.Session = PEM_read_SSL_SESSION(file, NULL, NULL, NULL);
+        fclose(file);
+        printf("Session loaded from %s\n", sessionFile);
+    }
+
+    setup.Host = argv[argument];
+    setup.Port = (uint16_t) atoi(argv[argument + 1]);
+    setup.Ciphers = ciphers;
+    setup.CipherCount = cipherCount;
+    setup.MaxIdleMs = maxIdleMs;
+    setup.MaxRequestsPerConnection = (BENCH_MODE_KEEPALIVE == mode) ? 0U : 1U;
+    setup.TimeoutMs = 5000U;
+    setup.Transport = &BenchTransport;
+    if (!HttpsSession_Init(&session, &setup))
+    {
+        return 1;
+    }
+    memset(body, '7', sizeof(body));
+    request.Method = "POST";
+    request.Path = "/sendValuesToDatabase.php";
+    request.ContentType = "application/json";
+    request.ExtraHeaders = NULL;
+    request.Body = body;
+    request.BodyLength = bodyLength;
+    request.WriteBody = NULL;
+    request.BodyContext = NULL;
+    request.IsChunked = false;
+    response.Body = responseBody;
+    response.BodySize = sizeof(responseBody);
+
+    for (post = 0U; post < posts; post++)
+    {
+        startMs = BenchNowMs();
+        if (!HttpsSession_Request(&session, &request, &response))
+        {
+            fprintf(stderr, "Post %u failed\n", post);
+        }
+        else if ((response.Status < 200U) || (response.Status > 299U))
+        {
+            fprintf(stderr, "Post %u answered %u\n", post, response.Status);
+        }
+        if ((0U != intervalMs) && ((post + 1U) < posts))
+        {
+            while ((BenchNowMs() - startMs) < intervalMs)
+            {
+                usleep(1000U);
+            }
+        }
+    }
+    HttpsSession_Close(&session);
+
+    printf("Mode %s, %u posts of %u bytes, cipher %s\n",
+            (BENCH_MODE_FULL == mode) ? "full" : ((BENCH_MODE_RESUME == mode) ? "resume" : "keepalive"), posts, bodyLength,
+            (NULL != BenchState.Negotiated) ? BenchState.Negotiated : "-");
+    printf("Requests %u, failed %u, connections %u, resumed %u, on open connection %u, retried %u\n",
+            session.Statistics.Requests, session.Statistics.Failures, session.Statistics.Connections, session.Statistics.Resumed,
+            session.Statistics.Reused, session.Statistics.Retried);
+    printf("Handshake CPU: %u full, mean %.2f ms; %u resumed, mean %.2f ms\n", BenchState.FullHandshakes,
+            (0U != BenchState.FullHandshakes) ? (BenchState.FullCpuMs / BenchState.FullHandshakes) : 0.0, BenchState.ResumedHandshakes,
+            (0U != BenchState.ResumedHandshakes) ? (BenchState.ResumedCpuMs / BenchState.ResumedHandshakes) : 0.0);
+    printf("%-10s %6s %8s %8s %8s\n", "Phase", "Count", "Mean ms", "Max ms", "Total ms");
+    for (phase = 0U; phase < (uint8_t) HTTPS_SESSION_PHASE_COUNT; phase++)
+    {
+        timing = &session.Statistics.Phases[phase];
+        printf("%-10s %6u %8.1f %8u %8u\n", HttpsSession_GetPhaseName((HttpsSession_Phase_T) phase), timing->Count,
+                (0U != timing->Count) ? ((double) timing->TotalMs / timing->Count) : 0.0, timing->MaxMs, timing->TotalMs);
+    }
+
+    if ((NULL != sessionFile) && (NULL != BenchState.Session) && (NULL != (file = fopen(sessionFile, "w"))))
+    {
+        PEM_write_SSL_SESSION(file, BenchState.Session);
+        fclose(file);
+    }
+    SSL_SESSION_free(BenchState.Session);
+    SSL_CTX_free(BenchState.Context);
+    return (0U == session.Statistics.Failures) ? 0 : 1;
+}
@@ -0,0 +1,405 @@
+/**
+ *  @file
+ *
+ *  @brief Host simulation of the XDK110_Dashboard upload priority queue.
+ *
+ *  Runs a day of uploads (APP_UPLOAD_QUEUE_ENABLE) through the firmware
+ *  UploadQueue the way AppControllerFire drives it: one telemetry sample per
+ *  upload interval, the queue drained most important class first after it,
+ *  the diagnostics pushed every 60 posts, and sensor alerts posted as they
+ *  come during the wait. The link alternates between a good state (a slow
+ *  link of the given bandwidth and round trip) and a bad one in which every
+ *  post fails after the timeout; both durations are drawn from exponential
+ *  distributions.
+ *
+ *  The report lists per class the records pushed, sent, dropped and demoted
+ *  and the latency from push to post (mean / max, as the device exports it),
+ *  plus the alert latency apart for the alerts which saw the link good from
+ *  their push to their post. Those wait at most for the post in flight (a
+ *  failing one if the link just came back) and their own post; a longer wait
+ *  makes the exit code 1.
+ *
+ *  Usage: UploadQueueSim [options]
+ *    --hours <n>       length of the run, default 24, at most 720
+ *    --seed <n>        seed of the link and the alerts, default 4711
+ *    --interval <ms>   upload interval, default 10000
+ *    --kbps <n>        bandwidth of the good link, default 32
+ *    --rtt <ms>        round trip of a post on the good link, default 400
+ *    --good <s>        mean good period, default 600
+ *    --bad <s>         mean bad period, default 120
+ *    --timeout <ms>    duration of a failed post, default 5000
+ *    --alert <s>       mean time between sensor alerts, default 900
+ *    --backlog <n>     backlog samples held, default 48
+ *    --budget <bytes>  backlog sample bytes per interval, default 2048, 0 no limit
+ *    --batch <n>       backlog samples per post, default 12
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "UploadQueue.h"
+#include "SensorSnapshot.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_ALERTS              8U      /**< UPLOAD_QUEUE_ALERTS */
+#define SIM_TELEMETRY_SAMPLES   4U      /**< UPLOAD_QUEUE_TELEMETRY_SAMPLES */
+#define SIM_MAX_BACKLOG         4096U
+#define SIM_RECENT_MS           30000U  /**< UPLOAD_QUEUE_RECENT_MS */
+#define SIM_REPORT_POSTS        60U     /**< APP_HTTPS_REPORT_INTERVAL */
+#define SIM_HTTP_OVERHEAD       260U    /**< Request head and response of a post */
+#define SIM_SAMPLE_JSON_BYTES   420U    /**< Snapshot object of SensorSnapshot_WriteJson */
+#define SIM_ALERT_JSON_BYTES    90U
+#define SIM_BACKLOG_JSON_BYTES  32U     /**< Wrapper of a backlog sample */
+#define SIM_DIAGNOSTICS_BYTES   720U
+#define SIM_ALERT_RECORD_SIZE   8U      /**< sizeof(AppControllerAlert_T) */
+
+/* local variables ********************************************************** */
+
+static uint32_t SimAlertStorage[UPLOAD_QUEUE_CLASS_SIZE(SIM_ALERTS, SIM_ALERT_RECORD_SIZE) / sizeof(uint32_t)];
+static uint32_t SimTelemetryStorage[UPLOAD_QUEUE_CLASS_SIZE(SIM_TELEMETRY_SAMPLES, sizeof(SensorSnapshot_T)) / sizeof(uint32_t)];
+static uint32_t SimBacklogStorage[UPLOAD_QUEUE_CLASS_SIZE(SIM_MAX_BACKLOG, sizeof(SensorSnapshot_T)) / sizeof(uint32_t)];
+static uint32_t SimDiagnosticsStorage[UPLOAD_QUEUE_CLASS_SIZE(1U, sizeof(UploadQueue_Statistics_T) * UPLOAD_QUEUE_CLASS_COUNT) / sizeof(uint32_t)];
+
+static UploadQueue_T SimQueue;
+
+static uint32_t SimNowMs = 0UL;
+static uint32_t SimSeed = 4711U;
+static uint32_t SimKbps = 32U;
+static uint32_t SimRttMs = 400U;
+static double SimGoodS = 600.0;
+static double SimBadS = 120.0;
+static uint32_t SimTimeoutMs = 5000U;
+static double SimAlertS = 900.0;
+
+static bool SimIsGood = true;
+static uint32_t SimLinkChangeMs;
+static uint32_t SimGoodSinceMs = 0UL; /**< Start of the current good period */
+static uint32_t SimNextAlertMs;
+static bool SimIsNotified = false; /**< Task notification of the read hook, pending */
+
+static uint32_t SimPosts = 0UL;
+static uint32_t SimFailedPosts = 0UL;
+static uint32_t SimMaxPostMs = 0UL;
+static uint32_t SimAlertsGood = 0UL;
+static uint32_t SimAlertsBad = 0UL;
+static uint32_t SimAlertMaxGoodMs = 0UL;
+static uint32_t SimAlertMaxBadMs = 0UL;
+static uint64_t SimAlertTotalGoodMs = 0ULL;
+
+/* local functions ********************************************************** */
+
+static double SimRandom(void)
+{
+    SimSeed = SimSeed * 1103515245U + 12345U;
+    return ((double) ((SimSeed >> 8) & 0xFFFFFFU) + 0.5) / 16777216.0;
+}
+
+static uint32_t SimExponentialMs(double meanS)
+{
+    return (uint32_t) (-log(SimRandom()) * meanS * 1000.0) + 1U;
+}
+
+/**
+ * @brief Moves the link state on to time ms.
+ */
+static void SimLinkUntil(uint32_t ms)
+{
+    while (SimLinkChangeMs <= ms)
+    {
+        SimIsGood = !SimIsGood;
+        if (SimIsGood)
+        {
+            SimGoodSinceMs = SimLinkChangeMs;
+        }
+        SimLinkChangeMs += SimExponentialMs(SimIsGood ? SimGoodS : SimBadS);
+    }
+}
+
+/**
+ * @brief Pushes the alerts raised up to time ms, at their own time.
+ */
+static void SimAlertsUntil(uint32_t ms)
+{
+    static const uint8_t alert[SIM_ALERT_RECORD_SIZE] = { 0U };
+
+    while (SimNextAlertMs <= ms)
+    {
+        SimIsNotified = UploadQueue_Push(&SimQueue, UPLOAD_QUEUE_CLASS_ALERT, alert, sizeof(alert), SimNextAlertMs) || SimIsNotified;
+        SimNextAlertMs += SimExponentialMs(SimAlertS);
+    }
+}
+
+/**
+ * @brief Returns the bytes on the wire of a batch.
+ */
+static uint32_t SimBodyBytes(const UploadQueue_Batch_T * batch)
+{
+    switch (batch->Class)
+    {
+    case UPLOAD_QUEUE_CLASS_ALERT:
+        return SIM_HTTP_OVERHEAD + 14U + batch->Count * SIM_ALERT_JSON_BYTES;
+    case UPLOAD_QUEUE_CLASS_TELEMETRY:
+        return SIM_HTTP_OVERHEAD + SIM_SAMPLE_JSON_BYTES;
+    case UPLOAD_QUEUE_CLASS_BACKLOG:
+        return SIM_HTTP_OVERHEAD + 14U + batch->Count * (SIM_SAMPLE_JSON_BYTES + SIM_BACKLOG_JSON_BYTES);
+    default:
+        return SIM_HTTP_OVERHEAD + SIM_DIAGNOSTICS_BYTES;
+    }
+}
+
+/**
+ * @brief Counts the alert latencies of a batch about to be completed, apart
+ * for the alerts which saw the link good from their push on.
+ */
+static void SimTrackAlerts(const UploadQueue_Batch_T * batch)
+{
+    uint32_t length;
+    uint32_t ageMs;
+    uint32_t latencyMs;
+    uint8_t index;
+
+    for (index = 0U; index < batch->Count; index++)
+    {
+        (void) UploadQueue_GetRecord(&SimQueue, batch, index, &length, &ageMs);
+        latencyMs = SimNowMs - batch->PeekMs + ageMs;
+        if ((batch->PeekMs - ageMs) >= SimGoodSinceMs)
+        {
+            SimAlertsGood++;
+            SimAlertTotalGoodMs += latencyMs;
+            SimAlertMaxGoodMs = (latencyMs > SimAlertMaxGoodMs) ? latencyMs : SimAlertMaxGoodMs;
+        }
+        else
+        {
+            SimAlertsBad++;
+            SimAlertMaxBadMs = (latencyMs > SimAlertMaxBadMs) ? latencyMs : SimAlertMaxBadMs;
+        }
+    }
+}
+
+/**
+ * @brief AppControllerPostQueue: posts batches down to lowest until one fails.
+ */
+static bool SimPostQueue(UploadQueue_Class_T lowest)
+{
+    UploadQueue_Batch_T batch;
+    uint32_t durationMs;
+    bool isSent = true;
+
+    while (isSent && UploadQueue_Peek(&SimQueue, lowest, SimNowMs, &batch))
+    {
+        SimLinkUntil(SimNowMs);
+        isSent = SimIsGood;
+        durationMs = isSent ? (SimRttMs + (SimBodyBytes(&batch) * 8U) / SimKbps) : SimTimeoutMs;
+        /* The sensor hook keeps pushing while the post is in flight */
+        SimAlertsUntil(SimNowMs + durationMs);
+        SimNowMs += durationMs;
+        SimPosts++;
+        if (isSent)
+        {
+            SimMaxPostMs = (durationMs > SimMaxPostMs) ? durationMs : SimMaxPostMs;
+            if (UPLOAD_QUEUE_CLASS_ALERT == batch.Class)
+            {
+                SimTrackAlerts(&batch);
+            }
+        }
+        else
+        {
+            SimFailedPosts++;
+        }
+        UploadQueue_Complete(&SimQueue, &batch, SimNowMs, isSent);
+    }
+    return isSent;
+}
+
+/**
+ * @brief AppControllerWait: alerts raised during the wait, or during the
+ * posts before it, are posted at once.
+ */
+static void SimWait(uint32_t waitMs)
+{
+    uint32_t endMs = SimNowMs + waitMs;
+
+    while (SimIsNotified || ((SimNextAlertMs < endMs) && (SimNowMs < endMs)))
+    {
+        if (!SimIsNotified)
+        {
+            SimNowMs = (SimNextAlertMs > SimNowMs) ? SimNextAlertMs : SimNowMs;
+            SimAlertsUntil(SimNowMs);
+        }
+        SimIsNotified = false;
+        (void) SimPostQueue(UPLOAD_QUEUE_CLASS_ALERT);
+    }
+    SimNowMs = (endMs > SimNowMs) ? endMs : SimNowMs;
+}
+
+/**
+ * @brief AppControllerReportQueue: queues the statistics as diagnostics record.
+ */
+static void SimReport(void)
+{
+    UploadQueue_Statistics_T statistics[UPLOAD_QUEUE_CLASS_COUNT];
+    uint8_t queueClass;
+
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        statistics[queueClass] = *UploadQueue_GetStatistics(&SimQueue, (UploadQueue_Class_T) queueClass);
+    }
+    (void) UploadQueue_Push(&SimQueue, UPLOAD_QUEUE_CLASS_DIAGNOSTICS, statistics, sizeof(statistics), SimNowMs);
+}
+
+static uint32_t ParseNumber(const char * option, const char * value, uint32_t max)
+{
+    char * end = NULL;
+    unsigned long number = (NULL != value) ? strtoul(value, &end, 10) : 0UL;
+
+    if ((NULL == value) || (end == value) || ('\0' != *end) || (number > max))
+    {
+        fprintf(stderr, "UploadQueueSim: invalid value for %s\n", option);
+        exit(2);
+    }
+    return (uint32_t) number;
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    UploadQueue_ClassSetup_T setups[UPLOAD_QUEUE_CLASS_COUNT] =
+            {
+                    [UPLOAD_QUEUE_CLASS_ALERT] = { SimAlertStorage, sizeof(SimAlertStorage), 0UL, (uint8_t) SIM_ALERTS, UPLOAD_QUEUE_OVERFLOW_REJECT },
+                    [UPLOAD_QUEUE_CLASS_TELEMETRY] = { SimTelemetryStorage, sizeof(SimTelemetryStorage), 0UL, 1U, UPLOAD_QUEUE_OVERFLOW_DROP_OLDEST },
+                    [UPLOAD_QUEUE_CLASS_BACKLOG] = { SimBacklogStorage, 0UL, 2048UL, 12U, UPLOAD_QUEUE_OVERFLOW_DROP_OLDEST },
+                    [UPLOAD_QUEUE_CLASS_DIAGNOSTICS] = { SimDiagnosticsStorage, sizeof(SimDiagnosticsStorage), 0UL, 1U, UPLOAD_QUEUE_OVERFLOW_REPLACE },
+            };
+    SensorSnapshot_T snapshot;
+    const UploadQueue_Statistics_T * statistics;
+    uint32_t hours = 24U;
+    uint32_t intervalMs = 10000U;
+    uint32_t backlog = 48U;
+    uint32_t intervals = 0UL;
+    uint32_t endMs;
+    uint32_t boundMs;
+    uint8_t queueClass;
+    int arg;
+
+    for (arg = 1; arg < argc; arg += 2)
+    {
+        const char * value = (arg + 1 < argc) ? argv[arg + 1] : NULL;
+
+        if (0 == strcmp(argv[arg], "--hours"))
+        {
+            hours = ParseNumber(argv[arg], value, 720U);
+        }
+        else if (0 == strcmp(argv[arg], "--seed"))
+        {
+            SimSeed = ParseNumber(argv[arg], value, UINT32_MAX);
+        }
+        else if (0 == strcmp(argv[arg], "--interval"))
+        {
+            intervalMs = ParseNumber(argv[arg], value, 3600000U);
+        }
+        else if (0 == strcmp(argv[arg], "--kbps"))
+        {
+            SimKbps = ParseNumber(argv[arg], value, 100000U);
+        }
+        else if (0 == strcmp(argv[arg], "--rtt"))
+        {
+            SimRttMs = ParseNumber(argv[arg], value, 60000U);
+        }
+        else if (0 == strcmp(argv[arg], "--good"))
+        {
+            SimGoodS = (double) ParseNumber(argv[arg], value, 86400U);
+        }
+        else if (0 == strcmp(argv[arg], "--bad"))
+        {
+            SimBadS = (double) ParseNumber(argv[arg], value, 86400U);
+        }
+        else if (0 == strcmp(argv[arg], "--timeout"))
+        {
+            SimTimeoutMs = ParseNumber(argv[arg], value, 600000U);
+        }
+        else if (0 == strcmp(argv[arg], "--alert"))
+        {
+            SimAlertS = (double) ParseNumber(argv[arg], value, 86400U);
+        }
+        else if (0 == strcmp(argv[arg], "--backlog"))
+        {
+            backlog = ParseNumber(argv[arg], value, SIM_MAX_BACKLOG);
+        }
+        else if (0 == strcmp(argv[arg], "--budget"))
+        {
+            setups[UPLOAD_QUEUE_CLASS_BACKLOG].IntervalBudget = ParseNumber(argv[arg], value, UINT32_MAX);
+        }
+        else if (0 == strcmp(argv[arg], "--batch"))
+        {
+            setups[UPLOAD_QUEUE_CLASS_BACKLOG].MaxBatch = (uint8_t) ParseNumber(argv[arg], value, 255U);
+        }
+        else
+        {
+            fprintf(stderr, "UploadQueueSim: unknown option %s, see the file header for the usage\n", argv[arg]);
+            return 2;
+        }
+    }
+    if ((0U == SimKbps) || (0U == intervalMs) || (0.0 == SimGoodS) || (0.0 == SimBadS) || (0.0 == SimAlertS) ||
+            (0U == backlog) || (0U == setups[UPLOAD_QUEUE_CLASS_BACKLOG].MaxBatch))
+    {
+        fprintf(stderr, "UploadQueueSim: --kbps, --interval, --good, --bad, --alert, --backlog and --batch must not be 0\n");
+        return 2;
+    }
+    setups[UPLOAD_QUEUE_CLASS_BACKLOG].Size = UPLOAD_QUEUE_CLASS_SIZE(backlog, sizeof(SensorSnapshot_T));
+    if (!UploadQueue_Init(&SimQueue, setups, SIM_RECENT_MS))
+    {
+        fprintf(stderr, "UploadQueueSim: invalid queue setup\n");
+        return 2;
+    }
+
+    memset(&snapshot, 0, sizeof(snapshot));
+    endMs = hours * 3600000U;
+    SimLinkChangeMs = SimExponentialMs(SimGoodS);
+    SimNextAlertMs = SimExponentialMs(SimAlertS);
+    while (SimNowMs < endMs)
+    {
+        /* AppControllerPreparePayload */
+        snapshot.TimestampMs = SimNowMs;
+        (void) UploadQueue_Push(&SimQueue, UPLOAD_QUEUE_CLASS_TELEMETRY, &snapshot, sizeof(snapshot), SimNowMs);
+        UploadQueue_StartInterval(&SimQueue);
+        SimAlertsUntil(SimNowMs);
+        SimLinkUntil(SimNowMs);
+        if (SimPostQueue(UPLOAD_QUEUE_CLASS_DIAGNOSTICS) && (0U == (++intervals % SIM_REPORT_POSTS)))
+        {
+            SimReport();
+        }
+        SimWait(intervalMs);
+    }
+
+    printf("%u h, upload every %u ms, good link %u kbit/s %u ms (mean %.0f s), bad link %u ms timeouts (mean %.0f s)\n",
+            (unsigned) hours, (unsigned) intervalMs, (unsigned) SimKbps, (unsigned) SimRttMs, SimGoodS, (unsigned) SimTimeoutMs, SimBadS);
+    printf("%u posts, %u failed, longest successful post %u ms\n\n", (unsigned) SimPosts, (unsigned) SimFailedPosts, (unsigned) SimMaxPostMs);
+    printf("class        pushed     sent  dropped  demoted  waiting  peak B  mean ms    max ms\n");
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        statistics = UploadQueue_GetStatistics(&SimQueue, (UploadQueue_Class_T) queueClass);
+        printf("%-11s %7u  %7u  %7u  %7u  %7u  %6u  %7u  %8u\n", UploadQueue_GetClassName((UploadQueue_Class_T) queueClass),
+                (unsigned) statistics->Enqueued, (unsigned) statistics->Sent, (unsigned) statistics->Dropped, (unsigned) statistics->Demoted,
+                (unsigned) statistics->Depth, (unsigned) statistics->PeakBytes,
+                (unsigned) ((0UL != statistics->Sent) ? (statistics->TotalLatencyMs / statistics->Sent) : 0UL), (unsigned) statistics->MaxLatencyMs);
+    }
+
+    /* The post in flight, possibly one failing as the link came back, then the alert post itself */
+    boundMs = ((SimTimeoutMs > SimMaxPostMs) ? SimTimeoutMs : SimMaxPostMs) + SimMaxPostMs;
+    printf("\nalerts on a steady good link: %u, latency mean %u ms max %u ms (bound %u ms)\n", (unsigned) SimAlertsGood,
+            (unsigned) ((0UL != SimAlertsGood) ? (SimAlertTotalGoodMs / SimAlertsGood) : 0ULL), (unsigned) SimAlertMaxGoodMs, (unsigned) boundMs);
+    printf("alerts hit by a bad link:     %u, latency max %u ms\n", (unsigned) SimAlertsBad, (unsigned) SimAlertMaxBadMs);
+    if (SimAlertMaxGoodMs > boundMs)
+    {
+        printf("FAIL: an alert on a steady good link waited longer than the bound\n");
+        return 1;
+    }
+    return 0;
+}
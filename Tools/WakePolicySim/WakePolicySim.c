@@ -0,0 +1,604 @@
+/**
+ *  @file
+ *
+ *  @brief Host simulation of the XDK110_Dashboard wake on event sensing.
+ *
+ *  Runs a synthetic office day (motion bursts, daylight and room lights)
+ *  through the firmware WakePolicy with 1 ms resolution, the way WakeAgent and
+ *  AppController drive it: the slope interrupt calls WakePolicy_OnMotion, a
+ *  timer polls the policy every ramp step while it is active, every light read
+ *  is checked against the lux window and a change of the periods restarts the
+ *  sensor and snapshot timers whose period differs (xTimerChangePeriod). The
+ *  same day is also run with every sensor at the fixed 1000 ms of SensorTable.
+ *
+ *  The report compares both runs: reads per sensor, MCU wake ups, an energy
+ *  estimate, how long after the start of a motion burst the accelerometer was
+ *  read and how long after a light change the BME280 was read. It checks that
+ *  no sensor goes unread longer than the heartbeat (plus the active period
+ *  its timer may have run at before the return to idle), that every light
+ *  change reads the BME280 within the light poll period, that the motion period
+ *  stays within its limits and that the policy is idle again at the end of
+ *  the day; a violation makes the exit code 1.
+ *
+ *  Usage: WakePolicySim [options]
+ *    --hours <n>       length of the day, default 24, at most 240
+ *    --seed <n>        seed of the synthetic day, default 4711
+ *    --irq <ms>        slope interrupt interval during motion, default 250
+ *    --csv <file>      write every period change: ms, state, motion and snapshot period
+ *
+ */
+
+/* module includes ********************************************************** */
+
+#include "WakePolicy.h"
+#include "SensorTable.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define SIM_MAX_BURSTS          4096U
+#define SIM_MAX_LIGHT_STEPS     64U
+#define SIM_TIMER_COUNT         (SENSOR_TABLE_SENSOR_COUNT + 1U) /**< Sensor timers, then the snapshot timer */
+#define SIM_SNAPSHOT_TIMER      SENSOR_TABLE_SENSOR_COUNT
+#define SIM_FIXED_PERIOD_MS     1000U /**< Period of SensorTable and of the snapshot timer */
+#define SIM_SLOPE_LATENCY_MS    32U   /**< WAKE_SLOPE_DURATION samples of the BMA280 at 62.5 Hz */
+#define SIM_WAKE_UP_UJ          12.0  /**< MCU out of sleep and back, timer service task and lane switch */
+#define SIM_SNAPSHOT_UJ         8.0   /**< Snapshot appended to the compressed batch */
+
+/* local types ************************************************************** */
+
+struct SimBurst_S
+{
+    uint32_t StartMs;
+    uint32_t EndMs;
+};
+typedef struct SimBurst_S SimBurst_T;
+
+struct SimLightStep_S
+{
+    uint32_t Ms;
+    uint32_t LevelMlx; /**< Room light from this time on */
+};
+typedef struct SimLightStep_S SimLightStep_T;
+
+struct SimRun_S
+{
+    bool IsFixed;
+    uint32_t Reads[SENSOR_TABLE_SENSOR_COUNT];
+    uint32_t LastReadMs[SENSOR_TABLE_SENSOR_COUNT];
+    uint32_t MaxGapMs[SENSOR_TABLE_SENSOR_COUNT];
+    uint32_t Snapshots;
+    uint32_t WakeUps;
+    double EnergyUj;
+    uint32_t MotionLatencyMs[SIM_MAX_BURSTS];
+    uint32_t LightLatencyMs[SIM_MAX_LIGHT_STEPS];
+    uint32_t ActiveMs;
+    uint32_t FastestMotionMs;
+    uint32_t SlowestMotionMs;
+    WakePolicy_Statistics_T Statistics;
+};
+typedef struct SimRun_S SimRun_T;
+
+struct SimTimers_S
+{
+    uint32_t PeriodMs[SIM_TIMER_COUNT];
+    uint32_t DueMs[SIM_TIMER_COUNT];
+    bool IsQuietRunning;
+    uint32_t QuietDueMs;
+};
+typedef struct SimTimers_S SimTimers_T;
+
+/* local variables ********************************************************** */
+
+/** Energy of a read in uJ, order of magnitude estimates: I2C transfer, driver and conversion where the sensor measures on demand */
+static const double SimReadUj[SENSOR_TABLE_SENSOR_COUNT] =
+        {
+                6.0,   /* accelerometer, calibrated read */
+                45.0,  /* gyroscope */
+                35.0,  /* magnetometer, forced measurement */
+                25.0,  /* environmental, forced measurement in the wake run */
+                8.0,   /* light */
+                120.0, /* acoustic, RMS over an ADC window */
+        };
+
+/** Defaults of AppController.h (WAKE_*) */
+static WakePolicy_Setup_T SimSetup =
+        {
+                .HeartbeatMs = 60000U,
+                .LightPollMs = 1000U,
+                .ActivePeriodMs = 1000U,
+                .FastestPeriodMs = 125U,
+                .RampStepMs = 2000U,
+                .QuietMs = 10000U,
+                .MotionSensors = (1U << SENSOR_TABLE_SENSOR_ACCELEROMETER) | (1U << SENSOR_TABLE_SENSOR_GYROSCOPE),
+                .OnDemandSensors = (1U << SENSOR_TABLE_SENSOR_ENVIRONMENTAL),
+                .LuxWindowPermille = 200U,
+                .LuxHysteresis = 20000U,
+        };
+
+static SimBurst_T SimBursts[SIM_MAX_BURSTS];
+
+static uint32_t SimBurstCount = 0U;
+
+static SimLightStep_T SimLightSteps[SIM_MAX_LIGHT_STEPS];
+
+static uint32_t SimLightStepCount = 0U;
+
+static uint32_t SimEndMs = 24U * 3600000U;
+
+static uint32_t SimIrqMs = 250U;
+
+static uint32_t SimSeed = 4711U;
+
+static uint32_t SimDaySeed = 4711U;
+
+static SimRun_T SimRuns[2];
+
+static WakePolicy_T SimPolicy;
+
+static SimTimers_T SimTimers;
+
+static FILE * SimCsv = NULL;
+
+static uint32_t SimErrors = 0U;
+
+/* local functions ********************************************************** */
+
+static double SimRandom(void)
+{
+    SimSeed = (SimSeed * 1103515245U) + 12345U;
+    return (double) ((SimSeed >> 8) & 0xFFFFU) / 65536.0;
+}
+
+static uint32_t SimRandomMs(double minS, double maxS)
+{
+    return (uint32_t) ((minS + (SimRandom() * (maxS - minS))) * 1000.0);
+}
+
+static void AddLightStep(uint32_t ms, uint32_t levelMlx)
+{
+    if ((SimLightStepCount < SIM_MAX_LIGHT_STEPS) && (ms < SimEndMs))
+    {
+        SimLightSteps[SimLightStepCount].Ms = ms;
+        SimLightSteps[SimLightStepCount].LevelMlx = levelMlx;
+        SimLightStepCount++;
+    }
+}
+
+/**
+ * @brief Office day: frequent short motion bursts during working hours, rare
+ * ones at night, room lights on in the morning and off in the evening with a
+ * few toggles in between. The last QuietMs and ramp steps stay calm, so the
+ * policy can return to idle.
+ */
+static void SyntheticDay(void)
+{
+    uint32_t calmFromMs = SimEndMs - (SimSetup.QuietMs + (8U * SimSetup.RampStepMs));
+    uint32_t nowMs = SimRandomMs(0.0, 1800.0);
+    uint32_t toggles;
+    double hour;
+
+    while (SimBurstCount < SIM_MAX_BURSTS)
+    {
+        hour = fmod((double) nowMs / 3600000.0, 24.0);
+        SimBursts[SimBurstCount].StartMs = nowMs;
+        if ((hour >= 8.0) && (hour < 18.0))
+        {
+            SimBursts[SimBurstCount].EndMs = nowMs + SimRandomMs(5.0, 120.0);
+            nowMs = SimBursts[SimBurstCount].EndMs - (uint32_t) (log(1.0 - SimRandom()) * 600000.0);
+        }
+        else
+        {
+            SimBursts[SimBurstCount].EndMs = nowMs + SimRandomMs(3.0, 20.0);
+            nowMs = SimBursts[SimBurstCount].EndMs - (uint32_t) (log(1.0 - SimRandom()) * 7200000.0);
+        }
+        if (SimBursts[SimBurstCount].EndMs >= calmFromMs)
+        {
+            break;
+        }
+        SimBurstCount++;
+    }
+
+    AddLightStep(SimRandomMs(7.5 * 3600.0, 8.5 * 3600.0), 300000U);
+    for (toggles = 0U; toggles < 3U; toggles++)
+    {
+        nowMs = SimRandomMs((9.0 + (3.0 * toggles)) * 3600.0, (11.0 + (3.0 * toggles)) * 3600.0);
+        AddLightStep(nowMs, 0U);
+        AddLightStep(nowMs + SimRandomMs(60.0, 1800.0), 300000U);
+    }
+    AddLightStep(SimRandomMs(18.0 * 3600.0, 19.5 * 3600.0), 0U);
+}
+
+/**
+ * @brief Light at a time in mlx: daylight through the window plus the room light.
+ */
+static uint32_t SimLux(uint32_t nowMs)
+{
+    double hour = fmod((double) nowMs / 3600000.0, 24.0);
+    double daylight = ((hour > 6.0) && (hour < 20.0)) ? (250000.0 * sin(((hour - 6.0) / 14.0) * M_PI)) : 0.0;
+    uint32_t levelMlx = 0U;
+    uint32_t index;
+
+    for (index = 0U; (index < SimLightStepCount) && (SimLightSteps[index].Ms <= nowMs); index++)
+    {
+        levelMlx = SimLightSteps[index].LevelMlx;
+    }
+    return (uint32_t) daylight + levelMlx;
+}
+
+static void WriteCsv(uint32_t nowMs)
+{
+    if (NULL != SimCsv)
+    {
+        fprintf(SimCsv, "%u,%s,%u,%u\n", nowMs, (WAKE_POLICY_STATE_ACTIVE == SimPolicy.State) ? "active" : "idle",
+                WakePolicy_GetPeriodMs(&SimPolicy, SENSOR_TABLE_SENSOR_ACCELEROMETER), WakePolicy_GetSnapshotPeriodMs(&SimPolicy));
+    }
+}
+
+static void Apply(SimRun_T * run, bool periodsChanged, uint32_t nowMs);
+
+/**
+ * @brief A sensor read, see SensorComponentReadWork and the read hook of WakeAgent.
+ */
+static void Read(SimRun_T * run, uint8_t sensor, uint32_t nowMs)
+{
+    uint32_t gapMs = nowMs - run->LastReadMs[sensor];
+    uint32_t index;
+
+    run->Reads[sensor]++;
+    run->EnergyUj += SimReadUj[sensor];
+    if (gapMs > run->MaxGapMs[sensor])
+    {
+        run->MaxGapMs[sensor] = gapMs;
+    }
+    run->LastReadMs[sensor] = nowMs;
+
+    /* first read after the start of a motion burst or a light change */
+    for (index = 0U; (SENSOR_TABLE_SENSOR_ACCELEROMETER == sensor) && (index < SimBurstCount); index++)
+    {
+        if ((UINT32_MAX == run->MotionLatencyMs[index]) && (SimBursts[index].StartMs <= nowMs))
+        {
+            run->MotionLatencyMs[index] = nowMs - SimBursts[index].StartMs;
+        }
+    }
+    for (index = 0U; (SENSOR_TABLE_SENSOR_ENVIRONMENTAL == sensor) && (index < SimLightStepCount); index++)
+    {
+        if ((UINT32_MAX == run->LightLatencyMs[index]) && (SimLightSteps[index].Ms <= nowMs))
+        {
+            run->LightLatencyMs[index] = nowMs - SimLightSteps[index].Ms;
+        }
+    }
+
+    if ((SENSOR_TABLE_SENSOR_LIGHT == sensor) && !run->IsFixed && WakePolicy_OnLight(&SimPolicy, SimLux(nowMs), nowMs))
+    {
+        Apply(run, false, nowMs);
+    }
+}
+
+/**
+ * @brief Acts on a result of the policy like AgentApply and AppControllerRetimeWake.
+ */
+static void Apply(SimRun_T * run, bool periodsChanged, uint32_t nowMs)
+{
+    uint32_t pending;
+    uint32_t periodMs;
+    uint8_t timer;
+
+    if (periodsChanged)
+    {
+        /* xTimerStart restarts a running timer too */
+        SimTimers.IsQuietRunning = (WAKE_POLICY_STATE_ACTIVE == SimPolicy.State);
+        SimTimers.QuietDueMs = nowMs + SimSetup.RampStepMs;
+        for (timer = 0U; timer < SIM_TIMER_COUNT; timer++)
+        {
+            periodMs = (SIM_SNAPSHOT_TIMER == timer) ? WakePolicy_GetSnapshotPeriodMs(&SimPolicy) : WakePolicy_GetPeriodMs(&SimPolicy, timer);
+            if (periodMs != SimTimers.PeriodMs[timer])
+            {
+                SimTimers.PeriodMs[timer] = periodMs;
+                SimTimers.DueMs[timer] = nowMs + periodMs;
+            }
+        }
+        periodMs = WakePolicy_GetPeriodMs(&SimPolicy, SENSOR_TABLE_SENSOR_ACCELEROMETER);
+        run->FastestMotionMs = (periodMs < run->FastestMotionMs) ? periodMs : run->FastestMotionMs;
+        run->SlowestMotionMs = (periodMs > run->SlowestMotionMs) ? periodMs : run->SlowestMotionMs;
+        WriteCsv(nowMs);
+    }
+    pending = WakePolicy_TakePendingReads(&SimPolicy);
+    for (timer = 0U; timer < SENSOR_TABLE_SENSOR_COUNT; timer++)
+    {
+        if (0U != (pending & (1U << timer)))
+        {
+            Read(run, timer, nowMs);
+        }
+    }
+}
+
+static void Run(SimRun_T * run)
+{
+    uint32_t burst = 0U;
+    uint32_t nextIrqMs = 0U;
+    uint32_t nowMs;
+    uint8_t timer;
+    bool isAwake;
+
+    for (burst = 0U; burst < SimBurstCount; burst++)
+    {
+        run->MotionLatencyMs[burst] = UINT32_MAX;
+    }
+    for (burst = 0U; burst < SimLightStepCount; burst++)
+    {
+        run->LightLatencyMs[burst] = UINT32_MAX;
+    }
+    burst = 0U;
+    run->FastestMotionMs = UINT32_MAX;
+    memset(&SimTimers, 0, sizeof(SimTimers));
+    if (run->IsFixed)
+    {
+        for (timer = 0U; timer < SIM_TIMER_COUNT; timer++)
+        {
+            SimTimers.PeriodMs[timer] = SIM_FIXED_PERIOD_MS;
+            SimTimers.DueMs[timer] = SIM_FIXED_PERIOD_MS;
+        }
+        run->FastestMotionMs = SIM_FIXED_PERIOD_MS;
+        run->SlowestMotionMs = SIM_FIXED_PERIOD_MS;
+    }
+    else
+    {
+        (void) WakePolicy_Init(&SimPolicy, &SimSetup);
+        /* AppControllerBootSampling starts every timer at its idle period */
+        Apply(run, true, 0U);
+    }
+
+    for (nowMs = 0U; nowMs < SimEndMs; nowMs++)
+    {
+        isAwake = false;
+        while ((burst < SimBurstCount) && (nowMs >= SimBursts[burst].EndMs))
+        {
+            burst++;
+        }
+        if (!run->IsFixed && (burst < SimBurstCount) && (nowMs >= SimBursts[burst].StartMs))
+        {
+            if (nowMs == SimBursts[burst].StartMs)
+            {
+                nextIrqMs = nowMs + SIM_SLOPE_LATENCY_MS;
+            }
+            if (nowMs == nextIrqMs)
+            {
+                nextIrqMs += SimIrqMs;
+                isAwake = true;
+                Apply(run, WakePolicy_OnMotion(&SimPolicy, nowMs), nowMs);
+            }
+        }
+        for (timer = 0U; timer < SIM_TIMER_COUNT; timer++)
+        {
+            if (nowMs == SimTimers.DueMs[timer])
+            {
+                SimTimers.DueMs[timer] += SimTimers.PeriodMs[timer];
+                isAwake = true;
+                if (SIM_SNAPSHOT_TIMER == timer)
+                {
+                    run->Snapshots++;
+                    run->EnergyUj += SIM_SNAPSHOT_UJ;
+                }
+                else
+                {
+                    Read(run, timer, nowMs);
+                }
+            }
+        }
+        if (SimTimers.IsQuietRunning && (nowMs == SimTimers.QuietDueMs))
+        {
+            SimTimers.QuietDueMs += SimSetup.RampStepMs;
+            isAwake = true;
+            Apply(run, WakePolicy_Poll(&SimPolicy, nowMs), nowMs);
+        }
+        if (!run->IsFixed && (WAKE_POLICY_STATE_ACTIVE == SimPolicy.State))
+        {
+            run->ActiveMs++;
+        }
+        if (isAwake)
+        {
+            run->WakeUps++;
+            run->EnergyUj += SIM_WAKE_UP_UJ;
+        }
+    }
+    for (timer = 0U; timer < SENSOR_TABLE_SENSOR_COUNT; timer++)
+    {
+        if ((SimEndMs - run->LastReadMs[timer]) > run->MaxGapMs[timer])
+        {
+            run->MaxGapMs[timer] = SimEndMs - run->LastReadMs[timer];
+        }
+    }
+    if (!run->IsFixed)
+    {
+        run->Statistics = SimPolicy.Statistics;
+    }
+}
+
+static void Check(bool condition, const char * message)
+{
+    if (!condition)
+    {
+        printf("VIOLATION: %s\n", message);
+        SimErrors++;
+    }
+}
+
+static int CompareU32(const void * left, const void * right)
+{
+    uint32_t a = *(const uint32_t *) left;
+    uint32_t b = *(const uint32_t *) right;
+
+    return (a > b) - (a < b);
+}
+
+/**
+ * @brief Prints mean / p99 / max of the latencies of the events that got a read, returns the events that did not.
+ */
+static uint32_t PrintLatencies(const char * name, uint32_t * latencies, uint32_t count)
+{
+    uint32_t detected = 0U;
+    uint32_t index;
+    double sum = 0.0;
+
+    qsort(latencies, count, sizeof(latencies[0]), CompareU32);
+    while ((detected < count) && (UINT32_MAX != latencies[detected]))
+    {
+        sum += latencies[detected];
+        detected++;
+    }
+    if (0U == detected)
+    {
+        printf("  %-9s %12s", name, "-");
+    }
+    else
+    {
+        index = ((detected * 99U) - 1U) / 100U;
+        printf("  %-9s %5.0f/%5u/%5u", name, sum / detected, latencies[index], latencies[detected - 1U]);
+    }
+    return count - detected;
+}
+
+static void PrintReport(void)
+{
+    SimRun_T * fixed = &SimRuns[0];
+    SimRun_T * wake = &SimRuns[1];
+    uint32_t movingMs = 0U;
+    uint32_t readsFixed = 0U;
+    uint32_t readsWake = 0U;
+    uint32_t missed[2];
+    uint32_t lightLimitMs = (SimSetup.LightPollMs > SimSetup.ActivePeriodMs) ? SimSetup.LightPollMs : SimSetup.ActivePeriodMs;
+    uint32_t lightLatencyMs = 0U;
+    uint8_t sensor;
+    uint32_t index;
+
+    for (index = 0U; index < SimBurstCount; index++)
+    {
+        movingMs += SimBursts[index].EndMs - SimBursts[index].StartMs;
+    }
+    printf("scenario: %.1f h, %u motion bursts (%.1f min moving), %u light changes, seed %u\n\n", SimEndMs / 3600000.0,
+            SimBurstCount, movingMs / 60000.0, SimLightStepCount, SimDaySeed);
+    printf("%-16s %12s %12s %12s\n", "", "fixed 1000 ms", "wake", "max gap s");
+    for (sensor = 0U; sensor < SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        printf("%-16s %12u %12u %12.1f\n", SensorTable_GetSensorName(sensor), fixed->Reads[sensor], wake->Reads[sensor],
+                wake->MaxGapMs[sensor] / 1000.0);
+        readsFixed += fixed->Reads[sensor];
+        readsWake += wake->Reads[sensor];
+    }
+    printf("%-16s %12u %12u\n", "reads", readsFixed, readsWake);
+    printf("%-16s %12u %12u\n", "snapshots", fixed->Snapshots, wake->Snapshots);
+    printf("%-16s %12u %12u\n", "wake ups", fixed->WakeUps, wake->WakeUps);
+    printf("%-16s %12.1f %12.1f  (estimate, %.1f %% of fixed)\n\n", "energy mJ", fixed->EnergyUj / 1000.0, wake->EnergyUj / 1000.0,
+            (100.0 * wake->EnergyUj) / fixed->EnergyUj);
+
+    printf("latency ms, mean/p99/max       fixed 1000 ms       wake\n");
+    printf("%-20s", "motion to accel read");
+    missed[0] = PrintLatencies("", fixed->MotionLatencyMs, SimBurstCount);
+    missed[1] = PrintLatencies("", wake->MotionLatencyMs, SimBurstCount);
+    printf("\n%-20s", "light to BME280 read");
+    (void) PrintLatencies("", fixed->LightLatencyMs, SimLightStepCount);
+    (void) PrintLatencies("", wake->LightLatencyMs, SimLightStepCount);
+    for (index = 0U; index < SimLightStepCount; index++)
+    {
+        lightLatencyMs = (wake->LightLatencyMs[index] > lightLatencyMs) ? wake->LightLatencyMs[index] : lightLatencyMs;
+    }
+    printf("\n\npolicy: %u activations, %u motion events, %u ramp steps, %u light events, active %.1f min, accelerometer period %u..%u ms\n",
+            wake->Statistics.Activations, wake->Statistics.MotionEvents, wake->Statistics.RampSteps, wake->Statistics.LightEvents,
+            wake->ActiveMs / 60000.0, wake->FastestMotionMs, wake->SlowestMotionMs);
+
+    /* back to idle, a timer restarts with the heartbeat up to one active period after its last read */
+    for (sensor = 0U; sensor < SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        Check(wake->MaxGapMs[sensor] <= (SimSetup.HeartbeatMs + SimSetup.ActivePeriodMs), "a sensor went unread longer than the heartbeat");
+    }
+    Check(wake->FastestMotionMs >= SimSetup.FastestPeriodMs, "motion period below FastestPeriodMs");
+    Check(wake->SlowestMotionMs <= SimSetup.HeartbeatMs, "motion period above the heartbeat");
+    Check(0U == missed[0], "fixed run missed a motion burst");
+    Check(0U == missed[1], "wake run missed a motion burst");
+    Check(lightLatencyMs <= lightLimitMs, "a light change waited longer than the light poll for the BME280 read");
+    Check(wake->Statistics.Activations >= 1U || (0U == SimBurstCount), "motion never activated the policy");
+    Check(WAKE_POLICY_STATE_IDLE == SimPolicy.State, "policy still active after the calm end of the day");
+    Check(wake->Reads[SENSOR_TABLE_SENSOR_ACCELEROMETER] > 0U, "accelerometer never read");
+    printf("%s\n", (0U == SimErrors) ? "checks: ok" : "checks: FAILED");
+}
+
+static void Usage(const char * name)
+{
+    fprintf(stderr, "usage: %s [--hours <n>] [--seed <n>] [--irq <ms>] [--csv <file>]\n", name);
+}
+
+/* global functions ********************************************************* */
+
+int main(int argc, char ** argv)
+{
+    const char * csvPath = NULL;
+    uint32_t hours = 24U;
+    int arg;
+
+    for (arg = 1; arg < argc; arg++)
+    {
+        const char * option = argv[arg];
+        const char * value = ((arg + 1) < argc) ? argv[arg + 1] : NULL;
+
+        if (NULL == value)
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        arg++;
+        if (0 == strcmp(option, "--hours"))
+        {
+            hours = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--seed"))
+        {
+            SimSeed = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--irq"))
+        {
+            SimIrqMs = (uint32_t) strtoul(value, NULL, 10);
+        }
+        else if (0 == strcmp(option, "--csv"))
+        {
+            csvPath = value;
+        }
+        else
+        {
+            Usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if ((0U == hours) || (hours > 240U) || (0U == SimIrqMs))
+    {
+        Usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    SimEndMs = hours * 3600000U;
+    if (NULL != csvPath)
+    {
+        SimCsv = fopen(csvPath, "w");
+        if (NULL == SimCsv)
+        {
+            perror(csvPath);
+            return EXIT_FAILURE;
+        }
+        fprintf(SimCsv, "ms,state,motion_period_ms,snapshot_period_ms\n");
+    }
+
+    SimDaySeed = SimSeed;
+    SyntheticDay();
+    SimRuns[0].IsFixed = true;
+    Run(&SimRuns[0]);
+    Run(&SimRuns[1]);
+    PrintReport();
+    if (NULL != SimCsv)
+    {
+        fclose(SimCsv);
+    }
+    return (0U == SimErrors) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
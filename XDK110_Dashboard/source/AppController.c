@@ -14,7 +14,6 @@
 #include <stdio.h>
 #include "BCDS_CmdProcessor.h"
 #include "FreeRTOS.h"
-#include "XdkSensorHandle.h"
 #include "timers.h"
 
 #include "XDK_WLAN.h"
@@ -30,6 +29,107 @@
 #include "XDK_Utils.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#if APP_SD_LOG_ENABLE || APP_SENSOR_TRACE_ENABLE || APP_DELTA_FOTA_ENABLE
+#include "XDK_Storage.h"
+#endif /* APP_SD_LOG_ENABLE || APP_SENSOR_TRACE_ENABLE || APP_DELTA_FOTA_ENABLE */
+#if APP_SD_LOG_ENABLE
+#include "ff.h"
+#endif /* APP_SD_LOG_ENABLE */
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+#include <string.h>
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
+
+#include "SensorSnapshot.h"
+#include "SensorComponent.h"
+#include "TimeSeriesCompressor.h"
+#include "BootSequencer.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+#if APP_LWM2M_ENABLE
+#include "Lwm2mAgent.h"
+#endif /* APP_LWM2M_ENABLE */
+#if APP_BLE_STREAM_ENABLE
+#include "SampleRing.h"
+#include "BleStreamAgent.h"
+#endif /* APP_BLE_STREAM_ENABLE */
+#if APP_LORA_ENABLE
+#include "LoRaAgent.h"
+#endif /* APP_LORA_ENABLE */
+#if HTTPS_SESSION_ENABLE
+#include "HttpsAgent.h"
+#endif /* HTTPS_SESSION_ENABLE */
+#if DNS_CACHE_ENABLE
+#include "DnsAgent.h"
+#endif /* DNS_CACHE_ENABLE */
+#if APP_SENSOR_TRACE_ENABLE
+#include "SensorTraceAgent.h"
+#endif /* APP_SENSOR_TRACE_ENABLE */
+#if APP_WAKE_ON_EVENT_ENABLE
+#include "WakeAgent.h"
+#endif /* APP_WAKE_ON_EVENT_ENABLE */
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+#include "SensorSchema.h"
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+#if APP_REMOTE_CONFIG_ENABLE
+#include "ConfigAgent.h"
+#include "XdkSensorHandle.h"
+#endif /* APP_REMOTE_CONFIG_ENABLE */
+#if APP_DELTA_FOTA_ENABLE
+#include "DeltaFotaAgent.h"
+#endif /* APP_DELTA_FOTA_ENABLE */
+#if APP_UPLOAD_QUEUE_ENABLE
+#include "UploadQueue.h"
+#include <stdarg.h>
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+#if APP_LIVE_VIEW_ENABLE
+#include "LiveViewAgent.h"
+#endif /* APP_LIVE_VIEW_ENABLE */
+#if APP_DECIMATION_ENABLE
+#include "DecimationFilter.h"
+#include <math.h>
+#endif /* APP_DECIMATION_ENABLE */
+#if APP_POWER_POLICY_ENABLE
+#include "PowerAgent.h"
+#endif /* APP_POWER_POLICY_ENABLE */
+#if APP_THERMAL_ENABLE
+#include "ThermalAgent.h"
+#endif /* APP_THERMAL_ENABLE */
+
+#if APP_WAKE_ON_EVENT_ENABLE && (APP_LWM2M_ENABLE || APP_BLE_STREAM_ENABLE)
+#error "APP_WAKE_ON_EVENT_ENABLE retimes the sensors, it cannot be combined with APP_LWM2M_ENABLE or APP_BLE_STREAM_ENABLE"
+#endif /* APP_WAKE_ON_EVENT_ENABLE && (APP_LWM2M_ENABLE || APP_BLE_STREAM_ENABLE) */
+
+#if APP_SD_BACKLOG_UPLOAD_ENABLE && !(APP_SD_LOG_ENABLE && HTTPS_SESSION_ENABLE && (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_COMPRESSED))
+#error "APP_SD_BACKLOG_UPLOAD_ENABLE needs APP_SD_LOG_ENABLE, HTTPS_SESSION_ENABLE and APP_UPLOAD_ENCODING_COMPRESSED"
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE && ... */
+
+#if APP_REMOTE_CONFIG_ENABLE && (!HTTPS_SESSION_ENABLE || APP_WAKE_ON_EVENT_ENABLE || APP_LWM2M_ENABLE || APP_BLE_STREAM_ENABLE || APP_LORA_ENABLE)
+#error "APP_REMOTE_CONFIG_ENABLE needs HTTPS_SESSION_ENABLE and retimes the sensors, it cannot be combined with APP_WAKE_ON_EVENT_ENABLE, APP_LWM2M_ENABLE, APP_BLE_STREAM_ENABLE or APP_LORA_ENABLE"
+#endif /* APP_REMOTE_CONFIG_ENABLE && ... */
+
+#if APP_DELTA_FOTA_ENABLE && (!HTTPS_SESSION_ENABLE || APP_LWM2M_ENABLE || APP_LORA_ENABLE)
+#error "APP_DELTA_FOTA_ENABLE needs HTTPS_SESSION_ENABLE and the HTTP upload task, it cannot be combined with APP_LWM2M_ENABLE or APP_LORA_ENABLE"
+#endif /* APP_DELTA_FOTA_ENABLE && ... */
+
+#if APP_UPLOAD_QUEUE_ENABLE && (!HTTPS_SESSION_ENABLE || (APP_UPLOAD_ENCODING != APP_UPLOAD_ENCODING_JSON) || APP_SD_BACKLOG_UPLOAD_ENABLE || APP_LWM2M_ENABLE || APP_LORA_ENABLE)
+#error "APP_UPLOAD_QUEUE_ENABLE needs HTTPS_SESSION_ENABLE, APP_UPLOAD_ENCODING_JSON and the HTTP upload task, it cannot be combined with APP_SD_BACKLOG_UPLOAD_ENABLE, APP_LWM2M_ENABLE or APP_LORA_ENABLE"
+#endif /* APP_UPLOAD_QUEUE_ENABLE && ... */
+
+#if APP_LIVE_VIEW_ENABLE && APP_LORA_ENABLE
+#error "APP_LIVE_VIEW_ENABLE needs the WLAN, it cannot be combined with APP_LORA_ENABLE"
+#endif /* APP_LIVE_VIEW_ENABLE && APP_LORA_ENABLE */
+
+#if APP_DECIMATION_ENABLE && (APP_WAKE_ON_EVENT_ENABLE || APP_LWM2M_ENABLE || APP_BLE_STREAM_ENABLE || APP_REMOTE_CONFIG_ENABLE || SENSOR_COMPONENT_PRINT_ENABLE)
+#error "APP_DECIMATION_ENABLE reads the accelerometer at a fixed period, it cannot be combined with APP_WAKE_ON_EVENT_ENABLE, APP_LWM2M_ENABLE, APP_BLE_STREAM_ENABLE, APP_REMOTE_CONFIG_ENABLE or SENSOR_COMPONENT_PRINT_ENABLE"
+#endif /* APP_DECIMATION_ENABLE && ... */
+
+#if APP_POWER_POLICY_ENABLE && (APP_WAKE_ON_EVENT_ENABLE || APP_LWM2M_ENABLE || APP_BLE_STREAM_ENABLE || APP_LORA_ENABLE || APP_REMOTE_CONFIG_ENABLE || APP_DECIMATION_ENABLE)
+#error "APP_POWER_POLICY_ENABLE retimes the sensors and needs the HTTP upload task, it cannot be combined with APP_WAKE_ON_EVENT_ENABLE, APP_LWM2M_ENABLE, APP_BLE_STREAM_ENABLE, APP_LORA_ENABLE, APP_REMOTE_CONFIG_ENABLE or APP_DECIMATION_ENABLE"
+#endif /* APP_POWER_POLICY_ENABLE && ... */
+
+#if APP_THERMAL_ENABLE && (APP_LWM2M_ENABLE || APP_LORA_ENABLE)
+#error "APP_THERMAL_ENABLE needs the HTTP upload task, it cannot be combined with APP_LWM2M_ENABLE or APP_LORA_ENABLE"
+#endif /* APP_THERMAL_ENABLE && (APP_LWM2M_ENABLE || APP_LORA_ENABLE) */
 
 /* constant definitions ***************************************************** */
 
@@ -41,39 +141,66 @@
 
 #define APP_RESPONSE_FROM_HTTP_SERVER_GET_TIMEOUT       UINT32_C(25000)/**< Timeout for completion of HTTP rest client GET */
 
+#if DNS_CACHE_ENABLE
+#define APP_DNS_REFRESH_PERIOD_MS                       UINT32_C(10000) /**< Period of the check for servers due for a refresh */
+#define APP_DNS_DEFAULT_TTL_S                           UINT32_C(300) /**< TTL of addresses from the resolver of the WLAN chip */
+#define APP_DNS_MIN_TTL_S                               UINT32_C(30)
+#define APP_DNS_MAX_TTL_S                               UINT32_C(86400)
+#define APP_DNS_REFRESH_PERCENT                         UINT8_C(75) /**< Share of the TTL after which a server is resolved again */
+#define APP_DNS_RETRY_MS                                UINT32_C(30000) /**< Shortest time between attempts to resolve a failing server */
+#define APP_DNS_TIMEOUT_MS                              UINT32_C(2000) /**< Longest wait for the DNS server */
+#endif /* DNS_CACHE_ENABLE */
+
+#if HTTPS_SESSION_ENABLE
+#define APP_HTTPS_REPORT_INTERVAL                       UINT32_C(60) /**< Posts between two HttpsAgent reports */
+
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_JSON)
+#define APP_UPLOAD_CONTENT_TYPE                         "application/json"
+#else
+#define APP_UPLOAD_CONTENT_TYPE                         "application/octet-stream"
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_JSON */
+#endif /* HTTPS_SESSION_ENABLE */
+
+#define APP_SNAPSHOT_PERIOD_MS                          UINT32_C(1000) /**< Period of the snapshot timer */
+
+#define APP_BOOT_WORKERS                                UINT8_C(2) /**< Boot steps run concurrently, one per independent chain */
+
+#define APP_STORAGE_ENABLE                              (APP_SD_LOG_ENABLE || APP_SENSOR_TRACE_ENABLE || APP_DELTA_FOTA_ENABLE) /**< The SD card is used */
+
+#define APP_CHANNEL_MASK(channel)                       (UINT32_C(1) << (uint32_t) (channel)) /**< SensorSnapshot channel bit */
+
+#define APP_SD_BACKLOG_STATE_MAGIC                      UINT32_C(0x4C4B4258) /**< "XBKL" */
+
 /* --------------------------------------------------------------------------- |
  * HANDLES ******************************************************************* |
  * -------------------------------------------------------------------------- */
 
 static CmdProcessor_T * AppCmdProcessor;
-xTimerHandle calibratedAccelerometerHandle = NULL;
-xTimerHandle acousticHandle = NULL;
-xTimerHandle environmentalHandle = NULL;
-xTimerHandle gyroscopeHandle = NULL;
-xTimerHandle lightSensorHandle  = NULL;
-xTimerHandle magnetometerHandle = NULL;
-
-float accelerometerXValue = 0;
-float accelerometerYValue = 0;
-float accelerometerZValue = 0;
-float acousticValue = 0;
-long int temperatureValue = 0;
-long int pressureValue = 0;
-long int humidityValue = 0;
-int gyroscopeXValue = 0;
-int gyroscopeYValue = 0;
-int gyroscopeZValue = 0;
-unsigned int lightValue = 0;
-long int magnetometerXValue = 0;
-long int magnetometerYValue = 0;
-long int magnetometerZValue = 0;
+xTimerHandle snapshotHandle = NULL;
+static StaticRtos_Timer_T snapshotStorage;
+#if APP_BLE_STREAM_ENABLE
+xTimerHandle bleStreamHandle = NULL;
+static StaticRtos_Timer_T bleStreamStorage;
+#endif /* APP_BLE_STREAM_ENABLE */
+
+static SensorSnapshot_T LatestSnapshot; /**< Latest value of every channel, written by the sensor timers */
+#if APP_DECIMATION_ENABLE
+static SensorTable_Value_T SensorReadValues[SENSOR_TABLE_CHANNEL_COUNT]; /**< Written by the reads, passed on by AppControllerDecimate */
+#endif /* APP_DECIMATION_ENABLE */
+
+static uint32_t UploadIntervalMs = INTER_REQUEST_INTERVAL; /**< Wait after a POST, changed by the remote configuration or the power policy */
+
+#if APP_POWER_POLICY_ENABLE
+static volatile uint32_t UploadChannelMask = SENSOR_TABLE_ALL_CHANNELS; /**< Channels of the JSON and schema POST bodies, changed by the power policy */
+#define APP_UPLOAD_CHANNELS                             UploadChannelMask
+#else
+#define APP_UPLOAD_CHANNELS                             SENSOR_TABLE_ALL_CHANNELS
+#endif /* APP_POWER_POLICY_ENABLE */
 
 /* --------------------------------------------------------------------------- |
  * VARIABLES ***************************************************************** |
  * -------------------------------------------------------------------------- */
 
-const float aku340ConversionRatio = pow(10,(-38/20));
-
 static WLAN_Setup_T WLANSetupInfo =
         {
                 .IsEnterprise = false,
@@ -84,13 +211,48 @@ static WLAN_Setup_T WLANSetupInfo =
         };/**< WLAN setup parameters */
 
 #if HTTP_SECURE_ENABLE
+#if DNS_CACHE_ENABLE
+static char SntpServerUrl[sizeof(SNTP_SERVER_URL) + DNS_CACHE_ADDRESS_STRING_SIZE] = SNTP_SERVER_URL; /**< SNTP_SERVER_URL, its address once resolved */
+#endif /* DNS_CACHE_ENABLE */
+
 static SNTP_Setup_T SNTPSetupInfo =
         {
+#if DNS_CACHE_ENABLE
+                .ServerUrl = SntpServerUrl,
+#else
                 .ServerUrl = SNTP_SERVER_URL,
+#endif /* DNS_CACHE_ENABLE */
                 .ServerPort = SNTP_SERVER_PORT,
         };/**< SNTP setup parameters */
 #endif /* HTTP_SECURE_ENABLE */
 
+#if DNS_CACHE_ENABLE
+static const DnsAgent_Host_T DnsHosts[] =
+        {
+                { DEST_SERVER_HOST, DEST_SERVER_FALLBACK_ADDRESS },
+#if HTTP_SECURE_ENABLE
+                { SNTP_SERVER_URL, SNTP_SERVER_FALLBACK_ADDRESS },
+#endif /* HTTP_SECURE_ENABLE */
+#if APP_LWM2M_ENABLE
+                { LWM2M_SERVER_HOST, NULL },
+#endif /* APP_LWM2M_ENABLE */
+        };/**< Servers resolved ahead of their first use */
+
+static const DnsAgent_Setup_T DnsAgentSetupInfo =
+        {
+                .Hosts = DnsHosts,
+                .HostCount = (uint8_t) (sizeof(DnsHosts) / sizeof(DnsHosts[0])),
+                .FileName = DNS_CACHE_FILE_NAME,
+                .RefreshPeriodMs = APP_DNS_REFRESH_PERIOD_MS,
+                .DefaultTtlS = APP_DNS_DEFAULT_TTL_S,
+                .MinTtlS = APP_DNS_MIN_TTL_S,
+                .MaxTtlS = APP_DNS_MAX_TTL_S,
+                .RefreshPercent = APP_DNS_REFRESH_PERCENT,
+                .RetryMs = APP_DNS_RETRY_MS,
+                .TimeoutMs = APP_DNS_TIMEOUT_MS,
+        };/**< DNS agent setup parameters */
+#endif /* DNS_CACHE_ENABLE */
+
 static HTTPRestClient_Setup_T HTTPRestClientSetupInfo =
         {
                 .IsSecure = HTTP_SECURE_ENABLE,
@@ -106,39 +268,252 @@ static HTTPRestClient_Config_T HTTPRestClientConfigInfo =
 
 static HTTPRestClient_Post_T HTTPRestClientPostInfo =
         {
-                .Payload = "{ \"AccelerometerX\": \"%f\","
-                		" \"AccelerometerY\": \"%f\","
-                		" \"AccelerometerZ\": \"%f\","
-                		" \"Acoustic\": \"%f\","
-                		" \"Digital_light\": \"%d\","
-                		" \"GyroscopeX\": \"%10d\","
-                		" \"GyroscopeY\": \"%10d\","
-                		" \"GyroscopeZ\": \"%10d\","
-                		" \"MagnetometerX\": \"%ld\","
-                		" \"MagnetometerY\": \"%ld\","
-                		" \"MagnetometerZ\": \"%ld\","
-                		" \"Pressure\": \"%ld\","
-                		" \"Temperature\": \"%ld\"}",
-						accelerometerXValue,
-						accelerometerYValue,
-						accelerometerZValue,
-						acousticValue,
-						lightValue,
-						gyroscopeXValue,
-						gyroscopeYValue,
-						gyroscopeZValue,
-						magnetometerXValue,
-						magnetometerYValue,
-						magnetometerZValue,
-						pressureValue,
-						temperatureValue,
-                .PayloadLength = (sizeof(POST_REQUEST_BODY) - 1U),
+                .Payload = NULL, /* Filled in by AppControllerPreparePayload */
+                .PayloadLength = 0UL,
                 .Url = DEST_POST_PATH,
         }; /**< HTTP rest client POST parameters */
 
+#if HTTPS_SESSION_ENABLE
+static const HttpsSession_Cipher_T HttpsCiphers[] = { HTTPS_CIPHER_PREFERENCE };
+
+static const HttpsAgent_Setup_T HttpsAgentSetupInfo =
+        {
+                .ServerHost = DEST_SERVER_HOST,
+                .ServerPort = HTTP_SECURE_ENABLE ? DEST_SERVER_PORT_SECURE : DEST_SERVER_PORT,
+                .IsSecure = HTTP_SECURE_ENABLE,
+                .CaFileName = HTTPS_CA_FILE_NAME,
+                .Ciphers = HttpsCiphers,
+                .CipherCount = (uint8_t) (sizeof(HttpsCiphers) / sizeof(HttpsCiphers[0])),
+                .MaxIdleMs = HTTPS_SESSION_MAX_IDLE_MS,
+                .TimeoutMs = APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT,
+#if DNS_CACHE_ENABLE
+                .Resolve = DnsAgent_Resolve,
+#endif /* DNS_CACHE_ENABLE */
+        };/**< HTTPS agent setup parameters */
+
+static HttpsSession_Request_T HttpsPostRequest =
+        {
+                .Method = "POST",
+                .Path = DEST_POST_PATH,
+                .ContentType = APP_UPLOAD_CONTENT_TYPE,
+                .ExtraHeaders = NULL,
+                .Body = NULL, /* The compressed batch, or WriteBody for a snapshot */
+                .BodyLength = 0UL,
+        };/**< POST through the HTTPS agent */
+
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+static HttpsSession_Response_T HttpsPostResponse =
+        {
+                .Body = NULL,
+                .BodySize = 0UL,
+        };/**< Status of the last POST, the body is discarded */
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+#endif /* HTTPS_SESSION_ENABLE */
+
+#if ((APP_UPLOAD_ENCODING != APP_UPLOAD_ENCODING_COMPRESSED) && !APP_UPLOAD_QUEUE_ENABLE)
+#if HTTPS_SESSION_ENABLE
+/**
+ * @brief Body of the next POST; both passes of the body writer see the same values and channels.
+ */
+struct AppControllerUploadBody_S
+{
+    SensorSnapshot_T Snapshot;
+    uint32_t ChannelMask; /**< APP_UPLOAD_CHANNELS when the snapshot was taken */
+};
+typedef struct AppControllerUploadBody_S AppControllerUploadBody_T;
+
+static AppControllerUploadBody_T UploadBody; /**< Values of the next POST, encoded straight into the buffer of the HTTPS session */
+#else
+static char PayloadBuffer[APP_PAYLOAD_BUFFER_SIZE]; /**< JSON or SensorSchema POST body */
+#endif /* HTTPS_SESSION_ENABLE */
+#endif /* (APP_UPLOAD_ENCODING != APP_UPLOAD_ENCODING_COMPRESSED) && !APP_UPLOAD_QUEUE_ENABLE */
+
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+static SensorSchema_T UploadSchema; /**< Channels of the POST body and whether the server knows them */
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+
+static uint8_t SampleBatchBuffers[2][APP_SAMPLE_BATCH_SIZE]; /**< Compressed sample batches, one filling and one uploading */
+
+static TimeSeriesCompressor_T SampleBatches[2]; /**< Compressor state of each batch */
+
+static volatile uint8_t ActiveSampleBatch = 0U; /**< Index of the batch the snapshot timer appends to */
+
+static uint32_t DroppedSamples = 0UL; /**< Samples lost because the active batch was full */
+
+#if APP_STORAGE_ENABLE
+static Storage_Setup_T StorageSetupInfo =
+        {
+                .SDCard = true,
+                .WiFiFileSystem = false,
+        };/**< Storage setup parameters */
+#endif /* APP_STORAGE_ENABLE */
+
+#if APP_SENSOR_TRACE_ENABLE
+static const SensorTraceAgent_Setup_T SensorTraceAgentSetupInfo =
+        {
+                .FileName = APP_SENSOR_TRACE_FILE_NAME,
+                .MaxBytes = APP_SENSOR_TRACE_MAX_BYTES,
+        };/**< Sensor trace agent setup parameters */
+#endif /* APP_SENSOR_TRACE_ENABLE */
+
+#if APP_DELTA_FOTA_ENABLE
+static const DeltaFotaAgent_Setup_T DeltaFotaAgentSetupInfo =
+        {
+                .Path = DELTA_FOTA_PATCH_PATH,
+                .FileName = DELTA_FOTA_FILE_NAME,
+                .StateFileName = DELTA_FOTA_STATE_FILE_NAME,
+                .PollIntervalMs = DELTA_FOTA_POLL_INTERVAL_MS,
+                .BlocksPerPoll = DELTA_FOTA_BLOCKS_PER_POLL,
+        };/**< Delta firmware update agent setup parameters */
+#endif /* APP_DELTA_FOTA_ENABLE */
+
+#if APP_UPLOAD_QUEUE_ENABLE
+/**
+ * @brief Record of an alert: a sensor read failed, or succeeded again.
+ */
+struct AppControllerAlert_S
+{
+    uint32_t Retcode; /**< Result of the read */
+    uint8_t Sensor; /**< SensorTable_Sensor_T */
+    uint8_t IsFailing;
+};
+typedef struct AppControllerAlert_S AppControllerAlert_T;
+
+static uint32_t UploadQueueAlerts[UPLOAD_QUEUE_CLASS_SIZE(UPLOAD_QUEUE_ALERTS, sizeof(AppControllerAlert_T)) / sizeof(uint32_t)];
+
+static uint32_t UploadQueueTelemetry[UPLOAD_QUEUE_CLASS_SIZE(UPLOAD_QUEUE_TELEMETRY_SAMPLES, sizeof(SensorSnapshot_T)) / sizeof(uint32_t)];
+
+static uint32_t UploadQueueBacklog[UPLOAD_QUEUE_CLASS_SIZE(UPLOAD_QUEUE_BACKLOG_SAMPLES, sizeof(SensorSnapshot_T)) / sizeof(uint32_t)];
+
+static uint32_t UploadQueueDiagnostics[UPLOAD_QUEUE_CLASS_SIZE(1UL, sizeof(UploadQueue_Statistics_T) * UPLOAD_QUEUE_CLASS_COUNT) / sizeof(uint32_t)];
+
+static const UploadQueue_ClassSetup_T UploadQueueSetupInfo[UPLOAD_QUEUE_CLASS_COUNT] =
+        {
+                [UPLOAD_QUEUE_CLASS_ALERT] = { UploadQueueAlerts, sizeof(UploadQueueAlerts), 0UL, (uint8_t) UPLOAD_QUEUE_ALERTS, UPLOAD_QUEUE_OVERFLOW_REJECT },
+                [UPLOAD_QUEUE_CLASS_TELEMETRY] = { UploadQueueTelemetry, sizeof(UploadQueueTelemetry), 0UL, UINT8_C(1), UPLOAD_QUEUE_OVERFLOW_DROP_OLDEST },
+                [UPLOAD_QUEUE_CLASS_BACKLOG] = { UploadQueueBacklog, sizeof(UploadQueueBacklog), UPLOAD_QUEUE_BACKLOG_BUDGET, UPLOAD_QUEUE_BACKLOG_BATCH, UPLOAD_QUEUE_OVERFLOW_DROP_OLDEST },
+                [UPLOAD_QUEUE_CLASS_DIAGNOSTICS] = { UploadQueueDiagnostics, sizeof(UploadQueueDiagnostics), 0UL, UINT8_C(1), UPLOAD_QUEUE_OVERFLOW_REPLACE },
+        };/**< Upload queue class setup parameters */
+
+static UploadQueue_T UploadQueue; /**< Outbound records; pushed from the sensor read hook and the AppController task, inside critical sections */
+
+/**
+ * @brief Body of the queue post in flight; both passes of the body writer see the same records and channels.
+ */
+struct AppControllerQueueBody_S
+{
+    UploadQueue_Batch_T Batch;
+    uint32_t ChannelMask; /**< APP_UPLOAD_CHANNELS at the peek */
+};
+typedef struct AppControllerQueueBody_S AppControllerQueueBody_T;
+
+static AppControllerQueueBody_T UploadQueueBody; /**< Records of the post in flight */
+
+static uint32_t FailingSensors = 0UL; /**< Bit per sensor whose last queued alert is a failure, written by the read hook only */
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+
+#if APP_SD_LOG_ENABLE
+static uint32_t SdLogOffset = 0UL; /**< Append position inside APP_SD_LOG_FILE_NAME */
+
+static bool SdLogOffsetKnown = false; /**< SdLogOffset was taken from the file, it is appended to */
+
+static SemaphoreHandle_t SdLogIdle = NULL; /**< Taken while a batch waits for the background lane, its buffer must not be refilled */
+
+static StaticRtos_Semaphore_T SdLogIdleStorage;
+#endif /* APP_SD_LOG_ENABLE */
+
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+/**
+ * @brief Content of APP_SD_BACKLOG_STATE_FILE_NAME.
+ */
+struct AppControllerBacklogState_S
+{
+    uint32_t Magic;
+    uint32_t PostedOffset; /**< Start of the log not posted yet */
+    uint32_t LogEnd; /**< End of the log when it was written, at a block boundary */
+    uint32_t Check; /**< Of the fields before, a torn write reads as no state */
+};
+typedef struct AppControllerBacklogState_S AppControllerBacklogState_T;
+
+static uint32_t SdBacklogOffset = 0UL; /**< Start of the log not posted yet */
+
+static uint32_t SdBacklogEnd = 0UL; /**< End of the log part of the current post */
+
+static AppControllerBacklogState_T SdBacklogState; /**< Last state written */
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
+
+#if APP_BLE_STREAM_ENABLE
+static SensorSnapshot_T BleSampleStorage[BLE_STREAM_RING_CAPACITY]; /**< Samples waiting for BLE */
+
+static SampleRing_T BleSampleRing; /**< Acquisition ring between the stream timer and the BLE task */
+
+static BleStreamAgent_Setup_T BleStreamAgentSetupInfo =
+        {
+                .DeviceName = BLE_DEVICE_NAME,
+                .Ring = &BleSampleRing,
+                .SampleRateHz = BLE_STREAM_SAMPLE_RATE_HZ,
+                .PayloadSize = BLE_STREAM_PAYLOAD_SIZE,
+                .ChannelMask = BLE_STREAM_CHANNEL_MASK,
+                .ConnectionIntervalMs = BLE_STREAM_CONNECTION_INTERVAL_MS,
+                .PacketsPerEvent = BLE_STREAM_PACKETS_PER_EVENT,
+                .MaxLatencyMs = BLE_STREAM_MAX_LATENCY_MS,
+                .StatisticsIntervalMs = UINT32_C(10000),
+        };/**< BLE stream agent setup parameters */
+#endif /* APP_BLE_STREAM_ENABLE */
+
+#if APP_LORA_ENABLE
+static LoRaAgent_Setup_T LoRaAgentSetupInfo =
+        {
+                .DevEUI = LORA_DEV_EUI,
+                .AppEUI = LORA_APP_EUI,
+                .AppKey = LORA_APP_KEY,
+                .Port = LORA_PORT,
+                .Snapshot = &LatestSnapshot,
+                .PollIntervalMs = UINT32_C(1000),
+                .StatisticsIntervalMs = UINT32_C(3600000),
+                .Scheduler =
+                        {
+                                .Region = LORA_REGION,
+                                .DataRate = LORA_DATA_RATE,
+                                .Format = LORA_PAYLOAD_FORMAT,
+                                .DutyCyclePermille = LORA_DUTY_CYCLE_PERMILLE,
+                                .DailyAirtimeBudgetMs = LORA_DAILY_AIRTIME_MS,
+                                .MinIntervalMs = LORA_MIN_INTERVAL_MS,
+                                .MaxIntervalMs = LORA_MAX_INTERVAL_MS,
+                                /* m/s2, deg/s, uT, degC, %RH, hPa, lux, dB */
+                                .Deadband = { 1.0f, 10.0f, 5.0f, 0.5f, 3.0f, 1.0f, 200.0f, 6.0f },
+                        },
+        };/**< LoRa agent setup parameters */
+#endif /* APP_LORA_ENABLE */
+
+#if APP_DECIMATION_ENABLE
+#define APP_DECIMATION_AXES             UINT8_C(3) /**< Accelerometer channels, X to Z */
+#define APP_DECIMATION_SNAPSHOT_STAGE   UINT8_C(1) /**< Stage whose output goes into the snapshots */
+
+static const DecimationFilter_Setup_T DecimationSetupInfo =
+        {
+                .InputBits = UINT8_C(19), /* mm/s2, 16 g */
+                .Stages = UINT8_C(2),
+                .Stage = { { 5U, 2U, 15U, 40U }, { 5U, 2U, 15U, 40U } },
+        };/**< Decimation setup parameters: 100 Hz to 10 Hz and 1 Hz, passband 0.2 Hz, aliases 61 dB down */
+
+static DecimationFilter_Bank_T DecimationBank; /**< Design shared by the axes */
+
+static DecimationFilter_Channel_T DecimationChannels[APP_DECIMATION_AXES];
+
+static int32_t DecimationInput[APP_DECIMATION_AXES][DECIMATION_BLOCK_LENGTH]; /**< Reads of the block being filled, mm/s2 */
+
+static int32_t DecimationOutputs[2][DECIMATION_FILTER_OUTPUT_LENGTH(DECIMATION_BLOCK_LENGTH, 10UL)]; /**< Outputs of a block per stage, sized for the 10 Hz one */
+
+static uint32_t DecimationFill = 0UL; /**< Reads in DecimationInput */
+
+static bool IsDecimationStarted = false; /**< The channels started at the first read */
+#endif /* APP_DECIMATION_ENABLE */
 
 static xTaskHandle AppControllerHandle = NULL; /**< OS thread handle for Application controller */
 
+STATIC_RTOS_TASK(AppControllerStorage, TASK_STACK_SIZE_APP_CONTROLLER);
+
 static CmdProcessor_T * AppCmdProcessor; /**< Handle to store the main Command processor handle to be reused by ServalPAL thread */
 
 /* --------------------------------------------------------------------------- |
@@ -160,6 +535,10 @@ static Retcode_T AppControllerValidateWLANConnectivity(void)
 
     if (WLANNWCT_IPSTATUS_CT_AQRD != nwStatus)
     {
+#if HTTPS_SESSION_ENABLE
+        /* The socket did not survive the disconnection */
+        HttpsAgent_Close();
+#endif /* HTTPS_SESSION_ENABLE */
 #if HTTP_SECURE_ENABLE
         static bool isSntpDisabled = false;
         if (false == isSntpDisabled)
@@ -184,379 +563,1836 @@ static Retcode_T AppControllerValidateWLANConnectivity(void)
 
 }
 
-static void readCalibratedAccelerometer(xTimerHandle xTimer)
+#if APP_DECIMATION_ENABLE
+/**
+ * @brief Read hook: passes the channels of a read on to the latest snapshot,
+ * the accelerometer through the decimation filters.
+ *
+ * Runs on the real-time lane. A failed read left the values of the previous
+ * one, which the filters take again so they keep their rate; the snapshot
+ * gets a new accelerometer value with every block which completes an output
+ * of APP_DECIMATION_SNAPSHOT_STAGE.
+ */
+static void AppControllerDecimate(SensorTable_Sensor_T sensor, Retcode_T retcode, const SensorTable_Value_T * values)
 {
-    (void) xTimer;
-
-    CalibratedAccel_Status_T calibrationAccuracy = CALIBRATED_ACCEL_UNRELIABLE;
-    Retcode_T calibrationStatus = RETCODE_FAILURE;
-
-    calibrationStatus = CalibratedAccel_getStatus(&calibrationAccuracy);
-
-    if (calibrationAccuracy == CALIBRATED_ACCEL_HIGH && calibrationStatus == RETCODE_OK){
-        Retcode_T returnDataValue = RETCODE_FAILURE;
-
-        /* Reading of the data of the calibrated accelerometer */
-        CalibratedAccel_XyzMps2Data_T getAccelMpsData = { INT32_C(0), INT32_C(0), INT32_C(0) };
-        returnDataValue = CalibratedAccel_readXyzMps2Value(&getAccelMpsData);
+    uint32_t channelMask = SensorTable_GetChannelMask((uint8_t) sensor);
+    int32_t * outputs[DECIMATION_FILTER_MAX_STAGES] = { DecimationOutputs[0], DecimationOutputs[1], NULL };
+    uint32_t counts[DECIMATION_FILTER_MAX_STAGES];
+    uint8_t channel;
+    uint8_t axis;
 
-        if (returnDataValue == RETCODE_OK){
-            printf("Calibrated acceleration: %10f m/s2[X] %10f m/s2[Y] %10f m/s2[Z]\n\r",
-                        (float) getAccelMpsData.xAxisData, (float) getAccelMpsData.yAxisData, (float) getAccelMpsData.zAxisData);
-            accelerometerXValue = (float) getAccelMpsData.xAxisData;
-            accelerometerYValue = (float) getAccelMpsData.yAxisData;
-            accelerometerZValue = (float) getAccelMpsData.zAxisData;
+    if (SENSOR_TABLE_SENSOR_ACCELEROMETER != sensor)
+    {
+        for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+        {
+            if (0UL != (channelMask & APP_CHANNEL_MASK(channel)))
+            {
+                LatestSnapshot.Values[channel] = values[channel];
+            }
+        }
+        return;
+    }
+    if ((RETCODE_OK != retcode) && !IsDecimationStarted)
+    {
+        return;
+    }
+    for (axis = 0U; axis < APP_DECIMATION_AXES; axis++)
+    {
+        channel = (uint8_t) SENSOR_TABLE_CHANNEL_ACCELEROMETER_X + axis;
+        DecimationInput[axis][DecimationFill] = (int32_t) lroundf(values[channel].Float * 1000.0f);
+        if (!IsDecimationStarted)
+        {
+            /* The outputs start at the first read instead of settling from 0 */
+            (void) DecimationFilter_Reset(&DecimationChannels[axis], &DecimationBank, DecimationInput[axis][DecimationFill]);
+            LatestSnapshot.Values[channel] = values[channel];
+        }
+    }
+    IsDecimationStarted = true;
+    DecimationFill++;
+    if (DecimationFill < DECIMATION_BLOCK_LENGTH)
+    {
+        return;
+    }
+    DecimationFill = 0UL;
+    for (axis = 0U; axis < APP_DECIMATION_AXES; axis++)
+    {
+        if (DecimationFilter_Process(&DecimationChannels[axis], DecimationInput[axis], DECIMATION_BLOCK_LENGTH, outputs, counts) &&
+                (0UL != counts[APP_DECIMATION_SNAPSHOT_STAGE]))
+        {
+            LatestSnapshot.Values[(uint8_t) SENSOR_TABLE_CHANNEL_ACCELEROMETER_X + axis].Float =
+                    (float) outputs[APP_DECIMATION_SNAPSHOT_STAGE][counts[APP_DECIMATION_SNAPSHOT_STAGE] - 1UL] / 1000.0f;
         }
     }
 }
+#endif /* APP_DECIMATION_ENABLE */
 
-float calcSoundPressure(float acousticRawValue){
-    return (acousticRawValue/aku340ConversionRatio);
-}
-
-static void readAcousticSensor(xTimerHandle xTimer)
+/**
+ * @brief Appends the latest snapshot to the active compressed sample batch.
+ *
+ * Runs in the timer service task, which the AppController task cannot preempt.
+ * The critical section only guards against the batch swap in AppControllerSwapSampleBatch.
+ */
+static void takeSnapshot(xTimerHandle xTimer)
 {
     (void) xTimer;
 
-    float acousticData;
+    TimeSeriesCompressor_T * batch;
+
+    LatestSnapshot.TimestampMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
 
-    if (RETCODE_OK == NoiseSensor_ReadRmsValue(&acousticData,10U)) {
-        printf("Sound pressure: %f \r\n", calcSoundPressure(acousticData));
-        acousticValue = calcSoundPressure(acousticData);
+    taskENTER_CRITICAL();
+    batch = &SampleBatches[ActiveSampleBatch];
+    if (!TimeSeriesCompressor_Append(batch, LatestSnapshot.TimestampMs, &LatestSnapshot.Values[0].Bits))
+    {
+        DroppedSamples++;
     }
+    taskEXIT_CRITICAL();
 }
 
-static void readEnvironmental(xTimerHandle xTimer)
+#if APP_BLE_STREAM_ENABLE
+/**
+ * @brief Pushes the latest snapshot into the BLE acquisition ring; a full ring counts a drop.
+ */
+static void streamSample(xTimerHandle xTimer)
 {
     (void) xTimer;
 
-    Retcode_T returnValue = RETCODE_FAILURE;
-
-    /* read and print BME280 environmental sensor data */
-
-    Environmental_Data_T bme280 = { INT32_C(0), UINT32_C(0), UINT32_C(0) };
-
-    returnValue = Environmental_readData(xdkEnvironmental_BME280_Handle, &bme280);
-
-    if ( RETCODE_OK == returnValue) {
-        printf("Environmental Data : p =%ld Pa T =%ld mDeg h =%ld %%rh\n\r",
-        (long int) bme280.pressure, (long int) bme280.temperature, (long int) bme280.humidity);
-        pressureValue = (long int) bme280.pressure;
-        temperatureValue = (long int) bme280.temperature;
-        humidityValue = (long int) bme280.humidity;
-    }
+    LatestSnapshot.TimestampMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    (void) SampleRing_Push(&BleSampleRing, &LatestSnapshot);
 }
+#endif /* APP_BLE_STREAM_ENABLE */
 
-static void readGyroscope(xTimerHandle xTimer)
+/**
+ * @brief Boot step: accelerometer. Sensor errors are reported but do not stop the boot.
+ */
+static Retcode_T AppControllerBootAccelerometer(void)
 {
-    (void) xTimer;
-
-    Retcode_T returnValue = RETCODE_FAILURE;
+    return SensorComponent_InitSensor(SENSOR_TABLE_SENSOR_ACCELEROMETER);
+}
 
-    Gyroscope_XyzData_T bmg160 = {INT32_C(0), INT32_C(0), INT32_C(0)};
+/**
+ * @brief Boot step: gyroscope.
+ */
+static Retcode_T AppControllerBootGyroscope(void)
+{
+    return SensorComponent_InitSensor(SENSOR_TABLE_SENSOR_GYROSCOPE);
+}
 
-        memset(&bmg160, 0, sizeof(CalibratedGyro_DpsData_T));
-        returnValue = Gyroscope_readXyzDegreeValue(xdkGyroscope_BMG160_Handle, &bmg160);
+/**
+ * @brief Boot step: magnetometer.
+ */
+static Retcode_T AppControllerBootMagnetometer(void)
+{
+    return SensorComponent_InitSensor(SENSOR_TABLE_SENSOR_MAGNETOMETER);
+}
 
-        if (RETCODE_OK == returnValue){
-            printf("Gyroscope Data: %10d mDeg[X] %10d mDeg[Y] %10d mDeg[Z]\n\r",
-                (int) bmg160.xAxisData, (int) bmg160.yAxisData, (int) bmg160.zAxisData);
-            gyroscopeXValue = (int) bmg160.xAxisData;
-            gyroscopeYValue = (int) bmg160.yAxisData;
-            gyroscopeZValue = (int) bmg160.zAxisData;
-        }
+/**
+ * @brief Boot step: environmental sensor.
+ */
+static Retcode_T AppControllerBootEnvironmental(void)
+{
+    return SensorComponent_InitSensor(SENSOR_TABLE_SENSOR_ENVIRONMENTAL);
 }
 
-static void readLightSensor(xTimerHandle xTimer)
+/**
+ * @brief Boot step: light sensor.
+ */
+static Retcode_T AppControllerBootLight(void)
 {
-    (void) xTimer;
+    return SensorComponent_InitSensor(SENSOR_TABLE_SENSOR_LIGHT);
+}
 
-    Retcode_T returnValue = RETCODE_FAILURE;
-    uint32_t max44009 = UINT32_C(0);
+/* --------------------------------------------------------------------------- |
+ * BOOTING- AND SETUP FUNCTIONS ********************************************** |
+ * -------------------------------------------------------------------------- */
 
-        returnValue = LightSensor_readLuxData(xdkLightSensor_MAX44009_Handle, &max44009);
+/**
+ * @brief Hands the active sample batch over to the caller and starts a fresh one.
+ *
+ * @return The completed batch; valid until the next call.
+ */
+static TimeSeriesCompressor_T * AppControllerSwapSampleBatch(void)
+{
+    TimeSeriesCompressor_T * completed;
+    uint8_t next;
+
+    taskENTER_CRITICAL();
+    completed = &SampleBatches[ActiveSampleBatch];
+    next = (uint8_t) (1U - ActiveSampleBatch);
+    (void) TimeSeriesCompressor_Init(&SampleBatches[next], SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK,
+            SampleBatchBuffers[next], APP_SAMPLE_BATCH_SIZE);
+    ActiveSampleBatch = next;
+    taskEXIT_CRITICAL();
+
+    return completed;
+}
 
-        if (RETCODE_OK == returnValue){
-            printf("Light sensor data :%d milli lux\n\r",(unsigned int) max44009);
-            lightValue = (unsigned int) max44009;
+#if APP_SD_LOG_ENABLE
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+/**
+ * @brief Steps over the complete blocks of the log from offset up to size.
+ *
+ * @return End of the last complete block; a block cut short by a reset ends the log before it.
+ */
+static uint32_t AppControllerSkipLogBlocks(uint32_t offset, uint32_t size)
+{
+    uint8_t lengthPrefix[2];
+    uint32_t bytesRead = 0UL;
+    uint32_t blockLength;
+    Storage_Read_T readCredentials =
+            {
+                    .FileName = APP_SD_LOG_FILE_NAME,
+                    .ReadBuffer = lengthPrefix,
+                    .BytesToRead = sizeof(lengthPrefix),
+                    .ActualBytesRead = &bytesRead,
+                    .Offset = 0UL,
+            };
+
+    while ((offset + sizeof(lengthPrefix)) <= size)
+    {
+        readCredentials.Offset = offset;
+        bytesRead = 0UL;
+        if ((RETCODE_OK != Storage_Read(STORAGE_MEDIUM_SD_CARD, &readCredentials)) || (sizeof(lengthPrefix) != bytesRead))
+        {
+            break;
+        }
+        blockLength = (uint32_t) lengthPrefix[0] | ((uint32_t) lengthPrefix[1] << 8);
+        if ((0UL == blockLength) || (blockLength > APP_SAMPLE_BATCH_SIZE) || ((offset + sizeof(lengthPrefix) + blockLength) > size))
+        {
+            break;
         }
+        offset += sizeof(lengthPrefix) + blockLength;
+    }
+    return offset;
 }
 
-static void readMagnetometer(xTimerHandle xTimer){
-
-    (void) xTimer;
-    Retcode_T returnValue = RETCODE_FAILURE;
-
-    /* read and print BMM150 magnetometer data */
-
-    Magnetometer_XyzData_T bmm150 = {INT32_C(0), INT32_C(0), INT32_C(0), INT32_C(0)};
-
-    returnValue = Magnetometer_readXyzTeslaData(xdkMagnetometer_BMM150_Handle, &bmm150);
+/**
+ * @brief Returns the FNV-1a hash of the fields of state before Check.
+ */
+static uint32_t AppControllerGetBacklogStateCheck(const AppControllerBacklogState_T * state)
+{
+    const uint32_t fields[] = { state->Magic, state->PostedOffset, state->LogEnd };
+    uint32_t check = UINT32_C(2166136261);
+    uint32_t index;
 
-    if (RETCODE_OK == returnValue) {
-    printf("Magnetic Data: x =%ld mT y =%ld mT z =%ld mT \n\r",
-          (long int) bmm150.xAxisData, (long int) bmm150.yAxisData, (long int) bmm150.zAxisData);
+    for (index = 0UL; index < (sizeof(fields) * 8UL); index += 8UL)
+    {
+        check ^= (fields[index / 32UL] >> (index % 32UL)) & UINT32_C(0xFF);
+        check *= UINT32_C(16777619);
     }
-    magnetometerXValue = (long int) bmm150.xAxisData;
-    magnetometerYValue = (long int) bmm150.yAxisData;
-    magnetometerZValue = (long int) bmm150.zAxisData;
+    return check;
 }
 
-static void initSensors(void)
+/**
+ * @brief Resumes the backlog from APP_SD_BACKLOG_STATE_FILE_NAME; SdLogOffset
+ * holds the size of the log.
+ */
+static void AppControllerLoadBacklogState(void)
 {
+    uint32_t bytesRead = 0UL;
+    uint32_t logSize = SdLogOffset;
+    Storage_Read_T readCredentials =
+            {
+                    .FileName = APP_SD_BACKLOG_STATE_FILE_NAME,
+                    .ReadBuffer = (uint8_t *) &SdBacklogState,
+                    .BytesToRead = sizeof(SdBacklogState),
+                    .ActualBytesRead = &bytesRead,
+                    .Offset = 0UL,
+            };
+
+    if ((RETCODE_OK != Storage_Read(STORAGE_MEDIUM_SD_CARD, &readCredentials)) || (sizeof(SdBacklogState) != bytesRead) ||
+            (APP_SD_BACKLOG_STATE_MAGIC != SdBacklogState.Magic) ||
+            (SdBacklogState.Check != AppControllerGetBacklogStateCheck(&SdBacklogState)) ||
+            (SdBacklogState.PostedOffset > SdBacklogState.LogEnd) || (SdBacklogState.LogEnd > logSize))
+    {
+        /* No state, or it belongs to another log: all of the log waits */
+        memset(&SdBacklogState, 0, sizeof(SdBacklogState));
+    }
+    SdBacklogOffset = SdBacklogState.PostedOffset;
+    SdLogOffset = AppControllerSkipLogBlocks(SdBacklogState.LogEnd, logSize);
+    SdBacklogEnd = SdLogOffset;
+    printf("AppControllerLoadBacklogState : %lu bytes of backlog from %lu \r\n", (unsigned long) (SdLogOffset - SdBacklogOffset),
+            (unsigned long) SdBacklogOffset);
+}
 
-	Retcode_T returnValue = RETCODE_FAILURE;
-
-	//Acoustic
-
-	//Accelerometer
-
-	Retcode_T calibratedAccelInitReturnValue = RETCODE_FAILURE;
-	calibratedAccelInitReturnValue = CalibratedAccel_init(xdkCalibratedAccelerometer_Handle);
-
-	if (calibratedAccelInitReturnValue != RETCODE_OK) {
-	    printf("Initializing Calibrated Accelerometer failed \n\r");
-	}
-
-	//Environmental
-
-	 Retcode_T returnOverSamplingValue = RETCODE_FAILURE;
-	 Retcode_T returnFilterValue = RETCODE_FAILURE;
-
-	 /* initialize environmental sensor */
-
-	 returnValue = Environmental_init(xdkEnvironmental_BME280_Handle);
-	 if ( RETCODE_OK != returnValue) {
-		 printf("BME280 Environmental Sensor initialization failed\n\r");
-	 }
-
-	 returnOverSamplingValue = Environmental_setOverSamplingPressure(xdkEnvironmental_BME280_Handle,ENVIRONMENTAL_BME280_OVERSAMP_2X);
-	 if (RETCODE_OK != returnOverSamplingValue) {
-	     printf("Configuring pressure oversampling failed \n\r");
-	 }
-
-	 returnFilterValue = Environmental_setFilterCoefficient(xdkEnvironmental_BME280_Handle,ENVIRONMENTAL_BME280_FILTER_COEFF_2);
-	 if (RETCODE_OK != returnFilterValue) {
-	     printf("Configuring pressure filter coefficient failed \n\r");
-	 }
-
-	//Gyroscope
-
-    Retcode_T returnBandwidthValue = RETCODE_FAILURE;
-    Retcode_T returnRangeValue = RETCODE_FAILURE;
+/**
+ * @brief Writes the posted position and the end of the log to APP_SD_BACKLOG_STATE_FILE_NAME.
+ */
+static void AppControllerSaveBacklogState(void)
+{
+    uint32_t bytesWritten = 0UL;
+    Storage_Write_T writeCredentials =
+            {
+                    .FileName = APP_SD_BACKLOG_STATE_FILE_NAME,
+                    .WriteBuffer = (uint8_t *) &SdBacklogState,
+                    .BytesToWrite = sizeof(SdBacklogState),
+                    .ActualBytesWritten = &bytesWritten,
+                    .Offset = 0UL,
+            };
+
+    SdBacklogState.Magic = APP_SD_BACKLOG_STATE_MAGIC;
+    SdBacklogState.PostedOffset = SdBacklogOffset;
+    SdBacklogState.LogEnd = SdLogOffset;
+    SdBacklogState.Check = AppControllerGetBacklogStateCheck(&SdBacklogState);
+    if (RETCODE_OK != Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials))
+    {
+        /* The posts go on; after a reset the backlog since the last written state is posted again */
+        printf("AppControllerSaveBacklogState : Writing %s failed \r\n", APP_SD_BACKLOG_STATE_FILE_NAME);
+    }
+}
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
 
-    returnValue = Gyroscope_init(xdkGyroscope_BMG160_Handle);
+/**
+ * @brief Takes SdLogOffset from the size of APP_SD_LOG_FILE_NAME, so the batches
+ * of this boot follow the ones of the earlier boots.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+static Retcode_T AppControllerFindLogEnd(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+    bool sdCardAvailable = false;
+    FILINFO fileInfo;
+    FRESULT fileResult;
 
-    if ( RETCODE_OK != returnValue) {
-        printf("BMG160 Gyroscope initialization failed\n\r");
+    retcode = Storage_IsAvailable(STORAGE_MEDIUM_SD_CARD, &sdCardAvailable);
+    if ((RETCODE_OK == retcode) && (false == sdCardAvailable))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_UNINITIALIZED);
     }
-    returnBandwidthValue = Gyroscope_setBandwidth(xdkGyroscope_BMG160_Handle, GYROSCOPE_BMG160_BANDWIDTH_116HZ);
-    if (RETCODE_OK != returnBandwidthValue) {
-        printf("Configuring bandwidth failed \n\r");
+    if (RETCODE_OK == retcode)
+    {
+        fileResult = f_stat(APP_SD_LOG_FILE_NAME, &fileInfo);
+        if (FR_OK == fileResult)
+        {
+            SdLogOffset = fileInfo.fsize;
+        }
+        else if (FR_NO_FILE == fileResult)
+        {
+            SdLogOffset = 0UL;
+        }
+        else
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
     }
-    returnRangeValue = Gyroscope_setRange(xdkGyroscope_BMG160_Handle, GYROSCOPE_BMG160_RANGE_500s);
-    if (RETCODE_OK != returnRangeValue) {
-        printf("Configuring range failed \n\r");
+    if (RETCODE_OK == retcode)
+    {
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+        AppControllerLoadBacklogState();
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
+        SdLogOffsetKnown = true;
+        printf("AppControllerFindLogEnd : Appending to %s at %lu \r\n", APP_SD_LOG_FILE_NAME, (unsigned long) SdLogOffset);
     }
+    return retcode;
+}
 
-    //Light
-
-    Retcode_T returnBrightnessValue = RETCODE_FAILURE;
-    Retcode_T returnIntegrationTimeValue = RETCODE_FAILURE;
-
-    returnValue = LightSensor_init(xdkLightSensor_MAX44009_Handle);
-
-    if ( RETCODE_OK != returnValue) {
-         printf("MAX44009 Light Sensor initialization failed\n\r");
-    }
-    returnBrightnessValue = LightSensor_setBrightness(xdkLightSensor_MAX44009_Handle,LIGHTSENSOR_NORMAL_BRIGHTNESS);
-    if (RETCODE_OK != returnBrightnessValue) {
-         printf("Configuring brightness failed \n\r");
+/**
+ * @brief Appends a compressed batch, prefixed by its 16 bit length, to APP_SD_LOG_FILE_NAME.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+static Retcode_T AppControllerLogSampleBatch(const uint8_t * block, uint32_t blockLength)
+{
+    Retcode_T retcode = RETCODE_OK;
+    bool sdCardAvailable = false;
+    uint8_t lengthPrefix[2] = { (uint8_t) (blockLength & 0xFFU), (uint8_t) (blockLength >> 8) };
+    uint32_t bytesWritten = 0UL;
+    Storage_Write_T writeCredentials =
+            {
+                    .FileName = APP_SD_LOG_FILE_NAME,
+                    .WriteBuffer = lengthPrefix,
+                    .BytesToWrite = sizeof(lengthPrefix),
+                    .ActualBytesWritten = &bytesWritten,
+                    .Offset = SdLogOffset,
+            };
+
+    retcode = Storage_IsAvailable(STORAGE_MEDIUM_SD_CARD, &sdCardAvailable);
+    if ((RETCODE_OK == retcode) && (false == sdCardAvailable))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_UNINITIALIZED);
     }
-    returnIntegrationTimeValue = LightSensor_setIntegrationTime(xdkLightSensor_MAX44009_Handle,LIGHTSENSOR_200MS);
-    if (RETCODE_OK != returnIntegrationTimeValue) {
-         printf("Configuring integration time failed \n\r");
+    if ((RETCODE_OK == retcode) && !SdLogOffsetKnown)
+    {
+        /* The card was missing at boot */
+        retcode = AppControllerFindLogEnd();
+        writeCredentials.Offset = SdLogOffset;
     }
-
-    //Magnetometer
-
-    Retcode_T returnDataRateValue = RETCODE_FAILURE;
-    Retcode_T returnPresetModeValue = RETCODE_FAILURE;
-
-    /* initialize magnetometer */
-
-    returnValue = Magnetometer_init(xdkMagnetometer_BMM150_Handle);
-
-    if(RETCODE_OK != returnValue){
-        printf("BMM150 Magnetometer initialization failed \n\r");
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials);
     }
-
-    returnDataRateValue = Magnetometer_setDataRate(xdkMagnetometer_BMM150_Handle,
-             MAGNETOMETER_BMM150_DATARATE_10HZ);
-    if (RETCODE_OK != returnDataRateValue) {
-    	printf("Configuring data rate failed \n\r");
+    if (RETCODE_OK == retcode)
+    {
+        writeCredentials.WriteBuffer = (uint8_t *) block;
+        writeCredentials.BytesToWrite = blockLength;
+        writeCredentials.Offset = SdLogOffset + sizeof(lengthPrefix);
+        retcode = Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials);
     }
-    returnPresetModeValue = Magnetometer_setPresetMode(xdkMagnetometer_BMM150_Handle,
-             MAGNETOMETER_BMM150_PRESETMODE_REGULAR);
-    if (RETCODE_OK != returnPresetModeValue) {
-    	printf("Configuring preset mode failed \n\r");
+    if (RETCODE_OK == retcode)
+    {
+        SdLogOffset += sizeof(lengthPrefix) + blockLength;
     }
+    return retcode;
 }
 
-/* --------------------------------------------------------------------------- |
- * BOOTING- AND SETUP FUNCTIONS ********************************************** |
- * -------------------------------------------------------------------------- */
-
 /**
- * @brief Responsible for controlling the HTTP Example application control flow.
+ * @brief Writes a compressed batch to the SD card on the background lane.
  *
- * - Synchronize the node with the SNTP server for time-stamp (if HTTPS)
- * - Check whether the WLAN network connection is available
- * - Do a HTTP rest client POST
- * - Wait for INTER_REQUEST_INTERVAL if POST was successful
- * - Redo the last 4 steps
+ * @param[in] param1
+ * Batch buffer
  *
- * @param[in] pvParameters
- * Unused
+ * @param[in] param2
+ * Batch length
  */
-static void AppControllerFire(void* pvParameters)
+static void AppControllerLogWork(void * param1, uint32_t param2)
 {
-    BCDS_UNUSED(pvParameters);
+    Retcode_T retcode = AppControllerLogSampleBatch((const uint8_t *) param1, param2);
 
-    Retcode_T retcode = RETCODE_OK;
+    if (RETCODE_OK != retcode)
+    {
+        printf("AppControllerLogWork : Logging to SD card failed \r\n");
+        Retcode_RaiseError(retcode);
+    }
+    (void) xSemaphoreGive(SdLogIdle);
+}
+#endif /* APP_SD_LOG_ENABLE */
 
-#if HTTP_SECURE_ENABLE
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+/**
+ * @brief Writes the log from SdBacklogOffset to SdBacklogEnd as POST body, read from
+ * the SD card straight into the buffer of the HTTPS session.
+ */
+static bool AppControllerWriteBacklog(void * context, PayloadWriter_T * writer)
+{
+    uint32_t offset = SdBacklogOffset;
+    uint32_t bytesRead = 0UL;
+    uint32_t room;
+    Storage_Read_T readCredentials =
+            {
+                    .FileName = APP_SD_LOG_FILE_NAME,
+                    .ReadBuffer = NULL,
+                    .BytesToRead = 0UL,
+                    .ActualBytesRead = &bytesRead,
+                    .Offset = 0UL,
+            };
 
-    uint64_t sntpTimeStampFromServer = 0UL;
+    BCDS_UNUSED(context);
 
-    /* We Synchronize the node with the SNTP server for time-stamp.
-     * Since there is no point in doing a HTTPS communication without a valid time */
-    do
+    while (offset < SdBacklogEnd)
     {
-        retcode = SNTP_GetTimeFromServer(&sntpTimeStampFromServer, APP_RESPONSE_FROM_SNTP_SERVER_TIMEOUT);
-        if ((RETCODE_OK != retcode) || (0UL == sntpTimeStampFromServer))
+        readCredentials.ReadBuffer = (uint8_t *) PayloadWriter_ReserveBulk(writer, &room);
+        if (NULL == readCredentials.ReadBuffer)
         {
-            printf("AppControllerFire : SNTP server time was not synchronized. Retrying...\r\n");
+            return false;
         }
-    } while (0UL == sntpTimeStampFromServer);
+        readCredentials.BytesToRead = ((SdBacklogEnd - offset) < room) ? (SdBacklogEnd - offset) : room;
+        readCredentials.Offset = offset;
+        bytesRead = 0UL;
+        if ((RETCODE_OK != Storage_Read(STORAGE_MEDIUM_SD_CARD, &readCredentials)) || (0UL == bytesRead))
+        {
+            printf("AppControllerWriteBacklog : Reading the SD card log failed at %lu \r\n", (unsigned long) offset);
+            return false;
+        }
+        PayloadWriter_Commit(writer, bytesRead);
+        offset += bytesRead;
+    }
+    return true;
+}
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
 
-    BCDS_UNUSED(sntpTimeStampFromServer); /* Copy of sntpTimeStampFromServer will be used be HTTPS for TLS handshake */
-#endif /* HTTP_SECURE_ENABLE */
+#if (HTTPS_SESSION_ENABLE && (APP_UPLOAD_ENCODING != APP_UPLOAD_ENCODING_COMPRESSED) && !APP_UPLOAD_QUEUE_ENABLE)
+/**
+ * @brief Writes the POST body of UploadBody, see HttpsSession_Request_T.
+ */
+static bool AppControllerWriteBody(void * context, PayloadWriter_T * writer)
+{
+    const AppControllerUploadBody_T * body = (const AppControllerUploadBody_T *) context;
+
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+    /* The channels are those of UploadSchema, set up in AppControllerPreparePayload */
+    return SensorSchema_WriteMessage(&UploadSchema, body->Snapshot.Values, writer);
+#else
+    return SensorTable_WriteJson(body->Snapshot.Values, body->ChannelMask, writer);
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+}
+#endif /* HTTPS_SESSION_ENABLE && (APP_UPLOAD_ENCODING != APP_UPLOAD_ENCODING_COMPRESSED) && !APP_UPLOAD_QUEUE_ENABLE */
+
+#if APP_UPLOAD_QUEUE_ENABLE
+/**
+ * @brief Formats at most PAYLOAD_WRITER_MAX_RESERVE - 1 characters into the POST body.
+ */
+static bool AppControllerWriteFormat(PayloadWriter_T * writer, const char * format, ...)
+{
+    char * room = PayloadWriter_Reserve(writer, PAYLOAD_WRITER_MAX_RESERVE);
+    va_list arguments;
+    int written;
+
+    if (NULL == room)
+    {
+        return false;
+    }
+    va_start(arguments, format);
+    written = vsnprintf(room, PAYLOAD_WRITER_MAX_RESERVE, format, arguments);
+    va_end(arguments);
+    if ((written < 0) || ((uint32_t) written >= PAYLOAD_WRITER_MAX_RESERVE))
+    {
+        return false;
+    }
+    PayloadWriter_Commit(writer, (uint32_t) written);
+    return true;
+}
+
+/**
+ * @brief Writes the diagnostics record: the queue statistics at the time of its push.
+ */
+static bool AppControllerWriteDiagnostics(const UploadQueue_Statistics_T * statistics, PayloadWriter_T * writer)
+{
+    static const char * const keys[] = { "depth", "bytes", "peak_bytes", "sent", "dropped", "demoted", "failures", "mean_latency_ms", "max_latency_ms" };
+    uint32_t values[sizeof(keys) / sizeof(keys[0])];
+    bool isOk = PayloadWriter_Write(writer, "{\"queue\":{", 10UL);
+    uint8_t queueClass;
+    uint8_t key;
+
+    for (queueClass = 0U; isOk && (queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT); queueClass++)
+    {
+        values[0] = statistics[queueClass].Depth;
+        values[1] = statistics[queueClass].DepthBytes;
+        values[2] = statistics[queueClass].PeakBytes;
+        values[3] = statistics[queueClass].Sent;
+        values[4] = statistics[queueClass].Dropped;
+        values[5] = statistics[queueClass].Demoted;
+        values[6] = statistics[queueClass].Failures;
+        values[7] = (0UL != statistics[queueClass].Sent) ? (statistics[queueClass].TotalLatencyMs / statistics[queueClass].Sent) : 0UL;
+        values[8] = statistics[queueClass].MaxLatencyMs;
+        isOk = AppControllerWriteFormat(writer, "%s\"%s\":", (0U != queueClass) ? "," : "", UploadQueue_GetClassName((UploadQueue_Class_T) queueClass));
+        for (key = 0U; isOk && (key < (uint8_t) (sizeof(keys) / sizeof(keys[0]))); key++)
+        {
+            isOk = AppControllerWriteFormat(writer, "%s\"%s\":%lu", (0U != key) ? "," : "{", keys[key], (unsigned long) values[key]);
+        }
+        isOk = isOk && PayloadWriter_Write(writer, "}", 1UL);
+    }
+    return isOk && PayloadWriter_Write(writer, "}}", 2UL);
+}
+
+/**
+ * @brief Writes the POST body of UploadQueueBody, see HttpsSession_Request_T.
+ *
+ * Telemetry is the snapshot object of the other upload modes, the other
+ * classes wrap their records: {"alerts":[...]}, {"backlog":[{"age_ms":..,"values":{..}},..]}
+ * and {"queue":{..}}. Ages are taken at the peek, so both passes write the same bytes.
+ */
+static bool AppControllerWriteQueueBody(void * context, PayloadWriter_T * writer)
+{
+    const AppControllerQueueBody_T * body = (const AppControllerQueueBody_T *) context;
+    const UploadQueue_Batch_T * batch = &body->Batch;
+    const AppControllerAlert_T * alert;
+    const void * record;
+    uint32_t length;
+    uint32_t ageMs;
+    uint8_t index;
+    bool isOk = true;
+
+    switch (batch->Class)
+    {
+    case UPLOAD_QUEUE_CLASS_ALERT:
+        isOk = PayloadWriter_Write(writer, "{\"alerts\":[", 11UL);
+        for (index = 0U; isOk && (index < batch->Count); index++)
+        {
+            alert = (const AppControllerAlert_T *) UploadQueue_GetRecord(&UploadQueue, batch, index, &length, &ageMs);
+            isOk = (NULL != alert) &&
+                    AppControllerWriteFormat(writer, "%s{\"sensor\":\"%s\",\"failing\":%s,", (0U != index) ? "," : "",
+                            SensorTable_GetSensorName(alert->Sensor), (0U != alert->IsFailing) ? "true" : "false") &&
+                    AppControllerWriteFormat(writer, "\"retcode\":\"0x%08lx\",\"age_ms\":%lu}", (unsigned long) alert->Retcode, (unsigned long) ageMs);
+        }
+        return isOk && PayloadWriter_Write(writer, "]}", 2UL);
+
+    case UPLOAD_QUEUE_CLASS_TELEMETRY:
+        record = UploadQueue_GetRecord(&UploadQueue, batch, 0U, &length, NULL);
+        return (NULL != record) && SensorTable_WriteJson(((const SensorSnapshot_T *) record)->Values, body->ChannelMask, writer);
+
+    case UPLOAD_QUEUE_CLASS_BACKLOG:
+        isOk = PayloadWriter_Write(writer, "{\"backlog\":[", 12UL);
+        for (index = 0U; isOk && (index < batch->Count); index++)
+        {
+            record = UploadQueue_GetRecord(&UploadQueue, batch, index, &length, &ageMs);
+            isOk = (NULL != record) &&
+                    AppControllerWriteFormat(writer, "%s{\"age_ms\":%lu,\"values\":", (0U != index) ? "," : "", (unsigned long) ageMs) &&
+                    SensorTable_WriteJson(((const SensorSnapshot_T *) record)->Values, body->ChannelMask, writer) &&
+                    PayloadWriter_Write(writer, "}", 1UL);
+        }
+        return isOk && PayloadWriter_Write(writer, "]}", 2UL);
+
+    case UPLOAD_QUEUE_CLASS_DIAGNOSTICS:
+        record = UploadQueue_GetRecord(&UploadQueue, batch, 0U, &length, NULL);
+        return (NULL != record) && AppControllerWriteDiagnostics((const UploadQueue_Statistics_T *) record, writer);
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Read hook of the sensor component: queues an alert when a sensor
+ * starts or stops failing, and wakes the AppController task to post it.
+ */
+static void AppControllerCheckSensor(SensorTable_Sensor_T sensor, Retcode_T retcode, const SensorTable_Value_T * values)
+{
+    AppControllerAlert_T alert;
+    bool isQueued;
+
+    BCDS_UNUSED(values);
+
+    alert.IsFailing = (RETCODE_OK != retcode) ? 1U : 0U;
+    if ((0UL != (FailingSensors & (1UL << (uint32_t) sensor))) == (0U != alert.IsFailing))
+    {
+        return;
+    }
+    alert.Retcode = (uint32_t) retcode;
+    alert.Sensor = (uint8_t) sensor;
+
+    taskENTER_CRITICAL();
+    isQueued = UploadQueue_Push(&UploadQueue, UPLOAD_QUEUE_CLASS_ALERT, &alert, sizeof(alert), (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS));
+    if (isQueued)
+    {
+        /* A full alert class rejects the push, the next read of the sensor tries again */
+        FailingSensors ^= (1UL << (uint32_t) sensor);
+    }
+    taskEXIT_CRITICAL();
+    if (isQueued && (NULL != AppControllerHandle))
+    {
+        (void) xTaskNotifyGive(AppControllerHandle);
+    }
+}
+
+/**
+ * @brief Posts the queued batches of the classes down to lowest, most important first.
+ *
+ * Stops at the first failed post, whose records stay queued for the next attempt.
+ *
+ * @return  RETCODE_OK if every batch due was posted, or the error of the failed post.
+ */
+static Retcode_T AppControllerPostQueue(UploadQueue_Class_T lowest)
+{
+    Retcode_T retcode = RETCODE_OK;
+    bool isDue;
+
+    HttpsPostRequest.WriteBody = AppControllerWriteQueueBody;
+    HttpsPostRequest.BodyContext = &UploadQueueBody;
+    while (RETCODE_OK == retcode)
+    {
+        taskENTER_CRITICAL();
+        isDue = UploadQueue_Peek(&UploadQueue, lowest, (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS), &UploadQueueBody.Batch);
+        UploadQueueBody.ChannelMask = APP_UPLOAD_CHANNELS;
+        taskEXIT_CRITICAL();
+        if (!isDue)
+        {
+            break;
+        }
+        /* The records in flight do not move, the body is written from them outside the critical section */
+        retcode = HttpsAgent_Request(&HttpsPostRequest, NULL);
+        taskENTER_CRITICAL();
+        UploadQueue_Complete(&UploadQueue, &UploadQueueBody.Batch, (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS), (RETCODE_OK == retcode));
+        taskEXIT_CRITICAL();
+    }
+    return retcode;
+}
+
+/**
+ * @brief Prints the queue statistics and queues them for the server.
+ */
+static void AppControllerReportQueue(void)
+{
+    UploadQueue_Statistics_T statistics[UPLOAD_QUEUE_CLASS_COUNT];
+    uint8_t queueClass;
+
+    taskENTER_CRITICAL();
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        statistics[queueClass] = *UploadQueue_GetStatistics(&UploadQueue, (UploadQueue_Class_T) queueClass);
+    }
+    (void) UploadQueue_Push(&UploadQueue, UPLOAD_QUEUE_CLASS_DIAGNOSTICS, statistics, sizeof(statistics), (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS));
+    taskEXIT_CRITICAL();
+
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        printf("UploadQueue : %s %lu waiting (%lu bytes, peak %lu), %lu sent, %lu dropped, %lu demoted, %lu failed posts, latency %lu ms mean %lu ms max \r\n",
+                UploadQueue_GetClassName((UploadQueue_Class_T) queueClass), (unsigned long) statistics[queueClass].Depth,
+                (unsigned long) statistics[queueClass].DepthBytes, (unsigned long) statistics[queueClass].PeakBytes,
+                (unsigned long) statistics[queueClass].Sent, (unsigned long) statistics[queueClass].Dropped,
+                (unsigned long) statistics[queueClass].Demoted, (unsigned long) statistics[queueClass].Failures,
+                (unsigned long) ((0UL != statistics[queueClass].Sent) ? (statistics[queueClass].TotalLatencyMs / statistics[queueClass].Sent) : 0UL),
+                (unsigned long) statistics[queueClass].MaxLatencyMs);
+    }
+}
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+
+/**
+ * @brief Waits waitMs between two uploads; with the upload queue the alerts
+ * queued meanwhile are posted as they come.
+ */
+static void AppControllerWait(uint32_t waitMs)
+{
+#if APP_UPLOAD_QUEUE_ENABLE
+    uint32_t startMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    uint32_t elapsedMs = 0UL;
+
+    while (elapsedMs < waitMs)
+    {
+        if (0UL != ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs - elapsedMs)))
+        {
+            (void) AppControllerPostQueue(UPLOAD_QUEUE_CLASS_ALERT);
+        }
+        elapsedMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS) - startMs;
+    }
+#else
+    vTaskDelay(pdMS_TO_TICKS(waitMs));
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+}
+
+/**
+ * @brief Completes the current sample batch, queued for the SD card log if enabled,
+ * and points the POST body at the configured encoding of the collected samples.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+static Retcode_T AppControllerPreparePayload(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+    TimeSeriesCompressor_T * batch;
+    uint32_t blockLength;
+#if (APP_POWER_POLICY_ENABLE && (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA))
+    uint32_t channelMask;
+#endif /* APP_POWER_POLICY_ENABLE && (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA) */
+#if ((APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA) && !HTTPS_SESSION_ENABLE)
+    PayloadWriter_T writer;
+#endif /* (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA) && !HTTPS_SESSION_ENABLE */
+
+#if APP_SD_LOG_ENABLE
+    /* The batch refilled next may still wait for the SD card */
+    if (NULL != SdLogIdle)
+    {
+        (void) xSemaphoreTake(SdLogIdle, portMAX_DELAY);
+    }
+#endif /* APP_SD_LOG_ENABLE */
+    batch = AppControllerSwapSampleBatch();
+    blockLength = TimeSeriesCompressor_Finish(batch);
+#if (APP_POWER_POLICY_ENABLE && (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA))
+    /* Other channels have another hash, the schema goes with the posts until the server accepted it */
+    channelMask = UploadChannelMask;
+    if ((channelMask != UploadSchema.ChannelMask) && !SensorSchema_Init(&UploadSchema, channelMask))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+#endif /* APP_POWER_POLICY_ENABLE && (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA) */
+
+#if APP_SD_LOG_ENABLE
+    if (NULL != SdLogIdle)
+    {
+        /* The SD card write does not delay the upload; AppControllerLogWork gives SdLogIdle back */
+        if ((0U == batch->SampleCount) ||
+                (RETCODE_OK != WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_BACKGROUND, AppControllerLogWork, batch->Buffer, blockLength)))
+        {
+            (void) xSemaphoreGive(SdLogIdle);
+        }
+    }
+#endif /* APP_SD_LOG_ENABLE */
+
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+    BCDS_UNUSED(blockLength);
+    /* Posted from the SD card, the batch has to be in the log first */
+    if (NULL != SdLogIdle)
+    {
+        (void) xSemaphoreTake(SdLogIdle, portMAX_DELAY);
+        (void) xSemaphoreGive(SdLogIdle);
+    }
+    SdBacklogEnd = SdLogOffset;
+    HttpsPostRequest.WriteBody = AppControllerWriteBacklog;
+    HttpsPostRequest.BodyContext = NULL;
+    HttpsPostRequest.IsChunked = true;
+#elif (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_COMPRESSED)
+    HTTPRestClientPostInfo.Payload = (const char *) batch->Buffer;
+    HTTPRestClientPostInfo.PayloadLength = blockLength;
+#elif APP_UPLOAD_QUEUE_ENABLE
+    BCDS_UNUSED(blockLength);
+    /* A full telemetry class moves its oldest samples to the backlog, a few KB of memmove at most */
+    taskENTER_CRITICAL();
+    (void) UploadQueue_Push(&UploadQueue, UPLOAD_QUEUE_CLASS_TELEMETRY, &LatestSnapshot, sizeof(LatestSnapshot), LatestSnapshot.TimestampMs);
+    UploadQueue_StartInterval(&UploadQueue);
+    taskEXIT_CRITICAL();
+#elif HTTPS_SESSION_ENABLE
+    BCDS_UNUSED(blockLength);
+    /* Both passes of the body writer have to see the same values and channels; the power policy changes them on the background lane */
+    taskENTER_CRITICAL();
+    UploadBody.Snapshot = LatestSnapshot;
+    UploadBody.ChannelMask = APP_UPLOAD_CHANNELS;
+    taskEXIT_CRITICAL();
+    HttpsPostRequest.WriteBody = AppControllerWriteBody;
+    HttpsPostRequest.BodyContext = &UploadBody;
+#elif (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+    BCDS_UNUSED(blockLength);
+    PayloadWriter_Init(&writer, (uint8_t *) PayloadBuffer, sizeof(PayloadBuffer), 0UL, NULL, NULL);
+    (void) SensorSchema_WriteMessage(&UploadSchema, LatestSnapshot.Values, &writer);
+    HTTPRestClientPostInfo.PayloadLength = PayloadWriter_Finish(&writer) ? writer.Length : 0UL;
+    HTTPRestClientPostInfo.Payload = PayloadBuffer;
+    if (0UL == HTTPRestClientPostInfo.PayloadLength)
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#else
+    BCDS_UNUSED(blockLength);
+    HTTPRestClientPostInfo.PayloadLength = SensorTable_ToJson(LatestSnapshot.Values, APP_UPLOAD_CHANNELS, PayloadBuffer, sizeof(PayloadBuffer));
+    HTTPRestClientPostInfo.Payload = PayloadBuffer;
+    if (0UL == HTTPRestClientPostInfo.PayloadLength)
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_COMPRESSED */
+
+    if (0UL != DroppedSamples)
+    {
+        printf("AppControllerPreparePayload : %lu samples dropped, batch full \r\n", (unsigned long) DroppedSamples);
+    }
+    return retcode;
+}
+
+#if APP_REMOTE_CONFIG_ENABLE
+
+static void AppControllerApplyConfig(const RemoteConfig_T * config, uint32_t changed);
+
+static const ConfigAgent_Setup_T ConfigAgentSetupInfo =
+        {
+                .Path = REMOTE_CONFIG_PATH,
+                .FileName = REMOTE_CONFIG_FILE_NAME,
+                .PollIntervalMs = REMOTE_CONFIG_POLL_INTERVAL_MS,
+                .ApplyCB = AppControllerApplyConfig,
+        };/**< Configuration agent setup parameters */
+
+/**
+ * @brief Returns the BMG160 range of a remote gyroscope range, the table setting for 0.
+ */
+static uint32_t AppControllerGetGyroscopeRange(uint16_t rangeDps)
+{
+    switch (rangeDps)
+    {
+    case 125U:
+        return (uint32_t) GYROSCOPE_BMG160_RANGE_125s;
+    case 250U:
+        return (uint32_t) GYROSCOPE_BMG160_RANGE_250s;
+    case 500U:
+        return (uint32_t) GYROSCOPE_BMG160_RANGE_500s;
+    case 1000U:
+        return (uint32_t) GYROSCOPE_BMG160_RANGE_1000s;
+    case 2000U:
+        return (uint32_t) GYROSCOPE_BMG160_RANGE_2000s;
+    default:
+        return SENSOR_COMPONENT_TABLE_SETTING;
+    }
+}
+
+#endif /* APP_REMOTE_CONFIG_ENABLE */
+
+#if (APP_REMOTE_CONFIG_ENABLE || APP_POWER_POLICY_ENABLE)
+
+/**
+ * @brief Returns the BMM150 data rate of a magnetometer rate in Hz, the table setting for 0.
+ */
+static uint32_t AppControllerGetMagnetometerRate(uint8_t rateHz)
+{
+    switch (rateHz)
+    {
+    case 2U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_2HZ;
+    case 6U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_6HZ;
+    case 8U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_8HZ;
+    case 10U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_10HZ;
+    case 15U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_15HZ;
+    case 20U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_20HZ;
+    case 25U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_25HZ;
+    case 30U:
+        return (uint32_t) MAGNETOMETER_BMM150_DATARATE_30HZ;
+    default:
+        return SENSOR_COMPONENT_TABLE_SETTING;
+    }
+}
+
+#endif /* APP_REMOTE_CONFIG_ENABLE || APP_POWER_POLICY_ENABLE */
+
+#if APP_REMOTE_CONFIG_ENABLE
+
+/**
+ * @brief Applies the changed settings of the remote configuration, in the AppController task.
+ *
+ * The timers keep running, xTimerChangePeriod restarts them at the new
+ * period; the sensor settings are written between two reads.
+ */
+static void AppControllerApplyConfig(const RemoteConfig_T * config, uint32_t changed)
+{
+    uint32_t periodMs;
+    uint8_t sensor;
+
+    if (0UL != (changed & REMOTE_CONFIG_CHANGED_SNAPSHOT))
+    {
+        periodMs = (0UL != config->SnapshotPeriodMs) ? config->SnapshotPeriodMs : APP_SNAPSHOT_PERIOD_MS;
+        (void) xTimerChangePeriod(snapshotHandle, pdMS_TO_TICKS(periodMs), UINT32_MAX);
+    }
+    if (0UL != (changed & REMOTE_CONFIG_CHANGED_UPLOAD))
+    {
+        UploadIntervalMs = (0UL != config->UploadIntervalMs) ? config->UploadIntervalMs : INTER_REQUEST_INTERVAL;
+    }
+    for (sensor = 0U; (0UL != (changed & REMOTE_CONFIG_CHANGED_SENSOR_PERIOD)) && (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT); sensor++)
+    {
+        if (NULL != SensorComponent_GetTimer((SensorTable_Sensor_T) sensor))
+        {
+            periodMs = (0UL != config->SensorPeriodsMs[sensor]) ? config->SensorPeriodsMs[sensor] : SensorTable_GetSensorPeriodMs(sensor);
+            (void) xTimerChangePeriod(SensorComponent_GetTimer((SensorTable_Sensor_T) sensor), pdMS_TO_TICKS(periodMs), UINT32_MAX);
+        }
+    }
+    if ((0UL != (changed & REMOTE_CONFIG_CHANGED_GYROSCOPE)) &&
+            (RETCODE_OK != SensorComponent_Configure(SENSOR_TABLE_SENSOR_GYROSCOPE, SENSOR_COMPONENT_TABLE_SETTING,
+                    AppControllerGetGyroscopeRange(config->GyroscopeRangeDps))))
+    {
+        printf("AppControllerApplyConfig : Gyroscope range not changed \r\n");
+    }
+    if ((0UL != (changed & REMOTE_CONFIG_CHANGED_MAGNETOMETER)) &&
+            (RETCODE_OK != SensorComponent_Configure(SENSOR_TABLE_SENSOR_MAGNETOMETER, AppControllerGetMagnetometerRate(config->MagnetometerRateHz),
+                    SENSOR_COMPONENT_TABLE_SETTING)))
+    {
+        printf("AppControllerApplyConfig : Magnetometer data rate not changed \r\n");
+    }
+    if (0UL != (changed & REMOTE_CONFIG_CHANGED_POST_PATH))
+    {
+        HttpsPostRequest.Path = ('\0' != config->PostPath[0]) ? config->PostPath : DEST_POST_PATH;
+    }
+}
+
+#endif /* APP_REMOTE_CONFIG_ENABLE */
+
+#if APP_POWER_POLICY_ENABLE
+
+static void AppControllerApplyPowerLevel(const PowerPolicy_Level_T * level);
+
+static const PowerPolicy_Level_T PowerLevels[] =
+        {
+                { "Normal", UINT16_C(0), UINT16_C(1), INTER_REQUEST_INTERVAL, SENSOR_TABLE_ALL_CHANNELS, UINT8_C(0) },
+                { "Saving", POWER_SAVING_ENTER_MV, POWER_SAVING_PERIOD_FACTOR, POWER_SAVING_UPLOAD_INTERVAL_MS, POWER_SAVING_CHANNEL_MASK,
+                        POWER_SAVING_MAGNETOMETER_HZ },
+                { "Low", POWER_LOW_ENTER_MV, POWER_LOW_PERIOD_FACTOR, POWER_LOW_UPLOAD_INTERVAL_MS, POWER_LOW_CHANNEL_MASK,
+                        POWER_LOW_MAGNETOMETER_HZ },
+                { "Critical", POWER_CRITICAL_ENTER_MV, POWER_CRITICAL_PERIOD_FACTOR, POWER_CRITICAL_UPLOAD_INTERVAL_MS, POWER_CRITICAL_CHANNEL_MASK,
+                        POWER_CRITICAL_MAGNETOMETER_HZ },
+        };/**< Power levels, see POWER_* */
+
+static const PowerPolicy_Setup_T PowerPolicySetupInfo =
+        {
+                .Levels = PowerLevels,
+                .LevelCount = (uint8_t) (sizeof(PowerLevels) / sizeof(PowerLevels[0])),
+                .HysteresisMv = POWER_HYSTERESIS_MV,
+                .MinDwellMs = POWER_MIN_DWELL_MS,
+                .FilterShift = POWER_FILTER_SHIFT,
+        };/**< Power policy setup parameters */
+
+static const PowerAgent_Setup_T PowerAgentSetupInfo =
+        {
+                .Policy = &PowerPolicySetupInfo,
+                .MeasurePeriodMs = POWER_MEASURE_PERIOD_MS,
+                .LevelChangedCB = AppControllerApplyPowerLevel,
+        };/**< Power agent setup parameters */
+
+/**
+ * @brief Applies a power level, on the background lane.
+ *
+ * Like AppControllerApplyConfig, xTimerChangePeriod restarts the running
+ * timers at the new period; a sensor without a channel of the level is
+ * stopped and keeps its last values. The upload task picks up the interval
+ * after its current wait and the channels with its next post.
+ */
+static void AppControllerApplyPowerLevel(const PowerPolicy_Level_T * level)
+{
+    xTimerHandle timer;
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        timer = SensorComponent_GetTimer((SensorTable_Sensor_T) sensor);
+        if (NULL == timer)
+        {
+            continue;
+        }
+        if (0UL == (level->ChannelMask & SensorTable_GetChannelMask(sensor)))
+        {
+            (void) xTimerStop(timer, UINT32_MAX);
+        }
+        else
+        {
+            (void) xTimerChangePeriod(timer, pdMS_TO_TICKS(SensorTable_GetSensorPeriodMs(sensor) * level->PeriodFactor), UINT32_MAX);
+        }
+    }
+    (void) xTimerChangePeriod(snapshotHandle, pdMS_TO_TICKS(APP_SNAPSHOT_PERIOD_MS * level->PeriodFactor), UINT32_MAX);
+    UploadIntervalMs = level->UploadIntervalMs;
+    UploadChannelMask = level->ChannelMask;
+    if (RETCODE_OK != SensorComponent_Configure(SENSOR_TABLE_SENSOR_MAGNETOMETER, AppControllerGetMagnetometerRate(level->MagnetometerRateHz),
+            SENSOR_COMPONENT_TABLE_SETTING))
+    {
+        printf("AppControllerApplyPowerLevel : Magnetometer data rate not changed \r\n");
+    }
+}
+
+/**
+ * @brief Boot step: battery monitor and the level of the first measurement.
+ */
+static Retcode_T AppControllerBootPower(void)
+{
+    Retcode_T retcode = PowerAgent_Setup(&PowerAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = PowerAgent_Enable();
+    }
+    return retcode;
+}
+
+#endif /* APP_POWER_POLICY_ENABLE */
+
+#if APP_THERMAL_ENABLE
+static const ThermalAgent_Setup_T ThermalAgentSetupInfo =
+        {
+                .I2cAddress = THERMAL_I2C_ADDRESS,
+                .FramePeriodMs = THERMAL_FRAME_PERIOD_MS,
+                .Mode = THERMAL_UPLOAD_MODE,
+                .Deadband = THERMAL_DEADBAND,
+                .KeyInterval = THERMAL_KEY_INTERVAL,
+                .Presence = { THERMAL_PRESENCE_THRESHOLD, THERMAL_PRESENCE_MIN_PIXELS, THERMAL_BACKGROUND_SHIFT },
+        };/**< Thermal agent setup parameters */
+
+#if HTTPS_SESSION_ENABLE
+static HttpsSession_Request_T ThermalPostRequest =
+        {
+                .Method = "POST",
+                .Path = THERMAL_POST_PATH,
+                .ContentType = "application/octet-stream",
+                .ExtraHeaders = NULL,
+                .Body = NULL, /* The batch of ThermalAgent_TakeBatch */
+                .BodyLength = 0UL,
+        };/**< POST of the thermal frames through the HTTPS agent */
+#else
+static HTTPRestClient_Post_T ThermalRestPostInfo =
+        {
+                .Payload = NULL, /* The batch of ThermalAgent_TakeBatch */
+                .PayloadLength = 0UL,
+                .Url = THERMAL_POST_PATH,
+        };/**< HTTP rest client POST of the thermal frames */
+#endif /* HTTPS_SESSION_ENABLE */
+
+/**
+ * @brief Posts the thermal frames captured since the last call.
+ *
+ * A batch whose post fails is lost, the next one starts with a key frame.
+ */
+static Retcode_T AppControllerPostThermal(void)
+{
+    const uint8_t * batch = NULL;
+    uint32_t length = ThermalAgent_TakeBatch(&batch);
+
+    if (0UL == length)
+    {
+        return RETCODE_OK;
+    }
+#if HTTPS_SESSION_ENABLE
+    ThermalPostRequest.Body = batch;
+    ThermalPostRequest.BodyLength = length;
+    return HttpsAgent_Request(&ThermalPostRequest, NULL);
+#else
+    ThermalRestPostInfo.Payload = (const char *) batch;
+    ThermalRestPostInfo.PayloadLength = length;
+    return HTTPRestClient_Post(&HTTPRestClientConfigInfo, &ThermalRestPostInfo, APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT);
+#endif /* HTTPS_SESSION_ENABLE */
+}
+
+/**
+ * @brief Boot step: thermal sensor on the extension port and its captures.
+ */
+static Retcode_T AppControllerBootThermal(void)
+{
+    Retcode_T retcode = ThermalAgent_Setup(&ThermalAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = ThermalAgent_Enable();
+    }
+    return retcode;
+}
+#endif /* APP_THERMAL_ENABLE */
+
+/**
+ * @brief Responsible for controlling the HTTP Example application control flow.
+ *
+ * - Check whether the WLAN network connection is available
+ * - Encode the samples collected since the last POST (and log them to SD card)
+ * - Do a HTTP rest client POST
+ * - Wait for INTER_REQUEST_INTERVAL if POST was successful
+ * - Redo the last 4 steps
+ *
+ * @param[in] pvParameters
+ * Unused
+ */
+static void AppControllerFire(void* pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    Retcode_T retcode = RETCODE_OK;
+    bool isFirstUpload = true;
+#if HTTPS_SESSION_ENABLE
+    uint32_t posts = 0UL;
+#endif /* HTTPS_SESSION_ENABLE */
 
     while (1)
     {
         /* Resetting / clearing the necessary buffers / variables for re-use */
         retcode = RETCODE_OK;
 
+#if (APP_SD_BACKLOG_UPLOAD_ENABLE || APP_UPLOAD_QUEUE_ENABLE)
+        /* The samples are kept during an outage too, the next posts send them with the rest of the backlog */
+        retcode = AppControllerPreparePayload();
+
+        if (RETCODE_OK == retcode)
+        {
+            retcode = AppControllerValidateWLANConnectivity();
+        }
+#else
         /* Check whether the WLAN network connection is available */
         retcode = AppControllerValidateWLANConnectivity();
 
+        if (RETCODE_OK == retcode)
+        {
+            retcode = AppControllerPreparePayload();
+        }
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE || APP_UPLOAD_QUEUE_ENABLE */
+
         /* Do a HTTP rest client POST */
         if (RETCODE_OK == retcode)
         {
+#if HTTPS_SESSION_ENABLE
+#if ((APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_COMPRESSED) && !APP_SD_BACKLOG_UPLOAD_ENABLE)
+            HttpsPostRequest.Body = (const uint8_t *) HTTPRestClientPostInfo.Payload;
+            HttpsPostRequest.BodyLength = HTTPRestClientPostInfo.PayloadLength;
+#endif /* (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_COMPRESSED) && !APP_SD_BACKLOG_UPLOAD_ENABLE */
+#if APP_UPLOAD_QUEUE_ENABLE
+            retcode = AppControllerPostQueue(UPLOAD_QUEUE_CLASS_DIAGNOSTICS);
+#elif (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+            retcode = HttpsAgent_Request(&HttpsPostRequest, &HttpsPostResponse);
+            if (SensorSchema_HandleStatus(&UploadSchema, HttpsPostResponse.Status))
+            {
+                /* The server lost the schema, e.g. in a restart: the same values once more, the schema attached */
+                retcode = HttpsAgent_Request(&HttpsPostRequest, &HttpsPostResponse);
+                (void) SensorSchema_HandleStatus(&UploadSchema, HttpsPostResponse.Status);
+            }
+#else
+            retcode = HttpsAgent_Request(&HttpsPostRequest, NULL);
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+#if APP_SD_BACKLOG_UPLOAD_ENABLE
+            if (RETCODE_OK == retcode)
+            {
+                if ((SdBacklogEnd - SdBacklogOffset) > (APP_SAMPLE_BATCH_SIZE + 2UL))
+                {
+                    printf("AppControllerFire : %lu bytes of backlog posted\r\n", (unsigned long) (SdBacklogEnd - SdBacklogOffset));
+                }
+                SdBacklogOffset = SdBacklogEnd;
+                AppControllerSaveBacklogState();
+            }
+#endif /* APP_SD_BACKLOG_UPLOAD_ENABLE */
+            if (0UL == (++posts % APP_HTTPS_REPORT_INTERVAL))
+            {
+                HttpsAgent_PrintReport();
+#if DNS_CACHE_ENABLE
+                DnsAgent_PrintReport();
+#endif /* DNS_CACHE_ENABLE */
+#if APP_UPLOAD_QUEUE_ENABLE
+                AppControllerReportQueue();
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+#if APP_POWER_POLICY_ENABLE
+                PowerAgent_PrintReport();
+#endif /* APP_POWER_POLICY_ENABLE */
+#if APP_THERMAL_ENABLE
+                ThermalAgent_PrintReport();
+#endif /* APP_THERMAL_ENABLE */
+            }
+#else
             retcode = HTTPRestClient_Post(&HTTPRestClientConfigInfo, &HTTPRestClientPostInfo, APP_RESPONSE_FROM_HTTP_SERVER_POST_TIMEOUT);
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+            /* The rest client hides the status: after a failed post the schema goes with the next one */
+            if (RETCODE_OK == retcode)
+            {
+                (void) SensorSchema_HandleStatus(&UploadSchema, UINT16_C(200));
+            }
+            else
+            {
+                SensorSchema_Reset(&UploadSchema);
+            }
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+#endif /* HTTPS_SESSION_ENABLE */
+        }
+#if APP_THERMAL_ENABLE
+        if (RETCODE_OK == retcode)
+        {
+            /* On the connection the post left open */
+            retcode = AppControllerPostThermal();
+        }
+#endif /* APP_THERMAL_ENABLE */
+#if APP_REMOTE_CONFIG_ENABLE
+        if (RETCODE_OK == retcode)
+        {
+            /* On the connection the post left open; a failed fetch keeps the settings in effect */
+            (void) ConfigAgent_Poll();
+        }
+#endif /* APP_REMOTE_CONFIG_ENABLE */
+#if APP_DELTA_FOTA_ENABLE
+        if (RETCODE_OK == retcode)
+        {
+            /* A failed block is fetched again after the next post */
+            (void) DeltaFotaAgent_Poll();
+        }
+#endif /* APP_DELTA_FOTA_ENABLE */
+        if ((RETCODE_OK == retcode) && isFirstUpload)
+        {
+            isFirstUpload = false;
+            printf("AppControllerFire : first upload %lu ms after power on\r\n", (unsigned long) (xTaskGetTickCount() * portTICK_PERIOD_MS));
         }
         if (RETCODE_OK == retcode)
         {
             /* Wait for INTER_REQUEST_INTERVAL */
-            vTaskDelay(pdMS_TO_TICKS(INTER_REQUEST_INTERVAL));
+            AppControllerWait(UploadIntervalMs);
         }
         if (RETCODE_OK != retcode)
         {
             printf("Error in Post/get request: Will trigger another post/get after INTER_REQUEST_INTERVAL\r\n");
-            vTaskDelay(pdMS_TO_TICKS(INTER_REQUEST_INTERVAL));
+            AppControllerWait(UploadIntervalMs);
             /* Report error and continue */
             Retcode_RaiseError(retcode);
         }
     }
 }
 
-static void AppControllerEnable(void * param1, uint32_t param2)
-{
-    BCDS_UNUSED(param1);
-    BCDS_UNUSED(param2);
+#if APP_LWM2M_ENABLE
 
-    uint32_t timerBlockTime = UINT32_MAX;
+static void AppControllerRetimeSensors(void);
 
-    xTimerStart(calibratedAccelerometerHandle,timerBlockTime);
-    xTimerStart(acousticHandle,timerBlockTime);
-    xTimerStart(environmentalHandle,timerBlockTime);
-    xTimerStart(gyroscopeHandle,timerBlockTime);
-    xTimerStart(lightSensorHandle,timerBlockTime);
-    xTimerStart(magnetometerHandle,timerBlockTime);
+static Lwm2mAgent_Setup_T Lwm2mAgentSetupInfo =
+        {
+                .ServerHost = LWM2M_SERVER_HOST,
+                .ServerPort = LWM2M_SERVER_PORT,
+                .EndpointName = LWM2M_ENDPOINT_NAME,
+                .LifetimeS = LWM2M_LIFETIME_S,
+                .DefaultSamplingMs = UINT32_C(1000),
+                .Snapshot = &LatestSnapshot,
+                .SamplingChangedCB = AppControllerRetimeSensors,
+#if DNS_CACHE_ENABLE
+                .Resolve = DnsAgent_Resolve,
+#endif /* DNS_CACHE_ENABLE */
+        };/**< LWM2M agent setup parameters */
 
-    Retcode_T retcode = WLAN_Enable();
-        if (RETCODE_OK == retcode)
+/**
+ * @brief Runs a sensor timer at the fastest period its observed channels need, stops it if none is observed.
+ */
+static void AppControllerRetimeSensor(xTimerHandle timer, uint32_t channelMask)
+{
+    uint32_t periodMs = 0UL;
+    uint32_t channelPeriodMs;
+    uint8_t channel;
+
+    for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        channelPeriodMs = (0UL != (channelMask & APP_CHANNEL_MASK(channel))) ? Lwm2mAgent_GetSamplingPeriodMs(channel) : 0UL;
+        if ((0UL != channelPeriodMs) && ((0UL == periodMs) || (channelPeriodMs < periodMs)))
         {
-            retcode = ServalPAL_Enable();
+            periodMs = channelPeriodMs;
         }
-    #if HTTP_SECURE_ENABLE
-        if (RETCODE_OK == retcode)
+    }
+    if (0UL == periodMs)
+    {
+        (void) xTimerStop(timer, UINT32_MAX);
+    }
+    else
+    {
+        /* xTimerChangePeriod also starts a dormant timer */
+        (void) xTimerChangePeriod(timer, pdMS_TO_TICKS(periodMs), UINT32_MAX);
+    }
+}
+
+static void AppControllerRetimeSensors(void)
+{
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if (NULL != SensorComponent_GetTimer((SensorTable_Sensor_T) sensor))
         {
-            retcode = SNTP_Enable();
+            AppControllerRetimeSensor(SensorComponent_GetTimer((SensorTable_Sensor_T) sensor), SensorTable_GetChannelMask(sensor));
         }
-    #endif /* HTTP_SECURE_ENABLE */
-        if (RETCODE_OK == retcode)
+    }
+}
+
+#endif /* APP_LWM2M_ENABLE */
+
+#if APP_WAKE_ON_EVENT_ENABLE
+
+static void AppControllerRetimeWake(void);
+
+static const WakePolicy_Setup_T WakePolicySetupInfo =
         {
-            retcode = HTTPRestClient_Enable();
-        }
-        if (RETCODE_OK == retcode)
+                .HeartbeatMs = WAKE_HEARTBEAT_MS,
+                .LightPollMs = WAKE_LIGHT_POLL_MS,
+                .ActivePeriodMs = WAKE_ACTIVE_PERIOD_MS,
+                .FastestPeriodMs = WAKE_FASTEST_PERIOD_MS,
+                .RampStepMs = WAKE_RAMP_STEP_MS,
+                .QuietMs = WAKE_QUIET_MS,
+                .MotionSensors = (UINT32_C(1) << SENSOR_TABLE_SENSOR_ACCELEROMETER) | (UINT32_C(1) << SENSOR_TABLE_SENSOR_GYROSCOPE),
+                .OnDemandSensors = (UINT32_C(1) << SENSOR_TABLE_SENSOR_ENVIRONMENTAL),
+                .LuxWindowPermille = WAKE_LUX_WINDOW_PERMILLE,
+                .LuxHysteresis = WAKE_LUX_HYSTERESIS_MLX,
+        };/**< Wake policy setup parameters */
+
+static const WakeAgent_Setup_T WakeAgentSetupInfo =
         {
-            if (pdPASS != xTaskCreate(AppControllerFire, (const char * const ) "AppController", TASK_STACK_SIZE_APP_CONTROLLER, NULL, TASK_PRIO_APP_CONTROLLER, &AppControllerHandle))
-            {
-                retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
-            }
-        }
-        if (RETCODE_OK != retcode)
+                .Policy = &WakePolicySetupInfo,
+                .SlopeThreshold = WAKE_SLOPE_THRESHOLD,
+                .SlopeDuration = WAKE_SLOPE_DURATION,
+                .PeriodsChangedCB = AppControllerRetimeWake,
+        };/**< Wake agent setup parameters */
+
+static uint32_t WakeTimerPeriodsMs[SENSOR_TABLE_SENSOR_COUNT + 1U]; /**< Period each sensor timer and, last, the snapshot timer runs at */
+
+/**
+ * @brief Changes the period of a timer if it differs; xTimerChangePeriod restarts the timer, so a heartbeat is not postponed by every change of the others.
+ */
+static void AppControllerRetimeWakeTimer(xTimerHandle timer, uint32_t * currentMs, uint32_t periodMs)
+{
+    if ((NULL != timer) && (0UL != periodMs) && (*currentMs != periodMs))
+    {
+        /* xTimerChangePeriod also starts a dormant timer */
+        (void) xTimerChangePeriod(timer, pdMS_TO_TICKS(periodMs), UINT32_MAX);
+        *currentMs = periodMs;
+    }
+}
+
+static void AppControllerRetimeWake(void)
+{
+    uint8_t sensor;
+
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        AppControllerRetimeWakeTimer(SensorComponent_GetTimer((SensorTable_Sensor_T) sensor), &WakeTimerPeriodsMs[sensor],
+                WakeAgent_GetPeriodMs((SensorTable_Sensor_T) sensor));
+    }
+    AppControllerRetimeWakeTimer(snapshotHandle, &WakeTimerPeriodsMs[SENSOR_TABLE_SENSOR_COUNT], WakeAgent_GetSnapshotPeriodMs());
+}
+
+/**
+ * @brief Boot step: motion interrupt, lux window and forced mode of the BME280.
+ */
+static Retcode_T AppControllerBootWake(void)
+{
+    return WakeAgent_Enable();
+}
+
+#endif /* APP_WAKE_ON_EVENT_ENABLE */
+
+/**
+ * @brief Boot step: sensor timers and sample buffers.
+ */
+static Retcode_T AppControllerBootTimers(void)
+{
+    uint32_t timerDelay = pdMS_TO_TICKS(APP_SNAPSHOT_PERIOD_MS);
+    uint32_t timerAutoReloadOn = UINT32_C(1);
+
+#if APP_DECIMATION_ENABLE
+    /* First hook, the others see the latest snapshot up to date */
+    if ((RETCODE_OK != SensorComponent_Setup(SensorReadValues)) || !DecimationFilter_Design(&DecimationBank, &DecimationSetupInfo) ||
+            (RETCODE_OK != SensorComponent_AddReadHook(AppControllerDecimate)))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#else
+    if (RETCODE_OK != SensorComponent_Setup(LatestSnapshot.Values))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#endif /* APP_DECIMATION_ENABLE */
+#if APP_UPLOAD_QUEUE_ENABLE
+    if (!UploadQueue_Init(&UploadQueue, UploadQueueSetupInfo, UPLOAD_QUEUE_RECENT_MS) ||
+            (RETCODE_OK != SensorComponent_AddReadHook(AppControllerCheckSensor)))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#endif /* APP_UPLOAD_QUEUE_ENABLE */
+    snapshotHandle = StaticRtos_CreateTimer(&snapshotStorage, "takeSnapshot", timerDelay, timerAutoReloadOn, NULL, takeSnapshot);
+#if APP_BLE_STREAM_ENABLE
+    bleStreamHandle = StaticRtos_CreateTimer(&bleStreamStorage, "streamSample", pdMS_TO_TICKS(1000UL / BLE_STREAM_SAMPLE_RATE_HZ), timerAutoReloadOn, NULL, streamSample);
+    (void) SampleRing_Init(&BleSampleRing, BleSampleStorage, BLE_STREAM_RING_CAPACITY);
+    if (NULL == bleStreamHandle)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#endif /* APP_BLE_STREAM_ENABLE */
+    (void) TimeSeriesCompressor_Init(&SampleBatches[ActiveSampleBatch], SENSOR_SNAPSHOT_CHANNEL_COUNT, SENSOR_SNAPSHOT_FLOAT_MASK,
+            SampleBatchBuffers[ActiveSampleBatch], APP_SAMPLE_BATCH_SIZE);
+    if (NULL == snapshotHandle)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+#if APP_WAKE_ON_EVENT_ENABLE
+    return WakeAgent_Setup(&WakeAgentSetupInfo);
+#else
+    return RETCODE_OK;
+#endif /* APP_WAKE_ON_EVENT_ENABLE */
+}
+
+/**
+ * @brief Boot step: starts sampling once every sensor is initialized.
+ */
+static Retcode_T AppControllerBootSampling(void)
+{
+    uint32_t timerBlockTime = UINT32_MAX;
+#if APP_BLE_STREAM_ENABLE
+    uint8_t sensor;
+#endif /* APP_BLE_STREAM_ENABLE */
+
+#if APP_LWM2M_ENABLE
+    /* Sensors run only while the LWM2M server observes them */
+    AppControllerRetimeSensors();
+#elif APP_WAKE_ON_EVENT_ENABLE
+    /* Sensors and snapshots start at the idle periods of the wake policy */
+    AppControllerRetimeWake();
+#else
+    (void) SensorComponent_Enable();
+#endif /* APP_LWM2M_ENABLE */
+#if APP_DECIMATION_ENABLE
+    if (NULL != SensorComponent_GetTimer(SENSOR_TABLE_SENSOR_ACCELEROMETER))
+    {
+        (void) xTimerChangePeriod(SensorComponent_GetTimer(SENSOR_TABLE_SENSOR_ACCELEROMETER), pdMS_TO_TICKS(DECIMATION_INPUT_PERIOD_MS), timerBlockTime);
+    }
+#endif /* APP_DECIMATION_ENABLE */
+    xTimerStart(snapshotHandle,timerBlockTime);
+#if APP_BLE_STREAM_ENABLE
+    /* The streamed sensors are read at the stream rate, xTimerChangePeriod also starts the timer */
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if ((0UL != (BLE_STREAM_CHANNEL_MASK & SensorTable_GetChannelMask(sensor))) &&
+                (NULL != SensorComponent_GetTimer((SensorTable_Sensor_T) sensor)))
         {
-            printf("AppControllerEnable : Failed \r\n");
-            Retcode_RaiseError(retcode);
-            assert(0); /* To provide LED indication for the user */
+            xTimerChangePeriod(SensorComponent_GetTimer((SensorTable_Sensor_T) sensor), pdMS_TO_TICKS(1000UL / BLE_STREAM_SAMPLE_RATE_HZ), timerBlockTime);
         }
+    }
+    xTimerStart(bleStreamHandle,timerBlockTime);
+#endif /* APP_BLE_STREAM_ENABLE */
+    return RETCODE_OK;
+}
 
-        Utils_PrintResetCause();
+#if APP_LORA_ENABLE
+
+/**
+ * @brief Boot step: LoRa radio and OTAA join.
+ */
+static Retcode_T AppControllerBootLoRa(void)
+{
+    Retcode_T retcode = LoRaAgent_Setup(&LoRaAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = LoRaAgent_Enable();
+    }
+    return retcode;
 }
 
-static void AppControllerSetup(void * param1, uint32_t param2)
+#else
+
+static Retcode_T AppControllerBootWlanSetup(void)
 {
-    BCDS_UNUSED(param1);
-    BCDS_UNUSED(param2);
+    return WLAN_Setup(&WLANSetupInfo);
+}
 
-    Retcode_T retcode = RETCODE_OK;
-    uint32_t timerDelay = UINT32_C(1000);
-    uint32_t timerAutoReloadOn = UINT32_C(1);
+static Retcode_T AppControllerBootServalPalSetup(void)
+{
+    return ServalPAL_Setup(AppCmdProcessor);
+}
 
-    // Setup of the necessary module
-    initSensors();
+/**
+ * @brief Boot step: connects to the access point, usually the longest step.
+ */
+static Retcode_T AppControllerBootWlanConnect(void)
+{
+    return WLAN_Enable();
+}
 
-    // Creation and start of the timer
-    calibratedAccelerometerHandle = xTimerCreate((const char *) "readCalibratedAccelerometer", timerDelay, timerAutoReloadOn, NULL, readCalibratedAccelerometer);
-    acousticHandle = xTimerCreate((const char *) "readAcousticSensor", timerDelay,timerAutoReloadOn, NULL, readAcousticSensor);
-    environmentalHandle = xTimerCreate((const char *) "readEnvironmental", timerDelay,timerAutoReloadOn, NULL, readEnvironmental);
-    gyroscopeHandle = xTimerCreate((const char *) "readGyroscope", timerDelay, timerAutoReloadOn, NULL, readGyroscope);
-    lightSensorHandle = xTimerCreate((const char *) "readAmbientLight", timerDelay, timerAutoReloadOn, NULL, readLightSensor);
-    magnetometerHandle = xTimerCreate((const char *) "readMagnetometer", timerDelay,timerAutoReloadOn, NULL, readMagnetometer);
-    retcode = CmdProcessor_Enqueue(AppCmdProcessor, AppControllerEnable, NULL, UINT32_C(0));
+static Retcode_T AppControllerBootServalPalEnable(void)
+{
+    return ServalPAL_Enable();
+}
 
-    retcode = WLAN_Setup(&WLANSetupInfo);
-        if (RETCODE_OK == retcode)
+#if DNS_CACHE_ENABLE
+/**
+ * @brief Boot step: resolves the servers ahead of their first use.
+ */
+static Retcode_T AppControllerBootDns(void)
+{
+    Retcode_T retcode = DnsAgent_Setup(&DnsAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = DnsAgent_Enable();
+    }
+    return retcode;
+}
+#endif /* DNS_CACHE_ENABLE */
+
+#if HTTP_SECURE_ENABLE
+/**
+ * @brief Boot step: synchronizes the node with the SNTP server for time-stamp.
+ *
+ * There is no point in doing a HTTPS communication without a valid time.
+ */
+static Retcode_T AppControllerBootSntp(void)
+{
+    uint64_t sntpTimeStampFromServer = 0UL;
+    Retcode_T retcode = SNTP_Setup(&SNTPSetupInfo);
+
+    if (RETCODE_OK == retcode)
+    {
+        retcode = SNTP_Enable();
+    }
+    while ((RETCODE_OK == retcode) && (0UL == sntpTimeStampFromServer))
+    {
+#if DNS_CACHE_ENABLE
+        /* The SNTP module resolves the server itself, its cached address needs no DNS request */
+        uint32_t sntpServerAddress;
+        if (RETCODE_OK == DnsAgent_Resolve(SNTP_SERVER_URL, &sntpServerAddress))
         {
-            retcode = ServalPAL_Setup(AppCmdProcessor);
+            DnsCache_FormatAddress(sntpServerAddress, SntpServerUrl);
         }
-    #if HTTP_SECURE_ENABLE
-        if (RETCODE_OK == retcode)
+#endif /* DNS_CACHE_ENABLE */
+        if ((RETCODE_OK != SNTP_GetTimeFromServer(&sntpTimeStampFromServer, APP_RESPONSE_FROM_SNTP_SERVER_TIMEOUT)) ||
+                (0UL == sntpTimeStampFromServer))
         {
-            retcode = SNTP_Setup(&SNTPSetupInfo);
+            printf("AppControllerBootSntp : SNTP server time was not synchronized. Retrying...\r\n");
         }
-    #endif /* HTTP_SECURE_ENABLE */
-        if (RETCODE_OK == retcode)
+    }
+    return retcode;
+}
+#endif /* HTTP_SECURE_ENABLE */
+
+static Retcode_T AppControllerBootHttpClient(void)
+{
+#if HTTPS_SESSION_ENABLE
+    BCDS_UNUSED(HTTPRestClientSetupInfo);
+    BCDS_UNUSED(HTTPRestClientConfigInfo);
+    return HttpsAgent_Setup(&HttpsAgentSetupInfo);
+#else
+    Retcode_T retcode = HTTPRestClient_Setup(&HTTPRestClientSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = HTTPRestClient_Enable();
+    }
+    return retcode;
+#endif /* HTTPS_SESSION_ENABLE */
+}
+
+#endif /* APP_LORA_ENABLE */
+
+#if APP_STORAGE_ENABLE
+static Retcode_T AppControllerBootStorage(void)
+{
+    Retcode_T retcode = Storage_Setup(&StorageSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Storage_Enable();
+    }
+#if APP_SD_LOG_ENABLE
+    if (RETCODE_OK == retcode)
+    {
+        SdLogIdle = StaticRtos_CreateCounting(&SdLogIdleStorage, "SdLogIdle", 1UL, 1UL);
+        if (NULL == SdLogIdle)
         {
-            retcode = HTTPRestClient_Setup(&HTTPRestClientSetupInfo);
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
         }
-        if (RETCODE_OK == retcode)
+    }
+    if (RETCODE_OK == retcode)
+    {
+        /* Without a card the first logged batch looks again */
+        (void) AppControllerFindLogEnd();
+    }
+#endif /* APP_SD_LOG_ENABLE */
+    return retcode;
+}
+#endif /* APP_STORAGE_ENABLE */
+
+#if APP_SENSOR_TRACE_ENABLE
+static Retcode_T AppControllerBootSensorTrace(void)
+{
+    Retcode_T retcode = SensorTraceAgent_Setup(&SensorTraceAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = SensorTraceAgent_Enable();
+    }
+    return retcode;
+}
+#endif /* APP_SENSOR_TRACE_ENABLE */
+
+#if APP_BLE_STREAM_ENABLE
+static Retcode_T AppControllerBootBleStream(void)
+{
+    Retcode_T retcode = BleStreamAgent_Setup(&BleStreamAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = BleStreamAgent_Enable();
+    }
+    return retcode;
+}
+#endif /* APP_BLE_STREAM_ENABLE */
+
+#if APP_LWM2M_ENABLE
+static Retcode_T AppControllerBootLwm2m(void)
+{
+    Retcode_T retcode = Lwm2mAgent_Setup(&Lwm2mAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Lwm2mAgent_Enable();
+    }
+    return retcode;
+}
+#elif !APP_LORA_ENABLE
+/**
+ * @brief Boot step: starts the HTTP upload task.
+ */
+static Retcode_T AppControllerBootUpload(void)
+{
+#if (APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA)
+    if (!SensorSchema_Init(&UploadSchema, APP_UPLOAD_CHANNELS))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+#endif /* APP_UPLOAD_ENCODING == APP_UPLOAD_ENCODING_SCHEMA */
+#if (APP_REMOTE_CONFIG_ENABLE || APP_DELTA_FOTA_ENABLE)
+    Retcode_T retcode = RETCODE_OK;
+#endif /* APP_REMOTE_CONFIG_ENABLE || APP_DELTA_FOTA_ENABLE */
+#if APP_REMOTE_CONFIG_ENABLE
+    /* The stored configuration applies before the first post */
+    retcode = ConfigAgent_Setup(&ConfigAgentSetupInfo);
+    if (RETCODE_OK != retcode)
+    {
+        return retcode;
+    }
+#endif /* APP_REMOTE_CONFIG_ENABLE */
+#if APP_DELTA_FOTA_ENABLE
+    /* An interrupted download resumes with the first poll */
+    retcode = DeltaFotaAgent_Setup(&DeltaFotaAgentSetupInfo);
+    if (RETCODE_OK != retcode)
+    {
+        return retcode;
+    }
+#endif /* APP_DELTA_FOTA_ENABLE */
+    AppControllerHandle = StaticRtos_CreateTask(&AppControllerStorage, AppControllerFire, "AppController", NULL, TASK_PRIO_APP_CONTROLLER);
+    if (NULL == AppControllerHandle)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    return RETCODE_OK;
+}
+#endif /* APP_LWM2M_ENABLE */
+
+#if APP_LIVE_VIEW_ENABLE
+static const LiveViewAgent_Setup_T LiveViewAgentSetupInfo =
         {
-            retcode = CmdProcessor_Enqueue(AppCmdProcessor, AppControllerEnable, NULL, UINT32_C(0));
-        }
+                .Port = LIVE_VIEW_PORT,
+                .MaxConnections = LIVE_VIEW_MAX_CONNECTIONS,
+                .IdleTimeoutMs = LIVE_VIEW_IDLE_TIMEOUT_MS,
+                .Snapshot = &LatestSnapshot,
+        };/**< Live view agent setup parameters */
+
+/**
+ * @brief Boot step: serves the live view on the WLAN.
+ */
+static Retcode_T AppControllerBootLiveView(void)
+{
+    Retcode_T retcode = LiveViewAgent_Setup(&LiveViewAgentSetupInfo);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = LiveViewAgent_Enable();
+    }
+    return retcode;
+}
+#endif /* APP_LIVE_VIEW_ENABLE */
+
+/**
+ * @brief Boot steps, see AppBootSteps for their dependencies.
+ */
+enum AppController_BootStep_E
+{
+    APP_BOOT_TIMERS = 0,
+    APP_BOOT_ACCELEROMETER,
+    APP_BOOT_GYROSCOPE,
+    APP_BOOT_MAGNETOMETER,
+    APP_BOOT_ENVIRONMENTAL,
+    APP_BOOT_LIGHT,
+    APP_BOOT_SAMPLING,
+#if APP_LORA_ENABLE
+    APP_BOOT_LORA,
+#else
+    APP_BOOT_WLAN_SETUP,
+    APP_BOOT_SERVALPAL_SETUP,
+    APP_BOOT_WLAN_CONNECT,
+    APP_BOOT_SERVALPAL_ENABLE,
+#if DNS_CACHE_ENABLE
+    APP_BOOT_DNS,
+#endif /* DNS_CACHE_ENABLE */
+#if HTTP_SECURE_ENABLE
+    APP_BOOT_SNTP,
+#endif /* HTTP_SECURE_ENABLE */
+    APP_BOOT_HTTP_CLIENT,
+#endif /* APP_LORA_ENABLE */
+#if APP_STORAGE_ENABLE
+    APP_BOOT_STORAGE,
+#endif /* APP_STORAGE_ENABLE */
+#if APP_SENSOR_TRACE_ENABLE
+    APP_BOOT_SENSOR_TRACE,
+#endif /* APP_SENSOR_TRACE_ENABLE */
+#if APP_BLE_STREAM_ENABLE
+    APP_BOOT_BLE_STREAM,
+#endif /* APP_BLE_STREAM_ENABLE */
+#if APP_WAKE_ON_EVENT_ENABLE
+    APP_BOOT_WAKE,
+#endif /* APP_WAKE_ON_EVENT_ENABLE */
+#if APP_LWM2M_ENABLE
+    APP_BOOT_LWM2M,
+#elif !APP_LORA_ENABLE
+    APP_BOOT_UPLOAD,
+#endif /* APP_LWM2M_ENABLE */
+#if APP_LIVE_VIEW_ENABLE
+    APP_BOOT_LIVE_VIEW,
+#endif /* APP_LIVE_VIEW_ENABLE */
+#if APP_POWER_POLICY_ENABLE
+    APP_BOOT_POWER,
+#endif /* APP_POWER_POLICY_ENABLE */
+#if APP_THERMAL_ENABLE
+    APP_BOOT_THERMAL,
+#endif /* APP_THERMAL_ENABLE */
+
+    APP_BOOT_STEP_COUNT
+};
+
+#define APP_BOOT_SENSORS        (BOOT_SEQUENCER_STEP(APP_BOOT_ACCELEROMETER) | BOOT_SEQUENCER_STEP(APP_BOOT_GYROSCOPE) | \
+        BOOT_SEQUENCER_STEP(APP_BOOT_MAGNETOMETER) | BOOT_SEQUENCER_STEP(APP_BOOT_ENVIRONMENTAL) | BOOT_SEQUENCER_STEP(APP_BOOT_LIGHT))
+
+#if DNS_CACHE_ENABLE
+#define APP_BOOT_NETWORK_READY  BOOT_SEQUENCER_STEP(APP_BOOT_DNS)
+#else
+#define APP_BOOT_NETWORK_READY  BOOT_SEQUENCER_STEP(APP_BOOT_SERVALPAL_ENABLE)
+#endif /* DNS_CACHE_ENABLE */
+
+#if HTTP_SECURE_ENABLE
+#define APP_BOOT_TIME_VALID     BOOT_SEQUENCER_STEP(APP_BOOT_SNTP)
+#else
+#define APP_BOOT_TIME_VALID     UINT32_C(0)
+#endif /* HTTP_SECURE_ENABLE */
+
+#if APP_SENSOR_TRACE_ENABLE
+#define APP_BOOT_TRACE_READY    BOOT_SEQUENCER_STEP(APP_BOOT_SENSOR_TRACE)
+#else
+#define APP_BOOT_TRACE_READY    UINT32_C(0)
+#endif /* APP_SENSOR_TRACE_ENABLE */
+
+#if APP_DELTA_FOTA_ENABLE
+#define APP_BOOT_FOTA_READY     BOOT_SEQUENCER_STEP(APP_BOOT_STORAGE)
+#else
+#define APP_BOOT_FOTA_READY     UINT32_C(0)
+#endif /* APP_DELTA_FOTA_ENABLE */
+
+/**
+ * The I2C sensors share one bus and are chained, the network is a chain of its
+ * own. Both chains start right away, so the sensors are sampled while WLAN
+ * connects and SNTP synchronizes.
+ */
+static const BootSequencer_Step_T AppBootSteps[APP_BOOT_STEP_COUNT] =
+        {
+                [APP_BOOT_TIMERS] = { "Timers", 0UL, AppControllerBootTimers },
+                [APP_BOOT_ACCELEROMETER] = { "Accelerometer", 0UL, AppControllerBootAccelerometer },
+                [APP_BOOT_GYROSCOPE] = { "Gyroscope", BOOT_SEQUENCER_STEP(APP_BOOT_ACCELEROMETER), AppControllerBootGyroscope },
+                [APP_BOOT_MAGNETOMETER] = { "Magnetometer", BOOT_SEQUENCER_STEP(APP_BOOT_GYROSCOPE), AppControllerBootMagnetometer },
+                [APP_BOOT_ENVIRONMENTAL] = { "Environmental", BOOT_SEQUENCER_STEP(APP_BOOT_MAGNETOMETER), AppControllerBootEnvironmental },
+                [APP_BOOT_LIGHT] = { "Light", BOOT_SEQUENCER_STEP(APP_BOOT_ENVIRONMENTAL), AppControllerBootLight },
+                [APP_BOOT_SAMPLING] = { "Sampling", BOOT_SEQUENCER_STEP(APP_BOOT_TIMERS) | APP_BOOT_SENSORS | APP_BOOT_TRACE_READY,
+                        AppControllerBootSampling },
+#if APP_LORA_ENABLE
+                [APP_BOOT_LORA] = { "LoRa", 0UL, AppControllerBootLoRa },
+#else
+                [APP_BOOT_WLAN_SETUP] = { "WlanSetup", 0UL, AppControllerBootWlanSetup },
+                [APP_BOOT_SERVALPAL_SETUP] = { "ServalPalSetup", BOOT_SEQUENCER_STEP(APP_BOOT_WLAN_SETUP), AppControllerBootServalPalSetup },
+                [APP_BOOT_WLAN_CONNECT] = { "WlanConnect", BOOT_SEQUENCER_STEP(APP_BOOT_SERVALPAL_SETUP), AppControllerBootWlanConnect },
+                [APP_BOOT_SERVALPAL_ENABLE] = { "ServalPalEnable", BOOT_SEQUENCER_STEP(APP_BOOT_WLAN_CONNECT), AppControllerBootServalPalEnable },
+#if DNS_CACHE_ENABLE
+                [APP_BOOT_DNS] = { "Dns", BOOT_SEQUENCER_STEP(APP_BOOT_SERVALPAL_ENABLE), AppControllerBootDns },
+#endif /* DNS_CACHE_ENABLE */
+#if HTTP_SECURE_ENABLE
+                [APP_BOOT_SNTP] = { "Sntp", APP_BOOT_NETWORK_READY, AppControllerBootSntp },
+#endif /* HTTP_SECURE_ENABLE */
+                [APP_BOOT_HTTP_CLIENT] = { "HttpClient", APP_BOOT_NETWORK_READY, AppControllerBootHttpClient },
+#endif /* APP_LORA_ENABLE */
+#if APP_STORAGE_ENABLE
+                [APP_BOOT_STORAGE] = { "Storage", 0UL, AppControllerBootStorage },
+#endif /* APP_STORAGE_ENABLE */
+#if APP_SENSOR_TRACE_ENABLE
+                [APP_BOOT_SENSOR_TRACE] = { "SensorTrace", BOOT_SEQUENCER_STEP(APP_BOOT_STORAGE), AppControllerBootSensorTrace },
+#endif /* APP_SENSOR_TRACE_ENABLE */
+#if APP_BLE_STREAM_ENABLE
+                [APP_BOOT_BLE_STREAM] = { "BleStream", BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING), AppControllerBootBleStream },
+#endif /* APP_BLE_STREAM_ENABLE */
+#if APP_WAKE_ON_EVENT_ENABLE
+                [APP_BOOT_WAKE] = { "Wake", BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING), AppControllerBootWake },
+#endif /* APP_WAKE_ON_EVENT_ENABLE */
+#if APP_LWM2M_ENABLE
+                [APP_BOOT_LWM2M] = { "Lwm2m", APP_BOOT_NETWORK_READY | BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING), AppControllerBootLwm2m },
+#elif !APP_LORA_ENABLE
+                [APP_BOOT_UPLOAD] = { "Upload", BOOT_SEQUENCER_STEP(APP_BOOT_HTTP_CLIENT) | APP_BOOT_TIME_VALID |
+                        BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING) | APP_BOOT_FOTA_READY, AppControllerBootUpload },
+#endif /* APP_LWM2M_ENABLE */
+#if APP_LIVE_VIEW_ENABLE
+                [APP_BOOT_LIVE_VIEW] = { "LiveView", APP_BOOT_NETWORK_READY | BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING), AppControllerBootLiveView },
+#endif /* APP_LIVE_VIEW_ENABLE */
+#if APP_POWER_POLICY_ENABLE
+                [APP_BOOT_POWER] = { "Power", BOOT_SEQUENCER_STEP(APP_BOOT_SAMPLING), AppControllerBootPower },
+#endif /* APP_POWER_POLICY_ENABLE */
+#if APP_THERMAL_ENABLE
+                [APP_BOOT_THERMAL] = { "Thermal", 0UL, AppControllerBootThermal },
+#endif /* APP_THERMAL_ENABLE */
+        };
+
+/**
+ * @brief Called by the boot sequencer once every step ran.
+ */
+static void AppControllerBootDone(Retcode_T retcode)
+{
+    if (RETCODE_OK != retcode)
+    {
+        printf("AppControllerEnable : Failed \r\n");
+        Retcode_RaiseError(retcode);
+        assert(0); /* To provide LED indication for the user */
+    }
+
+    StaticRtos_PrintReport();
+    WorkDispatcher_PrintReport();
+#if DNS_CACHE_ENABLE
+    DnsAgent_PrintReport();
+#endif /* DNS_CACHE_ENABLE */
+    Utils_PrintResetCause();
+}
+
+static void AppControllerSetup(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    Retcode_T retcode = BootSequencer_Start(AppBootSteps, APP_BOOT_STEP_COUNT, APP_BOOT_WORKERS, AppControllerBootDone);
 
     if (RETCODE_OK != retcode)
     {
@@ -580,7 +2416,7 @@ void AppController_Init(void * cmdProcessorHandle, uint32_t param2)
     else
     {
         AppCmdProcessor = (CmdProcessor_T *) cmdProcessorHandle;
-        retcode = CmdProcessor_Enqueue(AppCmdProcessor, AppControllerSetup, NULL, UINT32_C(0));
+        retcode = WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AppControllerSetup, NULL, UINT32_C(0));
     }
     if (RETCODE_OK != retcode)
     {
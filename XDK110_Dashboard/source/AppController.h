@@ -126,6 +126,70 @@
 
 #endif /* #if HTTP_SECURE_ENABLE */
 
+/**
+ * HTTPS_SESSION_ENABLE is set to post through HttpsAgent instead of the HTTP rest
+ * client. HttpsAgent keeps the connection open between posts, so only the first
+ * post and posts after the server closed the connection pay a TLS handshake.
+ */
+#define HTTPS_SESSION_ENABLE            UINT32_C(0)
+
+/**
+ * HTTPS_SESSION_MAX_IDLE_MS is the idle time after which a new connection is
+ * opened instead of reusing the last one. It has to stay below the keep-alive
+ * timeout of the server (KeepAliveTimeout of Apache, 5 s by default), or a post
+ * goes out on a connection the server already closed and is sent twice.
+ * With a stock server and INTER_REQUEST_INTERVAL every post connects anew:
+ * keep-alive only saves handshakes once KeepAliveTimeout of the server is
+ * raised above INTER_REQUEST_INTERVAL and this limit between the two, e.g.
+ * 15000 for a KeepAliveTimeout of 20 s.
+ */
+#define HTTPS_SESSION_MAX_IDLE_MS       UINT32_C(4000)
+
+/**
+ * HTTPS_CA_FILE_NAME is the CA certificate of the server in the file system of
+ * the WLAN chip (DER), uploaded once e.g. with WLANHostPgm. NULL skips the
+ * verification of the server, for tests only.
+ */
+#define HTTPS_CA_FILE_NAME              "/cert/server_ca.der"
+
+/**
+ * HTTPS_CIPHER_PREFERENCE lists the offered TLS cipher suites, most preferred
+ * first. ECDHE-ECDSA with an ECDSA P-256 server certificate is the cheapest
+ * handshake; the ECDHE-RSA suites remain for servers with an RSA certificate.
+ * Tools/TlsHandshakeBench measures a server with a given list.
+ */
+#define HTTPS_CIPHER_PREFERENCE         HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_GCM_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES128_CBC_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_ECDSA_AES256_CBC_SHA, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_GCM_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES128_CBC_SHA256, \
+                                        HTTPS_SESSION_CIPHER_ECDHE_RSA_AES256_CBC_SHA
+
+/**
+ * DNS_CACHE_ENABLE is set to resolve the servers through DnsAgent. The servers
+ * are resolved once the WLAN is connected and again in the background before
+ * their DNS records expire, so a new connection or SNTP request does not wait
+ * for the DNS server, and still gets the last address when the DNS server is
+ * down. The HTTP rest client resolves DEST_SERVER_HOST itself, the cache
+ * serves the uploads with HTTPS_SESSION_ENABLE only.
+ */
+#define DNS_CACHE_ENABLE                UINT32_C(0)
+
+/**
+ * DEST_SERVER_FALLBACK_ADDRESS and SNTP_SERVER_FALLBACK_ADDRESS are dotted IPv4
+ * addresses used while the server cannot be resolved and no address of an
+ * earlier run is stored in DNS_CACHE_FILE_NAME, "" for none.
+ */
+#define DEST_SERVER_FALLBACK_ADDRESS    ""
+#define SNTP_SERVER_FALLBACK_ADDRESS    ""
+
+/**
+ * DNS_CACHE_FILE_NAME is the file of the WLAN chip keeping the last good
+ * address of every server across restarts. It is only written when an address
+ * changed.
+ */
+#define DNS_CACHE_FILE_NAME             "/usr/dnscache.bin"
+
 /**
  * The maximum amount of data we download in a single request (in bytes). This number is
  * limited by the platform abstraction layer implementation that ships with the
@@ -133,6 +197,604 @@
  */
 #define REQUEST_MAX_DOWNLOAD_SIZE       UINT32_C(512)
 
+/* Upload and logging configurations ***************************************** */
+
+/**
+ * Possible values of APP_UPLOAD_ENCODING.
+ * - APP_UPLOAD_ENCODING_JSON posts the latest snapshot as a JSON object.
+ * - APP_UPLOAD_ENCODING_COMPRESSED posts every sample taken since the last post
+ *   as one TimeSeriesCompressor block (see Tools/TimeSeriesBench for the decoder).
+ * - APP_UPLOAD_ENCODING_SCHEMA posts the latest snapshot as a SensorSchema
+ *   message: the schema hash and the packed values, the channel keys only
+ *   until the server accepted them once (see Tools/SchemaBench).
+ */
+#define APP_UPLOAD_ENCODING_JSON        UINT32_C(0)
+#define APP_UPLOAD_ENCODING_COMPRESSED  UINT32_C(1)
+#define APP_UPLOAD_ENCODING_SCHEMA      UINT32_C(2)
+
+/**
+ * APP_UPLOAD_ENCODING selects the body format of the HTTP POST request.
+ */
+#define APP_UPLOAD_ENCODING             APP_UPLOAD_ENCODING_JSON
+
+/**
+ * APP_SAMPLE_BATCH_SIZE is the size in bytes of one compressed sample batch.
+ * Two batches are allocated: one is filled while the other one is uploaded.
+ */
+#define APP_SAMPLE_BATCH_SIZE           UINT32_C(512)
+
+/**
+ * APP_PAYLOAD_BUFFER_SIZE is the size in bytes of the JSON or SensorSchema POST body buffer.
+ * Unused with HTTPS_SESSION_ENABLE, which writes the body straight into the
+ * buffer of the session.
+ */
+#define APP_PAYLOAD_BUFFER_SIZE         UINT32_C(512)
+
+/**
+ * APP_SD_LOG_ENABLE is set to append every compressed sample batch to the SD card.
+ */
+#define APP_SD_LOG_ENABLE               UINT32_C(0)
+
+/**
+ * APP_SD_LOG_FILE_NAME is the SD card file the compressed batches are appended to.
+ * Every batch is prefixed with its length as a 16 bit little endian value.
+ * The file is kept over resets, every boot appends after its end.
+ */
+#define APP_SD_LOG_FILE_NAME            "SAMPLES.TSC"
+
+/**
+ * APP_SD_BACKLOG_UPLOAD_ENABLE is set to post from the APP_SD_LOG_FILE_NAME log
+ * instead of the batch in RAM. Every batch is logged, during a WLAN outage
+ * too, and each post streams all batches logged since the last successful
+ * one with chunked transfer encoding, read from the SD card straight into the
+ * buffer of the HTTPS session: a backlog of any size uploads with constant
+ * RAM. The body has the format of the log (see Tools/BacklogUpload).
+ * The position of the last successful post is kept on the SD card, so a reset
+ * during an outage resumes the backlog where it stopped.
+ * Needs APP_SD_LOG_ENABLE, HTTPS_SESSION_ENABLE and APP_UPLOAD_ENCODING_COMPRESSED.
+ */
+#define APP_SD_BACKLOG_UPLOAD_ENABLE    UINT32_C(0)
+
+/**
+ * APP_SD_BACKLOG_STATE_FILE_NAME is the SD card file of the posted position and
+ * the end of the log, written after every successful post.
+ */
+#define APP_SD_BACKLOG_STATE_FILE_NAME  "BACKLOG.STA"
+
+/**
+ * APP_SENSOR_TRACE_ENABLE is set to record every sensor read, failed ones
+ * included, to APP_SENSOR_TRACE_FILE_NAME on the SD card (SensorTraceAgent).
+ * Tools/SensorTraceReplay replays the file through the sampling and encoding
+ * of this application on the host.
+ */
+#define APP_SENSOR_TRACE_ENABLE         UINT32_C(0)
+
+/**
+ * APP_SENSOR_TRACE_FILE_NAME is the SD card file of the trace, rewritten at every boot.
+ */
+#define APP_SENSOR_TRACE_FILE_NAME      "SENSORS.TRC"
+
+/**
+ * APP_SENSOR_TRACE_MAX_BYTES is the size at which the recording stops, 0 for no limit.
+ */
+#define APP_SENSOR_TRACE_MAX_BYTES      UINT32_C(0)
+
+/* Remote configuration ****************************************************** */
+
+/**
+ * APP_REMOTE_CONFIG_ENABLE is set to fetch a RemoteConfig document from the
+ * upload server every REMOTE_CONFIG_POLL_INTERVAL_MS (ConfigAgent): the
+ * snapshot period, INTER_REQUEST_INTERVAL, the sensor periods, the gyroscope
+ * range, the magnetometer data rate and DEST_POST_PATH change at runtime,
+ * without reflashing. The last valid document is kept in
+ * REMOTE_CONFIG_FILE_NAME and applied at boot. The host and port stay the
+ * built in ones, a bad document must not cut the device off its server.
+ * Tools/ConfigServer serves a document for tests. Needs HTTPS_SESSION_ENABLE;
+ * it retimes the sensors, so it cannot be combined with
+ * APP_WAKE_ON_EVENT_ENABLE, APP_LWM2M_ENABLE or APP_BLE_STREAM_ENABLE.
+ */
+#define APP_REMOTE_CONFIG_ENABLE        UINT32_C(0)
+
+/**
+ * REMOTE_CONFIG_PATH is the path of the document on DEST_SERVER_HOST.
+ */
+#define REMOTE_CONFIG_PATH              "/~ex0eby/xdk.cfg"
+
+/**
+ * REMOTE_CONFIG_POLL_INTERVAL_MS is the time between two fetches of the
+ * document; an unchanged document costs a 304 answer without body.
+ */
+#define REMOTE_CONFIG_POLL_INTERVAL_MS  UINT32_C(300000)
+
+/**
+ * REMOTE_CONFIG_FILE_NAME is the file of the WLAN chip keeping the last valid
+ * document and its ETag. It is only written when the document changed.
+ */
+#define REMOTE_CONFIG_FILE_NAME         "/usr/remoteconfig.cfg"
+
+/* Delta firmware update ***************************************************** */
+
+/**
+ * APP_DELTA_FOTA_ENABLE is set to update the firmware from a DeltaPatch on
+ * the upload server (DeltaFotaAgent): a patch for the running image is
+ * downloaded in resumable blocks and applied on the fly to
+ * DELTA_FOTA_FILE_NAME on the SD card, which the XDK FOTA then flashes.
+ * Tools/FotaDelta creates the patch from the old and the new
+ * XDK110_Dashboard.bin; the server must answer Range requests. Needs
+ * HTTPS_SESSION_ENABLE and an SD card.
+ */
+#define APP_DELTA_FOTA_ENABLE           UINT32_C(0)
+
+/**
+ * DELTA_FOTA_PATCH_PATH is the path of the patch on DEST_SERVER_HOST.
+ */
+#define DELTA_FOTA_PATCH_PATH           "/~ex0eby/XDK110_Dashboard.xdp"
+
+/**
+ * DELTA_FOTA_POLL_INTERVAL_MS is the time between two checks for a patch,
+ * each a Range request for its 24 byte header.
+ */
+#define DELTA_FOTA_POLL_INTERVAL_MS     UINT32_C(3600000)
+
+/**
+ * DELTA_FOTA_BLOCKS_PER_POLL is the number of 1 KB patch blocks fetched
+ * after a post; the download goes on after the next posts.
+ */
+#define DELTA_FOTA_BLOCKS_PER_POLL      UINT32_C(16)
+
+/**
+ * DELTA_FOTA_FILE_NAME is the SD card file of the new image, the one the XDK
+ * FOTA looks for.
+ */
+#define DELTA_FOTA_FILE_NAME            "firmware.bin"
+
+/**
+ * DELTA_FOTA_STATE_FILE_NAME is the SD card file of the download position and
+ * decoder state.
+ */
+#define DELTA_FOTA_STATE_FILE_NAME      "FOTA.STA"
+
+/* Upload priority queue ***************************************************** */
+
+/**
+ * APP_UPLOAD_QUEUE_ENABLE is set to post through a priority queue
+ * (UploadQueue) instead of one snapshot per interval: sensor failure alerts
+ * are posted within moments and ahead of everything else, then the latest
+ * telemetry, then telemetry the link could not take in time (the backlog,
+ * aggregated into one post per UPLOAD_QUEUE_BACKLOG_BATCH samples), then the
+ * queue diagnostics. Every class has a fixed buffer; on a degraded link the
+ * backlog sheds its oldest samples, alerts keep their room. Needs
+ * HTTPS_SESSION_ENABLE and APP_UPLOAD_ENCODING_JSON, it replaces
+ * APP_SD_BACKLOG_UPLOAD_ENABLE.
+ */
+#define APP_UPLOAD_QUEUE_ENABLE         UINT32_C(0)
+
+/**
+ * UPLOAD_QUEUE_ALERTS is the number of alerts held while the link is down;
+ * later ones are dropped until they are posted.
+ */
+#define UPLOAD_QUEUE_ALERTS             UINT32_C(8)
+
+/**
+ * UPLOAD_QUEUE_TELEMETRY_SAMPLES is the number of recent samples held; older
+ * ones move to the backlog.
+ */
+#define UPLOAD_QUEUE_TELEMETRY_SAMPLES  UINT32_C(4)
+
+/**
+ * UPLOAD_QUEUE_BACKLOG_SAMPLES is the number of samples the backlog holds,
+ * about 70 bytes of RAM each.
+ */
+#define UPLOAD_QUEUE_BACKLOG_SAMPLES    UINT32_C(48)
+
+/**
+ * UPLOAD_QUEUE_RECENT_MS is the age at which a sample not posted yet moves
+ * from the telemetry to the backlog.
+ */
+#define UPLOAD_QUEUE_RECENT_MS          UINT32_C(30000)
+
+/**
+ * UPLOAD_QUEUE_BACKLOG_BATCH is the number of backlog samples per post.
+ */
+#define UPLOAD_QUEUE_BACKLOG_BATCH      UINT8_C(12)
+
+/**
+ * UPLOAD_QUEUE_BACKLOG_BUDGET is the number of backlog sample bytes (60 per
+ * sample) posted per upload interval, so a long backlog does not hold up the
+ * next telemetry on a slow link. 0 posts the whole backlog at once.
+ */
+#define UPLOAD_QUEUE_BACKLOG_BUDGET     UINT32_C(2048)
+
+/* Live view on the local network ******************************************** */
+
+/**
+ * APP_LIVE_VIEW_ENABLE is set to serve the latest snapshot and the last
+ * LIVE_VIEW_AGENT_HISTORY_LENGTH snapshots as JSON over HTTP on the WLAN
+ * (LiveViewAgent), e.g. http://<device>/latest and /history, for a local
+ * dashboard that does not go through the server. A response is rendered once
+ * per snapshot and served from RAM until the next one. Tools/LiveViewServer
+ * serves the same view on the host and load-tests it. Needs the WLAN, it
+ * cannot be combined with APP_LORA_ENABLE.
+ */
+#define APP_LIVE_VIEW_ENABLE            UINT32_C(0)
+
+/**
+ * LIVE_VIEW_PORT is the TCP port of the live view.
+ */
+#define LIVE_VIEW_PORT                  UINT16_C(80)
+
+/**
+ * LIVE_VIEW_MAX_CONNECTIONS is the number of clients served at a time, up to
+ * LIVE_VIEW_AGENT_MAX_CONNECTIONS; further ones get a 503. Every connection
+ * takes a socket of the WLAN chip, which has 8 for all of the application.
+ */
+#define LIVE_VIEW_MAX_CONNECTIONS       UINT8_C(2)
+
+/**
+ * LIVE_VIEW_IDLE_TIMEOUT_MS is the time after which a connection without a
+ * request is closed, so an idle browser tab does not hold a slot.
+ */
+#define LIVE_VIEW_IDLE_TIMEOUT_MS       UINT32_C(5000)
+
+/* Accelerometer decimation ************************************************** */
+
+/**
+ * APP_DECIMATION_ENABLE is set to read the accelerometer every
+ * DECIMATION_INPUT_PERIOD_MS and to pass its channels through anti-aliasing
+ * decimation filters (DecimationFilter) to 10 Hz and 1 Hz, instead of
+ * sampling whatever the last read saw. The snapshots carry the 1 Hz output,
+ * about 4.7 s late; the read hooks, e.g. the sensor trace, still see every
+ * read. Tools/DecimationBench verifies the response of the filters on the
+ * host. The accelerometer runs at a fixed period, so it cannot be combined
+ * with APP_WAKE_ON_EVENT_ENABLE, APP_LWM2M_ENABLE, APP_BLE_STREAM_ENABLE or
+ * APP_REMOTE_CONFIG_ENABLE; SENSOR_COMPONENT_PRINT_ENABLE must be 0.
+ */
+#define APP_DECIMATION_ENABLE           UINT32_C(0)
+
+/**
+ * DECIMATION_INPUT_PERIOD_MS is the accelerometer read period; the filter
+ * stages decimate by 10 each, so 10 ms gives the 1 Hz of the snapshots.
+ */
+#define DECIMATION_INPUT_PERIOD_MS      UINT32_C(10)
+
+/**
+ * DECIMATION_BLOCK_LENGTH is the number of reads filtered at once. A multiple
+ * of 10 delivers a 10 Hz output with every block.
+ */
+#define DECIMATION_BLOCK_LENGTH         UINT32_C(20)
+
+/* Battery aware sampling **************************************************** */
+
+/**
+ * APP_POWER_POLICY_ENABLE is set to adapt sampling and uploads to the battery
+ * voltage (PowerAgent): below POWER_SAVING_ENTER_MV, POWER_LOW_ENTER_MV and
+ * POWER_CRITICAL_ENTER_MV the sensors and snapshots run POWER_<level>_PERIOD_FACTOR
+ * times slower, posts are POWER_<level>_UPLOAD_INTERVAL_MS apart, the
+ * magnetometer runs at POWER_<level>_MAGNETOMETER_HZ and only the channels of
+ * POWER_<level>_CHANNEL_MASK (bit n for SensorSnapshot channel n) are read and
+ * posted; a sensor without one of them is stopped. The JSON and schema bodies leave the other channels out, a
+ * compressed batch repeats their last value, which costs next to nothing.
+ * Every transition is printed. Tools/PowerPolicySim estimates the runtime of a
+ * charge with and without the policy. The policy retimes the sensors and
+ * posts over HTTP, so it cannot be combined with APP_WAKE_ON_EVENT_ENABLE,
+ * APP_LWM2M_ENABLE, APP_BLE_STREAM_ENABLE, APP_LORA_ENABLE,
+ * APP_REMOTE_CONFIG_ENABLE or APP_DECIMATION_ENABLE.
+ */
+#define APP_POWER_POLICY_ENABLE                 UINT32_C(0)
+
+/**
+ * POWER_MEASURE_PERIOD_MS is the time between two battery measurements.
+ */
+#define POWER_MEASURE_PERIOD_MS                 UINT32_C(60000)
+
+/**
+ * POWER_FILTER_SHIFT sets the weight of a measurement in the average to
+ * 1 / 2^POWER_FILTER_SHIFT, so the dip of a post does not change the level.
+ */
+#define POWER_FILTER_SHIFT                      UINT8_C(2)
+
+/**
+ * POWER_HYSTERESIS_MV is the rise above the threshold of a level before it is
+ * left, POWER_MIN_DWELL_MS the shortest time between two transitions.
+ */
+#define POWER_HYSTERESIS_MV                     UINT16_C(100)
+#define POWER_MIN_DWELL_MS                      UINT32_C(600000)
+
+/**
+ * Saving level, from about 40 % of the charge of the XDK battery: no gyroscope
+ * reads, the other sensors every 5 s, a post per minute.
+ */
+#define POWER_SAVING_ENTER_MV                   UINT16_C(3790)
+#define POWER_SAVING_PERIOD_FACTOR              UINT16_C(5)
+#define POWER_SAVING_UPLOAD_INTERVAL_MS         UINT32_C(60000)
+#define POWER_SAVING_CHANNEL_MASK               UINT32_C(0x3F1F)
+#define POWER_SAVING_MAGNETOMETER_HZ            UINT8_C(6)
+
+/**
+ * Low level, from about 20 %: accelerometer, light and environmental sensor
+ * every 30 s, a post every 5 minutes.
+ */
+#define POWER_LOW_ENTER_MV                      UINT16_C(3720)
+#define POWER_LOW_PERIOD_FACTOR                 UINT16_C(30)
+#define POWER_LOW_UPLOAD_INTERVAL_MS            UINT32_C(300000)
+#define POWER_LOW_CHANNEL_MASK                  UINT32_C(0x3117)
+#define POWER_LOW_MAGNETOMETER_HZ               UINT8_C(2)
+
+/**
+ * Critical level, from about 10 %: the environmental sensor every 5 minutes,
+ * a post every 30 minutes.
+ */
+#define POWER_CRITICAL_ENTER_MV                 UINT16_C(3650)
+#define POWER_CRITICAL_PERIOD_FACTOR            UINT16_C(300)
+#define POWER_CRITICAL_UPLOAD_INTERVAL_MS       UINT32_C(1800000)
+#define POWER_CRITICAL_CHANNEL_MASK             UINT32_C(0x3100)
+#define POWER_CRITICAL_MAGNETOMETER_HZ          UINT8_C(2)
+
+/* Thermal array streaming *************************************************** */
+
+/**
+ * APP_THERMAL_ENABLE is set to capture the 8x8 frames of a Grid-EYE (AMG8833)
+ * on the I2C bus of the extension port every THERMAL_FRAME_PERIOD_MS
+ * (ThermalAgent). THERMAL_UPLOAD_MODE THERMAL_FRAME_MODE_FRAMES delta encodes
+ * the frames, so only the pixels which changed by more than THERMAL_DEADBAND
+ * are sent; THERMAL_FRAME_MODE_SUMMARIES sends a presence and hotspot record
+ * whenever the summary changed. The frames collected since the last post are
+ * posted to THERMAL_POST_PATH right after every sensor post, see ThermalFrame.h
+ * for the body. Tools/ThermalReplay replays frames through the encoder on the
+ * host and measures the compression and the time per frame. The frames are
+ * posted over HTTP, so it cannot be combined with APP_LWM2M_ENABLE or
+ * APP_LORA_ENABLE.
+ */
+#define APP_THERMAL_ENABLE                      UINT32_C(0)
+
+/**
+ * THERMAL_I2C_ADDRESS is the 7 bit address of the sensor, 0x69 with AD_SELECT
+ * high as on most breakout boards, 0x68 with it low.
+ */
+#define THERMAL_I2C_ADDRESS                     UINT8_C(0x69)
+
+/**
+ * THERMAL_FRAME_PERIOD_MS is the time between two frames, 100 for the 10
+ * frames per second of the sensor. From 1000 on the sensor runs at 1 frame
+ * per second and averages less noise away.
+ */
+#define THERMAL_FRAME_PERIOD_MS                 UINT32_C(100)
+
+/**
+ * THERMAL_UPLOAD_MODE is THERMAL_FRAME_MODE_FRAMES for the changed pixels or
+ * THERMAL_FRAME_MODE_SUMMARIES for presence and hotspot records only.
+ */
+#define THERMAL_UPLOAD_MODE                     THERMAL_FRAME_MODE_FRAMES
+
+/**
+ * THERMAL_DEADBAND is the largest change of a pixel, or of the hotspot of a
+ * summary, which is not sent, in 0.25 degC. 2 keeps the sensor noise of the
+ * AMG8833 out of the body; 0 posts every frame lossless.
+ */
+#define THERMAL_DEADBAND                        UINT8_C(2)
+
+/**
+ * THERMAL_KEY_INTERVAL is the number of frames between two complete frames
+ * within a post, 0 for only the first one.
+ */
+#define THERMAL_KEY_INTERVAL                    UINT16_C(100)
+
+/**
+ * THERMAL_PRESENCE_THRESHOLD is the rise above the background of a pixel seeing
+ * a person, in 0.25 degC, THERMAL_PRESENCE_MIN_PIXELS the pixels of a presence.
+ */
+#define THERMAL_PRESENCE_THRESHOLD              UINT8_C(6)
+#define THERMAL_PRESENCE_MIN_PIXELS             UINT8_C(2)
+
+/**
+ * THERMAL_BACKGROUND_SHIFT sets the weight of a frame in the background to
+ * 1 / 2^THERMAL_BACKGROUND_SHIFT; 7 follows the room within about 13 s at 10
+ * frames per second and takes a person standing still in within minutes.
+ */
+#define THERMAL_BACKGROUND_SHIFT                UINT8_C(7)
+
+/**
+ * THERMAL_POST_PATH is the URL path the frames are posted to.
+ */
+#define THERMAL_POST_PATH                       "/thermal"
+
+/* Wake on event configurations ********************************************** */
+
+/**
+ * APP_WAKE_ON_EVENT_ENABLE is set to sample on sensor events instead of every
+ * second (WakeAgent): idle, every sensor is read once per WAKE_HEARTBEAT_MS;
+ * motion of the BMA280 raises the sampling rate up to WAKE_FASTEST_PERIOD_MS
+ * and a change of the light reads the BME280 right away. Tools/WakePolicySim
+ * runs the policy on the host. It retimes the sensors itself, so it cannot be
+ * combined with APP_LWM2M_ENABLE or APP_BLE_STREAM_ENABLE.
+ */
+#define APP_WAKE_ON_EVENT_ENABLE        UINT32_C(0)
+
+/**
+ * WAKE_HEARTBEAT_MS is the period of every sensor while there is no activity.
+ */
+#define WAKE_HEARTBEAT_MS               UINT32_C(60000)
+
+/**
+ * WAKE_LIGHT_POLL_MS is the period the lux window is checked at while there is no activity.
+ * At 1000 ms a light change reads the BME280 as soon as the fixed polling did;
+ * a longer period saves energy, but the BME280 read lags a light change by
+ * up to the period (5000 ms: about 2.5 s on average in Tools/WakePolicySim).
+ */
+#define WAKE_LIGHT_POLL_MS              UINT32_C(1000)
+
+/**
+ * WAKE_ACTIVE_PERIOD_MS is the period of the sensors once motion starts.
+ */
+#define WAKE_ACTIVE_PERIOD_MS           UINT32_C(1000)
+
+/**
+ * WAKE_FASTEST_PERIOD_MS is the shortest period of the motion sensors during continued motion.
+ */
+#define WAKE_FASTEST_PERIOD_MS          UINT32_C(125)
+
+/**
+ * WAKE_RAMP_STEP_MS is the shortest time between two changes of the motion period.
+ */
+#define WAKE_RAMP_STEP_MS               UINT32_C(2000)
+
+/**
+ * WAKE_QUIET_MS is the time without motion before the sampling rate ramps down.
+ */
+#define WAKE_QUIET_MS                   UINT32_C(10000)
+
+/**
+ * WAKE_LUX_WINDOW_PERMILLE is the relative light change which reads the BME280, WAKE_LUX_HYSTERESIS_MLX the least one.
+ */
+#define WAKE_LUX_WINDOW_PERMILLE        UINT16_C(200)
+#define WAKE_LUX_HYSTERESIS_MLX         UINT32_C(20000)
+
+/**
+ * WAKE_SLOPE_THRESHOLD and WAKE_SLOPE_DURATION configure the slope interrupt of
+ * the BMA280: threshold in steps of 3.91 mg at the 2 g range, duration in
+ * consecutive samples.
+ */
+#define WAKE_SLOPE_THRESHOLD            UINT32_C(20)
+#define WAKE_SLOPE_DURATION             UINT32_C(2)
+
+/* LWM2M configurations ****************************************************** */
+
+/**
+ * APP_LWM2M_ENABLE is set to serve the sensor values to an LWM2M server (e.g. Leshan)
+ * instead of posting them over HTTP. The sensors are then only sampled while
+ * observed, at the rate the server attributes (pmin / pmax) require.
+ */
+#define APP_LWM2M_ENABLE                UINT32_C(0)
+
+/**
+ * LWM2M_SERVER_HOST is the host name or IPv4 address of the LWM2M server.
+ */
+#define LWM2M_SERVER_HOST               "leshan.eclipseprojects.io"
+
+/**
+ * LWM2M_SERVER_PORT is the CoAP port of the LWM2M server (non secure).
+ */
+#define LWM2M_SERVER_PORT               UINT16_C(5683)
+
+/**
+ * LWM2M_ENDPOINT_NAME is the endpoint client name the XDK registers with.
+ */
+#define LWM2M_ENDPOINT_NAME             "XDK110_Dashboard"
+
+/**
+ * LWM2M_LIFETIME_S is the registration lifetime in seconds.
+ */
+#define LWM2M_LIFETIME_S                UINT32_C(300)
+
+/* BLE streaming configurations ********************************************** */
+
+/**
+ * APP_BLE_STREAM_ENABLE is set to stream live samples as notifications of the
+ * BCDS bidirectional BLE service, e.g. for commissioning without WLAN.
+ */
+#define APP_BLE_STREAM_ENABLE           UINT32_C(0)
+
+/**
+ * BLE_DEVICE_NAME is the advertised BLE device name.
+ */
+#define BLE_DEVICE_NAME                 "XDK_Dashboard"
+
+/**
+ * BLE_STREAM_SAMPLE_RATE_HZ is the rate the streamed sensors are sampled at.
+ */
+#define BLE_STREAM_SAMPLE_RATE_HZ       UINT32_C(50)
+
+/**
+ * BLE_STREAM_CHANNEL_MASK selects the streamed SensorSnapshot channels, bit n for
+ * channel n. The default 0x0007 streams the three accelerometer axes.
+ */
+#define BLE_STREAM_CHANNEL_MASK         UINT16_C(0x0007)
+
+/**
+ * BLE_STREAM_PAYLOAD_SIZE is the notification payload size (ATT MTU - 3). The
+ * bidirectional service is limited to 20 bytes; a custom service on a link with
+ * a larger negotiated MTU can raise it up to BLE_STREAM_MAX_PAYLOAD_SIZE.
+ */
+#define BLE_STREAM_PAYLOAD_SIZE         UINT16_C(20)
+
+/**
+ * BLE_STREAM_CONNECTION_INTERVAL_MS is the connection interval the notifications are paced to.
+ */
+#define BLE_STREAM_CONNECTION_INTERVAL_MS   UINT32_C(30)
+
+/**
+ * BLE_STREAM_PACKETS_PER_EVENT is the number of notifications sent per connection interval.
+ */
+#define BLE_STREAM_PACKETS_PER_EVENT    UINT8_C(4)
+
+/**
+ * BLE_STREAM_MAX_LATENCY_MS is the age after which a partially filled notification is sent.
+ */
+#define BLE_STREAM_MAX_LATENCY_MS       UINT32_C(100)
+
+/**
+ * BLE_STREAM_RING_CAPACITY is the number of samples buffered between acquisition and BLE.
+ */
+#define BLE_STREAM_RING_CAPACITY        UINT32_C(64)
+
+/* LoRaWAN configurations **************************************************** */
+
+/**
+ * APP_LORA_ENABLE is set to send the sensor values as LoRaWAN uplinks through the
+ * LoRa extension board instead of HTTP, for sites without WLAN. WLAN, SNTP and
+ * the HTTP client are not started in this mode.
+ */
+#define APP_LORA_ENABLE                 UINT32_C(0)
+
+/**
+ * LORA_REGION is the LoRaWAN region, LORA_PAYLOAD_REGION_EU868 or LORA_PAYLOAD_REGION_US915.
+ */
+#define LORA_REGION                     LORA_PAYLOAD_REGION_EU868
+
+/**
+ * LORA_DEV_EUI, LORA_APP_EUI and LORA_APP_KEY are the OTAA credentials of the device.
+ */
+#define LORA_DEV_EUI                    "0000000000000000"
+#define LORA_APP_EUI                    "0000000000000000"
+#define LORA_APP_KEY                    "00000000000000000000000000000000"
+
+/**
+ * LORA_DATA_RATE is the fixed uplink data rate (ADR is off). It sets the maximum
+ * payload size: 51 bytes for DR0-2, 115 for DR3 and 242 from DR4 on in EU868.
+ */
+#define LORA_DATA_RATE                  UINT8_C(5)
+
+/**
+ * LORA_PAYLOAD_FORMAT is LORA_PAYLOAD_FORMAT_CAYENNE_LPP for network server
+ * integrations decoding Cayenne LPP, or LORA_PAYLOAD_FORMAT_BIT_PACKED for the
+ * smallest payload (22 bytes for all sensors instead of 47).
+ */
+#define LORA_PAYLOAD_FORMAT             LORA_PAYLOAD_FORMAT_BIT_PACKED
+
+/**
+ * LORA_PORT is the application port of the uplinks.
+ */
+#define LORA_PORT                       UINT8_C(1)
+
+/**
+ * LORA_DUTY_CYCLE_PERMILLE is the regulatory duty cycle of the sub-band, 10 for the 1 % of EU868 g1.
+ */
+#define LORA_DUTY_CYCLE_PERMILLE        UINT16_C(10)
+
+/**
+ * LORA_DAILY_AIRTIME_MS is the airtime budget per day, e.g. 30 s for The Things
+ * Network fair use policy. 0 limits by the duty cycle only.
+ */
+#define LORA_DAILY_AIRTIME_MS           UINT32_C(30000)
+
+/**
+ * LORA_MIN_INTERVAL_MS and LORA_MAX_INTERVAL_MS bound the time between uplinks:
+ * changes are sent at most every LORA_MIN_INTERVAL_MS, every sensor at least every
+ * LORA_MAX_INTERVAL_MS.
+ */
+#define LORA_MIN_INTERVAL_MS            UINT32_C(60000)
+#define LORA_MAX_INTERVAL_MS            UINT32_C(3600000)
+
 /**
  * @brief Gives control to the Application controller.
  *
@@ -0,0 +1,232 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the BLE notification packer.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "BleStream.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define BLE_STREAM_INTERVAL_UNIT_US         UINT32_C(1250)
+#define BLE_STREAM_MIN_INTERVAL_US          UINT32_C(7500)
+#define BLE_STREAM_MAX_INTERVAL_US          UINT32_C(4000000)
+
+/* local functions ********************************************************** */
+
+static void WriteLe16(uint8_t * buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t) (value & 0xFFU);
+    buffer[1] = (uint8_t) (value >> 8);
+}
+
+static void WriteLe32(uint8_t * buffer, uint32_t value)
+{
+    buffer[0] = (uint8_t) (value & 0xFFUL);
+    buffer[1] = (uint8_t) ((value >> 8) & 0xFFUL);
+    buffer[2] = (uint8_t) ((value >> 16) & 0xFFUL);
+    buffer[3] = (uint8_t) (value >> 24);
+}
+
+/**
+ * @brief Packs the oldest waiting samples into the frame buffer.
+ *
+ * A sample more than 65535 ms after its predecessor starts a new frame, as
+ * the delta would not fit.
+ *
+ * @return Number of samples packed.
+ */
+static uint16_t BuildFrame(BleStream_T * stream, uint16_t * length)
+{
+    uint16_t maxSamples = BleStream_GetSamplesPerFrame(stream);
+    uint16_t count = 0U;
+    uint16_t position = BLE_STREAM_FRAME_HEADER_SIZE;
+    uint32_t previousMs = 0UL;
+    const SensorSnapshot_T * sample;
+    uint8_t channel;
+
+    while ((count < maxSamples) && (NULL != (sample = SampleRing_Peek(stream->Ring, count))))
+    {
+        if (0U == count)
+        {
+            WriteLe32(&stream->Frame[2], sample->TimestampMs);
+            previousMs = sample->TimestampMs;
+        }
+        else if ((sample->TimestampMs - previousMs) > UINT16_MAX)
+        {
+            break;
+        }
+        WriteLe16(&stream->Frame[position], (uint16_t) (sample->TimestampMs - previousMs));
+        position += BLE_STREAM_SAMPLE_DELTA_SIZE;
+        for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+        {
+            if (0U != (stream->Setup.ChannelMask & (1U << channel)))
+            {
+                WriteLe32(&stream->Frame[position], sample->Values[channel].Bits);
+                position += 4U;
+            }
+        }
+        previousMs = sample->TimestampMs;
+        count++;
+    }
+    stream->Frame[0] = stream->Sequence;
+    stream->Frame[1] = (uint8_t) count;
+    *length = position;
+    return count;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool BleStream_Init(BleStream_T * stream, const BleStream_Setup_T * setup, SampleRing_T * ring)
+{
+    uint8_t channel;
+    uint16_t channels = 0U;
+
+    if ((NULL == stream) || (NULL == setup) || (NULL == ring) || (NULL == setup->Send) ||
+            (setup->PayloadSize > BLE_STREAM_MAX_PAYLOAD_SIZE) || (0U == setup->PacketsPerEvent) ||
+            (0UL == setup->ConnectionIntervalMs))
+    {
+        return false;
+    }
+    for (channel = 0U; channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT; channel++)
+    {
+        if (0U != (setup->ChannelMask & (1U << channel)))
+        {
+            channels++;
+        }
+    }
+    memset(stream, 0, sizeof(*stream));
+    stream->Setup = *setup;
+    stream->Ring = ring;
+    stream->SampleSize = (uint16_t) (BLE_STREAM_SAMPLE_DELTA_SIZE + (4U * channels));
+    stream->Credits = setup->PacketsPerEvent;
+    return ((0U != channels) && (BleStream_GetSamplesPerFrame(stream) > 0U));
+}
+
+/** Refer interface header for description */
+uint8_t BleStream_Process(BleStream_T * stream, uint32_t nowMs)
+{
+    uint8_t sent = 0U;
+    uint16_t length;
+    uint16_t count;
+    const SensorSnapshot_T * oldest;
+
+    if ((nowMs - stream->IntervalStartMs) >= stream->Setup.ConnectionIntervalMs)
+    {
+        /* Stay aligned to the interval grid unless the caller fell behind by more than one interval */
+        stream->IntervalStartMs = ((nowMs - stream->IntervalStartMs) < (2UL * stream->Setup.ConnectionIntervalMs)) ?
+                (stream->IntervalStartMs + stream->Setup.ConnectionIntervalMs) : nowMs;
+        stream->Credits = stream->Setup.PacketsPerEvent;
+    }
+
+    while (stream->Credits > 0U)
+    {
+        oldest = SampleRing_Peek(stream->Ring, 0UL);
+        if (NULL == oldest)
+        {
+            break;
+        }
+        /* A partial frame waits for more samples until it is MaxLatencyMs old */
+        if ((SampleRing_Count(stream->Ring) < BleStream_GetSamplesPerFrame(stream)) &&
+                ((nowMs - oldest->TimestampMs) < stream->Setup.MaxLatencyMs))
+        {
+            break;
+        }
+        count = BuildFrame(stream, &length);
+        if (!stream->Setup.Send(stream->Setup.SendContext, stream->Frame, length))
+        {
+            /* Backpressure: the samples stay in the ring until the link drains */
+            stream->Statistics.LinkBusy++;
+            stream->Credits = 0U;
+            break;
+        }
+        SampleRing_Consume(stream->Ring, count);
+        if (0UL == stream->Statistics.FramesSent)
+        {
+            stream->Statistics.StartMs = nowMs;
+        }
+        stream->Statistics.FramesSent++;
+        stream->Statistics.SamplesSent += count;
+        stream->Statistics.BytesSent += length;
+        stream->Statistics.LastSendMs = nowMs;
+        stream->Sequence++;
+        stream->Credits--;
+        sent++;
+    }
+    return sent;
+}
+
+/** Refer interface header for description */
+void BleStream_Discard(BleStream_T * stream)
+{
+    uint32_t count = SampleRing_Count(stream->Ring);
+
+    SampleRing_Consume(stream->Ring, count);
+    stream->Statistics.SamplesDiscarded += count;
+}
+
+/** Refer interface header for description */
+uint16_t BleStream_GetSamplesPerFrame(const BleStream_T * stream)
+{
+    uint16_t samples;
+
+    if (stream->Setup.PayloadSize <= BLE_STREAM_FRAME_HEADER_SIZE)
+    {
+        return 0U;
+    }
+    samples = (uint16_t) ((stream->Setup.PayloadSize - BLE_STREAM_FRAME_HEADER_SIZE) / stream->SampleSize);
+    return (samples > UINT8_MAX) ? UINT8_MAX : samples;
+}
+
+/** Refer interface header for description */
+const BleStream_Statistics_T * BleStream_GetStatistics(BleStream_T * stream)
+{
+    stream->Statistics.SamplesDropped = stream->Ring->Dropped;
+    stream->Statistics.PeakRingFill = stream->Ring->PeakFill;
+    return &stream->Statistics;
+}
+
+/** Refer interface header for description */
+uint32_t BleStream_GetThroughput(const BleStream_T * stream)
+{
+    uint32_t elapsedMs = stream->Statistics.LastSendMs - stream->Statistics.StartMs;
+
+    if (0UL == elapsedMs)
+    {
+        return 0UL;
+    }
+    return (uint32_t) (((uint64_t) stream->Statistics.BytesSent * 1000ULL) / elapsedMs);
+}
+
+/** Refer interface header for description */
+uint32_t BleStream_RecommendConnectionIntervalUs(const BleStream_T * stream, uint32_t sampleRateHz)
+{
+    uint64_t intervalUs;
+    uint16_t samplesPerFrame = BleStream_GetSamplesPerFrame(stream);
+
+    if ((0UL == sampleRateHz) || (0U == samplesPerFrame))
+    {
+        return BLE_STREAM_MIN_INTERVAL_US;
+    }
+    /* frames per second = rate / samplesPerFrame, halved for retries and jitter */
+    intervalUs = ((uint64_t) 1000000ULL * stream->Setup.PacketsPerEvent * samplesPerFrame) / (2ULL * sampleRateHz);
+    intervalUs -= intervalUs % BLE_STREAM_INTERVAL_UNIT_US;
+    if (intervalUs < BLE_STREAM_MIN_INTERVAL_US)
+    {
+        intervalUs = BLE_STREAM_MIN_INTERVAL_US;
+    }
+    if (intervalUs > BLE_STREAM_MAX_INTERVAL_US)
+    {
+        intervalUs = BLE_STREAM_MAX_INTERVAL_US;
+    }
+    return (uint32_t) intervalUs;
+}
@@ -0,0 +1,166 @@
+/**
+ *  @file
+ *
+ *  @brief Packs sensor snapshots from a SampleRing into BLE notifications.
+ *
+ *  As many samples as fit into the notification payload (ATT MTU - 3) are
+ *  packed into one frame. Frames are paced by the connection interval: at most
+ *  PacketsPerEvent frames are handed to the link per interval. A frame is only
+ *  consumed from the ring once the link accepted it, so a busy link holds the
+ *  samples back in the ring instead of losing them; only a full ring drops.
+ *
+ *  Frame layout (little endian):
+ *  | 0        | 1           | 2..5                | per sample: 2..3 + 4 * channels |
+ *  | sequence | sampleCount | first timestamp ms  | delta ms to previous sample, raw 32 bit values |
+ *
+ *  The values are the SensorSnapshot_T raw bits of the channels in
+ *  ChannelMask, in channel order.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef BLESTREAM_H_
+#define BLESTREAM_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SampleRing.h"
+
+/* local type and macro definitions */
+
+/** Largest notification payload (ATT MTU 247 of LE data length extension) */
+#define BLE_STREAM_MAX_PAYLOAD_SIZE         UINT16_C(244)
+
+/** Size of the frame header */
+#define BLE_STREAM_FRAME_HEADER_SIZE        UINT16_C(6)
+
+/** Size of the per sample timestamp delta */
+#define BLE_STREAM_SAMPLE_DELTA_SIZE        UINT16_C(2)
+
+/**
+ * @brief Hands one frame to the link.
+ *
+ * @return false if the link cannot take the frame now; it is offered again later.
+ */
+typedef bool (*BleStream_SendFunc_T)(void * context, const uint8_t * frame, uint16_t length);
+
+/**
+ * @brief Stream configuration.
+ */
+struct BleStream_Setup_S
+{
+    uint16_t PayloadSize; /**< Notification payload size, negotiated ATT MTU - 3 */
+    uint16_t ChannelMask; /**< Snapshot channels streamed, bit n for channel n */
+    uint32_t ConnectionIntervalMs; /**< Connection interval the frames are paced to */
+    uint8_t PacketsPerEvent; /**< Frames handed to the link per connection interval */
+    uint32_t MaxLatencyMs; /**< A partial frame is sent once its oldest sample is this old */
+    BleStream_SendFunc_T Send;
+    void * SendContext;
+};
+typedef struct BleStream_Setup_S BleStream_Setup_T;
+
+/**
+ * @brief Stream counters.
+ */
+struct BleStream_Statistics_S
+{
+    uint32_t FramesSent;
+    uint32_t SamplesSent;
+    uint32_t BytesSent;
+    uint32_t LinkBusy; /**< Frames the link refused, sent again later */
+    uint32_t SamplesDiscarded; /**< Samples flushed while no peer was connected */
+    uint32_t SamplesDropped; /**< Samples lost because the ring was full */
+    uint32_t PeakRingFill;
+    uint32_t StartMs; /**< Time of the first sent frame, base of the throughput */
+    uint32_t LastSendMs;
+};
+typedef struct BleStream_Statistics_S BleStream_Statistics_T;
+
+/**
+ * @brief Stream state.
+ */
+struct BleStream_S
+{
+    BleStream_Setup_T Setup;
+    SampleRing_T * Ring;
+    uint16_t SampleSize; /**< Bytes per packed sample */
+    uint8_t Sequence;
+    uint8_t Credits; /**< Frames the link may still take in the current interval */
+    uint32_t IntervalStartMs;
+    BleStream_Statistics_T Statistics;
+    uint8_t Frame[BLE_STREAM_MAX_PAYLOAD_SIZE];
+};
+typedef struct BleStream_S BleStream_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes the stream.
+ *
+ * @param[out] stream
+ * Stream state
+ *
+ * @param[in] setup
+ * Configuration, copied
+ *
+ * @param[in] ring
+ * Acquisition ring the samples are taken from
+ *
+ * @return false if the parameters are invalid or one sample does not fit into a frame.
+ */
+bool BleStream_Init(BleStream_T * stream, const BleStream_Setup_T * setup, SampleRing_T * ring);
+
+/**
+ * @brief Sends the frames which are due; call at least once per connection interval.
+ *
+ * @param[in,out] stream
+ * Stream state
+ *
+ * @param[in] nowMs
+ * Current time in milliseconds, same time base as the snapshot timestamps
+ *
+ * @return Number of frames the link accepted.
+ */
+uint8_t BleStream_Process(BleStream_T * stream, uint32_t nowMs);
+
+/**
+ * @brief Empties the ring, e.g. while no peer is connected.
+ */
+void BleStream_Discard(BleStream_T * stream);
+
+/**
+ * @brief Returns the number of samples one frame carries.
+ */
+uint16_t BleStream_GetSamplesPerFrame(const BleStream_T * stream);
+
+/**
+ * @brief Returns the counters, including the ring drops.
+ */
+const BleStream_Statistics_T * BleStream_GetStatistics(BleStream_T * stream);
+
+/**
+ * @brief Returns the payload throughput since the first frame.
+ *
+ * @return Bytes per second.
+ */
+uint32_t BleStream_GetThroughput(const BleStream_T * stream);
+
+/**
+ * @brief Computes the longest connection interval that carries a sample rate with 2x headroom.
+ *
+ * Longer intervals save power on both sides, so this is the interval to ask
+ * the central for.
+ *
+ * @param[in] stream
+ * Stream state
+ *
+ * @param[in] sampleRateHz
+ * Acquisition rate
+ *
+ * @return Interval in microseconds, a multiple of 1250 within the 7.5 ms .. 4 s range of the specification.
+ */
+uint32_t BleStream_RecommendConnectionIntervalUs(const BleStream_T * stream, uint32_t sampleRateHz);
+
+#endif /* BLESTREAM_H_ */
@@ -0,0 +1,171 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the BLE streaming task.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_BLE_STREAM_AGENT
+
+#include "BleStreamAgent.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "XDK_BLE.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "StaticRtos.h"
+
+/* constant definitions ***************************************************** */
+
+#define BLE_STREAM_AGENT_SEND_TIMEOUT_MS    UINT32_C(5) /**< Wait for the controller to take a notification */
+
+/* local variables ********************************************************** */
+
+static const BleStreamAgent_Setup_T * AgentSetup = NULL;
+
+static BleStream_T AgentStream; /**< Stream state */
+
+static xTaskHandle AgentTaskHandle = NULL;
+
+STATIC_RTOS_TASK(AgentTaskStorage, TASK_STACK_SIZE_BLE_STREAM_AGENT);
+
+static BLE_Setup_T BLESetupInfo =
+        {
+                .DeviceName = NULL, /* Filled in by BleStreamAgent_Setup */
+                .IsMacAddrConfigured = false,
+                .MacAddr = 0UL,
+                .Service = BLE_BCDS_BIDIRECTIONAL_SERVICE,
+                .IsDeviceCharacteristicEnabled = false,
+                .CharacteristicValue =
+                        {
+                                .ModelNumber = NULL,
+                                .Manufacturer = NULL,
+                                .SoftwareRevision = NULL
+                        },
+                .DataRxCB = NULL,
+                .CustomServiceRegistryCB = NULL,
+        };/**< BLE setup parameters */
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Hands a frame to the BLE stack; a refused frame stays in the ring.
+ */
+static bool AgentSend(void * context, const uint8_t * frame, uint16_t length)
+{
+    BCDS_UNUSED(context);
+
+    return (RETCODE_OK == BLE_SendData((uint8_t *) frame, (uint8_t) length, NULL, BLE_STREAM_AGENT_SEND_TIMEOUT_MS));
+}
+
+static void AgentPrintStatistics(void)
+{
+    const BleStream_Statistics_T * statistics = BleStream_GetStatistics(&AgentStream);
+
+    printf("BleStream : frames %lu samples %lu bytes %lu (%lu B/s) busy %lu dropped %lu discarded %lu peak ring %lu\r\n",
+            (unsigned long) statistics->FramesSent, (unsigned long) statistics->SamplesSent,
+            (unsigned long) statistics->BytesSent, (unsigned long) BleStream_GetThroughput(&AgentStream),
+            (unsigned long) statistics->LinkBusy, (unsigned long) statistics->SamplesDropped,
+            (unsigned long) statistics->SamplesDiscarded, (unsigned long) statistics->PeakRingFill);
+}
+
+/**
+ * @brief Wakes up once per connection interval and passes the due frames to the link.
+ */
+static void AgentTask(void * pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    uint32_t lastPrintMs = AgentNowMs();
+
+    for (;;)
+    {
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(AgentSetup->ConnectionIntervalMs));
+        if (BLE_IsConnected())
+        {
+            (void) BleStream_Process(&AgentStream, AgentNowMs());
+        }
+        else
+        {
+            /* Nobody listens, old samples are of no use once a peer connects */
+            BleStream_Discard(&AgentStream);
+        }
+        if ((0UL != AgentSetup->StatisticsIntervalMs) && ((AgentNowMs() - lastPrintMs) >= AgentSetup->StatisticsIntervalMs))
+        {
+            lastPrintMs = AgentNowMs();
+            AgentPrintStatistics();
+        }
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T BleStreamAgent_Setup(const BleStreamAgent_Setup_T * setup)
+{
+    BleStream_Setup_T streamSetup;
+
+    if ((NULL == setup) || (NULL == setup->Ring) || (NULL == setup->DeviceName))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    streamSetup.PayloadSize = setup->PayloadSize;
+    streamSetup.ChannelMask = setup->ChannelMask;
+    streamSetup.ConnectionIntervalMs = setup->ConnectionIntervalMs;
+    streamSetup.PacketsPerEvent = setup->PacketsPerEvent;
+    streamSetup.MaxLatencyMs = setup->MaxLatencyMs;
+    streamSetup.Send = AgentSend;
+    streamSetup.SendContext = NULL;
+    if (!BleStream_Init(&AgentStream, &streamSetup, setup->Ring))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentSetup = setup;
+    BLESetupInfo.DeviceName = setup->DeviceName;
+    printf("BleStream : %u samples per notification, recommended connection interval %lu us\r\n",
+            (unsigned int) BleStream_GetSamplesPerFrame(&AgentStream),
+            (unsigned long) BleStream_RecommendConnectionIntervalUs(&AgentStream, setup->SampleRateHz));
+    return BLE_Setup(&BLESetupInfo);
+}
+
+/** Refer interface header for description */
+Retcode_T BleStreamAgent_Enable(void)
+{
+    Retcode_T retcode;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    retcode = BLE_Enable();
+    if (RETCODE_OK == retcode)
+    {
+        AgentTaskHandle = StaticRtos_CreateTask(&AgentTaskStorage, AgentTask, "BleStream", NULL, TASK_PRIO_BLE_STREAM_AGENT);
+        if (NULL == AgentTaskHandle)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const BleStream_Statistics_T * BleStreamAgent_GetStatistics(void)
+{
+    return BleStream_GetStatistics(&AgentStream);
+}
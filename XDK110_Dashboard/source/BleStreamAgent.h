@@ -0,0 +1,62 @@
+/**
+ *  @file
+ *
+ *  @brief Streams sensor samples as BLE notifications through the XDK BLE service.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef BLESTREAMAGENT_H_
+#define BLESTREAMAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "SampleRing.h"
+#include "BleStream.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Agent configuration.
+ */
+struct BleStreamAgent_Setup_S
+{
+    const char * DeviceName; /**< Advertised device name */
+    SampleRing_T * Ring; /**< Acquisition ring filled at SampleRateHz */
+    uint32_t SampleRateHz;
+    uint16_t PayloadSize; /**< Notification payload size, ATT MTU - 3 */
+    uint16_t ChannelMask; /**< Snapshot channels streamed */
+    uint32_t ConnectionIntervalMs;
+    uint8_t PacketsPerEvent;
+    uint32_t MaxLatencyMs;
+    uint32_t StatisticsIntervalMs; /**< Period of the statistics print out, 0 to disable */
+};
+typedef struct BleStreamAgent_Setup_S BleStreamAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Sets up the BLE service and the stream.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T BleStreamAgent_Setup(const BleStreamAgent_Setup_T * setup);
+
+/**
+ * @brief Starts advertising and the streaming task.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T BleStreamAgent_Enable(void);
+
+/**
+ * @brief Returns the stream counters.
+ */
+const BleStream_Statistics_T * BleStreamAgent_GetStatistics(void);
+
+#endif /* BLESTREAMAGENT_H_ */
@@ -0,0 +1,283 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the boot step sequencer.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_BOOT_SEQUENCER
+
+#include "BootSequencer.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "StaticRtos.h"
+
+/* local type and macro definitions */
+
+#if APP_STATIC_ALLOCATION_ENABLE
+/** Static storage is only reserved for the workers the application uses */
+#define BOOT_SEQUENCER_WORKER_STORAGE       TASK_COUNT_BOOT_WORKER
+#else
+#define BOOT_SEQUENCER_WORKER_STORAGE       BOOT_SEQUENCER_MAX_WORKERS
+#endif /* APP_STATIC_ALLOCATION_ENABLE */
+
+/* local variables ********************************************************** */
+
+static const BootSequencer_Step_T * SequencerSteps = NULL;
+
+static uint8_t SequencerCount = 0U;
+
+static uint8_t SequencerWorkers = 0U;
+
+static BootSequencer_DoneCallback_T SequencerDoneCallback = NULL;
+
+static uint32_t DoneMask = 0UL; /**< Steps completed successfully, never cleared */
+
+static uint32_t FailedMask = 0UL; /**< Steps failed in the current run */
+
+static uint32_t RunningMask = 0UL; /**< Steps a worker is running */
+
+static bool IsRunning = false;
+
+static Retcode_T FirstError = RETCODE_OK;
+
+static uint32_t StartMs[BOOT_SEQUENCER_MAX_STEPS];
+
+static uint32_t DurationMs[BOOT_SEQUENCER_MAX_STEPS];
+
+static uint32_t FinishMs = 0UL;
+
+static SemaphoreHandle_t SequencerLock = NULL; /**< Protects the masks */
+
+static SemaphoreHandle_t SequencerProgress = NULL; /**< Given for every waiting worker when a step ends */
+
+static StaticRtos_Semaphore_T SequencerLockStorage;
+
+static StaticRtos_Semaphore_T SequencerProgressStorage;
+
+STATIC_RTOS_TASKS(SequencerWorkerStorage, BOOT_SEQUENCER_WORKER_STORAGE, TASK_STACK_SIZE_BOOT_WORKER);
+
+static xTaskHandle SequencerWorkerHandles[BOOT_SEQUENCER_WORKER_STORAGE];
+
+/* local functions ********************************************************** */
+
+static uint32_t SequencerNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Returns the lowest ready step: not done, failed or running and all dependencies done.
+ *
+ * @return Step index, SequencerCount if no step is ready.
+ */
+static uint8_t SequencerNextReady(void)
+{
+    uint8_t step;
+    uint32_t bit;
+
+    for (step = 0U; step < SequencerCount; step++)
+    {
+        bit = BOOT_SEQUENCER_STEP(step);
+        if ((0UL == ((DoneMask | FailedMask | RunningMask) & bit)) &&
+                ((SequencerSteps[step].DependsOn & DoneMask) == SequencerSteps[step].DependsOn))
+        {
+            break;
+        }
+    }
+    return step;
+}
+
+/**
+ * @brief Runs ready steps until none is left, then leaves; the worker which ends the run reports it.
+ */
+static void SequencerWorker(void * pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    uint8_t step;
+    uint8_t worker;
+    uint32_t startMs;
+    Retcode_T retcode;
+    bool isFinished = false;
+
+    while (!isFinished)
+    {
+        (void) xSemaphoreTake(SequencerLock, portMAX_DELAY);
+        step = IsRunning ? SequencerNextReady() : SequencerCount;
+        if (step < SequencerCount)
+        {
+            RunningMask |= BOOT_SEQUENCER_STEP(step);
+        }
+        isFinished = !IsRunning;
+        (void) xSemaphoreGive(SequencerLock);
+
+        if (step < SequencerCount)
+        {
+            startMs = SequencerNowMs();
+            retcode = SequencerSteps[step].Run();
+
+            (void) xSemaphoreTake(SequencerLock, portMAX_DELAY);
+            StartMs[step] = startMs;
+            DurationMs[step] = SequencerNowMs() - startMs;
+            RunningMask &= ~BOOT_SEQUENCER_STEP(step);
+            if (RETCODE_OK == retcode)
+            {
+                DoneMask |= BOOT_SEQUENCER_STEP(step);
+            }
+            else
+            {
+                printf("BootSequencer : step %s failed\r\n", SequencerSteps[step].Name);
+                FailedMask |= BOOT_SEQUENCER_STEP(step);
+                if (RETCODE_OK == FirstError)
+                {
+                    FirstError = retcode;
+                }
+            }
+            /* The run ends when nothing runs and nothing became ready */
+            isFinished = (0UL == RunningMask) && (SequencerNextReady() >= SequencerCount);
+            if (isFinished)
+            {
+                IsRunning = false;
+                FinishMs = SequencerNowMs();
+            }
+            retcode = FirstError;
+            (void) xSemaphoreGive(SequencerLock);
+
+            for (worker = 0U; worker < SequencerWorkers; worker++)
+            {
+                (void) xSemaphoreGive(SequencerProgress);
+            }
+            if (isFinished)
+            {
+                BootSequencer_PrintReport();
+                SequencerDoneCallback(retcode);
+            }
+        }
+        else if (!isFinished)
+        {
+            (void) xSemaphoreTake(SequencerProgress, portMAX_DELAY);
+        }
+    }
+    StaticRtos_ExitTask();
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T BootSequencer_Start(const BootSequencer_Step_T * steps, uint8_t count, uint8_t workers, BootSequencer_DoneCallback_T doneCallback)
+{
+    Retcode_T retcode = RETCODE_OK;
+    uint8_t step;
+    uint8_t worker;
+    uint8_t started;
+
+    if ((NULL == steps) || (NULL == doneCallback))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0U == count) || (count > BOOT_SEQUENCER_MAX_STEPS) || (0U == workers) || (workers > BOOT_SEQUENCER_MAX_WORKERS))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    for (step = 0U; step < count; step++)
+    {
+        /* Only earlier steps may be depended on, this rules out cycles */
+        if ((NULL == steps[step].Run) || (0UL != (steps[step].DependsOn & ~(BOOT_SEQUENCER_STEP(step) - 1UL))))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+        }
+    }
+    if (IsRunning || ((NULL != SequencerSteps) && (steps != SequencerSteps)))
+    {
+        /* A second run may only repeat the unfinished steps of the same table */
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INCONSISTENT_STATE);
+    }
+    if (NULL == SequencerLock)
+    {
+        SequencerLock = StaticRtos_CreateMutex(&SequencerLockStorage, "BootLock");
+        SequencerProgress = StaticRtos_CreateCounting(&SequencerProgressStorage, "BootProgress", BOOT_SEQUENCER_MAX_WORKERS * BOOT_SEQUENCER_MAX_STEPS, 0UL);
+        if ((NULL == SequencerLock) || (NULL == SequencerProgress))
+        {
+            return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    SequencerSteps = steps;
+    SequencerCount = count;
+    SequencerWorkers = workers;
+    SequencerDoneCallback = doneCallback;
+    FailedMask = 0UL;
+    FirstError = RETCODE_OK;
+
+    if (SequencerNextReady() >= count)
+    {
+        /* Every step already completed in an earlier run */
+        doneCallback(RETCODE_OK);
+        return RETCODE_OK;
+    }
+    IsRunning = true;
+    started = 0U;
+    for (worker = 0U; (worker < workers) && (worker < (uint8_t) BOOT_SEQUENCER_WORKER_STORAGE); worker++)
+    {
+        /* A worker of the previous run which did not end yet keeps its storage */
+        if (StaticRtos_ReclaimTask(&SequencerWorkerHandles[worker]))
+        {
+            SequencerWorkerHandles[worker] = StaticRtos_CreateTask(STATIC_RTOS_TASK_AT(SequencerWorkerStorage, worker), SequencerWorker, "Boot", NULL,
+                    TASK_PRIO_BOOT_WORKER);
+            if (NULL == SequencerWorkerHandles[worker])
+            {
+                break;
+            }
+            started++;
+        }
+    }
+    if (0U == started)
+    {
+        IsRunning = false;
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    /* With fewer workers than requested the boot is only less parallel */
+    return retcode;
+}
+
+/** Refer interface header for description */
+bool BootSequencer_IsDone(uint8_t step)
+{
+    return (step < BOOT_SEQUENCER_MAX_STEPS) && (0UL != (DoneMask & BOOT_SEQUENCER_STEP(step)));
+}
+
+/** Refer interface header for description */
+uint32_t BootSequencer_GetDurationMs(uint8_t step)
+{
+    return (step < BOOT_SEQUENCER_MAX_STEPS) ? DurationMs[step] : 0UL;
+}
+
+/** Refer interface header for description */
+void BootSequencer_PrintReport(void)
+{
+    uint32_t serialMs = 0UL;
+    uint8_t step;
+
+    for (step = 0U; step < SequencerCount; step++)
+    {
+        printf("BootSequencer : %-16s start %6lu ms took %6lu ms %s\r\n", SequencerSteps[step].Name,
+                (unsigned long) StartMs[step], (unsigned long) DurationMs[step],
+                (0UL != (DoneMask & BOOT_SEQUENCER_STEP(step))) ? "" :
+                        ((0UL != (FailedMask & BOOT_SEQUENCER_STEP(step))) ? "failed" : "blocked"));
+        serialMs += DurationMs[step];
+    }
+    printf("BootSequencer : boot took %lu ms, %lu ms of steps on %u workers\r\n", (unsigned long) FinishMs,
+            (unsigned long) serialMs, (unsigned int) SequencerWorkers);
+}
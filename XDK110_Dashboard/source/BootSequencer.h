@@ -0,0 +1,104 @@
+/**
+ *  @file
+ *
+ *  @brief Runs the application boot steps as a dependency graph on worker tasks.
+ *
+ *  Every step names the steps it depends on; a step may only depend on steps
+ *  listed before it, so the graph is acyclic by construction. Ready steps are
+ *  always started lowest index first, which keeps the start order the same
+ *  from boot to boot, while independent chains (e.g. sensor initialization
+ *  and the WLAN / SNTP bring-up) run concurrently on separate workers.
+ *
+ *  A step runs at most once: a completed step is never repeated, also not by
+ *  a second BootSequencer_Start, which only runs the steps that did not
+ *  complete yet (e.g. after a failure). A failed step blocks the steps
+ *  depending on it; the others still run.
+ *
+ *  Start time and duration of every step are recorded and printed at the end.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef BOOTSEQUENCER_H_
+#define BOOTSEQUENCER_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+/* local type and macro definitions */
+
+/** Maximum number of steps */
+#define BOOT_SEQUENCER_MAX_STEPS            UINT8_C(32)
+
+/** Maximum number of worker tasks */
+#define BOOT_SEQUENCER_MAX_WORKERS          UINT8_C(4)
+
+/** Dependency bit of a step, to be or-ed into DependsOn */
+#define BOOT_SEQUENCER_STEP(index)          (UINT32_C(1) << (uint32_t) (index))
+
+/**
+ * @brief Boot step function.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+typedef Retcode_T (*BootSequencer_StepFunc_T)(void);
+
+/**
+ * @brief Called once when no step is left to run.
+ *
+ * @param[in] retcode
+ * RETCODE_OK if every step completed, the error of the first failed step otherwise
+ */
+typedef void (*BootSequencer_DoneCallback_T)(Retcode_T retcode);
+
+/**
+ * @brief One boot step.
+ */
+struct BootSequencer_Step_S
+{
+    const char * Name;
+    uint32_t DependsOn; /**< BOOT_SEQUENCER_STEP() bits of the steps which must complete first */
+    BootSequencer_StepFunc_T Run;
+};
+typedef struct BootSequencer_Step_S BootSequencer_Step_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the worker tasks which run the steps not completed yet.
+ *
+ * The workers delete themselves once no step is left to run.
+ *
+ * @param[in] steps
+ * Step table, must stay valid
+ *
+ * @param[in] count
+ * Number of steps
+ *
+ * @param[in] workers
+ * Number of worker tasks, the number of steps running concurrently at most
+ *
+ * @param[in] doneCallback
+ * Called from a worker task when no step is left to run
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T BootSequencer_Start(const BootSequencer_Step_T * steps, uint8_t count, uint8_t workers, BootSequencer_DoneCallback_T doneCallback);
+
+/**
+ * @brief Returns whether a step completed successfully.
+ */
+bool BootSequencer_IsDone(uint8_t step);
+
+/**
+ * @brief Returns the run time of a completed or failed step in milliseconds.
+ */
+uint32_t BootSequencer_GetDurationMs(uint8_t step);
+
+/**
+ * @brief Prints start time and duration of every step, the boot time and the sum of all step durations.
+ */
+void BootSequencer_PrintReport(void);
+
+#endif /* BOOTSEQUENCER_H_ */
@@ -0,0 +1,275 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the minimal CoAP message parser and serializer.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "CoapMessage.h"
+
+/* system header files */
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define COAP_VERSION                UINT8_C(1)
+#define COAP_HEADER_SIZE            UINT16_C(4)
+#define COAP_PAYLOAD_MARKER         UINT8_C(0xFF)
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Decodes an option delta or length nibble with its extended bytes.
+ *
+ * @return false for the reserved nibble 15 or a truncated datagram.
+ */
+static bool ReadExtended(uint8_t nibble, const uint8_t * datagram, uint16_t length, uint16_t * position, uint16_t * value)
+{
+    if (nibble < 13U)
+    {
+        *value = nibble;
+    }
+    else if (13U == nibble)
+    {
+        if (*position >= length)
+        {
+            return false;
+        }
+        *value = (uint16_t) (datagram[*position] + 13U);
+        *position += 1U;
+    }
+    else if (14U == nibble)
+    {
+        if ((*position + 1U) >= length)
+        {
+            return false;
+        }
+        *value = (uint16_t) ((((uint16_t) datagram[*position] << 8) | datagram[*position + 1U]) + 269U);
+        *position += 2U;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+static uint8_t ExtendedNibble(uint16_t value)
+{
+    if (value < 13U)
+    {
+        return (uint8_t) value;
+    }
+    return (value < 269U) ? 13U : 14U;
+}
+
+static void WriteBytes(CoapMessage_Writer_T * writer, const void * data, uint16_t length)
+{
+    if ((writer->Overflow) || ((uint32_t) writer->Length + length > writer->Capacity))
+    {
+        writer->Overflow = true;
+        return;
+    }
+    if (0U != length)
+    {
+        memcpy(&writer->Buffer[writer->Length], data, length);
+    }
+    writer->Length += length;
+}
+
+static void WriteExtended(CoapMessage_Writer_T * writer, uint16_t value)
+{
+    uint8_t bytes[2];
+
+    if ((value >= 13U) && (value < 269U))
+    {
+        bytes[0] = (uint8_t) (value - 13U);
+        WriteBytes(writer, bytes, 1U);
+    }
+    else if (value >= 269U)
+    {
+        bytes[0] = (uint8_t) ((value - 269U) >> 8);
+        bytes[1] = (uint8_t) ((value - 269U) & 0xFFU);
+        WriteBytes(writer, bytes, 2U);
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool CoapMessage_Parse(CoapMessage_T * message, const uint8_t * datagram, uint16_t length)
+{
+    uint16_t position = COAP_HEADER_SIZE;
+    uint16_t optionNumber = 0U;
+    uint16_t delta;
+    uint16_t optionLength;
+
+    if ((NULL == message) || (NULL == datagram) || (length < COAP_HEADER_SIZE) || (COAP_VERSION != (datagram[0] >> 6)))
+    {
+        return false;
+    }
+    memset(message, 0, sizeof(*message));
+    message->Type = (CoapMessage_Type_T) ((datagram[0] >> 4) & 0x03U);
+    message->TokenLength = (uint8_t) (datagram[0] & 0x0FU);
+    message->Code = datagram[1];
+    message->MessageId = (uint16_t) (((uint16_t) datagram[2] << 8) | datagram[3]);
+    if ((message->TokenLength > COAP_MESSAGE_MAX_TOKEN_LENGTH) || ((position + message->TokenLength) > length))
+    {
+        return false;
+    }
+    memcpy(message->Token, &datagram[position], message->TokenLength);
+    position += message->TokenLength;
+
+    while (position < length)
+    {
+        uint8_t header = datagram[position++];
+
+        if (COAP_PAYLOAD_MARKER == header)
+        {
+            if (position >= length)
+            {
+                return false; /* marker followed by an empty payload is a format error */
+            }
+            message->Payload = &datagram[position];
+            message->PayloadLength = (uint16_t) (length - position);
+            break;
+        }
+        if (!ReadExtended((uint8_t) (header >> 4), datagram, length, &position, &delta) ||
+                !ReadExtended((uint8_t) (header & 0x0FU), datagram, length, &position, &optionLength) ||
+                ((uint32_t) position + optionLength > length))
+        {
+            return false;
+        }
+        optionNumber = (uint16_t) (optionNumber + delta);
+        if (message->OptionCount < COAP_MESSAGE_MAX_OPTIONS)
+        {
+            message->Options[message->OptionCount].Number = optionNumber;
+            message->Options[message->OptionCount].Length = optionLength;
+            message->Options[message->OptionCount].Value = &datagram[position];
+            message->OptionCount++;
+        }
+        position = (uint16_t) (position + optionLength);
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+const CoapMessage_Option_T * CoapMessage_FindOption(const CoapMessage_T * message, uint16_t number, const CoapMessage_Option_T * previous)
+{
+    uint8_t index = 0U;
+
+    if (NULL == message)
+    {
+        return NULL;
+    }
+    if (NULL != previous)
+    {
+        index = (uint8_t) ((previous - message->Options) + 1);
+    }
+    for (; index < message->OptionCount; index++)
+    {
+        if (number == message->Options[index].Number)
+        {
+            return &message->Options[index];
+        }
+    }
+    return NULL;
+}
+
+/** Refer interface header for description */
+uint32_t CoapMessage_GetUintOption(const CoapMessage_Option_T * option)
+{
+    uint32_t value = 0UL;
+    uint16_t index;
+
+    if (NULL == option)
+    {
+        return 0UL;
+    }
+    for (index = 0U; (index < option->Length) && (index < 4U); index++)
+    {
+        value = (value << 8) | option->Value[index];
+    }
+    return value;
+}
+
+/** Refer interface header for description */
+void CoapMessage_Begin(CoapMessage_Writer_T * writer, uint8_t * buffer, uint16_t capacity, CoapMessage_Type_T type,
+        uint8_t code, uint16_t messageId, const uint8_t * token, uint8_t tokenLength)
+{
+    uint8_t header[COAP_HEADER_SIZE];
+
+    writer->Buffer = buffer;
+    writer->Capacity = capacity;
+    writer->Length = 0U;
+    writer->LastOption = 0U;
+    writer->Overflow = (tokenLength > COAP_MESSAGE_MAX_TOKEN_LENGTH);
+
+    header[0] = (uint8_t) ((COAP_VERSION << 6) | (((uint8_t) type & 0x03U) << 4) | (tokenLength & 0x0FU));
+    header[1] = code;
+    header[2] = (uint8_t) (messageId >> 8);
+    header[3] = (uint8_t) (messageId & 0xFFU);
+    WriteBytes(writer, header, sizeof(header));
+    WriteBytes(writer, token, tokenLength);
+}
+
+/** Refer interface header for description */
+void CoapMessage_AddOption(CoapMessage_Writer_T * writer, uint16_t number, const void * value, uint16_t length)
+{
+    uint16_t delta;
+    uint8_t header;
+
+    if (number < writer->LastOption)
+    {
+        writer->Overflow = true;
+        return;
+    }
+    delta = (uint16_t) (number - writer->LastOption);
+    header = (uint8_t) ((ExtendedNibble(delta) << 4) | ExtendedNibble(length));
+    WriteBytes(writer, &header, 1U);
+    WriteExtended(writer, delta);
+    WriteExtended(writer, length);
+    WriteBytes(writer, value, length);
+    writer->LastOption = number;
+}
+
+/** Refer interface header for description */
+void CoapMessage_AddUintOption(CoapMessage_Writer_T * writer, uint16_t number, uint32_t value)
+{
+    uint8_t bytes[4];
+    uint16_t length = 0U;
+    int8_t shift;
+
+    for (shift = 24; shift >= 0; shift -= 8)
+    {
+        uint8_t byte = (uint8_t) ((value >> shift) & 0xFFU);
+        if ((0U != length) || (0U != byte))
+        {
+            bytes[length++] = byte;
+        }
+    }
+    CoapMessage_AddOption(writer, number, bytes, length);
+}
+
+/** Refer interface header for description */
+void CoapMessage_AddPayload(CoapMessage_Writer_T * writer, const void * payload, uint16_t length)
+{
+    uint8_t marker = COAP_PAYLOAD_MARKER;
+
+    if (0U == length)
+    {
+        return;
+    }
+    WriteBytes(writer, &marker, 1U);
+    WriteBytes(writer, payload, length);
+    writer->LastOption = UINT16_MAX;
+}
+
+/** Refer interface header for description */
+uint16_t CoapMessage_End(const CoapMessage_Writer_T * writer)
+{
+    return (writer->Overflow) ? 0U : writer->Length;
+}
@@ -0,0 +1,206 @@
+/**
+ *  @file
+ *
+ *  @brief Minimal CoAP (RFC 7252) message parser and serializer.
+ *
+ *  Only what the LWM2M observe client needs: header, token, options in
+ *  ascending order and payload. The parsed message points into the datagram,
+ *  nothing is copied or allocated.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef COAPMESSAGE_H_
+#define COAPMESSAGE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* local type and macro definitions */
+
+/** Maximum number of options kept while parsing a message */
+#define COAP_MESSAGE_MAX_OPTIONS            UINT8_C(16)
+
+/** Maximum token length allowed by RFC 7252 */
+#define COAP_MESSAGE_MAX_TOKEN_LENGTH       UINT8_C(8)
+
+/** Builds a CoAP code from its class and detail, e.g. COAP_CODE(2, 5) for 2.05 */
+#define COAP_CODE(codeClass, detail)        ((uint8_t) (((codeClass) << 5) | (detail)))
+
+#define COAP_CODE_EMPTY                     COAP_CODE(0, 0)
+#define COAP_CODE_GET                       COAP_CODE(0, 1)
+#define COAP_CODE_POST                      COAP_CODE(0, 2)
+#define COAP_CODE_PUT                       COAP_CODE(0, 3)
+#define COAP_CODE_DELETE                    COAP_CODE(0, 4)
+#define COAP_CODE_CREATED                   COAP_CODE(2, 1)
+#define COAP_CODE_DELETED                   COAP_CODE(2, 2)
+#define COAP_CODE_CHANGED                   COAP_CODE(2, 4)
+#define COAP_CODE_CONTENT                   COAP_CODE(2, 5)
+#define COAP_CODE_BAD_REQUEST               COAP_CODE(4, 0)
+#define COAP_CODE_NOT_FOUND                 COAP_CODE(4, 4)
+#define COAP_CODE_METHOD_NOT_ALLOWED        COAP_CODE(4, 5)
+#define COAP_CODE_NOT_ACCEPTABLE            COAP_CODE(4, 6)
+
+#define COAP_OPTION_OBSERVE                 UINT16_C(6)
+#define COAP_OPTION_LOCATION_PATH           UINT16_C(8)
+#define COAP_OPTION_URI_PATH                UINT16_C(11)
+#define COAP_OPTION_CONTENT_FORMAT          UINT16_C(12)
+#define COAP_OPTION_URI_QUERY               UINT16_C(15)
+#define COAP_OPTION_ACCEPT                  UINT16_C(17)
+
+#define COAP_FORMAT_TEXT_PLAIN              UINT16_C(0)
+#define COAP_FORMAT_LINK_FORMAT             UINT16_C(40)
+#define COAP_FORMAT_LWM2M_TLV               UINT16_C(11542)
+
+/**
+ * @brief CoAP message types.
+ */
+enum CoapMessage_Type_E
+{
+    COAP_TYPE_CON = 0,
+    COAP_TYPE_NON = 1,
+    COAP_TYPE_ACK = 2,
+    COAP_TYPE_RST = 3,
+};
+typedef enum CoapMessage_Type_E CoapMessage_Type_T;
+
+/**
+ * @brief One option of a parsed message.
+ */
+struct CoapMessage_Option_S
+{
+    uint16_t Number;
+    uint16_t Length;
+    const uint8_t * Value;
+};
+typedef struct CoapMessage_Option_S CoapMessage_Option_T;
+
+/**
+ * @brief A parsed CoAP message.
+ */
+struct CoapMessage_S
+{
+    CoapMessage_Type_T Type;
+    uint8_t Code;
+    uint16_t MessageId;
+    uint8_t TokenLength;
+    uint8_t Token[COAP_MESSAGE_MAX_TOKEN_LENGTH];
+    uint8_t OptionCount;
+    CoapMessage_Option_T Options[COAP_MESSAGE_MAX_OPTIONS];
+    const uint8_t * Payload;
+    uint16_t PayloadLength;
+};
+typedef struct CoapMessage_S CoapMessage_T;
+
+/**
+ * @brief Serializer state writing into a caller owned datagram buffer.
+ *
+ * Options must be added in ascending option number order.
+ */
+struct CoapMessage_Writer_S
+{
+    uint8_t * Buffer;
+    uint16_t Capacity;
+    uint16_t Length;
+    uint16_t LastOption;
+    bool Overflow; /**< Set once anything did not fit; the datagram must then be discarded */
+};
+typedef struct CoapMessage_Writer_S CoapMessage_Writer_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Parses a datagram.
+ *
+ * @param[out] message
+ * Parsed message, pointing into datagram
+ *
+ * @param[in] datagram
+ * Received datagram
+ *
+ * @param[in] length
+ * Size of the datagram in bytes
+ *
+ * @return true if the datagram is a well formed CoAP message.
+ */
+bool CoapMessage_Parse(CoapMessage_T * message, const uint8_t * datagram, uint16_t length);
+
+/**
+ * @brief Returns the next option with the given number.
+ *
+ * @param[in] message
+ * Parsed message
+ *
+ * @param[in] number
+ * Option number to look for
+ *
+ * @param[in] previous
+ * Option returned by the previous call to iterate repeatable options, NULL to start
+ *
+ * @return The option, NULL if there is no (further) option with that number.
+ */
+const CoapMessage_Option_T * CoapMessage_FindOption(const CoapMessage_T * message, uint16_t number, const CoapMessage_Option_T * previous);
+
+/**
+ * @brief Returns the value of an unsigned integer option.
+ *
+ * @param[in] option
+ * Option as returned by CoapMessage_FindOption
+ *
+ * @return Option value, 0 for an empty option.
+ */
+uint32_t CoapMessage_GetUintOption(const CoapMessage_Option_T * option);
+
+/**
+ * @brief Starts a message.
+ *
+ * @param[out] writer
+ * Serializer state
+ *
+ * @param[in] buffer
+ * Datagram buffer
+ *
+ * @param[in] capacity
+ * Size of the datagram buffer
+ *
+ * @param[in] type
+ * Message type
+ *
+ * @param[in] code
+ * Message code
+ *
+ * @param[in] messageId
+ * Message ID
+ *
+ * @param[in] token
+ * Token bytes, may be NULL if tokenLength is 0
+ *
+ * @param[in] tokenLength
+ * Token length (0 .. COAP_MESSAGE_MAX_TOKEN_LENGTH)
+ */
+void CoapMessage_Begin(CoapMessage_Writer_T * writer, uint8_t * buffer, uint16_t capacity, CoapMessage_Type_T type,
+        uint8_t code, uint16_t messageId, const uint8_t * token, uint8_t tokenLength);
+
+/**
+ * @brief Adds an opaque or string option.
+ */
+void CoapMessage_AddOption(CoapMessage_Writer_T * writer, uint16_t number, const void * value, uint16_t length);
+
+/**
+ * @brief Adds an unsigned integer option in its shortest encoding.
+ */
+void CoapMessage_AddUintOption(CoapMessage_Writer_T * writer, uint16_t number, uint32_t value);
+
+/**
+ * @brief Adds the payload marker and the payload; no option may follow.
+ */
+void CoapMessage_AddPayload(CoapMessage_Writer_T * writer, const void * payload, uint16_t length);
+
+/**
+ * @brief Returns the datagram length, 0 if the message did not fit into the buffer.
+ */
+uint16_t CoapMessage_End(const CoapMessage_Writer_T * writer);
+
+#endif /* COAPMESSAGE_H_ */
@@ -0,0 +1,225 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the configuration agent.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_CONFIG_AGENT
+
+#include "ConfigAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "HttpsAgent.h"
+#include "simplelink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* constant definitions ***************************************************** */
+
+/** File content: document length (16 bit little endian), ETag padded with zeros, document */
+#define CONFIG_AGENT_DOCUMENT_OFFSET    (2UL + HTTP_MESSAGE_MAX_ETAG)
+
+#define CONFIG_AGENT_FILE_SIZE          (CONFIG_AGENT_DOCUMENT_OFFSET + REMOTE_CONFIG_MAX_DOCUMENT)
+
+/* local variables ********************************************************** */
+
+static const ConfigAgent_Setup_T * AgentSetup = NULL;
+
+static RemoteConfig_T AgentConfig; /**< Settings in effect, all 0 for the built in ones */
+
+static char AgentETag[HTTP_MESSAGE_MAX_ETAG]; /**< Of the last document received, applied or not */
+
+static char AgentHeaders[sizeof("If-None-Match: \r\n") + HTTP_MESSAGE_MAX_ETAG];
+
+static uint8_t AgentFile[CONFIG_AGENT_FILE_SIZE + 1UL]; /**< File image; the received body lands at its document, one byte more detects a too long one */
+
+static bool AgentIsPolled = false;
+
+static uint32_t AgentLastPollMs = 0UL;
+
+static HttpsSession_Request_T AgentRequest =
+        {
+                .Method = "GET",
+                .Path = NULL,
+                .ContentType = NULL,
+                .ExtraHeaders = NULL,
+                .Body = NULL,
+                .BodyLength = 0UL,
+        };
+
+static HttpsSession_Response_T AgentResponse =
+        {
+                .Body = &AgentFile[CONFIG_AGENT_DOCUMENT_OFFSET],
+                .BodySize = REMOTE_CONFIG_MAX_DOCUMENT + 1UL,
+        };
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Validates the document at AgentFile and applies it.
+ *
+ * @param[out] changed
+ * REMOTE_CONFIG_CHANGED_ bits against the settings in effect before
+ *
+ * @return false if the document was rejected.
+ */
+static bool AgentApply(uint32_t length, const char * source, uint32_t * changed)
+{
+    RemoteConfig_T config;
+    uint16_t errorLine = 0U;
+
+    if ((length > REMOTE_CONFIG_MAX_DOCUMENT) ||
+            !RemoteConfig_Parse((const char *) &AgentFile[CONFIG_AGENT_DOCUMENT_OFFSET], length, &config, &errorLine))
+    {
+        printf("ConfigAgent : Document from %s rejected at line %u \r\n", source, (unsigned int) errorLine);
+        return false;
+    }
+    *changed = RemoteConfig_Compare(&AgentConfig, &config);
+    if (0UL != *changed)
+    {
+        AgentConfig = config;
+        printf("ConfigAgent : Version %lu from %s, changes 0x%02lx \r\n", (unsigned long) config.Version, source, (unsigned long) *changed);
+        AgentSetup->ApplyCB(&AgentConfig, *changed);
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the document of a previous run and applies it.
+ */
+static void AgentLoadFile(void)
+{
+    _i32 fileHandle = -1;
+    _i32 length;
+    uint32_t documentLength;
+    uint32_t changed = 0UL;
+
+    if ((NULL == AgentSetup->FileName) || (0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_READ, NULL, &fileHandle)))
+    {
+        return; /* First start */
+    }
+    length = sl_FsRead(fileHandle, 0UL, AgentFile, CONFIG_AGENT_FILE_SIZE);
+    (void) sl_FsClose(fileHandle, NULL, NULL, 0UL);
+    if (length < (_i32) CONFIG_AGENT_DOCUMENT_OFFSET)
+    {
+        return;
+    }
+    documentLength = (uint32_t) AgentFile[0] | ((uint32_t) AgentFile[1] << 8);
+    if ((documentLength > REMOTE_CONFIG_MAX_DOCUMENT) || ((uint32_t) length < (CONFIG_AGENT_DOCUMENT_OFFSET + documentLength)) ||
+            ('\0' != AgentFile[CONFIG_AGENT_DOCUMENT_OFFSET - 1UL]))
+    {
+        printf("ConfigAgent : %s is damaged \r\n", AgentSetup->FileName);
+        return;
+    }
+    if (AgentApply(documentLength, AgentSetup->FileName, &changed))
+    {
+        memcpy(AgentETag, &AgentFile[2], sizeof(AgentETag));
+    }
+}
+
+/**
+ * @brief Writes the applied document at AgentFile with its ETag.
+ */
+static void AgentSaveFile(uint32_t documentLength)
+{
+    _i32 fileHandle = -1;
+
+    if (NULL == AgentSetup->FileName)
+    {
+        return;
+    }
+    AgentFile[0] = (uint8_t) documentLength;
+    AgentFile[1] = (uint8_t) (documentLength >> 8);
+    memcpy(&AgentFile[2], AgentETag, sizeof(AgentETag));
+    if ((0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_WRITE, NULL, &fileHandle)) &&
+            (0 > sl_FsOpen((_u8 *) AgentSetup->FileName, FS_MODE_OPEN_CREATE(CONFIG_AGENT_FILE_SIZE, _FS_FILE_OPEN_FLAG_COMMIT | _FS_FILE_PUBLIC_WRITE),
+                    NULL, &fileHandle)))
+    {
+        printf("ConfigAgent : Cannot open %s \r\n", AgentSetup->FileName);
+        return;
+    }
+    if (0 > sl_FsWrite(fileHandle, 0UL, AgentFile, CONFIG_AGENT_DOCUMENT_OFFSET + documentLength))
+    {
+        printf("ConfigAgent : Writing %s failed \r\n", AgentSetup->FileName);
+    }
+    (void) sl_FsClose(fileHandle, NULL, NULL, 0UL);
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T ConfigAgent_Setup(const ConfigAgent_Setup_T * setup)
+{
+    if ((NULL == setup) || (NULL == setup->Path) || (NULL == setup->ApplyCB))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    AgentSetup = setup;
+    AgentRequest.Path = setup->Path;
+    AgentLoadFile();
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T ConfigAgent_Poll(void)
+{
+    Retcode_T retcode;
+    uint32_t changed = 0UL;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if (AgentIsPolled && ((AgentNowMs() - AgentLastPollMs) < AgentSetup->PollIntervalMs))
+    {
+        return RETCODE_OK;
+    }
+    AgentIsPolled = true;
+    AgentLastPollMs = AgentNowMs();
+
+    (void) snprintf(AgentHeaders, sizeof(AgentHeaders), "If-None-Match: %s\r\n", AgentETag);
+    AgentRequest.ExtraHeaders = ('\0' != AgentETag[0]) ? AgentHeaders : NULL;
+    retcode = HttpsAgent_Request(&AgentRequest, &AgentResponse);
+    if (304U == AgentResponse.Status)
+    {
+        return RETCODE_OK;
+    }
+    if (RETCODE_OK != retcode)
+    {
+        printf("ConfigAgent : GET %s failed with status %u \r\n", AgentSetup->Path, (unsigned int) AgentResponse.Status);
+        return retcode;
+    }
+    memcpy(AgentETag, AgentResponse.ETag, sizeof(AgentETag));
+    if (!AgentApply(AgentResponse.BodyLength, AgentSetup->Path, &changed))
+    {
+        return RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_INVALID_PARAM);
+    }
+    /* Without an ETag every poll downloads the document again; the flash is only written when it changed */
+    if (0UL != changed)
+    {
+        AgentSaveFile(AgentResponse.BodyLength);
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+const RemoteConfig_T * ConfigAgent_GetConfig(void)
+{
+    return &AgentConfig;
+}
@@ -0,0 +1,81 @@
+/**
+ *  @file
+ *
+ *  @brief Keeps the RemoteConfig document of the upload server on the XDK.
+ *
+ *  ConfigAgent_Poll fetches the document with a conditional GET through the
+ *  HttpsAgent, on the connection the posts keep open: the ETag of the last
+ *  document goes out in If-None-Match, so an unchanged document costs a
+ *  304 without body. A new document is validated with RemoteConfig_Parse;
+ *  a valid one is written with its ETag to a file of the WLAN chip and
+ *  handed to ApplyCB with the settings that changed, a rejected one is
+ *  reported and keeps the current settings. Its ETag is still remembered
+ *  in RAM, so the same broken document is not downloaded again every poll.
+ *
+ *  ConfigAgent_Setup reads the stored document and applies it, so a device
+ *  restarts with its last configuration before the server is reachable.
+ *
+ *  All functions are called from the task which posts through the HttpsAgent;
+ *  ApplyCB runs in that task too.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef CONFIGAGENT_H_
+#define CONFIGAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "RemoteConfig.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Applies the settings; changed holds the REMOTE_CONFIG_CHANGED_ bits
+ * against the previous ones. config stays valid until the next call.
+ */
+typedef void (*ConfigAgent_ApplyCB_T)(const RemoteConfig_T * config, uint32_t changed);
+
+/**
+ * @brief Agent configuration.
+ */
+struct ConfigAgent_Setup_S
+{
+    const char * Path; /**< Path of the document on the server of the HttpsAgent */
+    const char * FileName; /**< File of the WLAN chip keeping the last valid document, NULL for none */
+    uint32_t PollIntervalMs; /**< Shortest time between two fetches */
+    ConfigAgent_ApplyCB_T ApplyCB;
+};
+typedef struct ConfigAgent_Setup_S ConfigAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Stores the configuration and applies the stored document, if any.
+ *
+ * Requires the WLAN chip to be started; the HttpsAgent need not be set up yet.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T ConfigAgent_Setup(const ConfigAgent_Setup_T * setup);
+
+/**
+ * @brief Fetches the document if PollIntervalMs passed since the last fetch,
+ * and applies it if it changed.
+ *
+ * @return  RETCODE_OK if the document was not due, unchanged or applied, an
+ * error code for a failed request or a rejected document.
+ */
+Retcode_T ConfigAgent_Poll(void);
+
+/**
+ * @brief Returns the settings in effect.
+ */
+const RemoteConfig_T * ConfigAgent_GetConfig(void);
+
+#endif /* CONFIGAGENT_H_ */
@@ -0,0 +1,303 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the multi-rate decimation filters.
+ *
+ *  The FIR filter of a stage is designed at the rate of its input, the CIC
+ *  output: the desired response is the inverse of the CIC droop up to the
+ *  middle between the passband edge fp and the stopband edge 1/D - fp, the
+ *  lowest frequency which aliases onto fp, and 0 above. Its inverse
+ *  transform, integrated with the midpoint rule over
+ *  DECIMATION_FILTER_DESIGN_POINTS frequencies, is tapered with a Blackman
+ *  window, which spreads the edge over the transition band. The quantized
+ *  sum of the coefficients is corrected on the center tap, so the DC gain is
+ *  1 up to the rounding of the samples.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "DecimationFilter.h"
+
+/* system header files */
+#include <math.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define DECIMATION_FILTER_PI    3.14159265f
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Returns the CIC response at frequency f of its output rate, normalized to 1 at DC.
+ */
+static float DecimationFilterCicResponse(uint8_t factor, float f)
+{
+    float comb;
+    float response = 1.0f;
+    uint8_t order;
+
+    if ((1U == factor) || (f <= 0.0f))
+    {
+        return 1.0f;
+    }
+    comb = fabsf(sinf(DECIMATION_FILTER_PI * f) / ((float) factor * sinf(DECIMATION_FILTER_PI * f / (float) factor)));
+    for (order = 0U; order < DECIMATION_FILTER_CIC_ORDER; order++)
+    {
+        response *= comb;
+    }
+    return response;
+}
+
+/**
+ * @brief Returns the desired FIR response at frequency f of its input rate.
+ *
+ * @param[in] gain
+ * CIC gain left after its shift, made up for by the FIR
+ */
+static float DecimationFilterDesired(const DecimationFilter_StageSetup_T * setup, float gain, float f)
+{
+    float passband = (0.5f / (float) setup->FirFactor) * ((float) setup->PassbandPercent / 100.0f);
+    float stopband = fminf((1.0f / (float) setup->FirFactor) - passband, 0.5f);
+
+    if (f >= ((passband + stopband) / 2.0f))
+    {
+        return 0.0f;
+    }
+    return 1.0f / (gain * DecimationFilterCicResponse(setup->CicFactor, f));
+}
+
+static bool DecimationFilterDesignStage(DecimationFilter_Stage_T * stage, uint8_t inputBits)
+{
+    const DecimationFilter_StageSetup_T * setup = &stage->Setup;
+    uint32_t cicGain = 1UL;
+    uint8_t taps = setup->FirTaps;
+    uint8_t center = (uint8_t) (taps / 2U);
+    float coefficients[DECIMATION_FILTER_MAX_TAPS];
+    float gain;
+    float sum = 0.0f;
+    int32_t quantizedSum = 0L;
+    uint32_t point;
+    uint8_t order;
+    uint8_t tap;
+
+    if ((0U == setup->CicFactor) || (setup->CicFactor > DECIMATION_FILTER_MAX_CIC_FACTOR) ||
+            (0U == setup->FirFactor) || (setup->FirFactor > DECIMATION_FILTER_MAX_FIR_FACTOR) ||
+            (taps < 3U) || (taps > DECIMATION_FILTER_MAX_TAPS) || (0U == (taps & 1U)) ||
+            (setup->PassbandPercent < 10U) || (setup->PassbandPercent > 90U))
+    {
+        return false;
+    }
+    for (order = 0U; order < DECIMATION_FILTER_CIC_ORDER; order++)
+    {
+        cicGain *= setup->CicFactor;
+    }
+    stage->CicShift = 0U;
+    while ((UINT32_C(1) << stage->CicShift) < cicGain)
+    {
+        stage->CicShift++;
+    }
+    /* One bit more for the overshoot of the FIR of the previous stage */
+    if (((uint32_t) inputBits + 1UL + stage->CicShift) > 32UL)
+    {
+        return false;
+    }
+    gain = (float) cicGain / (float) (UINT32_C(1) << stage->CicShift);
+
+    /* Symmetric taps, computed once for both halves */
+    for (tap = 0U; tap <= center; tap++)
+    {
+        float value = 0.0f;
+        float distance = (float) center - (float) tap;
+
+        for (point = 0UL; point < DECIMATION_FILTER_DESIGN_POINTS; point++)
+        {
+            float f = ((float) point + 0.5f) * (0.5f / (float) DECIMATION_FILTER_DESIGN_POINTS);
+
+            value += DecimationFilterDesired(setup, gain, f) * cosf(2.0f * DECIMATION_FILTER_PI * f * distance);
+        }
+        value *= 1.0f / (float) DECIMATION_FILTER_DESIGN_POINTS;
+        value *= 0.42f - (0.5f * cosf(2.0f * DECIMATION_FILTER_PI * ((float) tap + 1.0f) / ((float) taps + 1.0f))) +
+                (0.08f * cosf(4.0f * DECIMATION_FILTER_PI * ((float) tap + 1.0f) / ((float) taps + 1.0f)));
+        coefficients[tap] = value;
+        coefficients[taps - 1U - tap] = value;
+    }
+    for (tap = 0U; tap < taps; tap++)
+    {
+        sum += coefficients[tap];
+    }
+    (void) memset(stage->Coefficients, 0, sizeof(stage->Coefficients));
+    for (tap = 0U; tap < taps; tap++)
+    {
+        stage->Coefficients[tap] = (int32_t) lroundf(coefficients[tap] / (sum * gain) * (float) (INT32_C(1) << DECIMATION_FILTER_COEFFICIENT_BITS));
+        quantizedSum += stage->Coefficients[tap];
+    }
+    stage->Coefficients[center] += (int32_t) lroundf((float) (INT32_C(1) << DECIMATION_FILTER_COEFFICIENT_BITS) / gain) - quantizedSum;
+    return true;
+}
+
+/**
+ * @brief Runs a block through a stage.
+ *
+ * @return Output samples written.
+ */
+static uint32_t DecimationFilterRunStage(const DecimationFilter_Stage_T * stage, DecimationFilter_StageState_T * state, int32_t offset,
+        const int32_t * input, uint32_t count, int32_t * output)
+{
+    const int32_t * coefficients = stage->Coefficients;
+    uint8_t cicFactor = stage->Setup.CicFactor;
+    uint8_t firFactor = stage->Setup.FirFactor;
+    uint8_t taps = stage->Setup.FirTaps;
+    uint32_t cicRounding = (0U == stage->CicShift) ? 0UL : (UINT32_C(1) << (stage->CicShift - 1U));
+    uint32_t written = 0UL;
+    uint32_t index;
+    uint8_t order;
+    uint8_t tap;
+
+    for (index = 0UL; index < count; index++)
+    {
+        uint32_t value = (uint32_t) (input[index] - offset);
+        const int32_t * delay;
+        int64_t sum = 0LL;
+
+        if (cicFactor > 1U)
+        {
+            for (order = 0U; order < DECIMATION_FILTER_CIC_ORDER; order++)
+            {
+                value += state->Integrators[order];
+                state->Integrators[order] = value;
+            }
+            state->CicPhase++;
+            if (state->CicPhase < cicFactor)
+            {
+                continue;
+            }
+            state->CicPhase = 0U;
+            for (order = 0U; order < DECIMATION_FILTER_CIC_ORDER; order++)
+            {
+                uint32_t previous = state->Combs[order];
+
+                state->Combs[order] = value;
+                value -= previous;
+            }
+            /* Modulo 2^32 the comb output is exact, as signed it is at most InputBits + CicShift wide */
+            value = (uint32_t) ((int32_t) (value + cicRounding) >> stage->CicShift);
+        }
+
+        if (0U == state->DelayIndex)
+        {
+            state->DelayIndex = taps;
+        }
+        state->DelayIndex--;
+        state->Delay[state->DelayIndex] = (int32_t) value;
+        state->Delay[state->DelayIndex + taps] = (int32_t) value;
+        state->FirPhase++;
+        if (state->FirPhase < firFactor)
+        {
+            continue;
+        }
+        state->FirPhase = 0U;
+
+        delay = &state->Delay[state->DelayIndex];
+        for (tap = 0U; tap < taps; tap++)
+        {
+            sum += (int64_t) coefficients[tap] * delay[tap];
+        }
+        output[written] = (int32_t) ((sum + (INT64_C(1) << (DECIMATION_FILTER_COEFFICIENT_BITS - 1U))) >> DECIMATION_FILTER_COEFFICIENT_BITS) +
+                offset;
+        written++;
+    }
+    return written;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool DecimationFilter_Design(DecimationFilter_Bank_T * bank, const DecimationFilter_Setup_T * setup)
+{
+    uint32_t factor = 1UL;
+    uint8_t stage;
+
+    if ((NULL == bank) || (NULL == setup) || (0U == setup->Stages) || (setup->Stages > DECIMATION_FILTER_MAX_STAGES) ||
+            (setup->InputBits < 2U) || (setup->InputBits > 31U))
+    {
+        return false;
+    }
+    (void) memset(bank, 0, sizeof(*bank));
+    bank->Stages = setup->Stages;
+    for (stage = 0U; stage < setup->Stages; stage++)
+    {
+        bank->Stage[stage].Setup = setup->Stage[stage];
+        if (!DecimationFilterDesignStage(&bank->Stage[stage], setup->InputBits))
+        {
+            return false;
+        }
+        factor *= (uint32_t) setup->Stage[stage].CicFactor * setup->Stage[stage].FirFactor;
+        bank->Factors[stage] = factor;
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+bool DecimationFilter_Reset(DecimationFilter_Channel_T * channel, const DecimationFilter_Bank_T * bank, int32_t offset)
+{
+    if ((NULL == channel) || (NULL == bank) || (0U == bank->Stages))
+    {
+        return false;
+    }
+    (void) memset(channel, 0, sizeof(*channel));
+    channel->Bank = bank;
+    channel->Offset = offset;
+    return true;
+}
+
+/** Refer interface header for description */
+bool DecimationFilter_Process(DecimationFilter_Channel_T * channel, const int32_t * input, uint32_t count, int32_t * const * outputs, uint32_t * counts)
+{
+    const DecimationFilter_Bank_T * bank;
+    uint8_t stage;
+
+    if ((NULL == channel) || (NULL == channel->Bank) || (NULL == input) || (NULL == outputs) || (NULL == counts))
+    {
+        return false;
+    }
+    bank = channel->Bank;
+    for (stage = 0U; stage < bank->Stages; stage++)
+    {
+        if (NULL == outputs[stage])
+        {
+            return false;
+        }
+    }
+    for (stage = 0U; stage < bank->Stages; stage++)
+    {
+        counts[stage] = DecimationFilterRunStage(&bank->Stage[stage], &channel->Stage[stage], channel->Offset, input, count, outputs[stage]);
+        input = outputs[stage];
+        count = counts[stage];
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+float DecimationFilter_GetDelay(const DecimationFilter_Bank_T * bank, uint8_t stage)
+{
+    float delay = 0.0f;
+    uint32_t factor = 1UL;
+    uint8_t index;
+
+    if ((NULL == bank) || (stage >= bank->Stages))
+    {
+        return 0.0f;
+    }
+    for (index = 0U; index <= stage; index++)
+    {
+        const DecimationFilter_StageSetup_T * setup = &bank->Stage[index].Setup;
+
+        delay += (float) factor * (((float) DECIMATION_FILTER_CIC_ORDER * (float) (setup->CicFactor - 1U) / 2.0f) +
+                ((float) setup->CicFactor * (float) (setup->FirTaps - 1U) / 2.0f));
+        factor = bank->Factors[index];
+    }
+    return delay;
+}
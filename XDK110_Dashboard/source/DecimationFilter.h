@@ -0,0 +1,203 @@
+/**
+ *  @file
+ *
+ *  @brief Fixed-point multi-rate decimation filters: one fast input stream per
+ *  channel, several anti-aliased output streams at lower rates.
+ *
+ *  A filter is a cascade of stages. Each stage decimates by its CIC factor R
+ *  with a CIC filter of order DECIMATION_FILTER_CIC_ORDER, then by its FIR
+ *  factor D with a linear phase FIR filter which flattens the droop of the
+ *  CIC in the passband and removes what the CIC lets through above it. Every
+ *  stage delivers its output, which is the input of the next one; e.g. 100 Hz
+ *  reads through the stages {5, 2} and {5, 2} give 10 Hz and 1 Hz.
+ *
+ *  The passband of a stage is PassbandPercent of the Nyquist frequency of its
+ *  output. Input frequencies which alias into it are attenuated; the ones
+ *  which alias into the transition band up to the output Nyquist frequency
+ *  are not, as with every decimator. Tools/DecimationBench measures the
+ *  response of a design against its model.
+ *
+ *  The design (DecimationFilter_Bank_T) is computed once in float and shared
+ *  by the channels, which only hold their delay lines. The processing is
+ *  integer only: the CIC works modulo 2^32, which is exact as long as its
+ *  output fits, and the FIR multiplies with Q24 coefficients into 64 bit.
+ *  The DC gain of every output is 1. An output lags its input by the group
+ *  delay of the stages, DecimationFilter_GetDelay.
+ *
+ *  Samples are processed a block at a time, stage by stage, so the inner
+ *  loops run over arrays. The input minus the offset of
+ *  DecimationFilter_Reset must stay within InputBits.
+ *
+ *  Pure C, no RTOS or platform dependency: also compiles on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DECIMATIONFILTER_H_
+#define DECIMATIONFILTER_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Most stages, i.e. outputs, of a filter */
+#define DECIMATION_FILTER_MAX_STAGES        UINT8_C(3)
+
+/** Most taps of the FIR filter of a stage; a stage holds twice as many samples */
+#define DECIMATION_FILTER_MAX_TAPS          UINT8_C(31)
+
+/** Integrators and combs of a CIC filter */
+#define DECIMATION_FILTER_CIC_ORDER         UINT8_C(4)
+
+/** Highest CIC factor, its gain of up to 2^20 takes that many bits of headroom */
+#define DECIMATION_FILTER_MAX_CIC_FACTOR    UINT8_C(32)
+
+/** Highest FIR factor */
+#define DECIMATION_FILTER_MAX_FIR_FACTOR    UINT8_C(4)
+
+/** Fraction bits of the FIR coefficients */
+#define DECIMATION_FILTER_COEFFICIENT_BITS  UINT8_C(24)
+
+/** Frequencies the FIR design integrates the desired response over */
+#define DECIMATION_FILTER_DESIGN_POINTS     UINT32_C(128)
+
+/** Capacity of an output buffer of DecimationFilter_Process, for count input samples and the factor of its stage */
+#define DECIMATION_FILTER_OUTPUT_LENGTH(count, factor)  (((count) / (factor)) + UINT32_C(1))
+
+/**
+ * @brief Configuration of a stage.
+ */
+struct DecimationFilter_StageSetup_S
+{
+    uint8_t CicFactor; /**< R, 1 (no CIC) to DECIMATION_FILTER_MAX_CIC_FACTOR */
+    uint8_t FirFactor; /**< D, 1 to DECIMATION_FILTER_MAX_FIR_FACTOR */
+    uint8_t FirTaps; /**< Odd, 3 to DECIMATION_FILTER_MAX_TAPS */
+    uint8_t PassbandPercent; /**< Passband edge in percent of the output Nyquist frequency, 10 to 90 */
+};
+typedef struct DecimationFilter_StageSetup_S DecimationFilter_StageSetup_T;
+
+/**
+ * @brief Filter configuration.
+ */
+struct DecimationFilter_Setup_S
+{
+    uint8_t InputBits; /**< Signed bits of an input sample minus the offset */
+    uint8_t Stages; /**< 1 to DECIMATION_FILTER_MAX_STAGES */
+    DecimationFilter_StageSetup_T Stage[DECIMATION_FILTER_MAX_STAGES];
+};
+typedef struct DecimationFilter_Setup_S DecimationFilter_Setup_T;
+
+/**
+ * @brief Design of a stage.
+ */
+struct DecimationFilter_Stage_S
+{
+    DecimationFilter_StageSetup_T Setup;
+    uint8_t CicShift; /**< Right shift which scales the CIC gain R^N to at most 1 */
+    int32_t Coefficients[DECIMATION_FILTER_MAX_TAPS]; /**< Q24, their sum makes up for the CIC gain left after the shift */
+};
+typedef struct DecimationFilter_Stage_S DecimationFilter_Stage_T;
+
+/**
+ * @brief Design shared by the channels of a filter.
+ */
+struct DecimationFilter_Bank_S
+{
+    uint8_t Stages;
+    uint32_t Factors[DECIMATION_FILTER_MAX_STAGES]; /**< Input samples per output sample of a stage, all stages up to it */
+    DecimationFilter_Stage_T Stage[DECIMATION_FILTER_MAX_STAGES];
+};
+typedef struct DecimationFilter_Bank_S DecimationFilter_Bank_T;
+
+/**
+ * @brief State of a stage in a channel.
+ */
+struct DecimationFilter_StageState_S
+{
+    uint32_t Integrators[DECIMATION_FILTER_CIC_ORDER];
+    uint32_t Combs[DECIMATION_FILTER_CIC_ORDER]; /**< Previous input of every comb */
+    int32_t Delay[2U * DECIMATION_FILTER_MAX_TAPS]; /**< FIR delay line, stored twice so the taps are contiguous */
+    uint8_t DelayIndex; /**< Newest sample of Delay */
+    uint8_t CicPhase; /**< Inputs since the last CIC output */
+    uint8_t FirPhase; /**< CIC outputs since the last FIR output */
+};
+typedef struct DecimationFilter_StageState_S DecimationFilter_StageState_T;
+
+/**
+ * @brief State of a channel.
+ */
+struct DecimationFilter_Channel_S
+{
+    const DecimationFilter_Bank_T * Bank;
+    int32_t Offset; /**< Subtracted from the input and added to the outputs */
+    DecimationFilter_StageState_T Stage[DECIMATION_FILTER_MAX_STAGES];
+};
+typedef struct DecimationFilter_Channel_S DecimationFilter_Channel_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Designs the stages of a filter.
+ *
+ * Float math, the CIC droop and a windowed integral per tap; a one-time cost
+ * at start up.
+ *
+ * @param[out] bank
+ * Design
+ *
+ * @param[in] setup
+ * Configuration, copied
+ *
+ * @return false on invalid parameters, or if InputBits plus the CIC gain of a stage exceed 32 bits.
+ */
+bool DecimationFilter_Design(DecimationFilter_Bank_T * bank, const DecimationFilter_Setup_T * setup);
+
+/**
+ * @brief Starts a channel as if its input had been offset forever.
+ *
+ * Every output then starts at offset instead of settling from 0; pass the
+ * first sample, or the middle of the input range.
+ *
+ * @param[out] channel
+ * Channel state
+ *
+ * @param[in] bank
+ * Design, must stay valid
+ *
+ * @param[in] offset
+ * Steady input
+ *
+ * @return false on invalid parameters.
+ */
+bool DecimationFilter_Reset(DecimationFilter_Channel_T * channel, const DecimationFilter_Bank_T * bank, int32_t offset);
+
+/**
+ * @brief Filters a block of input samples of a channel.
+ *
+ * @param[in] channel
+ * Channel state
+ *
+ * @param[in] input
+ * Samples at the input rate
+ *
+ * @param[in] count
+ * Samples in input
+ *
+ * @param[out] outputs
+ * Buffer per stage, of DECIMATION_FILTER_OUTPUT_LENGTH(count, Factors[stage]) samples; stage n + 1 reads the output of stage n
+ *
+ * @param[out] counts
+ * Samples written per stage, 0 if the block did not complete one
+ *
+ * @return false on invalid parameters.
+ */
+bool DecimationFilter_Process(DecimationFilter_Channel_T * channel, const int32_t * input, uint32_t count, int32_t * const * outputs, uint32_t * counts);
+
+/**
+ * @brief Returns the group delay of the output of a stage, in input samples.
+ */
+float DecimationFilter_GetDelay(const DecimationFilter_Bank_T * bank, uint8_t stage);
+
+#endif /* DECIMATIONFILTER_H_ */
@@ -0,0 +1,459 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the delta firmware update agent.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_DELTA_FOTA_AGENT
+
+#include "DeltaFotaAgent.h"
+
+/* system header files */
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "DeltaPatch.h"
+#include "HttpsAgent.h"
+#include "XDK_FOTA.h"
+#include "XDK_Storage.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* constant definitions ***************************************************** */
+
+/** Application partition of the XDK110: the firmware header, then the code at the FLASH origin 0x00020200 of the linker script */
+#define DELTA_FOTA_AGENT_IMAGE              ((const uint8_t *) 0x00020000UL)
+
+#define DELTA_FOTA_AGENT_IMAGE_MAX_SIZE     UINT32_C(0x000E0000)
+
+#define DELTA_FOTA_AGENT_WRITE_SIZE         UINT32_C(512) /**< One SD card block */
+
+#define DELTA_FOTA_AGENT_STATE_MAGIC        UINT32_C(0x53504458) /**< "XDPS" */
+
+/* local types ************************************************************** */
+
+/**
+ * @brief Content of the state file.
+ */
+struct AgentState_S
+{
+    uint32_t Magic;
+    uint32_t PatchOffset; /**< Patch bytes applied, header included */
+    DeltaPatch_Decoder_T Decoder;
+    uint32_t Crc; /**< Of the bytes before, a torn write reads as no state */
+};
+typedef struct AgentState_S AgentState_T;
+
+/* local variables ********************************************************** */
+
+static const DeltaFotaAgent_Setup_T * AgentSetup = NULL;
+
+static AgentState_T AgentState; /**< Download in progress if Magic is set */
+
+static DeltaFotaAgent_Statistics_T AgentStatistics;
+
+static uint32_t AgentSkippedCrc = 0UL; /**< New image CRC of a patch which does not apply to the running image */
+
+static uint32_t AgentImageSize = 0UL; /**< Size the CRC of the running image was last computed over */
+
+static uint32_t AgentImageCrc = 0UL;
+
+static uint8_t AgentBlock[DELTA_FOTA_AGENT_BLOCK_SIZE];
+
+static uint8_t AgentWriteBuffer[DELTA_FOTA_AGENT_WRITE_SIZE];
+
+static uint32_t AgentWriteLength = 0UL;
+
+static uint32_t AgentWriteOffset = 0UL; /**< Position of AgentWriteBuffer in the image file */
+
+static char AgentHeaders[sizeof("Range: bytes=4294967295-4294967295\r\n")];
+
+static bool AgentIsPolled = false;
+
+static uint32_t AgentLastPollMs = 0UL;
+
+static HttpsSession_Request_T AgentRequest =
+        {
+                .Method = "GET",
+                .Path = NULL,
+                .ContentType = NULL,
+                .ExtraHeaders = AgentHeaders,
+                .Body = NULL,
+                .BodyLength = 0UL,
+        };
+
+static HttpsSession_Response_T AgentResponse =
+        {
+                .Body = AgentBlock,
+                .BodySize = DELTA_FOTA_AGENT_BLOCK_SIZE,
+        };
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Returns the CRC-32 of the first size bytes of the running image, computed once per size.
+ */
+static uint32_t AgentGetImageCrc(uint32_t size)
+{
+    if (size != AgentImageSize)
+    {
+        AgentImageCrc = DeltaPatch_Crc32(0UL, DELTA_FOTA_AGENT_IMAGE, size);
+        AgentImageSize = size;
+    }
+    return AgentImageCrc;
+}
+
+static bool AgentReadOld(void * context, uint32_t offset, uint8_t * buffer, uint32_t length)
+{
+    BCDS_UNUSED(context);
+
+    memcpy(buffer, &DELTA_FOTA_AGENT_IMAGE[offset], length);
+    return true;
+}
+
+static bool AgentFlush(void)
+{
+    uint32_t bytesWritten = 0UL;
+    Storage_Write_T writeCredentials =
+            {
+                    .FileName = AgentSetup->FileName,
+                    .WriteBuffer = AgentWriteBuffer,
+                    .BytesToWrite = AgentWriteLength,
+                    .ActualBytesWritten = &bytesWritten,
+                    .Offset = AgentWriteOffset,
+            };
+
+    if ((0UL != AgentWriteLength) && (RETCODE_OK != Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials)))
+    {
+        printf("DeltaFotaAgent : Writing %s failed at %lu \r\n", AgentSetup->FileName, (unsigned long) AgentWriteOffset);
+        return false;
+    }
+    AgentStatistics.ImageBytes += AgentWriteLength;
+    AgentWriteOffset += AgentWriteLength;
+    AgentWriteLength = 0UL;
+    return true;
+}
+
+/**
+ * @brief Collects new image bytes into SD card blocks.
+ */
+static bool AgentWriteNew(void * context, const uint8_t * data, uint32_t length)
+{
+    uint32_t piece;
+
+    BCDS_UNUSED(context);
+
+    while (length > 0UL)
+    {
+        piece = DELTA_FOTA_AGENT_WRITE_SIZE - AgentWriteLength;
+        piece = (length < piece) ? length : piece;
+        memcpy(&AgentWriteBuffer[AgentWriteLength], data, piece);
+        AgentWriteLength += piece;
+        data += piece;
+        length -= piece;
+        if ((DELTA_FOTA_AGENT_WRITE_SIZE == AgentWriteLength) && !AgentFlush())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const DeltaPatch_Io_T AgentIo =
+        {
+                .Context = NULL,
+                .ReadOld = AgentReadOld,
+                .WriteNew = AgentWriteNew,
+        };
+
+/**
+ * @brief Writes AgentState, or an empty state if no download is in progress.
+ */
+static void AgentSaveState(void)
+{
+    uint32_t bytesWritten = 0UL;
+    Storage_Write_T writeCredentials =
+            {
+                    .FileName = AgentSetup->StateFileName,
+                    .WriteBuffer = (uint8_t *) &AgentState,
+                    .BytesToWrite = sizeof(AgentState),
+                    .ActualBytesWritten = &bytesWritten,
+                    .Offset = 0UL,
+            };
+
+    AgentState.Crc = DeltaPatch_Crc32(0UL, (const uint8_t *) &AgentState, offsetof(AgentState_T, Crc));
+    if (RETCODE_OK != Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials))
+    {
+        /* The download goes on; after a reset it starts over */
+        printf("DeltaFotaAgent : Writing %s failed \r\n", AgentSetup->StateFileName);
+    }
+}
+
+static void AgentClearState(void)
+{
+    memset(&AgentState, 0, sizeof(AgentState));
+    AgentSaveState();
+}
+
+/**
+ * @brief Fetches a range of the patch into AgentBlock.
+ *
+ * @return  RETCODE_OK if the whole range was received, an error code otherwise.
+ */
+static Retcode_T AgentFetch(uint32_t offset, uint32_t length)
+{
+    Retcode_T retcode;
+
+    (void) snprintf(AgentHeaders, sizeof(AgentHeaders), "Range: bytes=%lu-%lu\r\n", (unsigned long) offset,
+            (unsigned long) (offset + length - 1UL));
+    retcode = HttpsAgent_Request(&AgentRequest, &AgentResponse);
+    if (RETCODE_OK == retcode)
+    {
+        AgentStatistics.PatchBytes += AgentResponse.BodyLength;
+        /* A server ignoring Range answers 200 with the patch from its start */
+        if ((206U != AgentResponse.Status) || (length != AgentResponse.BodyLength))
+        {
+            printf("DeltaFotaAgent : Range %lu+%lu of %s answered with status %u and %lu bytes \r\n", (unsigned long) offset,
+                    (unsigned long) length, AgentSetup->Path, (unsigned int) AgentResponse.Status, (unsigned long) AgentResponse.BodyLength);
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
+    }
+    if ((RETCODE_OK != retcode) && (404U != AgentResponse.Status))
+    {
+        AgentStatistics.Failures++;
+    }
+    return retcode;
+}
+
+/**
+ * @brief Starts the download of a patch for the running image.
+ *
+ * @return false if the patch is for another image.
+ */
+static bool AgentStart(const DeltaPatch_Header_T * header)
+{
+    if ((header->OldSize > DELTA_FOTA_AGENT_IMAGE_MAX_SIZE) || (header->OldCrc != AgentGetImageCrc(header->OldSize)))
+    {
+        AgentSkippedCrc = header->NewCrc;
+        if ((header->NewSize <= DELTA_FOTA_AGENT_IMAGE_MAX_SIZE) && (header->NewCrc == AgentGetImageCrc(header->NewSize)))
+        {
+            printf("DeltaFotaAgent : %s is installed \r\n", AgentSetup->Path);
+        }
+        else
+        {
+            printf("DeltaFotaAgent : %s is for another image \r\n", AgentSetup->Path);
+        }
+        return false;
+    }
+    memset(&AgentState, 0, sizeof(AgentState));
+    AgentState.Magic = DELTA_FOTA_AGENT_STATE_MAGIC;
+    AgentState.PatchOffset = DELTA_PATCH_HEADER_SIZE;
+    DeltaPatch_InitDecoder(&AgentState.Decoder, header);
+    AgentSaveState();
+    printf("DeltaFotaAgent : %lu byte patch to a %lu byte image \r\n", (unsigned long) header->PatchSize, (unsigned long) header->NewSize);
+    return true;
+}
+
+/**
+ * @brief Fetches and applies the next block.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+static Retcode_T AgentApplyBlock(void)
+{
+    uint32_t remaining = AgentState.Decoder.Header.PatchSize - AgentState.PatchOffset;
+    uint32_t length = (remaining < DELTA_FOTA_AGENT_BLOCK_SIZE) ? remaining : DELTA_FOTA_AGENT_BLOCK_SIZE;
+    Retcode_T retcode = AgentFetch(AgentState.PatchOffset, length);
+
+    if (RETCODE_OK != retcode)
+    {
+        return retcode;
+    }
+    AgentWriteOffset = AgentState.Decoder.NewPosition;
+    AgentWriteLength = 0UL;
+    if (!DeltaPatch_Decode(&AgentState.Decoder, AgentBlock, length, &AgentIo) || !AgentFlush())
+    {
+        printf("DeltaFotaAgent : Patch rejected at %lu \r\n", (unsigned long) AgentState.PatchOffset);
+        AgentStatistics.Failures++;
+        AgentSkippedCrc = AgentState.Decoder.Header.NewCrc;
+        AgentClearState();
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentState.PatchOffset += length;
+    AgentStatistics.Blocks++;
+    AgentSaveState();
+    return RETCODE_OK;
+}
+
+/**
+ * @brief Hands the complete image to the XDK FOTA, which resets into the bootloader.
+ */
+static Retcode_T AgentInstall(void)
+{
+    Retcode_T retcode;
+
+    if (DELTA_PATCH_STATE_DONE != AgentState.Decoder.State)
+    {
+        printf("DeltaFotaAgent : Patch ends without END \r\n");
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    else
+    {
+        DeltaFotaAgent_PrintReport();
+        retcode = FOTA_ValidateSdcardFw();
+    }
+    AgentSkippedCrc = AgentState.Decoder.Header.NewCrc;
+    AgentClearState();
+    if (RETCODE_OK == retcode)
+    {
+        printf("DeltaFotaAgent : %s complete, installing \r\n", AgentSetup->FileName);
+        retcode = FOTA_UpdateSdcardFw();
+    }
+    if (RETCODE_OK != retcode)
+    {
+        printf("DeltaFotaAgent : Installing %s failed \r\n", AgentSetup->FileName);
+        AgentStatistics.Failures++;
+    }
+    return retcode;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T DeltaFotaAgent_Setup(const DeltaFotaAgent_Setup_T * setup)
+{
+    uint32_t bytesRead = 0UL;
+    Storage_Read_T readCredentials =
+            {
+                    .FileName = NULL,
+                    .ReadBuffer = (uint8_t *) &AgentState,
+                    .BytesToRead = sizeof(AgentState),
+                    .ActualBytesRead = &bytesRead,
+                    .Offset = 0UL,
+            };
+
+    if ((NULL == setup) || (NULL == setup->Path) || (NULL == setup->FileName) || (NULL == setup->StateFileName))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0UL == setup->BlocksPerPoll) || (DELTA_FOTA_AGENT_BLOCK_SIZE < DELTA_PATCH_HEADER_SIZE))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentSetup = setup;
+    AgentRequest.Path = setup->Path;
+    readCredentials.FileName = setup->StateFileName;
+    if ((RETCODE_OK != Storage_Read(STORAGE_MEDIUM_SD_CARD, &readCredentials)) || (sizeof(AgentState) != bytesRead) ||
+            (DELTA_FOTA_AGENT_STATE_MAGIC != AgentState.Magic) ||
+            (AgentState.Crc != DeltaPatch_Crc32(0UL, (const uint8_t *) &AgentState, offsetof(AgentState_T, Crc))))
+    {
+        /* No download in progress */
+        memset(&AgentState, 0, sizeof(AgentState));
+    }
+    else
+    {
+        AgentStatistics.Resumes++;
+        printf("DeltaFotaAgent : Resuming %s at %lu of %lu bytes \r\n", setup->Path, (unsigned long) AgentState.PatchOffset,
+                (unsigned long) AgentState.Decoder.Header.PatchSize);
+    }
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T DeltaFotaAgent_Poll(void)
+{
+    DeltaPatch_Header_T header;
+    Retcode_T retcode;
+    bool sdCardAvailable = false;
+    uint32_t blocks;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if (AgentIsPolled && ((AgentNowMs() - AgentLastPollMs) < AgentSetup->PollIntervalMs))
+    {
+        return RETCODE_OK;
+    }
+    AgentIsPolled = true;
+    AgentLastPollMs = AgentNowMs();
+
+    /* The header every time: a patch published since replaces the one in progress */
+    AgentStatistics.Checks++;
+    retcode = AgentFetch(0UL, DELTA_PATCH_HEADER_SIZE);
+    if (404U == AgentResponse.Status)
+    {
+        return RETCODE_OK;
+    }
+    if (RETCODE_OK != retcode)
+    {
+        return retcode;
+    }
+    if (!DeltaPatch_ParseHeader(AgentBlock, &header))
+    {
+        printf("DeltaFotaAgent : %s is not a patch \r\n", AgentSetup->Path);
+        AgentStatistics.Failures++;
+        return RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_INVALID_PARAM);
+    }
+    if ((DELTA_FOTA_AGENT_STATE_MAGIC != AgentState.Magic) || (0 != memcmp(&header, &AgentState.Decoder.Header, sizeof(header))))
+    {
+        if ((header.NewCrc == AgentSkippedCrc) || !AgentStart(&header))
+        {
+            return RETCODE_OK;
+        }
+    }
+    retcode = Storage_IsAvailable(STORAGE_MEDIUM_SD_CARD, &sdCardAvailable);
+    if ((RETCODE_OK == retcode) && (false == sdCardAvailable))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_UNINITIALIZED);
+    }
+    for (blocks = 0UL; (RETCODE_OK == retcode) && (blocks < AgentSetup->BlocksPerPoll) &&
+            (AgentState.PatchOffset < AgentState.Decoder.Header.PatchSize); blocks++)
+    {
+        retcode = AgentApplyBlock();
+    }
+    if ((RETCODE_OK == retcode) && (AgentState.PatchOffset == AgentState.Decoder.Header.PatchSize))
+    {
+        retcode = AgentInstall();
+    }
+    else if (RETCODE_OK == retcode)
+    {
+        /* The rest follows with the next polls, without waiting for PollIntervalMs */
+        AgentIsPolled = false;
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const DeltaFotaAgent_Statistics_T * DeltaFotaAgent_GetStatistics(void)
+{
+    return &AgentStatistics;
+}
+
+/** Refer interface header for description */
+void DeltaFotaAgent_PrintReport(void)
+{
+    printf("DeltaFotaAgent : %lu checks, %lu blocks, %lu patch bytes, %lu image bytes written, %lu resumes, %lu failures \r\n",
+            (unsigned long) AgentStatistics.Checks, (unsigned long) AgentStatistics.Blocks, (unsigned long) AgentStatistics.PatchBytes,
+            (unsigned long) AgentStatistics.ImageBytes, (unsigned long) AgentStatistics.Resumes, (unsigned long) AgentStatistics.Failures);
+    if (DELTA_FOTA_AGENT_STATE_MAGIC == AgentState.Magic)
+    {
+        printf("DeltaFotaAgent : %lu of %lu patch bytes, %lu of %lu image bytes \r\n", (unsigned long) AgentState.PatchOffset,
+                (unsigned long) AgentState.Decoder.Header.PatchSize, (unsigned long) AgentState.Decoder.NewPosition,
+                (unsigned long) AgentState.Decoder.Header.NewSize);
+    }
+}
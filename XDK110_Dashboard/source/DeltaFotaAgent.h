@@ -0,0 +1,105 @@
+/**
+ *  @file
+ *
+ *  @brief Firmware update by delta patch: downloads a DeltaPatch in blocks
+ *  and rebuilds the new image on the SD card for the XDK FOTA.
+ *
+ *  DeltaFotaAgent_Poll fetches the patch header from the upload server with
+ *  a Range request through the HttpsAgent. A patch for the running image
+ *  (its size and CRC-32 match the application in the internal flash) is
+ *  then fetched DELTA_FOTA_AGENT_BLOCK_SIZE bytes per Range request. Each
+ *  block goes straight through the DeltaPatch decoder, which reads the old
+ *  image from the flash and writes the new one to FileName; the patch itself
+ *  is never stored. After each block the decoder state and the download
+ *  position are written to StateFileName, so a reset or a lost connection
+ *  resumes at the next block instead of the start.
+ *
+ *  Once the new image is complete and its CRC matches the header, the state
+ *  is cleared and the image handed to the XDK FOTA (FOTA_ValidateSdcardFw,
+ *  FOTA_UpdateSdcardFw), which resets the XDK into the bootloader to flash
+ *  it. A patch for another image, including the one just installed, is
+ *  skipped; publishing a new patch under the same path restarts the download.
+ *
+ *  RAM: one block, a 512 byte write buffer and the decoder. The flash is
+ *  read in place.
+ *
+ *  All functions are called from the task which posts through the HttpsAgent.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DELTAFOTAAGENT_H_
+#define DELTAFOTAAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+/* local type and macro definitions */
+
+/** Patch bytes per Range request */
+#define DELTA_FOTA_AGENT_BLOCK_SIZE         UINT32_C(1024)
+
+/**
+ * @brief Agent configuration.
+ */
+struct DeltaFotaAgent_Setup_S
+{
+    const char * Path; /**< Path of the patch on the server of the HttpsAgent */
+    const char * FileName; /**< SD card file of the new image, the one the XDK FOTA flashes */
+    const char * StateFileName; /**< SD card file of the download state */
+    uint32_t PollIntervalMs; /**< Shortest time between two checks for a patch */
+    uint32_t BlocksPerPoll; /**< Blocks fetched per call, the posts wait meanwhile */
+};
+typedef struct DeltaFotaAgent_Setup_S DeltaFotaAgent_Setup_T;
+
+/**
+ * @brief Counters of the agent.
+ */
+struct DeltaFotaAgent_Statistics_S
+{
+    uint32_t Checks; /**< Patch headers fetched */
+    uint32_t Blocks; /**< Patch blocks fetched and applied */
+    uint32_t PatchBytes; /**< Patch bytes fetched, headers included */
+    uint32_t ImageBytes; /**< New image bytes written */
+    uint32_t Resumes; /**< Downloads continued from the state file */
+    uint32_t Failures; /**< Failed requests and rejected patches */
+};
+typedef struct DeltaFotaAgent_Statistics_S DeltaFotaAgent_Statistics_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Stores the configuration and reads the state of an interrupted download.
+ *
+ * Requires an enabled SD card storage.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T DeltaFotaAgent_Setup(const DeltaFotaAgent_Setup_T * setup);
+
+/**
+ * @brief Checks for a patch if PollIntervalMs passed since the last check,
+ * and continues the download of one.
+ *
+ * Does not return once a complete image is handed to the XDK FOTA.
+ *
+ * @return  RETCODE_OK if no patch was due or published, the patch is for
+ * another image or its blocks were applied, an error code otherwise.
+ */
+Retcode_T DeltaFotaAgent_Poll(void);
+
+/**
+ * @brief Returns the counters of the agent.
+ */
+const DeltaFotaAgent_Statistics_T * DeltaFotaAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters and the progress of the download.
+ */
+void DeltaFotaAgent_PrintReport(void);
+
+#endif /* DELTAFOTAAGENT_H_ */
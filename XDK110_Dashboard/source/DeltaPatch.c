@@ -0,0 +1,309 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the firmware delta patch decoder.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "DeltaPatch.h"
+
+/* system header files */
+#include <stddef.h>
+
+/* local variables ********************************************************** */
+
+/** CRC-32 of each nibble, 64 bytes instead of the 1 KB byte table */
+static const uint32_t DeltaPatchCrcTable[16] =
+        {
+                0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL, 0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+                0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL, 0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+        };
+
+/* local functions ********************************************************** */
+
+static uint32_t DeltaPatchReadUInt32(const uint8_t * data)
+{
+    return (uint32_t) data[0] | ((uint32_t) data[1] << 8) | ((uint32_t) data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+static void DeltaPatchWriteUInt32(uint8_t * data, uint32_t value)
+{
+    data[0] = (uint8_t) value;
+    data[1] = (uint8_t) (value >> 8);
+    data[2] = (uint8_t) (value >> 16);
+    data[3] = (uint8_t) (value >> 24);
+}
+
+static bool DeltaPatchFail(DeltaPatch_Decoder_T * decoder)
+{
+    decoder->State = DELTA_PATCH_STATE_ERROR;
+    return false;
+}
+
+/**
+ * @brief Appends bytes to the new image.
+ */
+static bool DeltaPatchWrite(DeltaPatch_Decoder_T * decoder, const DeltaPatch_Io_T * io, const uint8_t * data, uint32_t length)
+{
+    if (!io->WriteNew(io->Context, data, length))
+    {
+        return false;
+    }
+    decoder->NewCrc = DeltaPatch_Crc32(decoder->NewCrc, data, length);
+    decoder->NewPosition += length;
+    return true;
+}
+
+/**
+ * @brief Copies unchanged bytes of the old image.
+ */
+static bool DeltaPatchCopy(DeltaPatch_Decoder_T * decoder, const DeltaPatch_Io_T * io, uint32_t length)
+{
+    uint8_t buffer[DELTA_PATCH_IO_SIZE];
+    uint32_t piece;
+
+    while (length > 0UL)
+    {
+        piece = (length < sizeof(buffer)) ? length : sizeof(buffer);
+        if (!io->ReadOld(io->Context, decoder->OldPosition, buffer, piece) || !DeltaPatchWrite(decoder, io, buffer, piece))
+        {
+            return false;
+        }
+        decoder->OldPosition += piece;
+        length -= piece;
+    }
+    return true;
+}
+
+/**
+ * @brief Acts on a complete number of the current command.
+ */
+static bool DeltaPatchTakeNumber(DeltaPatch_Decoder_T * decoder, const DeltaPatch_Io_T * io)
+{
+    uint32_t number = decoder->Number;
+    int32_t distance;
+
+    decoder->Number = 0UL;
+    decoder->Shift = 0U;
+    switch (decoder->State)
+    {
+    case DELTA_PATCH_STATE_NUMBER:
+        if (DELTA_PATCH_OP_SEEK == decoder->Opcode)
+        {
+            distance = (int32_t) (number >> 1) ^ -(int32_t) (number & 1UL);
+            if (((distance < 0) && ((uint32_t) -distance > decoder->OldPosition)) ||
+                    ((distance > 0) && ((uint32_t) distance > (decoder->Header.OldSize - decoder->OldPosition))))
+            {
+                return false;
+            }
+            decoder->OldPosition = (uint32_t) ((int32_t) decoder->OldPosition + distance);
+            decoder->State = DELTA_PATCH_STATE_OPCODE;
+            return true;
+        }
+        if (number > (decoder->Header.NewSize - decoder->NewPosition))
+        {
+            return false;
+        }
+        if (DELTA_PATCH_OP_INSERT == decoder->Opcode)
+        {
+            decoder->RunRemaining = number;
+            decoder->State = (0UL != number) ? DELTA_PATCH_STATE_INSERT : DELTA_PATCH_STATE_OPCODE;
+            return true;
+        }
+        if (number > (decoder->Header.OldSize - decoder->OldPosition))
+        {
+            return false;
+        }
+        decoder->Remaining = number;
+        decoder->State = (0UL != number) ? DELTA_PATCH_STATE_SAME_COUNT : DELTA_PATCH_STATE_OPCODE;
+        return true;
+
+    case DELTA_PATCH_STATE_SAME_COUNT:
+        if ((number > decoder->Remaining) || !DeltaPatchCopy(decoder, io, number))
+        {
+            return false;
+        }
+        decoder->Remaining -= number;
+        decoder->State = (0UL != decoder->Remaining) ? DELTA_PATCH_STATE_CHANGED_COUNT : DELTA_PATCH_STATE_OPCODE;
+        return true;
+
+    case DELTA_PATCH_STATE_CHANGED_COUNT:
+        if ((0UL == number) || (number > decoder->Remaining))
+        {
+            return false;
+        }
+        decoder->Remaining -= number;
+        decoder->RunRemaining = number;
+        decoder->State = DELTA_PATCH_STATE_CHANGED;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief Takes the opcode of the next command.
+ */
+static bool DeltaPatchTakeOpcode(DeltaPatch_Decoder_T * decoder, uint8_t opcode)
+{
+    if (DELTA_PATCH_OP_END == opcode)
+    {
+        if ((decoder->NewPosition != decoder->Header.NewSize) || (decoder->NewCrc != decoder->Header.NewCrc))
+        {
+            return false;
+        }
+        decoder->State = DELTA_PATCH_STATE_DONE;
+        return true;
+    }
+    if (opcode > DELTA_PATCH_OP_SEEK)
+    {
+        return false;
+    }
+    decoder->Opcode = opcode;
+    decoder->State = DELTA_PATCH_STATE_NUMBER;
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+uint32_t DeltaPatch_Crc32(uint32_t crc, const uint8_t * data, uint32_t length)
+{
+    uint32_t index;
+
+    crc = ~crc;
+    for (index = 0UL; index < length; index++)
+    {
+        crc ^= data[index];
+        crc = (crc >> 4) ^ DeltaPatchCrcTable[crc & 0x0FUL];
+        crc = (crc >> 4) ^ DeltaPatchCrcTable[crc & 0x0FUL];
+    }
+    return ~crc;
+}
+
+/** Refer interface header for description */
+bool DeltaPatch_ParseHeader(const uint8_t * data, DeltaPatch_Header_T * header)
+{
+    if ((NULL == data) || (NULL == header) || (DELTA_PATCH_MAGIC != DeltaPatchReadUInt32(data)))
+    {
+        return false;
+    }
+    header->PatchSize = DeltaPatchReadUInt32(&data[4]);
+    header->OldSize = DeltaPatchReadUInt32(&data[8]);
+    header->OldCrc = DeltaPatchReadUInt32(&data[12]);
+    header->NewSize = DeltaPatchReadUInt32(&data[16]);
+    header->NewCrc = DeltaPatchReadUInt32(&data[20]);
+    return (header->PatchSize > DELTA_PATCH_HEADER_SIZE);
+}
+
+/** Refer interface header for description */
+void DeltaPatch_WriteHeader(const DeltaPatch_Header_T * header, uint8_t * data)
+{
+    DeltaPatchWriteUInt32(data, DELTA_PATCH_MAGIC);
+    DeltaPatchWriteUInt32(&data[4], header->PatchSize);
+    DeltaPatchWriteUInt32(&data[8], header->OldSize);
+    DeltaPatchWriteUInt32(&data[12], header->OldCrc);
+    DeltaPatchWriteUInt32(&data[16], header->NewSize);
+    DeltaPatchWriteUInt32(&data[20], header->NewCrc);
+}
+
+/** Refer interface header for description */
+void DeltaPatch_InitDecoder(DeltaPatch_Decoder_T * decoder, const DeltaPatch_Header_T * header)
+{
+    decoder->Header = *header;
+    decoder->State = DELTA_PATCH_STATE_OPCODE;
+    decoder->Opcode = DELTA_PATCH_OP_END;
+    decoder->Shift = 0U;
+    decoder->Number = 0UL;
+    decoder->Remaining = 0UL;
+    decoder->RunRemaining = 0UL;
+    decoder->OldPosition = 0UL;
+    decoder->NewPosition = 0UL;
+    decoder->NewCrc = 0UL;
+}
+
+/** Refer interface header for description */
+bool DeltaPatch_Decode(DeltaPatch_Decoder_T * decoder, const uint8_t * data, uint32_t length, const DeltaPatch_Io_T * io)
+{
+    uint8_t buffer[DELTA_PATCH_IO_SIZE];
+    uint32_t piece;
+    uint32_t index;
+    bool isOk = true;
+
+    if ((NULL == decoder) || (NULL == io) || ((NULL == data) && (0UL != length)))
+    {
+        return false;
+    }
+    while (isOk && (length > 0UL))
+    {
+        switch (decoder->State)
+        {
+        case DELTA_PATCH_STATE_OPCODE:
+            isOk = DeltaPatchTakeOpcode(decoder, *data);
+            data++;
+            length--;
+            break;
+
+        case DELTA_PATCH_STATE_NUMBER:
+        case DELTA_PATCH_STATE_SAME_COUNT:
+        case DELTA_PATCH_STATE_CHANGED_COUNT:
+            /* A fifth group may only carry the top 4 bits */
+            if ((decoder->Shift > 28U) || ((28U == decoder->Shift) && (*data > 0x0FU)))
+            {
+                isOk = false;
+                break;
+            }
+            decoder->Number |= (uint32_t) (*data & 0x7FU) << decoder->Shift;
+            decoder->Shift = (uint8_t) (decoder->Shift + 7U);
+            if (0U == (*data & 0x80U))
+            {
+                isOk = DeltaPatchTakeNumber(decoder, io);
+            }
+            data++;
+            length--;
+            break;
+
+        case DELTA_PATCH_STATE_CHANGED:
+            piece = (length < decoder->RunRemaining) ? length : decoder->RunRemaining;
+            piece = (piece < sizeof(buffer)) ? piece : sizeof(buffer);
+            isOk = io->ReadOld(io->Context, decoder->OldPosition, buffer, piece);
+            for (index = 0UL; isOk && (index < piece); index++)
+            {
+                buffer[index] = (uint8_t) (buffer[index] + data[index]);
+            }
+            isOk = isOk && DeltaPatchWrite(decoder, io, buffer, piece);
+            decoder->OldPosition += piece;
+            decoder->RunRemaining -= piece;
+            if (0UL == decoder->RunRemaining)
+            {
+                decoder->State = (0UL != decoder->Remaining) ? DELTA_PATCH_STATE_SAME_COUNT : DELTA_PATCH_STATE_OPCODE;
+            }
+            data += piece;
+            length -= piece;
+            break;
+
+        case DELTA_PATCH_STATE_INSERT:
+            piece = (length < decoder->RunRemaining) ? length : decoder->RunRemaining;
+            piece = (piece < DELTA_PATCH_IO_SIZE) ? piece : DELTA_PATCH_IO_SIZE;
+            isOk = DeltaPatchWrite(decoder, io, data, piece);
+            decoder->RunRemaining -= piece;
+            if (0UL == decoder->RunRemaining)
+            {
+                decoder->State = DELTA_PATCH_STATE_OPCODE;
+            }
+            data += piece;
+            length -= piece;
+            break;
+
+        default:
+            /* Bytes after END, or an earlier error */
+            isOk = false;
+            break;
+        }
+    }
+    return (isOk ? true : DeltaPatchFail(decoder));
+}
@@ -0,0 +1,152 @@
+/**
+ *  @file
+ *
+ *  @brief Streaming decoder of the firmware delta patches of DeltaFotaAgent.
+ *
+ *  A patch rebuilds a new image from the image running on the device. It
+ *  starts with a header of DELTA_PATCH_HEADER_SIZE bytes, all numbers 32 bit
+ *  little endian:
+ *
+ *      magic "XDP1", patch size, old size, old CRC-32, new size, new CRC-32
+ *
+ *  followed by commands, each an opcode byte and unsigned LEB128 numbers:
+ *
+ *  - ADD n: the next n bytes of the old image, each plus a difference. The
+ *    differences come as runs covering n: a count of unchanged bytes, then,
+ *    unless n is covered, a count of changed bytes and their differences.
+ *    Moved code differs from its old copy in a few addresses only, so most
+ *    of an image is unchanged runs.
+ *  - INSERT n: n new bytes, the old position stays.
+ *  - SEEK d: moves the old position by d, zigzag encoded.
+ *  - END: the patch is complete.
+ *
+ *  The decoder takes the patch in pieces of any size and keeps its whole
+ *  state in DeltaPatch_Decoder_T, which holds no pointers: a copy saved
+ *  between two pieces resumes the patch after a reset. It reads the old
+ *  image and writes the new one through DeltaPatch_Io_T, in pieces of at
+ *  most DELTA_PATCH_IO_SIZE bytes.
+ *
+ *  The module is platform independent; Tools/FotaDelta creates patches on
+ *  the host and applies them with this decoder.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DELTAPATCH_H_
+#define DELTAPATCH_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+#define DELTA_PATCH_MAGIC                   UINT32_C(0x31504458) /**< "XDP1" */
+#define DELTA_PATCH_HEADER_SIZE             UINT8_C(24)
+#define DELTA_PATCH_IO_SIZE                 UINT8_C(64) /**< Largest piece of ReadOld and WriteNew, on the stack of DeltaPatch_Decode */
+
+/** Opcodes of the commands */
+#define DELTA_PATCH_OP_END                  UINT8_C(0)
+#define DELTA_PATCH_OP_ADD                  UINT8_C(1)
+#define DELTA_PATCH_OP_INSERT               UINT8_C(2)
+#define DELTA_PATCH_OP_SEEK                 UINT8_C(3)
+
+/**
+ * @brief Header of a patch.
+ */
+struct DeltaPatch_Header_S
+{
+    uint32_t PatchSize; /**< Header included */
+    uint32_t OldSize;
+    uint32_t OldCrc;
+    uint32_t NewSize;
+    uint32_t NewCrc;
+};
+typedef struct DeltaPatch_Header_S DeltaPatch_Header_T;
+
+/**
+ * @brief Decoder state.
+ */
+enum DeltaPatch_State_E
+{
+    DELTA_PATCH_STATE_OPCODE = 0,
+    DELTA_PATCH_STATE_NUMBER, /**< Parsing the number of Opcode */
+    DELTA_PATCH_STATE_SAME_COUNT, /**< Parsing the count of an unchanged run */
+    DELTA_PATCH_STATE_CHANGED_COUNT,
+    DELTA_PATCH_STATE_CHANGED, /**< Taking the differences of a changed run */
+    DELTA_PATCH_STATE_INSERT, /**< Taking the bytes of an INSERT */
+    DELTA_PATCH_STATE_DONE, /**< END taken and the new image checked */
+    DELTA_PATCH_STATE_ERROR
+};
+typedef enum DeltaPatch_State_E DeltaPatch_State_T;
+
+/**
+ * @brief Decoder of one patch; plain data, it may be copied and stored.
+ */
+struct DeltaPatch_Decoder_S
+{
+    DeltaPatch_Header_T Header;
+    DeltaPatch_State_T State;
+    uint8_t Opcode;
+    uint8_t Shift; /**< Of the next LEB128 group */
+    uint32_t Number; /**< LEB128 number being parsed */
+    uint32_t Remaining; /**< Bytes of the ADD not covered by a run yet */
+    uint32_t RunRemaining; /**< Bytes left of the changed run or the INSERT */
+    uint32_t OldPosition;
+    uint32_t NewPosition; /**< Bytes of the new image written */
+    uint32_t NewCrc; /**< Running CRC-32 of the new image */
+};
+typedef struct DeltaPatch_Decoder_S DeltaPatch_Decoder_T;
+
+/**
+ * @brief Access to the images.
+ */
+struct DeltaPatch_Io_S
+{
+    void * Context;
+    /** Reads old image bytes; offset and length are checked against OldSize */
+    bool (*ReadOld)(void * context, uint32_t offset, uint8_t * buffer, uint32_t length);
+    /** Appends bytes to the new image */
+    bool (*WriteNew)(void * context, const uint8_t * data, uint32_t length);
+};
+typedef struct DeltaPatch_Io_S DeltaPatch_Io_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Continues a CRC-32 (IEEE 802.3), starting from 0.
+ */
+uint32_t DeltaPatch_Crc32(uint32_t crc, const uint8_t * data, uint32_t length);
+
+/**
+ * @brief Reads a header.
+ *
+ * @param[in] data
+ * DELTA_PATCH_HEADER_SIZE bytes
+ *
+ * @return false if the magic is wrong or the patch is shorter than its header.
+ */
+bool DeltaPatch_ParseHeader(const uint8_t * data, DeltaPatch_Header_T * header);
+
+/**
+ * @brief Writes a header into DELTA_PATCH_HEADER_SIZE bytes.
+ */
+void DeltaPatch_WriteHeader(const DeltaPatch_Header_T * header, uint8_t * data);
+
+/**
+ * @brief Prepares the decoding of the commands following a header.
+ */
+void DeltaPatch_InitDecoder(DeltaPatch_Decoder_T * decoder, const DeltaPatch_Header_T * header);
+
+/**
+ * @brief Decodes the next piece of the commands.
+ *
+ * A command reaching past an image, bytes after END or a new image
+ * which does not match the header put the decoder in
+ * DELTA_PATCH_STATE_ERROR, as does a failing ReadOld or WriteNew.
+ *
+ * @return false once the decoder is in DELTA_PATCH_STATE_ERROR.
+ */
+bool DeltaPatch_Decode(DeltaPatch_Decoder_T * decoder, const uint8_t * data, uint32_t length, const DeltaPatch_Io_T * io);
+
+#endif /* DELTAPATCH_H_ */
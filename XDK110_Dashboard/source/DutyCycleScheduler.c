@@ -0,0 +1,264 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the LoRaWAN duty cycle scheduler.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "DutyCycleScheduler.h"
+
+/* system header files */
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define DUTY_CYCLE_SCHEDULER_BUDGET_SHARE   UINT32_C(8) /**< Credit cap: 3 hours worth of the daily budget */
+#define DUTY_CYCLE_SCHEDULER_US_PER_DAY_MS  UINT32_C(86400) /**< Budget ms per day -> credit us per elapsed ms */
+
+/* local functions ********************************************************** */
+
+static uint64_t BudgetCapUs(const DutyCycleScheduler_T * scheduler)
+{
+    return ((uint64_t) scheduler->Setup.DailyAirtimeBudgetMs * 1000ULL) / DUTY_CYCLE_SCHEDULER_BUDGET_SHARE;
+}
+
+/**
+ * @brief Accrues the budget credit and rolls the daily airtime over.
+ */
+static void Advance(DutyCycleScheduler_T * scheduler, uint32_t nowMs)
+{
+    uint64_t accrual;
+    uint32_t day = nowMs / DUTY_CYCLE_SCHEDULER_DAY_MS;
+
+    accrual = ((uint64_t) (nowMs - scheduler->LastPollMs) * scheduler->Setup.DailyAirtimeBudgetMs) + scheduler->BudgetRemainder;
+    scheduler->BudgetCreditUs += accrual / DUTY_CYCLE_SCHEDULER_US_PER_DAY_MS;
+    scheduler->BudgetRemainder = (uint32_t) (accrual % DUTY_CYCLE_SCHEDULER_US_PER_DAY_MS);
+    if (scheduler->BudgetCreditUs > BudgetCapUs(scheduler))
+    {
+        scheduler->BudgetCreditUs = BudgetCapUs(scheduler);
+    }
+    scheduler->LastPollMs = nowMs;
+
+    if (day != scheduler->Day)
+    {
+        scheduler->Statistics.AirtimeYesterdayMs = ((scheduler->Day + 1UL) == day) ? scheduler->Statistics.AirtimeTodayMs : 0UL;
+        scheduler->Statistics.AirtimeTodayMs = 0UL;
+        scheduler->Day = day;
+    }
+}
+
+/**
+ * @brief Returns how much an item changed since its last uplink, in deadbands; 0 if below the deadband.
+ */
+static float ChangeScore(const DutyCycleScheduler_T * scheduler, const float * values, uint8_t item)
+{
+    float score = 0.0f;
+    float change;
+    float deadband = scheduler->Setup.Deadband[item];
+    uint8_t axis;
+
+    for (axis = 0U; axis < LoRaPayload_GetAxisCount((LoRaPayload_Item_T) item); axis++)
+    {
+        change = fabsf(values[axis] - scheduler->SentValues[item][axis]);
+        if (deadband > 0.0f)
+        {
+            change /= deadband;
+        }
+        else if (change > 0.0f)
+        {
+            change = 1.0f;
+        }
+        if (change > score)
+        {
+            score = change;
+        }
+    }
+    return (score >= 1.0f) ? score : 0.0f;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool DutyCycleScheduler_Init(DutyCycleScheduler_T * scheduler, const DutyCycleScheduler_Setup_T * setup)
+{
+    if ((NULL == scheduler) || (NULL == setup) || (0U == setup->DutyCyclePermille) || (setup->DutyCyclePermille > 1000U) ||
+            (0U == LoRaPayload_GetMaxSize(setup->Region, setup->DataRate)))
+    {
+        return false;
+    }
+    memset(scheduler, 0, sizeof(*scheduler));
+    scheduler->Setup = *setup;
+    scheduler->MaxPayloadSize = LoRaPayload_GetMaxSize(setup->Region, setup->DataRate);
+    scheduler->BudgetCreditUs = BudgetCapUs(scheduler);
+    return true;
+}
+
+/** Refer interface header for description */
+uint8_t DutyCycleScheduler_Poll(DutyCycleScheduler_T * scheduler, const SensorSnapshot_T * snapshot, uint32_t nowMs, uint8_t * payload)
+{
+    float scores[LORA_PAYLOAD_ITEM_COUNT];
+    uint32_t ages[LORA_PAYLOAD_ITEM_COUNT];
+    uint8_t candidates = 0U;
+    uint8_t selected = 0U;
+    uint8_t changed = 0U;
+    uint8_t item;
+    uint8_t axis;
+    uint8_t best;
+    uint16_t size;
+    uint32_t airtimeUs;
+
+    if ((NULL == scheduler) || (NULL == snapshot) || (NULL == payload))
+    {
+        return 0U;
+    }
+    if ((0UL == scheduler->LastPollMs) && (0UL == scheduler->Statistics.Uplinks))
+    {
+        scheduler->LastPollMs = nowMs;
+        scheduler->Day = nowMs / DUTY_CYCLE_SCHEDULER_DAY_MS;
+    }
+    Advance(scheduler, nowMs);
+    scheduler->PendingItems = 0U;
+
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        for (axis = 0U; axis < LoRaPayload_GetAxisCount((LoRaPayload_Item_T) item); axis++)
+        {
+            scheduler->PendingValues[item][axis] = LoRaPayload_GetValue(snapshot, (LoRaPayload_Item_T) item, axis);
+        }
+        scores[item] = ChangeScore(scheduler, scheduler->PendingValues[item], item);
+        ages[item] = nowMs - scheduler->SentMs[item];
+        if (0U == (scheduler->SentMask & (1U << item)))
+        {
+            ages[item] = UINT32_MAX; /* never sent */
+        }
+        if (scores[item] > 0.0f)
+        {
+            changed |= (uint8_t) (1U << item);
+            candidates |= (uint8_t) (1U << item);
+        }
+        else if (ages[item] >= scheduler->Setup.MaxIntervalMs)
+        {
+            candidates |= (uint8_t) (1U << item);
+        }
+    }
+    if (0U == candidates)
+    {
+        return 0U;
+    }
+    if ((0UL != scheduler->Statistics.Uplinks) && ((nowMs - scheduler->LastUplinkMs) < scheduler->Setup.MinIntervalMs))
+    {
+        return 0U;
+    }
+    if ((int32_t) (nowMs - scheduler->BandFreeMs) < 0)
+    {
+        scheduler->Statistics.HeldByDutyCycle++;
+        return 0U;
+    }
+
+    /* Changed items by descending change, then stale items by descending age */
+    while (0U != candidates)
+    {
+        best = LORA_PAYLOAD_ITEM_COUNT;
+        for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+        {
+            if (0U == (candidates & (1U << item)))
+            {
+                continue;
+            }
+            if ((LORA_PAYLOAD_ITEM_COUNT == best) || (scores[item] > scores[best]) ||
+                    ((scores[item] == scores[best]) && (ages[item] > ages[best])))
+            {
+                best = item;
+            }
+        }
+        candidates &= (uint8_t) ~(1U << best);
+        size = LoRaPayload_GetSize(scheduler->Setup.Format, (uint8_t) (selected | (1U << best)));
+        /* An uplink longer than the budget credit cap could never be sent */
+        if ((size <= scheduler->MaxPayloadSize) && ((0UL == scheduler->Setup.DailyAirtimeBudgetMs) ||
+                (LoRaPayload_GetAirtimeUs(scheduler->Setup.Region, scheduler->Setup.DataRate, (uint8_t) size) <= BudgetCapUs(scheduler))))
+        {
+            selected |= (uint8_t) (1U << best);
+        }
+    }
+    if (0U == selected)
+    {
+        return 0U;
+    }
+
+    size = LoRaPayload_GetSize(scheduler->Setup.Format, selected);
+    airtimeUs = LoRaPayload_GetAirtimeUs(scheduler->Setup.Region, scheduler->Setup.DataRate, (uint8_t) size);
+    if ((0UL != scheduler->Setup.DailyAirtimeBudgetMs) && (airtimeUs > scheduler->BudgetCreditUs))
+    {
+        scheduler->Statistics.HeldByBudget++;
+        return 0U;
+    }
+    size = LoRaPayload_Encode(scheduler->Setup.Format, snapshot, selected, payload, scheduler->MaxPayloadSize);
+    if (0U != size)
+    {
+        for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+        {
+            if ((0U != (changed & (1U << item))) && (0U == (selected & (1U << item))))
+            {
+                scheduler->Statistics.ItemsDeferred++;
+            }
+        }
+        scheduler->PendingItems = selected;
+        scheduler->PendingSize = (uint8_t) size;
+    }
+    return (uint8_t) size;
+}
+
+/** Refer interface header for description */
+void DutyCycleScheduler_Confirm(DutyCycleScheduler_T * scheduler, uint32_t nowMs, bool transmitted)
+{
+    uint32_t airtimeUs;
+    uint8_t item;
+
+    if ((NULL == scheduler) || (0U == scheduler->PendingItems))
+    {
+        return;
+    }
+    if (transmitted)
+    {
+        airtimeUs = LoRaPayload_GetAirtimeUs(scheduler->Setup.Region, scheduler->Setup.DataRate, scheduler->PendingSize);
+        scheduler->BudgetCreditUs -= (airtimeUs < scheduler->BudgetCreditUs) ? airtimeUs : scheduler->BudgetCreditUs;
+        /* Off time of the band: airtime * (1 / duty cycle - 1) */
+        scheduler->BandFreeMs = nowMs + (uint32_t) (((uint64_t) airtimeUs * (1000U - scheduler->Setup.DutyCyclePermille)) /
+                ((uint64_t) scheduler->Setup.DutyCyclePermille * 1000ULL)) + 1UL;
+        scheduler->LastUplinkMs = nowMs;
+        scheduler->Statistics.Uplinks++;
+        scheduler->Statistics.PayloadBytes += scheduler->PendingSize;
+        scheduler->Statistics.AirtimeUs += airtimeUs;
+        scheduler->Statistics.AirtimeTodayMs += (airtimeUs + 500UL) / 1000UL;
+        for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+        {
+            if (0U != (scheduler->PendingItems & (1U << item)))
+            {
+                memcpy(scheduler->SentValues[item], scheduler->PendingValues[item], sizeof(scheduler->SentValues[item]));
+                scheduler->SentMs[item] = nowMs;
+                scheduler->SentMask |= (uint8_t) (1U << item);
+                scheduler->Statistics.ItemsSent[item]++;
+            }
+        }
+    }
+    scheduler->PendingItems = 0U;
+}
+
+/** Refer interface header for description */
+bool DutyCycleScheduler_SetDataRate(DutyCycleScheduler_T * scheduler, uint8_t dataRate)
+{
+    uint8_t maxSize = LoRaPayload_GetMaxSize(scheduler->Setup.Region, dataRate);
+
+    if (0U == maxSize)
+    {
+        return false;
+    }
+    scheduler->Setup.DataRate = dataRate;
+    scheduler->MaxPayloadSize = maxSize;
+    return true;
+}
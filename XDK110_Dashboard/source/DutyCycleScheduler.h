@@ -0,0 +1,150 @@
+/**
+ *  @file
+ *
+ *  @brief Decides when to send a LoRaWAN uplink and which items it carries.
+ *
+ *  An uplink is only scheduled when all of these hold:
+ *  - at least one item changed by more than its deadband since it was last
+ *    sent, or an item was not sent for MaxIntervalMs (heartbeat),
+ *  - MinIntervalMs passed since the previous uplink,
+ *  - the sub-band is free again: after an uplink of airtime T the band is
+ *    blocked for T * (1000 / DutyCyclePermille - 1), the regulatory duty cycle,
+ *  - the daily airtime budget (e.g. a network fair use policy) has enough
+ *    credit. The credit accrues evenly over the day and is capped at three
+ *    hours worth, so the budget cannot be burnt in a single burst.
+ *
+ *  The payload is filled with the changed items in order of their change
+ *  (relative to the deadband), then with the stale items, oldest first, up to
+ *  the maximum payload of the data rate. Changed items which did not fit stay
+ *  changed and go first next time.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef DUTYCYCLESCHEDULER_H_
+#define DUTYCYCLESCHEDULER_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "LoRaPayload.h"
+
+/* local type and macro definitions */
+
+/** Length of the airtime accounting period */
+#define DUTY_CYCLE_SCHEDULER_DAY_MS         UINT32_C(86400000)
+
+/**
+ * @brief Scheduler configuration.
+ */
+struct DutyCycleScheduler_Setup_S
+{
+    LoRaPayload_Region_T Region;
+    uint8_t DataRate; /**< Uplink data rate, fixed (ADR off) */
+    LoRaPayload_Format_T Format;
+    uint16_t DutyCyclePermille; /**< Regulatory duty cycle of the sub-band, 10 for 1 % */
+    uint32_t DailyAirtimeBudgetMs; /**< Airtime allowed per day, 0 for the duty cycle limit only */
+    uint32_t MinIntervalMs; /**< Minimum time between two uplinks */
+    uint32_t MaxIntervalMs; /**< Every item is sent at least this often */
+    float Deadband[LORA_PAYLOAD_ITEM_COUNT]; /**< Change of any axis, in item units, that makes an item changed */
+};
+typedef struct DutyCycleScheduler_Setup_S DutyCycleScheduler_Setup_T;
+
+/**
+ * @brief Scheduler counters.
+ */
+struct DutyCycleScheduler_Statistics_S
+{
+    uint32_t Uplinks;
+    uint32_t PayloadBytes;
+    uint64_t AirtimeUs; /**< Total time on air */
+    uint32_t AirtimeTodayMs; /**< Time on air in the current day */
+    uint32_t AirtimeYesterdayMs; /**< Time on air of the last complete day */
+    uint32_t HeldByDutyCycle; /**< Polls with pending data blocked by the band off time */
+    uint32_t HeldByBudget; /**< Polls with pending data blocked by the daily budget */
+    uint32_t ItemsSent[LORA_PAYLOAD_ITEM_COUNT];
+    uint32_t ItemsDeferred; /**< Changed items which did not fit into an uplink */
+};
+typedef struct DutyCycleScheduler_Statistics_S DutyCycleScheduler_Statistics_T;
+
+/**
+ * @brief Scheduler state.
+ */
+struct DutyCycleScheduler_S
+{
+    DutyCycleScheduler_Setup_T Setup;
+    uint8_t MaxPayloadSize;
+    uint8_t SentMask; /**< Items sent at least once; the others count as stale */
+    uint32_t LastPollMs;
+    uint32_t LastUplinkMs;
+    uint32_t BandFreeMs; /**< Time the duty cycle off time ends */
+    uint32_t Day; /**< Current accounting day, nowMs / DUTY_CYCLE_SCHEDULER_DAY_MS */
+    uint64_t BudgetCreditUs; /**< Airtime credit of the daily budget */
+    uint32_t BudgetRemainder; /**< Accrual remainder, keeps the credit exact */
+    uint8_t PendingItems; /**< Items of the uplink handed out by the last successful poll */
+    uint8_t PendingSize;
+    float SentValues[LORA_PAYLOAD_ITEM_COUNT][LORA_PAYLOAD_MAX_AXES]; /**< Values of the last uplink of every item */
+    float PendingValues[LORA_PAYLOAD_ITEM_COUNT][LORA_PAYLOAD_MAX_AXES];
+    uint32_t SentMs[LORA_PAYLOAD_ITEM_COUNT];
+    DutyCycleScheduler_Statistics_T Statistics;
+};
+typedef struct DutyCycleScheduler_S DutyCycleScheduler_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * @param[out] scheduler
+ * Scheduler state
+ *
+ * @param[in] setup
+ * Configuration, copied
+ *
+ * @return false for an unknown data rate or invalid duty cycle.
+ */
+bool DutyCycleScheduler_Init(DutyCycleScheduler_T * scheduler, const DutyCycleScheduler_Setup_T * setup);
+
+/**
+ * @brief Checks whether an uplink is due and builds its payload.
+ *
+ * @param[in,out] scheduler
+ * Scheduler state
+ *
+ * @param[in] snapshot
+ * Latest sensor values
+ *
+ * @param[in] nowMs
+ * Current time in milliseconds
+ *
+ * @param[out] payload
+ * Payload buffer of at least LORA_PAYLOAD_MAX_SIZE bytes
+ *
+ * @return Payload size, 0 if nothing is to be sent now.
+ */
+uint8_t DutyCycleScheduler_Poll(DutyCycleScheduler_T * scheduler, const SensorSnapshot_T * snapshot, uint32_t nowMs, uint8_t * payload);
+
+/**
+ * @brief Reports the outcome of the uplink returned by the last poll.
+ *
+ * @param[in,out] scheduler
+ * Scheduler state
+ *
+ * @param[in] nowMs
+ * Time the uplink was sent
+ *
+ * @param[in] transmitted
+ * true if the radio transmitted the uplink; only then airtime is charged
+ * and the items count as sent
+ */
+void DutyCycleScheduler_Confirm(DutyCycleScheduler_T * scheduler, uint32_t nowMs, bool transmitted);
+
+/**
+ * @brief Changes the data rate, e.g. after a link check; also changes the payload limit.
+ *
+ * @return false for an unknown data rate.
+ */
+bool DutyCycleScheduler_SetDataRate(DutyCycleScheduler_T * scheduler, uint8_t dataRate);
+
+#endif /* DUTYCYCLESCHEDULER_H_ */
@@ -0,0 +1,316 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the HTTP/JSON live view.
+ *
+ *  A body is rendered through a fixed buffer PayloadWriter at
+ *  LIVE_VIEW_HEAD_ROOM bytes into the buffer of its resource. Its head, whose
+ *  Content-Length is known only then, is written at the start of the buffer
+ *  and moved up against the body, so the response goes out in one send.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "LiveView.h"
+
+/* system header files */
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "PayloadWriter.h"
+#include "SensorTable.h"
+
+/* local variables ********************************************************** */
+
+static const char * const LiveViewPaths[LIVE_VIEW_RESOURCE_COUNT] =
+        {
+                "/latest",
+                "/history",
+        };
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Formats at most PAYLOAD_WRITER_MAX_RESERVE - 1 characters into a body.
+ */
+static bool LiveViewWriteFormat(PayloadWriter_T * writer, const char * format, ...)
+{
+    char * room = PayloadWriter_Reserve(writer, PAYLOAD_WRITER_MAX_RESERVE);
+    va_list arguments;
+    int written;
+
+    if (NULL == room)
+    {
+        return false;
+    }
+    va_start(arguments, format);
+    written = vsnprintf(room, PAYLOAD_WRITER_MAX_RESERVE, format, arguments);
+    va_end(arguments);
+    if ((written < 0) || ((uint32_t) written >= PAYLOAD_WRITER_MAX_RESERVE))
+    {
+        return false;
+    }
+    PayloadWriter_Commit(writer, (uint32_t) written);
+    return true;
+}
+
+/**
+ * @brief Writes a channel value, null if it is not finite.
+ */
+static bool LiveViewWriteValue(PayloadWriter_T * writer, const SensorSnapshot_T * snapshot, uint8_t channel, bool isLast)
+{
+    float value = SensorTable_GetValue(snapshot->Values, channel);
+
+    if (!isfinite(value))
+    {
+        return LiveViewWriteFormat(writer, isLast ? "null" : "null,");
+    }
+    return LiveViewWriteFormat(writer, isLast ? "%g" : "%g,", (double) value);
+}
+
+/**
+ * @brief Returns the snapshot of the history, 0 for the oldest held.
+ */
+static const SensorSnapshot_T * LiveViewGetSnapshot(const LiveView_T * view, uint32_t index)
+{
+    return &view->Setup.History[(view->Next + view->Setup.HistoryLength - view->Count + index) % view->Setup.HistoryLength];
+}
+
+static bool LiveViewWriteLatest(const LiveView_T * view, PayloadWriter_T * writer)
+{
+    const SensorSnapshot_T * snapshot = LiveViewGetSnapshot(view, view->Count - 1UL);
+    bool isOk = LiveViewWriteFormat(writer, "{\"timestamp_ms\":%lu,\"values\":{", (unsigned long) snapshot->TimestampMs);
+    uint8_t channel;
+
+    for (channel = 0U; isOk && (channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT); channel++)
+    {
+        isOk = LiveViewWriteFormat(writer, "\"%s\":", SensorTable_GetChannelKey(channel)) &&
+                LiveViewWriteValue(writer, snapshot, channel, (channel + 1U) == (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT);
+    }
+    isOk = isOk && PayloadWriter_Write(writer, "},\"units\":{", 11UL);
+    for (channel = 0U; isOk && (channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT); channel++)
+    {
+        isOk = LiveViewWriteFormat(writer, ((channel + 1U) == (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT) ? "\"%s\":\"%s\"" : "\"%s\":\"%s\",",
+                SensorTable_GetChannelKey(channel), SensorTable_GetChannelUnit(channel));
+    }
+    return isOk && PayloadWriter_Write(writer, "}}", 2UL);
+}
+
+static bool LiveViewWriteHistory(const LiveView_T * view, PayloadWriter_T * writer)
+{
+    bool isOk = PayloadWriter_Write(writer, "{\"timestamp_ms\":[", 17UL);
+    uint32_t index;
+    uint8_t channel;
+
+    for (index = 0UL; isOk && (index < view->Count); index++)
+    {
+        isOk = LiveViewWriteFormat(writer, ((index + 1UL) == view->Count) ? "%lu" : "%lu,",
+                (unsigned long) LiveViewGetSnapshot(view, index)->TimestampMs);
+    }
+    isOk = isOk && PayloadWriter_Write(writer, "],\"values\":{", 12UL);
+    for (channel = 0U; isOk && (channel < (uint8_t) SENSOR_SNAPSHOT_CHANNEL_COUNT); channel++)
+    {
+        isOk = LiveViewWriteFormat(writer, (0U == channel) ? "\"%s\":[" : ",\"%s\":[", SensorTable_GetChannelKey(channel));
+        for (index = 0UL; isOk && (index < view->Count); index++)
+        {
+            isOk = LiveViewWriteValue(writer, LiveViewGetSnapshot(view, index), channel, (index + 1UL) == view->Count);
+        }
+        isOk = isOk && PayloadWriter_Write(writer, "]", 1UL);
+    }
+    return isOk && PayloadWriter_Write(writer, "}}", 2UL);
+}
+
+/**
+ * @brief Renders the response of a resource for the current generation.
+ */
+static void LiveViewRender(LiveView_T * view, LiveView_Resource_T resource)
+{
+    LiveView_Cache_T * cache = &view->Caches[resource];
+    PayloadWriter_T writer;
+    bool isOk;
+
+    view->Statistics.Renders++;
+    cache->Generation = view->Generation;
+    cache->Length = 0UL;
+    PayloadWriter_Init(&writer, (uint8_t *) &cache->Buffer[LIVE_VIEW_HEAD_ROOM], cache->Size - LIVE_VIEW_HEAD_ROOM, 0UL, NULL, NULL);
+    isOk = (LIVE_VIEW_RESOURCE_LATEST == resource) ? LiveViewWriteLatest(view, &writer) : LiveViewWriteHistory(view, &writer);
+    if (!isOk || !PayloadWriter_Finish(&writer))
+    {
+        view->Statistics.Overflows++;
+        return;
+    }
+    cache->HeadLength = HttpMessage_WriteResponseHead(cache->Buffer, LIVE_VIEW_HEAD_ROOM, 200U, "OK", "application/json",
+            writer.Length, false);
+    if (0UL == cache->HeadLength)
+    {
+        view->Statistics.Overflows++;
+        return;
+    }
+    cache->Offset = LIVE_VIEW_HEAD_ROOM - cache->HeadLength;
+    (void) memmove(&cache->Buffer[cache->Offset], cache->Buffer, cache->HeadLength);
+    cache->Length = cache->HeadLength + writer.Length;
+}
+
+/**
+ * @brief Returns true if a request path names a resource, a query is ignored.
+ */
+static bool LiveViewIsPath(const char * path, const char * resourcePath)
+{
+    size_t length = strlen(resourcePath);
+
+    return (0 == strncmp(path, resourcePath, length)) && (('\0' == path[length]) || ('?' == path[length]));
+}
+
+/**
+ * @brief Returns the resource of a request path, LIVE_VIEW_RESOURCE_COUNT for none.
+ */
+static uint8_t LiveViewFindResource(const char * path)
+{
+    uint8_t resource;
+
+    for (resource = 0U; resource < (uint8_t) LIVE_VIEW_RESOURCE_COUNT; resource++)
+    {
+        if (LiveViewIsPath(path, LiveViewPaths[resource]))
+        {
+            break;
+        }
+    }
+    return resource;
+}
+
+static const char * LiveViewGetReason(uint16_t status)
+{
+    switch (status)
+    {
+    case 400U:
+        return "Bad Request";
+    case 404U:
+        return "Not Found";
+    case 405U:
+        return "Method Not Allowed";
+    case 503U:
+        return "Service Unavailable";
+    default:
+        return "Internal Server Error";
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool LiveView_Init(LiveView_T * view, const LiveView_Setup_T * setup)
+{
+    if ((NULL == view) || (NULL == setup) || (NULL == setup->History) || (0UL == setup->HistoryLength) ||
+            (NULL == setup->LatestBuffer) || (setup->LatestSize <= LIVE_VIEW_HEAD_ROOM) ||
+            (NULL == setup->HistoryBuffer) || (setup->HistorySize <= LIVE_VIEW_HEAD_ROOM))
+    {
+        return false;
+    }
+    (void) memset(view, 0, sizeof(*view));
+    view->Setup = *setup;
+    view->Caches[LIVE_VIEW_RESOURCE_LATEST].Buffer = setup->LatestBuffer;
+    view->Caches[LIVE_VIEW_RESOURCE_LATEST].Size = setup->LatestSize;
+    view->Caches[LIVE_VIEW_RESOURCE_HISTORY].Buffer = setup->HistoryBuffer;
+    view->Caches[LIVE_VIEW_RESOURCE_HISTORY].Size = setup->HistorySize;
+    return true;
+}
+
+/** Refer interface header for description */
+bool LiveView_Update(LiveView_T * view, const SensorSnapshot_T * snapshot)
+{
+    if ((NULL == view) || (NULL == snapshot) || (0UL == snapshot->TimestampMs) ||
+            ((0UL != view->Count) && (LiveViewGetSnapshot(view, view->Count - 1UL)->TimestampMs == snapshot->TimestampMs)))
+    {
+        return false;
+    }
+    view->Setup.History[view->Next] = *snapshot;
+    view->Next = (view->Next + 1UL) % view->Setup.HistoryLength;
+    if (view->Count < view->Setup.HistoryLength)
+    {
+        view->Count++;
+    }
+    view->Generation++;
+    if (0UL == view->Generation)
+    {
+        /* 0 marks a cache never rendered */
+        view->Generation = 1UL;
+    }
+    view->Statistics.Updates++;
+    return true;
+}
+
+/** Refer interface header for description */
+void LiveView_Respond(LiveView_T * view, const HttpMessage_Head_T * head, const char ** response, uint32_t * length)
+{
+    LiveView_Cache_T * cache;
+    uint8_t resource;
+    bool isHead;
+
+    if ((NULL == view) || (NULL == head) || (NULL == response) || (NULL == length))
+    {
+        return;
+    }
+    if (HTTP_MESSAGE_STATE_BODY != head->State)
+    {
+        LiveView_RespondStatus(view, 400U, true, response, length);
+        return;
+    }
+    isHead = (0 == strcmp(head->Method, "HEAD"));
+    if (!isHead && (0 != strcmp(head->Method, "GET")))
+    {
+        LiveView_RespondStatus(view, 405U, head->IsClose, response, length);
+        return;
+    }
+    resource = LiveViewIsPath(head->Path, "/") ? (uint8_t) LIVE_VIEW_RESOURCE_LATEST : LiveViewFindResource(head->Path);
+    if (resource >= (uint8_t) LIVE_VIEW_RESOURCE_COUNT)
+    {
+        LiveView_RespondStatus(view, 404U, head->IsClose, response, length);
+        return;
+    }
+    if (0UL == view->Count)
+    {
+        LiveView_RespondStatus(view, 503U, head->IsClose, response, length);
+        return;
+    }
+    cache = &view->Caches[resource];
+    if (cache->Generation != view->Generation)
+    {
+        LiveViewRender(view, (LiveView_Resource_T) resource);
+    }
+    else
+    {
+        view->Statistics.CacheHits++;
+    }
+    if (0UL == cache->Length)
+    {
+        LiveView_RespondStatus(view, 500U, head->IsClose, response, length);
+        return;
+    }
+    view->Statistics.Requests++;
+    *response = &cache->Buffer[cache->Offset];
+    *length = isHead ? cache->HeadLength : cache->Length;
+}
+
+/** Refer interface header for description */
+void LiveView_RespondStatus(LiveView_T * view, uint16_t status, bool isClose, const char ** response, uint32_t * length)
+{
+    if ((NULL == view) || (NULL == response) || (NULL == length))
+    {
+        return;
+    }
+    view->Statistics.Requests++;
+    view->Statistics.Errors++;
+    *response = view->Status;
+    *length = HttpMessage_WriteResponseHead(view->Status, sizeof(view->Status), status, LiveViewGetReason(status), "text/plain", 0UL, isClose);
+}
+
+/** Refer interface header for description */
+const LiveView_Statistics_T * LiveView_GetStatistics(const LiveView_T * view)
+{
+    return (NULL == view) ? NULL : &view->Statistics;
+}
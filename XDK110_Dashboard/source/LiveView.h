@@ -0,0 +1,208 @@
+/**
+ *  @file
+ *
+ *  @brief HTTP/JSON view of the latest snapshot and a short history, for
+ *  clients on the local network.
+ *
+ *  The view keeps the last snapshots in a ring owned by the caller and answers
+ *  parsed request heads (HttpMessage.h) with complete responses, head and body
+ *  in one contiguous buffer ready for the socket:
+ *  - GET / or /latest: {"timestamp_ms":T,"values":{"AccelerometerX":0.12,...},"units":{...}}
+ *  - GET /history: {"timestamp_ms":[T0,...],"values":{"AccelerometerX":[v0,...],...}},
+ *    oldest first, one array per channel
+ *  - HEAD of both, 404 for other paths, 405 for other methods
+ *
+ *  Values are in the unit of their channel (SensorTable_GetValue), a value
+ *  which is not finite is null.
+ *
+ *  A response is rendered on the first request after the snapshot changed and
+ *  served from its buffer until the next change, so a dashboard polling faster
+ *  than the sampling costs a copy, not a render. The caches are independent:
+ *  a client reading only /latest never renders the history.
+ *
+ *  Cached responses say Connection: keep-alive; a client which asked for
+ *  close gets the same bytes and the server closes after them.
+ *
+ *  Pure C, no RTOS or platform dependency: also compiles on the host. The
+ *  view is not locked, one task serves it and passes it the snapshots.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LIVEVIEW_H_
+#define LIVEVIEW_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "HttpMessage.h"
+#include "SensorSnapshot.h"
+
+/* local type and macro definitions */
+
+/** Room kept in front of a rendered body for its response head */
+#define LIVE_VIEW_HEAD_ROOM                 UINT32_C(128)
+
+/** Size of the buffer of a status response without body */
+#define LIVE_VIEW_STATUS_SIZE               UINT32_C(128)
+
+/** Longest key or unit of a channel, with its quotes and separators */
+#define LIVE_VIEW_MAX_NAME                  UINT32_C(24)
+
+/** Longest value, "%g" of a negative float with exponent, and its comma */
+#define LIVE_VIEW_MAX_VALUE                 UINT32_C(13)
+
+/** Longest timestamp, 10 digits and its comma */
+#define LIVE_VIEW_MAX_TIMESTAMP             UINT32_C(11)
+
+/** Buffer size of /latest, worst case: head room, fixed text, key, value and unit of every channel,
+ * and the reserve the renderer asks the payload writer for */
+#define LIVE_VIEW_LATEST_SIZE \
+    (LIVE_VIEW_HEAD_ROOM + UINT32_C(64) + (SENSOR_SNAPSHOT_CHANNEL_COUNT * ((2UL * LIVE_VIEW_MAX_NAME) + LIVE_VIEW_MAX_VALUE + LIVE_VIEW_MAX_NAME)) + \
+            PAYLOAD_WRITER_MAX_RESERVE)
+
+/** Buffer size of /history for length snapshots, worst case */
+#define LIVE_VIEW_HISTORY_SIZE(length) \
+    (LIVE_VIEW_HEAD_ROOM + UINT32_C(64) + ((length) * LIVE_VIEW_MAX_TIMESTAMP) + \
+            (SENSOR_SNAPSHOT_CHANNEL_COUNT * (LIVE_VIEW_MAX_NAME + ((length) * LIVE_VIEW_MAX_VALUE))) + PAYLOAD_WRITER_MAX_RESERVE)
+
+/**
+ * @brief Cached resources.
+ */
+enum LiveView_Resource_E
+{
+    LIVE_VIEW_RESOURCE_LATEST = 0,
+    LIVE_VIEW_RESOURCE_HISTORY,
+    LIVE_VIEW_RESOURCE_COUNT
+};
+typedef enum LiveView_Resource_E LiveView_Resource_T;
+
+/**
+ * @brief View configuration, the buffers are owned by the caller.
+ */
+struct LiveView_Setup_S
+{
+    SensorSnapshot_T * History; /**< Ring of the last snapshots */
+    uint32_t HistoryLength; /**< Snapshots in History */
+    char * LatestBuffer; /**< Response of /latest, LIVE_VIEW_LATEST_SIZE bytes */
+    uint32_t LatestSize;
+    char * HistoryBuffer; /**< Response of /history, LIVE_VIEW_HISTORY_SIZE(HistoryLength) bytes */
+    uint32_t HistorySize;
+};
+typedef struct LiveView_Setup_S LiveView_Setup_T;
+
+/**
+ * @brief Rendered response of a resource.
+ */
+struct LiveView_Cache_S
+{
+    char * Buffer;
+    uint32_t Size;
+    uint32_t Generation; /**< View generation rendered, 0 for none */
+    uint32_t Offset; /**< Start of the head in Buffer */
+    uint32_t HeadLength;
+    uint32_t Length; /**< Head and body, 0 if the body did not fit */
+};
+typedef struct LiveView_Cache_S LiveView_Cache_T;
+
+/**
+ * @brief View counters.
+ */
+struct LiveView_Statistics_S
+{
+    uint32_t Updates; /**< Snapshots added to the history */
+    uint32_t Requests; /**< Heads answered, status responses included */
+    uint32_t CacheHits; /**< Requests served from a rendered response */
+    uint32_t Renders;
+    uint32_t Overflows; /**< Renders whose body did not fit, answered with 500 */
+    uint32_t Errors; /**< Status responses: 4xx, 500 and 503 */
+};
+typedef struct LiveView_Statistics_S LiveView_Statistics_T;
+
+/**
+ * @brief View state.
+ */
+struct LiveView_S
+{
+    LiveView_Setup_T Setup;
+    uint32_t Count; /**< Snapshots held, up to HistoryLength */
+    uint32_t Next; /**< Ring index of the next snapshot */
+    uint32_t Generation; /**< Incremented by every snapshot added */
+    LiveView_Cache_T Caches[LIVE_VIEW_RESOURCE_COUNT];
+    char Status[LIVE_VIEW_STATUS_SIZE]; /**< Last status response */
+    LiveView_Statistics_T Statistics;
+};
+typedef struct LiveView_S LiveView_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes an empty view.
+ *
+ * @param[out] view
+ * View state
+ *
+ * @param[in] setup
+ * Configuration, copied
+ *
+ * @return false on invalid parameters or buffers smaller than a response head.
+ */
+bool LiveView_Init(LiveView_T * view, const LiveView_Setup_T * setup);
+
+/**
+ * @brief Adds a snapshot if it is newer than the last one added.
+ *
+ * @param[in] view
+ * View state
+ *
+ * @param[in] snapshot
+ * Snapshot, copied; one with TimestampMs 0 holds no reading yet and is ignored
+ *
+ * @return true if the snapshot was added, i.e. the responses will be rendered again.
+ */
+bool LiveView_Update(LiveView_T * view, const SensorSnapshot_T * snapshot);
+
+/**
+ * @brief Returns the response to a request.
+ *
+ * @param[in] view
+ * View state
+ *
+ * @param[in] head
+ * Complete request head (State HTTP_MESSAGE_STATE_BODY)
+ *
+ * @param[out] response
+ * Response bytes, valid until the next call of LiveView_Update, LiveView_Respond or LiveView_RespondStatus
+ *
+ * @param[out] length
+ * Bytes in response
+ */
+void LiveView_Respond(LiveView_T * view, const HttpMessage_Head_T * head, const char ** response, uint32_t * length);
+
+/**
+ * @brief Returns a response without body, e.g. 503 for a client beyond the connection limit.
+ *
+ * @param[in] view
+ * View state
+ *
+ * @param[in] status
+ * Status code, 400, 404, 405, 500 or 503
+ *
+ * @param[in] isClose
+ * true to answer with Connection: close
+ *
+ * @param[out] response
+ * Response bytes, valid until the next call of LiveView_RespondStatus
+ *
+ * @param[out] length
+ * Bytes in response
+ */
+void LiveView_RespondStatus(LiveView_T * view, uint16_t status, bool isClose, const char ** response, uint32_t * length);
+
+/**
+ * @brief Returns the counters of the view.
+ */
+const LiveView_Statistics_T * LiveView_GetStatistics(const LiveView_T * view);
+
+#endif /* LIVEVIEW_H_ */
@@ -0,0 +1,389 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the live view agent.
+ *
+ *  The listen socket is non-blocking, so a connection which went away between
+ *  sl_Select and sl_Accept costs nothing. The accepted sockets block: they are
+ *  only read when sl_Select reported data, and written with the whole response.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_LIVE_VIEW_AGENT
+
+#include "LiveViewAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "simplelink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "StaticRtos.h"
+
+/* constant definitions ***************************************************** */
+
+#define LIVE_VIEW_AGENT_RECEIVE_SIZE        UINT16_C(128)
+#define LIVE_VIEW_AGENT_SEGMENT_SIZE        UINT16_C(1460) /**< Largest sl_Send */
+#define LIVE_VIEW_AGENT_LISTEN_BACKLOG      INT16_C(2)
+
+/**
+ * @brief Connection slot.
+ */
+struct AgentConnection_S
+{
+    int16_t Socket; /**< -1 for a free slot */
+    uint32_t ActiveMs; /**< Time of the accept or of the last request */
+    HttpMessage_Head_T Head; /**< Request being received */
+};
+typedef struct AgentConnection_S AgentConnection_T;
+
+/* local variables ********************************************************** */
+
+static const LiveViewAgent_Setup_T * AgentSetup = NULL;
+
+static LiveView_T AgentView;
+
+static SensorSnapshot_T AgentHistory[LIVE_VIEW_AGENT_HISTORY_LENGTH];
+
+static char AgentLatestBuffer[LIVE_VIEW_LATEST_SIZE];
+
+static char AgentHistoryBuffer[LIVE_VIEW_HISTORY_SIZE(LIVE_VIEW_AGENT_HISTORY_LENGTH)];
+
+static SensorSnapshot_T AgentSnapshot; /**< Copy of the snapshot of the setup */
+
+static AgentConnection_T AgentConnections[LIVE_VIEW_AGENT_MAX_CONNECTIONS];
+
+static uint8_t AgentOpenConnections = 0U;
+
+static int16_t AgentListenSocket = -1;
+
+static uint8_t AgentReceiveBuffer[LIVE_VIEW_AGENT_RECEIVE_SIZE];
+
+static LiveViewAgent_Statistics_T AgentStatistics;
+
+static xTaskHandle AgentTaskHandle = NULL;
+
+STATIC_RTOS_TASK(AgentTaskStorage, TASK_STACK_SIZE_LIVE_VIEW_AGENT);
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Sends all of data on a blocking socket.
+ */
+static bool AgentSend(int16_t socket, const char * data, uint32_t length)
+{
+    int16_t sent;
+
+    while (0UL != length)
+    {
+        sent = sl_Send(socket, data, (int16_t) ((length < LIVE_VIEW_AGENT_SEGMENT_SIZE) ? length : LIVE_VIEW_AGENT_SEGMENT_SIZE), 0);
+        if (sent <= 0)
+        {
+            return false;
+        }
+        AgentStatistics.BytesSent += (uint32_t) sent;
+        data += sent;
+        length -= (uint32_t) sent;
+    }
+    return true;
+}
+
+static void AgentClose(AgentConnection_T * connection)
+{
+    (void) sl_Close(connection->Socket);
+    connection->Socket = -1;
+    AgentOpenConnections--;
+}
+
+/**
+ * @brief Accepts a waiting client into a free slot, or answers it with 503.
+ */
+static void AgentAccept(void)
+{
+    SlSockAddrIn_t address;
+    SlSocklen_t addressLength = sizeof(address);
+    SlSockNonblocking_t nonblocking = { .NonblockingEnabled = 0U };
+    const char * response;
+    uint32_t length;
+    int16_t socket;
+    uint8_t index;
+
+    socket = sl_Accept(AgentListenSocket, (SlSockAddr_t *) &address, &addressLength);
+    if (0 > socket)
+    {
+        return;
+    }
+    if (AgentOpenConnections >= AgentSetup->MaxConnections)
+    {
+        LiveView_RespondStatus(&AgentView, 503U, true, &response, &length);
+        (void) AgentSend(socket, response, length);
+        (void) sl_Close(socket);
+        AgentStatistics.Refused++;
+        return;
+    }
+    (void) sl_SetSockOpt(socket, SL_SOL_SOCKET, SL_SO_NONBLOCKING, &nonblocking, sizeof(nonblocking));
+    for (index = 0U; AgentConnections[index].Socket >= 0; index++)
+    {
+    }
+    AgentConnections[index].Socket = socket;
+    AgentConnections[index].ActiveMs = AgentNowMs();
+    HttpMessage_InitHead(&AgentConnections[index].Head, false);
+    AgentOpenConnections++;
+    AgentStatistics.Connections++;
+    if (AgentOpenConnections > AgentStatistics.PeakConnections)
+    {
+        AgentStatistics.PeakConnections = AgentOpenConnections;
+    }
+}
+
+/**
+ * @brief Reads what a client sent and answers every request head completed by it.
+ */
+static void AgentReceive(AgentConnection_T * connection)
+{
+    const char * response;
+    uint32_t length;
+    uint32_t offset = 0UL;
+    uint32_t startMs;
+    int16_t received;
+    bool isClose;
+
+    received = sl_Recv(connection->Socket, AgentReceiveBuffer, sizeof(AgentReceiveBuffer), 0);
+    if (received <= 0)
+    {
+        if (0 > received)
+        {
+            AgentStatistics.Failures++;
+        }
+        AgentClose(connection);
+        return;
+    }
+    connection->ActiveMs = AgentNowMs();
+    while (offset < (uint32_t) received)
+    {
+        offset += HttpMessage_ParseHead(&connection->Head, &AgentReceiveBuffer[offset], (uint32_t) received - offset);
+        if ((HTTP_MESSAGE_STATE_BODY != connection->Head.State) && (HTTP_MESSAGE_STATE_ERROR != connection->Head.State))
+        {
+            continue;
+        }
+        startMs = AgentNowMs();
+        LiveView_Respond(&AgentView, &connection->Head, &response, &length);
+        /* A request body would be parsed as the next head, none of the resources takes one */
+        isClose = (HTTP_MESSAGE_STATE_ERROR == connection->Head.State) || connection->Head.IsClose || connection->Head.IsChunked ||
+                (connection->Head.HasContentLength && (0UL != connection->Head.ContentLength));
+        if (!AgentSend(connection->Socket, response, length))
+        {
+            AgentStatistics.Failures++;
+            isClose = true;
+        }
+        if ((AgentNowMs() - startMs) > AgentStatistics.MaxServeMs)
+        {
+            AgentStatistics.MaxServeMs = AgentNowMs() - startMs;
+        }
+        if (isClose)
+        {
+            AgentClose(connection);
+            return;
+        }
+        HttpMessage_InitHead(&connection->Head, false);
+    }
+}
+
+/**
+ * @brief Copies the snapshot into the view, a new one invalidates the rendered responses.
+ */
+static void AgentUpdateView(void)
+{
+    taskENTER_CRITICAL();
+    AgentSnapshot = *AgentSetup->Snapshot;
+    taskEXIT_CRITICAL();
+    (void) LiveView_Update(&AgentView, &AgentSnapshot);
+}
+
+/**
+ * @brief Waits for clients and their requests.
+ */
+static void AgentTask(void * pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    SlFdSet_t readSet;
+    struct SlTimeval_t timeout;
+    uint32_t reportMs = AgentNowMs();
+    uint32_t reportRequests = 0UL;
+    int16_t highest;
+    uint8_t index;
+
+    for (;;)
+    {
+        AgentUpdateView();
+
+        SL_FD_ZERO(&readSet);
+        SL_FD_SET(AgentListenSocket, &readSet);
+        highest = AgentListenSocket;
+        for (index = 0U; index < LIVE_VIEW_AGENT_MAX_CONNECTIONS; index++)
+        {
+            if (AgentConnections[index].Socket >= 0)
+            {
+                SL_FD_SET(AgentConnections[index].Socket, &readSet);
+                highest = (AgentConnections[index].Socket > highest) ? AgentConnections[index].Socket : highest;
+            }
+        }
+        timeout.tv_sec = 0;
+        timeout.tv_usec = LIVE_VIEW_AGENT_POLL_MS * 1000UL;
+        if (0 < sl_Select(highest + 1, &readSet, NULL, NULL, &timeout))
+        {
+            for (index = 0U; index < LIVE_VIEW_AGENT_MAX_CONNECTIONS; index++)
+            {
+                if ((AgentConnections[index].Socket >= 0) && SL_FD_ISSET(AgentConnections[index].Socket, &readSet))
+                {
+                    AgentReceive(&AgentConnections[index]);
+                }
+            }
+            if (SL_FD_ISSET(AgentListenSocket, &readSet))
+            {
+                AgentAccept();
+            }
+        }
+
+        for (index = 0U; index < LIVE_VIEW_AGENT_MAX_CONNECTIONS; index++)
+        {
+            if ((AgentConnections[index].Socket >= 0) && ((AgentNowMs() - AgentConnections[index].ActiveMs) >= AgentSetup->IdleTimeoutMs))
+            {
+                AgentStatistics.Timeouts++;
+                AgentClose(&AgentConnections[index]);
+            }
+        }
+        if ((AgentNowMs() - reportMs) >= LIVE_VIEW_AGENT_REPORT_MS)
+        {
+            if (reportRequests != AgentView.Statistics.Requests)
+            {
+                reportRequests = AgentView.Statistics.Requests;
+                LiveViewAgent_PrintReport();
+            }
+            reportMs = AgentNowMs();
+        }
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T LiveViewAgent_Setup(const LiveViewAgent_Setup_T * setup)
+{
+    LiveView_Setup_T viewSetup;
+    uint8_t index;
+
+    if ((NULL == setup) || (NULL == setup->Snapshot))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0U == setup->MaxConnections) || (setup->MaxConnections > LIVE_VIEW_AGENT_MAX_CONNECTIONS) || (0UL == setup->IdleTimeoutMs))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    viewSetup.History = AgentHistory;
+    viewSetup.HistoryLength = LIVE_VIEW_AGENT_HISTORY_LENGTH;
+    viewSetup.LatestBuffer = AgentLatestBuffer;
+    viewSetup.LatestSize = sizeof(AgentLatestBuffer);
+    viewSetup.HistoryBuffer = AgentHistoryBuffer;
+    viewSetup.HistorySize = sizeof(AgentHistoryBuffer);
+    if (!LiveView_Init(&AgentView, &viewSetup))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    for (index = 0U; index < LIVE_VIEW_AGENT_MAX_CONNECTIONS; index++)
+    {
+        AgentConnections[index].Socket = -1;
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T LiveViewAgent_Enable(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+    SlSockAddrIn_t localAddress;
+    SlSockNonblocking_t nonblocking = { .NonblockingEnabled = 1U };
+    SlNetCfgIpV4Args_t ipV4;
+    _u8 length = (_u8) sizeof(ipV4);
+    _u8 isDhcp = 0U;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    AgentListenSocket = sl_Socket(SL_AF_INET, SL_SOCK_STREAM, SL_IPPROTO_TCP);
+    if (0 > AgentListenSocket)
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        memset(&localAddress, 0, sizeof(localAddress));
+        localAddress.sin_family = SL_AF_INET;
+        localAddress.sin_port = sl_Htons(AgentSetup->Port);
+        localAddress.sin_addr.s_addr = 0UL;
+        if ((0 > sl_Bind(AgentListenSocket, (SlSockAddr_t *) &localAddress, sizeof(localAddress))) ||
+                (0 > sl_Listen(AgentListenSocket, LIVE_VIEW_AGENT_LISTEN_BACKLOG)) ||
+                (0 > sl_SetSockOpt(AgentListenSocket, SL_SOL_SOCKET, SL_SO_NONBLOCKING, &nonblocking, sizeof(nonblocking))))
+        {
+            printf("LiveViewAgent_Enable : Listening on port %u failed \r\n", (unsigned int) AgentSetup->Port);
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentTaskHandle = StaticRtos_CreateTask(&AgentTaskStorage, AgentTask, "LiveViewAgent", NULL, TASK_PRIO_LIVE_VIEW_AGENT);
+        if (NULL == AgentTaskHandle)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    if ((RETCODE_OK != retcode) && (0 <= AgentListenSocket))
+    {
+        (void) sl_Close(AgentListenSocket);
+        AgentListenSocket = -1;
+    }
+    if ((RETCODE_OK == retcode) && (0 <= sl_NetCfgGet(SL_IPV4_STA_P2P_CL_GET_INFO, &isDhcp, &length, (_u8 *) &ipV4)))
+    {
+        printf("LiveViewAgent : http://%u.%u.%u.%u:%u/latest \r\n", (unsigned int) ((ipV4.ipV4 >> 24) & 0xFFUL),
+                (unsigned int) ((ipV4.ipV4 >> 16) & 0xFFUL), (unsigned int) ((ipV4.ipV4 >> 8) & 0xFFUL),
+                (unsigned int) (ipV4.ipV4 & 0xFFUL), (unsigned int) AgentSetup->Port);
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const LiveViewAgent_Statistics_T * LiveViewAgent_GetStatistics(void)
+{
+    return &AgentStatistics;
+}
+
+/** Refer interface header for description */
+void LiveViewAgent_PrintReport(void)
+{
+    const LiveView_Statistics_T * view = LiveView_GetStatistics(&AgentView);
+
+    printf("LiveViewAgent : %lu connections, %lu refused, %lu timed out, %lu failed, peak %u open, %lu bytes sent \r\n",
+            (unsigned long) AgentStatistics.Connections, (unsigned long) AgentStatistics.Refused, (unsigned long) AgentStatistics.Timeouts,
+            (unsigned long) AgentStatistics.Failures, (unsigned int) AgentStatistics.PeakConnections, (unsigned long) AgentStatistics.BytesSent);
+    printf("LiveViewAgent : %lu requests, %lu from cache, %lu renders, %lu errors, %lu overflows, slowest %lu ms \r\n",
+            (unsigned long) view->Requests, (unsigned long) view->CacheHits, (unsigned long) view->Renders,
+            (unsigned long) view->Errors, (unsigned long) view->Overflows, (unsigned long) AgentStatistics.MaxServeMs);
+}
@@ -0,0 +1,95 @@
+/**
+ *  @file
+ *
+ *  @brief Serves the LiveView of the latest snapshot over HTTP on the WLAN,
+ *  through a SimpleLink TCP listen socket.
+ *
+ *  One task accepts the clients and answers their requests; it waits in
+ *  sl_Select on the listen socket and the open connections, and at least every
+ *  LIVE_VIEW_AGENT_POLL_MS copies the snapshot into the view. Connections are
+ *  kept open for further requests (HTTP/1.1 keep-alive) until the client
+ *  closes them or stays idle for IdleTimeoutMs. A client beyond
+ *  MaxConnections is answered with 503 and closed, so the sockets of the WLAN
+ *  chip stay available for the uploads.
+ *
+ *  Responses go out with blocking sends: they are a few KB, within the send
+ *  window of a client on the local network.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LIVEVIEWAGENT_H_
+#define LIVEVIEWAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "LiveView.h"
+
+/* local type and macro definitions */
+
+#define LIVE_VIEW_AGENT_MAX_CONNECTIONS     UINT8_C(4) /**< Connection slots, the highest MaxConnections */
+#define LIVE_VIEW_AGENT_HISTORY_LENGTH      UINT32_C(20) /**< Snapshots of /history */
+#define LIVE_VIEW_AGENT_POLL_MS             UINT32_C(100) /**< Longest wait in sl_Select, the latency of a new snapshot */
+#define LIVE_VIEW_AGENT_REPORT_MS           UINT32_C(60000) /**< Period of the report, printed if there were requests */
+
+/**
+ * @brief Agent configuration.
+ */
+struct LiveViewAgent_Setup_S
+{
+    uint16_t Port; /**< TCP port to listen on */
+    uint8_t MaxConnections; /**< Clients served at a time, 1 to LIVE_VIEW_AGENT_MAX_CONNECTIONS */
+    uint32_t IdleTimeoutMs; /**< A connection without a request for this long is closed */
+    const SensorSnapshot_T * Snapshot; /**< Snapshot the view copies */
+};
+typedef struct LiveViewAgent_Setup_S LiveViewAgent_Setup_T;
+
+/**
+ * @brief Agent counters.
+ */
+struct LiveViewAgent_Statistics_S
+{
+    uint32_t Connections; /**< Connections accepted */
+    uint32_t Refused; /**< Connections answered with 503 beyond MaxConnections */
+    uint32_t Timeouts; /**< Connections closed idle */
+    uint32_t Failures; /**< Connections closed on a send or receive error */
+    uint32_t BytesSent;
+    uint32_t MaxServeMs; /**< Longest time from a complete request head to its response sent */
+    uint8_t PeakConnections;
+};
+typedef struct LiveViewAgent_Statistics_S LiveViewAgent_Statistics_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Stores the agent configuration and initializes the view.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T LiveViewAgent_Setup(const LiveViewAgent_Setup_T * setup);
+
+/**
+ * @brief Opens the listen socket and starts the agent task.
+ *
+ * Requires an established WLAN connection.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T LiveViewAgent_Enable(void);
+
+/**
+ * @brief Returns the counters of the agent.
+ */
+const LiveViewAgent_Statistics_T * LiveViewAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters of the agent and of its view.
+ */
+void LiveViewAgent_PrintReport(void);
+
+#endif /* LIVEVIEWAGENT_H_ */
@@ -0,0 +1,162 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the LoRaWAN uplink task.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_LORA_AGENT
+
+#include "LoRaAgent.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "XDK_LoRa.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "StaticRtos.h"
+
+/* local variables ********************************************************** */
+
+static const LoRaAgent_Setup_T * AgentSetup = NULL;
+
+static DutyCycleScheduler_T AgentScheduler; /**< Scheduler state */
+
+static uint8_t AgentPayload[LORA_PAYLOAD_MAX_SIZE];
+
+static xTaskHandle AgentTaskHandle = NULL;
+
+STATIC_RTOS_TASK(AgentTaskStorage, TASK_STACK_SIZE_LORA_AGENT);
+
+static LoRa_Setup_T LoRaSetupInfo =
+        {
+                .Frequency = LORA_FREQUENCY_EU868, /* Filled in by LoRaAgent_Setup */
+                .DevEUI = NULL,
+                .AppEUI = NULL,
+                .AppKey = NULL,
+        };/**< LoRa setup parameters */
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static void AgentPrintStatistics(void)
+{
+    const DutyCycleScheduler_Statistics_T * statistics = &AgentScheduler.Statistics;
+
+    printf("LoRa : uplinks %lu bytes %lu airtime today %lu ms yesterday %lu ms held duty cycle %lu budget %lu deferred %lu\r\n",
+            (unsigned long) statistics->Uplinks, (unsigned long) statistics->PayloadBytes,
+            (unsigned long) statistics->AirtimeTodayMs, (unsigned long) statistics->AirtimeYesterdayMs,
+            (unsigned long) statistics->HeldByDutyCycle, (unsigned long) statistics->HeldByBudget,
+            (unsigned long) statistics->ItemsDeferred);
+}
+
+/**
+ * @brief Asks the scheduler for an uplink every poll interval and transmits it.
+ */
+static void AgentTask(void * pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    TickType_t lastWakeTime = xTaskGetTickCount();
+    uint32_t lastPrintMs = AgentNowMs();
+    uint8_t size;
+    Retcode_T retcode;
+
+    for (;;)
+    {
+        vTaskDelayUntil(&lastWakeTime, pdMS_TO_TICKS(AgentSetup->PollIntervalMs));
+        size = DutyCycleScheduler_Poll(&AgentScheduler, AgentSetup->Snapshot, AgentNowMs(), AgentPayload);
+        if (0U != size)
+        {
+            retcode = LoRa_SendUnconfirmed(AgentSetup->Port, AgentPayload, size);
+            /* A refused uplink keeps its items changed, they go out with the next one */
+            DutyCycleScheduler_Confirm(&AgentScheduler, AgentNowMs(), (RETCODE_OK == retcode));
+            if (RETCODE_OK != retcode)
+            {
+                Retcode_RaiseError(retcode);
+            }
+        }
+        if ((0UL != AgentSetup->StatisticsIntervalMs) && ((AgentNowMs() - lastPrintMs) >= AgentSetup->StatisticsIntervalMs))
+        {
+            lastPrintMs = AgentNowMs();
+            AgentPrintStatistics();
+        }
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T LoRaAgent_Setup(const LoRaAgent_Setup_T * setup)
+{
+    if ((NULL == setup) || (NULL == setup->Snapshot) || (NULL == setup->DevEUI) || (NULL == setup->AppEUI) || (NULL == setup->AppKey))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0UL == setup->PollIntervalMs) || !DutyCycleScheduler_Init(&AgentScheduler, &setup->Scheduler))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentSetup = setup;
+    LoRaSetupInfo.Frequency = (LORA_PAYLOAD_REGION_US915 == setup->Scheduler.Region) ? LORA_FREQUENCY_US915 : LORA_FREQUENCY_EU868;
+    LoRaSetupInfo.DevEUI = setup->DevEUI;
+    LoRaSetupInfo.AppEUI = setup->AppEUI;
+    LoRaSetupInfo.AppKey = setup->AppKey;
+    printf("LoRa : DR%u, up to %u byte payload, %lu us for a full payload\r\n", (unsigned int) setup->Scheduler.DataRate,
+            (unsigned int) AgentScheduler.MaxPayloadSize,
+            (unsigned long) LoRaPayload_GetAirtimeUs(setup->Scheduler.Region, setup->Scheduler.DataRate,
+                    (uint8_t) LoRaPayload_GetSize(setup->Scheduler.Format, LORA_PAYLOAD_ALL_ITEMS)));
+    return LoRa_Setup(&LoRaSetupInfo);
+}
+
+/** Refer interface header for description */
+Retcode_T LoRaAgent_Enable(void)
+{
+    Retcode_T retcode;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    retcode = LoRa_Enable();
+    if (RETCODE_OK == retcode)
+    {
+        retcode = LoRa_Join();
+    }
+    if (RETCODE_OK == retcode)
+    {
+        /* The scheduler sizes payloads and airtime for one data rate, so ADR stays off */
+        retcode = LoRa_SetADR(false);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = LoRa_SetDataRate(AgentSetup->Scheduler.DataRate);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentTaskHandle = StaticRtos_CreateTask(&AgentTaskStorage, AgentTask, "LoRa", NULL, TASK_PRIO_LORA_AGENT);
+        if (NULL == AgentTaskHandle)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const DutyCycleScheduler_Statistics_T * LoRaAgent_GetStatistics(void)
+{
+    return &AgentScheduler.Statistics;
+}
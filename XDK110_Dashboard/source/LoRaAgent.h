@@ -0,0 +1,61 @@
+/**
+ *  @file
+ *
+ *  @brief Sends the sensor values as LoRaWAN uplinks, scheduled by the duty cycle scheduler.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LORAAGENT_H_
+#define LORAAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "SensorSnapshot.h"
+#include "DutyCycleScheduler.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Agent configuration.
+ */
+struct LoRaAgent_Setup_S
+{
+    const char * DevEUI; /**< Device EUI, 16 hex digits */
+    const char * AppEUI; /**< Application (join) EUI, 16 hex digits */
+    const char * AppKey; /**< Application key, 32 hex digits */
+    uint8_t Port; /**< Application port of the uplinks */
+    const SensorSnapshot_T * Snapshot; /**< Latest sensor values */
+    uint32_t PollIntervalMs; /**< Period the scheduler is asked for an uplink */
+    uint32_t StatisticsIntervalMs; /**< Period of the statistics print out, 0 to disable */
+    DutyCycleScheduler_Setup_T Scheduler;
+};
+typedef struct LoRaAgent_Setup_S LoRaAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Sets up the LoRa radio and the scheduler.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T LoRaAgent_Setup(const LoRaAgent_Setup_T * setup);
+
+/**
+ * @brief Joins the network (OTAA) and starts the uplink task.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T LoRaAgent_Enable(void);
+
+/**
+ * @brief Returns the scheduler counters.
+ */
+const DutyCycleScheduler_Statistics_T * LoRaAgent_GetStatistics(void);
+
+#endif /* LORAAGENT_H_ */
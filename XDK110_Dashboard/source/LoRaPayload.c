@@ -0,0 +1,455 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the LoRaWAN payload encoders.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "LoRaPayload.h"
+
+/* system header files */
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define LORA_PAYLOAD_FRAMING_SIZE           UINT8_C(13) /**< MHDR, FHDR without FOpts, FPort and MIC */
+#define LORA_PAYLOAD_PREAMBLE_QUARTERS      UINT32_C(49) /**< 8 + 4.25 preamble symbols, in quarter symbols */
+#define LORA_PAYLOAD_CODING_RATE            UINT32_C(1) /**< 4/5 */
+
+#define LORA_PAYLOAD_LPP_TYPE_ANALOG_INPUT  UINT8_C(0x02)
+#define LORA_PAYLOAD_LPP_TYPE_ILLUMINANCE   UINT8_C(0x65)
+#define LORA_PAYLOAD_LPP_TYPE_TEMPERATURE   UINT8_C(0x67)
+#define LORA_PAYLOAD_LPP_TYPE_HUMIDITY      UINT8_C(0x68)
+#define LORA_PAYLOAD_LPP_TYPE_ACCELEROMETER UINT8_C(0x71)
+#define LORA_PAYLOAD_LPP_TYPE_BAROMETER     UINT8_C(0x73)
+#define LORA_PAYLOAD_LPP_TYPE_GYROMETER     UINT8_C(0x86)
+
+#define LORA_PAYLOAD_SPL_REFERENCE_PA       (20.0e-6f) /**< 0 dB SPL */
+
+/* local types ************************************************************** */
+
+/**
+ * @brief Modulation of one data rate.
+ */
+struct LoRaPayloadDataRate_S
+{
+    uint8_t SpreadingFactor;
+    uint16_t BandwidthKhz;
+    uint8_t MaxSize;
+};
+typedef struct LoRaPayloadDataRate_S LoRaPayloadDataRate_T;
+
+/**
+ * @brief Encoding rules of one item.
+ */
+struct LoRaPayloadItem_S
+{
+    uint8_t Channels[LORA_PAYLOAD_MAX_AXES]; /**< Snapshot channel of every axis */
+    uint8_t AxisCount;
+    uint8_t LppChannel; /**< LPP channel of the item, of the first axis for per axis entries */
+    uint8_t LppType;
+    uint8_t LppAxisSize; /**< Bytes per axis */
+    bool LppPerAxis; /**< Every axis is an own LPP entry (no multi axis LPP type) */
+    bool LppSigned;
+    float LppResolution; /**< Item unit per LPP count */
+    float BitMinimum; /**< Item value encoded as 0 */
+    float BitResolution; /**< Item unit per count */
+    uint8_t BitWidth; /**< Bits per axis */
+};
+typedef struct LoRaPayloadItem_S LoRaPayloadItem_T;
+
+/* local variables ********************************************************** */
+
+/** EU868 uplink data rates DR0 .. DR6 */
+static const LoRaPayloadDataRate_T LoRaPayloadEu868[] =
+        {
+                { 12U, 125U, 51U }, { 11U, 125U, 51U }, { 10U, 125U, 51U }, { 9U, 125U, 115U },
+                { 8U, 125U, 242U }, { 7U, 125U, 242U }, { 7U, 250U, 242U },
+        };
+
+/** US915 uplink data rates DR0 .. DR4 */
+static const LoRaPayloadDataRate_T LoRaPayloadUs915[] =
+        {
+                { 10U, 125U, 11U }, { 9U, 125U, 53U }, { 8U, 125U, 125U }, { 7U, 125U, 242U }, { 8U, 500U, 242U },
+        };
+
+/** Item table, indexed by LoRaPayload_Item_T */
+static const LoRaPayloadItem_T LoRaPayloadItems[LORA_PAYLOAD_ITEM_COUNT] =
+        {
+                {
+                        { SENSOR_SNAPSHOT_ACCELEROMETER_X, SENSOR_SNAPSHOT_ACCELEROMETER_Y, SENSOR_SNAPSHOT_ACCELEROMETER_Z }, 3U,
+                        1U, LORA_PAYLOAD_LPP_TYPE_ACCELEROMETER, 2U, false, true, 0.00980665f, /* 0.001 G */
+                        -80.0f, 0.05f, 12U
+                },
+                {
+                        { SENSOR_SNAPSHOT_GYROSCOPE_X, SENSOR_SNAPSHOT_GYROSCOPE_Y, SENSOR_SNAPSHOT_GYROSCOPE_Z }, 3U,
+                        2U, LORA_PAYLOAD_LPP_TYPE_GYROMETER, 2U, false, true, 0.01f,
+                        -1000.0f, 0.5f, 12U
+                },
+                {
+                        { SENSOR_SNAPSHOT_MAGNETOMETER_X, SENSOR_SNAPSHOT_MAGNETOMETER_Y, SENSOR_SNAPSHOT_MAGNETOMETER_Z }, 3U,
+                        3U, LORA_PAYLOAD_LPP_TYPE_ANALOG_INPUT, 2U, true, true, 1.0f, /* analog 0.01 = 1 uT when read as gauss */
+                        -2500.0f, 1.0f, 13U
+                },
+                {
+                        { SENSOR_SNAPSHOT_TEMPERATURE, 0U, 0U }, 1U,
+                        6U, LORA_PAYLOAD_LPP_TYPE_TEMPERATURE, 2U, false, true, 0.1f,
+                        -40.0f, 0.1f, 11U
+                },
+                {
+                        { SENSOR_SNAPSHOT_HUMIDITY, 0U, 0U }, 1U,
+                        7U, LORA_PAYLOAD_LPP_TYPE_HUMIDITY, 1U, false, false, 0.5f,
+                        0.0f, 1.0f, 7U
+                },
+                {
+                        { SENSOR_SNAPSHOT_PRESSURE, 0U, 0U }, 1U,
+                        8U, LORA_PAYLOAD_LPP_TYPE_BAROMETER, 2U, false, false, 0.1f,
+                        300.0f, 0.1f, 13U
+                },
+                {
+                        { SENSOR_SNAPSHOT_LIGHT, 0U, 0U }, 1U,
+                        9U, LORA_PAYLOAD_LPP_TYPE_ILLUMINANCE, 2U, false, false, 1.0f,
+                        0.0f, 1.0f, 18U
+                },
+                {
+                        { SENSOR_SNAPSHOT_ACOUSTIC, 0U, 0U }, 1U, /* converted to dB SPL */
+                        10U, LORA_PAYLOAD_LPP_TYPE_ANALOG_INPUT, 2U, false, true, 0.01f,
+                        0.0f, 0.5f, 8U
+                },
+        };
+
+/* local functions ********************************************************** */
+
+static const LoRaPayloadDataRate_T * GetDataRate(LoRaPayload_Region_T region, uint8_t dataRate)
+{
+    if ((LORA_PAYLOAD_REGION_EU868 == region) && (dataRate < (sizeof(LoRaPayloadEu868) / sizeof(LoRaPayloadEu868[0]))))
+    {
+        return &LoRaPayloadEu868[dataRate];
+    }
+    if ((LORA_PAYLOAD_REGION_US915 == region) && (dataRate < (sizeof(LoRaPayloadUs915) / sizeof(LoRaPayloadUs915[0]))))
+    {
+        return &LoRaPayloadUs915[dataRate];
+    }
+    return NULL;
+}
+
+static int32_t Quantize(float value, float resolution)
+{
+    return (int32_t) floorf((value / resolution) + 0.5f);
+}
+
+static int32_t Clamp(int32_t value, int32_t minimum, int32_t maximum)
+{
+    return (value < minimum) ? minimum : ((value > maximum) ? maximum : value);
+}
+
+static uint16_t GetLppItemSize(const LoRaPayloadItem_T * item)
+{
+    if (item->LppPerAxis)
+    {
+        return (uint16_t) (item->AxisCount * (2U + item->LppAxisSize));
+    }
+    return (uint16_t) (2U + (item->AxisCount * item->LppAxisSize));
+}
+
+static void WriteBits(uint8_t * buffer, uint32_t * bitPosition, uint32_t value, uint8_t count)
+{
+    while (count > 0U)
+    {
+        count--;
+        if (0UL != ((value >> count) & 1UL))
+        {
+            buffer[*bitPosition >> 3] |= (uint8_t) (0x80U >> (*bitPosition & 7UL));
+        }
+        (*bitPosition)++;
+    }
+}
+
+static uint32_t ReadBits(const uint8_t * buffer, uint32_t * bitPosition, uint8_t count)
+{
+    uint32_t value = 0UL;
+
+    while (count > 0U)
+    {
+        count--;
+        value = (value << 1) | ((buffer[*bitPosition >> 3] >> (7U - (*bitPosition & 7UL))) & 1U);
+        (*bitPosition)++;
+    }
+    return value;
+}
+
+static uint16_t EncodeLpp(const SensorSnapshot_T * snapshot, uint8_t itemMask, uint8_t * buffer)
+{
+    uint16_t position = 0U;
+    uint8_t item;
+    uint8_t axis;
+    uint8_t byte;
+    int32_t raw;
+    int32_t maximum;
+    const LoRaPayloadItem_T * rules;
+
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U == (itemMask & (1U << item)))
+        {
+            continue;
+        }
+        rules = &LoRaPayloadItems[item];
+        for (axis = 0U; axis < rules->AxisCount; axis++)
+        {
+            if ((0U == axis) || rules->LppPerAxis)
+            {
+                buffer[position++] = (uint8_t) (rules->LppChannel + (rules->LppPerAxis ? axis : 0U));
+                buffer[position++] = rules->LppType;
+            }
+            maximum = (int32_t) ((1UL << ((8U * rules->LppAxisSize) - (rules->LppSigned ? 1U : 0U))) - 1UL);
+            raw = Clamp(Quantize(LoRaPayload_GetValue(snapshot, (LoRaPayload_Item_T) item, axis), rules->LppResolution),
+                    rules->LppSigned ? (-maximum - 1) : 0, maximum);
+            for (byte = rules->LppAxisSize; byte > 0U; byte--)
+            {
+                buffer[position++] = (uint8_t) (((uint32_t) raw >> (8U * (byte - 1U))) & 0xFFUL);
+            }
+        }
+    }
+    return position;
+}
+
+static uint16_t EncodeBitPacked(const SensorSnapshot_T * snapshot, uint8_t itemMask, uint8_t * buffer, uint16_t size)
+{
+    uint32_t bitPosition = 8UL;
+    uint8_t item;
+    uint8_t axis;
+    int32_t raw;
+    const LoRaPayloadItem_T * rules;
+
+    memset(buffer, 0, size);
+    buffer[0] = itemMask;
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U == (itemMask & (1U << item)))
+        {
+            continue;
+        }
+        rules = &LoRaPayloadItems[item];
+        for (axis = 0U; axis < rules->AxisCount; axis++)
+        {
+            raw = Quantize(LoRaPayload_GetValue(snapshot, (LoRaPayload_Item_T) item, axis) - rules->BitMinimum, rules->BitResolution);
+            raw = Clamp(raw, 0, (int32_t) ((1UL << rules->BitWidth) - 1UL));
+            WriteBits(buffer, &bitPosition, (uint32_t) raw, rules->BitWidth);
+        }
+    }
+    return size;
+}
+
+static bool DecodeLpp(const uint8_t * payload, uint16_t length, LoRaPayload_Values_T * values)
+{
+    uint16_t position = 0U;
+    uint8_t item;
+    uint8_t axis;
+    uint8_t firstAxis;
+    uint8_t axisCount;
+    uint8_t byte;
+    uint32_t raw;
+    const LoRaPayloadItem_T * rules;
+
+    while (position < length)
+    {
+        if ((position + 2U) > length)
+        {
+            return false;
+        }
+        rules = NULL;
+        for (item = 0U; (item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT) && (NULL == rules); item++)
+        {
+            axisCount = LoRaPayloadItems[item].LppPerAxis ? LoRaPayloadItems[item].AxisCount : 1U;
+            if ((payload[position] >= LoRaPayloadItems[item].LppChannel) &&
+                    (payload[position] < (LoRaPayloadItems[item].LppChannel + axisCount)) &&
+                    (payload[position + 1U] == LoRaPayloadItems[item].LppType))
+            {
+                rules = &LoRaPayloadItems[item];
+                break;
+            }
+        }
+        if (NULL == rules)
+        {
+            return false;
+        }
+        firstAxis = rules->LppPerAxis ? (uint8_t) (payload[position] - rules->LppChannel) : 0U;
+        axisCount = rules->LppPerAxis ? 1U : rules->AxisCount;
+        position += 2U;
+        if ((position + (axisCount * rules->LppAxisSize)) > length)
+        {
+            return false;
+        }
+        for (axis = firstAxis; axis < (firstAxis + axisCount); axis++)
+        {
+            raw = 0UL;
+            for (byte = 0U; byte < rules->LppAxisSize; byte++)
+            {
+                raw = (raw << 8) | payload[position++];
+            }
+            if (rules->LppSigned && (0UL != (raw & (1UL << ((8U * rules->LppAxisSize) - 1U)))))
+            {
+                raw |= ~((1UL << (8U * rules->LppAxisSize)) - 1UL); /* sign extension */
+            }
+            values->Values[item][axis] = (rules->LppSigned ? (float) (int32_t) raw : (float) raw) * rules->LppResolution;
+        }
+        values->ItemMask |= (uint8_t) (1U << item);
+    }
+    return true;
+}
+
+static bool DecodeBitPacked(const uint8_t * payload, uint16_t length, LoRaPayload_Values_T * values)
+{
+    uint32_t bitPosition = 8UL;
+    uint8_t item;
+    uint8_t axis;
+    const LoRaPayloadItem_T * rules;
+
+    if ((length < 1U) || (length != LoRaPayload_GetSize(LORA_PAYLOAD_FORMAT_BIT_PACKED, payload[0])) ||
+            (0U != (payload[0] & (uint8_t) ~LORA_PAYLOAD_ALL_ITEMS)))
+    {
+        return false;
+    }
+    values->ItemMask = payload[0];
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U == (payload[0] & (1U << item)))
+        {
+            continue;
+        }
+        rules = &LoRaPayloadItems[item];
+        for (axis = 0U; axis < rules->AxisCount; axis++)
+        {
+            values->Values[item][axis] = rules->BitMinimum +
+                    ((float) ReadBits(payload, &bitPosition, rules->BitWidth) * rules->BitResolution);
+        }
+    }
+    return true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+uint8_t LoRaPayload_GetMaxSize(LoRaPayload_Region_T region, uint8_t dataRate)
+{
+    const LoRaPayloadDataRate_T * rate = GetDataRate(region, dataRate);
+
+    return (NULL == rate) ? 0U : rate->MaxSize;
+}
+
+/** Refer interface header for description */
+uint32_t LoRaPayload_GetAirtimeUs(LoRaPayload_Region_T region, uint8_t dataRate, uint8_t payloadSize)
+{
+    const LoRaPayloadDataRate_T * rate = GetDataRate(region, dataRate);
+    uint32_t symbolUs;
+    uint32_t lowDataRate;
+    int32_t numerator;
+    int32_t denominator;
+    uint32_t payloadSymbols = 8UL;
+
+    if (NULL == rate)
+    {
+        return 0UL;
+    }
+    symbolUs = ((UINT32_C(1) << rate->SpreadingFactor) * 1000UL) / rate->BandwidthKhz;
+    lowDataRate = ((rate->SpreadingFactor >= 11U) && (125U == rate->BandwidthKhz)) ? 1UL : 0UL;
+
+    /* Semtech AN1200.13: 8 + max(ceil((8 PL - 4 SF + 28 + 16 CRC - 20 IH) / (4 (SF - 2 DE))) (CR + 4), 0) */
+    numerator = (8 * (int32_t) (payloadSize + LORA_PAYLOAD_FRAMING_SIZE)) - (4 * (int32_t) rate->SpreadingFactor) + 28 + 16;
+    denominator = 4 * ((int32_t) rate->SpreadingFactor - (2 * (int32_t) lowDataRate));
+    if (numerator > 0)
+    {
+        payloadSymbols += (uint32_t) ((numerator + denominator - 1) / denominator) * (LORA_PAYLOAD_CODING_RATE + 4UL);
+    }
+    return ((LORA_PAYLOAD_PREAMBLE_QUARTERS * symbolUs) / 4UL) + (payloadSymbols * symbolUs);
+}
+
+/** Refer interface header for description */
+uint8_t LoRaPayload_GetAxisCount(LoRaPayload_Item_T item)
+{
+    return ((uint8_t) item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT) ? LoRaPayloadItems[item].AxisCount : 0U;
+}
+
+/** Refer interface header for description */
+float LoRaPayload_GetValue(const SensorSnapshot_T * snapshot, LoRaPayload_Item_T item, uint8_t axis)
+{
+    const LoRaPayloadItem_T * rules;
+    float value;
+
+    if (((uint8_t) item >= (uint8_t) LORA_PAYLOAD_ITEM_COUNT) || (axis >= LoRaPayloadItems[item].AxisCount))
+    {
+        return 0.0f;
+    }
+    rules = &LoRaPayloadItems[item];
+    value = SensorTable_GetValue(snapshot->Values, rules->Channels[axis]);
+    if (LORA_PAYLOAD_ITEM_ACOUSTIC == item)
+    {
+        value = (value > LORA_PAYLOAD_SPL_REFERENCE_PA) ? (20.0f * log10f(value / LORA_PAYLOAD_SPL_REFERENCE_PA)) : 0.0f;
+    }
+    return value;
+}
+
+/** Refer interface header for description */
+uint16_t LoRaPayload_GetSize(LoRaPayload_Format_T format, uint8_t itemMask)
+{
+    uint32_t size = 0UL;
+    uint8_t item;
+
+    for (item = 0U; item < (uint8_t) LORA_PAYLOAD_ITEM_COUNT; item++)
+    {
+        if (0U != (itemMask & (1U << item)))
+        {
+            size += (LORA_PAYLOAD_FORMAT_CAYENNE_LPP == format) ? GetLppItemSize(&LoRaPayloadItems[item]) :
+                    (uint32_t) (LoRaPayloadItems[item].AxisCount * LoRaPayloadItems[item].BitWidth);
+        }
+    }
+    if (LORA_PAYLOAD_FORMAT_BIT_PACKED == format)
+    {
+        size = 1UL + ((size + 7UL) / 8UL);
+    }
+    return (uint16_t) size;
+}
+
+/** Refer interface header for description */
+uint16_t LoRaPayload_Encode(LoRaPayload_Format_T format, const SensorSnapshot_T * snapshot, uint8_t itemMask,
+        uint8_t * buffer, uint16_t capacity)
+{
+    uint16_t size;
+
+    if ((NULL == snapshot) || (NULL == buffer))
+    {
+        return 0U;
+    }
+    itemMask &= LORA_PAYLOAD_ALL_ITEMS;
+    size = LoRaPayload_GetSize(format, itemMask);
+    if ((0U == itemMask) || (size > capacity))
+    {
+        return 0U;
+    }
+    if (LORA_PAYLOAD_FORMAT_CAYENNE_LPP == format)
+    {
+        return EncodeLpp(snapshot, itemMask, buffer);
+    }
+    return EncodeBitPacked(snapshot, itemMask, buffer, size);
+}
+
+/** Refer interface header for description */
+bool LoRaPayload_Decode(LoRaPayload_Format_T format, const uint8_t * payload, uint16_t length, LoRaPayload_Values_T * values)
+{
+    if ((NULL == payload) || (NULL == values))
+    {
+        return false;
+    }
+    memset(values, 0, sizeof(*values));
+    if (LORA_PAYLOAD_FORMAT_CAYENNE_LPP == format)
+    {
+        return DecodeLpp(payload, length, values);
+    }
+    return DecodeBitPacked(payload, length, values);
+}
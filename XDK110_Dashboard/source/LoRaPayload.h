@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *
+ *  @brief LoRaWAN payload encoders for the sensor snapshot.
+ *
+ *  The snapshot channels are grouped into items (one per sensor). An item is
+ *  either sent completely or not at all, so a payload can carry any subset of
+ *  items and be sized to the maximum payload of the current data rate.
+ *
+ *  Two formats are supported:
+ *  - Cayenne LPP: self describing, understood by most network server
+ *    integrations. Magnetometer axes and the sound pressure level have no LPP
+ *    type and are sent as analog inputs (gauss and dB SPL).
+ *  - Bit packed: one byte item bitmap followed by the present items in item
+ *    order, every axis quantized to a fixed width (see the item table),
+ *    MSB first. Less than half the size of LPP.
+ *
+ *  Also provides the regional data rate limits and the LoRa time on air
+ *  calculation the duty cycle scheduler is based on.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LORAPAYLOAD_H_
+#define LORAPAYLOAD_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorSnapshot.h"
+
+/* local type and macro definitions */
+
+/** Largest application payload of any supported region and data rate */
+#define LORA_PAYLOAD_MAX_SIZE               UINT8_C(242)
+
+/** Maximum number of axes of one item */
+#define LORA_PAYLOAD_MAX_AXES               UINT8_C(3)
+
+/**
+ * @brief Payload items, one per sensor.
+ */
+enum LoRaPayload_Item_E
+{
+    LORA_PAYLOAD_ITEM_ACCELEROMETER = 0, /**< m/s2 */
+    LORA_PAYLOAD_ITEM_GYROSCOPE, /**< deg/s */
+    LORA_PAYLOAD_ITEM_MAGNETOMETER, /**< uT */
+    LORA_PAYLOAD_ITEM_TEMPERATURE, /**< degC */
+    LORA_PAYLOAD_ITEM_HUMIDITY, /**< %RH */
+    LORA_PAYLOAD_ITEM_PRESSURE, /**< hPa */
+    LORA_PAYLOAD_ITEM_LIGHT, /**< lux */
+    LORA_PAYLOAD_ITEM_ACOUSTIC, /**< dB SPL */
+
+    LORA_PAYLOAD_ITEM_COUNT
+};
+typedef enum LoRaPayload_Item_E LoRaPayload_Item_T;
+
+/** Item mask covering every item */
+#define LORA_PAYLOAD_ALL_ITEMS              ((uint8_t) ((1U << LORA_PAYLOAD_ITEM_COUNT) - 1U))
+
+/**
+ * @brief Payload formats.
+ */
+enum LoRaPayload_Format_E
+{
+    LORA_PAYLOAD_FORMAT_CAYENNE_LPP = 0,
+    LORA_PAYLOAD_FORMAT_BIT_PACKED,
+};
+typedef enum LoRaPayload_Format_E LoRaPayload_Format_T;
+
+/**
+ * @brief Supported LoRaWAN regions.
+ */
+enum LoRaPayload_Region_E
+{
+    LORA_PAYLOAD_REGION_EU868 = 0,
+    LORA_PAYLOAD_REGION_US915,
+};
+typedef enum LoRaPayload_Region_E LoRaPayload_Region_T;
+
+/**
+ * @brief Decoded item values, indexed by item and axis.
+ */
+struct LoRaPayload_Values_S
+{
+    uint8_t ItemMask; /**< Items present in the payload */
+    float Values[LORA_PAYLOAD_ITEM_COUNT][LORA_PAYLOAD_MAX_AXES];
+};
+typedef struct LoRaPayload_Values_S LoRaPayload_Values_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Returns the maximum application payload of a data rate (LoRaWAN regional parameters, no FOpts).
+ *
+ * @return Size in bytes, 0 for an unknown data rate.
+ */
+uint8_t LoRaPayload_GetMaxSize(LoRaPayload_Region_T region, uint8_t dataRate);
+
+/**
+ * @brief Returns the time on air of an uplink.
+ *
+ * Explicit header, CRC, coding rate 4/5, 8 preamble symbols and the 13 bytes
+ * of LoRaWAN framing on top of the application payload.
+ *
+ * @param[in] region
+ * Region the data rate belongs to
+ *
+ * @param[in] dataRate
+ * Uplink data rate
+ *
+ * @param[in] payloadSize
+ * Application payload size
+ *
+ * @return Time on air in microseconds, 0 for an unknown data rate.
+ */
+uint32_t LoRaPayload_GetAirtimeUs(LoRaPayload_Region_T region, uint8_t dataRate, uint8_t payloadSize);
+
+/**
+ * @brief Returns the number of axes of an item.
+ */
+uint8_t LoRaPayload_GetAxisCount(LoRaPayload_Item_T item);
+
+/**
+ * @brief Returns the value of one item axis in the unit of the item.
+ */
+float LoRaPayload_GetValue(const SensorSnapshot_T * snapshot, LoRaPayload_Item_T item, uint8_t axis);
+
+/**
+ * @brief Returns the encoded size of a set of items.
+ *
+ * @param[in] format
+ * Payload format
+ *
+ * @param[in] itemMask
+ * Items to encode, bit n for item n
+ *
+ * @return Size in bytes.
+ */
+uint16_t LoRaPayload_GetSize(LoRaPayload_Format_T format, uint8_t itemMask);
+
+/**
+ * @brief Encodes a set of items of a snapshot.
+ *
+ * @param[in] format
+ * Payload format
+ *
+ * @param[in] snapshot
+ * Sensor values
+ *
+ * @param[in] itemMask
+ * Items to encode, bit n for item n
+ *
+ * @param[out] buffer
+ * Payload buffer
+ *
+ * @param[in] capacity
+ * Size of the payload buffer
+ *
+ * @return Payload size, 0 if the items do not fit into capacity.
+ */
+uint16_t LoRaPayload_Encode(LoRaPayload_Format_T format, const SensorSnapshot_T * snapshot, uint8_t itemMask,
+        uint8_t * buffer, uint16_t capacity);
+
+/**
+ * @brief Decodes a payload back into item values (the network server side).
+ *
+ * @return false for a malformed payload.
+ */
+bool LoRaPayload_Decode(LoRaPayload_Format_T format, const uint8_t * payload, uint16_t length, LoRaPayload_Values_T * values);
+
+#endif /* LORAPAYLOAD_H_ */
@@ -0,0 +1,187 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the LWM2M agent task.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_LWM2M_AGENT
+
+#include "Lwm2mAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "Lwm2mObserve.h"
+#include "simplelink.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "StaticRtos.h"
+
+/* constant definitions ***************************************************** */
+
+#define LWM2M_AGENT_RECEIVE_TIMEOUT_US      UINT32_C(100000) /**< Receive timeout, bounds the Process interval */
+#define LWM2M_AGENT_DATAGRAM_SIZE           UINT16_C(256)
+
+/* local variables ********************************************************** */
+
+static const Lwm2mAgent_Setup_T * AgentSetup = NULL;
+
+static Lwm2mObserve_T AgentClient; /**< LWM2M client state */
+
+static int16_t AgentSocket = -1;
+
+static SlSockAddrIn_t AgentServerAddress;
+
+static uint8_t AgentReceiveBuffer[LWM2M_AGENT_DATAGRAM_SIZE];
+
+static xTaskHandle AgentTaskHandle = NULL;
+
+STATIC_RTOS_TASK(AgentTaskStorage, TASK_STACK_SIZE_LWM2M_AGENT);
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static void AgentSend(void * context, const uint8_t * datagram, uint16_t length)
+{
+    BCDS_UNUSED(context);
+
+    if (0 > sl_SendTo(AgentSocket, datagram, length, 0, (SlSockAddr_t *) &AgentServerAddress, sizeof(AgentServerAddress)))
+    {
+        printf("Lwm2mAgent : Sending %u bytes failed \r\n", (unsigned int) length);
+    }
+}
+
+/**
+ * @brief Receives server requests and drives registration and notifications.
+ */
+static void AgentTask(void * pvParameters)
+{
+    BCDS_UNUSED(pvParameters);
+
+    SlSockAddrIn_t fromAddress;
+    SlSocklen_t fromLength;
+    int16_t received;
+    uint32_t generation = 0UL;
+
+    for (;;)
+    {
+        fromLength = sizeof(fromAddress);
+        received = sl_RecvFrom(AgentSocket, AgentReceiveBuffer, sizeof(AgentReceiveBuffer), 0,
+                (SlSockAddr_t *) &fromAddress, &fromLength);
+        if ((received > 0) && (fromAddress.sin_addr.s_addr == AgentServerAddress.sin_addr.s_addr))
+        {
+            Lwm2mObserve_HandleDatagram(&AgentClient, AgentReceiveBuffer, (uint16_t) received, AgentSetup->Snapshot, AgentNowMs());
+        }
+        Lwm2mObserve_Process(&AgentClient, AgentSetup->Snapshot, AgentNowMs());
+
+        if ((generation != AgentClient.SamplingGeneration) && (NULL != AgentSetup->SamplingChangedCB))
+        {
+            generation = AgentClient.SamplingGeneration;
+            AgentSetup->SamplingChangedCB();
+        }
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T Lwm2mAgent_Setup(const Lwm2mAgent_Setup_T * setup)
+{
+    Lwm2mObserve_Setup_T observeSetup;
+
+    if ((NULL == setup) || (NULL == setup->ServerHost) || (NULL == setup->Snapshot))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    observeSetup.EndpointName = setup->EndpointName;
+    observeSetup.LifetimeS = setup->LifetimeS;
+    observeSetup.DefaultSamplingMs = setup->DefaultSamplingMs;
+    observeSetup.Send = AgentSend;
+    observeSetup.SendContext = NULL;
+    if (!Lwm2mObserve_Init(&AgentClient, &observeSetup))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T Lwm2mAgent_Enable(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+    uint32_t serverIp = 0UL;
+    struct SlTimeval_t receiveTimeout;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    if (NULL != AgentSetup->Resolve)
+    {
+        retcode = AgentSetup->Resolve(AgentSetup->ServerHost, &serverIp);
+    }
+    else if (0 > sl_NetAppDnsGetHostByName((_i8 *) AgentSetup->ServerHost, (_u16) strlen(AgentSetup->ServerHost), (_u32 *) &serverIp, SL_AF_INET))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+    }
+    if (RETCODE_OK != retcode)
+    {
+        printf("Lwm2mAgent_Enable : Resolving %s failed \r\n", AgentSetup->ServerHost);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        memset(&AgentServerAddress, 0, sizeof(AgentServerAddress));
+        AgentServerAddress.sin_family = SL_AF_INET;
+        AgentServerAddress.sin_port = sl_Htons(AgentSetup->ServerPort);
+        AgentServerAddress.sin_addr.s_addr = sl_Htonl(serverIp);
+
+        AgentSocket = sl_Socket(SL_AF_INET, SL_SOCK_DGRAM, SL_IPPROTO_UDP);
+        if (0 > AgentSocket)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    if (RETCODE_OK == retcode)
+    {
+        receiveTimeout.tv_sec = 0;
+        receiveTimeout.tv_usec = LWM2M_AGENT_RECEIVE_TIMEOUT_US;
+        if (0 > sl_SetSockOpt(AgentSocket, SL_SOL_SOCKET, SL_SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout)))
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentTaskHandle = StaticRtos_CreateTask(&AgentTaskStorage, AgentTask, "Lwm2mAgent", NULL, TASK_PRIO_LWM2M_AGENT);
+        if (NULL == AgentTaskHandle)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    if ((RETCODE_OK != retcode) && (0 <= AgentSocket))
+    {
+        (void) sl_Close(AgentSocket);
+        AgentSocket = -1;
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+uint32_t Lwm2mAgent_GetSamplingPeriodMs(uint8_t channel)
+{
+    return Lwm2mObserve_GetSamplingPeriodMs(&AgentClient, channel);
+}
@@ -0,0 +1,77 @@
+/**
+ *  @file
+ *
+ *  @brief Runs the Lwm2mObserve client on the XDK over a SimpleLink UDP socket.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LWM2MAGENT_H_
+#define LWM2MAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+#include "SensorSnapshot.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Called from the agent task whenever the server changed the sampling periods.
+ */
+typedef void (*Lwm2mAgent_SamplingChangedCallback_T)(void);
+
+/**
+ * @brief Resolves host to an IPv4 address in host byte order, e.g. DnsAgent_Resolve.
+ */
+typedef Retcode_T (*Lwm2mAgent_ResolveFunc_T)(const char * host, uint32_t * address);
+
+/**
+ * @brief Agent configuration.
+ */
+struct Lwm2mAgent_Setup_S
+{
+    const char * ServerHost; /**< Host name or dotted IPv4 address of the LWM2M server */
+    uint16_t ServerPort;
+    const char * EndpointName;
+    uint32_t LifetimeS;
+    uint32_t DefaultSamplingMs; /**< Sampling period of an observed channel without pmin */
+    const SensorSnapshot_T * Snapshot; /**< Snapshot the resources are read from */
+    Lwm2mAgent_SamplingChangedCallback_T SamplingChangedCB;
+    Lwm2mAgent_ResolveFunc_T Resolve; /**< NULL to ask the resolver of the WLAN chip */
+};
+typedef struct Lwm2mAgent_Setup_S Lwm2mAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Stores the agent configuration.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T Lwm2mAgent_Setup(const Lwm2mAgent_Setup_T * setup);
+
+/**
+ * @brief Resolves the server, opens the socket and starts the agent task.
+ *
+ * Requires an established WLAN connection.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T Lwm2mAgent_Enable(void);
+
+/**
+ * @brief Returns the sampling period the server observations need for a channel.
+ *
+ * @param[in] channel
+ * Snapshot channel
+ *
+ * @return Period in milliseconds, 0 if the channel is not observed.
+ */
+uint32_t Lwm2mAgent_GetSamplingPeriodMs(uint8_t channel);
+
+#endif /* LWM2MAGENT_H_ */
@@ -0,0 +1,834 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the LWM2M observe client.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "Lwm2mObserve.h"
+
+/* additional interface header files */
+#include "CoapMessage.h"
+
+/* system header files */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define LWM2M_DEVICE_OBJECT_ID          UINT16_C(3)
+#define LWM2M_NO_ID                     UINT16_C(0xFFFF)
+#define LWM2M_TLV_TYPE_OBJECT_INSTANCE  UINT8_C(0x00)
+#define LWM2M_TLV_TYPE_RESOURCE         UINT8_C(0xC0)
+#define LWM2M_TEXT_VALUE_SIZE           UINT8_C(24)
+#define LWM2M_TLV_MAX_HEADER_SIZE       UINT8_C(5) /**< type, 16 bit identifier, 16 bit length */
+
+/**
+ * @brief One IPSO resource backed by a snapshot channel.
+ */
+struct Lwm2mResource_S
+{
+    uint16_t ObjectId;
+    uint16_t InstanceId;
+    uint16_t ResourceId;
+    uint8_t Channel;
+};
+typedef struct Lwm2mResource_S Lwm2mResource_T;
+
+/* local variables ********************************************************** */
+
+/** Resource table, grouped by object instance; one entry per snapshot channel, in the units of SensorTable.h */
+static const Lwm2mResource_T Lwm2mResources[SENSOR_SNAPSHOT_CHANNEL_COUNT] =
+        {
+                { 3303U, 0U, 5700U, SENSOR_SNAPSHOT_TEMPERATURE },
+                { 3304U, 0U, 5700U, SENSOR_SNAPSHOT_HUMIDITY },
+                { 3315U, 0U, 5700U, SENSOR_SNAPSHOT_PRESSURE },
+                { 3301U, 0U, 5700U, SENSOR_SNAPSHOT_LIGHT },
+                { 3324U, 0U, 5700U, SENSOR_SNAPSHOT_ACOUSTIC },
+                { 3313U, 0U, 5702U, SENSOR_SNAPSHOT_ACCELEROMETER_X },
+                { 3313U, 0U, 5703U, SENSOR_SNAPSHOT_ACCELEROMETER_Y },
+                { 3313U, 0U, 5704U, SENSOR_SNAPSHOT_ACCELEROMETER_Z },
+                { 3314U, 0U, 5702U, SENSOR_SNAPSHOT_MAGNETOMETER_X },
+                { 3314U, 0U, 5703U, SENSOR_SNAPSHOT_MAGNETOMETER_Y },
+                { 3314U, 0U, 5704U, SENSOR_SNAPSHOT_MAGNETOMETER_Z },
+                { 3334U, 0U, 5702U, SENSOR_SNAPSHOT_GYROSCOPE_X },
+                { 3334U, 0U, 5703U, SENSOR_SNAPSHOT_GYROSCOPE_Y },
+                { 3334U, 0U, 5704U, SENSOR_SNAPSHOT_GYROSCOPE_Z },
+        };
+
+/** Device object (/3/0) resources: Manufacturer and Model Number */
+static const char * const Lwm2mDeviceStrings[] = { "Bosch", "XDK110" };
+
+/** Registration link format, must list every object instance of Lwm2mResources */
+static const char Lwm2mObjectLinks[] = "</3/0>,</3303/0>,</3304/0>,</3315/0>,</3301/0>,</3324/0>,</3313/0>,</3314/0>,</3334/0>";
+
+/* local functions ********************************************************** */
+
+static void UpdateSamplingPeriods(Lwm2mObserve_T * client);
+
+static uint16_t NextMessageId(Lwm2mObserve_T * client)
+{
+    client->NextMessageId++;
+    return client->NextMessageId;
+}
+
+static float ResourceValue(const SensorSnapshot_T * snapshot, uint8_t resource)
+{
+    return SensorTable_GetValue(snapshot->Values, Lwm2mResources[resource].Channel);
+}
+
+/**
+ * @brief Maps an object / instance / resource path to a range of the resource table.
+ *
+ * @return false if the path does not address any resource of the table.
+ */
+static bool FindResources(uint16_t objectId, uint16_t instanceId, uint16_t resourceId, uint8_t * first, uint8_t * count)
+{
+    uint8_t index;
+
+    *count = 0U;
+    for (index = 0U; index < SENSOR_SNAPSHOT_CHANNEL_COUNT; index++)
+    {
+        const Lwm2mResource_T * entry = &Lwm2mResources[index];
+        if ((entry->ObjectId == objectId) &&
+                ((LWM2M_NO_ID == instanceId) || (entry->InstanceId == instanceId)) &&
+                ((LWM2M_NO_ID == resourceId) || (entry->ResourceId == resourceId)))
+        {
+            if (0U == *count)
+            {
+                *first = index;
+            }
+            (*count)++;
+        }
+    }
+    return (0U != *count);
+}
+
+static uint16_t WriteTlvHeader(uint8_t * buffer, uint8_t type, uint16_t identifier, uint16_t length)
+{
+    uint16_t position = 1U;
+
+    buffer[0] = type;
+    if (identifier > 0xFFU)
+    {
+        buffer[0] |= 0x20U;
+        buffer[position++] = (uint8_t) (identifier >> 8);
+    }
+    buffer[position++] = (uint8_t) (identifier & 0xFFU);
+    if (length <= 7U)
+    {
+        buffer[0] |= (uint8_t) length;
+    }
+    else if (length <= 0xFFU)
+    {
+        buffer[0] |= 0x08U;
+        buffer[position++] = (uint8_t) length;
+    }
+    else
+    {
+        buffer[0] |= 0x10U;
+        buffer[position++] = (uint8_t) (length >> 8);
+        buffer[position++] = (uint8_t) (length & 0xFFU);
+    }
+    return position;
+}
+
+static uint16_t WriteTlvFloat(uint8_t * buffer, uint16_t resourceId, float value)
+{
+    SensorSnapshot_Value_T bits;
+    uint16_t position = WriteTlvHeader(buffer, LWM2M_TLV_TYPE_RESOURCE, resourceId, 4U);
+
+    bits.Float = value;
+    buffer[position++] = (uint8_t) (bits.Bits >> 24);
+    buffer[position++] = (uint8_t) (bits.Bits >> 16);
+    buffer[position++] = (uint8_t) (bits.Bits >> 8);
+    buffer[position++] = (uint8_t) (bits.Bits & 0xFFU);
+    return position;
+}
+
+/**
+ * @brief Encodes resources of the table; text/plain for a single resource unless TLV is requested.
+ *
+ * @return Payload length, the content format is returned in format.
+ */
+static uint16_t EncodeResources(const SensorSnapshot_T * snapshot, uint8_t first, uint8_t count, bool wrapInstance,
+        bool useTlv, uint8_t * payload, uint16_t * format)
+{
+    uint8_t header[LWM2M_TLV_MAX_HEADER_SIZE];
+    uint16_t headerLength;
+    uint16_t length = 0U;
+    uint16_t offset;
+    uint8_t index;
+    int written;
+
+    if ((1U == count) && (!useTlv))
+    {
+        written = snprintf((char *) payload, LWM2M_TEXT_VALUE_SIZE, "%g", (double) ResourceValue(snapshot, first));
+        *format = COAP_FORMAT_TEXT_PLAIN;
+        return (written > 0) ? (uint16_t) written : 0U;
+    }
+
+    /* leave room for the largest object instance header the content can need */
+    offset = wrapInstance ? LWM2M_TLV_MAX_HEADER_SIZE : 0U;
+    for (index = first; index < (first + count); index++)
+    {
+        length = (uint16_t) (length + WriteTlvFloat(&payload[offset + length], Lwm2mResources[index].ResourceId,
+                ResourceValue(snapshot, index)));
+    }
+    if (wrapInstance)
+    {
+        headerLength = WriteTlvHeader(header, LWM2M_TLV_TYPE_OBJECT_INSTANCE, Lwm2mResources[first].InstanceId, length);
+        memmove(&payload[headerLength], &payload[offset], length);
+        memcpy(payload, header, headerLength);
+        length = (uint16_t) (length + headerLength);
+    }
+    *format = COAP_FORMAT_LWM2M_TLV;
+    return length;
+}
+
+static void SendRegistration(Lwm2mObserve_T * client, uint32_t nowMs)
+{
+    CoapMessage_Writer_T writer;
+    char query[48];
+    char segment[LWM2M_OBSERVE_LOCATION_SIZE];
+    const char * cursor;
+    const char * slash;
+    uint16_t length;
+    uint8_t token[4];
+
+    client->NextToken++;
+    memcpy(token, &client->NextToken, sizeof(token));
+    client->PendingMessageId = NextMessageId(client);
+    CoapMessage_Begin(&writer, client->Datagram, sizeof(client->Datagram), COAP_TYPE_CON, COAP_CODE_POST,
+            client->PendingMessageId, token, sizeof(token));
+
+    if (!client->Registered)
+    {
+        /* a new registration starts without observations on the server side */
+        memset(client->Observations, 0, sizeof(client->Observations));
+        UpdateSamplingPeriods(client);
+
+        CoapMessage_AddOption(&writer, COAP_OPTION_URI_PATH, "rd", 2U);
+        CoapMessage_AddUintOption(&writer, COAP_OPTION_CONTENT_FORMAT, COAP_FORMAT_LINK_FORMAT);
+        length = (uint16_t) snprintf(query, sizeof(query), "ep=%s", client->Setup.EndpointName);
+        CoapMessage_AddOption(&writer, COAP_OPTION_URI_QUERY, query, length);
+        length = (uint16_t) snprintf(query, sizeof(query), "lt=%lu", (unsigned long) client->Setup.LifetimeS);
+        CoapMessage_AddOption(&writer, COAP_OPTION_URI_QUERY, query, length);
+        CoapMessage_AddOption(&writer, COAP_OPTION_URI_QUERY, "lwm2m=1.0", 9U);
+        CoapMessage_AddOption(&writer, COAP_OPTION_URI_QUERY, "b=U", 3U);
+        CoapMessage_AddPayload(&writer, Lwm2mObjectLinks, (uint16_t) (sizeof(Lwm2mObjectLinks) - 1U));
+        client->Statistics.Registrations++;
+    }
+    else
+    {
+        /* Update: POST to the location returned at registration, no payload */
+        cursor = client->Location;
+        while ('\0' != *cursor)
+        {
+            slash = strchr(cursor, '/');
+            length = (uint16_t) ((NULL != slash) ? (size_t) (slash - cursor) : strlen(cursor));
+            memcpy(segment, cursor, length);
+            CoapMessage_AddOption(&writer, COAP_OPTION_URI_PATH, segment, length);
+            cursor += length;
+            if ('/' == *cursor)
+            {
+                cursor++;
+            }
+        }
+        client->Statistics.Updates++;
+    }
+
+    length = CoapMessage_End(&writer);
+    if (0U != length)
+    {
+        client->Setup.Send(client->Setup.SendContext, client->Datagram, length);
+    }
+    client->Pending = true;
+    client->PendingSinceMs = nowMs;
+}
+
+static void HandleRegistrationResponse(Lwm2mObserve_T * client, const CoapMessage_T * message, uint32_t nowMs)
+{
+    const CoapMessage_Option_T * option = NULL;
+    size_t used = 0;
+
+    client->Pending = false;
+    if (COAP_CODE_CREATED == message->Code)
+    {
+        client->Location[0] = '\0';
+        while (NULL != (option = CoapMessage_FindOption(message, COAP_OPTION_LOCATION_PATH, option)))
+        {
+            if ((used + option->Length + 2U) > sizeof(client->Location))
+            {
+                break;
+            }
+            if (0U != used)
+            {
+                client->Location[used++] = '/';
+            }
+            memcpy(&client->Location[used], option->Value, option->Length);
+            used += option->Length;
+            client->Location[used] = '\0';
+        }
+        client->Registered = true;
+        client->LastRegistrationMs = nowMs;
+    }
+    else if (COAP_CODE_CHANGED == message->Code)
+    {
+        client->LastRegistrationMs = nowMs;
+    }
+    else
+    {
+        /* registration unknown to the server (e.g. it restarted): register again */
+        client->Registered = false;
+    }
+}
+
+static void UpdateSamplingPeriods(Lwm2mObserve_T * client)
+{
+    uint32_t periods[SENSOR_SNAPSHOT_CHANNEL_COUNT];
+    uint8_t observation;
+    uint8_t index;
+
+    memset(periods, 0, sizeof(periods));
+    for (observation = 0U; observation < LWM2M_OBSERVE_MAX_OBSERVATIONS; observation++)
+    {
+        const Lwm2mObserve_Observation_T * entry = &client->Observations[observation];
+        if (!entry->Active)
+        {
+            continue;
+        }
+        for (index = entry->FirstResource; index < (entry->FirstResource + entry->ResourceCount); index++)
+        {
+            Lwm2mObserve_Attributes_T attributes;
+            uint8_t channel = Lwm2mResources[index].Channel;
+            uint32_t period = client->Setup.DefaultSamplingMs;
+
+            Lwm2mObserve_GetAttributes(client, index, &attributes);
+            /* a change cannot be notified before pmin, so sampling faster than pmin is wasted */
+            if ((0U != (attributes.Flags & LWM2M_OBSERVE_ATTRIBUTE_PMIN)) && (0UL != attributes.MinPeriodS))
+            {
+                period = attributes.MinPeriodS * 1000UL;
+            }
+            if ((0U != (attributes.Flags & LWM2M_OBSERVE_ATTRIBUTE_PMAX)) && (0UL != attributes.MaxPeriodS) &&
+                    ((attributes.MaxPeriodS * 1000UL) < period))
+            {
+                period = attributes.MaxPeriodS * 1000UL;
+            }
+            if ((0UL == periods[channel]) || (period < periods[channel]))
+            {
+                periods[channel] = period;
+            }
+        }
+    }
+    if (0 != memcmp(periods, client->SamplingPeriodMs, sizeof(periods)))
+    {
+        memcpy(client->SamplingPeriodMs, periods, sizeof(periods));
+        client->SamplingGeneration++;
+    }
+}
+
+static void SendNotification(Lwm2mObserve_T * client, Lwm2mObserve_Observation_T * observation, const SensorSnapshot_T * snapshot)
+{
+    CoapMessage_Writer_T writer;
+    uint8_t payload[64];
+    uint16_t format = COAP_FORMAT_TEXT_PLAIN;
+    uint16_t payloadLength;
+    uint16_t length;
+
+    payloadLength = EncodeResources(snapshot, observation->FirstResource, observation->ResourceCount, false,
+            observation->UseTlv, payload, &format);
+    observation->Sequence = (observation->Sequence + 1UL) & 0xFFFFFFUL;
+    observation->LastMessageId = NextMessageId(client);
+
+    CoapMessage_Begin(&writer, client->Datagram, sizeof(client->Datagram), COAP_TYPE_NON, COAP_CODE_CONTENT,
+            observation->LastMessageId, observation->Token, observation->TokenLength);
+    CoapMessage_AddUintOption(&writer, COAP_OPTION_OBSERVE, observation->Sequence);
+    CoapMessage_AddUintOption(&writer, COAP_OPTION_CONTENT_FORMAT, format);
+    CoapMessage_AddPayload(&writer, payload, payloadLength);
+    length = CoapMessage_End(&writer);
+    if (0U != length)
+    {
+        client->Setup.Send(client->Setup.SendContext, client->Datagram, length);
+        client->Statistics.Notifications++;
+    }
+}
+
+static void SendResponse(Lwm2mObserve_T * client, const CoapMessage_T * request, uint8_t code, bool hasObserve,
+        uint32_t observeSequence, uint16_t format, const uint8_t * payload, uint16_t payloadLength)
+{
+    CoapMessage_Writer_T writer;
+    CoapMessage_Type_T type = (COAP_TYPE_CON == request->Type) ? COAP_TYPE_ACK : COAP_TYPE_NON;
+    uint16_t messageId = (COAP_TYPE_CON == request->Type) ? request->MessageId : NextMessageId(client);
+    uint16_t length;
+
+    CoapMessage_Begin(&writer, client->Datagram, sizeof(client->Datagram), type, code, messageId,
+            request->Token, request->TokenLength);
+    if (hasObserve)
+    {
+        CoapMessage_AddUintOption(&writer, COAP_OPTION_OBSERVE, observeSequence);
+    }
+    if (0U != payloadLength)
+    {
+        CoapMessage_AddUintOption(&writer, COAP_OPTION_CONTENT_FORMAT, format);
+        CoapMessage_AddPayload(&writer, payload, payloadLength);
+    }
+    length = CoapMessage_End(&writer);
+    if (0U != length)
+    {
+        client->Setup.Send(client->Setup.SendContext, client->Datagram, length);
+    }
+}
+
+static Lwm2mObserve_Observation_T * FindObservation(Lwm2mObserve_T * client, uint8_t first, uint8_t count)
+{
+    uint8_t index;
+
+    for (index = 0U; index < LWM2M_OBSERVE_MAX_OBSERVATIONS; index++)
+    {
+        Lwm2mObserve_Observation_T * observation = &client->Observations[index];
+        if (observation->Active && (observation->FirstResource == first) && (observation->ResourceCount == count))
+        {
+            return observation;
+        }
+    }
+    return NULL;
+}
+
+static void HandleDeviceObjectRead(Lwm2mObserve_T * client, const CoapMessage_T * request, uint16_t instanceId, uint16_t resourceId)
+{
+    uint8_t payload[32];
+    uint16_t length = 0U;
+    uint16_t valueLength;
+    uint16_t index;
+
+    if ((0U != instanceId) || ((LWM2M_NO_ID != resourceId) && (resourceId >= 2U)))
+    {
+        SendResponse(client, request, COAP_CODE_NOT_FOUND, false, 0UL, 0U, NULL, 0U);
+        return;
+    }
+    if (LWM2M_NO_ID != resourceId)
+    {
+        valueLength = (uint16_t) strlen(Lwm2mDeviceStrings[resourceId]);
+        SendResponse(client, request, COAP_CODE_CONTENT, false, 0UL, COAP_FORMAT_TEXT_PLAIN,
+                (const uint8_t *) Lwm2mDeviceStrings[resourceId], valueLength);
+        return;
+    }
+    for (index = 0U; index < 2U; index++)
+    {
+        valueLength = (uint16_t) strlen(Lwm2mDeviceStrings[index]);
+        length = (uint16_t) (length + WriteTlvHeader(&payload[length], LWM2M_TLV_TYPE_RESOURCE, index, valueLength));
+        memcpy(&payload[length], Lwm2mDeviceStrings[index], valueLength);
+        length = (uint16_t) (length + valueLength);
+    }
+    SendResponse(client, request, COAP_CODE_CONTENT, false, 0UL, COAP_FORMAT_LWM2M_TLV, payload, length);
+}
+
+static void HandleRead(Lwm2mObserve_T * client, const CoapMessage_T * request, const SensorSnapshot_T * snapshot,
+        uint8_t first, uint8_t count, bool objectLevel, uint32_t nowMs)
+{
+    const CoapMessage_Option_T * observeOption = CoapMessage_FindOption(request, COAP_OPTION_OBSERVE, NULL);
+    const CoapMessage_Option_T * acceptOption = CoapMessage_FindOption(request, COAP_OPTION_ACCEPT, NULL);
+    bool useTlv = (NULL != acceptOption) && (COAP_FORMAT_LWM2M_TLV == CoapMessage_GetUintOption(acceptOption));
+    Lwm2mObserve_Observation_T * observation = NULL;
+    uint8_t payload[64];
+    uint16_t format = COAP_FORMAT_TEXT_PLAIN;
+    uint16_t payloadLength;
+    uint8_t index;
+
+    if ((NULL != acceptOption) && !useTlv && (COAP_FORMAT_TEXT_PLAIN != CoapMessage_GetUintOption(acceptOption)))
+    {
+        SendResponse(client, request, COAP_CODE_NOT_ACCEPTABLE, false, 0UL, 0U, NULL, 0U);
+        return;
+    }
+    if ((count > LWM2M_OBSERVE_MAX_RESOURCES_PER_TARGET) || (objectLevel && (NULL != observeOption)))
+    {
+        SendResponse(client, request, COAP_CODE_BAD_REQUEST, false, 0UL, 0U, NULL, 0U);
+        return;
+    }
+    payloadLength = EncodeResources(snapshot, first, count, objectLevel, useTlv, payload, &format);
+
+    if ((NULL != observeOption) && (0UL == CoapMessage_GetUintOption(observeOption)))
+    {
+        observation = FindObservation(client, first, count);
+        for (index = 0U; (NULL == observation) && (index < LWM2M_OBSERVE_MAX_OBSERVATIONS); index++)
+        {
+            if (!client->Observations[index].Active)
+            {
+                observation = &client->Observations[index];
+            }
+        }
+    }
+    else if (NULL != observeOption)
+    {
+        observation = FindObservation(client, first, count);
+        if (NULL != observation)
+        {
+            observation->Active = false;
+            client->Statistics.Cancellations++;
+            UpdateSamplingPeriods(client);
+        }
+        observation = NULL;
+    }
+
+    if (NULL == observation)
+    {
+        /* plain read, cancellation, or no free observation slot */
+        SendResponse(client, request, COAP_CODE_CONTENT, false, 0UL, format, payload, payloadLength);
+        return;
+    }
+    observation->Active = true;
+    observation->UseTlv = useTlv;
+    observation->FirstResource = first;
+    observation->ResourceCount = count;
+    observation->TokenLength = request->TokenLength;
+    memcpy(observation->Token, request->Token, request->TokenLength);
+    observation->Sequence = 0UL;
+    observation->LastNotifyMs = nowMs;
+    for (index = 0U; index < count; index++)
+    {
+        observation->LastValues[index] = ResourceValue(snapshot, (uint8_t) (first + index));
+    }
+    UpdateSamplingPeriods(client);
+    SendResponse(client, request, COAP_CODE_CONTENT, true, observation->Sequence, format, payload, payloadLength);
+}
+
+/**
+ * @brief Applies the attributes of the query at the level of the path; the
+ * attributes the query does not name keep their values.
+ */
+static void HandleWriteAttributes(Lwm2mObserve_T * client, const CoapMessage_T * request, uint8_t first, uint8_t count,
+        Lwm2mObserve_Level_T level)
+{
+    const CoapMessage_Option_T * option = NULL;
+    Lwm2mObserve_Attributes_T scratch;
+    uint8_t index;
+
+    /* Checked in full first, a bad request changes nothing */
+    memset(&scratch, 0, sizeof(scratch));
+    while (NULL != (option = CoapMessage_FindOption(request, COAP_OPTION_URI_QUERY, option)))
+    {
+        if (!Lwm2mObserve_ParseAttribute(&scratch, (const char *) option->Value, option->Length))
+        {
+            SendResponse(client, request, COAP_CODE_BAD_REQUEST, false, 0UL, 0U, NULL, 0U);
+            return;
+        }
+    }
+    for (index = first; index < (first + count); index++)
+    {
+        while (NULL != (option = CoapMessage_FindOption(request, COAP_OPTION_URI_QUERY, option)))
+        {
+            (void) Lwm2mObserve_ParseAttribute(&client->Attributes[level][index], (const char *) option->Value, option->Length);
+        }
+    }
+    UpdateSamplingPeriods(client);
+    SendResponse(client, request, COAP_CODE_CHANGED, false, 0UL, 0U, NULL, 0U);
+}
+
+static void HandleRequest(Lwm2mObserve_T * client, const CoapMessage_T * request, const SensorSnapshot_T * snapshot, uint32_t nowMs)
+{
+    const CoapMessage_Option_T * option = NULL;
+    uint16_t path[3] = { LWM2M_NO_ID, LWM2M_NO_ID, LWM2M_NO_ID };
+    uint8_t depth = 0U;
+    uint8_t first = 0U;
+    uint8_t count = 0U;
+    char segment[6];
+    char * end;
+    unsigned long identifier;
+
+    client->Statistics.Requests++;
+    while (NULL != (option = CoapMessage_FindOption(request, COAP_OPTION_URI_PATH, option)))
+    {
+        if ((depth >= 3U) || (0U == option->Length) || (option->Length >= sizeof(segment)))
+        {
+            SendResponse(client, request, COAP_CODE_NOT_FOUND, false, 0UL, 0U, NULL, 0U);
+            return;
+        }
+        memcpy(segment, option->Value, option->Length);
+        segment[option->Length] = '\0';
+        identifier = strtoul(segment, &end, 10);
+        if (('\0' != *end) || (identifier >= LWM2M_NO_ID))
+        {
+            SendResponse(client, request, COAP_CODE_NOT_FOUND, false, 0UL, 0U, NULL, 0U);
+            return;
+        }
+        path[depth++] = (uint16_t) identifier;
+    }
+
+    if ((COAP_CODE_GET == request->Code) && (LWM2M_DEVICE_OBJECT_ID == path[0]) && (depth >= 2U))
+    {
+        HandleDeviceObjectRead(client, request, path[1], path[2]);
+    }
+    else if ((0U == depth) || !FindResources(path[0], path[1], path[2], &first, &count))
+    {
+        SendResponse(client, request, COAP_CODE_NOT_FOUND, false, 0UL, 0U, NULL, 0U);
+    }
+    else if (COAP_CODE_GET == request->Code)
+    {
+        HandleRead(client, request, snapshot, first, count, (1U == depth), nowMs);
+    }
+    else if ((COAP_CODE_PUT == request->Code) && (0U == request->PayloadLength))
+    {
+        HandleWriteAttributes(client, request, first, count, (Lwm2mObserve_Level_T) (depth - 1U));
+    }
+    else
+    {
+        SendResponse(client, request, COAP_CODE_METHOD_NOT_ALLOWED, false, 0UL, 0U, NULL, 0U);
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool Lwm2mObserve_Init(Lwm2mObserve_T * client, const Lwm2mObserve_Setup_T * setup)
+{
+    if ((NULL == client) || (NULL == setup) || (NULL == setup->Send) || (NULL == setup->EndpointName) ||
+            (0UL == setup->LifetimeS) || (0UL == setup->DefaultSamplingMs))
+    {
+        return false;
+    }
+    memset(client, 0, sizeof(*client));
+    client->Setup = *setup;
+    client->NextMessageId = (uint16_t) (setup->LifetimeS ^ (uintptr_t) client);
+    return true;
+}
+
+/** Refer interface header for description */
+void Lwm2mObserve_HandleDatagram(Lwm2mObserve_T * client, const uint8_t * datagram, uint16_t length,
+        const SensorSnapshot_T * snapshot, uint32_t nowMs)
+{
+    CoapMessage_T message;
+    uint8_t index;
+
+    if ((NULL == client) || (NULL == snapshot) || !CoapMessage_Parse(&message, datagram, length))
+    {
+        return;
+    }
+    if (COAP_TYPE_RST == message.Type)
+    {
+        /* the server no longer wants this notification stream */
+        for (index = 0U; index < LWM2M_OBSERVE_MAX_OBSERVATIONS; index++)
+        {
+            if (client->Observations[index].Active && (client->Observations[index].LastMessageId == message.MessageId))
+            {
+                client->Observations[index].Active = false;
+                client->Statistics.Cancellations++;
+                UpdateSamplingPeriods(client);
+            }
+        }
+    }
+    else if ((COAP_CODE(1, 0) > message.Code) && (COAP_CODE_EMPTY != message.Code))
+    {
+        HandleRequest(client, &message, snapshot, nowMs);
+    }
+    else if (client->Pending && (COAP_TYPE_ACK == message.Type) && (message.MessageId == client->PendingMessageId))
+    {
+        HandleRegistrationResponse(client, &message, nowMs);
+    }
+}
+
+/** Refer interface header for description */
+void Lwm2mObserve_Process(Lwm2mObserve_T * client, const SensorSnapshot_T * snapshot, uint32_t nowMs)
+{
+    uint8_t observation;
+    uint8_t index;
+
+    if ((NULL == client) || (NULL == snapshot))
+    {
+        return;
+    }
+    if (client->Pending)
+    {
+        if ((nowMs - client->PendingSinceMs) >= LWM2M_OBSERVE_RESPONSE_TIMEOUT_MS)
+        {
+            SendRegistration(client, nowMs);
+        }
+        return;
+    }
+    if (!client->Registered || ((nowMs - client->LastRegistrationMs) >= (client->Setup.LifetimeS * 500UL)))
+    {
+        SendRegistration(client, nowMs);
+        return;
+    }
+
+    for (observation = 0U; observation < LWM2M_OBSERVE_MAX_OBSERVATIONS; observation++)
+    {
+        Lwm2mObserve_Observation_T * entry = &client->Observations[observation];
+        uint32_t elapsedMs = nowMs - entry->LastNotifyMs;
+        bool due = false;
+
+        if (!entry->Active)
+        {
+            continue;
+        }
+        for (index = 0U; (index < entry->ResourceCount) && !due; index++)
+        {
+            uint8_t resource = (uint8_t) (entry->FirstResource + index);
+            Lwm2mObserve_Attributes_T attributes;
+
+            Lwm2mObserve_GetAttributes(client, resource, &attributes);
+            due = Lwm2mObserve_IsNotificationDue(&attributes, entry->LastValues[index], ResourceValue(snapshot, resource), elapsedMs);
+        }
+        if (due)
+        {
+            for (index = 0U; index < entry->ResourceCount; index++)
+            {
+                entry->LastValues[index] = ResourceValue(snapshot, (uint8_t) (entry->FirstResource + index));
+            }
+            entry->LastNotifyMs = nowMs;
+            SendNotification(client, entry, snapshot);
+        }
+    }
+}
+
+/** Refer interface header for description */
+uint32_t Lwm2mObserve_GetSamplingPeriodMs(const Lwm2mObserve_T * client, uint8_t channel)
+{
+    if ((NULL == client) || (channel >= SENSOR_SNAPSHOT_CHANNEL_COUNT))
+    {
+        return 0UL;
+    }
+    return client->SamplingPeriodMs[channel];
+}
+
+/** Refer interface header for description */
+bool Lwm2mObserve_ParseAttribute(Lwm2mObserve_Attributes_T * attributes, const char * query, uint16_t length)
+{
+    char text[24];
+    char * value;
+    char * end;
+    uint8_t flag;
+    float number = 0.0f;
+
+    if ((NULL == attributes) || (NULL == query) || (0U == length) || (length >= sizeof(text)))
+    {
+        return false;
+    }
+    memcpy(text, query, length);
+    text[length] = '\0';
+    value = strchr(text, '=');
+    if (NULL != value)
+    {
+        *value++ = '\0';
+        number = strtof(value, &end);
+        if ((end == value) || ('\0' != *end) || (number < 0.0f && ((0 == strcmp(text, "pmin")) || (0 == strcmp(text, "pmax")))))
+        {
+            return false;
+        }
+    }
+
+    if (0 == strcmp(text, "pmin"))
+    {
+        flag = LWM2M_OBSERVE_ATTRIBUTE_PMIN;
+        attributes->MinPeriodS = (uint32_t) number;
+    }
+    else if (0 == strcmp(text, "pmax"))
+    {
+        flag = LWM2M_OBSERVE_ATTRIBUTE_PMAX;
+        attributes->MaxPeriodS = (uint32_t) number;
+    }
+    else if (0 == strcmp(text, "gt"))
+    {
+        flag = LWM2M_OBSERVE_ATTRIBUTE_GT;
+        attributes->GreaterThan = number;
+    }
+    else if (0 == strcmp(text, "lt"))
+    {
+        flag = LWM2M_OBSERVE_ATTRIBUTE_LT;
+        attributes->LessThan = number;
+    }
+    else if ((0 == strcmp(text, "st")) || (0 == strcmp(text, "stp")))
+    {
+        flag = LWM2M_OBSERVE_ATTRIBUTE_ST;
+        attributes->Step = number;
+    }
+    else
+    {
+        return false;
+    }
+
+    if (NULL != value)
+    {
+        attributes->Flags |= flag;
+    }
+    else
+    {
+        attributes->Flags &= (uint8_t) ~flag;
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+void Lwm2mObserve_GetAttributes(const Lwm2mObserve_T * client, uint8_t resource, Lwm2mObserve_Attributes_T * attributes)
+{
+    const Lwm2mObserve_Attributes_T * level;
+    uint8_t index;
+
+    memset(attributes, 0, sizeof(*attributes));
+    for (index = 0U; index < (uint8_t) LWM2M_OBSERVE_LEVELS; index++)
+    {
+        level = &client->Attributes[index][resource];
+        if (0U != (level->Flags & LWM2M_OBSERVE_ATTRIBUTE_PMIN))
+        {
+            attributes->MinPeriodS = level->MinPeriodS;
+        }
+        if (0U != (level->Flags & LWM2M_OBSERVE_ATTRIBUTE_PMAX))
+        {
+            attributes->MaxPeriodS = level->MaxPeriodS;
+        }
+        if (0U != (level->Flags & LWM2M_OBSERVE_ATTRIBUTE_GT))
+        {
+            attributes->GreaterThan = level->GreaterThan;
+        }
+        if (0U != (level->Flags & LWM2M_OBSERVE_ATTRIBUTE_LT))
+        {
+            attributes->LessThan = level->LessThan;
+        }
+        if (0U != (level->Flags & LWM2M_OBSERVE_ATTRIBUTE_ST))
+        {
+            attributes->Step = level->Step;
+        }
+        attributes->Flags |= level->Flags;
+    }
+}
+
+/** Refer interface header for description */
+bool Lwm2mObserve_IsNotificationDue(const Lwm2mObserve_Attributes_T * attributes, float lastValue, float value, uint32_t elapsedMs)
+{
+    uint8_t flags = attributes->Flags;
+    float difference = value - lastValue;
+
+    if ((0U != (flags & LWM2M_OBSERVE_ATTRIBUTE_PMIN)) && (elapsedMs < (attributes->MinPeriodS * 1000UL)))
+    {
+        return false;
+    }
+    if ((0U != (flags & LWM2M_OBSERVE_ATTRIBUTE_PMAX)) && (0UL != attributes->MaxPeriodS) &&
+            (elapsedMs >= (attributes->MaxPeriodS * 1000UL)))
+    {
+        return true;
+    }
+    if ((0U != (flags & LWM2M_OBSERVE_ATTRIBUTE_GT)) &&
+            ((lastValue > attributes->GreaterThan) != (value > attributes->GreaterThan)))
+    {
+        return true;
+    }
+    if ((0U != (flags & LWM2M_OBSERVE_ATTRIBUTE_LT)) &&
+            ((lastValue < attributes->LessThan) != (value < attributes->LessThan)))
+    {
+        return true;
+    }
+    if (0U != (flags & LWM2M_OBSERVE_ATTRIBUTE_ST))
+    {
+        return (((difference < 0.0f) ? -difference : difference) >= attributes->Step);
+    }
+    if (0U != (flags & (LWM2M_OBSERVE_ATTRIBUTE_GT | LWM2M_OBSERVE_ATTRIBUTE_LT)))
+    {
+        return false;
+    }
+    /* no change condition set: every change is notified */
+    return (value != lastValue);
+}
@@ -0,0 +1,267 @@
+/**
+ *  @file
+ *
+ *  @brief LWM2M client exposing the sensor snapshot as IPSO objects with Observe support.
+ *
+ *  The client registers with the LWM2M server, serves Read, Observe and
+ *  Write-Attributes requests on the IPSO resources mapped to the snapshot
+ *  channels and sends notifications according to the server set pmin, pmax,
+ *  gt, lt and st attributes. From the active observations it derives the
+ *  sampling period each channel needs, so unobserved sensors can stay idle.
+ *
+ *  The module is transport agnostic: datagrams are handed in by the caller and
+ *  sent through the Send callback, which keeps the same code testable on the
+ *  host (see Tools/Lwm2mObserveSim) and on the XDK (see Lwm2mAgent).
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef LWM2MOBSERVE_H_
+#define LWM2MOBSERVE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorSnapshot.h"
+
+/* local type and macro definitions */
+
+/** Maximum number of concurrent observations */
+#define LWM2M_OBSERVE_MAX_OBSERVATIONS          UINT8_C(8)
+
+/** Maximum number of resources one observation covers (an IPSO object instance) */
+#define LWM2M_OBSERVE_MAX_RESOURCES_PER_TARGET  UINT8_C(3)
+
+/** Size of the datagram buffer used for responses and notifications */
+#define LWM2M_OBSERVE_DATAGRAM_SIZE             UINT16_C(256)
+
+/** Time after which an unanswered Register / Update is sent again */
+#define LWM2M_OBSERVE_RESPONSE_TIMEOUT_MS       UINT32_C(5000)
+
+/** Maximum length of the registration location returned by the server */
+#define LWM2M_OBSERVE_LOCATION_SIZE             UINT8_C(32)
+
+/**
+ * @brief Sends one datagram to the LWM2M server.
+ */
+typedef void (*Lwm2mObserve_SendFunc_T)(void * context, const uint8_t * datagram, uint16_t length);
+
+/**
+ * @brief Client configuration.
+ */
+struct Lwm2mObserve_Setup_S
+{
+    const char * EndpointName; /**< Endpoint client name used at registration */
+    uint32_t LifetimeS; /**< Registration lifetime, an Update is sent after half of it */
+    uint32_t DefaultSamplingMs; /**< Sampling period of an observed channel without pmin */
+    Lwm2mObserve_SendFunc_T Send;
+    void * SendContext;
+};
+typedef struct Lwm2mObserve_Setup_S Lwm2mObserve_Setup_T;
+
+/**
+ * @brief Notification attributes of one resource (LWM2M 1.0 section 5.1.2).
+ */
+struct Lwm2mObserve_Attributes_S
+{
+    uint32_t MinPeriodS; /**< pmin */
+    uint32_t MaxPeriodS; /**< pmax, 0 if not set */
+    float GreaterThan; /**< gt */
+    float LessThan; /**< lt */
+    float Step; /**< st */
+    uint8_t Flags; /**< LWM2M_OBSERVE_ATTRIBUTE_* of the attributes set */
+};
+typedef struct Lwm2mObserve_Attributes_S Lwm2mObserve_Attributes_T;
+
+#define LWM2M_OBSERVE_ATTRIBUTE_PMIN    UINT8_C(0x01)
+#define LWM2M_OBSERVE_ATTRIBUTE_PMAX    UINT8_C(0x02)
+#define LWM2M_OBSERVE_ATTRIBUTE_GT      UINT8_C(0x04)
+#define LWM2M_OBSERVE_ATTRIBUTE_LT      UINT8_C(0x08)
+#define LWM2M_OBSERVE_ATTRIBUTE_ST      UINT8_C(0x10)
+
+/**
+ * @brief Levels attributes are written at; a resource inherits every attribute
+ * it has not set itself from its object instance, and that from its object.
+ */
+enum Lwm2mObserve_Level_E
+{
+    LWM2M_OBSERVE_LEVEL_OBJECT = 0,
+    LWM2M_OBSERVE_LEVEL_INSTANCE,
+    LWM2M_OBSERVE_LEVEL_RESOURCE,
+    LWM2M_OBSERVE_LEVELS,
+};
+typedef enum Lwm2mObserve_Level_E Lwm2mObserve_Level_T;
+
+/**
+ * @brief One active observation.
+ */
+struct Lwm2mObserve_Observation_S
+{
+    bool Active;
+    bool UseTlv; /**< Notify in TLV instead of text/plain */
+    uint8_t FirstResource; /**< First entry of the resource table covered */
+    uint8_t ResourceCount; /**< Number of resource table entries covered */
+    uint8_t TokenLength;
+    uint8_t Token[8];
+    uint16_t LastMessageId; /**< Message ID of the last notification, to match a RST */
+    uint32_t Sequence; /**< Observe option value of the last notification */
+    uint32_t LastNotifyMs;
+    float LastValues[LWM2M_OBSERVE_MAX_RESOURCES_PER_TARGET];
+};
+typedef struct Lwm2mObserve_Observation_S Lwm2mObserve_Observation_T;
+
+/**
+ * @brief Counters of the client.
+ */
+struct Lwm2mObserve_Statistics_S
+{
+    uint32_t Registrations;
+    uint32_t Updates;
+    uint32_t Requests;
+    uint32_t Notifications;
+    uint32_t Cancellations;
+};
+typedef struct Lwm2mObserve_Statistics_S Lwm2mObserve_Statistics_T;
+
+/**
+ * @brief Client state.
+ */
+struct Lwm2mObserve_S
+{
+    Lwm2mObserve_Setup_T Setup;
+    bool Registered;
+    bool Pending; /**< A Register or Update waits for its response */
+    uint16_t PendingMessageId;
+    uint32_t PendingSinceMs;
+    uint32_t LastRegistrationMs;
+    uint16_t NextMessageId;
+    uint32_t NextToken;
+    char Location[LWM2M_OBSERVE_LOCATION_SIZE]; /**< Location-Path segments joined by '/' */
+    Lwm2mObserve_Attributes_T Attributes[LWM2M_OBSERVE_LEVELS][SENSOR_SNAPSHOT_CHANNEL_COUNT]; /**< Per level one entry per IPSO resource, in resource table order; the entries of an object or instance are kept equal */
+    Lwm2mObserve_Observation_T Observations[LWM2M_OBSERVE_MAX_OBSERVATIONS];
+    uint32_t SamplingPeriodMs[SENSOR_SNAPSHOT_CHANNEL_COUNT]; /**< 0 if the channel is not observed */
+    uint32_t SamplingGeneration; /**< Incremented whenever SamplingPeriodMs changes */
+    Lwm2mObserve_Statistics_T Statistics;
+    uint8_t Datagram[LWM2M_OBSERVE_DATAGRAM_SIZE];
+};
+typedef struct Lwm2mObserve_S Lwm2mObserve_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes the client; nothing is sent before Lwm2mObserve_Process.
+ *
+ * @param[out] client
+ * Client state
+ *
+ * @param[in] setup
+ * Configuration, copied
+ *
+ * @return true on success, false on invalid parameters.
+ */
+bool Lwm2mObserve_Init(Lwm2mObserve_T * client, const Lwm2mObserve_Setup_T * setup);
+
+/**
+ * @brief Handles one datagram received from the LWM2M server.
+ *
+ * @param[in,out] client
+ * Client state
+ *
+ * @param[in] datagram
+ * Received datagram
+ *
+ * @param[in] length
+ * Size of the datagram
+ *
+ * @param[in] snapshot
+ * Latest sensor values, used to answer reads
+ *
+ * @param[in] nowMs
+ * Current time in milliseconds
+ */
+void Lwm2mObserve_HandleDatagram(Lwm2mObserve_T * client, const uint8_t * datagram, uint16_t length,
+        const SensorSnapshot_T * snapshot, uint32_t nowMs);
+
+/**
+ * @brief Runs registration maintenance and sends the notifications which are due.
+ *
+ * Call it whenever new sensor values are available and at least every second.
+ *
+ * @param[in,out] client
+ * Client state
+ *
+ * @param[in] snapshot
+ * Latest sensor values
+ *
+ * @param[in] nowMs
+ * Current time in milliseconds
+ */
+void Lwm2mObserve_Process(Lwm2mObserve_T * client, const SensorSnapshot_T * snapshot, uint32_t nowMs);
+
+/**
+ * @brief Returns the sampling period the observations need for a channel.
+ *
+ * @param[in] client
+ * Client state
+ *
+ * @param[in] channel
+ * Snapshot channel
+ *
+ * @return Period in milliseconds, 0 if the channel is not observed.
+ */
+uint32_t Lwm2mObserve_GetSamplingPeriodMs(const Lwm2mObserve_T * client, uint8_t channel);
+
+/**
+ * @brief Parses one Uri-Query attribute ("pmin=10", "st=0.5", "gt") into attributes.
+ *
+ * A key without value removes the attribute.
+ *
+ * @param[in,out] attributes
+ * Attributes to update
+ *
+ * @param[in] query
+ * Query string, not NUL terminated
+ *
+ * @param[in] length
+ * Length of the query string
+ *
+ * @return false for an unknown attribute or a malformed value.
+ */
+bool Lwm2mObserve_ParseAttribute(Lwm2mObserve_Attributes_T * attributes, const char * query, uint16_t length);
+
+/**
+ * @brief Returns the attributes which apply to a resource: its own ones, completed
+ * by the ones of its object instance and object.
+ *
+ * @param[in] client
+ * Client state
+ *
+ * @param[in] resource
+ * Entry of the resource table
+ *
+ * @param[out] attributes
+ * Effective attributes
+ */
+void Lwm2mObserve_GetAttributes(const Lwm2mObserve_T * client, uint8_t resource, Lwm2mObserve_Attributes_T * attributes);
+
+/**
+ * @brief Decides whether a resource value needs to be notified.
+ *
+ * @param[in] attributes
+ * Attributes of the resource
+ *
+ * @param[in] lastValue
+ * Value sent in the last notification
+ *
+ * @param[in] value
+ * Current value
+ *
+ * @param[in] elapsedMs
+ * Time since the last notification
+ *
+ * @return true if a notification is due.
+ */
+bool Lwm2mObserve_IsNotificationDue(const Lwm2mObserve_Attributes_T * attributes, float lastValue, float value, uint32_t elapsedMs);
+
+#endif /* LWM2MOBSERVE_H_ */
@@ -0,0 +1,173 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the battery aware sampling.
+ *
+ *  The policy is only updated on the background lane, or in
+ *  PowerAgent_Enable before the measurement timer runs.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_POWER_AGENT
+
+#include "PowerAgent.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "BatteryMonitor.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+
+/* local variables ********************************************************** */
+
+static const PowerAgent_Setup_T * AgentSetup = NULL;
+
+static PowerPolicy_T AgentPolicy;
+
+static xTimerHandle AgentMeasureTimer = NULL;
+
+static StaticRtos_Timer_T AgentMeasureTimerStorage;
+
+static uint32_t AgentMeasureFailures = 0UL;
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Measures the battery once and acts on a transition.
+ */
+static void AgentMeasure(void)
+{
+    uint8_t from = AgentPolicy.Level;
+    uint16_t millivolts = 0U;
+
+    if (RETCODE_OK != BatteryMonitor_MeasureSignal(&millivolts))
+    {
+        AgentMeasureFailures++;
+        millivolts = 0U;
+    }
+    if (PowerPolicy_Update(&AgentPolicy, millivolts, AgentNowMs()))
+    {
+        printf("PowerAgent : %s -> %s at %u mV \r\n", AgentSetup->Policy->Levels[from].Name, PowerPolicy_GetLevel(&AgentPolicy)->Name,
+                (unsigned int) PowerPolicy_GetMillivolts(&AgentPolicy));
+        if (NULL != AgentSetup->LevelChangedCB)
+        {
+            AgentSetup->LevelChangedCB(PowerPolicy_GetLevel(&AgentPolicy));
+        }
+    }
+}
+
+static void AgentMeasureWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    AgentMeasure();
+}
+
+static void AgentMeasureTimerCallback(xTimerHandle xTimer)
+{
+    BCDS_UNUSED(xTimer);
+
+    /* The ADC conversion waits, which the timer service task must not */
+    (void) WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_BACKGROUND, AgentMeasureWork, NULL, 0UL);
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T PowerAgent_Setup(const PowerAgent_Setup_T * setup)
+{
+    if ((NULL == setup) || (NULL == setup->Policy))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0UL == setup->MeasurePeriodMs) || !PowerPolicy_Init(&AgentPolicy, setup->Policy))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentMeasureTimer = StaticRtos_CreateTimer(&AgentMeasureTimerStorage, "PowerMeasure", pdMS_TO_TICKS(setup->MeasurePeriodMs), pdTRUE, NULL,
+            AgentMeasureTimerCallback);
+    if (NULL == AgentMeasureTimer)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T PowerAgent_Enable(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    retcode = BatteryMonitor_Init();
+    if (RETCODE_OK == retcode)
+    {
+        AgentMeasure();
+        if (pdPASS != xTimerStart(AgentMeasureTimer, UINT32_MAX))
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const PowerPolicy_Level_T * PowerAgent_GetLevel(void)
+{
+    return (NULL == AgentSetup) ? NULL : PowerPolicy_GetLevel(&AgentPolicy);
+}
+
+/** Refer interface header for description */
+const PowerPolicy_Statistics_T * PowerAgent_GetStatistics(void)
+{
+    return &AgentPolicy.Statistics;
+}
+
+/** Refer interface header for description */
+void PowerAgent_PrintReport(void)
+{
+    const PowerPolicy_Statistics_T * statistics = &AgentPolicy.Statistics;
+    const PowerPolicy_Transition_T * transition;
+    uint8_t index;
+
+    if (NULL == AgentSetup)
+    {
+        return;
+    }
+    printf("PowerAgent : %s at %u mV, %lu readings (%u to %u mV), %lu failed, %lu transitions, %lu deferred \r\n",
+            PowerPolicy_GetLevel(&AgentPolicy)->Name, (unsigned int) PowerPolicy_GetMillivolts(&AgentPolicy),
+            (unsigned long) statistics->Readings, (0UL != statistics->Readings) ? (unsigned int) statistics->MinMv : 0U,
+            (unsigned int) statistics->MaxMv, (unsigned long) AgentMeasureFailures, (unsigned long) statistics->Transitions,
+            (unsigned long) statistics->Deferred);
+    for (index = 0U; index < AgentSetup->Policy->LevelCount; index++)
+    {
+        printf("PowerAgent :   %-10s %lu s \r\n", AgentSetup->Policy->Levels[index].Name, (unsigned long) (statistics->LevelMs[index] / 1000UL));
+    }
+    for (index = 0U; NULL != (transition = PowerPolicy_GetTransition(&AgentPolicy, index)); index++)
+    {
+        printf("PowerAgent :   %lu s %s -> %s at %u mV \r\n", (unsigned long) (transition->TimestampMs / 1000UL),
+                AgentSetup->Policy->Levels[transition->From].Name, AgentSetup->Policy->Levels[transition->To].Name,
+                (unsigned int) transition->Millivolts);
+    }
+}
@@ -0,0 +1,81 @@
+/**
+ *  @file
+ *
+ *  @brief Battery aware sampling: runs the PowerPolicy on the battery voltage.
+ *
+ *  The agent measures the battery through the BatteryMonitor of the XDK (the
+ *  ADC on the battery divider) every MeasurePeriodMs on the background lane
+ *  and feeds the readings into the PowerPolicy. Every transition is printed
+ *  and handed to the application, which retimes its sensors and posts.
+ *
+ *  The first measurement is taken in PowerAgent_Enable, so a device which
+ *  boots on a low battery saves from the start.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef POWERAGENT_H_
+#define POWERAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+#include "PowerPolicy.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Called on the background lane, or in PowerAgent_Enable, when the level changed.
+ *
+ * @param[in] level
+ * Settings of the new level
+ */
+typedef void (*PowerAgent_LevelChangedCB_T)(const PowerPolicy_Level_T * level);
+
+/**
+ * @brief Agent configuration.
+ */
+struct PowerAgent_Setup_S
+{
+    const PowerPolicy_Setup_T * Policy; /**< Policy configuration, must stay valid */
+    uint32_t MeasurePeriodMs; /**< Time between two battery measurements */
+    PowerAgent_LevelChangedCB_T LevelChangedCB;
+};
+typedef struct PowerAgent_Setup_S PowerAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the policy at level 0 and creates the measurement timer.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T PowerAgent_Setup(const PowerAgent_Setup_T * setup);
+
+/**
+ * @brief Initializes the battery monitor, applies the level of a first
+ * measurement and starts the periodic ones.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T PowerAgent_Enable(void);
+
+/**
+ * @brief Returns the settings of the current level, NULL before PowerAgent_Setup.
+ */
+const PowerPolicy_Level_T * PowerAgent_GetLevel(void);
+
+/**
+ * @brief Returns the counters of the policy.
+ */
+const PowerPolicy_Statistics_T * PowerAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters, the time per level and the logged transitions.
+ */
+void PowerAgent_PrintReport(void);
+
+#endif /* POWERAGENT_H_ */
@@ -0,0 +1,179 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the battery aware sampling policy.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "PowerPolicy.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define POWER_POLICY_MAX_FILTER_SHIFT   UINT8_C(8)
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Returns the level an average calls for, starting from the current one.
+ */
+static uint8_t PowerPolicyGetTarget(const PowerPolicy_T * policy, uint16_t millivolts)
+{
+    const PowerPolicy_Setup_T * setup = policy->Setup;
+    uint8_t target = policy->Level;
+
+    while (((target + 1U) < setup->LevelCount) && (millivolts <= setup->Levels[target + 1U].EnterMv))
+    {
+        target++;
+    }
+    while ((target > 0U) && ((uint32_t) millivolts > ((uint32_t) setup->Levels[target].EnterMv + setup->HysteresisMv)))
+    {
+        target--;
+    }
+    return target;
+}
+
+static void PowerPolicyLog(PowerPolicy_T * policy, uint8_t to, uint16_t millivolts, uint32_t nowMs)
+{
+    PowerPolicy_Transition_T * transition = &policy->Log[policy->LogNext];
+
+    transition->TimestampMs = nowMs;
+    transition->Millivolts = millivolts;
+    transition->From = policy->Level;
+    transition->To = to;
+    policy->LogNext = (uint8_t) ((policy->LogNext + 1U) % POWER_POLICY_LOG_LENGTH);
+    policy->Statistics.Transitions++;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool PowerPolicy_Init(PowerPolicy_T * policy, const PowerPolicy_Setup_T * setup)
+{
+    uint8_t level;
+
+    if ((NULL == policy) || (NULL == setup) || (NULL == setup->Levels) || (0U == setup->LevelCount) ||
+            (setup->LevelCount > POWER_POLICY_MAX_LEVELS) || (setup->FilterShift > POWER_POLICY_MAX_FILTER_SHIFT))
+    {
+        return false;
+    }
+    for (level = 0U; level < setup->LevelCount; level++)
+    {
+        if ((0U == setup->Levels[level].PeriodFactor) || (0UL == setup->Levels[level].UploadIntervalMs) ||
+                (0UL == setup->Levels[level].ChannelMask))
+        {
+            return false;
+        }
+        if ((level > 1U) && (setup->Levels[level].EnterMv >= setup->Levels[level - 1U].EnterMv))
+        {
+            return false;
+        }
+    }
+    (void) memset(policy, 0, sizeof(*policy));
+    policy->Setup = setup;
+    policy->Statistics.MinMv = UINT16_MAX;
+    return true;
+}
+
+/** Refer interface header for description */
+bool PowerPolicy_Update(PowerPolicy_T * policy, uint16_t millivolts, uint32_t nowMs)
+{
+    const PowerPolicy_Setup_T * setup;
+    uint16_t average;
+    uint8_t target;
+    bool isFirst;
+
+    if ((NULL == policy) || (NULL == policy->Setup))
+    {
+        return false;
+    }
+    setup = policy->Setup;
+    if (0U == millivolts)
+    {
+        policy->Statistics.Rejected++;
+        return false;
+    }
+    policy->Statistics.Readings++;
+    if (millivolts < policy->Statistics.MinMv)
+    {
+        policy->Statistics.MinMv = millivolts;
+    }
+    if (millivolts > policy->Statistics.MaxMv)
+    {
+        policy->Statistics.MaxMv = millivolts;
+    }
+
+    isFirst = !policy->HasReading;
+    if (isFirst)
+    {
+        policy->Average = (uint32_t) millivolts << setup->FilterShift;
+        policy->LevelSinceMs = nowMs;
+        policy->HasReading = true;
+    }
+    else
+    {
+        policy->Statistics.LevelMs[policy->Level] += nowMs - policy->LastReadingMs;
+        policy->Average = policy->Average - (policy->Average >> setup->FilterShift) + millivolts;
+    }
+    policy->LastReadingMs = nowMs;
+    average = PowerPolicy_GetMillivolts(policy);
+
+    target = PowerPolicyGetTarget(policy, average);
+    if (target == policy->Level)
+    {
+        return false;
+    }
+    if (!isFirst && ((nowMs - policy->LevelSinceMs) < setup->MinDwellMs))
+    {
+        policy->Statistics.Deferred++;
+        return false;
+    }
+    PowerPolicyLog(policy, target, average, nowMs);
+    policy->Level = target;
+    policy->LevelSinceMs = nowMs;
+    return true;
+}
+
+/** Refer interface header for description */
+const PowerPolicy_Level_T * PowerPolicy_GetLevel(const PowerPolicy_T * policy)
+{
+    if ((NULL == policy) || (NULL == policy->Setup))
+    {
+        return NULL;
+    }
+    return &policy->Setup->Levels[policy->Level];
+}
+
+/** Refer interface header for description */
+uint16_t PowerPolicy_GetMillivolts(const PowerPolicy_T * policy)
+{
+    if ((NULL == policy) || !policy->HasReading)
+    {
+        return 0U;
+    }
+    /* Rounded to the nearest mV */
+    return (uint16_t) ((policy->Average + ((UINT32_C(1) << policy->Setup->FilterShift) >> 1U)) >> policy->Setup->FilterShift);
+}
+
+/** Refer interface header for description */
+const PowerPolicy_Transition_T * PowerPolicy_GetTransition(const PowerPolicy_T * policy, uint8_t index)
+{
+    uint32_t kept;
+
+    if (NULL == policy)
+    {
+        return NULL;
+    }
+    kept = (policy->Statistics.Transitions < POWER_POLICY_LOG_LENGTH) ? policy->Statistics.Transitions : POWER_POLICY_LOG_LENGTH;
+    if (index >= kept)
+    {
+        return NULL;
+    }
+    return &policy->Log[(policy->LogNext + POWER_POLICY_LOG_LENGTH - kept + index) % POWER_POLICY_LOG_LENGTH];
+}
@@ -0,0 +1,151 @@
+/**
+ *  @file
+ *
+ *  @brief Battery aware sampling policy: which power level the device runs at.
+ *
+ *  The policy maps the battery voltage to one of up to
+ *  POWER_POLICY_MAX_LEVELS levels. Level 0 is the normal operation, every
+ *  further level saves more: its sensor and snapshot periods are PeriodFactor
+ *  times the normal ones, posts are UploadIntervalMs apart, only the channels
+ *  of ChannelMask are sampled and posted and the magnetometer runs at
+ *  MagnetometerRateHz.
+ *
+ *  The readings are smoothed with an exponential average of weight
+ *  1 / 2^FilterShift, which rides out the dips of a WLAN transmission. Level n
+ *  is entered once the average drops to EnterMv of level n and left towards
+ *  level n - 1 once it rises above EnterMv plus HysteresisMv, e.g. on the
+ *  charger. Apart from the first reading, which selects its level right away,
+ *  the level changes at most once per MinDwellMs. The last
+ *  POWER_POLICY_LOG_LENGTH transitions are kept.
+ *
+ *  The module is platform independent and keeps no time of its own; the
+ *  caller passes milliseconds. PowerAgent runs it on the XDK,
+ *  Tools/PowerPolicySim on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef POWERPOLICY_H_
+#define POWERPOLICY_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Most levels of a policy */
+#define POWER_POLICY_MAX_LEVELS     UINT8_C(4)
+
+/** Transitions kept by the policy */
+#define POWER_POLICY_LOG_LENGTH     UINT8_C(8)
+
+/**
+ * @brief Settings of a level.
+ */
+struct PowerPolicy_Level_S
+{
+    const char * Name;
+    uint16_t EnterMv; /**< The level applies from this voltage down, ignored for level 0 */
+    uint16_t PeriodFactor; /**< Sensor and snapshot periods in multiples of the normal ones, at least 1 */
+    uint32_t UploadIntervalMs; /**< Wait after a post */
+    uint32_t ChannelMask; /**< Channels sampled and posted, bit n for channel n */
+    uint8_t MagnetometerRateHz; /**< Data rate of the magnetometer, 0 for the setting of SensorTable.h */
+};
+typedef struct PowerPolicy_Level_S PowerPolicy_Level_T;
+
+/**
+ * @brief Policy configuration.
+ */
+struct PowerPolicy_Setup_S
+{
+    const PowerPolicy_Level_T * Levels; /**< Normal operation first, EnterMv falling */
+    uint8_t LevelCount; /**< 1 to POWER_POLICY_MAX_LEVELS */
+    uint16_t HysteresisMv; /**< Rise above EnterMv before a level is left */
+    uint32_t MinDwellMs; /**< Shortest time between two transitions */
+    uint8_t FilterShift; /**< Weight of a reading in the average is 1 / 2^FilterShift, 0 to 8 */
+};
+typedef struct PowerPolicy_Setup_S PowerPolicy_Setup_T;
+
+/**
+ * @brief A change of the level.
+ */
+struct PowerPolicy_Transition_S
+{
+    uint32_t TimestampMs;
+    uint16_t Millivolts; /**< Average which caused it */
+    uint8_t From;
+    uint8_t To;
+};
+typedef struct PowerPolicy_Transition_S PowerPolicy_Transition_T;
+
+/**
+ * @brief Counters of the policy.
+ */
+struct PowerPolicy_Statistics_S
+{
+    uint32_t Readings;
+    uint32_t Rejected; /**< Readings of 0 mV */
+    uint32_t Transitions;
+    uint32_t Deferred; /**< Readings which asked for another level within MinDwellMs */
+    uint16_t MinMv; /**< Lowest reading */
+    uint16_t MaxMv; /**< Highest reading */
+    uint32_t LevelMs[POWER_POLICY_MAX_LEVELS]; /**< Time spent in every level, up to the last reading */
+};
+typedef struct PowerPolicy_Statistics_S PowerPolicy_Statistics_T;
+
+/**
+ * @brief Policy state.
+ */
+struct PowerPolicy_S
+{
+    const PowerPolicy_Setup_T * Setup;
+    uint8_t Level;
+    bool HasReading;
+    uint32_t Average; /**< Millivolts times 2^FilterShift */
+    uint32_t LevelSinceMs;
+    uint32_t LastReadingMs;
+    PowerPolicy_Transition_T Log[POWER_POLICY_LOG_LENGTH];
+    uint8_t LogNext; /**< Entry the next transition is written to */
+    PowerPolicy_Statistics_T Statistics;
+};
+typedef struct PowerPolicy_S PowerPolicy_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the policy at level 0, without a reading.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return false for an invalid setup (no levels, EnterMv not falling, a factor, interval or channel mask of 0).
+ */
+bool PowerPolicy_Init(PowerPolicy_T * policy, const PowerPolicy_Setup_T * setup);
+
+/**
+ * @brief Feeds a battery reading into the average and moves the level.
+ *
+ * @param[in] millivolts
+ * Battery voltage, 0 for a failed measurement, which is counted and ignored
+ *
+ * @return true if the level changed.
+ */
+bool PowerPolicy_Update(PowerPolicy_T * policy, uint16_t millivolts, uint32_t nowMs);
+
+/**
+ * @brief Returns the settings of the current level.
+ */
+const PowerPolicy_Level_T * PowerPolicy_GetLevel(const PowerPolicy_T * policy);
+
+/**
+ * @brief Returns the average of the readings in mV, 0 before the first one.
+ */
+uint16_t PowerPolicy_GetMillivolts(const PowerPolicy_T * policy);
+
+/**
+ * @brief Returns a logged transition, index 0 for the oldest one kept; NULL past the last one.
+ */
+const PowerPolicy_Transition_T * PowerPolicy_GetTransition(const PowerPolicy_T * policy, uint8_t index);
+
+#endif /* POWERPOLICY_H_ */
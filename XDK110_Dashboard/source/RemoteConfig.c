@@ -0,0 +1,309 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the runtime configuration document.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "RemoteConfig.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* local type and macro definitions */
+
+#define REMOTE_CONFIG_MAX_KEY               UINT8_C(32)
+#define REMOTE_CONFIG_PERIOD_SUFFIX         "_period_ms"
+
+/* local variables ********************************************************** */
+
+static const uint16_t RemoteConfigGyroscopeRanges[] = { 125U, 250U, 500U, 1000U, 2000U };
+
+static const uint8_t RemoteConfigMagnetometerRates[] = { 2U, 6U, 8U, 10U, 15U, 20U, 25U, 30U };
+
+/* local functions ********************************************************** */
+
+static bool RemoteConfigIsSpace(char character)
+{
+    return ((' ' == character) || ('\t' == character) || ('\r' == character));
+}
+
+/**
+ * @brief Parses a decimal number filling the whole value.
+ */
+static bool RemoteConfigParseNumber(const char * value, uint32_t length, uint32_t * number)
+{
+    uint32_t result = 0UL;
+    uint32_t index;
+
+    if ((0UL == length) || (length > 10UL))
+    {
+        return false;
+    }
+    for (index = 0UL; index < length; index++)
+    {
+        if ((value[index] < '0') || (value[index] > '9') ||
+                (result > ((UINT32_MAX - (uint32_t) (value[index] - '0')) / 10UL)))
+        {
+            return false;
+        }
+        result = (result * 10UL) + (uint32_t) (value[index] - '0');
+    }
+    *number = result;
+    return true;
+}
+
+static bool RemoteConfigParsePeriod(const char * value, uint32_t length, uint32_t minimumMs, uint32_t * periodMs)
+{
+    return (RemoteConfigParseNumber(value, length, periodMs) && (*periodMs >= minimumMs) && (*periodMs <= REMOTE_CONFIG_MAX_PERIOD_MS));
+}
+
+/**
+ * @brief Compares a key with a name case insensitively, as the sensor names are CamelCase.
+ */
+static bool RemoteConfigIsKey(const char * key, const char * name)
+{
+    char character;
+
+    for (; '\0' != *name; key++, name++)
+    {
+        character = *name;
+        if ((character >= 'A') && (character <= 'Z'))
+        {
+            character = (char) (character - 'A' + 'a');
+        }
+        if (*key != character)
+        {
+            return false;
+        }
+    }
+    return ('\0' == *key);
+}
+
+/**
+ * @brief Returns the sensor of a <sensor>_period_ms key, SENSOR_TABLE_SENSOR_COUNT for another key.
+ *
+ * The suffix is cut off the key.
+ */
+static uint8_t RemoteConfigGetPeriodSensor(char * key, uint32_t keyLength)
+{
+    uint32_t suffixLength = sizeof(REMOTE_CONFIG_PERIOD_SUFFIX) - 1U;
+    uint8_t sensor;
+
+    if ((keyLength <= suffixLength) || (0 != strcmp(&key[keyLength - suffixLength], REMOTE_CONFIG_PERIOD_SUFFIX)))
+    {
+        return (uint8_t) SENSOR_TABLE_SENSOR_COUNT;
+    }
+    key[keyLength - suffixLength] = '\0';
+    for (sensor = 0U; sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT; sensor++)
+    {
+        if (RemoteConfigIsKey(key, SensorTable_GetSensorName(sensor)))
+        {
+            break;
+        }
+    }
+    return sensor;
+}
+
+/**
+ * @brief Applies one key to config.
+ *
+ * @return false for a malformed value or one out of its range.
+ */
+static bool RemoteConfigParseEntry(RemoteConfig_T * config, char * key, uint32_t keyLength, const char * value, uint32_t length)
+{
+    uint32_t number = 0UL;
+    uint8_t sensor;
+    uint8_t index;
+
+    if (0 == strcmp(key, "version"))
+    {
+        return RemoteConfigParseNumber(value, length, &config->Version);
+    }
+    if (0 == strcmp(key, "snapshot_period_ms"))
+    {
+        return RemoteConfigParsePeriod(value, length, REMOTE_CONFIG_MIN_PERIOD_MS, &config->SnapshotPeriodMs);
+    }
+    if (0 == strcmp(key, "upload_interval_ms"))
+    {
+        return RemoteConfigParsePeriod(value, length, REMOTE_CONFIG_MIN_UPLOAD_MS, &config->UploadIntervalMs);
+    }
+    if (0 == strcmp(key, "gyroscope_range_dps"))
+    {
+        for (index = 0U; index < (uint8_t) (sizeof(RemoteConfigGyroscopeRanges) / sizeof(RemoteConfigGyroscopeRanges[0])); index++)
+        {
+            if (RemoteConfigParseNumber(value, length, &number) && (number == RemoteConfigGyroscopeRanges[index]))
+            {
+                config->GyroscopeRangeDps = (uint16_t) number;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (0 == strcmp(key, "magnetometer_rate_hz"))
+    {
+        for (index = 0U; index < (uint8_t) sizeof(RemoteConfigMagnetometerRates); index++)
+        {
+            if (RemoteConfigParseNumber(value, length, &number) && (number == RemoteConfigMagnetometerRates[index]))
+            {
+                config->MagnetometerRateHz = (uint8_t) number;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (0 == strcmp(key, "post_path"))
+    {
+        if ((0UL == length) || (length >= REMOTE_CONFIG_MAX_PATH) || ('/' != value[0]) || (NULL != memchr(value, ' ', length)) ||
+                (NULL != memchr(value, '\t', length)))
+        {
+            return false;
+        }
+        memcpy(config->PostPath, value, length);
+        config->PostPath[length] = '\0';
+        return true;
+    }
+    sensor = RemoteConfigGetPeriodSensor(key, keyLength);
+    if (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT)
+    {
+        return RemoteConfigParsePeriod(value, length, REMOTE_CONFIG_MIN_PERIOD_MS, &config->SensorPeriodsMs[sensor]);
+    }
+    /* A key of a newer firmware */
+    return true;
+}
+
+/**
+ * @brief Parses one line without its line feed.
+ */
+static bool RemoteConfigParseLine(RemoteConfig_T * config, const char * line, uint32_t length)
+{
+    char key[REMOTE_CONFIG_MAX_KEY];
+    const char * separator;
+    uint32_t keyLength;
+    const char * value;
+
+    while ((length > 0UL) && RemoteConfigIsSpace(line[length - 1UL]))
+    {
+        length--;
+    }
+    while ((length > 0UL) && RemoteConfigIsSpace(*line))
+    {
+        line++;
+        length--;
+    }
+    if ((0UL == length) || ('#' == line[0]))
+    {
+        return true;
+    }
+    separator = memchr(line, '=', length);
+    if (NULL == separator)
+    {
+        return false;
+    }
+    keyLength = (uint32_t) (separator - line);
+    while ((keyLength > 0UL) && RemoteConfigIsSpace(line[keyLength - 1UL]))
+    {
+        keyLength--;
+    }
+    if ((0UL == keyLength) || (keyLength >= sizeof(key)))
+    {
+        return false;
+    }
+    memcpy(key, line, keyLength);
+    key[keyLength] = '\0';
+    value = separator + 1;
+    length -= (uint32_t) (value - line);
+    while ((length > 0UL) && RemoteConfigIsSpace(*value))
+    {
+        value++;
+        length--;
+    }
+    return RemoteConfigParseEntry(config, key, keyLength, value, length);
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool RemoteConfig_Parse(const char * document, uint32_t length, RemoteConfig_T * config, uint16_t * errorLine)
+{
+    RemoteConfig_T parsed;
+    const char * end;
+    uint32_t lineLength;
+    uint16_t line = 0U;
+
+    if (NULL != errorLine)
+    {
+        *errorLine = 0U;
+    }
+    if ((NULL == document) || (NULL == config) || (length > REMOTE_CONFIG_MAX_DOCUMENT))
+    {
+        return false;
+    }
+    memset(&parsed, 0, sizeof(parsed));
+    while (length > 0UL)
+    {
+        line++;
+        end = memchr(document, '\n', length);
+        lineLength = (NULL != end) ? (uint32_t) (end - document) : length;
+        if ((NULL != memchr(document, '\0', lineLength)) || !RemoteConfigParseLine(&parsed, document, lineLength))
+        {
+            if (NULL != errorLine)
+            {
+                *errorLine = line;
+            }
+            return false;
+        }
+        if (NULL == end)
+        {
+            break;
+        }
+        document = end + 1;
+        length -= lineLength + 1UL;
+    }
+    *config = parsed;
+    return true;
+}
+
+/** Refer interface header for description */
+uint32_t RemoteConfig_Compare(const RemoteConfig_T * previous, const RemoteConfig_T * next)
+{
+    uint32_t changed = 0UL;
+
+    if ((NULL == previous) || (NULL == next))
+    {
+        return 0UL;
+    }
+    if (previous->SnapshotPeriodMs != next->SnapshotPeriodMs)
+    {
+        changed |= REMOTE_CONFIG_CHANGED_SNAPSHOT;
+    }
+    if (previous->UploadIntervalMs != next->UploadIntervalMs)
+    {
+        changed |= REMOTE_CONFIG_CHANGED_UPLOAD;
+    }
+    if (0 != memcmp(previous->SensorPeriodsMs, next->SensorPeriodsMs, sizeof(previous->SensorPeriodsMs)))
+    {
+        changed |= REMOTE_CONFIG_CHANGED_SENSOR_PERIOD;
+    }
+    if (previous->GyroscopeRangeDps != next->GyroscopeRangeDps)
+    {
+        changed |= REMOTE_CONFIG_CHANGED_GYROSCOPE;
+    }
+    if (previous->MagnetometerRateHz != next->MagnetometerRateHz)
+    {
+        changed |= REMOTE_CONFIG_CHANGED_MAGNETOMETER;
+    }
+    if (0 != strcmp(previous->PostPath, next->PostPath))
+    {
+        changed |= REMOTE_CONFIG_CHANGED_POST_PATH;
+    }
+    if (previous->Version != next->Version)
+    {
+        changed |= REMOTE_CONFIG_CHANGED_VERSION;
+    }
+    return changed;
+}
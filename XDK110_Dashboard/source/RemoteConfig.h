@@ -0,0 +1,103 @@
+/**
+ *  @file
+ *
+ *  @brief Runtime configuration of the dashboard: parses and compares the
+ *  configuration document served next to the upload endpoint.
+ *
+ *  The document is plain text, one `key=value` per line; blank lines and
+ *  lines starting with '#' are skipped:
+ *
+ *      # office units, slower upload
+ *      version=7
+ *      snapshot_period_ms=2000
+ *      upload_interval_ms=60000
+ *      gyroscope_period_ms=250
+ *      gyroscope_range_dps=2000
+ *      magnetometer_rate_hz=20
+ *      post_path=/~ex0eby/sendValuesToDatabase.php
+ *
+ *  Every key is optional. A missing key, like a member left 0 or empty in
+ *  RemoteConfig_T, stands for the value the firmware was built with, so
+ *  removing a line from the document undoes it on the next fetch. Unknown
+ *  keys are skipped, so a document may already carry the keys of a newer
+ *  firmware. Any malformed line or value out of its range rejects the whole
+ *  document: a device applies a document completely or not at all.
+ *
+ *  Keys and ranges:
+ *  - version: any number, only reported
+ *  - snapshot_period_ms: REMOTE_CONFIG_MIN_PERIOD_MS to REMOTE_CONFIG_MAX_PERIOD_MS
+ *  - upload_interval_ms: REMOTE_CONFIG_MIN_UPLOAD_MS to REMOTE_CONFIG_MAX_PERIOD_MS
+ *  - <sensor>_period_ms: as snapshot_period_ms, <sensor> being the name of
+ *    SENSOR_TABLE_SENSORS in lower case, e.g. light_period_ms
+ *  - gyroscope_range_dps: 125, 250, 500, 1000 or 2000
+ *  - magnetometer_rate_hz: 2, 6, 8, 10, 15, 20, 25 or 30
+ *  - post_path: absolute path, no spaces, shorter than REMOTE_CONFIG_MAX_PATH
+ *
+ *  The module is platform independent. ConfigAgent fetches and keeps the
+ *  document on the XDK, Tools/ConfigServer serves one on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef REMOTECONFIG_H_
+#define REMOTECONFIG_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorTable.h"
+
+/* local type and macro definitions */
+
+#define REMOTE_CONFIG_MAX_DOCUMENT          UINT16_C(512) /**< Longest document accepted */
+#define REMOTE_CONFIG_MAX_PATH              UINT8_C(64)
+#define REMOTE_CONFIG_MIN_PERIOD_MS         UINT32_C(20)
+#define REMOTE_CONFIG_MIN_UPLOAD_MS         UINT32_C(1000)
+#define REMOTE_CONFIG_MAX_PERIOD_MS         UINT32_C(86400000)
+
+/** Bits of RemoteConfig_Compare, one per group of settings applied together */
+#define REMOTE_CONFIG_CHANGED_SNAPSHOT      UINT32_C(0x01)
+#define REMOTE_CONFIG_CHANGED_UPLOAD        UINT32_C(0x02)
+#define REMOTE_CONFIG_CHANGED_SENSOR_PERIOD UINT32_C(0x04)
+#define REMOTE_CONFIG_CHANGED_GYROSCOPE     UINT32_C(0x08)
+#define REMOTE_CONFIG_CHANGED_MAGNETOMETER  UINT32_C(0x10)
+#define REMOTE_CONFIG_CHANGED_POST_PATH     UINT32_C(0x20)
+#define REMOTE_CONFIG_CHANGED_VERSION       UINT32_C(0x40) /**< Nothing to apply, but a new document to keep */
+
+/**
+ * @brief Settings of a document; 0 or an empty string keeps the built in value.
+ */
+struct RemoteConfig_S
+{
+    uint32_t Version;
+    uint32_t SnapshotPeriodMs;
+    uint32_t UploadIntervalMs;
+    uint32_t SensorPeriodsMs[SENSOR_TABLE_SENSOR_COUNT];
+    uint16_t GyroscopeRangeDps;
+    uint8_t MagnetometerRateHz;
+    char PostPath[REMOTE_CONFIG_MAX_PATH];
+};
+typedef struct RemoteConfig_S RemoteConfig_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Parses and validates a document.
+ *
+ * @param[out] config
+ * Settings of the document, only written if it is valid
+ *
+ * @param[out] errorLine
+ * Number of the first rejected line, 0 for a document too long; may be NULL
+ *
+ * @return false if the document is rejected.
+ */
+bool RemoteConfig_Parse(const char * document, uint32_t length, RemoteConfig_T * config, uint16_t * errorLine);
+
+/**
+ * @brief Returns the REMOTE_CONFIG_CHANGED_ bits of the settings which differ.
+ */
+uint32_t RemoteConfig_Compare(const RemoteConfig_T * previous, const RemoteConfig_T * next);
+
+#endif /* REMOTECONFIG_H_ */
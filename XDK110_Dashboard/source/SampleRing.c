@@ -0,0 +1,77 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor snapshot ring.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "SampleRing.h"
+
+/* system header files */
+#include <stddef.h>
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool SampleRing_Init(SampleRing_T * ring, SensorSnapshot_T * storage, uint32_t capacity)
+{
+    if ((NULL == ring) || (NULL == storage) || (0UL == capacity))
+    {
+        return false;
+    }
+    ring->Storage = storage;
+    ring->Capacity = capacity;
+    ring->Head = 0UL;
+    ring->Tail = 0UL;
+    ring->Dropped = 0UL;
+    ring->PeakFill = 0UL;
+    return true;
+}
+
+/** Refer interface header for description */
+bool SampleRing_Push(SampleRing_T * ring, const SensorSnapshot_T * snapshot)
+{
+    uint32_t head = ring->Head;
+    uint32_t fill = head - ring->Tail;
+
+    if (fill >= ring->Capacity)
+    {
+        ring->Dropped++;
+        return false;
+    }
+    ring->Storage[head % ring->Capacity] = *snapshot;
+    /* Publish the index only once the snapshot is complete */
+    ring->Head = head + 1UL;
+    if ((fill + 1UL) > ring->PeakFill)
+    {
+        ring->PeakFill = fill + 1UL;
+    }
+    return true;
+}
+
+/** Refer interface header for description */
+uint32_t SampleRing_Count(const SampleRing_T * ring)
+{
+    return ring->Head - ring->Tail;
+}
+
+/** Refer interface header for description */
+const SensorSnapshot_T * SampleRing_Peek(const SampleRing_T * ring, uint32_t index)
+{
+    if (index >= SampleRing_Count(ring))
+    {
+        return NULL;
+    }
+    return &ring->Storage[(ring->Tail + index) % ring->Capacity];
+}
+
+/** Refer interface header for description */
+void SampleRing_Consume(SampleRing_T * ring, uint32_t count)
+{
+    uint32_t waiting = SampleRing_Count(ring);
+
+    ring->Tail += (count < waiting) ? count : waiting;
+}
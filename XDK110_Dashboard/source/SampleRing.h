@@ -0,0 +1,93 @@
+/**
+ *  @file
+ *
+ *  @brief Single producer / single consumer ring of sensor snapshots.
+ *
+ *  The acquisition side (a timer callback) pushes, one consumer task peeks and
+ *  consumes. Each index is only written by its owner, so no lock is needed as
+ *  long as 32 bit stores are atomic. A full ring rejects the new sample and
+ *  counts it as dropped, the producer never blocks.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SAMPLERING_H_
+#define SAMPLERING_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorSnapshot.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Ring state; the storage is owned by the caller.
+ */
+struct SampleRing_S
+{
+    SensorSnapshot_T * Storage;
+    uint32_t Capacity; /**< Number of snapshots Storage holds */
+    volatile uint32_t Head; /**< Total pushes, written by the producer only */
+    volatile uint32_t Tail; /**< Total consumes, written by the consumer only */
+    volatile uint32_t Dropped; /**< Pushes rejected because the ring was full */
+    uint32_t PeakFill; /**< Highest fill level seen by the producer */
+};
+typedef struct SampleRing_S SampleRing_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes an empty ring.
+ *
+ * @param[out] ring
+ * Ring state
+ *
+ * @param[in] storage
+ * Snapshot storage
+ *
+ * @param[in] capacity
+ * Number of snapshots in storage
+ *
+ * @return false on invalid parameters.
+ */
+bool SampleRing_Init(SampleRing_T * ring, SensorSnapshot_T * storage, uint32_t capacity);
+
+/**
+ * @brief Appends a snapshot (producer side).
+ *
+ * @return false if the ring was full and the snapshot was dropped.
+ */
+bool SampleRing_Push(SampleRing_T * ring, const SensorSnapshot_T * snapshot);
+
+/**
+ * @brief Returns the number of snapshots waiting to be consumed.
+ */
+uint32_t SampleRing_Count(const SampleRing_T * ring);
+
+/**
+ * @brief Returns a waiting snapshot without consuming it (consumer side).
+ *
+ * @param[in] ring
+ * Ring state
+ *
+ * @param[in] index
+ * 0 for the oldest waiting snapshot
+ *
+ * @return The snapshot, NULL if fewer than index + 1 snapshots are waiting.
+ */
+const SensorSnapshot_T * SampleRing_Peek(const SampleRing_T * ring, uint32_t index);
+
+/**
+ * @brief Releases the oldest snapshots (consumer side).
+ *
+ * @param[in] ring
+ * Ring state
+ *
+ * @param[in] count
+ * Number of snapshots to release, limited to the number waiting
+ */
+void SampleRing_Consume(SampleRing_T * ring, uint32_t count);
+
+#endif /* SAMPLERING_H_ */
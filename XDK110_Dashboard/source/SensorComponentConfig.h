@@ -0,0 +1,24 @@
+/**
+ *  @file
+ *
+ *  @brief Sensors of the dashboard, see SensorComponent.h.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORCOMPONENTCONFIG_H_
+#define SENSORCOMPONENTCONFIG_H_
+
+/* local type and macro definitions */
+
+#define SENSOR_COMPONENT_ENABLE_ACCELEROMETER       1
+#define SENSOR_COMPONENT_ENABLE_GYROSCOPE           1
+#define SENSOR_COMPONENT_ENABLE_MAGNETOMETER        1
+#define SENSOR_COMPONENT_ENABLE_ENVIRONMENTAL       1
+#define SENSOR_COMPONENT_ENABLE_LIGHT               1
+#define SENSOR_COMPONENT_ENABLE_ACOUSTIC            1
+
+/** Print the channels of a sensor after every read */
+#define SENSOR_COMPONENT_PRINT_ENABLE               1
+
+#endif /* SENSORCOMPONENTCONFIG_H_ */
@@ -0,0 +1,39 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor snapshot helpers.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "SensorSnapshot.h"
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+const char * SensorSnapshot_GetChannelName(uint8_t channel)
+{
+    return SensorTable_GetChannelKey(channel);
+}
+
+/** Refer interface header for description */
+uint32_t SensorSnapshot_ToJson(const SensorSnapshot_T * snapshot, char * buffer, size_t size)
+{
+    if (NULL == snapshot)
+    {
+        return 0UL;
+    }
+    return SensorTable_ToJson(snapshot->Values, SENSOR_TABLE_ALL_CHANNELS, buffer, size);
+}
+
+/** Refer interface header for description */
+bool SensorSnapshot_WriteJson(const SensorSnapshot_T * snapshot, PayloadWriter_T * writer)
+{
+    if (NULL == snapshot)
+    {
+        return false;
+    }
+    return SensorTable_WriteJson(snapshot->Values, SENSOR_TABLE_ALL_CHANNELS, writer);
+}
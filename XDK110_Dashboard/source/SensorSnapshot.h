@@ -0,0 +1,98 @@
+/**
+ *  @file
+ *
+ *  @brief Snapshot of the latest value of every sensor channel of the dashboard.
+ *
+ *  The snapshot is the common input of all payload encoders. Every channel is
+ *  stored as a 32 bit word; the channels listed in SENSOR_SNAPSHOT_FLOAT_MASK
+ *  carry an IEEE-754 float, all other channels carry a signed integer. The
+ *  channels themselves are defined by the shared table in SensorTable.h.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORSNAPSHOT_H_
+#define SENSORSNAPSHOT_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stddef.h>
+
+#include "SensorTable.h"
+
+/* local type and macro definitions */
+
+#define SENSOR_SNAPSHOT_CHANNEL_ENUM(id, sensor, key, type, scale, unit)    SENSOR_SNAPSHOT_##id = SENSOR_TABLE_CHANNEL_##id,
+
+/**
+ * @brief Index of every channel inside SensorSnapshot_T::Values, see SENSOR_TABLE_CHANNELS.
+ */
+enum SensorSnapshot_Channel_E
+{
+    SENSOR_TABLE_CHANNELS(SENSOR_SNAPSHOT_CHANNEL_ENUM)
+
+    SENSOR_SNAPSHOT_CHANNEL_COUNT = SENSOR_TABLE_CHANNEL_COUNT
+};
+
+/**
+ * @brief Bit mask of the channels which hold a float value (bit n = channel n).
+ */
+#define SENSOR_SNAPSHOT_FLOAT_MASK      SENSOR_TABLE_FLOAT_MASK
+
+/**
+ * @brief One channel value, interpreted according to SENSOR_SNAPSHOT_FLOAT_MASK.
+ */
+typedef SensorTable_Value_T SensorSnapshot_Value_T;
+
+/**
+ * @brief The value of all channels at one point in time.
+ */
+struct SensorSnapshot_S
+{
+    uint32_t TimestampMs; /**< Milliseconds since boot at which the snapshot was taken */
+    SensorSnapshot_Value_T Values[SENSOR_SNAPSHOT_CHANNEL_COUNT];
+};
+typedef struct SensorSnapshot_S SensorSnapshot_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Returns the JSON key of a channel as used in the HTTP POST body.
+ *
+ * @param[in] channel
+ * Channel index
+ *
+ * @return Key string, NULL for an invalid channel.
+ */
+const char * SensorSnapshot_GetChannelName(uint8_t channel);
+
+/**
+ * @brief Formats a snapshot as the JSON object expected by DEST_POST_PATH.
+ *
+ * @param[in] snapshot
+ * Snapshot to format
+ *
+ * @param[out] buffer
+ * Output buffer, NUL terminated on success
+ *
+ * @param[in] size
+ * Size of the output buffer
+ *
+ * @return Length of the JSON text, 0 if the buffer is too small.
+ */
+uint32_t SensorSnapshot_ToJson(const SensorSnapshot_T * snapshot, char * buffer, size_t size);
+
+/**
+ * @brief Writes the JSON object of SensorSnapshot_ToJson through a payload writer.
+ *
+ * @param[in] snapshot
+ * Snapshot to write
+ *
+ * @param[in,out] writer
+ * Writer started with PayloadWriter_Init
+ *
+ * @return false if the writer failed.
+ */
+bool SensorSnapshot_WriteJson(const SensorSnapshot_T * snapshot, PayloadWriter_T * writer);
+
+#endif /* SENSORSNAPSHOT_H_ */
@@ -0,0 +1,223 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the sensor trace recorder.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_SENSOR_TRACE_AGENT
+
+#include "SensorTraceAgent.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "XDK_Storage.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "SensorComponent.h"
+#include "SensorTrace.h"
+#include "WorkDispatcher.h"
+
+/* constant definitions ***************************************************** */
+
+#define SENSOR_TRACE_AGENT_REPORT_CHUNKS    UINT32_C(64) /**< Chunks between two reports */
+
+/* local variables ********************************************************** */
+
+static const SensorTraceAgent_Setup_T * AgentSetup = NULL;
+
+static uint8_t AgentChunks[2][SENSOR_TRACE_AGENT_CHUNK_SIZE];
+
+static SensorTrace_Writer_T AgentWriter; /**< Chunk being filled, real-time lane only */
+
+static uint8_t AgentActiveChunk = 0U;
+
+static volatile bool AgentIsWriting = false; /**< The other chunk waits for the SD card */
+
+static volatile bool AgentIsRecording = false;
+
+static uint32_t AgentOffset = 0UL; /**< Append position in the file, background lane only */
+
+static SensorTraceAgent_Statistics_T AgentStatistics;
+
+/* local functions ********************************************************** */
+
+static Retcode_T AgentWrite(uint8_t * data, uint32_t length)
+{
+    uint32_t bytesWritten = 0UL;
+    Storage_Write_T writeCredentials =
+            {
+                    .FileName = AgentSetup->FileName,
+                    .WriteBuffer = data,
+                    .BytesToWrite = length,
+                    .ActualBytesWritten = &bytesWritten,
+                    .Offset = AgentOffset,
+            };
+    Retcode_T retcode = Storage_Write(STORAGE_MEDIUM_SD_CARD, &writeCredentials);
+
+    if (RETCODE_OK == retcode)
+    {
+        AgentOffset += length;
+    }
+    return retcode;
+}
+
+/**
+ * @brief Writes a full chunk on the background lane.
+ *
+ * @param[in] param1
+ * Chunk buffer
+ *
+ * @param[in] param2
+ * Chunk length
+ */
+static void AgentWriteWork(void * param1, uint32_t param2)
+{
+    if (RETCODE_OK == AgentWrite((uint8_t *) param1, param2))
+    {
+        AgentStatistics.Chunks++;
+        AgentStatistics.Bytes = AgentOffset;
+    }
+    else
+    {
+        AgentStatistics.WriteErrors++;
+    }
+    if ((0UL != AgentSetup->MaxBytes) && ((AgentOffset + SENSOR_TRACE_AGENT_CHUNK_SIZE) > AgentSetup->MaxBytes))
+    {
+        AgentIsRecording = false;
+        printf("SensorTraceAgent : %s is full, recording stopped\r\n", AgentSetup->FileName);
+        SensorTraceAgent_PrintReport();
+    }
+    else if (0UL == (AgentStatistics.Chunks % SENSOR_TRACE_AGENT_REPORT_CHUNKS))
+    {
+        SensorTraceAgent_PrintReport();
+    }
+    AgentIsWriting = false;
+}
+
+/**
+ * @brief Hands the filled chunk to the background lane and starts the other one.
+ *
+ * @return false if the other chunk is still being written.
+ */
+static bool AgentSwapChunk(void)
+{
+    uint32_t length;
+
+    if (AgentIsWriting)
+    {
+        return false;
+    }
+    length = SensorTrace_FinishChunk(&AgentWriter);
+    AgentIsWriting = true;
+    if (RETCODE_OK != WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_BACKGROUND, AgentWriteWork, AgentChunks[AgentActiveChunk], length))
+    {
+        AgentIsWriting = false;
+        AgentStatistics.Dropped += AgentWriter.RecordCount;
+    }
+    AgentActiveChunk = (uint8_t) (1U - AgentActiveChunk);
+    (void) SensorTrace_InitWriter(&AgentWriter, AgentChunks[AgentActiveChunk], SENSOR_TRACE_AGENT_CHUNK_SIZE);
+    return true;
+}
+
+/**
+ * @brief Read hook of the sensor component, runs on the real-time lane.
+ */
+static void AgentRecord(SensorTable_Sensor_T sensor, Retcode_T retcode, const SensorTable_Value_T * values)
+{
+    SensorTrace_Record_T record;
+    uint8_t channel;
+
+    if (!AgentIsRecording)
+    {
+        return;
+    }
+    record.TimestampMs = (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+    record.Sensor = (uint8_t) sensor;
+    record.Retcode = (uint32_t) retcode;
+    for (channel = 0U; channel < (uint8_t) SENSOR_TABLE_CHANNEL_COUNT; channel++)
+    {
+        record.Values[channel] = values[channel];
+    }
+    if (!SensorTrace_Append(&AgentWriter, &record) && (!AgentSwapChunk() || !SensorTrace_Append(&AgentWriter, &record)))
+    {
+        AgentStatistics.Dropped++;
+        return;
+    }
+    AgentStatistics.Records++;
+    if (RETCODE_OK != retcode)
+    {
+        AgentStatistics.FailedReads++;
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T SensorTraceAgent_Setup(const SensorTraceAgent_Setup_T * setup)
+{
+    if ((NULL == setup) || (NULL == setup->FileName))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    AgentSetup = setup;
+    AgentActiveChunk = 0U;
+    (void) SensorTrace_InitWriter(&AgentWriter, AgentChunks[AgentActiveChunk], SENSOR_TRACE_AGENT_CHUNK_SIZE);
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T SensorTraceAgent_Enable(void)
+{
+    uint8_t header[SENSOR_TRACE_HEADER_SIZE];
+    bool sdCardAvailable = false;
+    Retcode_T retcode;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    retcode = Storage_IsAvailable(STORAGE_MEDIUM_SD_CARD, &sdCardAvailable);
+    if ((RETCODE_OK == retcode) && (false == sdCardAvailable))
+    {
+        retcode = RETCODE(RETCODE_SEVERITY_WARNING, RETCODE_UNINITIALIZED);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentOffset = 0UL;
+        (void) SensorTrace_WriteHeader(header, sizeof(header));
+        retcode = AgentWrite(header, sizeof(header));
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = SensorComponent_AddReadHook(AgentRecord);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentStatistics.Bytes = AgentOffset;
+        AgentIsRecording = true;
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+const SensorTraceAgent_Statistics_T * SensorTraceAgent_GetStatistics(void)
+{
+    return &AgentStatistics;
+}
+
+/** Refer interface header for description */
+void SensorTraceAgent_PrintReport(void)
+{
+    printf("SensorTraceAgent : %lu reads recorded, %lu failed reads, %lu dropped, %lu chunks, %lu bytes, %lu write errors\r\n",
+            (unsigned long) AgentStatistics.Records, (unsigned long) AgentStatistics.FailedReads, (unsigned long) AgentStatistics.Dropped,
+            (unsigned long) AgentStatistics.Chunks, (unsigned long) AgentStatistics.Bytes, (unsigned long) AgentStatistics.WriteErrors);
+}
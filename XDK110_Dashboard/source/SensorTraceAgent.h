@@ -0,0 +1,85 @@
+/**
+ *  @file
+ *
+ *  @brief Records every sensor read into a SensorTrace file on the SD card.
+ *
+ *  The agent hooks into the sensor component (SensorComponent_AddReadHook), so
+ *  it sees the reads as they happen on the real-time lane: successful ones
+ *  with their values and failed ones with the return code of the driver.
+ *  Records are collected in one of two chunk buffers; a full chunk is written
+ *  on the background lane while the other one fills. A read arriving while
+ *  both chunks wait for the SD card is not recorded and counted as dropped.
+ *
+ *  The file is written from its start at every boot; Tools/SensorTraceReplay
+ *  decodes it and replays it through the sampling and encoding of the
+ *  application on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef SENSORTRACEAGENT_H_
+#define SENSORTRACEAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+
+/* local type and macro definitions */
+
+/** Size of each of the two chunk buffers, one SD card block */
+#define SENSOR_TRACE_AGENT_CHUNK_SIZE       UINT32_C(512)
+
+/**
+ * @brief Agent configuration.
+ */
+struct SensorTraceAgent_Setup_S
+{
+    const char * FileName; /**< SD card file of the trace */
+    uint32_t MaxBytes; /**< Recording stops once the file reaches this size, 0 for no limit */
+};
+typedef struct SensorTraceAgent_Setup_S SensorTraceAgent_Setup_T;
+
+/**
+ * @brief Counters of the agent.
+ */
+struct SensorTraceAgent_Statistics_S
+{
+    uint32_t Records; /**< Reads recorded */
+    uint32_t FailedReads; /**< Recorded reads which returned an error */
+    uint32_t Dropped; /**< Reads lost because both chunks were busy or a chunk could not be queued */
+    uint32_t Chunks; /**< Chunks written */
+    uint32_t Bytes; /**< Size of the file */
+    uint32_t WriteErrors;
+};
+typedef struct SensorTraceAgent_Statistics_S SensorTraceAgent_Statistics_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Prepares the chunk buffers.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorTraceAgent_Setup(const SensorTraceAgent_Setup_T * setup);
+
+/**
+ * @brief Writes the file header and starts recording; requires an enabled SD card storage.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T SensorTraceAgent_Enable(void);
+
+/**
+ * @brief Returns the counters of the agent.
+ */
+const SensorTraceAgent_Statistics_T * SensorTraceAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters of the agent.
+ */
+void SensorTraceAgent_PrintReport(void);
+
+#endif /* SENSORTRACEAGENT_H_ */
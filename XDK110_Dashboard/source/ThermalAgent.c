@@ -0,0 +1,426 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the thermal array streaming.
+ *
+ *  The timer only counts the frame ticks, so a capture the normal lane
+ *  refused or a failed read still advances the frame numbers. The encoder
+ *  and the batches are shared with ThermalAgent_TakeBatch and only touched
+ *  in critical sections; the encoding of a frame is short enough for one.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_THERMAL_AGENT
+
+#include "ThermalAgent.h"
+
+/* system header files */
+#include <stdio.h>
+#include <string.h>
+
+/* additional interface header files */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "semphr.h"
+#include "BSP_ExtensionPort.h"
+#include "BCDS_MCU_I2C.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+
+/* constant definitions ***************************************************** */
+
+#define THERMAL_AGENT_REG_PCTL              UINT8_C(0x00) /**< Power control, 0x00 normal mode */
+#define THERMAL_AGENT_REG_RST               UINT8_C(0x01) /**< Reset, 0x3F initial reset */
+#define THERMAL_AGENT_REG_FPSC              UINT8_C(0x02) /**< Frame rate, 0x00 10 fps, 0x01 1 fps */
+#define THERMAL_AGENT_REG_PIXELS            UINT8_C(0x80) /**< First of the 128 pixel registers */
+
+#define THERMAL_AGENT_PCTL_NORMAL           UINT8_C(0x00)
+#define THERMAL_AGENT_RST_INITIAL           UINT8_C(0x3F)
+#define THERMAL_AGENT_FPSC_10               UINT8_C(0x00)
+#define THERMAL_AGENT_FPSC_1                UINT8_C(0x01)
+
+#define THERMAL_AGENT_STARTUP_MS            UINT32_C(250) /**< Two frames at 10 fps after the reset, and the 50 ms of the mode change */
+
+#define THERMAL_AGENT_I2C_TIMEOUT_MS        UINT32_C(20) /**< Longest transfer, the pixels take 3.5 ms at 400 kHz */
+
+/* local variables ********************************************************** */
+
+static const ThermalAgent_Setup_T * AgentSetup = NULL;
+
+static I2C_T AgentI2c = NULL;
+
+static SemaphoreHandle_t AgentI2cDone = NULL;
+
+static StaticRtos_Semaphore_T AgentI2cDoneStorage;
+
+static volatile bool AgentI2cFailed = false;
+
+static xTimerHandle AgentCaptureTimer = NULL;
+
+static StaticRtos_Timer_T AgentCaptureTimerStorage;
+
+static uint8_t AgentRaw[THERMAL_FRAME_RAW_SIZE]; /**< Pixel registers, only used on the normal lane */
+
+static ThermalFrame_T AgentFrame; /**< Latest frame, only used on the normal lane */
+
+static ThermalFrame_Presence_T AgentPresence; /**< Only used on the normal lane */
+
+static ThermalFrame_Encoder_T AgentEncoder;
+
+static uint8_t AgentBatches[2][THERMAL_AGENT_BATCH_SIZE]; /**< One filling and one uploading */
+
+static uint32_t AgentBatchLengths[2];
+
+static uint8_t AgentActiveBatch = 0U; /**< Index of the batch the captures append to */
+
+static uint16_t AgentFrameNumber = 0U; /**< Frame ticks since the active batch started */
+
+static uint16_t AgentGap = 0U; /**< Frame ticks since the last message */
+
+static bool AgentHasRecord = false; /**< The active batch has a summary record */
+
+static ThermalFrame_Summary_T AgentLastRecord;
+
+static ThermalFrame_Summary_T AgentLatest;
+
+static bool AgentHasLatest = false;
+
+static ThermalAgent_Statistics_T AgentStatistics;
+
+/* local functions ********************************************************** */
+
+static void AgentI2cCallback(I2C_T i2c, struct MCU_I2C_Event_S event)
+{
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+
+    BCDS_UNUSED(i2c);
+
+    if (event.TransferError)
+    {
+        AgentI2cFailed = true;
+    }
+    if (event.TxComplete || event.RxComplete || event.TransferError)
+    {
+        (void) xSemaphoreGiveFromISR(AgentI2cDone, &higherPriorityTaskWoken);
+        portYIELD_FROM_ISR(higherPriorityTaskWoken);
+    }
+}
+
+/**
+ * @brief Reads or writes registers of the sensor and waits for the transfer.
+ */
+static Retcode_T AgentTransfer(bool isRead, uint8_t reg, uint8_t * data, uint32_t length)
+{
+    Retcode_T retcode;
+
+    AgentI2cFailed = false;
+    if (isRead)
+    {
+        retcode = MCU_I2C_ReadRegister(AgentI2c, AgentSetup->I2cAddress, reg, data, length);
+    }
+    else
+    {
+        retcode = MCU_I2C_WriteRegister(AgentI2c, AgentSetup->I2cAddress, reg, data, length);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        if (pdTRUE != xSemaphoreTake(AgentI2cDone, pdMS_TO_TICKS(THERMAL_AGENT_I2C_TIMEOUT_MS)))
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_TIMEOUT);
+        }
+        else if (AgentI2cFailed)
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_FAILURE);
+        }
+    }
+    return retcode;
+}
+
+static Retcode_T AgentWriteRegister(uint8_t reg, uint8_t value)
+{
+    return AgentTransfer(false, reg, &value, 1UL);
+}
+
+/**
+ * @brief Appends the latest frame to the active batch, as a message or a summary record.
+ *
+ * @return false if the batch was full.
+ */
+static bool AgentAppend(const ThermalFrame_Summary_T * summary)
+{
+    uint8_t * batch = &AgentBatches[AgentActiveBatch][AgentBatchLengths[AgentActiveBatch]];
+    uint32_t room = THERMAL_AGENT_BATCH_SIZE - AgentBatchLengths[AgentActiveBatch];
+    uint32_t length = 0UL;
+
+    if (THERMAL_FRAME_MODE_FRAMES == AgentSetup->Mode)
+    {
+        length = ThermalFrame_Encode(&AgentEncoder, &AgentFrame, AgentGap, batch, room);
+    }
+    else if (AgentHasRecord && !ThermalFrame_SummaryChanged(&AgentLastRecord, summary, AgentSetup->Deadband))
+    {
+        return true;
+    }
+    else if (room >= THERMAL_FRAME_SUMMARY_SIZE)
+    {
+        ThermalFrame_WriteSummary(summary, (0U == AgentFrameNumber) ? 0U : (uint16_t) (AgentFrameNumber - 1U), batch);
+        AgentLastRecord = *summary;
+        AgentHasRecord = true;
+        AgentStatistics.Records++;
+        length = THERMAL_FRAME_SUMMARY_SIZE;
+    }
+    if (0UL == length)
+    {
+        return false;
+    }
+    AgentBatchLengths[AgentActiveBatch] += length;
+    AgentGap = 0U;
+    return true;
+}
+
+/**
+ * @brief Reads a frame, summarizes it and appends it to the active batch.
+ */
+static void AgentCapture(void)
+{
+    ThermalFrame_Summary_T summary;
+    bool isAppended;
+
+    if (RETCODE_OK != AgentTransfer(true, THERMAL_AGENT_REG_PIXELS, AgentRaw, THERMAL_FRAME_RAW_SIZE))
+    {
+        AgentStatistics.ReadFailures++;
+        return;
+    }
+    ThermalFrame_FromAmg88xx(AgentRaw, &AgentFrame);
+    ThermalFrame_Detect(&AgentPresence, &AgentFrame, &summary);
+
+    taskENTER_CRITICAL();
+    isAppended = AgentAppend(&summary);
+    AgentLatest = summary;
+    AgentHasLatest = true;
+    taskEXIT_CRITICAL();
+
+    AgentStatistics.Captures++;
+    if (!isAppended)
+    {
+        AgentStatistics.Dropped++;
+    }
+    if (summary.Presence)
+    {
+        AgentStatistics.PresenceFrames++;
+    }
+}
+
+static void AgentCaptureWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    AgentCapture();
+}
+
+static void AgentCaptureTimerCallback(xTimerHandle xTimer)
+{
+    BCDS_UNUSED(xTimer);
+
+    taskENTER_CRITICAL();
+    AgentFrameNumber++;
+    if (AgentGap < UINT16_MAX)
+    {
+        AgentGap++;
+    }
+    taskEXIT_CRITICAL();
+
+    /* The I2C transfer waits, which the timer service task must not */
+    (void) WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_NORMAL, AgentCaptureWork, NULL, 0UL);
+}
+
+/**
+ * @brief Starts a batch with its header; the next frame is a key frame.
+ */
+static void AgentStartBatch(uint8_t index)
+{
+    ThermalFrame_WriteBatchHeader(AgentSetup->Mode, (uint16_t) AgentSetup->FramePeriodMs, AgentBatches[index]);
+    AgentBatchLengths[index] = THERMAL_FRAME_BATCH_HEADER_SIZE;
+    ThermalFrame_ResetEncoder(&AgentEncoder);
+    AgentHasRecord = false;
+    AgentFrameNumber = 0U;
+    AgentGap = 0U;
+}
+
+/**
+ * @brief Prints a pixel value in degC.
+ */
+static void AgentPrintCelsius(const char * label, int16_t value)
+{
+    int32_t centi = (int32_t) value * 25L;
+
+    printf("%s %s%ld.%02ld degC", label, (centi < 0L) ? "-" : "", (long) (((centi < 0L) ? -centi : centi) / 100L),
+            (long) (((centi < 0L) ? -centi : centi) % 100L));
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T ThermalAgent_Setup(const ThermalAgent_Setup_T * setup)
+{
+    if (NULL == setup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((setup->FramePeriodMs < THERMAL_AGENT_MIN_FRAME_PERIOD_MS) || (setup->FramePeriodMs > UINT16_MAX) ||
+            (setup->Mode > THERMAL_FRAME_MODE_SUMMARIES) || !ThermalFrame_InitEncoder(&AgentEncoder, setup->Deadband, setup->KeyInterval) ||
+            !ThermalFrame_InitPresence(&AgentPresence, &setup->Presence))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentI2cDone = StaticRtos_CreateCounting(&AgentI2cDoneStorage, "ThermalI2c", 1UL, 0UL);
+    AgentCaptureTimer = StaticRtos_CreateTimer(&AgentCaptureTimerStorage, "ThermalCapture", pdMS_TO_TICKS(setup->FramePeriodMs), pdTRUE, NULL,
+            AgentCaptureTimerCallback);
+    if ((NULL == AgentI2cDone) || (NULL == AgentCaptureTimer))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    AgentSetup = setup;
+    AgentActiveBatch = 0U;
+    AgentStartBatch(AgentActiveBatch);
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T ThermalAgent_Enable(void)
+{
+    Retcode_T retcode = RETCODE_OK;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    retcode = BSP_ExtensionPort_Connect();
+    if (RETCODE_OK == retcode)
+    {
+        retcode = BSP_ExtensionPort_ConnectI2c();
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = BSP_ExtensionPort_SetI2cConfig(BSP_EXTENSIONPORT_I2C_MODE, BSP_EXTENSIONPORT_I2C_FASTMODE, NULL);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        AgentI2c = BSP_ExtensionPort_GetI2cHandle();
+        retcode = (NULL == AgentI2c) ? RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER) : MCU_I2C_Initialize(AgentI2c, AgentI2cCallback);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = BSP_ExtensionPort_EnableI2c();
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = AgentWriteRegister(THERMAL_AGENT_REG_PCTL, THERMAL_AGENT_PCTL_NORMAL);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = AgentWriteRegister(THERMAL_AGENT_REG_RST, THERMAL_AGENT_RST_INITIAL);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = AgentWriteRegister(THERMAL_AGENT_REG_FPSC, (AgentSetup->FramePeriodMs >= 1000UL) ? THERMAL_AGENT_FPSC_1 : THERMAL_AGENT_FPSC_10);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        vTaskDelay(pdMS_TO_TICKS(THERMAL_AGENT_STARTUP_MS));
+        if (pdPASS != xTimerStart(AgentCaptureTimer, UINT32_MAX))
+        {
+            retcode = RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+        }
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+uint32_t ThermalAgent_TakeBatch(const uint8_t ** batch)
+{
+    uint32_t length = 0UL;
+
+    if (NULL == AgentSetup)
+    {
+        return 0UL;
+    }
+    taskENTER_CRITICAL();
+    if (AgentBatchLengths[AgentActiveBatch] > THERMAL_FRAME_BATCH_HEADER_SIZE)
+    {
+        *batch = AgentBatches[AgentActiveBatch];
+        length = AgentBatchLengths[AgentActiveBatch];
+        AgentActiveBatch = (uint8_t) (1U - AgentActiveBatch);
+        AgentStartBatch(AgentActiveBatch);
+        AgentStatistics.Batches++;
+    }
+    taskEXIT_CRITICAL();
+
+    return length;
+}
+
+/** Refer interface header for description */
+bool ThermalAgent_GetSummary(ThermalFrame_Summary_T * summary)
+{
+    bool hasLatest;
+
+    taskENTER_CRITICAL();
+    hasLatest = AgentHasLatest;
+    *summary = AgentLatest;
+    taskEXIT_CRITICAL();
+
+    return hasLatest;
+}
+
+/** Refer interface header for description */
+const ThermalAgent_Statistics_T * ThermalAgent_GetStatistics(void)
+{
+    return &AgentStatistics;
+}
+
+/** Refer interface header for description */
+void ThermalAgent_PrintReport(void)
+{
+    ThermalFrame_Statistics_T encoder;
+    ThermalFrame_Summary_T summary;
+    uint32_t hundredths;
+
+    if (NULL == AgentSetup)
+    {
+        return;
+    }
+    taskENTER_CRITICAL();
+    encoder = AgentEncoder.Statistics;
+    taskEXIT_CRITICAL();
+
+    printf("ThermalAgent : %lu frames, %lu read failures, %lu dropped, %lu batches, presence in %lu frames \r\n",
+            (unsigned long) AgentStatistics.Captures, (unsigned long) AgentStatistics.ReadFailures, (unsigned long) AgentStatistics.Dropped,
+            (unsigned long) AgentStatistics.Batches, (unsigned long) AgentStatistics.PresenceFrames);
+    if ((THERMAL_FRAME_MODE_FRAMES == AgentSetup->Mode) && (0UL != encoder.Bytes))
+    {
+        hundredths = (uint32_t) (((uint64_t) encoder.Frames * THERMAL_FRAME_RAW_SIZE * 100ULL) / encoder.Bytes);
+        printf("ThermalAgent :   %lu key, %lu delta with %lu pixels, %lu unchanged, %lu bytes, %lu.%02lu times smaller than raw \r\n",
+                (unsigned long) encoder.KeyFrames, (unsigned long) encoder.DeltaFrames, (unsigned long) encoder.ChangedPixels,
+                (unsigned long) encoder.UnchangedFrames, (unsigned long) encoder.Bytes, (unsigned long) (hundredths / 100UL),
+                (unsigned long) (hundredths % 100UL));
+    }
+    else if (THERMAL_FRAME_MODE_SUMMARIES == AgentSetup->Mode)
+    {
+        printf("ThermalAgent :   %lu summary records \r\n", (unsigned long) AgentStatistics.Records);
+    }
+    if (ThermalAgent_GetSummary(&summary))
+    {
+        AgentPrintCelsius("ThermalAgent :   background", summary.Background);
+        AgentPrintCelsius(", hotspot", summary.Hotspot);
+        printf(" at row %u column %u, %u active pixels%s \r\n", (unsigned int) (summary.HotspotIndex / THERMAL_FRAME_WIDTH),
+                (unsigned int) (summary.HotspotIndex % THERMAL_FRAME_WIDTH), (unsigned int) summary.ActivePixels,
+                summary.Presence ? ", presence" : "");
+    }
+}
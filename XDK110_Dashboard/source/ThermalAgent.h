@@ -0,0 +1,110 @@
+/**
+ *  @file
+ *
+ *  @brief Thermal array streaming: captures Grid-EYE frames and batches them for upload.
+ *
+ *  The agent reads an AMG88xx on the I2C bus of the extension port every
+ *  FramePeriodMs, up to the 10 frames per second of the sensor, on the normal
+ *  lane; a capture holds the bus for about 3.5 ms at 400 kHz. Every frame
+ *  runs through the presence detector of ThermalFrame and, depending on
+ *  Mode, is delta encoded or summarized into the active of two batches of
+ *  THERMAL_AGENT_BATCH_SIZE bytes. ThermalAgent_TakeBatch hands the filled
+ *  batch to the uploader and starts the other one with a key frame, so every
+ *  batch decodes on its own. A frame which finds the batch full is dropped
+ *  and counted, the next message carries the gap.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef THERMALAGENT_H_
+#define THERMALAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+#include "ThermalFrame.h"
+
+/* local type and macro definitions */
+
+/** Bytes of a batch, a POST body */
+#define THERMAL_AGENT_BATCH_SIZE            UINT32_C(3072)
+
+/** Shortest frame period, the frame rate of the sensor */
+#define THERMAL_AGENT_MIN_FRAME_PERIOD_MS   UINT32_C(100)
+
+/**
+ * @brief Agent configuration.
+ */
+struct ThermalAgent_Setup_S
+{
+    uint8_t I2cAddress; /**< 7 bit address, 0x68 or 0x69 by the AD_SELECT pin */
+    uint32_t FramePeriodMs; /**< Time between two captures, from THERMAL_AGENT_MIN_FRAME_PERIOD_MS to 65535 */
+    ThermalFrame_Mode_T Mode; /**< Changed pixels or presence summaries */
+    uint8_t Deadband; /**< Largest change of a pixel or the hotspot which is not sent, in 0.25 degC */
+    uint16_t KeyInterval; /**< Frames between two key frames, 0 for the first one of a batch only */
+    ThermalFrame_PresenceSetup_T Presence;
+};
+typedef struct ThermalAgent_Setup_S ThermalAgent_Setup_T;
+
+/**
+ * @brief Counters of the agent.
+ */
+struct ThermalAgent_Statistics_S
+{
+    uint32_t Captures; /**< Frames read */
+    uint32_t ReadFailures;
+    uint32_t Dropped; /**< Frames which found the batch full */
+    uint32_t Records; /**< Summary records written */
+    uint32_t Batches; /**< Batches handed over */
+    uint32_t PresenceFrames; /**< Frames with a presence */
+};
+typedef struct ThermalAgent_Statistics_S ThermalAgent_Statistics_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Checks the configuration and creates the capture timer.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T ThermalAgent_Setup(const ThermalAgent_Setup_T * setup);
+
+/**
+ * @brief Connects the extension port I2C, resets the sensor to 10 frames per
+ * second (1 for a FramePeriodMs from 1 s on) and starts the captures.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T ThermalAgent_Enable(void);
+
+/**
+ * @brief Hands the filled batch over and starts a fresh one.
+ *
+ * @param[out] batch
+ * The batch, valid until the next call
+ *
+ * @return Bytes of the batch, 0 if it holds no frame.
+ */
+uint32_t ThermalAgent_TakeBatch(const uint8_t ** batch);
+
+/**
+ * @brief Returns the summary of the latest frame.
+ *
+ * @return false before the first frame.
+ */
+bool ThermalAgent_GetSummary(ThermalFrame_Summary_T * summary);
+
+/**
+ * @brief Returns the counters of the agent.
+ */
+const ThermalAgent_Statistics_T * ThermalAgent_GetStatistics(void);
+
+/**
+ * @brief Prints the counters, the message types and the compression of the frames.
+ */
+void ThermalAgent_PrintReport(void);
+
+#endif /* THERMALAGENT_H_ */
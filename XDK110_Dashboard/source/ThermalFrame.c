@@ -0,0 +1,484 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the thermal frame encoding and the presence detector.
+ *
+ *  The encoder builds the key frame on the stack first and the delta frame
+ *  only once its size, counted beforehand, beats the key frame. The
+ *  background is kept in 1/256 LSB, so a slow average still moves.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "ThermalFrame.h"
+
+/* system header files */
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define THERMAL_FRAME_GAP_ESCAPE            UINT32_C(63) /**< Gap code of bits 2-7 followed by a varint */
+
+#define THERMAL_FRAME_VARINT_MAX_BYTES      UINT8_C(3) /**< Longest varint, 21 bits */
+
+#define THERMAL_FRAME_BACKGROUND_SHIFT      UINT8_C(8) /**< Background fraction bits */
+
+#define THERMAL_FRAME_ACTIVE_SLOWDOWN       UINT8_C(4) /**< Active pixels adapt 2^4 times slower */
+
+/* local functions ********************************************************** */
+
+static uint32_t ThermalFrameZigzag(int32_t value)
+{
+    return (value >= 0) ? ((uint32_t) value * 2UL) : (((uint32_t) -value * 2UL) - 1UL);
+}
+
+static int32_t ThermalFrameUnzigzag(uint32_t value)
+{
+    return (0UL != (value & 1UL)) ? -(int32_t) ((value + 1UL) / 2UL) : (int32_t) (value / 2UL);
+}
+
+static uint32_t ThermalFrameVarintLength(uint32_t value)
+{
+    uint32_t length = 1UL;
+
+    while (value >= 0x80UL)
+    {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+static uint32_t ThermalFrameWriteVarint(uint8_t * buffer, uint32_t value)
+{
+    uint32_t length = 0UL;
+
+    while (value >= 0x80UL)
+    {
+        buffer[length++] = (uint8_t) ((value & 0x7FUL) | 0x80UL);
+        value >>= 7;
+    }
+    buffer[length++] = (uint8_t) value;
+    return length;
+}
+
+/**
+ * @return Bytes read, 0 for a truncated or too long varint.
+ */
+static uint32_t ThermalFrameReadVarint(const uint8_t * data, uint32_t length, uint32_t * value)
+{
+    uint32_t index;
+
+    *value = 0UL;
+    for (index = 0UL; (index < length) && (index < THERMAL_FRAME_VARINT_MAX_BYTES); index++)
+    {
+        *value |= (uint32_t) (data[index] & 0x7FU) << (7UL * index);
+        if (0U == (data[index] & 0x80U))
+        {
+            return index + 1UL;
+        }
+    }
+    return 0UL;
+}
+
+/**
+ * @brief Returns the neighbour a key frame predicts a pixel from.
+ */
+static int16_t ThermalFramePrediction(const ThermalFrame_T * frame, uint8_t index)
+{
+    if (0U == index)
+    {
+        return 0;
+    }
+    return frame->Pixels[(0U == (index % THERMAL_FRAME_WIDTH)) ? (uint8_t) (index - THERMAL_FRAME_WIDTH) : (uint8_t) (index - 1U)];
+}
+
+static uint32_t ThermalFrameWriteHeader(ThermalFrame_Type_T type, uint16_t gap, uint8_t * buffer)
+{
+    uint32_t code = (0U == gap) ? 0UL : ((uint32_t) gap - 1UL);
+
+    if (code < THERMAL_FRAME_GAP_ESCAPE)
+    {
+        buffer[0] = (uint8_t) ((uint32_t) type | (code << 2));
+        return 1UL;
+    }
+    buffer[0] = (uint8_t) ((uint32_t) type | (THERMAL_FRAME_GAP_ESCAPE << 2));
+    return 1UL + ThermalFrameWriteVarint(&buffer[1], code - THERMAL_FRAME_GAP_ESCAPE);
+}
+
+static int16_t ThermalFrameClip(int16_t value)
+{
+    if (value < THERMAL_FRAME_PIXEL_MIN)
+    {
+        return THERMAL_FRAME_PIXEL_MIN;
+    }
+    return (value > THERMAL_FRAME_PIXEL_MAX) ? THERMAL_FRAME_PIXEL_MAX : value;
+}
+
+static void ThermalFrameWriteInt16(uint8_t * buffer, int16_t value)
+{
+    buffer[0] = (uint8_t) ((uint16_t) value & 0xFFU);
+    buffer[1] = (uint8_t) ((uint16_t) value >> 8);
+}
+
+static int16_t ThermalFrameReadInt16(const uint8_t * buffer)
+{
+    return (int16_t) (uint16_t) ((uint16_t) buffer[0] | ((uint16_t) buffer[1] << 8));
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+void ThermalFrame_FromAmg88xx(const uint8_t * raw, ThermalFrame_T * frame)
+{
+    uint8_t index;
+    uint16_t value;
+
+    for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+    {
+        value = (uint16_t) ((uint16_t) raw[2U * index] | ((uint16_t) (raw[(2U * index) + 1U] & 0x0FU) << 8));
+        frame->Pixels[index] = (0U != (value & 0x0800U)) ? (int16_t) ((int32_t) value - 4096L) : (int16_t) value;
+    }
+}
+
+/** Refer interface header for description */
+bool ThermalFrame_InitEncoder(ThermalFrame_Encoder_T * encoder, uint8_t deadband, uint16_t keyInterval)
+{
+    if (deadband > 127U)
+    {
+        return false;
+    }
+    memset(encoder, 0, sizeof(*encoder));
+    encoder->Deadband = deadband;
+    encoder->KeyInterval = keyInterval;
+    return true;
+}
+
+/** Refer interface header for description */
+void ThermalFrame_ResetEncoder(ThermalFrame_Encoder_T * encoder)
+{
+    encoder->HasReference = false;
+    encoder->SinceKey = 0U;
+}
+
+/** Refer interface header for description */
+uint32_t ThermalFrame_Encode(ThermalFrame_Encoder_T * encoder, const ThermalFrame_T * frame, uint16_t gap, uint8_t * buffer, uint32_t size)
+{
+    ThermalFrame_T clipped;
+    uint8_t key[2UL * THERMAL_FRAME_PIXELS];
+    uint8_t columns[THERMAL_FRAME_WIDTH] = { 0U };
+    uint8_t rows = 0U;
+    uint32_t keyLength = 0UL;
+    uint32_t deltaLength = 0UL;
+    uint32_t changed = 0UL;
+    uint32_t length;
+    int32_t delta;
+    uint8_t index;
+    uint8_t row;
+
+    if (size < THERMAL_FRAME_MAX_MESSAGE)
+    {
+        return 0UL;
+    }
+    for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+    {
+        clipped.Pixels[index] = ThermalFrameClip(frame->Pixels[index]);
+    }
+    for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+    {
+        keyLength += ThermalFrameWriteVarint(&key[keyLength],
+                ThermalFrameZigzag((int32_t) clipped.Pixels[index] - (int32_t) ThermalFramePrediction(&clipped, index)));
+    }
+    if (encoder->HasReference)
+    {
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            delta = (int32_t) clipped.Pixels[index] - (int32_t) encoder->Reference.Pixels[index];
+            if ((delta > (int32_t) encoder->Deadband) || (delta < -(int32_t) encoder->Deadband))
+            {
+                columns[index / THERMAL_FRAME_WIDTH] |= (uint8_t) (1U << (index % THERMAL_FRAME_WIDTH));
+                deltaLength += ThermalFrameVarintLength(ThermalFrameZigzag(delta));
+                changed++;
+            }
+        }
+        for (row = 0U; row < THERMAL_FRAME_WIDTH; row++)
+        {
+            if (0U != columns[row])
+            {
+                rows |= (uint8_t) (1U << row);
+                deltaLength++;
+            }
+        }
+        deltaLength++;
+    }
+
+    encoder->Statistics.Frames++;
+    if (encoder->SinceKey < UINT16_MAX)
+    {
+        encoder->SinceKey++;
+    }
+    if (!encoder->HasReference || ((0U != encoder->KeyInterval) && (encoder->SinceKey >= encoder->KeyInterval)) || (deltaLength >= keyLength))
+    {
+        length = ThermalFrameWriteHeader(THERMAL_FRAME_KEY, gap, buffer);
+        memcpy(&buffer[length], key, keyLength);
+        length += keyLength;
+        encoder->Reference = clipped;
+        encoder->HasReference = true;
+        encoder->SinceKey = 0U;
+        encoder->Statistics.KeyFrames++;
+    }
+    else if (0UL == changed)
+    {
+        length = ThermalFrameWriteHeader(THERMAL_FRAME_UNCHANGED, gap, buffer);
+        encoder->Statistics.UnchangedFrames++;
+    }
+    else
+    {
+        length = ThermalFrameWriteHeader(THERMAL_FRAME_DELTA, gap, buffer);
+        buffer[length++] = rows;
+        for (row = 0U; row < THERMAL_FRAME_WIDTH; row++)
+        {
+            if (0U != columns[row])
+            {
+                buffer[length++] = columns[row];
+            }
+        }
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            if (0U != (columns[index / THERMAL_FRAME_WIDTH] & (1U << (index % THERMAL_FRAME_WIDTH))))
+            {
+                delta = (int32_t) clipped.Pixels[index] - (int32_t) encoder->Reference.Pixels[index];
+                length += ThermalFrameWriteVarint(&buffer[length], ThermalFrameZigzag(delta));
+                encoder->Reference.Pixels[index] = clipped.Pixels[index];
+            }
+        }
+        encoder->Statistics.DeltaFrames++;
+        encoder->Statistics.ChangedPixels += changed;
+    }
+    encoder->Statistics.Bytes += length;
+    return length;
+}
+
+/** Refer interface header for description */
+void ThermalFrame_InitDecoder(ThermalFrame_Decoder_T * decoder)
+{
+    memset(decoder, 0, sizeof(*decoder));
+}
+
+/** Refer interface header for description */
+uint32_t ThermalFrame_Decode(ThermalFrame_Decoder_T * decoder, const uint8_t * data, uint32_t length, ThermalFrame_T * frame, uint32_t * gap)
+{
+    ThermalFrame_T decoded;
+    uint8_t columns[THERMAL_FRAME_WIDTH] = { 0U };
+    uint32_t offset = 1UL;
+    uint32_t code;
+    uint32_t value;
+    uint32_t read;
+    int32_t pixel;
+    uint8_t type;
+    uint8_t rows;
+    uint8_t index;
+    uint8_t row;
+
+    if (0UL == length)
+    {
+        return 0UL;
+    }
+    type = (uint8_t) (data[0] & 0x03U);
+    code = (uint32_t) data[0] >> 2;
+    if (THERMAL_FRAME_GAP_ESCAPE == code)
+    {
+        read = ThermalFrameReadVarint(&data[offset], length - offset, &value);
+        if ((0UL == read) || (value > (UINT16_MAX - THERMAL_FRAME_GAP_ESCAPE - 1UL)))
+        {
+            return 0UL;
+        }
+        code += value;
+        offset += read;
+    }
+    if ((THERMAL_FRAME_KEY != type) && !decoder->HasReference)
+    {
+        return 0UL;
+    }
+
+    decoded = decoder->Reference;
+    switch (type)
+    {
+    case THERMAL_FRAME_KEY:
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            read = ThermalFrameReadVarint(&data[offset], length - offset, &value);
+            pixel = (int32_t) ThermalFramePrediction(&decoded, index) + ThermalFrameUnzigzag(value);
+            if ((0UL == read) || (pixel < THERMAL_FRAME_PIXEL_MIN) || (pixel > THERMAL_FRAME_PIXEL_MAX))
+            {
+                return 0UL;
+            }
+            decoded.Pixels[index] = (int16_t) pixel;
+            offset += read;
+        }
+        break;
+    case THERMAL_FRAME_DELTA:
+        if (offset >= length)
+        {
+            return 0UL;
+        }
+        rows = data[offset++];
+        for (row = 0U; row < THERMAL_FRAME_WIDTH; row++)
+        {
+            if (0U != (rows & (1U << row)))
+            {
+                if (offset >= length)
+                {
+                    return 0UL;
+                }
+                columns[row] = data[offset++];
+            }
+        }
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            if (0U != (columns[index / THERMAL_FRAME_WIDTH] & (1U << (index % THERMAL_FRAME_WIDTH))))
+            {
+                read = ThermalFrameReadVarint(&data[offset], length - offset, &value);
+                pixel = (int32_t) decoded.Pixels[index] + ThermalFrameUnzigzag(value);
+                if ((0UL == read) || (pixel < THERMAL_FRAME_PIXEL_MIN) || (pixel > THERMAL_FRAME_PIXEL_MAX))
+                {
+                    return 0UL;
+                }
+                decoded.Pixels[index] = (int16_t) pixel;
+                offset += read;
+            }
+        }
+        break;
+    case THERMAL_FRAME_UNCHANGED:
+        break;
+    default:
+        return 0UL;
+    }
+
+    decoder->Reference = decoded;
+    decoder->HasReference = true;
+    *frame = decoded;
+    if (NULL != gap)
+    {
+        *gap = code + 1UL;
+    }
+    return offset;
+}
+
+/** Refer interface header for description */
+bool ThermalFrame_InitPresence(ThermalFrame_Presence_T * presence, const ThermalFrame_PresenceSetup_T * setup)
+{
+    if ((NULL == setup) || (0U == setup->MinPixels) || (setup->MinPixels > THERMAL_FRAME_PIXELS) || (0U == setup->AdaptShift) ||
+            (setup->AdaptShift > 12U))
+    {
+        return false;
+    }
+    memset(presence, 0, sizeof(*presence));
+    presence->Setup = *setup;
+    return true;
+}
+
+/** Refer interface header for description */
+void ThermalFrame_Detect(ThermalFrame_Presence_T * presence, const ThermalFrame_T * frame, ThermalFrame_Summary_T * summary)
+{
+    int32_t threshold = (int32_t) presence->Setup.Threshold << THERMAL_FRAME_BACKGROUND_SHIFT;
+    int32_t sum = 0L;
+    int32_t scaled;
+    int32_t rise;
+    uint8_t index;
+    uint8_t shift;
+
+    if (!presence->HasBackground)
+    {
+        for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+        {
+            presence->Background[index] = (int32_t) frame->Pixels[index] << THERMAL_FRAME_BACKGROUND_SHIFT;
+        }
+        presence->HasBackground = true;
+    }
+
+    memset(summary, 0, sizeof(*summary));
+    summary->Hotspot = frame->Pixels[0];
+    for (index = 0U; index < THERMAL_FRAME_PIXELS; index++)
+    {
+        if (frame->Pixels[index] > summary->Hotspot)
+        {
+            summary->Hotspot = frame->Pixels[index];
+            summary->HotspotIndex = index;
+        }
+        scaled = (int32_t) frame->Pixels[index] << THERMAL_FRAME_BACKGROUND_SHIFT;
+        rise = scaled - presence->Background[index];
+        shift = presence->Setup.AdaptShift;
+        if (rise > threshold)
+        {
+            summary->ActivePixels++;
+            shift += THERMAL_FRAME_ACTIVE_SLOWDOWN;
+        }
+        presence->Background[index] += rise / ((int32_t) 1 << shift);
+        sum += presence->Background[index];
+    }
+    summary->Presence = (summary->ActivePixels >= presence->Setup.MinPixels);
+    summary->Background = (int16_t) ((sum / (int32_t) THERMAL_FRAME_PIXELS) / ((int32_t) 1 << THERMAL_FRAME_BACKGROUND_SHIFT));
+}
+
+/** Refer interface header for description */
+bool ThermalFrame_SummaryChanged(const ThermalFrame_Summary_T * previous, const ThermalFrame_Summary_T * summary, uint8_t deadband)
+{
+    int32_t hotspot = (int32_t) summary->Hotspot - (int32_t) previous->Hotspot;
+    int32_t background = (int32_t) summary->Background - (int32_t) previous->Background;
+
+    if ((previous->Presence != summary->Presence) || (background > (int32_t) deadband) || (background < -(int32_t) deadband))
+    {
+        return true;
+    }
+    /* Without a presence the hotspot is the warmest spot of the room, which the noise moves around */
+    return summary->Presence && ((previous->HotspotIndex != summary->HotspotIndex) || (hotspot > (int32_t) deadband) || (hotspot < -(int32_t) deadband));
+}
+
+/** Refer interface header for description */
+void ThermalFrame_WriteSummary(const ThermalFrame_Summary_T * summary, uint16_t frameNumber, uint8_t * buffer)
+{
+    buffer[0] = (uint8_t) (frameNumber & 0xFFU);
+    buffer[1] = (uint8_t) (frameNumber >> 8);
+    buffer[2] = (uint8_t) ((summary->Presence ? 0x80U : 0x00U) | (summary->ActivePixels & 0x7FU));
+    buffer[3] = summary->HotspotIndex;
+    ThermalFrameWriteInt16(&buffer[4], summary->Hotspot);
+    ThermalFrameWriteInt16(&buffer[6], summary->Background);
+}
+
+/** Refer interface header for description */
+uint16_t ThermalFrame_ReadSummary(const uint8_t * buffer, ThermalFrame_Summary_T * summary)
+{
+    summary->Presence = (0U != (buffer[2] & 0x80U));
+    summary->ActivePixels = (uint8_t) (buffer[2] & 0x7FU);
+    summary->HotspotIndex = buffer[3];
+    summary->Hotspot = ThermalFrameReadInt16(&buffer[4]);
+    summary->Background = ThermalFrameReadInt16(&buffer[6]);
+    return (uint16_t) ((uint16_t) buffer[0] | ((uint16_t) buffer[1] << 8));
+}
+
+/** Refer interface header for description */
+void ThermalFrame_WriteBatchHeader(ThermalFrame_Mode_T mode, uint16_t framePeriodMs, uint8_t * buffer)
+{
+    buffer[0] = (uint8_t) 'T';
+    buffer[1] = (uint8_t) 'F';
+    buffer[2] = THERMAL_FRAME_VERSION;
+    buffer[3] = (uint8_t) mode;
+    buffer[4] = (uint8_t) (framePeriodMs & 0xFFU);
+    buffer[5] = (uint8_t) (framePeriodMs >> 8);
+}
+
+/** Refer interface header for description */
+bool ThermalFrame_ReadBatchHeader(const uint8_t * buffer, uint32_t length, ThermalFrame_Mode_T * mode, uint16_t * framePeriodMs)
+{
+    if ((length < THERMAL_FRAME_BATCH_HEADER_SIZE) || ((uint8_t) 'T' != buffer[0]) || ((uint8_t) 'F' != buffer[1]) ||
+            (THERMAL_FRAME_VERSION != buffer[2]) || (buffer[3] > (uint8_t) THERMAL_FRAME_MODE_SUMMARIES))
+    {
+        return false;
+    }
+    *mode = (ThermalFrame_Mode_T) buffer[3];
+    *framePeriodMs = (uint16_t) ((uint16_t) buffer[4] | ((uint16_t) buffer[5] << 8));
+    return true;
+}
@@ -0,0 +1,283 @@
+/**
+ *  @file
+ *
+ *  @brief Thermal array frames: delta encoding and presence summaries.
+ *
+ *  A frame holds the 8x8 pixels of a Grid-EYE (AMG88xx) in its own unit,
+ *  0.25 degC per LSB, row by row. Consecutive frames of a room barely differ,
+ *  so the encoder sends a key frame now and then and only the changed pixels
+ *  in between.
+ *
+ *  Every frame becomes one message:
+ *
+ *  | Byte | Content |
+ *  |------|---------|
+ *  | 0 | Bits 0-1 type (THERMAL_FRAME_KEY, _DELTA, _UNCHANGED), bits 2-7 frames since the previous message minus 1, 63 for more |
+ *  | 1.. | If bits 2-7 are 63: varint of the frames since the previous message minus 64 |
+ *  | .. | Key frame: 64 zigzag varints, pixel 0, then every pixel minus its left neighbour, or the one above in column 0 |
+ *  | .. | Delta frame: bit n of a row byte for a changed row n, a column byte for every such row, then a zigzag varint of the change of every changed pixel |
+ *
+ *  A pixel counts as changed once it differs by more than Deadband from the
+ *  frame the decoder holds, so the decoded pixels are never further than
+ *  Deadband off and a Deadband of 0 is lossless. A delta frame is only sent
+ *  while it is shorter than the key frame. A frame of the sensor noise alone
+ *  is an unchanged message of a single byte.
+ *
+ *  The presence detector follows the background of every pixel with an
+ *  exponential average. Pixels more than Threshold above it are active,
+ *  MinPixels of them are a presence; active pixels adapt 16 times slower, so
+ *  a person standing still fades out in minutes, not seconds. Its summary of
+ *  a frame is a record of THERMAL_FRAME_SUMMARY_SIZE bytes:
+ *
+ *  | Byte | Content |
+ *  |------|---------|
+ *  | 0-1 | Frame number within the batch, little endian |
+ *  | 2 | Bit 7 presence, bits 0-6 active pixels |
+ *  | 3 | Index of the warmest pixel |
+ *  | 4-5 | Warmest pixel, little endian |
+ *  | 6-7 | Mean of the background, little endian |
+ *
+ *  A batch of messages or records starts with a header of
+ *  THERMAL_FRAME_BATCH_HEADER_SIZE bytes: 'T', 'F', the version 1, the mode
+ *  and the frame period in ms, little endian.
+ *
+ *  The module is platform independent; ThermalAgent runs it on the XDK,
+ *  Tools/ThermalReplay on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef THERMALFRAME_H_
+#define THERMALFRAME_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Pixels of a row and of a column */
+#define THERMAL_FRAME_WIDTH                 UINT8_C(8)
+
+/** Pixels of a frame */
+#define THERMAL_FRAME_PIXELS                UINT8_C(64)
+
+/** Pixel range of the 12 bit sensor output */
+#define THERMAL_FRAME_PIXEL_MIN             INT16_C(-2048)
+#define THERMAL_FRAME_PIXEL_MAX             INT16_C(2047)
+
+/** Bytes of the pixel registers of the AMG88xx */
+#define THERMAL_FRAME_RAW_SIZE              UINT32_C(128)
+
+/** Longest message: type, a gap of 3 bytes and 64 pixels of 2 bytes */
+#define THERMAL_FRAME_MAX_MESSAGE           UINT32_C(132)
+
+/** Bytes of a summary record */
+#define THERMAL_FRAME_SUMMARY_SIZE          UINT32_C(8)
+
+/** Bytes of a batch header */
+#define THERMAL_FRAME_BATCH_HEADER_SIZE     UINT32_C(6)
+
+/** Version of the encoding in the batch header */
+#define THERMAL_FRAME_VERSION               UINT8_C(1)
+
+/**
+ * @brief Message types.
+ */
+enum ThermalFrame_Type_E
+{
+    THERMAL_FRAME_KEY = 0,
+    THERMAL_FRAME_DELTA,
+    THERMAL_FRAME_UNCHANGED,
+};
+typedef enum ThermalFrame_Type_E ThermalFrame_Type_T;
+
+/**
+ * @brief Content of a batch.
+ */
+enum ThermalFrame_Mode_E
+{
+    THERMAL_FRAME_MODE_FRAMES = 0, /**< A message per frame */
+    THERMAL_FRAME_MODE_SUMMARIES, /**< A summary record per frame whose summary changed */
+};
+typedef enum ThermalFrame_Mode_E ThermalFrame_Mode_T;
+
+/**
+ * @brief A frame, 0.25 degC per LSB, row by row.
+ */
+struct ThermalFrame_S
+{
+    int16_t Pixels[THERMAL_FRAME_PIXELS];
+};
+typedef struct ThermalFrame_S ThermalFrame_T;
+
+/**
+ * @brief Counters of an encoder.
+ */
+struct ThermalFrame_Statistics_S
+{
+    uint32_t Frames;
+    uint32_t KeyFrames;
+    uint32_t DeltaFrames;
+    uint32_t UnchangedFrames;
+    uint32_t ChangedPixels; /**< Pixels of the delta frames */
+    uint32_t Bytes; /**< Bytes of all messages */
+};
+typedef struct ThermalFrame_Statistics_S ThermalFrame_Statistics_T;
+
+/**
+ * @brief Encoder state.
+ */
+struct ThermalFrame_Encoder_S
+{
+    uint8_t Deadband; /**< Largest change of a pixel which is not sent */
+    uint16_t KeyInterval; /**< Frames between two key frames, 0 for only the first one */
+    uint16_t SinceKey; /**< Frames since the last key frame, not counting it */
+    bool HasReference;
+    ThermalFrame_T Reference; /**< Frame the decoder holds */
+    ThermalFrame_Statistics_T Statistics;
+};
+typedef struct ThermalFrame_Encoder_S ThermalFrame_Encoder_T;
+
+/**
+ * @brief Decoder state.
+ */
+struct ThermalFrame_Decoder_S
+{
+    bool HasReference;
+    ThermalFrame_T Reference; /**< Last decoded frame */
+};
+typedef struct ThermalFrame_Decoder_S ThermalFrame_Decoder_T;
+
+/**
+ * @brief Presence detector configuration.
+ */
+struct ThermalFrame_PresenceSetup_S
+{
+    uint8_t Threshold; /**< Rise above the background of an active pixel */
+    uint8_t MinPixels; /**< Active pixels of a presence, at least 1 */
+    uint8_t AdaptShift; /**< Weight of a frame in the background is 1 / 2^AdaptShift, 1 to 12 */
+};
+typedef struct ThermalFrame_PresenceSetup_S ThermalFrame_PresenceSetup_T;
+
+/**
+ * @brief Presence detector state.
+ */
+struct ThermalFrame_Presence_S
+{
+    ThermalFrame_PresenceSetup_T Setup;
+    bool HasBackground;
+    int32_t Background[THERMAL_FRAME_PIXELS]; /**< Pixels times 256 */
+};
+typedef struct ThermalFrame_Presence_S ThermalFrame_Presence_T;
+
+/**
+ * @brief Summary of a frame.
+ */
+struct ThermalFrame_Summary_S
+{
+    bool Presence;
+    uint8_t ActivePixels;
+    uint8_t HotspotIndex; /**< Warmest pixel, row times 8 plus column */
+    int16_t Hotspot; /**< Its value */
+    int16_t Background; /**< Mean of the background */
+};
+typedef struct ThermalFrame_Summary_S ThermalFrame_Summary_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Converts the pixel registers of an AMG88xx, 12 bit two's complement, little endian.
+ */
+void ThermalFrame_FromAmg88xx(const uint8_t * raw, ThermalFrame_T * frame);
+
+/**
+ * @brief Starts an encoder; its first frame is a key frame.
+ *
+ * @return false for a deadband above 127.
+ */
+bool ThermalFrame_InitEncoder(ThermalFrame_Encoder_T * encoder, uint8_t deadband, uint16_t keyInterval);
+
+/**
+ * @brief Makes the next frame a key frame, e.g. for the first one of a batch. The counters are kept.
+ */
+void ThermalFrame_ResetEncoder(ThermalFrame_Encoder_T * encoder);
+
+/**
+ * @brief Encodes a frame into a message.
+ *
+ * Pixels outside THERMAL_FRAME_PIXEL_MIN to THERMAL_FRAME_PIXEL_MAX are clipped.
+ *
+ * @param[in] gap
+ * Frames since the previously encoded one, 1 for the next one
+ *
+ * @param[in] size
+ * Room in buffer; below THERMAL_FRAME_MAX_MESSAGE nothing is encoded and the encoder is left alone
+ *
+ * @return Bytes of the message, 0 if nothing was encoded.
+ */
+uint32_t ThermalFrame_Encode(ThermalFrame_Encoder_T * encoder, const ThermalFrame_T * frame, uint16_t gap, uint8_t * buffer, uint32_t size);
+
+/**
+ * @brief Starts a decoder; it needs a key frame first.
+ */
+void ThermalFrame_InitDecoder(ThermalFrame_Decoder_T * decoder);
+
+/**
+ * @brief Decodes the message at the start of data.
+ *
+ * @param[out] frame
+ * The decoded frame
+ *
+ * @param[out] gap
+ * Frames since the previous message, or NULL
+ *
+ * @return Bytes of the message, 0 for a malformed one or a delta without a key frame before.
+ */
+uint32_t ThermalFrame_Decode(ThermalFrame_Decoder_T * decoder, const uint8_t * data, uint32_t length, ThermalFrame_T * frame, uint32_t * gap);
+
+/**
+ * @brief Starts a presence detector; the first frame becomes its background.
+ *
+ * @return false for an invalid setup.
+ */
+bool ThermalFrame_InitPresence(ThermalFrame_Presence_T * presence, const ThermalFrame_PresenceSetup_T * setup);
+
+/**
+ * @brief Summarizes a frame against the background and adapts the background.
+ */
+void ThermalFrame_Detect(ThermalFrame_Presence_T * presence, const ThermalFrame_T * frame, ThermalFrame_Summary_T * summary);
+
+/**
+ * @brief Tells whether a summary is worth a record after the previous one:
+ * the presence changed, the background moved by more than deadband or,
+ * during a presence, the hotspot moved to another pixel or by more than
+ * deadband.
+ */
+bool ThermalFrame_SummaryChanged(const ThermalFrame_Summary_T * previous, const ThermalFrame_Summary_T * summary, uint8_t deadband);
+
+/**
+ * @brief Writes the THERMAL_FRAME_SUMMARY_SIZE bytes of a summary record.
+ */
+void ThermalFrame_WriteSummary(const ThermalFrame_Summary_T * summary, uint16_t frameNumber, uint8_t * buffer);
+
+/**
+ * @brief Reads a summary record.
+ *
+ * @return The frame number within the batch.
+ */
+uint16_t ThermalFrame_ReadSummary(const uint8_t * buffer, ThermalFrame_Summary_T * summary);
+
+/**
+ * @brief Writes the THERMAL_FRAME_BATCH_HEADER_SIZE bytes of a batch header.
+ */
+void ThermalFrame_WriteBatchHeader(ThermalFrame_Mode_T mode, uint16_t framePeriodMs, uint8_t * buffer);
+
+/**
+ * @brief Reads a batch header.
+ *
+ * @return false for a length below THERMAL_FRAME_BATCH_HEADER_SIZE, another magic, version or an unknown mode.
+ */
+bool ThermalFrame_ReadBatchHeader(const uint8_t * buffer, uint32_t length, ThermalFrame_Mode_T * mode, uint16_t * framePeriodMs);
+
+#endif /* THERMALFRAME_H_ */
@@ -0,0 +1,518 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the streaming time-series compressor.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "TimeSeriesCompressor.h"
+
+/* system header files */
+#include <string.h>
+
+/* constant definitions ***************************************************** */
+
+#define TSC_HEADER_MAGIC            UINT8_C(0x54) /**< 'T' */
+#define TSC_NO_WINDOW               UINT8_C(0xFF) /**< Column has no XOR window yet */
+
+/**
+ * Worst case size of one encoded sample in bits: a 4 bit prefix plus the
+ * raw word for the timestamp and for every delta-of-delta column, 2 control
+ * bits + 5 bits leading zeros + 5 bits length + the raw word for an XOR column.
+ */
+#define TSC_WORST_CASE_TIMESTAMP_BITS    UINT32_C(36)
+#define TSC_WORST_CASE_COLUMN_BITS       UINT32_C(44)
+
+/* local functions ********************************************************** */
+
+static void WriteBits(uint8_t * buffer, uint32_t * bitPosition, uint32_t value, uint8_t count)
+{
+    while (count > 0U)
+    {
+        uint32_t byteIndex = *bitPosition >> 3;
+        uint8_t bitOffset = (uint8_t) (*bitPosition & 7U);
+        uint8_t space = (uint8_t) (8U - bitOffset);
+        uint8_t chunk = (count < space) ? count : space;
+        uint8_t bits = (uint8_t) ((value >> (count - chunk)) & ((1U << chunk) - 1U));
+
+        if (0U == bitOffset)
+        {
+            buffer[byteIndex] = 0U;
+        }
+        buffer[byteIndex] |= (uint8_t) (bits << (space - chunk));
+        count -= chunk;
+        *bitPosition += chunk;
+    }
+}
+
+static bool ReadBits(const uint8_t * buffer, uint32_t length, uint32_t * bitPosition, uint8_t count, uint32_t * value)
+{
+    uint32_t result = 0UL;
+
+    if ((*bitPosition + count) > (length * 8UL))
+    {
+        return false;
+    }
+    while (count > 0U)
+    {
+        uint32_t byteIndex = *bitPosition >> 3;
+        uint8_t bitOffset = (uint8_t) (*bitPosition & 7U);
+        uint8_t space = (uint8_t) (8U - bitOffset);
+        uint8_t chunk = (count < space) ? count : space;
+        uint8_t bits = (uint8_t) ((buffer[byteIndex] >> (space - chunk)) & ((1U << chunk) - 1U));
+
+        /* two steps, a 32 bit shift of a 32 bit word is undefined */
+        result = (result << (chunk - 1U)) << 1U;
+        result |= bits;
+        count -= chunk;
+        *bitPosition += chunk;
+    }
+    *value = result;
+    return true;
+}
+
+/**
+ * @brief Encodes a delta-of-delta into its bucket.
+ *
+ * Buckets (prefix, payload bits, range):
+ * '0' 0 [0], '10' 7 [-63, 64], '110' 9 [-255, 256], '1110' 12 [-2047, 2048], '1111' 32 [any]
+ *
+ * @return Number of bits written (or that would be written if buffer is NULL).
+ */
+static uint32_t EncodeDeltaOfDelta(uint8_t * buffer, uint32_t * bitPosition, uint32_t deltaOfDelta)
+{
+    int32_t dod = (int32_t) deltaOfDelta;
+    uint32_t prefix;
+    uint8_t prefixBits;
+    uint8_t payloadBits;
+    uint32_t payload;
+
+    if (0 == dod)
+    {
+        prefix = 0U;
+        prefixBits = 1U;
+        payloadBits = 0U;
+    }
+    else if ((dod >= -63) && (dod <= 64))
+    {
+        prefix = 0x2U;
+        prefixBits = 2U;
+        payloadBits = 7U;
+    }
+    else if ((dod >= -255) && (dod <= 256))
+    {
+        prefix = 0x6U;
+        prefixBits = 3U;
+        payloadBits = 9U;
+    }
+    else if ((dod >= -2047) && (dod <= 2048))
+    {
+        prefix = 0xEU;
+        prefixBits = 4U;
+        payloadBits = 12U;
+    }
+    else
+    {
+        prefix = 0xFU;
+        prefixBits = 4U;
+        payloadBits = 32U;
+    }
+
+    if (NULL != buffer)
+    {
+        WriteBits(buffer, bitPosition, prefix, prefixBits);
+        if (32U == payloadBits)
+        {
+            WriteBits(buffer, bitPosition, deltaOfDelta, payloadBits);
+        }
+        else if (0U != payloadBits)
+        {
+            /* offset into the unsigned range, e.g. [-63, 64] -> [0, 127] */
+            payload = (uint32_t) (dod + ((1 << (payloadBits - 1U)) - 1));
+            WriteBits(buffer, bitPosition, payload, payloadBits);
+        }
+    }
+    return (uint32_t) prefixBits + payloadBits;
+}
+
+static bool DecodeDeltaOfDelta(const uint8_t * buffer, uint32_t length, uint32_t * bitPosition, uint32_t * deltaOfDelta)
+{
+    uint8_t payloadBits = 32U;
+    uint8_t prefixLength;
+    uint32_t bit = 0UL;
+    uint32_t payload = 0UL;
+    static const uint8_t bucketBits[] = { 0U, 7U, 9U, 12U };
+
+    for (prefixLength = 0U; prefixLength < 4U; prefixLength++)
+    {
+        if (!ReadBits(buffer, length, bitPosition, 1U, &bit))
+        {
+            return false;
+        }
+        if (0UL == bit)
+        {
+            payloadBits = bucketBits[prefixLength];
+            break;
+        }
+    }
+    if (0U == payloadBits)
+    {
+        *deltaOfDelta = 0UL;
+        return true;
+    }
+    if (!ReadBits(buffer, length, bitPosition, payloadBits, &payload))
+    {
+        return false;
+    }
+    if (32U == payloadBits)
+    {
+        *deltaOfDelta = payload;
+    }
+    else
+    {
+        *deltaOfDelta = (uint32_t) ((int32_t) payload - ((1 << (payloadBits - 1U)) - 1));
+    }
+    return true;
+}
+
+/**
+ * @brief Encodes one delta-of-delta column value.
+ *
+ * With a NULL buffer only the size is computed and the column is not updated.
+ */
+static uint32_t EncodeIntegerColumn(uint8_t * buffer, uint32_t * bitPosition, TimeSeriesCompressor_Column_T * column, uint32_t value)
+{
+    uint32_t delta = value - column->Previous;
+    uint32_t bits = EncodeDeltaOfDelta(buffer, bitPosition, delta - column->PreviousDelta);
+
+    if (NULL != buffer)
+    {
+        column->Previous = value;
+        column->PreviousDelta = delta;
+    }
+    return bits;
+}
+
+/**
+ * @brief Encodes one XOR column value.
+ *
+ * '0' identical value, '10' + bits in the previous window,
+ * '11' + 5 bits leading zeros + 5 bits (length - 1) + bits for a new window.
+ * With a NULL buffer only the size is computed and the column is not updated.
+ */
+static uint32_t EncodeFloatColumn(uint8_t * buffer, uint32_t * bitPosition, TimeSeriesCompressor_Column_T * column, uint32_t value)
+{
+    uint32_t xorValue = value ^ column->Previous;
+    uint8_t leading;
+    uint8_t trailing;
+    uint8_t significant;
+    uint32_t bits;
+
+    if (0UL == xorValue)
+    {
+        if (NULL != buffer)
+        {
+            WriteBits(buffer, bitPosition, 0U, 1U);
+        }
+        return 1UL;
+    }
+
+    leading = (uint8_t) __builtin_clz(xorValue);
+    trailing = (uint8_t) __builtin_ctz(xorValue);
+    if (leading > 31U)
+    {
+        leading = 31U;
+    }
+
+    if ((TSC_NO_WINDOW != column->Leading) && (leading >= column->Leading) && (trailing >= column->Trailing))
+    {
+        significant = (uint8_t) (32U - column->Leading - column->Trailing);
+        bits = 2UL + significant;
+        if (NULL != buffer)
+        {
+            WriteBits(buffer, bitPosition, 0x2U, 2U);
+            WriteBits(buffer, bitPosition, xorValue >> column->Trailing, significant);
+        }
+    }
+    else
+    {
+        significant = (uint8_t) (32U - leading - trailing);
+        bits = 12UL + significant;
+        if (NULL != buffer)
+        {
+            WriteBits(buffer, bitPosition, 0x3U, 2U);
+            WriteBits(buffer, bitPosition, leading, 5U);
+            WriteBits(buffer, bitPosition, (uint32_t) significant - 1U, 5U);
+            WriteBits(buffer, bitPosition, xorValue >> trailing, significant);
+            column->Leading = leading;
+            column->Trailing = trailing;
+        }
+    }
+    if (NULL != buffer)
+    {
+        column->Previous = value;
+    }
+    return bits;
+}
+
+static bool DecodeFloatColumn(const uint8_t * buffer, uint32_t length, uint32_t * bitPosition, TimeSeriesCompressor_Column_T * column)
+{
+    uint32_t control = 0UL;
+    uint32_t leading = 0UL;
+    uint32_t significant = 0UL;
+    uint32_t xorValue = 0UL;
+
+    if (!ReadBits(buffer, length, bitPosition, 1U, &control))
+    {
+        return false;
+    }
+    if (0UL == control)
+    {
+        return true;
+    }
+    if (!ReadBits(buffer, length, bitPosition, 1U, &control))
+    {
+        return false;
+    }
+    if (1UL == control)
+    {
+        if (!ReadBits(buffer, length, bitPosition, 5U, &leading) ||
+                !ReadBits(buffer, length, bitPosition, 5U, &significant))
+        {
+            return false;
+        }
+        significant += 1UL;
+        if ((leading + significant) > 32UL)
+        {
+            return false;
+        }
+        column->Leading = (uint8_t) leading;
+        column->Trailing = (uint8_t) (32UL - leading - significant);
+    }
+    else if (TSC_NO_WINDOW == column->Leading)
+    {
+        return false;
+    }
+    significant = 32UL - column->Leading - column->Trailing;
+    if (!ReadBits(buffer, length, bitPosition, (uint8_t) significant, &xorValue))
+    {
+        return false;
+    }
+    column->Previous ^= (xorValue << column->Trailing);
+    return true;
+}
+
+static void ResetColumns(TimeSeriesCompressor_Column_T * timestamp, TimeSeriesCompressor_Column_T * columns)
+{
+    uint8_t index;
+
+    memset(timestamp, 0, sizeof(*timestamp));
+    for (index = 0U; index < TIMESERIES_COMPRESSOR_MAX_CHANNELS; index++)
+    {
+        columns[index].Previous = 0UL;
+        columns[index].PreviousDelta = 0UL;
+        columns[index].Leading = TSC_NO_WINDOW;
+        columns[index].Trailing = 0U;
+    }
+}
+
+static uint32_t EncodeSample(TimeSeriesCompressor_T * compressor, uint8_t * buffer, uint32_t timestampMs, const uint32_t * values)
+{
+    uint32_t bitPosition = compressor->BitPosition;
+    uint32_t bits = 0UL;
+    uint8_t index;
+
+    if (0U == compressor->SampleCount)
+    {
+        /* first sample of the block: raw words, they seed the column state */
+        if (NULL != buffer)
+        {
+            WriteBits(buffer, &bitPosition, timestampMs, 32U);
+            compressor->Timestamp.Previous = timestampMs;
+            for (index = 0U; index < compressor->ChannelCount; index++)
+            {
+                WriteBits(buffer, &bitPosition, values[index], 32U);
+                compressor->Columns[index].Previous = values[index];
+            }
+            compressor->BitPosition = bitPosition;
+        }
+        return 32UL * (1UL + compressor->ChannelCount);
+    }
+
+    bits += EncodeIntegerColumn(buffer, &bitPosition, &compressor->Timestamp, timestampMs);
+    for (index = 0U; index < compressor->ChannelCount; index++)
+    {
+        if (0U != (compressor->FloatMask & (1U << index)))
+        {
+            bits += EncodeFloatColumn(buffer, &bitPosition, &compressor->Columns[index], values[index]);
+        }
+        else
+        {
+            bits += EncodeIntegerColumn(buffer, &bitPosition, &compressor->Columns[index], values[index]);
+        }
+    }
+    if (NULL != buffer)
+    {
+        compressor->BitPosition = bitPosition;
+    }
+    return bits;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool TimeSeriesCompressor_Init(TimeSeriesCompressor_T * compressor, uint8_t channelCount, uint16_t floatMask, uint8_t * buffer, uint32_t capacity)
+{
+    if ((NULL == compressor) || (NULL == buffer) || (0U == channelCount) ||
+            (channelCount > TIMESERIES_COMPRESSOR_MAX_CHANNELS) || (capacity < TIMESERIES_COMPRESSOR_HEADER_SIZE))
+    {
+        return false;
+    }
+    compressor->Buffer = buffer;
+    compressor->Capacity = capacity;
+    compressor->BitPosition = TIMESERIES_COMPRESSOR_HEADER_SIZE * 8UL;
+    compressor->FloatMask = floatMask;
+    compressor->SampleCount = 0U;
+    compressor->ChannelCount = channelCount;
+    ResetColumns(&compressor->Timestamp, compressor->Columns);
+    (void) TimeSeriesCompressor_Finish(compressor);
+    return true;
+}
+
+/** Refer interface header for description */
+bool TimeSeriesCompressor_Append(TimeSeriesCompressor_T * compressor, uint32_t timestampMs, const uint32_t * values)
+{
+    uint32_t freeBits;
+    uint32_t worstCaseBits;
+
+    if ((NULL == compressor) || (NULL == values) || (UINT16_MAX == compressor->SampleCount))
+    {
+        return false;
+    }
+    freeBits = (compressor->Capacity * 8UL) - compressor->BitPosition;
+    worstCaseBits = TSC_WORST_CASE_TIMESTAMP_BITS + (TSC_WORST_CASE_COLUMN_BITS * compressor->ChannelCount);
+
+    /* only pay for the exact size computation when the block is nearly full */
+    if ((freeBits < worstCaseBits) && (freeBits < EncodeSample(compressor, NULL, timestampMs, values)))
+    {
+        return false;
+    }
+    (void) EncodeSample(compressor, compressor->Buffer, timestampMs, values);
+    compressor->SampleCount++;
+    return true;
+}
+
+/** Refer interface header for description */
+uint32_t TimeSeriesCompressor_Finish(TimeSeriesCompressor_T * compressor)
+{
+    uint8_t * header;
+
+    if (NULL == compressor)
+    {
+        return 0UL;
+    }
+    header = compressor->Buffer;
+    header[0] = TSC_HEADER_MAGIC;
+    header[1] = TIMESERIES_COMPRESSOR_VERSION;
+    header[2] = compressor->ChannelCount;
+    header[3] = (uint8_t) (compressor->FloatMask & 0xFFU);
+    header[4] = (uint8_t) (compressor->FloatMask >> 8);
+    header[5] = (uint8_t) (compressor->SampleCount & 0xFFU);
+    header[6] = (uint8_t) (compressor->SampleCount >> 8);
+    header[7] = 0U;
+    return (compressor->BitPosition + 7UL) / 8UL;
+}
+
+/** Refer interface header for description */
+bool TimeSeriesDecompressor_Init(TimeSeriesDecompressor_T * decompressor, const uint8_t * buffer, uint32_t length)
+{
+    if ((NULL == decompressor) || (NULL == buffer) || (length < TIMESERIES_COMPRESSOR_HEADER_SIZE) ||
+            (TSC_HEADER_MAGIC != buffer[0]) || (TIMESERIES_COMPRESSOR_VERSION != buffer[1]) ||
+            (0U == buffer[2]) || (buffer[2] > TIMESERIES_COMPRESSOR_MAX_CHANNELS))
+    {
+        return false;
+    }
+    decompressor->Buffer = buffer;
+    decompressor->Length = length;
+    decompressor->BitPosition = TIMESERIES_COMPRESSOR_HEADER_SIZE * 8UL;
+    decompressor->ChannelCount = buffer[2];
+    decompressor->FloatMask = (uint16_t) (buffer[3] | ((uint16_t) buffer[4] << 8));
+    decompressor->SampleCount = (uint16_t) (buffer[5] | ((uint16_t) buffer[6] << 8));
+    decompressor->SampleIndex = 0U;
+    ResetColumns(&decompressor->Timestamp, decompressor->Columns);
+    return true;
+}
+
+/** Refer interface header for description */
+bool TimeSeriesDecompressor_Next(TimeSeriesDecompressor_T * decompressor, uint32_t * timestampMs, uint32_t * values)
+{
+    const uint8_t * buffer;
+    uint32_t length;
+    uint32_t deltaOfDelta = 0UL;
+    TimeSeriesCompressor_Column_T * column;
+    uint8_t index;
+
+    if ((NULL == decompressor) || (NULL == timestampMs) || (NULL == values) ||
+            (decompressor->SampleIndex >= decompressor->SampleCount))
+    {
+        return false;
+    }
+    buffer = decompressor->Buffer;
+    length = decompressor->Length;
+
+    if (0U == decompressor->SampleIndex)
+    {
+        if (!ReadBits(buffer, length, &decompressor->BitPosition, 32U, &decompressor->Timestamp.Previous))
+        {
+            return false;
+        }
+        for (index = 0U; index < decompressor->ChannelCount; index++)
+        {
+            if (!ReadBits(buffer, length, &decompressor->BitPosition, 32U, &decompressor->Columns[index].Previous))
+            {
+                return false;
+            }
+        }
+    }
+    else
+    {
+        if (!DecodeDeltaOfDelta(buffer, length, &decompressor->BitPosition, &deltaOfDelta))
+        {
+            return false;
+        }
+        decompressor->Timestamp.PreviousDelta += deltaOfDelta;
+        decompressor->Timestamp.Previous += decompressor->Timestamp.PreviousDelta;
+
+        for (index = 0U; index < decompressor->ChannelCount; index++)
+        {
+            column = &decompressor->Columns[index];
+            if (0U != (decompressor->FloatMask & (1U << index)))
+            {
+                if (!DecodeFloatColumn(buffer, length, &decompressor->BitPosition, column))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                if (!DecodeDeltaOfDelta(buffer, length, &decompressor->BitPosition, &deltaOfDelta))
+                {
+                    return false;
+                }
+                column->PreviousDelta += deltaOfDelta;
+                column->Previous += column->PreviousDelta;
+            }
+        }
+    }
+
+    *timestampMs = decompressor->Timestamp.Previous;
+    for (index = 0U; index < decompressor->ChannelCount; index++)
+    {
+        values[index] = decompressor->Columns[index].Previous;
+    }
+    decompressor->SampleIndex++;
+    return true;
+}
@@ -0,0 +1,174 @@
+/**
+ *  @file
+ *
+ *  @brief Streaming time-series compressor for batched sensor samples.
+ *
+ *  Gorilla style encoding adapted to 32 bit words:
+ *  - the timestamp column and the integer channels are stored as
+ *    delta-of-delta in variable length buckets,
+ *  - the float channels are stored as the XOR against the previous value,
+ *    re-using the previous leading/trailing zero window when possible.
+ *
+ *  The working set is the compressor structure itself plus the caller owned
+ *  output buffer; nothing is allocated. The module has no platform dependency
+ *  so the very same code decodes the blocks on the host.
+ *
+ *  Block layout (all multi byte header fields are little endian):
+ *  | 0 | 1       | 2            | 3..4      | 5..6        | 7        | 8.. |
+ *  | T | version | channelCount | floatMask | sampleCount | reserved | bit stream |
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef TIMESERIESCOMPRESSOR_H_
+#define TIMESERIESCOMPRESSOR_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Maximum number of value columns a block can carry (size of the float mask) */
+#define TIMESERIES_COMPRESSOR_MAX_CHANNELS      UINT8_C(16)
+
+/** Size of the block header in bytes */
+#define TIMESERIES_COMPRESSOR_HEADER_SIZE       UINT32_C(8)
+
+/** Block format version written into the header */
+#define TIMESERIES_COMPRESSOR_VERSION           UINT8_C(1)
+
+/**
+ * @brief Per column encoder / decoder state.
+ */
+struct TimeSeriesCompressor_Column_S
+{
+    uint32_t Previous; /**< Previous value (raw bits) */
+    uint32_t PreviousDelta; /**< Previous delta, delta-of-delta columns only */
+    uint8_t Leading; /**< Leading zeros of the current XOR window, 0xFF if none yet */
+    uint8_t Trailing; /**< Trailing zeros of the current XOR window */
+};
+typedef struct TimeSeriesCompressor_Column_S TimeSeriesCompressor_Column_T;
+
+/**
+ * @brief Compressor state for one block.
+ */
+struct TimeSeriesCompressor_S
+{
+    uint8_t * Buffer;
+    uint32_t Capacity; /**< Size of Buffer in bytes */
+    uint32_t BitPosition; /**< Next bit to write, counted from the start of Buffer */
+    uint16_t FloatMask;
+    uint16_t SampleCount;
+    uint8_t ChannelCount;
+    TimeSeriesCompressor_Column_T Timestamp;
+    TimeSeriesCompressor_Column_T Columns[TIMESERIES_COMPRESSOR_MAX_CHANNELS];
+};
+typedef struct TimeSeriesCompressor_S TimeSeriesCompressor_T;
+
+/**
+ * @brief Decompressor state for one block.
+ */
+struct TimeSeriesDecompressor_S
+{
+    const uint8_t * Buffer;
+    uint32_t Length; /**< Size of Buffer in bytes */
+    uint32_t BitPosition;
+    uint16_t FloatMask;
+    uint16_t SampleCount; /**< Number of samples in the block */
+    uint16_t SampleIndex; /**< Number of samples decoded so far */
+    uint8_t ChannelCount;
+    TimeSeriesCompressor_Column_T Timestamp;
+    TimeSeriesCompressor_Column_T Columns[TIMESERIES_COMPRESSOR_MAX_CHANNELS];
+};
+typedef struct TimeSeriesDecompressor_S TimeSeriesDecompressor_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts a new block in the given buffer.
+ *
+ * @param[out] compressor
+ * Compressor state to initialize
+ *
+ * @param[in] channelCount
+ * Number of value columns per sample (1 .. TIMESERIES_COMPRESSOR_MAX_CHANNELS)
+ *
+ * @param[in] floatMask
+ * Bit n set if column n holds an IEEE-754 float
+ *
+ * @param[in] buffer
+ * Output buffer; must stay valid until TimeSeriesCompressor_Finish
+ *
+ * @param[in] capacity
+ * Size of the output buffer, at least TIMESERIES_COMPRESSOR_HEADER_SIZE
+ *
+ * @return true on success, false on invalid parameters.
+ */
+bool TimeSeriesCompressor_Init(TimeSeriesCompressor_T * compressor, uint8_t channelCount, uint16_t floatMask, uint8_t * buffer, uint32_t capacity);
+
+/**
+ * @brief Appends one sample to the block.
+ *
+ * The append is all-or-nothing: if the encoded sample does not fit into the
+ * remaining buffer the block is left untouched.
+ *
+ * @param[in,out] compressor
+ * Compressor state
+ *
+ * @param[in] timestampMs
+ * Sample timestamp
+ *
+ * @param[in] values
+ * channelCount raw 32 bit values
+ *
+ * @return true if the sample was added, false if the block is full.
+ */
+bool TimeSeriesCompressor_Append(TimeSeriesCompressor_T * compressor, uint32_t timestampMs, const uint32_t * values);
+
+/**
+ * @brief Completes the block header.
+ *
+ * The block may still be appended to afterwards; calling this again updates
+ * the header.
+ *
+ * @param[in,out] compressor
+ * Compressor state
+ *
+ * @return Number of bytes of the buffer used by the block.
+ */
+uint32_t TimeSeriesCompressor_Finish(TimeSeriesCompressor_T * compressor);
+
+/**
+ * @brief Parses the header of a block.
+ *
+ * @param[out] decompressor
+ * Decompressor state to initialize
+ *
+ * @param[in] buffer
+ * Block as produced by TimeSeriesCompressor_Finish
+ *
+ * @param[in] length
+ * Size of the block in bytes
+ *
+ * @return true if the header is valid.
+ */
+bool TimeSeriesDecompressor_Init(TimeSeriesDecompressor_T * decompressor, const uint8_t * buffer, uint32_t length);
+
+/**
+ * @brief Decodes the next sample of the block.
+ *
+ * @param[in,out] decompressor
+ * Decompressor state
+ *
+ * @param[out] timestampMs
+ * Sample timestamp
+ *
+ * @param[out] values
+ * Room for channelCount raw 32 bit values
+ *
+ * @return true if a sample was decoded, false at the end of the block or on a truncated block.
+ */
+bool TimeSeriesDecompressor_Next(TimeSeriesDecompressor_T * decompressor, uint32_t * timestampMs, uint32_t * values);
+
+#endif /* TIMESERIESCOMPRESSOR_H_ */
@@ -0,0 +1,346 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the upload priority queue.
+ *
+ *  A record is a header of UPLOAD_QUEUE_RECORD_OVERHEAD bytes (push time and
+ *  length) followed by its data, padded to 4 bytes so the data stays aligned.
+ *  Removing a record moves the ones behind it to the front; the buffers are a
+ *  few hundred bytes to a few KB, a ring with records wrapping around its end
+ *  would cost more code than the moves cost time.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "UploadQueue.h"
+
+/* system header files */
+#include <stddef.h>
+#include <string.h>
+
+/* local variables ********************************************************** */
+
+static const char * const UploadQueueClassNames[UPLOAD_QUEUE_CLASS_COUNT] =
+        {
+                "alert",
+                "telemetry",
+                "backlog",
+                "diagnostics",
+        };
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Returns the buffer bytes of a record of length data bytes.
+ */
+static uint32_t UploadQueueSpan(uint32_t length)
+{
+    return UPLOAD_QUEUE_RECORD_OVERHEAD + ((length + 3UL) & ~3UL);
+}
+
+/**
+ * @brief Returns the header of the record at a buffer offset: push time, then length.
+ */
+static uint32_t * UploadQueueHeader(const UploadQueue_ClassState_T * state, uint32_t offset)
+{
+    return &state->Setup.Storage[offset / sizeof(uint32_t)];
+}
+
+/**
+ * @brief Returns the buffer offset of a record, 0 for the oldest.
+ */
+static uint32_t UploadQueueOffset(const UploadQueue_ClassState_T * state, uint32_t index)
+{
+    uint32_t offset = 0UL;
+
+    while (index-- > 0UL)
+    {
+        offset += UploadQueueSpan(UploadQueueHeader(state, offset)[1]);
+    }
+    return offset;
+}
+
+/**
+ * @brief Removes the record at a buffer offset.
+ */
+static void UploadQueueRemove(UploadQueue_ClassState_T * state, uint32_t offset)
+{
+    uint8_t * base = (uint8_t *) state->Setup.Storage;
+    uint32_t span = UploadQueueSpan(UploadQueueHeader(state, offset)[1]);
+
+    (void) memmove(&base[offset], &base[offset + span], state->Statistics.DepthBytes - offset - span);
+    state->Statistics.DepthBytes -= span;
+    state->Statistics.Depth--;
+}
+
+/**
+ * @brief Drops the oldest record which is not in flight.
+ *
+ * @return false if every record is in flight.
+ */
+static bool UploadQueueShed(UploadQueue_ClassState_T * state)
+{
+    if (state->Statistics.Depth <= (uint32_t) state->InFlight)
+    {
+        return false;
+    }
+    UploadQueueRemove(state, UploadQueueOffset(state, state->InFlight));
+    state->Statistics.Dropped++;
+    return true;
+}
+
+/**
+ * @brief Appends a record, keeping its push time.
+ */
+static bool UploadQueueAppend(UploadQueue_ClassState_T * state, const void * data, uint32_t length, uint32_t enqueuedMs)
+{
+    uint32_t span = UploadQueueSpan(length);
+    uint32_t * header;
+    bool isRoom;
+
+    if (UPLOAD_QUEUE_OVERFLOW_REPLACE == state->Setup.Overflow)
+    {
+        while (UploadQueueShed(state))
+        {
+        }
+    }
+    isRoom = (span <= state->Setup.Size);
+    while (isRoom && ((state->Setup.Size - state->Statistics.DepthBytes) < span))
+    {
+        isRoom = (UPLOAD_QUEUE_OVERFLOW_REJECT != state->Setup.Overflow) && UploadQueueShed(state);
+    }
+    if (!isRoom)
+    {
+        state->Statistics.Dropped++;
+        return false;
+    }
+    header = UploadQueueHeader(state, state->Statistics.DepthBytes);
+    header[0] = enqueuedMs;
+    header[1] = length;
+    if (0UL != length)
+    {
+        (void) memcpy(&header[2], data, length);
+    }
+    state->Statistics.DepthBytes += span;
+    state->Statistics.Depth++;
+    state->Statistics.Enqueued++;
+    if (state->Statistics.DepthBytes > state->Statistics.PeakBytes)
+    {
+        state->Statistics.PeakBytes = state->Statistics.DepthBytes;
+    }
+    return true;
+}
+
+/**
+ * @brief Moves the telemetry record at a buffer offset to the backlog.
+ */
+static void UploadQueueMove(UploadQueue_T * queue, uint32_t offset)
+{
+    UploadQueue_ClassState_T * telemetry = &queue->Classes[UPLOAD_QUEUE_CLASS_TELEMETRY];
+    const uint32_t * header = UploadQueueHeader(telemetry, offset);
+
+    /* A full backlog sheds its own oldest record, or counts this one as dropped */
+    (void) UploadQueueAppend(&queue->Classes[UPLOAD_QUEUE_CLASS_BACKLOG], &header[2], header[1], header[0]);
+    UploadQueueRemove(telemetry, offset);
+    telemetry->Statistics.Demoted++;
+}
+
+/**
+ * @brief Moves telemetry older than RecentMs to the backlog.
+ */
+static void UploadQueueDemote(UploadQueue_T * queue, uint32_t nowMs)
+{
+    UploadQueue_ClassState_T * telemetry = &queue->Classes[UPLOAD_QUEUE_CLASS_TELEMETRY];
+
+    while ((0UL != queue->RecentMs) && (telemetry->Statistics.Depth > (uint32_t) telemetry->InFlight))
+    {
+        if ((nowMs - UploadQueueHeader(telemetry, UploadQueueOffset(telemetry, telemetry->InFlight))[0]) < queue->RecentMs)
+        {
+            break;
+        }
+        UploadQueueMove(queue, UploadQueueOffset(telemetry, telemetry->InFlight));
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool UploadQueue_Init(UploadQueue_T * queue, const UploadQueue_ClassSetup_T * setups, uint32_t recentMs)
+{
+    uint8_t queueClass;
+
+    if ((NULL == queue) || (NULL == setups))
+    {
+        return false;
+    }
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        if ((NULL == setups[queueClass].Storage) || (0U == setups[queueClass].MaxBatch))
+        {
+            return false;
+        }
+        (void) memset(&queue->Classes[queueClass], 0, sizeof(queue->Classes[queueClass]));
+        queue->Classes[queueClass].Setup = setups[queueClass];
+        queue->Classes[queueClass].Setup.Size &= ~3UL;
+    }
+    queue->RecentMs = recentMs;
+    UploadQueue_StartInterval(queue);
+    return true;
+}
+
+/** Refer interface header for description */
+bool UploadQueue_Push(UploadQueue_T * queue, UploadQueue_Class_T queueClass, const void * data, uint32_t length, uint32_t nowMs)
+{
+    UploadQueue_ClassState_T * state;
+
+    if ((NULL == queue) || ((uint32_t) queueClass >= (uint32_t) UPLOAD_QUEUE_CLASS_COUNT) || ((NULL == data) && (0UL != length)))
+    {
+        return false;
+    }
+    if ((UPLOAD_QUEUE_CLASS_TELEMETRY == queueClass) && (0UL != queue->RecentMs))
+    {
+        /* Full telemetry makes room by aging its oldest records early */
+        state = &queue->Classes[UPLOAD_QUEUE_CLASS_TELEMETRY];
+        while (((state->Setup.Size - state->Statistics.DepthBytes) < UploadQueueSpan(length)) &&
+                (state->Statistics.Depth > (uint32_t) state->InFlight))
+        {
+            UploadQueueMove(queue, UploadQueueOffset(state, state->InFlight));
+        }
+    }
+    return UploadQueueAppend(&queue->Classes[queueClass], data, length, nowMs);
+}
+
+/** Refer interface header for description */
+void UploadQueue_StartInterval(UploadQueue_T * queue)
+{
+    uint8_t queueClass;
+
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        queue->Classes[queueClass].BudgetLeft = (0UL != queue->Classes[queueClass].Setup.IntervalBudget) ?
+                queue->Classes[queueClass].Setup.IntervalBudget : UINT32_MAX;
+    }
+}
+
+/** Refer interface header for description */
+bool UploadQueue_Peek(UploadQueue_T * queue, UploadQueue_Class_T lowest, uint32_t nowMs, UploadQueue_Batch_T * batch)
+{
+    UploadQueue_ClassState_T * state;
+    uint32_t offset;
+    uint32_t length;
+    uint8_t queueClass;
+
+    if ((NULL == queue) || (NULL == batch))
+    {
+        return false;
+    }
+    for (queueClass = 0U; queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT; queueClass++)
+    {
+        if (0U != queue->Classes[queueClass].InFlight)
+        {
+            return false;
+        }
+    }
+    UploadQueueDemote(queue, nowMs);
+    for (queueClass = 0U; (queueClass <= (uint8_t) lowest) && (queueClass < (uint8_t) UPLOAD_QUEUE_CLASS_COUNT); queueClass++)
+    {
+        state = &queue->Classes[queueClass];
+        batch->Class = (UploadQueue_Class_T) queueClass;
+        batch->Count = 0U;
+        batch->Bytes = 0UL;
+        batch->PeekMs = nowMs;
+        offset = 0UL;
+        while ((batch->Count < state->Setup.MaxBatch) && (batch->Count < state->Statistics.Depth))
+        {
+            length = UploadQueueHeader(state, offset)[1];
+            if ((batch->Bytes + length) > state->BudgetLeft)
+            {
+                break;
+            }
+            batch->Bytes += length;
+            batch->Count++;
+            offset += UploadQueueSpan(length);
+        }
+        if (0U != batch->Count)
+        {
+            state->InFlight = batch->Count;
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Refer interface header for description */
+const void * UploadQueue_GetRecord(const UploadQueue_T * queue, const UploadQueue_Batch_T * batch, uint8_t index, uint32_t * length, uint32_t * ageMs)
+{
+    const UploadQueue_ClassState_T * state;
+    const uint32_t * header;
+
+    if ((NULL == queue) || (NULL == batch) || (NULL == length) || (index >= batch->Count))
+    {
+        return NULL;
+    }
+    state = &queue->Classes[batch->Class];
+    header = UploadQueueHeader(state, UploadQueueOffset(state, index));
+    *length = header[1];
+    if (NULL != ageMs)
+    {
+        *ageMs = batch->PeekMs - header[0];
+    }
+    return &header[2];
+}
+
+/** Refer interface header for description */
+void UploadQueue_Complete(UploadQueue_T * queue, const UploadQueue_Batch_T * batch, uint32_t nowMs, bool isSent)
+{
+    UploadQueue_ClassState_T * state;
+    uint32_t latencyMs;
+    uint8_t index;
+
+    if ((NULL == queue) || (NULL == batch) || ((uint32_t) batch->Class >= (uint32_t) UPLOAD_QUEUE_CLASS_COUNT))
+    {
+        return;
+    }
+    state = &queue->Classes[batch->Class];
+    state->BudgetLeft -= (batch->Bytes < state->BudgetLeft) ? batch->Bytes : state->BudgetLeft;
+    state->InFlight = 0U;
+    if (!isSent)
+    {
+        state->Statistics.Failures++;
+        return;
+    }
+    for (index = 0U; index < batch->Count; index++)
+    {
+        latencyMs = nowMs - UploadQueueHeader(state, 0UL)[0];
+        state->Statistics.LastLatencyMs = latencyMs;
+        state->Statistics.TotalLatencyMs += latencyMs;
+        if (latencyMs > state->Statistics.MaxLatencyMs)
+        {
+            state->Statistics.MaxLatencyMs = latencyMs;
+        }
+        UploadQueueRemove(state, 0UL);
+        state->Statistics.Sent++;
+    }
+}
+
+/** Refer interface header for description */
+const UploadQueue_Statistics_T * UploadQueue_GetStatistics(const UploadQueue_T * queue, UploadQueue_Class_T queueClass)
+{
+    if ((NULL == queue) || ((uint32_t) queueClass >= (uint32_t) UPLOAD_QUEUE_CLASS_COUNT))
+    {
+        return NULL;
+    }
+    return &queue->Classes[queueClass].Statistics;
+}
+
+/** Refer interface header for description */
+const char * UploadQueue_GetClassName(UploadQueue_Class_T queueClass)
+{
+    if ((uint32_t) queueClass >= (uint32_t) UPLOAD_QUEUE_CLASS_COUNT)
+    {
+        return "unknown";
+    }
+    return UploadQueueClassNames[queueClass];
+}
@@ -0,0 +1,254 @@
+/**
+ *  @file
+ *
+ *  @brief Outbound queue of the uploads, in priority classes with byte budgets.
+ *
+ *  Each class holds its records in its own buffer, oldest first, so a class
+ *  never takes room from another: the buffer size is the byte budget of the
+ *  class. UploadQueue_Peek hands out a batch of the most important class with
+ *  records waiting, so alerts overtake telemetry, telemetry overtakes the
+ *  backlog and the diagnostics go last. An interval budget (bytes posted per
+ *  UploadQueue_StartInterval) keeps a long backlog from delaying the next
+ *  interval's telemetry on a slow link.
+ *
+ *  Under congestion the queue sheds the least valuable data first:
+ *  - telemetry older than RecentMs, or pushed out of a full telemetry class,
+ *    moves to the backlog, whose batches aggregate many records into one post
+ *  - a full backlog drops its oldest record
+ *  - a new diagnostics record replaces the waiting ones
+ *  - a full alert class rejects the new alert, the first ones of an outage
+ *    are kept
+ *
+ *  The records of the batch in flight stay where they are until
+ *  UploadQueue_Complete, so a body writer may read them while other tasks
+ *  push. The queue itself is not locked, the callers serialize the calls.
+ *
+ *  Pure C, no RTOS or platform dependency: also compiles on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef UPLOADQUEUE_H_
+#define UPLOADQUEUE_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* local type and macro definitions */
+
+/** Bytes a record takes in a class buffer on top of its data */
+#define UPLOAD_QUEUE_RECORD_OVERHEAD        UINT32_C(8)
+
+/** Class buffer size for count records of length bytes */
+#define UPLOAD_QUEUE_CLASS_SIZE(count, length) \
+    ((count) * (UPLOAD_QUEUE_RECORD_OVERHEAD + ((((uint32_t) (length)) + 3UL) & ~3UL)))
+
+/**
+ * @brief Classes, most important first.
+ */
+enum UploadQueue_Class_E
+{
+    UPLOAD_QUEUE_CLASS_ALERT = 0,
+    UPLOAD_QUEUE_CLASS_TELEMETRY,
+    UPLOAD_QUEUE_CLASS_BACKLOG,
+    UPLOAD_QUEUE_CLASS_DIAGNOSTICS,
+    UPLOAD_QUEUE_CLASS_COUNT
+};
+typedef enum UploadQueue_Class_E UploadQueue_Class_T;
+
+/**
+ * @brief What a push into a full class does.
+ */
+enum UploadQueue_Overflow_E
+{
+    UPLOAD_QUEUE_OVERFLOW_REJECT = 0, /**< The new record is dropped */
+    UPLOAD_QUEUE_OVERFLOW_DROP_OLDEST, /**< The oldest records waiting are dropped for it */
+    UPLOAD_QUEUE_OVERFLOW_REPLACE, /**< Every record waiting is dropped for it, even with room left */
+};
+typedef enum UploadQueue_Overflow_E UploadQueue_Overflow_T;
+
+/**
+ * @brief Configuration of a class.
+ */
+struct UploadQueue_ClassSetup_S
+{
+    uint32_t * Storage; /**< Record buffer, owned by the caller */
+    uint32_t Size; /**< Bytes in Storage, the byte budget of the class */
+    uint32_t IntervalBudget; /**< Bytes posted per interval, 0 for no limit */
+    uint8_t MaxBatch; /**< Records per post */
+    UploadQueue_Overflow_T Overflow;
+};
+typedef struct UploadQueue_ClassSetup_S UploadQueue_ClassSetup_T;
+
+/**
+ * @brief Counters and depth of a class.
+ */
+struct UploadQueue_Statistics_S
+{
+    uint32_t Enqueued; /**< Records pushed, demoted ones included */
+    uint32_t Sent; /**< Records posted */
+    uint32_t Dropped; /**< Records rejected or shed */
+    uint32_t Demoted; /**< Records moved to the backlog */
+    uint32_t Failures; /**< Batches whose post failed */
+    uint32_t Depth; /**< Records waiting */
+    uint32_t DepthBytes; /**< Buffer bytes in use */
+    uint32_t PeakBytes; /**< Highest DepthBytes */
+    uint32_t LastLatencyMs; /**< Push to post of the last record sent */
+    uint32_t MaxLatencyMs;
+    uint32_t TotalLatencyMs; /**< Sum over the records sent, for the mean */
+};
+typedef struct UploadQueue_Statistics_S UploadQueue_Statistics_T;
+
+/**
+ * @brief State of a class.
+ */
+struct UploadQueue_ClassState_S
+{
+    UploadQueue_ClassSetup_T Setup;
+    uint32_t BudgetLeft; /**< Bytes still to post in this interval */
+    uint8_t InFlight; /**< Records at the front handed out by UploadQueue_Peek */
+    UploadQueue_Statistics_T Statistics;
+};
+typedef struct UploadQueue_ClassState_S UploadQueue_ClassState_T;
+
+/**
+ * @brief Queue state.
+ */
+struct UploadQueue_S
+{
+    UploadQueue_ClassState_T Classes[UPLOAD_QUEUE_CLASS_COUNT];
+    uint32_t RecentMs; /**< Age at which telemetry moves to the backlog, 0 never */
+};
+typedef struct UploadQueue_S UploadQueue_T;
+
+/**
+ * @brief Records handed out for one post.
+ */
+struct UploadQueue_Batch_S
+{
+    UploadQueue_Class_T Class;
+    uint8_t Count; /**< Records, the oldest of the class */
+    uint32_t Bytes; /**< Data bytes of the records */
+    uint32_t PeekMs; /**< Time of UploadQueue_Peek, for record ages that stay the same in both body passes */
+};
+typedef struct UploadQueue_Batch_S UploadQueue_Batch_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Initializes an empty queue.
+ *
+ * @param[out] queue
+ * Queue state
+ *
+ * @param[in] setups
+ * One configuration per class, in UploadQueue_Class_T order
+ *
+ * @param[in] recentMs
+ * Age at which telemetry moves to the backlog, 0 to keep it
+ *
+ * @return false on invalid parameters.
+ */
+bool UploadQueue_Init(UploadQueue_T * queue, const UploadQueue_ClassSetup_T * setups, uint32_t recentMs);
+
+/**
+ * @brief Appends a record to a class, shedding older ones by its overflow rule.
+ *
+ * @param[in] queue
+ * Queue state
+ *
+ * @param[in] queueClass
+ * Class of the record
+ *
+ * @param[in] data
+ * Record data, copied
+ *
+ * @param[in] length
+ * Bytes of data
+ *
+ * @param[in] nowMs
+ * Time of the push, the start of its latency
+ *
+ * @return false if the record was dropped.
+ */
+bool UploadQueue_Push(UploadQueue_T * queue, UploadQueue_Class_T queueClass, const void * data, uint32_t length, uint32_t nowMs);
+
+/**
+ * @brief Refills the interval budget of every class.
+ */
+void UploadQueue_StartInterval(UploadQueue_T * queue);
+
+/**
+ * @brief Moves aged telemetry to the backlog and hands out the next batch.
+ *
+ * A class is skipped if its interval budget does not cover its oldest record.
+ * The batch stays in flight until UploadQueue_Complete.
+ *
+ * @param[in] queue
+ * Queue state
+ *
+ * @param[in] lowest
+ * Least important class to consider
+ *
+ * @param[in] nowMs
+ * Current time
+ *
+ * @param[out] batch
+ * The records to post
+ *
+ * @return false if nothing is due, or a batch is still in flight.
+ */
+bool UploadQueue_Peek(UploadQueue_T * queue, UploadQueue_Class_T lowest, uint32_t nowMs, UploadQueue_Batch_T * batch);
+
+/**
+ * @brief Returns a record of a batch in flight.
+ *
+ * @param[in] queue
+ * Queue state
+ *
+ * @param[in] batch
+ * Batch of UploadQueue_Peek
+ *
+ * @param[in] index
+ * 0 for the oldest record of the batch
+ *
+ * @param[out] length
+ * Bytes of the record
+ *
+ * @param[out] ageMs
+ * Age of the record at batch->PeekMs, may be NULL
+ *
+ * @return The record data, 4 byte aligned; NULL if index is out of the batch.
+ */
+const void * UploadQueue_GetRecord(const UploadQueue_T * queue, const UploadQueue_Batch_T * batch, uint8_t index, uint32_t * length, uint32_t * ageMs);
+
+/**
+ * @brief Ends a batch in flight: removes its records if they were posted,
+ * keeps them for another attempt otherwise. Both charge the interval budget.
+ *
+ * @param[in] queue
+ * Queue state
+ *
+ * @param[in] batch
+ * Batch of UploadQueue_Peek
+ *
+ * @param[in] nowMs
+ * Current time, the end of the latencies
+ *
+ * @param[in] isSent
+ * true if the server took the batch
+ */
+void UploadQueue_Complete(UploadQueue_T * queue, const UploadQueue_Batch_T * batch, uint32_t nowMs, bool isSent);
+
+/**
+ * @brief Returns the counters and depth of a class.
+ */
+const UploadQueue_Statistics_T * UploadQueue_GetStatistics(const UploadQueue_T * queue, UploadQueue_Class_T queueClass);
+
+/**
+ * @brief Returns the lower case name of a class, e.g. for reports.
+ */
+const char * UploadQueue_GetClassName(UploadQueue_Class_T queueClass);
+
+#endif /* UPLOADQUEUE_H_ */
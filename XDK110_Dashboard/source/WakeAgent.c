@@ -0,0 +1,212 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the wake on event sensing.
+ *
+ *  The policy is only touched on the real-time lane: the motion interrupt,
+ *  the no-motion timer and the light read hook all end up there.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "XdkAppInfo.h"
+
+#undef BCDS_MODULE_ID  /* Module ID define before including Basics package*/
+#define BCDS_MODULE_ID XDK_APP_MODULE_ID_WAKE_AGENT
+
+#include "WakeAgent.h"
+
+/* system header files */
+#include <stdio.h>
+
+/* additional interface header files */
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+#include "XdkSensorHandle.h"
+#include "SensorComponent.h"
+#include "StaticRtos.h"
+#include "WorkDispatcher.h"
+
+/* local variables ********************************************************** */
+
+static const WakeAgent_Setup_T * AgentSetup = NULL;
+
+static WakePolicy_T AgentPolicy;
+
+static xTimerHandle AgentQuietTimer = NULL;
+
+static StaticRtos_Timer_T AgentQuietTimerStorage;
+
+static volatile bool AgentIsMotionQueued = false; /**< Coalesces the interrupts until the real-time lane handled one */
+
+/* local functions ********************************************************** */
+
+static uint32_t AgentNowMs(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+/**
+ * @brief Acts on a result of the policy: retimes the sensors, runs the no-motion timer while active and queues the pending reads.
+ */
+static void AgentApply(bool periodsChanged)
+{
+    uint32_t pending;
+    uint8_t sensor;
+
+    if (periodsChanged)
+    {
+        if (WAKE_POLICY_STATE_ACTIVE == AgentPolicy.State)
+        {
+            (void) xTimerStart(AgentQuietTimer, 0UL);
+        }
+        else
+        {
+            (void) xTimerStop(AgentQuietTimer, 0UL);
+        }
+        if (NULL != AgentSetup->PeriodsChangedCB)
+        {
+            AgentSetup->PeriodsChangedCB();
+        }
+    }
+    pending = WakePolicy_TakePendingReads(&AgentPolicy);
+    for (sensor = 0U; (0UL != pending) && (sensor < (uint8_t) SENSOR_TABLE_SENSOR_COUNT); sensor++)
+    {
+        if (0UL != (pending & (1UL << sensor)))
+        {
+            (void) SensorComponent_ReadNow((SensorTable_Sensor_T) sensor);
+        }
+    }
+}
+
+static void AgentMotionWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    AgentIsMotionQueued = false;
+    AgentApply(WakePolicy_OnMotion(&AgentPolicy, AgentNowMs()));
+}
+
+/**
+ * @brief Slope interrupt of the BMA280, interrupt context.
+ */
+static void AgentMotionIsr(int32_t deviceId, uint32_t channel)
+{
+    BCDS_UNUSED(deviceId);
+    BCDS_UNUSED(channel);
+
+    if (!AgentIsMotionQueued)
+    {
+        AgentIsMotionQueued = (RETCODE_OK == WorkDispatcher_EnqueueFromIsr(WORK_DISPATCHER_LANE_REALTIME, AgentMotionWork, NULL, 0UL));
+    }
+}
+
+static void AgentQuietWork(void * param1, uint32_t param2)
+{
+    BCDS_UNUSED(param1);
+    BCDS_UNUSED(param2);
+
+    AgentApply(WakePolicy_Poll(&AgentPolicy, AgentNowMs()));
+}
+
+static void AgentQuietTimerCallback(xTimerHandle xTimer)
+{
+    BCDS_UNUSED(xTimer);
+
+    (void) WorkDispatcher_Enqueue(WORK_DISPATCHER_LANE_REALTIME, AgentQuietWork, NULL, 0UL);
+}
+
+/**
+ * @brief Read hook, real-time lane: checks every light reading against the lux window.
+ */
+static void AgentOnRead(SensorTable_Sensor_T sensor, Retcode_T retcode, const SensorTable_Value_T * values)
+{
+    if ((SENSOR_TABLE_SENSOR_LIGHT == sensor) && (RETCODE_OK == retcode) &&
+            WakePolicy_OnLight(&AgentPolicy, (uint32_t) values[SENSOR_TABLE_CHANNEL_LIGHT].Int, AgentNowMs()))
+    {
+        AgentApply(false);
+    }
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+Retcode_T WakeAgent_Setup(const WakeAgent_Setup_T * setup)
+{
+    if ((NULL == setup) || (NULL == setup->Policy))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_NULL_POINTER);
+    }
+    if ((0UL == setup->Policy->RampStepMs) || !WakePolicy_Init(&AgentPolicy, setup->Policy))
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_INVALID_PARAM);
+    }
+    AgentQuietTimer = StaticRtos_CreateTimer(&AgentQuietTimerStorage, "WakeQuiet", pdMS_TO_TICKS(setup->Policy->RampStepMs), pdTRUE, NULL,
+            AgentQuietTimerCallback);
+    if (NULL == AgentQuietTimer)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_OUT_OF_RESOURCES);
+    }
+    AgentSetup = setup;
+    return RETCODE_OK;
+}
+
+/** Refer interface header for description */
+Retcode_T WakeAgent_Enable(void)
+{
+    Accelerometer_ConfigSlopeIntr_T slopeConfig;
+    Retcode_T retcode = RETCODE_OK;
+
+    if (NULL == AgentSetup)
+    {
+        return RETCODE(RETCODE_SEVERITY_ERROR, RETCODE_UNINITIALIZED);
+    }
+    slopeConfig.slopeDuration = AgentSetup->SlopeDuration;
+    slopeConfig.slopeThreshold = AgentSetup->SlopeThreshold;
+    slopeConfig.slopeEnableX = UINT8_C(1);
+    slopeConfig.slopeEnableY = UINT8_C(1);
+    slopeConfig.slopeEnableZ = UINT8_C(1);
+
+    /* the BME280 measures once per read and sleeps in between */
+    if (RETCODE_OK != Environmental_setPowerMode(xdkEnvironmental_BME280_Handle, ENVIRONMENTAL_BME280_POWERMODE_FORCED))
+    {
+        printf("WakeAgent_Enable : BME280 forced mode failed, it keeps running continuously \r\n");
+    }
+    retcode = SensorComponent_AddReadHook(AgentOnRead);
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Accelerometer_init(xdkAccelerometers_BMA280_Handle);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Accelerometer_regRealTimeCallback(xdkAccelerometers_BMA280_Handle, AgentMotionIsr);
+    }
+    if (RETCODE_OK == retcode)
+    {
+        retcode = Accelerometer_configInterrupt(xdkAccelerometers_BMA280_Handle, ACCELEROMETER_BMA280_INTERRUPT_CHANNEL1,
+                ACCELEROMETER_BMA280_SLOPE_INTERRUPT, &slopeConfig);
+    }
+    return retcode;
+}
+
+/** Refer interface header for description */
+uint32_t WakeAgent_GetPeriodMs(SensorTable_Sensor_T sensor)
+{
+    return (NULL == AgentSetup) ? 0UL : WakePolicy_GetPeriodMs(&AgentPolicy, (uint8_t) sensor);
+}
+
+/** Refer interface header for description */
+uint32_t WakeAgent_GetSnapshotPeriodMs(void)
+{
+    return (NULL == AgentSetup) ? 0UL : WakePolicy_GetSnapshotPeriodMs(&AgentPolicy);
+}
+
+/** Refer interface header for description */
+const WakePolicy_Statistics_T * WakeAgent_GetStatistics(void)
+{
+    return &AgentPolicy.Statistics;
+}
@@ -0,0 +1,87 @@
+/**
+ *  @file
+ *
+ *  @brief Wake on event sensing: runs the WakePolicy on the sensor interrupts.
+ *
+ *  The agent feeds the events of the sensors into the WakePolicy and tells the
+ *  application when the periods of the sensor timers change:
+ *  - motion: the slope (any-motion) interrupt engine of the BMA280 signals
+ *    motion on INT1; the interrupt only queues the handling on the real-time
+ *    lane. No-motion is the QuietMs timeout of the policy, checked by a timer
+ *    which only runs while the policy is active.
+ *  - light: every light read is checked against the lux window of the policy
+ *    (a SensorComponent read hook), at the idle poll period of the light sensor.
+ *  - on demand: the BME280 runs in forced mode, so it measures once per read
+ *    and sleeps in between; the reads the policy asks for are queued with
+ *    SensorComponent_ReadNow.
+ *
+ *  Between the reads nothing runs, so the MCU stays in the idle task and
+ *  sleeps until the next timer or interrupt.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef WAKEAGENT_H_
+#define WAKEAGENT_H_
+
+/* local interface declaration ********************************************** */
+#include "BCDS_Basics.h"
+#include "BCDS_Retcode.h"
+#include "WakePolicy.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief Called on the real-time lane when the periods of the policy changed.
+ */
+typedef void (*WakeAgent_PeriodsChangedCB_T)(void);
+
+/**
+ * @brief Agent configuration.
+ */
+struct WakeAgent_Setup_S
+{
+    const WakePolicy_Setup_T * Policy; /**< Policy configuration, must stay valid */
+    uint32_t SlopeThreshold; /**< Slope interrupt threshold of the BMA280, in steps of 3.91 mg at the 2 g range */
+    uint32_t SlopeDuration; /**< Consecutive samples above the threshold before the interrupt fires, 1 to 4 */
+    WakeAgent_PeriodsChangedCB_T PeriodsChangedCB;
+};
+typedef struct WakeAgent_Setup_S WakeAgent_Setup_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the policy in IDLE and creates the no-motion timer.
+ *
+ * @param[in] setup
+ * Configuration, must stay valid
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T WakeAgent_Setup(const WakeAgent_Setup_T * setup);
+
+/**
+ * @brief Switches the BME280 to forced mode and enables the motion interrupt and the lux window.
+ *
+ * Requires initialized sensors.
+ *
+ * @return  RETCODE_OK on success, or an error code otherwise.
+ */
+Retcode_T WakeAgent_Enable(void);
+
+/**
+ * @brief Returns the period a sensor runs at now; see WakePolicy_GetPeriodMs.
+ */
+uint32_t WakeAgent_GetPeriodMs(SensorTable_Sensor_T sensor);
+
+/**
+ * @brief Returns the period snapshots are taken at now; see WakePolicy_GetSnapshotPeriodMs.
+ */
+uint32_t WakeAgent_GetSnapshotPeriodMs(void);
+
+/**
+ * @brief Returns the counters of the policy.
+ */
+const WakePolicy_Statistics_T * WakeAgent_GetStatistics(void);
+
+#endif /* WAKEAGENT_H_ */
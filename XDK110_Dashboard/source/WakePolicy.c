@@ -0,0 +1,189 @@
+/**
+ *  @file
+ *
+ *  @brief Implementation of the event driven sampling policy.
+ *
+ */
+
+/* module includes ********************************************************** */
+
+/* own header files */
+#include "WakePolicy.h"
+
+/* system header files */
+#include <stddef.h>
+
+/* local functions ********************************************************** */
+
+/**
+ * @brief Centers the lux window on a reading.
+ */
+static void WakePolicyCenterLux(WakePolicy_T * policy, uint32_t lux)
+{
+    uint32_t halfWidth = (uint32_t) (((uint64_t) lux * policy->Setup->LuxWindowPermille) / 1000U);
+
+    if (halfWidth < policy->Setup->LuxHysteresis)
+    {
+        halfWidth = policy->Setup->LuxHysteresis;
+    }
+    policy->LuxLow = (lux > halfWidth) ? (lux - halfWidth) : 0UL;
+    policy->LuxHigh = ((UINT32_MAX - lux) > halfWidth) ? (lux + halfWidth) : UINT32_MAX;
+    policy->HasLux = true;
+}
+
+/* global functions ********************************************************* */
+
+/** Refer interface header for description */
+bool WakePolicy_Init(WakePolicy_T * policy, const WakePolicy_Setup_T * setup)
+{
+    if ((NULL == policy) || (NULL == setup) || (0UL == setup->HeartbeatMs) || (0UL == setup->ActivePeriodMs) ||
+            (0UL == setup->FastestPeriodMs) || (setup->FastestPeriodMs > setup->ActivePeriodMs))
+    {
+        return false;
+    }
+    policy->Setup = setup;
+    policy->State = WAKE_POLICY_STATE_IDLE;
+    policy->MotionPeriodMs = setup->ActivePeriodMs;
+    policy->LastMotionMs = 0UL;
+    policy->LastStepMs = 0UL;
+    policy->HasLux = false;
+    policy->LuxLow = 0UL;
+    policy->LuxHigh = 0UL;
+    policy->PendingReads = 0UL;
+    policy->Statistics.MotionEvents = 0UL;
+    policy->Statistics.LightEvents = 0UL;
+    policy->Statistics.Activations = 0UL;
+    policy->Statistics.RampSteps = 0UL;
+    return true;
+}
+
+/** Refer interface header for description */
+bool WakePolicy_OnMotion(WakePolicy_T * policy, uint32_t nowMs)
+{
+    uint32_t periodMs;
+
+    if (NULL == policy)
+    {
+        return false;
+    }
+    policy->Statistics.MotionEvents++;
+    policy->LastMotionMs = nowMs;
+    if (WAKE_POLICY_STATE_IDLE == policy->State)
+    {
+        policy->State = WAKE_POLICY_STATE_ACTIVE;
+        policy->MotionPeriodMs = policy->Setup->ActivePeriodMs;
+        policy->LastStepMs = nowMs;
+        /* the sensors of interest are read right away instead of one period later */
+        policy->PendingReads |= policy->Setup->MotionSensors | policy->Setup->OnDemandSensors;
+        policy->Statistics.Activations++;
+        return true;
+    }
+
+    /* continued motion ramps the rate up, one step per RampStepMs */
+    if ((policy->MotionPeriodMs <= policy->Setup->FastestPeriodMs) || ((nowMs - policy->LastStepMs) < policy->Setup->RampStepMs))
+    {
+        return false;
+    }
+    periodMs = policy->MotionPeriodMs / 2UL;
+    policy->MotionPeriodMs = (periodMs < policy->Setup->FastestPeriodMs) ? policy->Setup->FastestPeriodMs : periodMs;
+    policy->LastStepMs = nowMs;
+    policy->Statistics.RampSteps++;
+    return true;
+}
+
+/** Refer interface header for description */
+bool WakePolicy_OnLight(WakePolicy_T * policy, uint32_t lux, uint32_t nowMs)
+{
+    (void) nowMs;
+
+    if (NULL == policy)
+    {
+        return false;
+    }
+    if (policy->HasLux && ((lux < policy->LuxLow) || (lux > policy->LuxHigh)))
+    {
+        WakePolicyCenterLux(policy, lux);
+        policy->PendingReads |= policy->Setup->OnDemandSensors;
+        policy->Statistics.LightEvents++;
+        return true;
+    }
+    if (!policy->HasLux)
+    {
+        WakePolicyCenterLux(policy, lux);
+    }
+    return false;
+}
+
+/** Refer interface header for description */
+bool WakePolicy_Poll(WakePolicy_T * policy, uint32_t nowMs)
+{
+    if ((NULL == policy) || (WAKE_POLICY_STATE_ACTIVE != policy->State) || ((nowMs - policy->LastMotionMs) < policy->Setup->QuietMs) ||
+            ((nowMs - policy->LastStepMs) < policy->Setup->RampStepMs))
+    {
+        return false;
+    }
+    policy->LastStepMs = nowMs;
+    if (policy->MotionPeriodMs >= policy->Setup->ActivePeriodMs)
+    {
+        policy->State = WAKE_POLICY_STATE_IDLE;
+        return true;
+    }
+    policy->MotionPeriodMs *= 2UL;
+    if (policy->MotionPeriodMs > policy->Setup->ActivePeriodMs)
+    {
+        policy->MotionPeriodMs = policy->Setup->ActivePeriodMs;
+    }
+    policy->Statistics.RampSteps++;
+    return true;
+}
+
+/** Refer interface header for description */
+uint32_t WakePolicy_GetPeriodMs(const WakePolicy_T * policy, uint8_t sensor)
+{
+    uint32_t sensorBit;
+    uint32_t idlePeriodMs;
+
+    if ((NULL == policy) || (sensor >= (uint8_t) SENSOR_TABLE_SENSOR_COUNT))
+    {
+        return 0UL;
+    }
+    sensorBit = 1UL << sensor;
+    idlePeriodMs = policy->Setup->HeartbeatMs;
+    if (((uint8_t) SENSOR_TABLE_SENSOR_LIGHT == sensor) && (0UL != policy->Setup->LightPollMs) && (policy->Setup->LightPollMs < idlePeriodMs))
+    {
+        idlePeriodMs = policy->Setup->LightPollMs;
+    }
+    if ((WAKE_POLICY_STATE_IDLE == policy->State) || (0UL != (policy->Setup->OnDemandSensors & sensorBit)))
+    {
+        return idlePeriodMs;
+    }
+    if (0UL != (policy->Setup->MotionSensors & sensorBit))
+    {
+        return policy->MotionPeriodMs;
+    }
+    return (policy->Setup->ActivePeriodMs < idlePeriodMs) ? policy->Setup->ActivePeriodMs : idlePeriodMs;
+}
+
+/** Refer interface header for description */
+uint32_t WakePolicy_GetSnapshotPeriodMs(const WakePolicy_T * policy)
+{
+    if (NULL == policy)
+    {
+        return 0UL;
+    }
+    return (WAKE_POLICY_STATE_IDLE == policy->State) ? policy->Setup->HeartbeatMs : policy->MotionPeriodMs;
+}
+
+/** Refer interface header for description */
+uint32_t WakePolicy_TakePendingReads(WakePolicy_T * policy)
+{
+    uint32_t pending;
+
+    if (NULL == policy)
+    {
+        return 0UL;
+    }
+    pending = policy->PendingReads;
+    policy->PendingReads = 0UL;
+    return pending;
+}
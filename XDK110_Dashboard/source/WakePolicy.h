@@ -0,0 +1,147 @@
+/**
+ *  @file
+ *
+ *  @brief Event driven sampling policy: which period every sensor runs at.
+ *
+ *  Instead of reading every sensor at a fixed period, the policy keeps the
+ *  device IDLE until something happens:
+ *  - IDLE: every sensor is read once per heartbeat, only the light sensor is
+ *    read more often (LightPollMs) to watch the lux window.
+ *  - ACTIVE: entered on a motion event (BMA280 slope interrupt). The motion
+ *    and on demand sensors are read right away, then the motion sensors run
+ *    at ActivePeriodMs and every further motion event halves their period
+ *    down to FastestPeriodMs, at most once per RampStepMs. The other sensors
+ *    run at ActivePeriodMs.
+ *  - After QuietMs without motion (the no-motion condition) the period of the
+ *    motion sensors doubles every RampStepMs; past ActivePeriodMs the policy
+ *    is IDLE again.
+ *
+ *  The on demand sensors (the BME280 in forced mode) stay at the heartbeat in
+ *  both states and are read once more every time the light leaves its window
+ *  of LuxWindowPermille (at least LuxHysteresis) around the last value.
+ *
+ *  The module is platform independent and keeps no time of its own; the
+ *  caller passes milliseconds. WakeAgent runs it on the XDK,
+ *  Tools/WakePolicySim on the host.
+ *
+ */
+
+/* header definition ******************************************************** */
+#ifndef WAKEPOLICY_H_
+#define WAKEPOLICY_H_
+
+/* local interface declaration ********************************************** */
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "SensorTable.h"
+
+/* local type and macro definitions */
+
+/**
+ * @brief State of the policy.
+ */
+enum WakePolicy_State_E
+{
+    WAKE_POLICY_STATE_IDLE = 0,
+    WAKE_POLICY_STATE_ACTIVE,
+};
+typedef enum WakePolicy_State_E WakePolicy_State_T;
+
+/**
+ * @brief Policy configuration.
+ */
+struct WakePolicy_Setup_S
+{
+    uint32_t HeartbeatMs; /**< Period of every sensor while idle */
+    uint32_t LightPollMs; /**< Period of the light sensor while idle, 0 for the heartbeat */
+    uint32_t ActivePeriodMs; /**< Period while active, and of the motion sensors when activity starts */
+    uint32_t FastestPeriodMs; /**< Shortest period of the motion sensors */
+    uint32_t RampStepMs; /**< Shortest time between two period changes */
+    uint32_t QuietMs; /**< Time without motion before the periods ramp down */
+    uint32_t MotionSensors; /**< Sensors following the motion ramp, bit n for sensor n */
+    uint32_t OnDemandSensors; /**< Sensors read on events only, bit n for sensor n */
+    uint16_t LuxWindowPermille; /**< Half width of the lux window, relative to the last value */
+    uint32_t LuxHysteresis; /**< Least half width of the lux window, in the unit of the light channel (mlx) */
+};
+typedef struct WakePolicy_Setup_S WakePolicy_Setup_T;
+
+/**
+ * @brief Counters of the policy.
+ */
+struct WakePolicy_Statistics_S
+{
+    uint32_t MotionEvents;
+    uint32_t LightEvents; /**< The light left its window */
+    uint32_t Activations; /**< IDLE to ACTIVE */
+    uint32_t RampSteps; /**< Changes of the motion period */
+};
+typedef struct WakePolicy_Statistics_S WakePolicy_Statistics_T;
+
+/**
+ * @brief Policy state.
+ */
+struct WakePolicy_S
+{
+    const WakePolicy_Setup_T * Setup;
+    WakePolicy_State_T State;
+    uint32_t MotionPeriodMs;
+    uint32_t LastMotionMs;
+    uint32_t LastStepMs;
+    bool HasLux;
+    uint32_t LuxLow;
+    uint32_t LuxHigh;
+    uint32_t PendingReads; /**< Sensors to read once, bit n for sensor n */
+    WakePolicy_Statistics_T Statistics;
+};
+typedef struct WakePolicy_S WakePolicy_T;
+
+/* global function prototype declarations */
+
+/**
+ * @brief Starts the policy in IDLE.
+ *
+ * @return false for an invalid setup (a period of 0, FastestPeriodMs above ActivePeriodMs).
+ */
+bool WakePolicy_Init(WakePolicy_T * policy, const WakePolicy_Setup_T * setup);
+
+/**
+ * @brief Handles a motion event.
+ *
+ * @return true if the periods changed.
+ */
+bool WakePolicy_OnMotion(WakePolicy_T * policy, uint32_t nowMs);
+
+/**
+ * @brief Checks a light reading against the lux window.
+ *
+ * @param[in] lux
+ * Value of the light channel (mlx)
+ *
+ * @return true if the light left its window; the on demand sensors are then pending.
+ */
+bool WakePolicy_OnLight(WakePolicy_T * policy, uint32_t lux, uint32_t nowMs);
+
+/**
+ * @brief Ramps the periods down while there is no motion; call at least every RampStepMs while active.
+ *
+ * @return true if the periods changed.
+ */
+bool WakePolicy_Poll(WakePolicy_T * policy, uint32_t nowMs);
+
+/**
+ * @brief Returns the period a sensor runs at in the current state.
+ */
+uint32_t WakePolicy_GetPeriodMs(const WakePolicy_T * policy, uint8_t sensor);
+
+/**
+ * @brief Returns the period snapshots are taken at: the heartbeat while idle, the motion period while active.
+ */
+uint32_t WakePolicy_GetSnapshotPeriodMs(const WakePolicy_T * policy);
+
+/**
+ * @brief Returns and clears the sensors to read once now, bit n for sensor n.
+ */
+uint32_t WakePolicy_TakePendingReads(WakePolicy_T * policy);
+
+#endif /* WAKEPOLICY_H_ */
@@ -56,11 +56,62 @@
 /**< Main command processor task queue length */
 #define TASK_Q_LEN_MAIN_CMD_PROCESSOR               (UINT32_C(10))
 
+/**< Work dispatcher real-time lane (sensor acquisition) task priority */
+#define TASK_PRIO_DISPATCHER_REALTIME               (UINT32_C(4))
+/**< Work dispatcher real-time lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_REALTIME         (UINT32_C(500))
+/**< Work dispatcher real-time lane queue length */
+#define TASK_Q_LEN_DISPATCHER_REALTIME              (UINT32_C(16))
+
+/**< Work dispatcher normal lane (setup, enable, encoding) task priority */
+#define TASK_PRIO_DISPATCHER_NORMAL                 (UINT32_C(2))
+/**< Work dispatcher normal lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_NORMAL           (UINT32_C(600))
+/**< Work dispatcher normal lane queue length */
+#define TASK_Q_LEN_DISPATCHER_NORMAL                (UINT32_C(8))
+
+/**< Work dispatcher background lane (logging, storage) task priority */
+#define TASK_PRIO_DISPATCHER_BACKGROUND             (UINT32_C(1))
+/**< Work dispatcher background lane task stack size */
+#define TASK_STACK_SIZE_DISPATCHER_BACKGROUND       (UINT32_C(800))
+/**< Work dispatcher background lane queue length */
+#define TASK_Q_LEN_DISPATCHER_BACKGROUND            (UINT32_C(4))
+
 /**< Application controller task priority */
 #define TASK_PRIO_APP_CONTROLLER                    (UINT32_C(2))
 /**< Application controller task stack size */
 #define TASK_STACK_SIZE_APP_CONTROLLER              (UINT32_C(1200))
 
+/**< LWM2M agent task priority */
+#define TASK_PRIO_LWM2M_AGENT                       (UINT32_C(2))
+/**< LWM2M agent task stack size */
+#define TASK_STACK_SIZE_LWM2M_AGENT                 (UINT32_C(600))
+
+/**< BLE stream agent task priority */
+#define TASK_PRIO_BLE_STREAM_AGENT                  (UINT32_C(3))
+/**< BLE stream agent task stack size */
+#define TASK_STACK_SIZE_BLE_STREAM_AGENT            (UINT32_C(400))
+
+/**< LoRa agent task priority */
+#define TASK_PRIO_LORA_AGENT                        (UINT32_C(2))
+/**< LoRa agent task stack size */
+#define TASK_STACK_SIZE_LORA_AGENT                  (UINT32_C(500))
+
+/**< Live view agent task priority */
+#define TASK_PRIO_LIVE_VIEW_AGENT                   (UINT32_C(1))
+/**< Live view agent task stack size */
+#define TASK_STACK_SIZE_LIVE_VIEW_AGENT             (UINT32_C(500))
+
+/**< Boot sequencer worker task priority */
+#define TASK_PRIO_BOOT_WORKER                       (UINT32_C(3))
+/**< Boot sequencer worker task stack size, runs the WLAN, SNTP and HTTP setup */
+#define TASK_STACK_SIZE_BOOT_WORKER                 (UINT32_C(1000))
+/**< Boot sequencer worker tasks with storage when static allocation is enabled */
+#define TASK_COUNT_BOOT_WORKER                      (UINT32_C(2))
+
+/**< 1: tasks, timers and semaphores of the application use static storage instead of the heap, see StaticRtos.h */
+#define APP_STATIC_ALLOCATION_ENABLE                (UINT32_C(0))
+
 /*
  * @brief BCDS_APP_MODULE_ID for Application C module of XDK
  * @info  usage:
@@ -71,6 +122,22 @@ enum XDK_App_ModuleID_E
 {
     XDK_APP_MODULE_ID_MAIN = XDK_COMMON_ID_OVERFLOW,
     XDK_APP_MODULE_ID_APP_CONTROLLER,
+    XDK_APP_MODULE_ID_LWM2M_AGENT,
+    XDK_APP_MODULE_ID_BLE_STREAM_AGENT,
+    XDK_APP_MODULE_ID_LORA_AGENT,
+    XDK_APP_MODULE_ID_BOOT_SEQUENCER,
+    XDK_APP_MODULE_ID_SENSOR_COMPONENT,
+    XDK_APP_MODULE_ID_STATIC_RTOS,
+    XDK_APP_MODULE_ID_WORK_DISPATCHER,
+    XDK_APP_MODULE_ID_HTTPS_AGENT,
+    XDK_APP_MODULE_ID_DNS_AGENT,
+    XDK_APP_MODULE_ID_SENSOR_TRACE_AGENT,
+    XDK_APP_MODULE_ID_WAKE_AGENT,
+    XDK_APP_MODULE_ID_CONFIG_AGENT,
+    XDK_APP_MODULE_ID_DELTA_FOTA_AGENT,
+    XDK_APP_MODULE_ID_LIVE_VIEW_AGENT,
+    XDK_APP_MODULE_ID_POWER_AGENT,
+    XDK_APP_MODULE_ID_THERMAL_AGENT,
 
 /* Define next module ID here */
 };